@@ -54,6 +54,9 @@
 %attributestring(carto::Options, std::shared_ptr<carto::Bitmap>, BackgroundBitmap, getBackgroundBitmap, setBackgroundBitmap)
 %attribute(carto::Options, int, EnvelopeThreadPoolSize, getEnvelopeThreadPoolSize, setEnvelopeThreadPoolSize)
 %attribute(carto::Options, int, TileThreadPoolSize, getTileThreadPoolSize, setTileThreadPoolSize)
+%attribute(carto::Options, bool, TileFetchReprioritization, isTileFetchReprioritization, setTileFetchReprioritization)
+%attribute(carto::Options, float, TargetFrameTime, getTargetFrameTime, setTargetFrameTime)
+%attribute(carto::Options, bool, AdaptiveTileQuality, isAdaptiveTileQuality, setAdaptiveTileQuality)
 %attribute(carto::Options, int, TileDrawSize, getTileDrawSize, setTileDrawSize)
 %attribute(carto::Options, float, DPI, getDPI, setDPI)
 %attribute(carto::Options, float, DrawDistance, getDrawDistance, setDrawDistance)
@@ -73,6 +76,8 @@
 %ignore carto::Options::getSkyBitmap;
 %ignore carto::Options::getAdjustedInternalPanBounds;
 %ignore carto::Options::OnChangeListener;
+%ignore carto::Options::Snapshot;
+%ignore carto::Options::getSnapshot;
 %ignore carto::Options::registerOnChangeListener;
 %ignore carto::Options::unregisterOnChangeListener;
 %ignore carto::Options::GetDefaultBackgroundBitmap;
@@ -43,14 +43,47 @@
 %typemap(jni) (const unsigned char* dataPtr, std::size_t size) "jbyteArray"
 %typemap(javain) (const unsigned char* dataPtr, std::size_t size) "$javainput"
 %typemap(in) (const unsigned char* dataPtr, std::size_t size) {
-  jsize len = jenv->GetArrayLength($input);
-  jbyte* buf = new jbyte[len];
-  jenv->GetByteArrayRegion($input, 0, len, buf);
-  $1 = reinterpret_cast<unsigned char*>(buf);
-  $2 = static_cast<std::size_t>(len);
+  /* Access the array elements in-place, the BinaryData constructor makes the only copy */
+  $2 = static_cast<std::size_t>(jenv->GetArrayLength($input));
+  $1 = reinterpret_cast<unsigned char*>(jenv->GetPrimitiveArrayCritical($input, 0));
 }
 %typemap(freearg) (const unsigned char* dataPtr, std::size_t size) {
-  delete[] $1;
+  if ($1 != NULL) {
+    jenv->ReleasePrimitiveArrayCritical($input, $1, JNI_ABORT);
+  }
+}
+
+%typemap(jtype) const unsigned char* dataBuffer "java.nio.ByteBuffer"
+%typemap(jstype) const unsigned char* dataBuffer "java.nio.ByteBuffer"
+%typemap(jni) const unsigned char* dataBuffer "jobject"
+%typemap(javacode) carto::BinaryData %{
+  /* Keeps each direct buffer view paired with the BinaryData object that owns its memory.
+     The entries are dropped automatically once the buffers become unreachable. */
+  private static final java.util.Map<java.nio.ByteBuffer, BinaryData> dataBufferOwners = java.util.Collections.synchronizedMap(new java.util.WeakHashMap<java.nio.ByteBuffer, BinaryData>());
+%}
+%typemap(javaout) const unsigned char* dataBuffer {
+    java.nio.ByteBuffer buffer = $jnicall;
+    if (buffer == null) {
+      return java.nio.ByteBuffer.allocateDirect(0);
+    }
+    java.nio.ByteBuffer readOnlyBuffer = buffer.asReadOnlyBuffer();
+    // The buffer points directly at the native data, keep this object reachable while the buffer is
+    dataBufferOwners.put(readOnlyBuffer, this);
+    return readOnlyBuffer;
+  }
+%typemap(out) const unsigned char* dataBuffer {
+  $result = ($1 != NULL ? jenv->NewDirectByteBuffer(const_cast<unsigned char*>($1), arg1->size()) : NULL);
+}
+
+%javamethodmodifiers carto::BinaryData::dataBuffer "/**\n   * Returns a read-only direct buffer view over the data, no bytes are copied.<br>\n   * The returned buffer keeps this object alive, the view stays valid as long as the buffer itself is reachable.\n   */\n  public"
+%rename(getDataBuffer) carto::BinaryData::dataBuffer;
+%extend carto::BinaryData {
+    /* Read-only direct buffer view over the data, no bytes are copied.
+       The javaout typemap registers the view in dataBufferOwners, so the returned
+       buffer keeps the owning object (and thus the native data) alive. */
+    const unsigned char* dataBuffer() const {
+        return $self->data();
+    }
 }
 
 %typemap(jtype) const unsigned char* data "byte[]"
@@ -33,6 +33,7 @@
 %std_exceptions(carto::Variant::FromString)
 %ignore carto::Variant::Variant(const char*);
 %ignore carto::Variant::toPicoJSON;
+%ignore carto::Variant::FromStream;
 %ignore carto::Variant::FromPicoJSON;
 !custom_equals(carto::Variant);
 !custom_tostring(carto::Variant);
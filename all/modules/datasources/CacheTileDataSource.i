@@ -3,7 +3,7 @@
 
 %module(directors="1") CacheTileDataSource
 
-!proxy_imports(carto::CacheTileDataSource, core.MapTile, core.MapBounds, core.StringMap, datasources.TileDataSource, datasources.components.TileData)
+!proxy_imports(carto::CacheTileDataSource, core.MapTile, core.MapBounds, core.StringMap, datasources.TileDataSource, datasources.components.TileData, datasources.components.CacheStats)
 
 %{
 #include "datasources/CacheTileDataSource.h"
@@ -15,11 +15,13 @@
 %include <cartoswig.i>
 
 %import "datasources/TileDataSource.i"
+%import "datasources/components/CacheStats.i"
 
 !polymorphic_shared_ptr(carto::CacheTileDataSource, datasources.CacheTileDataSource)
 
 !attributestring_polymorphic(carto::CacheTileDataSource, datasources.TileDataSource, DataSource, getDataSource)
 %attribute(carto::CacheTileDataSource, std::size_t, Capacity, getCapacity, setCapacity)
+%attributeval(carto::CacheTileDataSource, carto::CacheStats, CacheStats, getCacheStats)
 %std_exceptions(carto::CacheTileDataSource::CacheTileDataSource)
 
 %feature("director") carto::CacheTileDataSource;
@@ -19,6 +19,7 @@
 
 !polymorphic_shared_ptr(carto::CombinedTileDataSource, datasources.CombinedTileDataSource)
 
+%attribute(carto::CombinedTileDataSource, bool, TileSynthesizingEnabled, isTileSynthesizingEnabled, setTileSynthesizingEnabled)
 %std_exceptions(carto::CombinedTileDataSource::CombinedTileDataSource)
 
 %feature("director") carto::CombinedTileDataSource;
@@ -0,0 +1,20 @@
+#ifndef _COMPACTIONLISTENER_I
+#define _COMPACTIONLISTENER_I
+
+%module(directors="1") CompactionListener
+
+%{
+#include "datasources/CompactionListener.h"
+#include <memory>
+%}
+
+%include <std_shared_ptr.i>
+%include <cartoswig.i>
+
+!polymorphic_shared_ptr(carto::CompactionListener, datasources.CompactionListener)
+
+%feature("director") carto::CompactionListener;
+
+%include "datasources/CompactionListener.h"
+
+#endif
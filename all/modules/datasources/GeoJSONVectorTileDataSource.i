@@ -26,6 +26,7 @@
 
 %std_io_exceptions(carto::GeoJSONVectorTileDataSource::createLayer)
 %std_io_exceptions(carto::GeoJSONVectorTileDataSource::setLayerGeoJSON)
+%std_io_exceptions(carto::GeoJSONVectorTileDataSource::setLayerGeoJSONFromFile)
 %std_io_exceptions(carto::GeoJSONVectorTileDataSource::setLayerFeatureCollection)
 
 %feature("director") carto::GeoJSONVectorTileDataSource;
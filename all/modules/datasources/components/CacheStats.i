@@ -0,0 +1,26 @@
+#ifndef _CACHESTATS_I
+#define _CACHESTATS_I
+
+%module CacheStats
+
+%{
+#include "datasources/components/CacheStats.h"
+%}
+
+%include <std_string.i>
+%include <cartoswig.i>
+
+!value_type(carto::CacheStats, datasources.components.CacheStats)
+
+%attribute(carto::CacheStats, long long, HitCount, getHitCount)
+%attribute(carto::CacheStats, long long, MissCount, getMissCount)
+%attribute(carto::CacheStats, long long, EvictionCount, getEvictionCount)
+%attribute(carto::CacheStats, size_t, ElementCount, getElementCount)
+%attribute(carto::CacheStats, size_t, CapacityInBytes, getCapacityInBytes)
+%attribute(carto::CacheStats, float, MeanLoadLatency, getMeanLoadLatency)
+!custom_equals(carto::CacheStats);
+!custom_tostring(carto::CacheStats);
+
+%include "datasources/components/CacheStats.h"
+
+#endif
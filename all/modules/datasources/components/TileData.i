@@ -19,6 +19,7 @@
 
 %attribute(carto::TileData, long long, MaxAge, getMaxAge, setMaxAge)
 %attribute(carto::TileData, bool, ReplaceWithParent, isReplaceWithParent, setReplaceWithParent)
+%attribute(carto::TileData, int, ErrorCode, getErrorCode, setErrorCode)
 %attributestring(carto::TileData, std::shared_ptr<carto::BinaryData>, Data, getData)
 !standard_equals(carto::TileData);
 
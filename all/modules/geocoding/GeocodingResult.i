@@ -36,6 +36,7 @@
 %include "geocoding/GeocodingResult.h"
 
 !value_template(std::vector<std::shared_ptr<carto::GeocodingResult> >, geocoding.GeocodingResultVector);
+!value_template(std::vector<std::vector<std::shared_ptr<carto::GeocodingResult> > >, geocoding.GeocodingResultVectorVector);
 
 #endif
 
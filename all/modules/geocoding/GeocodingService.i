@@ -8,7 +8,7 @@
 
 #ifdef _CARTO_GEOCODING_SUPPORT
 
-!proxy_imports(carto::GeocodingService, geocoding.GeocodingRequest, geocoding.GeocodingResult)
+!proxy_imports(carto::GeocodingService, geocoding.GeocodingRequest, geocoding.GeocodingResult, geocoding.GeocodingSession)
 
 %{
 #include "geocoding/GeocodingService.h"
@@ -21,10 +21,12 @@
 
 %import "geocoding/GeocodingRequest.i"
 %import "geocoding/GeocodingResult.i"
+%import "geocoding/GeocodingSession.i"
 
 !polymorphic_shared_ptr(carto::GeocodingService, geocoding.GeocodingService)
 
 %std_io_exceptions(carto::GeocodingService::calculateAddresses)
+%ignore carto::GeocodingService::refreshAddressesInBackground;
 
 %feature("director") carto::GeocodingService;
 
@@ -0,0 +1,38 @@
+#ifndef _GEOCODINGSESSION_I
+#define _GEOCODINGSESSION_I
+
+#pragma SWIG nowarn=325
+
+%module GeocodingSession
+
+#ifdef _CARTO_GEOCODING_SUPPORT
+
+!proxy_imports(carto::GeocodingSession, geocoding.GeocodingRequest, geocoding.GeocodingResult)
+
+%{
+#include "geocoding/GeocodingSession.h"
+#include <memory>
+%}
+
+%include <std_shared_ptr.i>
+%include <cartoswig.i>
+
+%import "geocoding/GeocodingRequest.i"
+%import "geocoding/GeocodingResult.i"
+
+!shared_ptr(carto::GeocodingSession, geocoding.GeocodingSession)
+
+%attribute(carto::GeocodingSession, std::size_t, Capacity, getCapacity, setCapacity)
+%ignore carto::GeocodingSession::findCachedResults;
+%ignore carto::GeocodingSession::findSpeculativeResults;
+%ignore carto::GeocodingSession::cacheResults;
+%ignore carto::GeocodingSession::beginRefresh;
+%ignore carto::GeocodingSession::commitRefresh;
+%ignore carto::GeocodingSession::cancelRefresh;
+!standard_equals(carto::GeocodingSession);
+
+%include "geocoding/GeocodingSession.h"
+
+#endif
+
+#endif
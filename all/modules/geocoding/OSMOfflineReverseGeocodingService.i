@@ -28,6 +28,7 @@
 %attributestring(carto::OSMOfflineReverseGeocodingService, std::string, Language, getLanguage, setLanguage)
 %std_io_exceptions(carto::OSMOfflineReverseGeocodingService::OSMOfflineReverseGeocodingService)
 %std_io_exceptions(carto::OSMOfflineReverseGeocodingService::calculateAddresses)
+%std_io_exceptions(carto::OSMOfflineReverseGeocodingService::calculateAddressesBatch)
 
 %feature("director") carto::OSMOfflineReverseGeocodingService;
 
@@ -27,6 +27,7 @@
 %attributestring(carto::PackageManagerReverseGeocodingService, std::string, Language, getLanguage, setLanguage)
 %std_exceptions(carto::PackageManagerReverseGeocodingService::PackageManagerReverseGeocodingService)
 %std_io_exceptions(carto::PackageManagerReverseGeocodingService::calculateAddresses)
+%std_io_exceptions(carto::PackageManagerReverseGeocodingService::calculateAddressesBatch)
 
 %feature("director") carto::PackageManagerReverseGeocodingService;
 
@@ -16,6 +16,7 @@
 %}
 
 %include <std_shared_ptr.i>
+%include <std_vector.i>
 %include <cartoswig.i>
 
 %import "core/MapPos.i"
@@ -32,6 +33,8 @@
 
 %include "geocoding/ReverseGeocodingRequest.h"
 
+!value_template(std::vector<std::shared_ptr<carto::ReverseGeocodingRequest> >, geocoding.ReverseGeocodingRequestVector);
+
 #endif
 
 #endif
@@ -25,6 +25,7 @@
 !polymorphic_shared_ptr(carto::ReverseGeocodingService, geocoding.ReverseGeocodingService)
 
 %std_io_exceptions(carto::ReverseGeocodingService::calculateAddresses)
+%std_io_exceptions(carto::ReverseGeocodingService::calculateAddressesBatch)
 
 %feature("director") carto::ReverseGeocodingService;
 
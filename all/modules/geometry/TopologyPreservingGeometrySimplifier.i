@@ -0,0 +1,25 @@
+#ifndef _TOPOLOGYPRESERVINGGEOMETRYSIMPLIFIER_I
+#define _TOPOLOGYPRESERVINGGEOMETRYSIMPLIFIER_I
+
+%module TopologyPreservingGeometrySimplifier
+
+!proxy_imports(carto::TopologyPreservingGeometrySimplifier, geometry.Geometry, geometry.DouglasPeuckerGeometrySimplifier, projections.Projection)
+
+%{
+#include "geometry/TopologyPreservingGeometrySimplifier.h"
+#include <memory>
+%}
+
+%include <std_shared_ptr.i>
+%include <cartoswig.i>
+
+%import "core/MapPos.i"
+%import "geometry/DouglasPeuckerGeometrySimplifier.i"
+
+!polymorphic_shared_ptr(carto::TopologyPreservingGeometrySimplifier, geometry.TopologyPreservingGeometrySimplifier)
+
+%ignore carto::TopologyPreservingGeometrySimplifier::simplifyAll;
+
+%include "geometry/TopologyPreservingGeometrySimplifier.h"
+
+#endif
@@ -5,7 +5,7 @@
 
 #ifdef _CARTO_WKBT_SUPPORT
 
-!proxy_imports(carto::WKBGeometryReader, core.BinaryData, geometry.Geometry)
+!proxy_imports(carto::WKBGeometryReader, core.BinaryData, geometry.Geometry, geometry.GeometryVector)
 
 %{
 #include "geometry/WKBGeometryReader.h"
@@ -20,6 +20,7 @@
 %import "geometry/Geometry.i"
 
 %std_exceptions(carto::WKBGeometryReader::readGeometry)
+%std_exceptions(carto::WKBGeometryReader::readGeometries)
 
 %include "geometry/WKBGeometryReader.h"
 
@@ -26,9 +26,11 @@
 %std_exceptions(carto::Bitmap::CreateFromCompressed)
 %ignore carto::Bitmap::Bitmap(const unsigned char*, std::size_t);
 %ignore carto::Bitmap::Bitmap(const unsigned char*, unsigned int, unsigned int, ColorFormat::ColorFormat, unsigned int);
+%ignore carto::Bitmap::getContentHash;
 %ignore carto::Bitmap::getPixelData;
 %rename(getPixelData) carto::Bitmap::getPixelDataPtr;
 %ignore carto::Bitmap::CreateFromCompressed(const unsigned char*, std::size_t);
+%ignore carto::Bitmap::CreateFromCompressed(const unsigned char*, std::size_t, unsigned int, unsigned int);
 !standard_equals(carto::Bitmap);
 
 %include "graphics/Bitmap.h"
@@ -3,7 +3,7 @@
 
 %module ClusteredVectorLayer
 
-!proxy_imports(carto::ClusteredVectorLayer, datasources.LocalVectorDataSource, layers.VectorLayer, vectorelements.VectorElement, layers.ClusterElementBuilder)
+!proxy_imports(carto::ClusteredVectorLayer, datasources.LocalVectorDataSource, layers.VectorLayer, styles.PointStyle, vectorelements.VectorElement, layers.ClusterElementBuilder)
 
 %{
 #include "layers/ClusteredVectorLayer.h"
@@ -17,12 +17,15 @@
 %import "datasources/LocalVectorDataSource.i"
 %import "layers/VectorLayer.i"
 %import "layers/ClusterElementBuilder.i"
+%import "styles/PointStyle.i"
 
 !polymorphic_shared_ptr(carto::ClusteredVectorLayer, layers.ClusteredVectorLayer)
 
 %attribute(carto::ClusteredVectorLayer, float, MinimumClusterDistance, getMinimumClusterDistance, setMinimumClusterDistance)
 %attribute(carto::ClusteredVectorLayer, float, MaximumClusterZoom, getMaximumClusterZoom, setMaximumClusterZoom)
 %attribute(carto::ClusteredVectorLayer, bool, AnimatedClusters, isAnimatedClusters, setAnimatedClusters)
+%attributestring(carto::ClusteredVectorLayer, std::shared_ptr<carto::PointStyle>, ClusterPointStyle, getClusterPointStyle, setClusterPointStyle)
+%attribute(carto::ClusteredVectorLayer, float, ClusterPointZoom, getClusterPointZoom, setClusterPointZoom)
 !attributestring_polymorphic(carto::ClusteredVectorLayer, layers.ClusterElementBuilder, ClusterElementBuilder, getClusterElementBuilder)
 %std_exceptions(carto::ClusteredVectorLayer::ClusteredVectorLayer)
 
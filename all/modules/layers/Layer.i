@@ -29,6 +29,7 @@
 %attribute(carto::Layer, bool, Visible, isVisible, setVisible)
 %attributeval(carto::Layer, carto::MapRange, VisibleZoomRange, getVisibleZoomRange, setVisibleZoomRange)
 %attribute(carto::Layer, float, Opacity, getOpacity, setOpacity)
+%attributestring(carto::Layer, std::string, CompositingGroup, getCompositingGroup, setCompositingGroup)
 %ignore carto::Layer::isSurfaceCreated;
 %ignore carto::Layer::onSurfaceCreated;
 %ignore carto::Layer::onDrawFrame;
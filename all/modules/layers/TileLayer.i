@@ -5,7 +5,7 @@
 
 %module TileLayer
 
-!proxy_imports(carto::TileLayer, core.MapPos, core.MapTile, core.MapBounds, datasources.TileDataSource, layers.TileLoadListener, layers.UTFGridEventListener, layers.Layer)
+!proxy_imports(carto::TileLayer, core.MapPos, core.MapTile, core.MapBounds, core.Variant, datasources.TileDataSource, layers.TileLoadListener, layers.UTFGridEventListener, layers.Layer)
 
 %{
 #include "layers/TileLayer.h"
@@ -16,6 +16,7 @@
 %include <std_shared_ptr.i>
 %include <cartoswig.i>
 
+%import "core/Variant.i"
 %import "datasources/TileDataSource.i"
 %import "layers/Layer.i"
 %import "layers/TileLoadListener.i"
@@ -25,11 +26,13 @@
 
 %attribute(carto::TileLayer, int, FrameNr, getFrameNr, setFrameNr)
 %attribute(carto::TileLayer, bool, Preloading, isPreloading, setPreloading)
+%attribute(carto::TileLayer, int, PreloadingTileBudget, getPreloadingTileBudget, setPreloadingTileBudget)
 %attribute(carto::TileLayer, bool, SynchronizedRefresh, isSynchronizedRefresh, setSynchronizedRefresh)
 %attribute(carto::TileLayer, carto::TileSubstitutionPolicy::TileSubstitutionPolicy, TileSubstitutionPolicy, getTileSubstitutionPolicy, setTileSubstitutionPolicy)
 %attribute(carto::TileLayer, float, ZoomLevelBias, getZoomLevelBias, setZoomLevelBias)
 %attribute(carto::TileLayer, int, MaxOverzoomLevel, getMaxOverzoomLevel, setMaxOverzoomLevel)
 %attribute(carto::TileLayer, int, MaxUnderzoomLevel, getMaxUnderzoomLevel, setMaxUnderzoomLevel)
+%attributeval(carto::TileLayer, carto::Variant, TileLoadStatistics, getTileLoadStatistics)
 !attributestring_polymorphic(carto::TileLayer, datasources.TileDataSource, DataSource, getDataSource)
 !attributestring_polymorphic(carto::TileLayer, datasources.TileDataSource, UTFGridDataSource, getUTFGridDataSource, setUTFGridDataSource)
 !attributestring_polymorphic(carto::TileLayer, layers.TileLoadListener, TileLoadListener, getTileLoadListener, setTileLoadListener)
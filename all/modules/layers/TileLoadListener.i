@@ -3,14 +3,18 @@
 
 %module(directors="1") TileLoadListener
 
+!proxy_imports(carto::TileLoadListener, core.MapTile)
+
 %{
-#include "layers/TileLoadListener.h"	
+#include "layers/TileLoadListener.h"
 #include <memory>
 %}
 
 %include <std_string.i>
 %include <std_shared_ptr.i>
 
+%import "core/MapTile.i"
+
 !polymorphic_shared_ptr(carto::TileLoadListener, layers.TileLoadListener)
 
 %feature("director") carto::TileLoadListener;
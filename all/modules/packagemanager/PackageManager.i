@@ -35,6 +35,8 @@ using std::uint64_t;
 %attributeval(carto::PackageManager, std::vector<std::shared_ptr<carto::PackageInfo> >, ServerPackages, getServerPackages)
 %attributeval(carto::PackageManager, std::vector<std::shared_ptr<carto::PackageInfo> >, LocalPackages, getLocalPackages)
 %attribute(carto::PackageManager, int, ServerPackageListAge, getServerPackageListAge)
+%attribute(carto::PackageManager, int, DownloadConcurrency, getDownloadConcurrency, setDownloadConcurrency)
+%attribute(carto::PackageManager, int, TileCacheCapacity, getTileCacheCapacity, setTileCacheCapacity)
 %attributestring(carto::PackageManager, std::shared_ptr<carto::PackageMetaInfo>, ServerPackageListMetaInfo, getServerPackageListMetaInfo)
 !attributestring_polymorphic(carto::PackageManager, packagemanager.PackageManagerListener, PackageManagerListener, getPackageManagerListener, setPackageManagerListener)
 %std_io_exceptions(carto::PackageManager::PackageManager)
@@ -30,6 +30,7 @@
 %attributestring(carto::PackageTileMask, std::string, StringValue, getStringValue)
 %attribute(carto::PackageTileMask, int, MaxZoomLevel, getMaxZoomLevel)
 %ignore carto::PackageTileMask::Tile;
+%ignore carto::PackageTileMask::Index;
 %ignore carto::PackageTileMask::getURLSafeStringValue;
 %ignore carto::PackageTileMask::PackageTileMask;
 !standard_equals(carto::PackageTileMask);
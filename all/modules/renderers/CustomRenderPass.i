@@ -0,0 +1,19 @@
+#ifndef _CUSTOMRENDERPASS_I
+#define _CUSTOMRENDERPASS_I
+
+%module(directors="1") CustomRenderPass
+
+%{
+#include "renderers/CustomRenderPass.h"
+#include <memory>
+%}
+
+%include <std_shared_ptr.i>
+
+!polymorphic_shared_ptr(carto::CustomRenderPass, renderers.CustomRenderPass)
+
+%feature("director") carto::CustomRenderPass;
+
+%include "renderers/CustomRenderPass.h"
+
+#endif
@@ -3,7 +3,7 @@
 
 %module MapRenderer
 
-!proxy_imports(carto::MapRenderer, core.MapPos, core.MapBounds, core.ScreenPos, graphics.ViewState, renderers.MapRendererListener, renderers.RendererCaptureListener, renderers.RedrawRequestListener)
+!proxy_imports(carto::MapRenderer, core.MapPos, core.MapBounds, core.ScreenPos, core.Variant, graphics.ViewState, renderers.CustomRenderPass, renderers.MapRendererListener, renderers.RendererCaptureListener, renderers.RedrawRequestListener)
 
 %{
 #include "renderers/MapRenderer.h"
@@ -11,13 +11,16 @@
 #include <memory>
 %}
 
+%include <std_string.i>
 %include <std_shared_ptr.i>
 %include <cartoswig.i>
 
 %import "core/MapPos.i"
 %import "core/MapBounds.i"
 %import "core/ScreenPos.i"
+%import "core/Variant.i"
 %import "graphics/ViewState.i"
+%import "renderers/CustomRenderPass.i"
 %import "renderers/MapRendererListener.i"
 %import "renderers/RendererCaptureListener.i"
 %import "renderers/RedrawRequestListener.i"
@@ -25,11 +28,15 @@
 !shared_ptr(carto::MapRenderer, renderers.MapRenderer)
 
 %attributestring(carto::MapRenderer, std::shared_ptr<carto::MapRendererListener>, MapRendererListener, getMapRendererListener, setMapRendererListener)
+%attribute(carto::MapRenderer, bool, FrameProfilingEnabled, isFrameProfilingEnabled, setFrameProfilingEnabled)
+%attributeval(carto::MapRenderer, carto::Variant, LayerRenderStatistics, getLayerRenderStatistics)
 %std_exceptions(carto::MapRenderer::captureRendering)
+%std_exceptions(carto::MapRenderer::registerCustomRenderPass)
 %ignore carto::MapRenderer::MapRenderer;
 %ignore carto::MapRenderer::init;
 %ignore carto::MapRenderer::deinit;
 %ignore carto::MapRenderer::getBillboardDrawDatas;
+%ignore carto::MapRenderer::getFrameProfiler;
 %ignore carto::MapRenderer::getProjectionSurface;
 %ignore carto::MapRenderer::getAnimationHandler;
 %ignore carto::MapRenderer::getKineticEventHandler;
@@ -1,11 +1,13 @@
 #ifndef _PACKAGEMANAGERVALHALLAROUTINGSERVICE_I
 #define _PACKAGEMANAGERVALHALLAROUTINGSERVICE_I
 
+#pragma SWIG nowarn=325
+
 %module(directors="1") PackageManagerValhallaRoutingService
 
 #if defined(_CARTO_VALHALLA_ROUTING_SUPPORT) && defined(_CARTO_PACKAGEMANAGER_SUPPORT)
 
-!proxy_imports(carto::PackageManagerValhallaRoutingService, packagemanager.PackageManager, routing.RoutingService, routing.RoutingRequest, routing.RoutingResult, routing.RouteMatchingRequest, routing.RouteMatchingResult)
+!proxy_imports(carto::PackageManagerValhallaRoutingService, packagemanager.PackageManager, routing.RoutingService, routing.RoutingRequest, routing.RoutingResult, routing.RoutingTask, routing.RouteMatchingCompletionListener, routing.RouteMatchingRequest, routing.RouteMatchingRequestVector, routing.RouteMatchingResult)
 
 %{
 #include "routing/PackageManagerValhallaRoutingService.h"
@@ -15,11 +17,14 @@
 
 %include <std_shared_ptr.i>
 %include <std_string.i>
+%include <std_vector.i>
 %include <cartoswig.i>
 
 %import "routing/RoutingService.i"
 %import "routing/RoutingRequest.i"
 %import "routing/RoutingResult.i"
+%import "routing/RoutingTask.i"
+%import "routing/RouteMatchingCompletionListener.i"
 %import "routing/RouteMatchingRequest.i"
 %import "routing/RouteMatchingResult.i"
 %import "packagemanager/PackageManager.i"
@@ -27,8 +32,10 @@
 !polymorphic_shared_ptr(carto::PackageManagerValhallaRoutingService, routing.PackageManagerValhallaRoutingService)
 
 %attributestring(carto::PackageManagerValhallaRoutingService, std::string, Profile, getProfile, setProfile)
+%attribute(carto::PackageManagerValhallaRoutingService, std::size_t, CacheSize, getCacheSize, setCacheSize)
 %std_exceptions(carto::PackageManagerValhallaRoutingService::PackageManagerValhallaRoutingService)
 %std_io_exceptions(carto::PackageManagerValhallaRoutingService::matchRoute)
+%std_io_exceptions(carto::PackageManagerValhallaRoutingService::matchRoutes)
 %std_io_exceptions(carto::PackageManagerValhallaRoutingService::calculateRoute)
 
 %feature("director") carto::PackageManagerValhallaRoutingService;
@@ -0,0 +1,30 @@
+#ifndef _ROUTEMATCHINGCOMPLETIONLISTENER_I
+#define _ROUTEMATCHINGCOMPLETIONLISTENER_I
+
+%module(directors="1") RouteMatchingCompletionListener
+
+#ifdef _CARTO_ROUTING_SUPPORT
+
+!proxy_imports(carto::RouteMatchingCompletionListener, routing.RouteMatchingRequest, routing.RouteMatchingResult)
+
+%{
+#include "routing/RouteMatchingCompletionListener.h"
+#include <memory>
+%}
+
+%include <std_shared_ptr.i>
+%include <std_string.i>
+%include <cartoswig.i>
+
+%import "routing/RouteMatchingRequest.i"
+%import "routing/RouteMatchingResult.i"
+
+!polymorphic_shared_ptr(carto::RouteMatchingCompletionListener, routing.RouteMatchingCompletionListener)
+
+%feature("director") carto::RouteMatchingCompletionListener;
+
+%include "routing/RouteMatchingCompletionListener.h"
+
+#endif
+
+#endif
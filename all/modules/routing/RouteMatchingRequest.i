@@ -16,12 +16,14 @@
 %}
 
 %include <std_shared_ptr.i>
+%include <std_vector.i>
 %include <cartoswig.i>
 
 %import "core/MapPos.i"
 %import "projections/Projection.i"
 
 !shared_ptr(carto::RouteMatchingRequest, routing.RouteMatchingRequest)
+!value_type(std::vector<std::shared_ptr<carto::RouteMatchingRequest> >, routing.RouteMatchingRequestVector)
 
 %attributestring(carto::RouteMatchingRequest, std::shared_ptr<carto::Projection>, Projection, getProjection)
 %attributeval(carto::RouteMatchingRequest, std::vector<carto::MapPos>, Points, getPoints)
@@ -32,6 +34,8 @@
 
 %include "routing/RouteMatchingRequest.h"
 
+!value_template(std::vector<std::shared_ptr<carto::RouteMatchingRequest> >, routing.RouteMatchingRequestVector);
+
 #endif
 
 #endif
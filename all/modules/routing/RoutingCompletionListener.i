@@ -0,0 +1,29 @@
+#ifndef _ROUTINGCOMPLETIONLISTENER_I
+#define _ROUTINGCOMPLETIONLISTENER_I
+
+%module(directors="1") RoutingCompletionListener
+
+#ifdef _CARTO_ROUTING_SUPPORT
+
+!proxy_imports(carto::RoutingCompletionListener, routing.RoutingResult)
+
+%{
+#include "routing/RoutingCompletionListener.h"
+#include <memory>
+%}
+
+%include <std_shared_ptr.i>
+%include <std_string.i>
+%include <cartoswig.i>
+
+%import "routing/RoutingResult.i"
+
+!polymorphic_shared_ptr(carto::RoutingCompletionListener, routing.RoutingCompletionListener)
+
+%feature("director") carto::RoutingCompletionListener;
+
+%include "routing/RoutingCompletionListener.h"
+
+#endif
+
+#endif
@@ -8,7 +8,7 @@
 
 #ifdef _CARTO_ROUTING_SUPPORT
 
-!proxy_imports(carto::RoutingService, routing.RoutingRequest, routing.RoutingResult)
+!proxy_imports(carto::RoutingService, routing.RoutingCompletionListener, routing.RoutingRequest, routing.RoutingResult, routing.RoutingTask)
 
 %{
 #include "routing/RoutingService.h"
@@ -19,12 +19,15 @@
 %include <std_shared_ptr.i>
 %include <cartoswig.i>
 
+%import "routing/RoutingCompletionListener.i"
 %import "routing/RoutingRequest.i"
 %import "routing/RoutingResult.i"
+%import "routing/RoutingTask.i"
 
 !polymorphic_shared_ptr(carto::RoutingService, routing.RoutingService)
 
 %std_io_exceptions(carto::RoutingService::calculateRoute)
+%std_io_exceptions(carto::RoutingService::calculateRouteAsync)
 
 %feature("director") carto::RoutingService;
 
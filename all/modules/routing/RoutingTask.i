@@ -0,0 +1,24 @@
+#ifndef _ROUTINGTASK_I
+#define _ROUTINGTASK_I
+
+%module RoutingTask
+
+#ifdef _CARTO_ROUTING_SUPPORT
+
+%{
+#include "routing/RoutingTask.h"
+#include <memory>
+%}
+
+%include <std_shared_ptr.i>
+%include <cartoswig.i>
+
+!shared_ptr(carto::RoutingTask, routing.RoutingTask)
+
+!standard_equals(carto::RoutingTask);
+
+%include "routing/RoutingTask.h"
+
+#endif
+
+#endif
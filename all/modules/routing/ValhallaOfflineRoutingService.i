@@ -1,11 +1,13 @@
 #ifndef _VALHALLAOFFLINEROUTINGSERVICE_I
 #define _VALHALLAOFFLINEROUTINGSERVICE_I
 
+#pragma SWIG nowarn=325
+
 %module(directors="1") ValhallaOfflineRoutingService
 
 #if defined(_CARTO_VALHALLA_ROUTING_SUPPORT) && defined(_CARTO_OFFLINE_SUPPORT)
 
-!proxy_imports(carto::ValhallaOfflineRoutingService, routing.RoutingService, routing.RoutingRequest, routing.RoutingResult, routing.RouteMatchingRequest, routing.RouteMatchingResult)
+!proxy_imports(carto::ValhallaOfflineRoutingService, routing.RoutingService, routing.RoutingCompletionListener, routing.RoutingRequest, routing.RoutingResult, routing.RoutingTask, routing.RouteMatchingCompletionListener, routing.RouteMatchingRequest, routing.RouteMatchingRequestVector, routing.RouteMatchingResult)
 
 %{
 #include "routing/ValhallaOfflineRoutingService.h"
@@ -15,20 +17,27 @@
 
 %include <std_shared_ptr.i>
 %include <std_string.i>
+%include <std_vector.i>
 %include <cartoswig.i>
 
 %import "routing/RoutingService.i"
+%import "routing/RoutingCompletionListener.i"
 %import "routing/RoutingRequest.i"
 %import "routing/RoutingResult.i"
+%import "routing/RoutingTask.i"
+%import "routing/RouteMatchingCompletionListener.i"
 %import "routing/RouteMatchingRequest.i"
 %import "routing/RouteMatchingResult.i"
 
 !polymorphic_shared_ptr(carto::ValhallaOfflineRoutingService, routing.ValhallaOfflineRoutingService)
 
 %attributestring(carto::ValhallaOfflineRoutingService, std::string, Profile, getProfile, setProfile)
+%attribute(carto::ValhallaOfflineRoutingService, std::size_t, CacheSize, getCacheSize, setCacheSize)
 %std_io_exceptions(carto::ValhallaOfflineRoutingService::ValhallaOfflineRoutingService)
 %std_io_exceptions(carto::ValhallaOfflineRoutingService::matchRoute)
+%std_io_exceptions(carto::ValhallaOfflineRoutingService::matchRoutes)
 %std_io_exceptions(carto::ValhallaOfflineRoutingService::calculateRoute)
+%std_io_exceptions(carto::ValhallaOfflineRoutingService::calculateRouteAsync)
 
 %feature("director") carto::ValhallaOfflineRoutingService;
 
@@ -29,6 +29,7 @@
 %attributestring(carto::SearchRequest, std::shared_ptr<carto::Geometry>, Geometry, getGeometry, setGeometry)
 %attributestring(carto::SearchRequest, std::shared_ptr<carto::Projection>, Projection, getProjection, setProjection)
 %attribute(carto::SearchRequest, float, SearchRadius, getSearchRadius, setSearchRadius)
+%attribute(carto::SearchRequest, int, MaxResults, getMaxResults, setMaxResults)
 !standard_equals(carto::SearchRequest);
 !custom_tostring(carto::SearchRequest);
 
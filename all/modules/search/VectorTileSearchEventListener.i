@@ -0,0 +1,28 @@
+#ifndef _VECTORTILESEARCHEVENTLISTENER_I
+#define _VECTORTILESEARCHEVENTLISTENER_I
+
+%module(directors="1") VectorTileSearchEventListener
+
+#ifdef _CARTO_SEARCH_SUPPORT
+
+!proxy_imports(carto::VectorTileSearchEventListener, geometry.VectorTileFeatureCollection)
+
+%{
+#include "search/VectorTileSearchEventListener.h"
+#include <memory>
+%}
+
+%include <std_shared_ptr.i>
+%include <cartoswig.i>
+
+%import "geometry/VectorTileFeatureCollection.i"
+
+!polymorphic_shared_ptr(carto::VectorTileSearchEventListener, search.VectorTileSearchEventListener)
+
+%feature("director") carto::VectorTileSearchEventListener;
+
+%include "search/VectorTileSearchEventListener.h"
+
+#endif
+
+#endif
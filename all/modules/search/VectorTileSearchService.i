@@ -8,7 +8,7 @@
 
 #ifdef _CARTO_SEARCH_SUPPORT
 
-!proxy_imports(carto::VectorTileSearchService, search.SearchRequest, datasources.TileDataSource, geometry.VectorTileFeatureCollection, vectortiles.VectorTileDecoder, projections.Projection)
+!proxy_imports(carto::VectorTileSearchService, search.SearchRequest, search.VectorTileSearchEventListener, datasources.TileDataSource, geometry.VectorTileFeatureCollection, vectortiles.VectorTileDecoder, projections.Projection)
 
 %{
 #include "search/VectorTileSearchService.h"
@@ -21,6 +21,7 @@
 
 %import "geometry/VectorTileFeatureCollection.i"
 %import "search/SearchRequest.i"
+%import "search/VectorTileSearchEventListener.i"
 %import "datasources/TileDataSource.i"
 %import "vectortiles/VectorTileDecoder.i"
 %import "projections/Projection.i"
@@ -31,8 +32,14 @@
 %attributestring(carto::VectorTileSearchService, std::shared_ptr<carto::VectorTileDecoder>, TileDecoder, getTileDecoder)
 %attribute(carto::VectorTileSearchService, int, MinZoom, getMinZoom, setMinZoom)
 %attribute(carto::VectorTileSearchService, int, MaxZoom, getMaxZoom, setMaxZoom)
+%attributestring(carto::VectorTileSearchService, std::shared_ptr<carto::VectorTileSearchEventListener>, EventListener, getEventListener, setEventListener)
 %std_exceptions(carto::VectorTileSearchService::VectorTileSearchService)
 %std_exceptions(carto::VectorTileSearchService::findFeatures)
+#ifdef _CARTO_OFFLINE_SUPPORT
+%attributestring(carto::VectorTileSearchService, std::string, FeatureIndexFileName, getFeatureIndexFileName, setFeatureIndexFileName)
+%std_io_exceptions(carto::VectorTileSearchService::setFeatureIndexFileName)
+%std_io_exceptions(carto::VectorTileSearchService::buildFeatureIndex)
+#endif
 
 %feature("director") carto::VectorTileSearchService;
 
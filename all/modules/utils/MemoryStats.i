@@ -0,0 +1,21 @@
+#ifndef _MEMORYSTATS_I
+#define _MEMORYSTATS_I
+
+%module MemoryStats
+
+!proxy_imports(carto::MemoryStats, core.Variant)
+
+%{
+#include "utils/MemoryStats.h"
+%}
+
+%include <cartoswig.i>
+
+%import "core/Variant.i"
+
+%ignore carto::MemoryStats::Allocated;
+%ignore carto::MemoryStats::Freed;
+
+%include "utils/MemoryStats.h"
+
+#endif
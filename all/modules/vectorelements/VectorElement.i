@@ -33,6 +33,7 @@
 %csmethodmodifiers carto::VectorElement::Geometry "public virtual";
 !attributestring_polymorphic(carto::VectorElement, geometry.Geometry, Geometry, getGeometry)
 %std_exceptions(carto::VectorElement::VectorElement)
+%ignore carto::VectorElement::getChangeGeneration;
 !standard_equals(carto::VectorElement);
 
 %include "vectorelements/VectorElement.h"
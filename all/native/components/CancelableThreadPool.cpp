@@ -1,91 +1,187 @@
 #include "CancelableThreadPool.h"
+#include "components/ThreadWorker.h"
 #include "utils/Log.h"
 #include "utils/ThreadUtils.h"
 
-#include "core/MapPos.h"
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace carto {
 
+    class CancelableThreadPool::Scheduler : public std::enable_shared_from_this<CancelableThreadPool::Scheduler> {
+    public:
+        Scheduler();
+        ~Scheduler();
+
+        void registerThreadPool(const std::shared_ptr<CancelableThreadPool>& threadPool);
+
+        static std::shared_ptr<Scheduler> GetInstance();
+
+        bool _stop;
+        long long _taskCount;
+
+        std::vector<std::weak_ptr<CancelableThreadPool> > _threadPools;
+        std::vector<std::shared_ptr<std::thread> > _threads;
+
+        mutable std::mutex _mutex;
+        std::condition_variable _condition;
+
+    private:
+        struct SchedulerWorker : public ThreadWorker {
+            SchedulerWorker(const std::shared_ptr<Scheduler>& scheduler);
+
+            void operator()();
+
+            std::weak_ptr<Scheduler> _scheduler;
+        };
+
+        bool getNextTask(std::shared_ptr<CancelableTask>& task, std::shared_ptr<CancelableThreadPool>& threadPool, ThreadQoS::ThreadQoS& qos);
+
+        static std::shared_ptr<Scheduler> _Instance;
+        static std::mutex _Mutex;
+    };
+
     CancelableThreadPool::CancelableThreadPool() :
         _poolSize(0),
-        _taskCount(0),
+        _runningCount(0),
+        _qos(ThreadQoS::UTILITY),
         _stop(false),
+        _registered(false),
         _taskRecords(),
-        _workers(),
-        _threads(),
-        _mutex()
+        _scheduler(Scheduler::GetInstance())
     {
     }
-    
+
     CancelableThreadPool::~CancelableThreadPool() {
     }
-        
+
     void CancelableThreadPool::deinit() {
-        {
-            std::lock_guard<std::mutex> lock(_mutex);
-            _stop = true;
-        }
-        
-        cancelAll();
-        
-        {
-            std::lock_guard<std::mutex> lock(_mutex);
-            _condition.notify_all();
-        }
-        
-        for (const std::shared_ptr<std::thread>& thread : _threads) {
-            thread->detach();
+        std::lock_guard<std::mutex> lock(_scheduler->_mutex);
+        _stop = true;
+
+        std::size_t taskRecordsSize = _taskRecords.size();
+        for (std::size_t i = 0; i < taskRecordsSize; i++) {
+            const std::shared_ptr<CancelableTask>& task = _taskRecords.top()._task;
+            task->cancel();
+            _taskRecords.pop();
         }
-        
-        _workers.clear();
-        _threads.clear();
     }
-    
+
     int CancelableThreadPool::getPoolSize() const {
-        std::lock_guard<std::mutex> lock(_mutex);
+        std::lock_guard<std::mutex> lock(_scheduler->_mutex);
         return _poolSize;
     }
-    
+
     void CancelableThreadPool::setPoolSize(int poolSize) {
-        std::lock_guard<std::mutex> lock(_mutex);
-        
+        std::lock_guard<std::mutex> lock(_scheduler->_mutex);
+
         if (_stop) {
             return;
         }
-    
-        // Add threads
-        for (int i = _poolSize; i < poolSize; i++) {
-            _workers.push_back(std::make_shared<TaskWorker>(shared_from_this()));
-            _threads.push_back(std::make_shared<std::thread>(&TaskWorker::operator(), _workers.back()));
-        }
-    
+
+        bool raised = poolSize > _poolSize;
         _poolSize = poolSize;
+
+        // Raising the limit may make queued tasks eligible for execution
+        if (raised) {
+            _scheduler->_condition.notify_all();
+        }
+    }
+
+    ThreadQoS::ThreadQoS CancelableThreadPool::getQoS() const {
+        std::lock_guard<std::mutex> lock(_scheduler->_mutex);
+        return _qos;
     }
-    
+
+    void CancelableThreadPool::setQoS(ThreadQoS::ThreadQoS qos) {
+        std::lock_guard<std::mutex> lock(_scheduler->_mutex);
+        _qos = qos;
+    }
+
     void CancelableThreadPool::execute(std::shared_ptr<CancelableTask> task) {
         execute(task, DEFAULT_PRIORITY);
     }
-    
+
     void CancelableThreadPool::execute(std::shared_ptr<CancelableTask> task, int priority) {
+        execute(task, priority, getQoS());
+    }
+
+    void CancelableThreadPool::execute(std::shared_ptr<CancelableTask> task, int priority, ThreadQoS::ThreadQoS qos) {
         if (!task->isCanceled()) {
-            std::lock_guard<std::mutex> lock(_mutex);
-            
-            if (_stop) {
+            std::lock_guard<std::mutex> lock(_scheduler->_mutex);
+
+            if (_stop || _scheduler->_stop) {
                 return;
             }
-    
+
+            // Register this pool with the shared scheduler when the first task arrives
+            if (!_registered) {
+                _scheduler->registerThreadPool(shared_from_this());
+                _registered = true;
+            }
+
             // Push task to queue, increase global task count
-            _taskRecords.push(TaskRecord(task, priority, _taskCount));
-            _taskCount++;
-    
+            _taskRecords.push(TaskRecord(task, priority, qos, _scheduler->_taskCount));
+            _scheduler->_taskCount++;
+
             // If there are any waiting threads, notify one of them
-            _condition.notify_one();
+            _scheduler->_condition.notify_one();
+        }
+    }
+
+    void CancelableThreadPool::reprioritize(const std::shared_ptr<CancelableTask>& task, int priority) {
+        std::lock_guard<std::mutex> lock(_scheduler->_mutex);
+
+        if (_stop) {
+            return;
+        }
+
+        // Rebuild the task queue with the updated priority, keep the original sequence numbers
+        std::vector<TaskRecord> taskRecords;
+        taskRecords.reserve(_taskRecords.size());
+        while (!_taskRecords.empty()) {
+            TaskRecord taskRecord = _taskRecords.top();
+            _taskRecords.pop();
+            if (taskRecord._task == task) {
+                taskRecord._priority = priority;
+            }
+            taskRecords.push_back(taskRecord);
+        }
+        for (const TaskRecord& taskRecord : taskRecords) {
+            _taskRecords.push(taskRecord);
+        }
+    }
+
+    void CancelableThreadPool::reprioritize(const std::shared_ptr<CancelableTask>& task, int priority, ThreadQoS::ThreadQoS qos) {
+        std::lock_guard<std::mutex> lock(_scheduler->_mutex);
+
+        if (_stop) {
+            return;
+        }
+
+        // Rebuild the task queue with the updated priority and QoS class, keep the original sequence numbers
+        std::vector<TaskRecord> taskRecords;
+        taskRecords.reserve(_taskRecords.size());
+        while (!_taskRecords.empty()) {
+            TaskRecord taskRecord = _taskRecords.top();
+            _taskRecords.pop();
+            if (taskRecord._task == task) {
+                taskRecord._priority = priority;
+                taskRecord._qos = qos;
+            }
+            taskRecords.push_back(taskRecord);
+        }
+        for (const TaskRecord& taskRecord : taskRecords) {
+            _taskRecords.push(taskRecord);
         }
     }
-    
+
     void CancelableThreadPool::cancelAll() {
-        std::lock_guard<std::mutex> lock(_mutex);
-        
+        std::lock_guard<std::mutex> lock(_scheduler->_mutex);
+
         std::size_t taskRecordsSize = _taskRecords.size();
         for (std::size_t i = 0; i < taskRecordsSize; i++) {
             const std::shared_ptr<CancelableTask>& task = _taskRecords.top()._task;
@@ -93,14 +189,15 @@ namespace carto {
             _taskRecords.pop();
         }
     }
-    
-    CancelableThreadPool::TaskRecord::TaskRecord(std::shared_ptr<CancelableTask> task, int priority, long long sequence) :
+
+    CancelableThreadPool::TaskRecord::TaskRecord(std::shared_ptr<CancelableTask> task, int priority, ThreadQoS::ThreadQoS qos, long long sequence) :
         _task(task),
         _priority(priority),
+        _qos(qos),
         _sequence(sequence)
     {
     }
-    
+
     bool CancelableThreadPool::TaskRecord::operator <(const TaskRecord& taskRecord) const {
         // Tasks are sorted according to their priority and then their sequence
         if (_priority != taskRecord._priority) {
@@ -108,97 +205,133 @@ namespace carto {
         }
         return _sequence > taskRecord._sequence;
     }
-    
-    CancelableThreadPool::TaskWorker::TaskWorker(const std::shared_ptr<CancelableThreadPool>& threadPool) :
-        _threadPool(threadPool) {
+
+    CancelableThreadPool::Scheduler::Scheduler() :
+        _stop(false),
+        _taskCount(0),
+        _threadPools(),
+        _threads(),
+        _mutex()
+    {
+    }
+
+    CancelableThreadPool::Scheduler::~Scheduler() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+            _condition.notify_all();
+        }
+
+        for (const std::shared_ptr<std::thread>& thread : _threads) {
+            thread->detach();
+        }
+    }
+
+    void CancelableThreadPool::Scheduler::registerThreadPool(const std::shared_ptr<CancelableThreadPool>& threadPool) {
+        _threadPools.push_back(threadPool);
+
+        // Start the shared workers lazily, one for each available core
+        if (_threads.empty()) {
+            int threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+            for (int i = 0; i < threadCount; i++) {
+                auto worker = std::make_shared<SchedulerWorker>(shared_from_this());
+                _threads.push_back(std::make_shared<std::thread>(&SchedulerWorker::operator(), worker));
+            }
+        }
+    }
+
+    std::shared_ptr<CancelableThreadPool::Scheduler> CancelableThreadPool::Scheduler::GetInstance() {
+        std::lock_guard<std::mutex> lock(_Mutex);
+        if (!_Instance) {
+            _Instance = std::make_shared<Scheduler>();
+        }
+        return _Instance;
     }
-        
-    void CancelableThreadPool::TaskWorker::operator ()() {
-        ThreadUtils::SetThreadPriority(ThreadPriority::MINIMUM);
+
+    CancelableThreadPool::Scheduler::SchedulerWorker::SchedulerWorker(const std::shared_ptr<Scheduler>& scheduler) :
+        _scheduler(scheduler)
+    {
+    }
+
+    void CancelableThreadPool::Scheduler::SchedulerWorker::operator ()() {
+        ThreadQoS::ThreadQoS currentQoS = ThreadQoS::BACKGROUND;
+        ThreadUtils::SetThreadQoS(currentQoS);
         while (true) {
-            auto threadPool = _threadPool.lock();
-            if (!threadPool) {
+            auto scheduler = _scheduler.lock();
+            if (!scheduler) {
                 return;
             }
 
-            // If there are no tasks, wait until notified or exit thread if interrupted
+            // Find the next eligible task, wait until notified if there is none
+            std::shared_ptr<CancelableTask> task;
+            std::shared_ptr<CancelableThreadPool> threadPool;
+            ThreadQoS::ThreadQoS qos = currentQoS;
             {
-                std::unique_lock<std::mutex> lock(threadPool->_mutex);
-                if (threadPool->_stop) {
+                std::unique_lock<std::mutex> lock(scheduler->_mutex);
+                if (scheduler->_stop) {
                     return;
                 }
-                
-                if (threadPool->_taskRecords.size() == 0) {
-                    threadPool->_condition.wait(lock);
+
+                if (!scheduler->getNextTask(task, threadPool, qos)) {
+                    scheduler->_condition.wait(lock);
+                    continue;
                 }
             }
-    
-            // Request another task, execute it if it's not null
-            while (true) {
-                {
-                    std::lock_guard<std::mutex> lock(threadPool->_mutex);
-                    if (threadPool->_stop) {
-                        return;
-                    }
-                }
-                
-                std::shared_ptr<CancelableTask> task = threadPool->getNextTask();
-                if (task) {
-                    task->operator ()();
-                } else {
-                    break;
-                }
-    
-                if (threadPool->shouldTerminateWorker(*this)) {
-                    return;
-                }
-    
-                // Check for interruption
-                std::this_thread::yield();
+
+            // Apply the QoS class of the task to the worker thread
+            if (qos != currentQoS) {
+                ThreadUtils::SetThreadQoS(qos);
+                currentQoS = qos;
             }
+
+            task->operator ()();
+
+            {
+                std::lock_guard<std::mutex> lock(scheduler->_mutex);
+                threadPool->_runningCount--;
+
+                // Finishing a task may make queued tasks from the same pool eligible
+                scheduler->_condition.notify_one();
+            }
+
+            // Release the references before looping, otherwise an idle worker would keep them alive
+            task.reset();
+            threadPool.reset();
+
+            std::this_thread::yield();
         }
     }
-    
-    std::shared_ptr<CancelableTask> CancelableThreadPool::getNextTask() {
-        std::lock_guard<std::mutex> lock(_mutex);
-    
-        // Return the next highest priority task from the task queue
-        std::shared_ptr<CancelableTask> task;
-        if (_taskRecords.size() > 0) {
-            task = _taskRecords.top()._task;
-            _taskRecords.pop();
-        }
-        return task;
-    }
-    
-    bool CancelableThreadPool::shouldTerminateWorker(TaskWorker& worker) {
-        std::lock_guard<std::mutex> lock(_mutex);
-        
-        if (_stop) {
-            return true;
-        }
-    
-        // If there are too many threads, remove this worker and it's thread
-        if (static_cast<int>(_threads.size()) > _poolSize) {
-    
-            // Find the index of the finished worker, it's thread will have the same index in _threads vector
-            int index = 0;
-            WorkerList::iterator it;
-            for (it = _workers.begin(); it != _workers.end(); ++it) {
-                const std::shared_ptr<TaskWorker>& listWorker = *it;
-                if (listWorker.get() == &worker) {
-                    // Remove thread and worker
-                    _workers.erase(it);
-                    _threads.erase(_threads.begin() + index);
-                    break;
+
+    bool CancelableThreadPool::Scheduler::getNextTask(std::shared_ptr<CancelableTask>& task, std::shared_ptr<CancelableThreadPool>& threadPool, ThreadQoS::ThreadQoS& qos) {
+        // Find the highest priority task among all the pools that have not reached their concurrency limits
+        std::shared_ptr<CancelableThreadPool> bestThreadPool;
+        for (auto it = _threadPools.begin(); it != _threadPools.end(); ) {
+            std::shared_ptr<CancelableThreadPool> pool = it->lock();
+            if (!pool) {
+                it = _threadPools.erase(it);
+                continue;
+            }
+            if (!pool->_stop && !pool->_taskRecords.empty() && pool->_runningCount < pool->_poolSize) {
+                if (!bestThreadPool || bestThreadPool->_taskRecords.top() < pool->_taskRecords.top()) {
+                    bestThreadPool = pool;
                 }
-                index++;
             }
-    
-            return true;
+            ++it;
+        }
+
+        if (!bestThreadPool) {
+            return false;
         }
-    
-        return false;
+
+        task = bestThreadPool->_taskRecords.top()._task;
+        qos = bestThreadPool->_taskRecords.top()._qos;
+        bestThreadPool->_taskRecords.pop();
+        bestThreadPool->_runningCount++;
+        threadPool = bestThreadPool;
+        return true;
     }
-    
+
+    std::shared_ptr<CancelableThreadPool::Scheduler> CancelableThreadPool::Scheduler::_Instance;
+    std::mutex CancelableThreadPool::Scheduler::_Mutex;
+
 }
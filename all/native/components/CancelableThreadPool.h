@@ -8,71 +8,70 @@
 #define _CARTO_CANCELABLETHREADPOOL_H_
 
 #include "components/CancelableTask.h"
-#include "components/ThreadWorker.h"
+#include "utils/ThreadUtils.h"
 
-#include <condition_variable>
 #include <memory>
 #include <queue>
-#include <thread>
 
 namespace carto {
 
+    /**
+     * A prioritized task queue backed by a process-wide shared set of worker threads.
+     * Each CancelableThreadPool instance acts as an independent priority lane and
+     * cancellation group, while the actual worker threads are shared between all
+     * instances and their count is tuned to the number of available cores.
+     */
     class CancelableThreadPool : public std::enable_shared_from_this<CancelableThreadPool> {
     public:
         CancelableThreadPool();
         virtual ~CancelableThreadPool();
         void deinit();
-    
+
         int getPoolSize() const;
-        void setPoolSize(int threadCount);
-    
+        void setPoolSize(int poolSize);
+
+        ThreadQoS::ThreadQoS getQoS() const;
+        void setQoS(ThreadQoS::ThreadQoS qos);
+
         void execute(std::shared_ptr<CancelableTask>);
         void execute(std::shared_ptr<CancelableTask>, int priority);
-    
+        void execute(std::shared_ptr<CancelableTask>, int priority, ThreadQoS::ThreadQoS qos);
+
+        void reprioritize(const std::shared_ptr<CancelableTask>& task, int priority);
+        void reprioritize(const std::shared_ptr<CancelableTask>& task, int priority, ThreadQoS::ThreadQoS qos);
+
         void cancelAll();
-        
+
     private:
         struct TaskRecord {
-            TaskRecord(std::shared_ptr<CancelableTask> task, int priority, long long sequence);
-    
+            TaskRecord(std::shared_ptr<CancelableTask> task, int priority, ThreadQoS::ThreadQoS qos, long long sequence);
+
             bool operator <(const TaskRecord& taskRecord) const;
-    
+
             std::shared_ptr<CancelableTask> _task;
             int _priority;
+            ThreadQoS::ThreadQoS _qos;
             long long _sequence;
         };
-    
-        struct TaskWorker : public ThreadWorker {
-            TaskWorker(const std::shared_ptr<CancelableThreadPool>& threadPool);
-    
-            void operator()();
-    
-            std::weak_ptr<CancelableThreadPool> _threadPool;
-        };
-    
+
+        class Scheduler;
+
         typedef std::priority_queue<TaskRecord> TaskRecordQueue;
-        typedef std::vector<std::shared_ptr<TaskWorker> > WorkerList;
-        typedef std::vector<std::shared_ptr<std::thread> > ThreadList;
-    
-        std::shared_ptr<CancelableTask> getNextTask();
-    
-        bool shouldTerminateWorker(TaskWorker& worker);
-    
+
         static const int DEFAULT_PRIORITY = 0;
-    
-        int _poolSize;
-        long long _taskCount;
-        
+
+        int _poolSize; // maximum number of concurrently running tasks from this pool
+        int _runningCount; // number of currently running tasks from this pool
+        ThreadQoS::ThreadQoS _qos; // default QoS class for tasks from this pool
+
         bool _stop;
-    
+        bool _registered;
+
         TaskRecordQueue _taskRecords;
-        WorkerList _workers;
-        ThreadList _threads;
-    
-        mutable std::mutex _mutex;
-        std::condition_variable _condition;
+
+        std::shared_ptr<Scheduler> _scheduler;
     };
-    
+
 }
 
 #endif
@@ -8,16 +8,22 @@ namespace carto {
 
         std::lock_guard<std::mutex> lock(registry._mutex);
         registry._classNames[std::type_index(typeInfo)] = name;
+        // Publish an immutable copy of the updated map. Registration happens only during
+        // static initialization, while lookups run on the hot object marshalling path
+        // and read the latest snapshot without taking the mutex.
+        std::atomic_store(&registry._classNamesSnapshot, std::make_shared<const std::unordered_map<std::type_index, std::string> >(registry._classNames));
         // Log::Infof("ClassRegistry: Registered class %s as %s", typeInfo.name(), name);
     }
-    
+
     std::string ClassRegistry::GetClassName(const std::type_info& typeInfo) {
         ClassRegistry& registry = GetInstance();
 
-        std::lock_guard<std::mutex> lock(registry._mutex);
-        auto it = registry._classNames.find(std::type_index(typeInfo));
-        if (it != registry._classNames.end()) {
-            return it->second;
+        std::shared_ptr<const std::unordered_map<std::type_index, std::string> > classNames = std::atomic_load(&registry._classNamesSnapshot);
+        if (classNames) {
+            auto it = classNames->find(std::type_index(typeInfo));
+            if (it != classNames->end()) {
+                return it->second;
+            }
         }
         Log::Errorf("ClassRegistry: Could not find class: %s", typeInfo.name());
         return std::string();
@@ -25,6 +31,7 @@ namespace carto {
 
     ClassRegistry::ClassRegistry() :
         _classNames(),
+        _classNamesSnapshot(),
         _mutex()
     {
     }
@@ -7,6 +7,7 @@
 #ifndef _CARTO_CLASSREGISTRY_H_
 #define _CARTO_CLASSREGISTRY_H_
 
+#include <memory>
 #include <typeinfo>
 #include <typeindex>
 #include <mutex>
@@ -31,6 +32,7 @@ namespace carto {
         static ClassRegistry& GetInstance();
 
         std::unordered_map<std::type_index, std::string> _classNames;
+        std::shared_ptr<const std::unordered_map<std::type_index, std::string> > _classNamesSnapshot; // immutable snapshot, accessed with std::atomic_load/atomic_store
         std::mutex _mutex;
     };
 
@@ -58,8 +58,16 @@ namespace carto {
         _projectionSurface(std::make_shared<PlanarProjectionSurface>()),
         _envelopeThreadPool(envelopeThreadPool),
         _tileThreadPool(tileThreadPool),
-        _mutex()
+        _tileFetchReprioritization(true),
+        _targetFrameTime(0),
+        _adaptiveTileQuality(false),
+        _mutex(),
+        _snapshot()
     {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            updateSnapshot();
+        }
         setEnvelopeThreadPoolSize(1);
         setTileThreadPoolSize(1);
     }
@@ -68,8 +76,7 @@ namespace carto {
     }
         
     Color Options::getAmbientLightColor() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _ambientLightColor;
+        return getSnapshot()->ambientLightColor;
     }
     
     void Options::setAmbientLightColor(const Color& color) {
@@ -79,13 +86,13 @@ namespace carto {
                 return;
             }
             _ambientLightColor = color;
+            updateSnapshot();
         }
         notifyOptionChanged("AmbientLightColor");
     }
     
     Color Options::getMainLightColor() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _mainLightColor;
+        return getSnapshot()->mainLightColor;
     }
     
     void Options::setMainLightColor(const Color& color) {
@@ -95,13 +102,13 @@ namespace carto {
                 return;
             }
             _mainLightColor = color;
+            updateSnapshot();
         }
         notifyOptionChanged("MainLightColor");
     }
     
     MapVec Options::getMainLightDirection() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _mainLightDir;
+        return getSnapshot()->mainLightDir;
     }
     
     void Options::setMainLightDirection(const MapVec& direction) {
@@ -113,13 +120,13 @@ namespace carto {
                 return;
             }
             _mainLightDir = directionNormalized;
+            updateSnapshot();
         }
         notifyOptionChanged("MainLightDirection");
     }
     
     RenderProjectionMode::RenderProjectionMode Options::getRenderProjectionMode() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _renderProjectionMode;
+        return getSnapshot()->renderProjectionMode;
     }
     
     void Options::setRenderProjectionMode(RenderProjectionMode::RenderProjectionMode renderProjectionMode) {
@@ -138,13 +145,13 @@ namespace carto {
                 _projectionSurface = std::make_shared<PlanarProjectionSurface>();
                 break;
             }
+            updateSnapshot();
         }
         notifyOptionChanged("RenderProjectionMode");
     }
     
     bool Options::isClickTypeDetection() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _clickTypeDetection;
+        return getSnapshot()->clickTypeDetection;
     }
     
     void Options::setClickTypeDetection(bool enabled) {
@@ -154,13 +161,13 @@ namespace carto {
                 return;
             }
             _clickTypeDetection = enabled;
+            updateSnapshot();
         }
         notifyOptionChanged("ClickTypeDetection");
     }
     
     int Options::getTileDrawSize() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _tileDrawSize;
+        return getSnapshot()->tileDrawSize;
     }
     
     void Options::setTileDrawSize(int tileDrawSize) {
@@ -170,13 +177,13 @@ namespace carto {
                 return;
             }
             _tileDrawSize = tileDrawSize;
+            updateSnapshot();
         }
         notifyOptionChanged("TileDrawSize");
     }
     
     float Options::getDPI() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _dpi;
+        return getSnapshot()->dpi;
     }
     
     void Options::setDPI(float dpi) {
@@ -186,13 +193,13 @@ namespace carto {
                 return;
             }
             _dpi = dpi;
+            updateSnapshot();
         }
         notifyOptionChanged("DPI");
     }
     
     float Options::getDrawDistance() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _drawDistance;
+        return getSnapshot()->drawDistance;
     }
     
     void Options::setDrawDistance(float drawDistance) {
@@ -202,13 +209,13 @@ namespace carto {
                 return;
             }
             _drawDistance = drawDistance;
+            updateSnapshot();
         }
         notifyOptionChanged("DrawDistance");
     }
     
     int Options::getFieldOfViewY() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _fovY;
+        return getSnapshot()->fovY;
     }
     
     void Options::setFieldOfViewY(int fovY) {
@@ -218,13 +225,13 @@ namespace carto {
                 return;
             }
             _fovY = fovY;
+            updateSnapshot();
         }
         notifyOptionChanged("FieldOfViewY");
     }
     
     PanningMode::PanningMode Options::getPanningMode() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _panningMode;
+        return getSnapshot()->panningMode;
     }
     
     void Options::setPanningMode(PanningMode::PanningMode panningMode) {
@@ -234,13 +241,13 @@ namespace carto {
                 return;
             }
             _panningMode = panningMode;
+            updateSnapshot();
         }
         notifyOptionChanged("PanningMode");
     }
     
     PivotMode::PivotMode Options::getPivotMode() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _pivotMode;
+        return getSnapshot()->pivotMode;
     }
 
     void Options::setPivotMode(PivotMode::PivotMode pivotMode) {
@@ -250,13 +257,13 @@ namespace carto {
                 return;
             }
             _pivotMode = pivotMode;
+            updateSnapshot();
         }
         notifyOptionChanged("PivotMode");
     }
 
     bool Options::isSeamlessPanning() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _seamlessPanning;
+        return getSnapshot()->seamlessPanning;
     }
     
     void Options::setSeamlessPanning(bool enabled) {
@@ -266,13 +273,13 @@ namespace carto {
                 return;
             }
             _seamlessPanning = enabled;
+            updateSnapshot();
         }
         notifyOptionChanged("SeamlessPanning");
     }
         
     bool Options::isRestrictedPanning() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _restrictedPanning;
+        return getSnapshot()->restrictedPanning;
     }
     
     void Options::setRestrictedPanning(bool enabled) {
@@ -282,13 +289,13 @@ namespace carto {
                 return;
             }
             _restrictedPanning = enabled;
+            updateSnapshot();
         }
         notifyOptionChanged("RestrictedPanning");
     }
         
     bool Options::isTiltGestureReversed() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _tiltGestureReversed;
+        return getSnapshot()->tiltGestureReversed;
     }
     
     void Options::setTiltGestureReversed(bool reversed) {
@@ -298,13 +305,13 @@ namespace carto {
                 return;
             }
             _tiltGestureReversed = reversed;
+            updateSnapshot();
         }
         notifyOptionChanged("TiltGestureReversed");
     }
         
     bool Options::isZoomGestures() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _zoomGestures;
+        return getSnapshot()->zoomGestures;
     }
     
     void Options::setZoomGestures(bool enabled) {
@@ -314,6 +321,7 @@ namespace carto {
                 return;
             }
             _zoomGestures = enabled;
+            updateSnapshot();
         }
         notifyOptionChanged("ZoomGestures");
     }
@@ -349,10 +357,57 @@ namespace carto {
         }
         notifyOptionChanged("TileThreadPoolSize");
     }
-    
+
+    bool Options::isTileFetchReprioritization() const {
+        return getSnapshot()->tileFetchReprioritization;
+    }
+
+    void Options::setTileFetchReprioritization(bool enabled) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_tileFetchReprioritization == enabled) {
+                return;
+            }
+            _tileFetchReprioritization = enabled;
+            updateSnapshot();
+        }
+        notifyOptionChanged("TileFetchReprioritization");
+    }
+
+    float Options::getTargetFrameTime() const {
+        return getSnapshot()->targetFrameTime;
+    }
+
+    void Options::setTargetFrameTime(float frameTime) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_targetFrameTime == frameTime) {
+                return;
+            }
+            _targetFrameTime = frameTime;
+            updateSnapshot();
+        }
+        notifyOptionChanged("TargetFrameTime");
+    }
+
+    bool Options::isAdaptiveTileQuality() const {
+        return getSnapshot()->adaptiveTileQuality;
+    }
+
+    void Options::setAdaptiveTileQuality(bool enabled) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_adaptiveTileQuality == enabled) {
+                return;
+            }
+            _adaptiveTileQuality = enabled;
+            updateSnapshot();
+        }
+        notifyOptionChanged("AdaptiveTileQuality");
+    }
+
     Color Options::getClearColor() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _clearColor;
+        return getSnapshot()->clearColor;
     }
 
     void Options::setClearColor(const Color& color) {
@@ -362,13 +417,13 @@ namespace carto {
                 return;
             }
             _clearColor = color;
+            updateSnapshot();
         }
         notifyOptionChanged("ClearColor");
     }
     
     Color Options::getSkyColor() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _skyColor;
+        return getSnapshot()->skyColor;
     }
 
     void Options::setSkyColor(const Color& color) {
@@ -378,6 +433,7 @@ namespace carto {
                 return;
             }
             _skyColor = color;
+            updateSnapshot();
         }
         notifyOptionChanged("SkyColor");
     }
@@ -396,8 +452,7 @@ namespace carto {
     }
 
     std::shared_ptr<Bitmap> Options::getBackgroundBitmap() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _backgroundBitmap;
+        return getSnapshot()->backgroundBitmap;
     }
 
     void Options::setBackgroundBitmap(const std::shared_ptr<Bitmap>& backgroundBitmap) {
@@ -407,13 +462,13 @@ namespace carto {
                 return;
             }
             _backgroundBitmap = backgroundBitmap;
+            updateSnapshot();
         }
         notifyOptionChanged("BackgroundBitmap");
     }
     
     float Options::getWatermarkAlignmentX() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _watermarkAlignmentX;
+        return getSnapshot()->watermarkAlignmentX;
     }
     
     void Options::setWatermarkAlignmentX(float alignmentX) {
@@ -424,13 +479,13 @@ namespace carto {
                 return;
             }
             _watermarkAlignmentX = alignmentXClipped;
+            updateSnapshot();
         }
         notifyOptionChanged("WatermarkAlignment");
     }
         
     float Options::getWatermarkAlignmentY() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _watermarkAlignmentY;
+        return getSnapshot()->watermarkAlignmentY;
     }
         
     void Options::setWatermarkAlignmentY(float alignmentY) {
@@ -441,13 +496,13 @@ namespace carto {
                 return;
             }
             _watermarkAlignmentY = alignmentYClipped;
+            updateSnapshot();
         }
         notifyOptionChanged("WatermarkAlignment");
     }
         
     float Options::getWatermarkScale() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _watermarkScale;
+        return getSnapshot()->watermarkScale;
     }
         
     void Options::setWatermarkScale(float scale) {
@@ -457,13 +512,13 @@ namespace carto {
                 return;
             }
             _watermarkScale = scale;
+            updateSnapshot();
         }
         notifyOptionChanged("WatermarkScale");
     }
         
     std::shared_ptr<Bitmap> Options::getWatermarkBitmap() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _watermarkBitmap;
+        return getSnapshot()->watermarkBitmap;
     }
     
     void Options::setWatermarkBitmap(const std::shared_ptr<Bitmap>& watermarkBitmap) {
@@ -473,13 +528,13 @@ namespace carto {
                 return;
             }
             _watermarkBitmap = watermarkBitmap;
+            updateSnapshot();
         }
         notifyOptionChanged("WatermarkBitmap");
     }
         
     ScreenPos Options::getWatermarkPadding() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _watermarkPadding;
+        return getSnapshot()->watermarkPadding;
     }
     
     void Options::setWatermarkPadding(const ScreenPos& padding) {
@@ -489,13 +544,13 @@ namespace carto {
                 return;
             }
             _watermarkPadding = padding;
+            updateSnapshot();
         }
         notifyOptionChanged("WatermarkPadding");
     }
     
     bool Options::isUserInput() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _userInput;
+        return getSnapshot()->userInput;
     }
     
     void Options::setUserInput(bool enabled) {
@@ -505,13 +560,13 @@ namespace carto {
                 return;
             }
             _userInput = enabled;
+            updateSnapshot();
         }
         notifyOptionChanged("UserInput");
     }
     
     bool Options::isKineticPan() {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _kineticPan;
+        return getSnapshot()->kineticPan;
     }
     
     void Options::setKineticPan(bool enabled) {
@@ -521,13 +576,13 @@ namespace carto {
                 return;
             }
             _kineticPan = enabled;
+            updateSnapshot();
         }
         notifyOptionChanged("KineticPan");
     }
     
     bool Options::isKineticRotation() {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _kineticRotation;
+        return getSnapshot()->kineticRotation;
     }
     
     void Options::setKineticRotation(bool enabled) {
@@ -537,13 +592,13 @@ namespace carto {
                 return;
             }
             _kineticRotation = enabled;
+            updateSnapshot();
         }
         notifyOptionChanged("KineticRotation");
     }
         
     bool Options::isKineticZoom() {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _kineticZoom;
+        return getSnapshot()->kineticZoom;
     }
     
     void Options::setKineticZoom(bool enabled) {
@@ -553,13 +608,13 @@ namespace carto {
                 return;
             }
             _kineticZoom = enabled;
+            updateSnapshot();
         }
         notifyOptionChanged("KineticZoom");
     }
     
     bool Options::isRotatable() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _rotatable;
+        return getSnapshot()->rotatable;
     }
     
     void Options::setRotatable(bool rotatable) {
@@ -569,13 +624,13 @@ namespace carto {
                 return;
             }
             _rotatable = rotatable;
+            updateSnapshot();
         }
         notifyOptionChanged("Rotatable");
     }
     
     MapRange Options::getTiltRange() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _tiltRange;
+        return getSnapshot()->tiltRange;
     }
     
     void Options::setTiltRange(const MapRange& tiltRange) {
@@ -591,13 +646,13 @@ namespace carto {
                 return;
             }
             _tiltRange = tiltRangeClipped;
+            updateSnapshot();
         }
         notifyOptionChanged("TiltRange");
     }
     
     MapRange Options::getZoomRange() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _zoomRange;
+        return getSnapshot()->zoomRange;
     }
     
     void Options::setZoomRange(const MapRange& zoomRange) {
@@ -613,13 +668,13 @@ namespace carto {
                 return;
             }
             _zoomRange = zoomRangeClipped;
+            updateSnapshot();
         }
         notifyOptionChanged("ZoomRange");
     }
         
     MapBounds Options::getPanBounds() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _panBounds;
+        return getSnapshot()->panBounds;
     }
     
     void Options::setPanBounds(const MapBounds& panBounds) {
@@ -632,39 +687,40 @@ namespace carto {
                 return;
             }
             _panBounds = panBounds;
+            updateSnapshot();
         }
         notifyOptionChanged("PanBounds");
     }
     
     MapBounds Options::getAdjustedInternalPanBounds(bool clamp) const {
-        std::lock_guard<std::mutex> lock(_mutex);
+        std::shared_ptr<const Snapshot> snapshot = getSnapshot();
 
-        MapBounds panBoundsClipped = _panBounds;
-        panBoundsClipped.shrinkToIntersection(_baseProjection->getBounds());
+        MapBounds panBoundsClipped = snapshot->panBounds;
+        panBoundsClipped.shrinkToIntersection(snapshot->baseProjection->getBounds());
 
-        MapPos panBoundsMin = _panBounds.getMin();
-        MapPos panBoundsMax = _panBounds.getMax();
+        MapPos panBoundsMin = snapshot->panBounds.getMin();
+        MapPos panBoundsMax = snapshot->panBounds.getMax();
         if (std::isfinite(panBoundsMin.getX())) {
-            panBoundsMin.setX(_baseProjection->toInternal(panBoundsClipped.getMin()).getX());
+            panBoundsMin.setX(snapshot->baseProjection->toInternal(panBoundsClipped.getMin()).getX());
         }
         if (std::isfinite(panBoundsMin.getY())) {
-            panBoundsMin.setY(_baseProjection->toInternal(panBoundsClipped.getMin()).getY());
+            panBoundsMin.setY(snapshot->baseProjection->toInternal(panBoundsClipped.getMin()).getY());
         }
         if (std::isfinite(panBoundsMax.getX())) {
-            panBoundsMax.setX(_baseProjection->toInternal(panBoundsClipped.getMax()).getX());
+            panBoundsMax.setX(snapshot->baseProjection->toInternal(panBoundsClipped.getMax()).getX());
         }
         if (std::isfinite(panBoundsMax.getY())) {
-            panBoundsMax.setY(_baseProjection->toInternal(panBoundsClipped.getMax()).getY());
+            panBoundsMax.setY(snapshot->baseProjection->toInternal(panBoundsClipped.getMax()).getY());
         }
 
-        if (_renderProjectionMode == RenderProjectionMode::RENDER_PROJECTION_MODE_PLANAR) {
+        if (snapshot->renderProjectionMode == RenderProjectionMode::RENDER_PROJECTION_MODE_PLANAR) {
             EPSG3857 proj;
             MapPos projBoundsMin = proj.toInternal(proj.getBounds().getMin());
             MapPos projBoundsMax = proj.toInternal(proj.getBounds().getMax());
 
             panBoundsMin.setY(std::max(panBoundsMin.getY(), projBoundsMin.getY()));
             panBoundsMax.setY(std::min(panBoundsMax.getY(), projBoundsMax.getY()));
-            if (!_seamlessPanning) {
+            if (!snapshot->seamlessPanning) {
                 panBoundsMin.setX(std::max(panBoundsMin.getX(), projBoundsMin.getX()));
                 panBoundsMax.setX(std::min(panBoundsMax.getX(), projBoundsMax.getX()));
             }
@@ -680,8 +736,7 @@ namespace carto {
     }
     
     ScreenPos Options::getFocusPointOffset() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _focusPointOffset;
+        return getSnapshot()->focusPointOffset;
     }
     
     void Options::setFocusPointOffset(const ScreenPos& offset) {
@@ -691,13 +746,13 @@ namespace carto {
                 return;
             }
             _focusPointOffset = offset;
+            updateSnapshot();
         }
         notifyOptionChanged("FocusPointOffset");
     }
     
     std::shared_ptr<Projection> Options::getBaseProjection() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _baseProjection;
+        return getSnapshot()->baseProjection;
     }
     
     void Options::setBaseProjection(const std::shared_ptr<Projection>& baseProjection) {
@@ -711,15 +766,19 @@ namespace carto {
                 return;
             }
             _baseProjection = baseProjection;
+            updateSnapshot();
         }
         notifyOptionChanged("BaseProjection");
     }
     
     std::shared_ptr<ProjectionSurface> Options::getProjectionSurface() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _projectionSurface;
+        return getSnapshot()->projectionSurface;
     }
-    
+
+    std::shared_ptr<const Options::Snapshot> Options::getSnapshot() const {
+        return std::atomic_load(&_snapshot);
+    }
+
     void Options::registerOnChangeListener(const std::shared_ptr<OnChangeListener>& listener) {
         std::lock_guard<std::mutex> lock(_onChangeListenersMutex);
         _onChangeListeners.push_back(listener);
@@ -762,6 +821,53 @@ namespace carto {
         return _ExpiredWatermarkBitmap;
     }
         
+    void Options::updateSnapshot() {
+        // Copy all the option values into a fresh snapshot instance and publish it
+        // atomically. Must be called with the mutex locked. As the readers access the
+        // published snapshots without locking, the old instance is never modified.
+        auto snapshot = std::make_shared<Snapshot>();
+        snapshot->ambientLightColor = _ambientLightColor;
+        snapshot->mainLightColor = _mainLightColor;
+        snapshot->mainLightDir = _mainLightDir;
+        snapshot->renderProjectionMode = _renderProjectionMode;
+        snapshot->clickTypeDetection = _clickTypeDetection;
+        snapshot->tileDrawSize = _tileDrawSize;
+        snapshot->dpi = _dpi;
+        snapshot->drawDistance = _drawDistance;
+        snapshot->fovY = _fovY;
+        snapshot->panningMode = _panningMode;
+        snapshot->pivotMode = _pivotMode;
+        snapshot->seamlessPanning = _seamlessPanning;
+        snapshot->restrictedPanning = _restrictedPanning;
+        snapshot->tiltGestureReversed = _tiltGestureReversed;
+        snapshot->zoomGestures = _zoomGestures;
+        snapshot->clearColor = _clearColor;
+        snapshot->skyColor = _skyColor;
+        snapshot->backgroundBitmap = _backgroundBitmap;
+        snapshot->watermarkAlignmentX = _watermarkAlignmentX;
+        snapshot->watermarkAlignmentY = _watermarkAlignmentY;
+        snapshot->watermarkBitmap = _watermarkBitmap;
+        snapshot->watermarkPadding = _watermarkPadding;
+        snapshot->watermarkScale = _watermarkScale;
+        snapshot->userInput = _userInput;
+        snapshot->kineticPan = _kineticPan;
+        snapshot->kineticRotation = _kineticRotation;
+        snapshot->kineticZoom = _kineticZoom;
+        snapshot->rotatable = _rotatable;
+        snapshot->tiltRange = _tiltRange;
+        snapshot->zoomRange = _zoomRange;
+        snapshot->panBounds = _panBounds;
+        snapshot->focusPointOffset = _focusPointOffset;
+        snapshot->baseProjection = _baseProjection;
+        snapshot->projectionSurface = _projectionSurface;
+        snapshot->tileFetchReprioritization = _tileFetchReprioritization;
+        snapshot->targetFrameTime = _targetFrameTime;
+        snapshot->adaptiveTileQuality = _adaptiveTileQuality;
+        std::shared_ptr<const Snapshot> oldSnapshot = std::atomic_load(&_snapshot);
+        snapshot->generation = (oldSnapshot ? oldSnapshot->generation + 1 : 0);
+        std::atomic_store(&_snapshot, std::shared_ptr<const Snapshot>(std::move(snapshot)));
+    }
+
     void Options::notifyOptionChanged(const std::string& optionName) {
         std::vector<std::shared_ptr<OnChangeListener> > onChangeListeners;
         {
@@ -99,6 +99,52 @@ namespace carto {
             virtual void onOptionChanged(const std::string& optionName) = 0;
         };
 
+        /**
+         * An immutable snapshot of the option values. A new snapshot instance is published
+         * atomically every time an option changes, thus readers can access a consistent
+         * set of option values via a single atomic load, without blocking the writers.
+         */
+        struct Snapshot {
+            Color ambientLightColor;
+            Color mainLightColor;
+            MapVec mainLightDir;
+            RenderProjectionMode::RenderProjectionMode renderProjectionMode;
+            bool clickTypeDetection;
+            int tileDrawSize;
+            float dpi;
+            float drawDistance;
+            int fovY;
+            PanningMode::PanningMode panningMode;
+            PivotMode::PivotMode pivotMode;
+            bool seamlessPanning;
+            bool restrictedPanning;
+            bool tiltGestureReversed;
+            bool zoomGestures;
+            Color clearColor;
+            Color skyColor;
+            std::shared_ptr<Bitmap> backgroundBitmap;
+            float watermarkAlignmentX;
+            float watermarkAlignmentY;
+            std::shared_ptr<Bitmap> watermarkBitmap;
+            ScreenPos watermarkPadding;
+            float watermarkScale;
+            bool userInput;
+            bool kineticPan;
+            bool kineticRotation;
+            bool kineticZoom;
+            bool rotatable;
+            MapRange tiltRange;
+            MapRange zoomRange;
+            MapBounds panBounds;
+            ScreenPos focusPointOffset;
+            std::shared_ptr<Projection> baseProjection;
+            std::shared_ptr<ProjectionSurface> projectionSurface;
+            bool tileFetchReprioritization;
+            float targetFrameTime;
+            bool adaptiveTileQuality;
+            long long generation;
+        };
+
         /**
          * Constructs an Options object with all parameters set to defaults.
          * @param envelopeThreadPool The thread pool used for envelope tasks.
@@ -292,8 +338,8 @@ namespace carto {
          */
         int getEnvelopeThreadPoolSize() const;
         /**
-         * Sets the number of threads used by the envelope task pool. More threads means more envelope tasks 
-         * are executed in parallel. This might speed up the data query, but may cause performance drops. Default is 1.
+         * Sets the maximum number of envelope tasks executed in parallel. Higher values
+         * might speed up the data query, but may cause performance drops. Default is 1.
          * @param poolSize The new envelope task thread pool size.
          */
         void setEnvelopeThreadPoolSize(int poolSize);
@@ -304,12 +350,54 @@ namespace carto {
          */
         int getTileThreadPoolSize() const;
         /**
-         * Sets the number of threads used by the tile task pool. More threads means more tile tasks
-         * are executed in parallel. This might speed up the data query, but may cause performance drops. Default is 1.
+         * Sets the maximum number of tile tasks executed in parallel. Higher values
+         * might speed up the data query, but may cause performance drops. Default is 1.
          * @param poolSize The new tile task thread pool size.
          */
         void setTileThreadPoolSize(int poolSize);
-    
+
+        /**
+         * Returns the state of the tile fetch reprioritization flag.
+         * @return True if pending tile fetch tasks are reprioritized, false otherwise.
+         */
+        bool isTileFetchReprioritization() const;
+        /**
+         * Sets the tile fetch reprioritization flag. If enabled, pending tile fetch tasks are
+         * reordered on every view change based on their distance from the camera, with aging
+         * applied to prevent starvation of distant tiles. By default, reprioritization is enabled.
+         * @param enabled True if pending tile fetch tasks should be reprioritized, false otherwise.
+         */
+        void setTileFetchReprioritization(bool enabled);
+
+        /**
+         * Returns the target frame time of the renderer.
+         * @return The target frame time in seconds. Zero if the frame budget governor is disabled.
+         */
+        float getTargetFrameTime() const;
+        /**
+         * Sets the target frame time of the renderer. If the render stages of a frame take longer
+         * than the given budget, non-essential work (animation interpolation steps, billboard
+         * re-placement) is deferred to the next frame instead of slowing down every frame uniformly.
+         * By default, the target frame time is 0 and the frame budget governor is disabled.
+         * @param frameTime The new target frame time in seconds. Use 0 to disable the frame budget governor.
+         */
+        void setTargetFrameTime(float frameTime);
+
+        /**
+         * Returns the state of the adaptive tile quality flag.
+         * @return True if tile layers adapt their detail level to the frame budget, false otherwise.
+         */
+        bool isAdaptiveTileQuality() const;
+        /**
+         * Sets the adaptive tile quality flag. If enabled together with a non-zero target frame time,
+         * tile layers reduce their detail level (coarser vector tiles, downsampled raster tile textures)
+         * when the render stages stay over the frame budget for several seconds, as happens under
+         * thermal throttling. The full detail level is restored once enough headroom returns.
+         * By default, adaptive tile quality is disabled.
+         * @param enabled True if tile layers should adapt their detail level to the frame budget, false otherwise.
+         */
+        void setAdaptiveTileQuality(bool enabled);
+
         /**
          * Returns the clear color used by the renderer before drawing anything else.
          * By default, this is white. It should be set to (0, 0, 0, 0) if transparent MapView is needed.
@@ -554,7 +642,16 @@ namespace carto {
          * @return The projection surface.
          */
         std::shared_ptr<ProjectionSurface> getProjectionSurface() const;
-        
+
+        /**
+         * Returns the current snapshot of the option values. Reading several options
+         * from the same snapshot instance guarantees a consistent view of the options
+         * and is cheaper than calling the individual getters. The generation counter
+         * of the snapshot can be used to detect option changes between frames.
+         * @return The current snapshot of the option values.
+         */
+        std::shared_ptr<const Snapshot> getSnapshot() const;
+
         /**
          * Registers listener for options change events.
          * @param listener The listener for change events.
@@ -581,7 +678,9 @@ namespace carto {
         static const MapVec DEFAULT_MAIN_LIGHT_DIR;
         
         void notifyOptionChanged(const std::string& optionName);
-        
+
+        void updateSnapshot();
+
         Color _ambientLightColor;
         Color _mainLightColor;
         MapVec _mainLightDir;
@@ -643,9 +742,16 @@ namespace carto {
     
         std::shared_ptr<CancelableThreadPool> _envelopeThreadPool;
         std::shared_ptr<CancelableThreadPool> _tileThreadPool;
-    
+
+        bool _tileFetchReprioritization;
+
+        float _targetFrameTime;
+        bool _adaptiveTileQuality;
+
         mutable std::mutex _mutex;
 
+        std::shared_ptr<const Snapshot> _snapshot; // immutable snapshot, accessed with std::atomic_load/atomic_store
+
         std::vector<std::shared_ptr<OnChangeListener> > _onChangeListeners;
         mutable std::mutex _onChangeListenersMutex;
 
@@ -1,6 +1,6 @@
 #include "Address.h"
 
-#include <sstream>
+#include <utility>
 
 namespace carto {
 
@@ -85,34 +85,46 @@ namespace carto {
     }
 
     std::string Address::toString() const {
-        std::vector<std::pair<std::string, std::string> > items {
-            { "country",       _country       },
-            { "region",        _region        },
-            { "county",        _county        },
-            { "locality",      _locality      },
-            { "neighbourhood", _neighbourhood },
-            { "street",        _street        },
-            { "postcode",      _postcode      },
-            { "houseNumber",   _houseNumber   },
-            { "name",          _name          }
+        const std::pair<const char*, const std::string*> items[] = {
+            { "country",       &_country       },
+            { "region",        &_region        },
+            { "county",        &_county        },
+            { "locality",      &_locality      },
+            { "neighbourhood", &_neighbourhood },
+            { "street",        &_street        },
+            { "postcode",      &_postcode      },
+            { "houseNumber",   &_houseNumber   },
+            { "name",          &_name          }
         };
-        std::stringstream ss;
-        ss << "Address [";
+        std::string str;
+        str.reserve(128);
+        str += "Address [";
         bool empty = true;
-        for (const std::pair<std::string, std::string>& item : items) {
-            if (!item.second.empty()) {
-                ss << (empty ? "" : ", ") << item.first << "=" << item.second;
+        for (const std::pair<const char*, const std::string*>& item : items) {
+            if (!item.second->empty()) {
+                if (!empty) {
+                    str += ", ";
+                }
+                str += item.first;
+                str += "=";
+                str += *item.second;
                 empty = false;
             }
         }
         if (!_categories.empty()) {
-            ss << (empty ? "" : ", ") << "categories=";
+            if (!empty) {
+                str += ", ";
+            }
+            str += "categories=";
             for (std::size_t i = 0; i < _categories.size(); i++) {
-                ss << (i == 0 ? "" : ";") << _categories[i];
+                if (i > 0) {
+                    str += ";";
+                }
+                str += _categories[i];
             }
         }
-        ss << "]";
-        return ss.str();
+        str += "]";
+        return str;
     }
     
 }
@@ -19,7 +19,12 @@ namespace carto {
         _dataPtr(std::make_shared<std::vector<unsigned char> >(data, data + size))
     {
     }
-    
+
+    BinaryData::BinaryData(std::shared_ptr<std::vector<unsigned char> > dataPtr) :
+        _dataPtr(dataPtr ? std::move(dataPtr) : std::make_shared<std::vector<unsigned char> >())
+    {
+    }
+
     bool BinaryData::empty() const {
         return _dataPtr->empty();
     }
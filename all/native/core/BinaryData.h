@@ -34,6 +34,12 @@ namespace carto {
          * @param size The size of the data in bytes.
          */
         BinaryData(const unsigned char* dataPtr, std::size_t size);
+        /**
+         * Constructs a BinaryData object from a shared byte vector without copying the data.
+         * The vector must not be modified after it is handed over to the BinaryData object.
+         * @param dataPtr The shared pointer to the byte vector.
+         */
+        explicit BinaryData(std::shared_ptr<std::vector<unsigned char> > dataPtr);
 
         /**
          * Check if the data is empty (size is 0).
@@ -2,56 +2,74 @@
 #include "components/Exceptions.h"
 #include "utils/Log.h"
 
+#include <istream>
+
+namespace {
+
+    const picojson::value NULL_PICOJSON_VALUE = picojson::value();
+
+}
+
 namespace carto {
 
     Variant::Variant() :
-        _value()
+        _rootValue(),
+        _value(nullptr)
     {
     }
 
     Variant::Variant(bool boolVal) :
-        _value(boolVal)
+        _rootValue(std::make_shared<picojson::value>(boolVal)),
+        _value(_rootValue.get())
     {
     }
 
     Variant::Variant(long long longVal) :
-        _value(static_cast<std::int64_t>(longVal))
+        _rootValue(std::make_shared<picojson::value>(static_cast<std::int64_t>(longVal))),
+        _value(_rootValue.get())
     {
     }
 
     Variant::Variant(double doubleVal) :
-        _value(doubleVal)
+        _rootValue(std::make_shared<picojson::value>(doubleVal)),
+        _value(_rootValue.get())
     {
     }
 
     Variant::Variant(const char* str) :
-        _value(std::string(str))
+        _rootValue(std::make_shared<picojson::value>(std::string(str))),
+        _value(_rootValue.get())
     {
     }
 
     Variant::Variant(const std::string& string) :
-        _value(string)
+        _rootValue(std::make_shared<picojson::value>(string)),
+        _value(_rootValue.get())
     {
     }
 
     Variant::Variant(const std::vector<Variant>& array) :
-        _value()
+        _rootValue(),
+        _value(nullptr)
     {
         picojson::value::array valArr;
         for (auto it = array.begin(); it != array.end(); it++) {
             valArr.push_back(it->toPicoJSON());
         }
-        _value = picojson::value(valArr);
+        _rootValue = std::make_shared<picojson::value>(valArr);
+        _value = _rootValue.get();
     }
 
     Variant::Variant(const std::map<std::string, Variant>& object) :
-        _value()
+        _rootValue(),
+        _value(nullptr)
     {
         picojson::value::object valObj;
         for (auto it = object.begin(); it != object.end(); it++) {
             valObj[it->first] = it->second.toPicoJSON();
         }
-        _value = picojson::value(valObj);
+        _rootValue = std::make_shared<picojson::value>(valObj);
+        _value = _rootValue.get();
     }
 
     VariantType::VariantType Variant::getType() const {
@@ -118,12 +136,13 @@ namespace carto {
         if (val.is<picojson::value::array>()) {
             const picojson::array& valArr = val.get<picojson::value::array>();
             if (idx >= 0 && idx < static_cast<int>(valArr.size())) {
-                return FromPicoJSON(valArr[idx]);
+                // Share the underlying document instead of copying the subtree
+                return FromSubValue(_rootValue, &valArr[idx]);
             }
         }
         return Variant();
     }
-    
+
     std::vector<std::string> Variant::getObjectKeys() const {
         const picojson::value& val = toPicoJSON();
         std::vector<std::string> keys;
@@ -143,15 +162,15 @@ namespace carto {
         }
         return false;
     }
-    
+
     Variant Variant::getObjectElement(const std::string& key) const {
         const picojson::value& val = toPicoJSON();
-        std::vector<std::string> keys;
         if (val.is<picojson::value::object>()) {
             const picojson::object& valObj = val.get<picojson::value::object>();
             auto it = valObj.find(key);
             if (it != valObj.end()) {
-                return FromPicoJSON(it->second);
+                // Share the underlying document instead of copying the subtree
+                return FromSubValue(_rootValue, &it->second);
             }
         }
         return Variant();
@@ -174,7 +193,7 @@ namespace carto {
     }
 
     const picojson::value& Variant::toPicoJSON() const {
-        return _value;
+        return _value ? *_value : NULL_PICOJSON_VALUE;
     }
 
     Variant Variant::FromString(const std::string& str) {
@@ -183,14 +202,30 @@ namespace carto {
         if (!err.empty()) {
             throw ParseException(std::string("Variant parsing failed: ") + err, str);
         }
+        return FromPicoJSON(std::move(val));
+    }
+
+    Variant Variant::FromStream(std::istream& stream) {
+        picojson::value val;
+        std::string err;
+        picojson::parse(val, std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>(), &err);
+        if (!err.empty()) {
+            throw ParseException(std::string("Variant parsing failed: ") + err);
+        }
+        return FromPicoJSON(std::move(val));
+    }
+
+    Variant Variant::FromPicoJSON(picojson::value val) {
         Variant var;
-        var._value = std::move(val);
+        var._rootValue = std::make_shared<picojson::value>(std::move(val));
+        var._value = var._rootValue.get();
         return var;
     }
 
-    Variant Variant::FromPicoJSON(picojson::value val) {
+    Variant Variant::FromSubValue(std::shared_ptr<const picojson::value> rootValue, const picojson::value* value) {
         Variant var;
-        var._value = std::move(val);
+        var._rootValue = std::move(rootValue);
+        var._value = value;
         return var;
     }
 
@@ -8,6 +8,7 @@
 #define _CARTO_VARIANT_H_
 
 #include <cstdint>
+#include <iosfwd>
 #include <memory>
 #include <string>
 #include <vector>
@@ -55,6 +56,8 @@ namespace carto {
     
     /**
      * JSON value. Can contain JSON-style structured data, including objects and arrays.
+     * Variant objects are immutable. Variants returned for array and object elements
+     * share the underlying document with the parent variant, no data is copied.
      */
     class Variant {
     public:
@@ -194,6 +197,15 @@ namespace carto {
          */
         static Variant FromString(const std::string& str);
 
+        /**
+         * Creates a Variant object by reading the JSON representation from a stream.
+         * Compared to FromString, this avoids materializing the full document as a string first.
+         * @param stream The stream to read the JSON representation from.
+         * @return The corresponding Variant object.
+         * @throws std::runtime_exception If the stream parsing fails.
+         */
+        static Variant FromStream(std::istream& stream);
+
         /**
          * Creates Variant object from a PicoJSON value.
          * @param val The PicoJSON value to use.
@@ -202,7 +214,10 @@ namespace carto {
         static Variant FromPicoJSON(picojson::value val);
 
     private:
-        picojson::value _value;
+        static Variant FromSubValue(std::shared_ptr<const picojson::value> rootValue, const picojson::value* value);
+
+        std::shared_ptr<const picojson::value> _rootValue;
+        const picojson::value* _value;
     };
 
 }
@@ -1,15 +1,27 @@
 #include "CacheTileDataSource.h"
 #include "core/MapTile.h"
+#include "components/CancelableThreadPool.h"
 #include "components/Exceptions.h"
+#include "datasources/components/TileData.h"
+#include "projections/Projection.h"
 #include "utils/Log.h"
+#include "utils/TileUtils.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <memory>
 
 namespace carto {
     
     CacheTileDataSource::CacheTileDataSource(const std::shared_ptr<TileDataSource>& dataSource) :
         TileDataSource(),
-        _dataSource(dataSource)
+        _dataSource(dataSource),
+        _tileTTL(-1),
+        _refreshThreadPool(),
+        _refreshingTiles(),
+        _refreshMutex(),
+        _failedTiles(),
+        _failedTilesMutex()
     {
         if (!dataSource) {
             throw NullArgumentException("Null dataSource");
@@ -20,6 +32,16 @@ namespace carto {
     }
     
     CacheTileDataSource::~CacheTileDataSource() {
+        std::shared_ptr<CancelableThreadPool> refreshThreadPool;
+        {
+            std::lock_guard<std::mutex> lock(_refreshMutex);
+            std::swap(refreshThreadPool, _refreshThreadPool);
+        }
+        if (refreshThreadPool) {
+            refreshThreadPool->cancelAll();
+            refreshThreadPool->deinit();
+        }
+
         _dataSource->unregisterOnChangeListener(_dataSourceListener);
         _dataSourceListener.reset();
     }
@@ -38,13 +60,172 @@ namespace carto {
 
     void CacheTileDataSource::notifyTilesChanged(bool removeTiles) {
         clear();
+        clearTileFetchFailures();
         TileDataSource::notifyTilesChanged(removeTiles);
     }
 
+    void CacheTileDataSource::invalidateTiles(const MapBounds& mapBounds, int minZoom, int maxZoom) {
+        minZoom = std::max(minZoom, getMinZoom());
+        maxZoom = std::min(maxZoom, getMaxZoom());
+
+        // If the region covers too many tiles, fall back to a full refresh
+        std::uint64_t tileCount = 0;
+        for (int zoom = minZoom; zoom <= maxZoom; zoom++) {
+            MapTile mapTile1 = TileUtils::CalculateMapTile(mapBounds.getMin(), zoom, getProjection());
+            MapTile mapTile2 = TileUtils::CalculateMapTile(mapBounds.getMax(), zoom, getProjection());
+            std::uint64_t dx = std::abs(mapTile1.getX() - mapTile2.getX()) + 1;
+            std::uint64_t dy = std::abs(mapTile1.getY() - mapTile2.getY()) + 1;
+            tileCount += dx * dy;
+        }
+        if (maxZoom < minZoom || tileCount > MAX_REGION_INVALIDATION_TILES) {
+            notifyTilesChanged(false);
+            return;
+        }
+
+        // Drop the affected tiles from the cache, so that the next load goes to the original data source
+        for (int zoom = minZoom; zoom <= maxZoom; zoom++) {
+            MapTile mapTile1 = TileUtils::CalculateMapTile(mapBounds.getMin(), zoom, getProjection());
+            MapTile mapTile2 = TileUtils::CalculateMapTile(mapBounds.getMax(), zoom, getProjection());
+            for (int y = std::min(mapTile1.getY(), mapTile2.getY()); y <= std::max(mapTile1.getY(), mapTile2.getY()); y++) {
+                for (int x = std::min(mapTile1.getX(), mapTile2.getX()); x <= std::max(mapTile1.getX(), mapTile2.getX()); x++) {
+                    long long tileId = MapTile(x, y, zoom, 0).getFlipped().getTileId();
+                    removeTileFromCache(tileId);
+                    {
+                        std::lock_guard<std::mutex> lock(_failedTilesMutex);
+                        _failedTiles.erase(tileId);
+                    }
+                }
+            }
+        }
+
+        TileDataSource::notifyTilesChanged(mapBounds, minZoom, maxZoom);
+    }
+
+    CacheStats CacheTileDataSource::getCacheStats() const {
+        return CacheStats();
+    }
+
+    void CacheTileDataSource::removeTileFromCache(long long tileId) {
+    }
+
+    bool CacheTileDataSource::isTileFetchBlocked(long long tileId) const {
+        std::lock_guard<std::mutex> lock(_failedTilesMutex);
+        auto it = _failedTiles.find(tileId);
+        if (it == _failedTiles.end()) {
+            return false;
+        }
+        return std::chrono::steady_clock::now() < it->second.retryTime;
+    }
+
+    void CacheTileDataSource::registerTileFetchResult(long long tileId, const std::shared_ptr<TileData>& tileData) {
+        std::lock_guard<std::mutex> lock(_failedTilesMutex);
+
+        if (tileData && tileData->getErrorCode() == 0) {
+            _failedTiles.erase(tileId);
+            return;
+        }
+
+        if (_failedTiles.size() >= static_cast<std::size_t>(MAX_FAILED_TILES) && _failedTiles.find(tileId) == _failedTiles.end()) {
+            // Drop the expired entries first, as a last resort forget all the failures
+            std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
+            for (auto it = _failedTiles.begin(); it != _failedTiles.end(); ) {
+                it = (it->second.retryTime < currentTime ? _failedTiles.erase(it) : ++it);
+            }
+            if (_failedTiles.size() >= static_cast<std::size_t>(MAX_FAILED_TILES)) {
+                _failedTiles.clear();
+            }
+        }
+
+        TileFetchFailure& failure = _failedTiles[tileId];
+        failure.failureCount++;
+
+        int errorCode = tileData ? tileData->getErrorCode() : -1;
+        long long retryDelay = 0;
+        if (errorCode == 404) {
+            // A missing tile is a stable fact, no point in quick retries
+            retryDelay = NOT_FOUND_RETRY_DELAY;
+        } else {
+            // Server and network errors are usually transient, back off exponentially
+            retryDelay = std::min(static_cast<long long>(ERROR_MAX_RETRY_DELAY), static_cast<long long>(ERROR_BASE_RETRY_DELAY) << std::min(failure.failureCount - 1, 16));
+        }
+        failure.retryTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(retryDelay);
+    }
+
+    void CacheTileDataSource::clearTileFetchFailures() {
+        std::lock_guard<std::mutex> lock(_failedTilesMutex);
+        _failedTiles.clear();
+    }
+
     std::shared_ptr<TileDataSource> CacheTileDataSource::getDataSource() const {
         return _dataSource.get();
     }
-    
+
+    long long CacheTileDataSource::getTileTTL() const {
+        return _tileTTL.load();
+    }
+
+    void CacheTileDataSource::setTileTTL(long long ttlMilliseconds) {
+        _tileTTL.store(ttlMilliseconds < 0 ? -1 : ttlMilliseconds);
+    }
+
+    void CacheTileDataSource::applyTileTTL(const std::shared_ptr<TileData>& tileData) const {
+        long long ttl = _tileTTL.load();
+        if (ttl >= 0 && tileData) {
+            long long maxAge = tileData->getMaxAge();
+            if (maxAge < 0 || maxAge > ttl) {
+                tileData->setMaxAge(ttl);
+            }
+        }
+    }
+
+    void CacheTileDataSource::refreshTileAsync(const MapTile& mapTile) {
+        std::lock_guard<std::mutex> lock(_refreshMutex);
+        if (!_refreshingTiles.insert(mapTile.getTileId()).second) {
+            return; // a refresh of this tile is already pending
+        }
+        if (!_refreshThreadPool) {
+            _refreshThreadPool = std::make_shared<CancelableThreadPool>();
+            _refreshThreadPool->setPoolSize(1);
+            _refreshThreadPool->setQoS(ThreadQoS::BACKGROUND);
+        }
+        auto task = std::make_shared<TileRefreshTask>(std::static_pointer_cast<CacheTileDataSource>(shared_from_this()), mapTile);
+        _refreshThreadPool->execute(task, 0);
+    }
+
+    CacheTileDataSource::TileRefreshTask::TileRefreshTask(const std::shared_ptr<CacheTileDataSource>& dataSource, const MapTile& mapTile) :
+        _dataSource(dataSource),
+        _mapTile(mapTile)
+    {
+    }
+
+    void CacheTileDataSource::TileRefreshTask::run() {
+        std::shared_ptr<CacheTileDataSource> dataSource = _dataSource.lock();
+        if (!dataSource) {
+            return;
+        }
+
+        std::shared_ptr<TileData> tileData;
+        if (!isCanceled() && !dataSource->isTileFetchBlocked(_mapTile.getTileId())) {
+            tileData = dataSource->_dataSource->loadTile(_mapTile);
+            dataSource->registerTileFetchResult(_mapTile.getTileId(), tileData);
+        }
+
+        if (tileData && tileData->getMaxAge() != 0 && !tileData->isReplaceWithParent() && tileData->getData()) {
+            dataSource->applyTileTTL(tileData);
+            dataSource->storeRefreshedTile(_mapTile, tileData);
+
+            // Notify the listeners with tile-level scope, so that only the refreshed tile is reloaded
+            MapBounds tileBounds = TileUtils::CalculateMapTileBounds(_mapTile.getFlipped(), dataSource->getProjection());
+            dataSource->TileDataSource::notifyTilesChanged(tileBounds, _mapTile.getZoom(), _mapTile.getZoom());
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(dataSource->_refreshMutex);
+            dataSource->_refreshingTiles.erase(_mapTile.getTileId());
+        }
+    }
+
+
     CacheTileDataSource::DataSourceListener::DataSourceListener(CacheTileDataSource& cacheDataSource) :
         _cacheDataSource(cacheDataSource)
     {
@@ -54,4 +235,8 @@ namespace carto {
         _cacheDataSource.notifyTilesChanged(removeTiles);
     }
 
+    void CacheTileDataSource::DataSourceListener::onTilesChanged(const MapBounds& mapBounds, int minZoom, int maxZoom) {
+        _cacheDataSource.invalidateTiles(mapBounds, minZoom, maxZoom);
+    }
+
 }
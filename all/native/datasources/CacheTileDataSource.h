@@ -8,10 +8,20 @@
 #define _CARTO_CACHETILEDATASOURCE_H_
 
 #include "datasources/TileDataSource.h"
+#include "datasources/components/CacheStats.h"
+#include "components/CancelableTask.h"
 #include "components/DirectorPtr.h"
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
 namespace carto {
-    
+    class CancelableThreadPool;
+
     /**
      * A tile data source that loads tiles from another tile data source and caches them.
      */
@@ -26,11 +36,39 @@ namespace carto {
 
         virtual void notifyTilesChanged(bool removeTiles);
 
+        /**
+         * Invalidates cached tiles within the given region and zoom range.
+         * The affected tiles are dropped from the cache and listeners are notified with the
+         * same region scope, so only tiles intersecting the region are refetched while the
+         * rest of the cache and the current frame stay warm.
+         * @param mapBounds The bounds of the changed region, in the coordinate system of the data source projection.
+         * @param minZoom The minimum zoom level of the changed tiles (inclusive).
+         * @param maxZoom The maximum zoom level of the changed tiles (inclusive).
+         */
+        virtual void invalidateTiles(const MapBounds& mapBounds, int minZoom, int maxZoom);
+
         /**
          * Returns the original data source that the cache uses.
          * @return The original data source.
          */
         std::shared_ptr<TileDataSource> getDataSource() const;
+
+        /**
+         * Returns the maximum time-to-live of the cached tiles.
+         * @return The maximum time-to-live of the cached tiles in milliseconds, or -1 if no limit is set.
+         */
+        long long getTileTTL() const;
+        /**
+         * Sets the maximum time-to-live of the cached tiles. By default no limit is set and
+         * cached tiles expire only when the original data source gives an explicit expiration
+         * time (for example via HTTP cache control headers). The limit applies in addition to
+         * such expiration times, whichever is shorter. Expiration is checked lazily when a tile
+         * is requested, no background timers are used. An expired tile is still returned and
+         * displayed while a fresh copy is fetched in the background ('stale-while-revalidate'),
+         * so periodically updated tiles (weather, traffic, etc) refresh without flickering.
+         * @param ttlMilliseconds The maximum time-to-live of the cached tiles in milliseconds, or -1 to remove the limit.
+         */
+        void setTileTTL(long long ttlMilliseconds);
         
         /**
          * Clear the cache.
@@ -48,12 +86,20 @@ namespace carto {
          */
         virtual void setCapacity(std::size_t capacityInBytes) = 0;
 
+        /**
+         * Returns a snapshot of the cache usage statistics.
+         * The counters are cumulative since the creation of the data source.
+         * @return The cache usage statistics.
+         */
+        virtual CacheStats getCacheStats() const;
+
     protected:
         class DataSourceListener : public TileDataSource::OnChangeListener {
         public:
             explicit DataSourceListener(CacheTileDataSource& cacheDataSource);
             
             virtual void onTilesChanged(bool removeTiles);
+            virtual void onTilesChanged(const MapBounds& mapBounds, int minZoom, int maxZoom);
             
         private:
             CacheTileDataSource& _cacheDataSource;
@@ -61,10 +107,57 @@ namespace carto {
         
         CacheTileDataSource(const std::shared_ptr<TileDataSource>& dataSource);
 
+        virtual void removeTileFromCache(long long tileId);
+        virtual void storeRefreshedTile(const MapTile& mapTile, const std::shared_ptr<TileData>& tileData) = 0;
+
+        bool isTileFetchBlocked(long long tileId) const;
+        void registerTileFetchResult(long long tileId, const std::shared_ptr<TileData>& tileData);
+        void clearTileFetchFailures();
+
+        void applyTileTTL(const std::shared_ptr<TileData>& tileData) const;
+        void refreshTileAsync(const MapTile& mapTile);
+
+        static const std::uint64_t MAX_REGION_INVALIDATION_TILES = 4096;
+
+        static const int STALE_TILE_RETRY_DELAY = 5 * 1000;
+
         const DirectorPtr<TileDataSource> _dataSource;
-        
+
     private:
+        class TileRefreshTask : public CancelableTask {
+        public:
+            TileRefreshTask(const std::shared_ptr<CacheTileDataSource>& dataSource, const MapTile& mapTile);
+
+            virtual void run();
+
+        private:
+            std::weak_ptr<CacheTileDataSource> _dataSource;
+            MapTile _mapTile;
+        };
+
+        struct TileFetchFailure {
+            TileFetchFailure() : failureCount(0), retryTime() { }
+
+            int failureCount;
+            std::chrono::steady_clock::time_point retryTime;
+        };
+
+        static const int MAX_FAILED_TILES = 4096;
+
+        static const int NOT_FOUND_RETRY_DELAY = 300 * 1000;
+        static const int ERROR_BASE_RETRY_DELAY = 1 * 1000;
+        static const int ERROR_MAX_RETRY_DELAY = 60 * 1000;
+
         std::shared_ptr<DataSourceListener> _dataSourceListener;
+
+        std::atomic<long long> _tileTTL;
+
+        std::shared_ptr<CancelableThreadPool> _refreshThreadPool;
+        std::unordered_set<long long> _refreshingTiles;
+        mutable std::mutex _refreshMutex;
+
+        std::unordered_map<long long, TileFetchFailure> _failedTiles;
+        mutable std::mutex _failedTilesMutex;
     };
     
 }
@@ -8,6 +8,8 @@
 #include "utils/NetworkUtils.h"
 #include "utils/PlatformUtils.h"
 
+#include <algorithm>
+
 #include <picojson/picojson.h>
 
 #include <stdext/base64.h>
@@ -22,6 +24,7 @@ namespace carto {
         _schema(),
         _tmsScheme(false),
         _tileURLs(),
+        _endpointStats(),
         _tileMasks(),
         _randomGenerator(),
         _mutex()
@@ -70,15 +73,35 @@ namespace carto {
             }
         }
 
-        // Select tile URL randomly
-        std::size_t randomIndex = std::uniform_int_distribution<std::size_t>(0, _tileURLs.size() - 1)(_randomGenerator);
-        std::string tileURL = _tileURLs[randomIndex];
+        // Select the currently best tile endpoint
+        std::size_t endpointIndex = selectTileEndpoint();
+        std::string tileURL = _tileURLs[endpointIndex];
 
         // Fetch online tile, allow parallel tile fetching
         lock.unlock();
+        std::chrono::steady_clock::time_point fetchTime = std::chrono::steady_clock::now();
         tileData = loadOnlineTile(tileURL, mapTile);
+        float latency = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - fetchTime).count() * 1.0f;
         lock.lock();
 
+        updateTileEndpointStats(endpointIndex, tileData ? true : false, latency);
+
+        // Fail over to the next best endpoint, a single endpoint may be down or unreachable
+        if (!tileData && !_tileURLs.empty()) {
+            std::size_t failoverIndex = selectTileEndpoint();
+            if (failoverIndex != endpointIndex) {
+                tileURL = _tileURLs[failoverIndex];
+
+                lock.unlock();
+                fetchTime = std::chrono::steady_clock::now();
+                tileData = loadOnlineTile(tileURL, mapTile);
+                latency = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - fetchTime).count() * 1.0f;
+                lock.lock();
+
+                updateTileEndpointStats(failoverIndex, tileData ? true : false, latency);
+            }
+        }
+
         // Store the tile in local cache
         if (tileData) {
             if (tileData->getMaxAge() != 0 && tileData->getData() && !tileData->isReplaceWithParent()) {
@@ -157,6 +180,7 @@ namespace carto {
                 _tileURLs.push_back(tileURL.get<std::string>());
             }
         }
+        _endpointStats.assign(_tileURLs.size(), EndpointStats());
         _tmsScheme = false;
         if (config.get("scheme").is<std::string>()) {
             _tmsScheme = config.get("scheme").get<std::string>() == "tms";
@@ -192,6 +216,54 @@ namespace carto {
         return !_tileURLs.empty();
     }
     
+    std::size_t CartoOnlineTileDataSource::selectTileEndpoint() {
+        // Occasionally explore a random endpoint so that the latency statistics
+        // of the non-preferred endpoints do not go stale
+        if (_tileURLs.size() > 1 && std::uniform_int_distribution<int>(0, ENDPOINT_EXPLORATION_RATE - 1)(_randomGenerator) == 0) {
+            return std::uniform_int_distribution<std::size_t>(0, _tileURLs.size() - 1)(_randomGenerator);
+        }
+
+        // Pick the healthy endpoint with the lowest smoothed latency. Endpoints without
+        // measurements are preferred, so that every endpoint gets measured at least once.
+        std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
+        std::size_t bestIndex = _tileURLs.size();
+        for (std::size_t i = 0; i < _tileURLs.size(); i++) {
+            const EndpointStats& stats = _endpointStats[i];
+            if (stats.retryTime > currentTime) {
+                continue;
+            }
+            if (stats.meanLatency < 0) {
+                return i;
+            }
+            if (bestIndex == _tileURLs.size() || stats.meanLatency < _endpointStats[bestIndex].meanLatency) {
+                bestIndex = i;
+            }
+        }
+
+        // If all endpoints are backing off after errors, fall back to a random endpoint
+        if (bestIndex == _tileURLs.size()) {
+            bestIndex = std::uniform_int_distribution<std::size_t>(0, _tileURLs.size() - 1)(_randomGenerator);
+        }
+        return bestIndex;
+    }
+
+    void CartoOnlineTileDataSource::updateTileEndpointStats(std::size_t index, bool success, float latency) {
+        if (index >= _endpointStats.size()) {
+            return; // the configuration was reloaded while fetching
+        }
+
+        EndpointStats& stats = _endpointStats[index];
+        if (success) {
+            stats.meanLatency = (stats.meanLatency < 0 ? latency : stats.meanLatency + (latency - stats.meanLatency) * ENDPOINT_LATENCY_SMOOTHING);
+            stats.errorCount = 0;
+            stats.retryTime = std::chrono::steady_clock::time_point();
+        } else {
+            stats.errorCount++;
+            int backoff = ENDPOINT_BACKOFF_SECONDS << std::min(stats.errorCount - 1, 5);
+            stats.retryTime = std::chrono::steady_clock::now() + std::chrono::seconds(backoff);
+        }
+    }
+
     std::shared_ptr<TileData> CartoOnlineTileDataSource::loadOnlineTile(const std::string& tileURL, const MapTile& mapTile) {
         Log::Infof("CartoOnlineTileDataSource::loadOnlineTile: Loading tile %d/%d/%d", mapTile.getZoom(), mapTile.getX(), mapTile.getY());
 
@@ -238,6 +310,8 @@ namespace carto {
         return tileData;
     }
 
+    const float CartoOnlineTileDataSource::ENDPOINT_LATENCY_SMOOTHING = 0.2f;
+
     const std::string CartoOnlineTileDataSource::TILE_SERVICE_TEMPLATE = "https://api.nutiteq.com/maps/v2/{source}/1/tiles.json";
     
 }
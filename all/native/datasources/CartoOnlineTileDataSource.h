@@ -10,6 +10,7 @@
 #include "datasources/TileDataSource.h"
 #include "network/HTTPClient.h"
 
+#include <chrono>
 #include <random>
 #include <vector>
 
@@ -48,14 +49,27 @@ namespace carto {
             std::shared_ptr<BinaryData> tileData;
         };
 
+        struct EndpointStats {
+            float meanLatency = -1.0f;
+            int errorCount = 0;
+            std::chrono::steady_clock::time_point retryTime;
+        };
+
         std::string buildTileURL(const std::string& baseURL, const MapTile& tile) const;
 
         bool loadConfiguration();
 
         std::shared_ptr<TileData> loadOnlineTile(const std::string& url, const MapTile& mapTile);
 
+        std::size_t selectTileEndpoint();
+
+        void updateTileEndpointStats(std::size_t index, bool success, float latency);
+
         static const int DEFAULT_MAX_ZOOM = 14;
         static const int MAX_CACHED_TILES = 8;
+        static const int ENDPOINT_EXPLORATION_RATE = 16;
+        static const int ENDPOINT_BACKOFF_SECONDS = 5;
+        static const float ENDPOINT_LATENCY_SMOOTHING;
         static const std::string TILE_SERVICE_TEMPLATE;
 
         const std::string _source;
@@ -66,6 +80,7 @@ namespace carto {
 
         bool _tmsScheme;
         std::vector<std::string> _tileURLs;
+        std::vector<EndpointStats> _endpointStats;
         std::vector<TileMask> _tileMasks;
         std::default_random_engine _randomGenerator;
 
@@ -1,8 +1,10 @@
 #include "CombinedTileDataSource.h"
 #include "core/MapTile.h"
 #include "components/Exceptions.h"
+#include "graphics/Bitmap.h"
 #include "utils/Log.h"
 
+#include <algorithm>
 #include <memory>
 
 namespace carto {
@@ -11,7 +13,8 @@ namespace carto {
         TileDataSource(),
         _dataSource1(dataSource1),
         _dataSource2(dataSource2),
-        _zoomLevel(zoomLevel)
+        _zoomLevel(zoomLevel),
+        _tileSynthesizingEnabled(false)
     {
         if (!dataSource1) {
             throw NullArgumentException("Null dataSource1");
@@ -31,6 +34,14 @@ namespace carto {
         _dataSourceListener.reset();
     }
 
+    bool CombinedTileDataSource::isTileSynthesizingEnabled() const {
+        return _tileSynthesizingEnabled;
+    }
+
+    void CombinedTileDataSource::setTileSynthesizingEnabled(bool enabled) {
+        _tileSynthesizingEnabled = enabled;
+    }
+
     int CombinedTileDataSource::getMinZoom() const {
         return _dataSource1->getMinZoom();
     }
@@ -49,7 +60,64 @@ namespace carto {
         if (mapTile.getZoom() < _zoomLevel) {
             return _dataSource1->loadTile(mapTile);
         }
-        return _dataSource2->loadTile(mapTile);
+        std::shared_ptr<TileData> tileData = _dataSource2->loadTile(mapTile);
+        if (_tileSynthesizingEnabled && (!tileData || !tileData->getData())) {
+            if (std::shared_ptr<TileData> synthesizedTileData = synthesizeTile(mapTile)) {
+                return synthesizedTileData;
+            }
+        }
+        return tileData;
+    }
+
+    std::shared_ptr<TileData> CombinedTileDataSource::synthesizeTile(const MapTile& mapTile) {
+        // Find the closest ancestor tile that the first data source can serve
+        MapTile parentTile = mapTile;
+        while (parentTile.getZoom() >= _zoomLevel || parentTile.getZoom() > _dataSource1->getMaxZoom()) {
+            if (parentTile.getZoom() == 0) {
+                return std::shared_ptr<TileData>();
+            }
+            parentTile = parentTile.getParent();
+        }
+        int deltaZoom = mapTile.getZoom() - parentTile.getZoom();
+        if (parentTile.getZoom() < _dataSource1->getMinZoom() || deltaZoom > MAX_OVERZOOM_LEVELS) {
+            return std::shared_ptr<TileData>();
+        }
+
+        std::shared_ptr<TileData> parentTileData = _dataSource1->loadTile(parentTile);
+        if (!parentTileData || !parentTileData->getData()) {
+            return std::shared_ptr<TileData>();
+        }
+        std::shared_ptr<Bitmap> bitmap = Bitmap::CreateFromCompressed(parentTileData->getData());
+        if (!bitmap) {
+            Log::Infof("CombinedTileDataSource::synthesizeTile: Failed to decode parent tile %s, skipping synthesizing", parentTile.toString().c_str());
+            return std::shared_ptr<TileData>();
+        }
+
+        // Extract and scale up the corresponding part of the parent tile.
+        // Tile y coordinates are flipped at data source level, flip back for top-based bitmap offsets.
+        MapTile flippedTile = mapTile.getFlipped();
+        int x = (bitmap->getWidth()  * (flippedTile.getX() & ((1 << deltaZoom) - 1))) >> deltaZoom;
+        int y = (bitmap->getHeight() * (flippedTile.getY() & ((1 << deltaZoom) - 1))) >> deltaZoom;
+        int w = bitmap->getWidth()  >> deltaZoom;
+        int h = bitmap->getHeight() >> deltaZoom;
+        std::shared_ptr<Bitmap> subBitmap = bitmap->getSubBitmap(x, y, std::max(w, 1), std::max(h, 1));
+        if (!subBitmap) {
+            return std::shared_ptr<TileData>();
+        }
+        std::shared_ptr<Bitmap> resizedBitmap = subBitmap->getResizedBitmap(bitmap->getWidth(), bitmap->getHeight());
+        if (!resizedBitmap) {
+            return std::shared_ptr<TileData>();
+        }
+        std::shared_ptr<BinaryData> pngData = resizedBitmap->compressToPng();
+        if (!pngData) {
+            return std::shared_ptr<TileData>();
+        }
+
+        // The synthesized tile is only a stand-in, expire it immediately so that
+        // the actual tile gets loaded once it becomes available
+        auto synthesizedTileData = std::make_shared<TileData>(pngData);
+        synthesizedTileData->setMaxAge(0);
+        return synthesizedTileData;
     }
 
     CombinedTileDataSource::DataSourceListener::DataSourceListener(CombinedTileDataSource& combinedDataSource) :
@@ -60,5 +128,7 @@ namespace carto {
     void CombinedTileDataSource::DataSourceListener::onTilesChanged(bool removeTiles) {
         _combinedDataSource.notifyTilesChanged(removeTiles);
     }
-    
+
+    const int CombinedTileDataSource::MAX_OVERZOOM_LEVELS = 4;
+
 }
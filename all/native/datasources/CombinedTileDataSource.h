@@ -28,6 +28,21 @@ namespace carto {
         CombinedTileDataSource(const std::shared_ptr<TileDataSource>& dataSource1, const std::shared_ptr<TileDataSource>& dataSource2, int zoomLevel);
         virtual ~CombinedTileDataSource();
 
+        /**
+         * Returns the state of the tile synthesizing flag.
+         * @return True if missing high-zoom tiles are synthesized from low-zoom tiles, false otherwise.
+         */
+        bool isTileSynthesizingEnabled() const;
+        /**
+         * Sets the tile synthesizing flag. If the flag is set and the second data source does not have
+         * the requested tile, the tile is synthesized by scaling up the corresponding part of the closest
+         * available tile from the first data source. Synthesized tiles expire immediately, so they get
+         * replaced once the actual tiles become available. Note: this mode works only with raster tiles.
+         * The default is false.
+         * @param enabled True if missing tiles should be synthesized, false otherwise.
+         */
+        void setTileSynthesizingEnabled(bool enabled);
+
         virtual int getMinZoom() const;
         virtual int getMaxZoom() const;
 
@@ -45,11 +60,16 @@ namespace carto {
         private:
             CombinedTileDataSource& _combinedDataSource;
         };
-        
+
+        std::shared_ptr<TileData> synthesizeTile(const MapTile& mapTile);
+
+        static const int MAX_OVERZOOM_LEVELS;
+
         const DirectorPtr<TileDataSource> _dataSource1;
         const DirectorPtr<TileDataSource> _dataSource2;
         int _zoomLevel;
-        
+        std::atomic<bool> _tileSynthesizingEnabled;
+
     private:
         std::shared_ptr<DataSourceListener> _dataSourceListener;
     };
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2016 CartoDB. All rights reserved.
+ * Copying and using this code is allowed only according
+ * to license terms, as given in https://cartodb.com/terms/
+ */
+
+#ifndef _CARTO_COMPACTIONLISTENER_H_
+#define _CARTO_COMPACTIONLISTENER_H_
+
+namespace carto {
+
+    /**
+     * Listener for persistent cache compaction.
+     */
+    class CompactionListener {
+    public:
+        virtual ~CompactionListener() { }
+
+        /**
+         * Listener method that is called when the compaction has started.
+         */
+        virtual void onCompactionStarting() { }
+        /**
+         * Listener method that is called to report about compaction progress.
+         * @param progress The progress of the compaction, from 0 to 100.
+         */
+        virtual void onCompactionProgress(float progress) { }
+        /**
+         * Listener method that is called when the compaction has finished.
+         */
+        virtual void onCompactionCompleted() { }
+    };
+
+}
+
+#endif
@@ -19,6 +19,9 @@
 #include "assets/gdal/projop_wparm_csv.h"
 #include "assets/gdal/unit_of_measure_csv.h"
 
+#include <thread>
+#include <utility>
+
 #include <boost/lexical_cast.hpp>
 
 #include <gdal_priv.h>
@@ -219,81 +222,110 @@ namespace carto {
         BitmapFilterTable filterTable(minUds, minVds, maxUds, maxVds);
         filterTable.calculateFilterTable(AffineTransform(invTransformDS), _tileSize, _tileSize, FILTER_SCALE, MAX_FILTER_WIDTH);
 
-        // Read tile data by band
-        std::lock_guard<std::mutex> lock(_mutex);
+        // Read tile data by band. Only the dataset access itself is serialized,
+        // resampling is done outside of the lock so concurrent tile loads can overlap.
+        std::vector<std::pair<int, std::vector<unsigned char> > > bands;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
 
-        std::vector<unsigned char> data(_tileSize * _tileSize * 4);
-        std::vector<unsigned char> bandData((maxUds - minUds) * (maxVds - minVds));
-        for (int n = 1; n <= _poDataset->GetRasterCount(); n++) {
-            GDALRasterBand* poRasterBand = _poDataset->GetRasterBand(n);
-            if (!poRasterBand) {
-                Log::Warnf("GDALRasterTileDataSource: Failed to read band %d", n);
-                continue;
-            }
-            
-            GDALColorInterp colorInterp = poRasterBand->GetColorInterpretation();
-            int mask = 0;
-            switch (colorInterp) {
-            case GCI_GrayIndex:
-                mask = 7;
-                break;
-            case GCI_RedBand:
-                mask = 1;
-                break;
-            case GCI_GreenBand:
-                mask = 2;
-                break;
-            case GCI_BlueBand:
-                mask = 4;
-                break;
-            case GCI_AlphaBand:
-                mask = 8;
-                break;
-            default:
-                Log::Warnf("GDALRasterTileDataSource: Unsupported band %d, color interpretation %d", n, (int)colorInterp);
-                break;
-            }
-            if (mask == 0) {
-                continue;
-            }
-
-            poRasterBand->RasterIO(GF_Read, minU, minV, maxU - minU, maxV - minV, (void *)&bandData[0], maxUds - minUds, maxVds - minVds, GDT_Byte, 0, 0);
-
-            std::size_t sampleIndex = 0;
-            const std::vector<BitmapFilterTable::Sample>& samples = filterTable.getSamples();
-            for (int i = 0; i < _tileSize * _tileSize; i++) {
-                int count = filterTable.getSampleCounts()[i];
-                if (count == 0) {
+            for (int n = 1; n <= _poDataset->GetRasterCount(); n++) {
+                GDALRasterBand* poRasterBand = _poDataset->GetRasterBand(n);
+                if (!poRasterBand) {
+                    Log::Warnf("GDALRasterTileDataSource: Failed to read band %d", n);
                     continue;
                 }
 
-                float filteredValue = 0.5f;
-                for (int j = 0; j < count; j++) {
-                    const BitmapFilterTable::Sample& sample = samples[sampleIndex++];
-                    filteredValue += bandData[sample.v * (maxUds - minUds) + sample.u] * sample.weight;
+                GDALColorInterp colorInterp = poRasterBand->GetColorInterpretation();
+                int mask = 0;
+                switch (colorInterp) {
+                case GCI_GrayIndex:
+                    mask = 7;
+                    break;
+                case GCI_RedBand:
+                    mask = 1;
+                    break;
+                case GCI_GreenBand:
+                    mask = 2;
+                    break;
+                case GCI_BlueBand:
+                    mask = 4;
+                    break;
+                case GCI_AlphaBand:
+                    mask = 8;
+                    break;
+                default:
+                    Log::Warnf("GDALRasterTileDataSource: Unsupported band %d, color interpretation %d", n, (int)colorInterp);
+                    break;
                 }
-                for (int j = 0; mask >= (1 << j); j++) {
-                    if (mask & (1 << j)) {
-                        data[i * 4 + j] = static_cast<unsigned char>(filteredValue);
-                    }
+                if (mask == 0) {
+                    continue;
                 }
+
+                std::vector<unsigned char> bandData((maxUds - minUds) * (maxVds - minVds));
+                poRasterBand->RasterIO(GF_Read, minU, minV, maxU - minU, maxV - minV, (void *)&bandData[0], maxUds - minUds, maxVds - minVds, GDT_Byte, 0, 0);
+                bands.emplace_back(mask, std::move(bandData));
             }
         }
-        if (!_hasAlpha) {
-            std::size_t sampleIndex = 0;
+
+        // The sample table is indexed sequentially, precalculate per-row offsets
+        // so that row ranges can be resampled independently
+        std::vector<std::size_t> rowSampleOffsets(_tileSize + 1, 0);
+        for (int v = 0; v < _tileSize; v++) {
+            std::size_t sampleCount = 0;
+            for (int u = 0; u < _tileSize; u++) {
+                sampleCount += filterTable.getSampleCounts()[v * _tileSize + u];
+            }
+            rowSampleOffsets[v + 1] = rowSampleOffsets[v] + sampleCount;
+        }
+
+        // Resample all bands in a single pass over the filter table
+        std::vector<unsigned char> data(_tileSize * _tileSize * 4);
+        auto resampleRows = [&](int v0, int v1) {
             const std::vector<BitmapFilterTable::Sample>& samples = filterTable.getSamples();
-            for (int i = 0; i < _tileSize * _tileSize; i++) {
+            std::size_t sampleIndex = rowSampleOffsets[v0];
+            for (int i = v0 * _tileSize; i < v1 * _tileSize; i++) {
                 int count = filterTable.getSampleCounts()[i];
                 if (count == 0) {
                     continue;
                 }
-                
-                float filteredValue = 0.5f;
-                for (int j = 0; j < count; j++) {
-                    const BitmapFilterTable::Sample& sample = samples[sampleIndex++];
-                    filteredValue += 255 * sample.weight;
+
+                for (const std::pair<int, std::vector<unsigned char> >& band : bands) {
+                    float filteredValue = 0.5f;
+                    for (int j = 0; j < count; j++) {
+                        const BitmapFilterTable::Sample& sample = samples[sampleIndex + j];
+                        filteredValue += band.second[sample.v * (maxUds - minUds) + sample.u] * sample.weight;
+                    }
+                    for (int j = 0; band.first >= (1 << j); j++) {
+                        if (band.first & (1 << j)) {
+                            data[i * 4 + j] = static_cast<unsigned char>(filteredValue);
+                        }
+                    }
+                }
+                if (!_hasAlpha) {
+                    float filteredValue = 0.5f;
+                    for (int j = 0; j < count; j++) {
+                        filteredValue += 255 * samples[sampleIndex + j].weight;
+                    }
+                    data[i * 4 + 3] = static_cast<unsigned char>(filteredValue);
                 }
-                data[i * 4 + 3] = static_cast<unsigned char>(filteredValue);
+                sampleIndex += count;
+            }
+        };
+
+        // Fan the row ranges out across threads, the ranges are independent
+        std::size_t threadCount = std::min(static_cast<std::size_t>(std::max(std::thread::hardware_concurrency(), 1U)), static_cast<std::size_t>(MAX_RESAMPLE_THREADS));
+        if (threadCount < 2) {
+            resampleRows(0, _tileSize);
+        } else {
+            std::vector<std::thread> threads;
+            threads.reserve(threadCount);
+            for (std::size_t k = 0; k < threadCount; k++) {
+                int v0 = static_cast<int>(_tileSize * k / threadCount);
+                int v1 = static_cast<int>(_tileSize * (k + 1) / threadCount);
+                threads.emplace_back(resampleRows, v0, v1);
+            }
+            for (std::thread& thread : threads) {
+                thread.join();
             }
         }
 
@@ -378,6 +410,7 @@ namespace carto {
     const float GDALRasterTileDataSource::FILTER_SCALE = 1.5f;
     const int GDALRasterTileDataSource::MAX_FILTER_WIDTH = 16;
     const int GDALRasterTileDataSource::MAX_DOWNSAMPLE_FACTOR = 8;
+    const int GDALRasterTileDataSource::MAX_RESAMPLE_THREADS = 4;
 }
 
 #endif
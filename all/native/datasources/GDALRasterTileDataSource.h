@@ -66,6 +66,7 @@ namespace carto {
         static const float FILTER_SCALE;
         static const int MAX_FILTER_WIDTH;
         static const int MAX_DOWNSAMPLE_FACTOR;
+        static const int MAX_RESAMPLE_THREADS;
     };
 }
 
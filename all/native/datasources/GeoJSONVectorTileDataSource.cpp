@@ -7,11 +7,128 @@
 #include "projections/Projection.h"
 #include "utils/Const.h"
 #include "utils/Log.h"
+#include "utils/TileUtils.h"
+
+#include <cctype>
+#include <cstdio>
+#include <map>
+
+#include <boost/lexical_cast.hpp>
+
+#include <sqlite3pp.h>
+
+#include <stdext/utf8_filesystem.h>
 
 #include <mbvtbuilder/MBVTTileBuilder.h>
 
 #include <mapnikvt/mbvtpackage/MBVTPackage.pb.h>
 
+namespace {
+
+    // A minimal buffered JSON scanner that can extract single values from a file
+    // without reading the whole file into memory.
+    class GeoJSONStreamReader {
+    public:
+        explicit GeoJSONStreamReader(FILE* fp) : _fp(fp), _buffer(), _offset(0), _size(0) { }
+
+        int readChar() {
+            if (_offset >= _size) {
+                _size = std::fread(_buffer, 1, sizeof(_buffer), _fp);
+                _offset = 0;
+                if (_size == 0) {
+                    return -1;
+                }
+            }
+            return static_cast<unsigned char>(_buffer[_offset++]);
+        }
+
+        void pushBackChar() {
+            _offset--;
+        }
+
+        int readToken() {
+            int c;
+            while ((c = readChar()) >= 0) {
+                if (!std::isspace(c)) {
+                    break;
+                }
+            }
+            return c;
+        }
+
+        void readString(std::string* str) {
+            int c;
+            while ((c = readChar()) >= 0) {
+                if (str) {
+                    str->push_back(static_cast<char>(c));
+                }
+                if (c == '\\') {
+                    c = readChar();
+                    if (c >= 0 && str) {
+                        str->push_back(static_cast<char>(c));
+                    }
+                } else if (c == '"') {
+                    return;
+                }
+            }
+            throw carto::ParseException("Unexpected end of GeoJSON input");
+        }
+
+        void readValue(int firstChar, std::string* str) {
+            if (firstChar == '"') {
+                if (str) {
+                    str->push_back('"');
+                }
+                readString(str);
+                return;
+            }
+            if (firstChar == '{' || firstChar == '[') {
+                if (str) {
+                    str->push_back(static_cast<char>(firstChar));
+                }
+                int depth = 1;
+                while (depth > 0) {
+                    int c = readChar();
+                    if (c < 0) {
+                        throw carto::ParseException("Unexpected end of GeoJSON input");
+                    }
+                    if (str) {
+                        str->push_back(static_cast<char>(c));
+                    }
+                    if (c == '"') {
+                        readString(str);
+                    } else if (c == '{' || c == '[') {
+                        depth++;
+                    } else if (c == '}' || c == ']') {
+                        depth--;
+                    }
+                }
+                return;
+            }
+            if (str) {
+                str->push_back(static_cast<char>(firstChar));
+            }
+            int c;
+            while ((c = readChar()) >= 0) {
+                if (c == ',' || c == '}' || c == ']' || std::isspace(c)) {
+                    pushBackChar();
+                    return;
+                }
+                if (str) {
+                    str->push_back(static_cast<char>(c));
+                }
+            }
+        }
+
+    private:
+        FILE* _fp;
+        char _buffer[16384];
+        std::size_t _offset;
+        std::size_t _size;
+    };
+
+}
+
 namespace carto {
 
     GeoJSONVectorTileDataSource::GeoJSONVectorTileDataSource(int minZoom, int maxZoom) :
@@ -49,6 +166,87 @@ namespace carto {
         notifyTilesChanged(false);
     }
     
+    void GeoJSONVectorTileDataSource::setLayerGeoJSONFromFile(int layerIndex, const std::string& geoJSONFileName) {
+        std::shared_ptr<FILE> fp(utf8_filesystem::fopen(geoJSONFileName.c_str(), "rb"), fclose);
+        if (!fp) {
+            throw FileException("Failed to open GeoJSON file", geoJSONFileName);
+        }
+
+        try {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _tileBuilder->clearLayer(layerIndex);
+
+            picojson::array features;
+            features.reserve(MAX_STREAMED_FEATURES);
+            auto importFeatures = [this, layerIndex, &features]() {
+                picojson::object featureCollection;
+                featureCollection["type"] = picojson::value("FeatureCollection");
+                featureCollection["features"] = picojson::value(features);
+                _tileBuilder->importGeoJSONFeatureCollection(layerIndex, picojson::value(featureCollection));
+                features.clear();
+            };
+
+            // Read the top-level members one-by-one, streaming the features array in batches.
+            // Only a single batch of features is kept in memory at any time.
+            GeoJSONStreamReader reader(fp.get());
+            if (reader.readToken() != '{') {
+                throw ParseException("Expecting FeatureCollection object");
+            }
+            int token = reader.readToken();
+            while (token != '}') {
+                if (token != '"') {
+                    throw ParseException("Expecting member name");
+                }
+                std::string memberName;
+                reader.readString(&memberName);
+                memberName.pop_back(); // drop the stored closing quote
+                if (reader.readToken() != ':') {
+                    throw ParseException("Expecting member value");
+                }
+
+                token = reader.readToken();
+                if (memberName == "features") {
+                    if (token != '[') {
+                        throw ParseException("Expecting features array");
+                    }
+                    token = reader.readToken();
+                    while (token != ']') {
+                        std::string featureStr;
+                        reader.readValue(token, &featureStr);
+                        picojson::value feature;
+                        std::string err = picojson::parse(feature, featureStr);
+                        if (!err.empty()) {
+                            throw ParseException("Error while parsing feature", err);
+                        }
+                        features.push_back(picojson::value(std::move(feature)));
+                        if (features.size() >= MAX_STREAMED_FEATURES) {
+                            importFeatures();
+                        }
+                        token = reader.readToken();
+                        if (token == ',') {
+                            token = reader.readToken();
+                        }
+                    }
+                } else {
+                    reader.readValue(token, nullptr);
+                }
+
+                token = reader.readToken();
+                if (token == ',') {
+                    token = reader.readToken();
+                }
+            }
+
+            if (!features.empty()) {
+                importFeatures();
+            }
+        } catch (const std::exception& ex) {
+            Log::Errorf("GeoJSONVectorTileDataSource::setLayerGeoJSONFromFile: Failed to update layer: %s", ex.what());
+            throw GenericException("Failed to set layer contents", ex.what());
+        }
+        notifyTilesChanged(false);
+    }
+
     void GeoJSONVectorTileDataSource::setLayerFeatureCollection(int layerIndex, const std::shared_ptr<Projection>& projection, const std::shared_ptr<FeatureCollection>& featureCollection) {
         if (!featureCollection) {
             throw NullArgumentException("Null featureCollection");
@@ -84,6 +282,85 @@ namespace carto {
         notifyTilesChanged(false);
     }
 
+    void GeoJSONVectorTileDataSource::exportToMBTiles(const std::string& path, int minZoom, int maxZoom) {
+        if (minZoom < 0 || maxZoom > Const::MAX_SUPPORTED_ZOOM_LEVEL || minZoom > maxZoom) {
+            throw OutOfRangeException("Illegal zoom range");
+        }
+
+        std::unique_ptr<sqlite3pp::database> db;
+        try {
+            db.reset(new sqlite3pp::database(path.c_str()));
+        } catch (const std::exception& ex) {
+            Log::Errorf("GeoJSONVectorTileDataSource::exportToMBTiles: Failed to create database: %s", ex.what());
+            throw FileException("Failed to create MBTiles file", path);
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        try {
+            // One-shot bulk export, no need for durability of partial results
+            db->execute("PRAGMA journal_mode=OFF");
+            db->execute("PRAGMA synchronous=OFF");
+
+            db->execute("CREATE TABLE IF NOT EXISTS metadata (name TEXT, value TEXT)");
+            db->execute("CREATE TABLE IF NOT EXISTS tiles (zoom_level INTEGER, tile_column INTEGER, tile_row INTEGER, tile_data BLOB)");
+            db->execute("CREATE UNIQUE INDEX IF NOT EXISTS tiles_index ON tiles (zoom_level, tile_column, tile_row)");
+
+            // Calculate data extent, in projection coordinates and in WGS84
+            MapBounds bounds;
+            for (int layerIndex : _tileBuilder->getLayerIndices()) {
+                // NOTE: layerBounds are flipped
+                auto layerBounds = _tileBuilder->getLayerBounds(layerIndex);
+                bounds.expandToContain(MapPos(layerBounds.min(0), -layerBounds.max(1)));
+                bounds.expandToContain(MapPos(layerBounds.max(0), -layerBounds.min(1)));
+            }
+            MapPos boundsMinWgs84 = _projection->toWgs84(bounds.getMin());
+            MapPos boundsMaxWgs84 = _projection->toWgs84(bounds.getMax());
+
+            std::map<std::string, std::string> metaData;
+            metaData["name"] = "geojson";
+            metaData["format"] = "pbf";
+            metaData["minzoom"] = boost::lexical_cast<std::string>(minZoom);
+            metaData["maxzoom"] = boost::lexical_cast<std::string>(maxZoom);
+            metaData["bounds"] = boost::lexical_cast<std::string>(boundsMinWgs84.getX()) + "," + boost::lexical_cast<std::string>(boundsMinWgs84.getY()) + "," + boost::lexical_cast<std::string>(boundsMaxWgs84.getX()) + "," + boost::lexical_cast<std::string>(boundsMaxWgs84.getY());
+            for (auto it = metaData.begin(); it != metaData.end(); it++) {
+                sqlite3pp::command command(*db, "INSERT INTO metadata (name, value) VALUES (:name, :value)");
+                command.bind(":name", it->first.c_str());
+                command.bind(":value", it->second.c_str());
+                command.execute();
+                command.finish();
+            }
+
+            // Build the tile pyramid, tiles of each zoom level are grouped into a single transaction
+            for (int zoom = minZoom; zoom <= maxZoom; zoom++) {
+                MapTile tile0 = TileUtils::CalculateMapTile(MapPos(bounds.getMin().getX(), bounds.getMax().getY()), zoom, _projection);
+                MapTile tile1 = TileUtils::CalculateMapTile(MapPos(bounds.getMax().getX(), bounds.getMin().getY()), zoom, _projection);
+
+                db->execute("BEGIN");
+                for (int y = tile0.getY(); y <= tile1.getY(); y++) {
+                    for (int x = tile0.getX(); x <= tile1.getX(); x++) {
+                        protobuf::encoded_message encodedTile;
+                        _tileBuilder->buildTile(zoom, x, y, encodedTile);
+                        if (encodedTile.data().empty()) {
+                            continue;
+                        }
+
+                        sqlite3pp::command command(*db, "INSERT OR REPLACE INTO tiles (zoom_level, tile_column, tile_row, tile_data) VALUES (:zoom, :x, :y, :data)");
+                        command.bind(":zoom", zoom);
+                        command.bind(":x", x);
+                        command.bind(":y", (1 << zoom) - 1 - y); // TMS scheme
+                        command.bind(":data", encodedTile.data().data(), static_cast<unsigned int>(encodedTile.data().size()));
+                        command.execute();
+                        command.finish();
+                    }
+                }
+                db->execute("COMMIT");
+            }
+        } catch (const std::exception& ex) {
+            Log::Errorf("GeoJSONVectorTileDataSource::exportToMBTiles: Failed to export tiles: %s", ex.what());
+            throw GenericException("Failed to export tiles", ex.what());
+        }
+    }
+
     MapBounds GeoJSONVectorTileDataSource::getDataExtent() const {
         std::lock_guard<std::mutex> lock(_mutex);
         MapBounds mapBounds;
@@ -52,6 +52,17 @@ namespace carto {
          */
         void setLayerGeoJSON(int layerIndex, const Variant& geoJSON);
 
+        /**
+         * Sets the features of the specified layer by streaming the features from a GeoJSON file.
+         * The file must contain a single FeatureCollection element. Unlike setLayerGeoJSON,
+         * the file is not parsed into memory as a whole, features are read and imported
+         * in small batches, which keeps memory usage bounded even for very large files.
+         * @param layerIndex The index of the layer. A layer with empty name will be created if it does not exist yet.
+         * @param geoJSONFileName The full path of the GeoJSON file to import.
+         * @throws std::runtime_error If the file could not be read or an error occured during updating the layer.
+         */
+        void setLayerGeoJSONFromFile(int layerIndex, const std::string& geoJSONFileName);
+
         /**
          * Sets the feature collection of the specified layer.
          * @param layerIndex The index of the layer. A layer with empty name will be created if it does not exist yet.
@@ -66,12 +77,27 @@ namespace carto {
          * @param layerIndex The index of layer to delete.
          */
         void deleteLayer(int layerIndex);
-        
+
+        /**
+         * Exports the tiles of all layers into an MBTiles file.
+         * The full tile pyramid within the given zoom range is pre-generated, so the resulting
+         * file can be used with MBTilesTileDataSource in place of this data source, replacing
+         * per-session tiling with plain database reads. This is a potentially long synchronous
+         * operation and is best called from a background thread.
+         * @param path The full path of the MBTiles file to create.
+         * @param minZoom The minimum zoom level to export.
+         * @param maxZoom The maximum zoom level to export.
+         * @throws std::runtime_error If the file could not be created or an error occured during tile generation.
+         */
+        void exportToMBTiles(const std::string& path, int minZoom, int maxZoom);
+
         virtual MapBounds getDataExtent() const;
 
         virtual std::shared_ptr<TileData> loadTile(const MapTile& mapTile);
     
     private:
+        static const std::size_t MAX_STREAMED_FEATURES = 1024;
+
         std::unique_ptr<mbvtbuilder::MBVTTileBuilder> _tileBuilder;
         mutable std::mutex _mutex;
     };
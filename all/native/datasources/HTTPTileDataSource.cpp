@@ -1,9 +1,12 @@
 #include "HTTPTileDataSource.h"
 #include "core/MapTile.h"
+#include "network/NetworkEstimator.h"
 #include "utils/Log.h"
 #include "utils/NetworkUtils.h"
 #include "utils/GeneralUtils.h"
 
+#include <chrono>
+
 namespace carto {
 
     HTTPTileDataSource::HTTPTileDataSource(int minZoom, int maxZoom, const std::string& baseURL) :
@@ -101,14 +104,22 @@ namespace carto {
         Log::Infof("HTTPTileDataSource::loadTile: Loading %s", url.c_str());
         std::map<std::string, std::string> responseHeaders;
         std::shared_ptr<BinaryData> responseData;
+        NetworkEstimator::BeginRequest();
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+        bool success = false;
+        int statusCode = -1;
         try {
-            if (_httpClient.get(url, headers, responseHeaders, responseData) != 0) {
-                Log::Errorf("HTTPTileDataSource::loadTile: Failed to load %s", url.c_str());
-                return std::shared_ptr<TileData>();
-            }
+            success = _httpClient.get(url, headers, responseHeaders, responseData, &statusCode) == 0;
         } catch (const std::exception& ex) {
             Log::Errorf("HTTPTileDataSource::loadTile: Exception while loading tile %d/%d/%d: %s", mapTile.getZoom(), mapTile.getX(), mapTile.getY(), ex.what());
-            return std::shared_ptr<TileData>();
+        }
+        float duration = std::chrono::duration_cast<std::chrono::duration<float> >(std::chrono::steady_clock::now() - startTime).count();
+        NetworkEstimator::EndRequest(success && responseData ? responseData->size() : 0, duration, success);
+        if (!success) {
+            Log::Errorf("HTTPTileDataSource::loadTile: Failed to load %s", url.c_str());
+            auto tileData = std::make_shared<TileData>(std::shared_ptr<BinaryData>());
+            tileData->setErrorCode(statusCode > 0 ? statusCode : -1);
+            return tileData;
         }
         auto tileData = std::make_shared<TileData>(responseData);
         if (maxAgeHeaderCheck) {
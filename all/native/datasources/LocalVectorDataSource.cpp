@@ -8,8 +8,10 @@
 #include "geometry/PolygonGeometry.h"
 #include "geometry/MultiGeometry.h"
 #include "geometry/GeometrySimplifier.h"
+#include "geometry/TopologyPreservingGeometrySimplifier.h"
 #include "geometry/utils/KDTreeSpatialIndex.h"
 #include "geometry/utils/NullSpatialIndex.h"
+#include "geometry/utils/RTreeSpatialIndex.h"
 #include "projections/Projection.h"
 #include "projections/PlanarProjectionSurface.h"
 #include "styles/PointStyle.h"
@@ -34,6 +36,7 @@
 #include "utils/Log.h"
 
 #include <algorithm>
+#include <cmath>
 #include <iterator>
 #include <unordered_set>
 
@@ -42,9 +45,16 @@ namespace carto {
     LocalVectorDataSource::LocalVectorDataSource(const std::shared_ptr<Projection>& projection) :
         VectorDataSource(projection),
         _geometrySimplifier(),
+        _simplifiedElementCache(),
+        _batchSimplifiedLevels(),
+        _cachedVectorData(),
         _spatialIndex(std::make_shared<NullSpatialIndex<std::shared_ptr<VectorElement> > >()),
         _spatialIndexType(LocalSpatialIndexType::LOCAL_SPATIAL_INDEX_TYPE_NULL),
         _elementId(0),
+        _transactionLevel(0),
+        _transactionElementsChanged(false),
+        _transactionAddedElements(),
+        _transactionRemovedElements(),
         _mutex()
     {
     }
@@ -52,9 +62,16 @@ namespace carto {
     LocalVectorDataSource::LocalVectorDataSource(const std::shared_ptr<Projection>& projection, LocalSpatialIndexType::LocalSpatialIndexType spatialIndexType) :
         VectorDataSource(projection),
         _geometrySimplifier(),
+        _simplifiedElementCache(),
+        _batchSimplifiedLevels(),
+        _cachedVectorData(),
         _spatialIndex(std::make_shared<NullSpatialIndex<std::shared_ptr<VectorElement> > >()),
         _spatialIndexType(spatialIndexType),
         _elementId(0),
+        _transactionLevel(0),
+        _transactionElementsChanged(false),
+        _transactionAddedElements(),
+        _transactionRemovedElements(),
         _mutex()
     {
     }
@@ -68,12 +85,49 @@ namespace carto {
             std::lock_guard<std::mutex> lock(_mutex);
             removedElements = _spatialIndex->getAll();
             _spatialIndex->clear();
+            _simplifiedElementCache.clear();
+            _batchSimplifiedLevels.clear();
+            _cachedVectorData.reset();
         }
         if (!removedElements.empty()) {
             notifyElementsRemoved(removedElements);
         }
     }
     
+    void LocalVectorDataSource::beginTransaction() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _transactionLevel++;
+    }
+
+    void LocalVectorDataSource::commitTransaction() {
+        std::vector<std::shared_ptr<VectorElement> > addedElements, removedElements;
+        bool elementsChanged = false;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_transactionLevel <= 0) {
+                Log::Error("LocalVectorDataSource::commitTransaction: No active transaction");
+                return;
+            }
+            _transactionLevel--;
+            if (_transactionLevel > 0) {
+                return;
+            }
+            std::swap(addedElements, _transactionAddedElements);
+            std::swap(removedElements, _transactionRemovedElements);
+            elementsChanged = _transactionElementsChanged;
+            _transactionElementsChanged = false;
+        }
+        if (!addedElements.empty()) {
+            VectorDataSource::notifyElementsAdded(addedElements);
+        }
+        if (!removedElements.empty()) {
+            VectorDataSource::notifyElementsRemoved(removedElements);
+        }
+        if (elementsChanged) {
+            notifyElementsChanged();
+        }
+    }
+
     std::vector<std::shared_ptr<VectorElement> > LocalVectorDataSource::getAll() const {
         std::lock_guard<std::mutex> lock(_mutex);
         return _spatialIndex->getAll();
@@ -94,6 +148,9 @@ namespace carto {
         std::vector<std::shared_ptr<VectorElement> > elementsAdded, elementsRemoved;
         {
             std::lock_guard<std::mutex> lock(_mutex);
+            _simplifiedElementCache.clear();
+            _batchSimplifiedLevels.clear();
+            _cachedVectorData.reset();
             std::vector<std::shared_ptr<VectorElement> > oldElements = _spatialIndex->getAll();
             std::unordered_set<std::shared_ptr<VectorElement> > oldElementSet(oldElements.begin(), oldElements.end());
             
@@ -135,6 +192,8 @@ namespace carto {
             element->setId(_elementId);
             cglib::bbox3<double> bounds = calculateElementBounds(element);
             _spatialIndex->insert(bounds, element);
+            invalidateSimplifiedElementCache(element->getId());
+            _cachedVectorData.reset();
             _elementId++;
         }
         notifyElementAdded(element);
@@ -157,8 +216,10 @@ namespace carto {
                 element->setId(_elementId);
                 cglib::bbox3<double> bounds = calculateElementBounds(element);
                 _spatialIndex->insert(bounds, element);
+                invalidateSimplifiedElementCache(element->getId());
                 _elementId++;
             }
+            _cachedVectorData.reset();
         }
         if (!elements.empty()) {
             notifyElementsAdded(elements);
@@ -180,6 +241,8 @@ namespace carto {
             std::lock_guard<std::mutex> lock(_mutex);
             cglib::bbox3<double> bounds = calculateElementBounds(element);
             removed = _spatialIndex->remove(bounds, element);
+            invalidateSimplifiedElementCache(element->getId());
+            _cachedVectorData.reset();
         }
         if (removed) {
             notifyElementRemoved(element);
@@ -207,7 +270,9 @@ namespace carto {
                 if (_spatialIndex->remove(bounds, element)) {
                     removedElements.push_back(element);
                 }
+                invalidateSimplifiedElementCache(element->getId());
             }
+            _cachedVectorData.reset();
         }
         if (!removedElements.empty()) {
             notifyElementsRemoved(removedElements);
@@ -224,18 +289,22 @@ namespace carto {
         {
             std::lock_guard<std::mutex> lock(_mutex);
             _geometrySimplifier = simplifier;
+            _simplifiedElementCache.clear();
+            _batchSimplifiedLevels.clear();
+            _cachedVectorData.reset();
         }
         notifyElementsChanged();
     }
 
     std::shared_ptr<FeatureCollection> LocalVectorDataSource::getFeatureCollection() const {
         std::lock_guard<std::mutex> lock(_mutex);
+        std::vector<std::shared_ptr<VectorElement> > elements = _spatialIndex->getAll();
         std::vector<std::shared_ptr<Feature> > features;
-        for (const std::shared_ptr<VectorElement>& element : _spatialIndex->getAll()) {
-            auto feature = std::make_shared<Feature>(element->getGeometry(), Variant(element->getMetaData()));
-            features.push_back(feature);
+        features.reserve(elements.size());
+        for (const std::shared_ptr<VectorElement>& element : elements) {
+            features.push_back(std::make_shared<Feature>(element->getGeometry(), Variant(element->getMetaData())));
         }
-        return std::make_shared<FeatureCollection>(features);
+        return std::make_shared<FeatureCollection>(std::move(features));
     }
 
     void LocalVectorDataSource::addFeatureCollection(const std::shared_ptr<FeatureCollection>& featureCollection, const std::shared_ptr<Style>& style) {
@@ -283,11 +352,20 @@ namespace carto {
 
         // Check if we need to rebuild the underlying spatial index
         std::shared_ptr<ProjectionSurface> projectionSurface = cullState->getViewState().getProjectionSurface();
-        if (_spatialIndexType == LocalSpatialIndexType::LOCAL_SPATIAL_INDEX_TYPE_KDTREE) {
+        if (projectionSurface != _projectionSurface) {
+            _simplifiedElementCache.clear();
+            _batchSimplifiedLevels.clear();
+        }
+        if (_spatialIndexType != LocalSpatialIndexType::LOCAL_SPATIAL_INDEX_TYPE_NULL) {
             if (projectionSurface != _projectionSurface) {
                 std::vector<std::shared_ptr<VectorElement> > elements = _spatialIndex->getAll();
                 _projectionSurface = projectionSurface;
-                _spatialIndex = std::make_shared<KDTreeSpatialIndex<std::shared_ptr<VectorElement> > >();
+                if (_spatialIndexType == LocalSpatialIndexType::LOCAL_SPATIAL_INDEX_TYPE_RTREE) {
+                    _spatialIndex = std::make_shared<RTreeSpatialIndex<std::shared_ptr<VectorElement> > >();
+                } else {
+                    _spatialIndex = std::make_shared<KDTreeSpatialIndex<std::shared_ptr<VectorElement> > >();
+                }
+                _spatialIndex->reserve(elements.size());
                 for (const std::shared_ptr<VectorElement>& element : elements) {
                     cglib::bbox3<double> bounds = calculateElementBounds(element);
                     _spatialIndex->insert(bounds, element);
@@ -297,17 +375,58 @@ namespace carto {
             _projectionSurface = projectionSurface;
         }
 
+        // With the null index and no simplifier the loaded data is independent of the view,
+        // so the previously built element list can be shared across culls until the data
+        // source is modified. This avoids copying the full element list on every view change.
+        if (_spatialIndexType == LocalSpatialIndexType::LOCAL_SPATIAL_INDEX_TYPE_NULL && !_geometrySimplifier) {
+            if (!_cachedVectorData) {
+                _cachedVectorData = std::make_shared<VectorData>(_spatialIndex->getAll());
+            }
+            return _cachedVectorData;
+        }
+
         // Query the spatial index
         std::vector<std::shared_ptr<VectorElement> > elements = _spatialIndex->query(cullState->getViewState().getFrustum());
         
-        // If geometry simplifier is specified, create new vector elements with simplified geometry
+        // If geometry simplifier is specified, create new vector elements with simplified geometry.
+        // The view scale is quantized to discrete levels and the simplified elements are cached
+        // per element per level, so each level is built only once and then reused across view changes.
         if (_geometrySimplifier) {
             float simplifierScale = cullState->getViewState().estimateWorldPixelMeasure();
+            int simplifierLevel = static_cast<int>(std::floor(std::log2(simplifierScale)));
+            float levelScale = std::pow(2.0f, static_cast<float>(simplifierLevel));
+
+            // A topology-preserving simplifier works on the whole data set at once, so that
+            // boundaries shared between adjacent polygons stay shared after simplification.
+            // Build the full cache level on first use, the per-element loop below then
+            // finds all the elements in the cache.
+            if (auto batchSimplifier = std::dynamic_pointer_cast<TopologyPreservingGeometrySimplifier>(_geometrySimplifier)) {
+                if (_batchSimplifiedLevels.find(simplifierLevel) == _batchSimplifiedLevels.end()) {
+                    batchSimplifyElements(batchSimplifier, simplifierLevel, levelScale);
+                    _batchSimplifiedLevels.insert(simplifierLevel);
+                }
+            }
 
             std::vector<std::shared_ptr<VectorElement> > simplifiedElements;
             simplifiedElements.reserve(elements.size());
             for (const std::shared_ptr<VectorElement>& element : elements) {
-                std::shared_ptr<VectorElement> simplifiedElement = simplifyElement(element, simplifierScale);
+                std::shared_ptr<VectorElement> simplifiedElement;
+                bool cached = false;
+                auto cacheIt = _simplifiedElementCache.find(element->getId());
+                if (cacheIt != _simplifiedElementCache.end()) {
+                    auto levelIt = cacheIt->second.find(simplifierLevel);
+                    if (levelIt != cacheIt->second.end()) {
+                        simplifiedElement = levelIt->second;
+                        cached = true;
+                    }
+                }
+                if (!cached) {
+                    simplifiedElement = simplifyElement(element, levelScale);
+                    if (getSimplifiableGeometry(element)) {
+                        // Cache the result, also when the element was unchanged or simplified away
+                        _simplifiedElementCache[element->getId()][simplifierLevel] = simplifiedElement;
+                    }
+                }
                 if (simplifiedElement) {
                     simplifiedElements.emplace_back(std::move(simplifiedElement));
                 }
@@ -318,17 +437,66 @@ namespace carto {
         return std::make_shared<VectorData>(elements);
     }
 
+    void LocalVectorDataSource::notifyElementAdded(const std::shared_ptr<VectorElement>& element) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_transactionLevel > 0) {
+                _transactionAddedElements.push_back(element);
+                return;
+            }
+        }
+        VectorDataSource::notifyElementAdded(element);
+    }
+
     void LocalVectorDataSource::notifyElementChanged(const std::shared_ptr<VectorElement>& element) {
         {
             std::lock_guard<std::mutex> lock(_mutex);
+            invalidateSimplifiedElementCache(element->getId());
             if (!(std::dynamic_pointer_cast<NullSpatialIndex<std::shared_ptr<VectorElement>>>(_spatialIndex))) {
                 _spatialIndex->remove(element);
                 cglib::bbox3<double> bounds = calculateElementBounds(element);
                 _spatialIndex->insert(bounds, element);
             }
+            if (_transactionLevel > 0) {
+                _transactionElementsChanged = true;
+                return;
+            }
         }
         VectorDataSource::notifyElementChanged(element);
     }
+
+    void LocalVectorDataSource::notifyElementRemoved(const std::shared_ptr<VectorElement>& element) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_transactionLevel > 0) {
+                _transactionRemovedElements.push_back(element);
+                return;
+            }
+        }
+        VectorDataSource::notifyElementRemoved(element);
+    }
+
+    void LocalVectorDataSource::notifyElementsAdded(const std::vector<std::shared_ptr<VectorElement> >& elements) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_transactionLevel > 0) {
+                _transactionAddedElements.insert(_transactionAddedElements.end(), elements.begin(), elements.end());
+                return;
+            }
+        }
+        VectorDataSource::notifyElementsAdded(elements);
+    }
+
+    void LocalVectorDataSource::notifyElementsRemoved(const std::vector<std::shared_ptr<VectorElement> >& elements) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_transactionLevel > 0) {
+                _transactionRemovedElements.insert(_transactionRemovedElements.end(), elements.begin(), elements.end());
+                return;
+            }
+        }
+        VectorDataSource::notifyElementsRemoved(elements);
+    }
     
     std::shared_ptr<VectorElement> LocalVectorDataSource::createElement(const std::shared_ptr<Geometry>& geometry, const std::shared_ptr<Style>& style) const {
         if (auto polygonStyle = std::dynamic_pointer_cast<PolygonStyle>(style)) {
@@ -381,47 +549,50 @@ namespace carto {
         return std::shared_ptr<VectorElement>();
     }
     
-    std::shared_ptr<VectorElement> LocalVectorDataSource::simplifyElement(const std::shared_ptr<VectorElement>& element, float scale) const {
-        if (!_projectionSurface) {
-            return element;
+    std::shared_ptr<Geometry> LocalVectorDataSource::getSimplifiableGeometry(const std::shared_ptr<VectorElement>& element) const {
+        if (std::dynamic_pointer_cast<Line>(element) || std::dynamic_pointer_cast<Polygon>(element) || std::dynamic_pointer_cast<Polygon3D>(element) || std::dynamic_pointer_cast<GeometryCollection>(element)) {
+            return element->getGeometry();
         }
+        return std::shared_ptr<Geometry>();
+    }
 
+    std::shared_ptr<VectorElement> LocalVectorDataSource::recreateElement(const std::shared_ptr<VectorElement>& element, const std::shared_ptr<Geometry>& geometry) const {
         std::shared_ptr<VectorElement> simplifiedElement = element;
         if (auto lineElement = std::dynamic_pointer_cast<Line>(element)) {
-            auto lineGeometry = std::dynamic_pointer_cast<LineGeometry>(lineElement->getGeometry());
-            lineGeometry = std::dynamic_pointer_cast<LineGeometry>(_geometrySimplifier->simplify(lineGeometry, _projection, _projectionSurface, scale));
-            if (lineGeometry) {
-                simplifiedElement = std::make_shared<Line>(lineGeometry, lineElement->getStyle());
+            if (auto lineGeometry = std::dynamic_pointer_cast<LineGeometry>(geometry)) {
+                if (lineGeometry != lineElement->getGeometry()) {
+                    simplifiedElement = std::make_shared<Line>(lineGeometry, lineElement->getStyle());
+                }
             } else {
                 simplifiedElement.reset();
             }
         } else if (auto polygonElement = std::dynamic_pointer_cast<Polygon>(element)) {
-            auto polygonGeometry = std::dynamic_pointer_cast<PolygonGeometry>(polygonElement->getGeometry());
-            polygonGeometry = std::dynamic_pointer_cast<PolygonGeometry>(_geometrySimplifier->simplify(polygonGeometry, _projection, _projectionSurface, scale));
-            if (polygonGeometry) {
-                simplifiedElement = std::make_shared<Polygon>(polygonGeometry, polygonElement->getStyle());
+            if (auto polygonGeometry = std::dynamic_pointer_cast<PolygonGeometry>(geometry)) {
+                if (polygonGeometry != polygonElement->getGeometry()) {
+                    simplifiedElement = std::make_shared<Polygon>(polygonGeometry, polygonElement->getStyle());
+                }
             } else {
                 simplifiedElement.reset();
             }
         } else if (auto polygon3DElement = std::dynamic_pointer_cast<Polygon3D>(element)) {
-            auto polygonGeometry = std::dynamic_pointer_cast<PolygonGeometry>(polygon3DElement->getGeometry());
-            polygonGeometry = std::dynamic_pointer_cast<PolygonGeometry>(_geometrySimplifier->simplify(polygonGeometry, _projection, _projectionSurface, scale));
-            if (polygonGeometry) {
-                simplifiedElement = std::make_shared<Polygon3D>(polygonGeometry, polygon3DElement->getStyle(), polygon3DElement->getHeight());
+            if (auto polygonGeometry = std::dynamic_pointer_cast<PolygonGeometry>(geometry)) {
+                if (polygonGeometry != polygon3DElement->getGeometry()) {
+                    simplifiedElement = std::make_shared<Polygon3D>(polygonGeometry, polygon3DElement->getStyle(), polygon3DElement->getHeight());
+                }
             } else {
                 simplifiedElement.reset();
             }
         } else if (auto geomCollectionElement = std::dynamic_pointer_cast<GeometryCollection>(element)) {
-            auto multiGeometry = std::dynamic_pointer_cast<MultiGeometry>(geomCollectionElement->getGeometry());
-            multiGeometry = std::dynamic_pointer_cast<MultiGeometry>(_geometrySimplifier->simplify(multiGeometry, _projection, _projectionSurface, scale));
-            if (multiGeometry) {
-                simplifiedElement = std::make_shared<GeometryCollection>(multiGeometry, geomCollectionElement->getStyle());
+            if (auto multiGeometry = std::dynamic_pointer_cast<MultiGeometry>(geometry)) {
+                if (multiGeometry != geomCollectionElement->getGeometry()) {
+                    simplifiedElement = std::make_shared<GeometryCollection>(multiGeometry, geomCollectionElement->getStyle());
+                }
             } else {
                 simplifiedElement.reset();
             }
         }
 
-        if (simplifiedElement != element) {
+        if (simplifiedElement && simplifiedElement != element) {
             // Copy base attributes. Note: we will not attach the new element to the data source, it is temporary object
             simplifiedElement->setId(element->getId());
             simplifiedElement->setMetaData(element->getMetaData());
@@ -431,6 +602,51 @@ namespace carto {
         return simplifiedElement;
     }
 
+    std::shared_ptr<VectorElement> LocalVectorDataSource::simplifyElement(const std::shared_ptr<VectorElement>& element, float scale) const {
+        if (!_projectionSurface) {
+            return element;
+        }
+
+        std::shared_ptr<Geometry> geometry = getSimplifiableGeometry(element);
+        if (!geometry) {
+            return element;
+        }
+        return recreateElement(element, _geometrySimplifier->simplify(geometry, _projection, _projectionSurface, scale));
+    }
+
+    void LocalVectorDataSource::batchSimplifyElements(const std::shared_ptr<TopologyPreservingGeometrySimplifier>& simplifier, int simplifierLevel, float levelScale) {
+        if (!_projectionSurface) {
+            return;
+        }
+
+        std::vector<std::shared_ptr<VectorElement> > elements = _spatialIndex->getAll();
+        std::vector<std::shared_ptr<Geometry> > geometries;
+        geometries.reserve(elements.size());
+        for (const std::shared_ptr<VectorElement>& element : elements) {
+            geometries.push_back(getSimplifiableGeometry(element));
+        }
+        std::vector<std::shared_ptr<Geometry> > simplifiedGeometries = simplifier->simplifyAll(geometries, _projection, _projectionSurface, levelScale);
+        for (std::size_t i = 0; i < elements.size(); i++) {
+            if (!geometries[i]) {
+                continue;
+            }
+            // Cache all elements, including the unchanged ones. Otherwise the per-element
+            // fallback path would re-simplify them without the shared topology context.
+            _simplifiedElementCache[elements[i]->getId()][simplifierLevel] = recreateElement(elements[i], simplifiedGeometries[i]);
+        }
+    }
+
+    void LocalVectorDataSource::invalidateSimplifiedElementCache(long long elementId) {
+        if (std::dynamic_pointer_cast<TopologyPreservingGeometrySimplifier>(_geometrySimplifier)) {
+            // The simplified elements depend on their neighbours, any modification
+            // potentially invalidates the arcs shared with adjacent elements
+            _simplifiedElementCache.clear();
+            _batchSimplifiedLevels.clear();
+        } else {
+            _simplifiedElementCache.erase(elementId);
+        }
+    }
+
     cglib::bbox3<double> LocalVectorDataSource::calculateElementBounds(const std::shared_ptr<VectorElement>& element) const {
         if (!_projectionSurface) {
             return cglib::bbox3<double>(cglib::vec3<double>(0, 0, 0), cglib::vec3<double>(0, 0, 0));
@@ -10,7 +10,10 @@
 #include "datasources/VectorDataSource.h"
 #include "geometry/utils/SpatialIndex.h"
 
+#include <map>
 #include <memory>
+#include <set>
+#include <unordered_map>
 
 namespace carto {
 
@@ -27,7 +30,15 @@ namespace carto {
             /**
              * K-d tree index, element culling is exact and fast.
              */
-            LOCAL_SPATIAL_INDEX_TYPE_KDTREE
+            LOCAL_SPATIAL_INDEX_TYPE_KDTREE,
+
+            /**
+             * Packed R-tree index, element culling is exact and fast.
+             * Compared to the k-d tree index, it handles large data sets with
+             * heavily overlapping element bounds better, at the cost of a
+             * rebuild after the data source is modified.
+             */
+            LOCAL_SPATIAL_INDEX_TYPE_RTREE
         };
     }
 
@@ -36,6 +47,7 @@ namespace carto {
     class GeometrySimplifier;
     class ProjectionSurface;
     class Style;
+    class TopologyPreservingGeometrySimplifier;
 
     /**
      * A modifiable vector data source that keeps all the elements in the local memory.
@@ -64,7 +76,21 @@ namespace carto {
          * Clear the data source by removing all elements.
          */
         void clear();
-        
+
+        /**
+         * Starts a transaction. While a transaction is active, data source change notifications are
+         * collected instead of being delivered per element, so attached layers are not refreshed
+         * until the transaction is committed. This makes a burst of add/remove/update calls much
+         * cheaper than performing them one by one. Transactions can be nested, the collected
+         * notifications are delivered when the outermost transaction is committed.
+         */
+        void beginTransaction();
+        /**
+         * Commits a transaction started with beginTransaction. All change notifications collected
+         * during the transaction are delivered as single batches.
+         */
+        void commitTransaction();
+
         /**
          * Returns all vector elements added to this data source using add() and addAll() methods.
          * @return A vector containing all the vector elements in this data source.
@@ -112,6 +138,8 @@ namespace carto {
         std::shared_ptr<GeometrySimplifier> getGeometrySimplifier() const;
         /**
          * Attaches geometry simplifier to the data source. If the specified simplifier is null, detaches any active simplifier.
+         * If the simplifier is a TopologyPreservingGeometrySimplifier, all the elements of the data source are
+         * simplified together, keeping boundaries shared between adjacent polygons consistent.
          * @param simplifier The new geometry simplifier to use (can be null).
          */
         void setGeometrySimplifier(const std::shared_ptr<GeometrySimplifier>& simplifier);
@@ -133,20 +161,36 @@ namespace carto {
         virtual std::shared_ptr<VectorData> loadElements(const std::shared_ptr<CullState>& cullState);
 
     protected:
+        virtual void notifyElementAdded(const std::shared_ptr<VectorElement>& element);
         virtual void notifyElementChanged(const std::shared_ptr<VectorElement>& element);
+        virtual void notifyElementRemoved(const std::shared_ptr<VectorElement>& element);
+        virtual void notifyElementsAdded(const std::vector<std::shared_ptr<VectorElement> >& elements);
+        virtual void notifyElementsRemoved(const std::vector<std::shared_ptr<VectorElement> >& elements);
 
     private:
         std::shared_ptr<VectorElement> createElement(const std::shared_ptr<Geometry>& geometry, const std::shared_ptr<Style>& style) const;
+        std::shared_ptr<Geometry> getSimplifiableGeometry(const std::shared_ptr<VectorElement>& element) const;
+        std::shared_ptr<VectorElement> recreateElement(const std::shared_ptr<VectorElement>& element, const std::shared_ptr<Geometry>& geometry) const;
         std::shared_ptr<VectorElement> simplifyElement(const std::shared_ptr<VectorElement>& element, float scale) const;
+        void batchSimplifyElements(const std::shared_ptr<TopologyPreservingGeometrySimplifier>& simplifier, int simplifierLevel, float levelScale);
+        void invalidateSimplifiedElementCache(long long elementId);
         cglib::bbox3<double> calculateElementBounds(const std::shared_ptr<VectorElement>& element) const;
 
         std::shared_ptr<GeometrySimplifier> _geometrySimplifier;
+        mutable std::unordered_map<long long, std::map<int, std::shared_ptr<VectorElement> > > _simplifiedElementCache;
+        std::set<int> _batchSimplifiedLevels;
+        std::shared_ptr<VectorData> _cachedVectorData;
         std::shared_ptr<SpatialIndex<std::shared_ptr<VectorElement> > > _spatialIndex;
         LocalSpatialIndexType::LocalSpatialIndexType _spatialIndexType;
         std::shared_ptr<ProjectionSurface> _projectionSurface;
         
         unsigned int _elementId;
 
+        int _transactionLevel;
+        bool _transactionElementsChanged;
+        std::vector<std::shared_ptr<VectorElement> > _transactionAddedElements;
+        std::vector<std::shared_ptr<VectorElement> > _transactionRemovedElements;
+
         mutable std::mutex _mutex;
     };
     
@@ -19,12 +19,11 @@ namespace carto {
         TileDataSource(),
         _scheme(MBTilesScheme::MBTILES_SCHEME_TMS),
         _db(new sqlite3pp::database()),
+        _tileQuery(),
         _cachedDataExtent(),
         _mutex()
     {
-        if (_db->connect_v2(path.c_str(), SQLITE_OPEN_READONLY) != SQLITE_OK) {
-            throw FileException("Failed to open database file", path);
-        }
+        openDatabase(path);
 
         // First try to use metadata table for min/maxzoom values
         bool foundMinZoom = false, foundMaxZoom = false;
@@ -70,27 +69,46 @@ namespace carto {
         TileDataSource(minZoom, maxZoom),
         _scheme(MBTilesScheme::MBTILES_SCHEME_TMS),
         _db(new sqlite3pp::database()),
+        _tileQuery(),
         _cachedDataExtent(),
         _mutex()
     {
-        if (_db->connect_v2(path.c_str(), SQLITE_OPEN_READONLY) != SQLITE_OK) {
-            throw FileException("Failed to open database file", path);
-        }
+        openDatabase(path);
     }
     
     MBTilesTileDataSource::MBTilesTileDataSource(int minZoom, int maxZoom, const std::string& path, MBTilesScheme::MBTilesScheme scheme) :
         TileDataSource(minZoom, maxZoom),
         _scheme(scheme),
         _db(new sqlite3pp::database()),
+        _tileQuery(),
         _cachedDataExtent(),
         _mutex()
     {
-        if (_db->connect_v2(path.c_str(), SQLITE_OPEN_READONLY) != SQLITE_OK) {
+        openDatabase(path);
+    }
+        
+    void MBTilesTileDataSource::openDatabase(const std::string& path) {
+        // The database is opened without the sqlite connection mutex (access is serialized
+        // by our own mutex) and with a page cache shared between all instances.
+        if (_db->connect_v2(path.c_str(), SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX | SQLITE_OPEN_SHAREDCACHE) != SQLITE_OK) {
             throw FileException("Failed to open database file", path);
         }
+
+        // Map the database into memory so that repeated tile loads are served from warm
+        // pages. The pragma is advisory, sqlite falls back to normal reads when memory
+        // mapping is not available.
+        try {
+            std::string mmapPragma = "PRAGMA mmap_size=" + boost::lexical_cast<std::string>(MMAP_SIZE);
+            sqlite3pp::query query(*_db, mmapPragma.c_str());
+            for (auto it = query.begin(); it != query.end(); ++it);
+            query.finish();
+        } catch (const std::exception& ex) {
+            Log::Errorf("MBTilesTileDataSource: Failed to configure mmap for the database: %s", ex.what());
+        }
     }
-        
+
     MBTilesTileDataSource::~MBTilesTileDataSource() {
+        _tileQuery.reset();
         if (_db) {
             try {
                 if (_db->disconnect() != SQLITE_OK) {
@@ -208,14 +226,18 @@ namespace carto {
         }
         
         try {
-            // Make the query and check for database error
-            sqlite3pp::query query(*_db, "SELECT tile_data FROM tiles WHERE zoom_level=:zoom AND tile_column=:x AND tile_row=:y");
+            // Make the query and check for database error. The prepared query is reused between calls.
+            if (!_tileQuery) {
+                _tileQuery.reset(new sqlite3pp::query(*_db, "SELECT tile_data FROM tiles WHERE zoom_level=:zoom AND tile_column=:x AND tile_row=:y"));
+            }
+            sqlite3pp::query& query = *_tileQuery;
             query.bind(":zoom", mapTile.getZoom());
             query.bind(":x", mapTile.getX());
             query.bind(":y", _scheme == MBTilesScheme::MBTILES_SCHEME_XYZ ? mapTile.getY() : (1 << (mapTile.getZoom())) - 1 - mapTile.getY());
-            
+
             auto it = query.begin();
             if (it == query.end()) {
+                query.reset();
                 std::shared_ptr<TileData> tileData = std::make_shared<TileData>(std::shared_ptr<BinaryData>());
                 if (mapTile.getZoom() > getMinZoom()) {
                     Log::Infof("MBTilesTileDataSource::loadTile: Tile data doesn't exist in the database, redirecting to parent");
@@ -227,17 +249,22 @@ namespace carto {
                 return tileData;
             }
             
+            // Read the tile blob directly into a shared buffer. The same buffer flows
+            // through TileData to the decoder without further copies.
             std::size_t dataSize = (*it).column_bytes(0);
             const unsigned char* dataPtr = static_cast<const unsigned char*>((*it).get<const void*>(0));
-            auto data = std::make_shared<BinaryData>(dataPtr, dataSize);
-            query.finish();
-    
-            return std::make_shared<TileData>(data);
+            auto dataBuffer = std::make_shared<std::vector<unsigned char> >(dataPtr, dataPtr + dataSize);
+            query.reset();
+
+            return std::make_shared<TileData>(std::make_shared<BinaryData>(std::move(dataBuffer)));
         } catch (const std::exception& ex) {
             Log::Errorf("MBTilesTileDataSource::loadTile: Failed to query tile data from the database: %s", ex.what());
+            _tileQuery.reset(); // the prepared query may be left in an undefined state, drop it
             return std::shared_ptr<TileData>();
         }
     }
+
+    const long long MBTilesTileDataSource::MMAP_SIZE = 64 * 1024 * 1024;
     
 }
 
@@ -15,6 +15,7 @@
 
 namespace sqlite3pp {
     class database;
+    class query;
 }
     
 namespace carto {
@@ -85,8 +86,13 @@ namespace carto {
         virtual std::shared_ptr<TileData> loadTile(const MapTile& mapTile);
     
     private:
+        void openDatabase(const std::string& path);
+
+        static const long long MMAP_SIZE;
+
         MBTilesScheme::MBTilesScheme _scheme;
         std::unique_ptr<sqlite3pp::database> _db;
+        std::unique_ptr<sqlite3pp::query> _tileQuery;
         mutable std::unique_ptr<MapBounds> _cachedDataExtent;
         mutable std::mutex _mutex;
     };
@@ -3,6 +3,8 @@
 #include "core/MapTile.h"
 #include "utils/Log.h"
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
 
 namespace carto {
@@ -10,10 +12,27 @@ namespace carto {
     MemoryCacheTileDataSource::MemoryCacheTileDataSource(const std::shared_ptr<TileDataSource>& dataSource) :
         CacheTileDataSource(dataSource),
         _cache(DEFAULT_CAPACITY),
+        _cacheHitCount(0),
+        _cacheMissCount(0),
+        _cacheInsertCount(0),
+        _cacheRemoveCount(0),
+        _loadTimeSum(0),
         _mutex()
     {
     }
     
+    MemoryCacheTileDataSource::MemoryCacheTileDataSource(const std::shared_ptr<TileDataSource>& dataSource, std::size_t capacityInBytes) :
+        CacheTileDataSource(dataSource),
+        _cache(capacityInBytes),
+        _cacheHitCount(0),
+        _cacheMissCount(0),
+        _cacheInsertCount(0),
+        _cacheRemoveCount(0),
+        _loadTimeSum(0),
+        _mutex()
+    {
+    }
+
     MemoryCacheTileDataSource::~MemoryCacheTileDataSource() {
     }
     
@@ -25,31 +44,85 @@ namespace carto {
         std::shared_ptr<TileData> tileData;
         if (_cache.read(mapTile.getTileId(), tileData)) {
             if (tileData->getMaxAge() != 0) {
+                _cacheHitCount++;
+                promoteParentTiles(mapTile);
+                return tileData;
+            }
+            if (tileData->getData()) {
+                // The tile has expired. Serve the stale tile and refresh it in the background
+                // ('stale-while-revalidate'). Push the expiration time forward so that the
+                // refresh is not retriggered on every lookup while it is pending or failing.
+                tileData->setMaxAge(STALE_TILE_RETRY_DELAY);
+                refreshTileAsync(mapTile);
+                _cacheHitCount++;
+                promoteParentTiles(mapTile);
                 return tileData;
             }
             _cache.remove(mapTile.getTileId());
+            _cacheRemoveCount++;
         }
-        
+        _cacheMissCount++;
+
+        if (isTileFetchBlocked(mapTile.getTileId())) {
+            Log::Infof("MemoryCacheTileDataSource::loadTile: Fetching of %s is blocked due to recent failures", mapTile.toString().c_str());
+            return std::shared_ptr<TileData>();
+        }
+
         lock.unlock();
+        std::chrono::steady_clock::time_point loadStartTime = std::chrono::steady_clock::now();
         tileData = _dataSource->loadTile(mapTile);
+        std::chrono::steady_clock::time_point loadEndTime = std::chrono::steady_clock::now();
         lock.lock();
+        _loadTimeSum += std::chrono::duration_cast<std::chrono::duration<double> >(loadEndTime - loadStartTime).count();
+
+        registerTileFetchResult(mapTile.getTileId(), tileData);
 
         if (tileData) {
+            applyTileTTL(tileData);
             if (tileData->getMaxAge() != 0 && tileData->getData() && !tileData->isReplaceWithParent()) {
                 _cache.put(mapTile.getTileId(), tileData, tileData->getData()->size() + 16);
+                _cacheInsertCount++;
             }
         } else {
             Log::Infof("MemoryCacheTileDataSource::loadTile: Failed to load %s.", mapTile.toString().c_str());
         }
+        promoteParentTiles(mapTile);
         
         return tileData;
     }
     
     void MemoryCacheTileDataSource::clear() {
         std::lock_guard<std::recursive_mutex> lock(_mutex);
+        _cacheRemoveCount += static_cast<long long>(_cache.keys().size());
         _cache.clear();
     }
     
+    void MemoryCacheTileDataSource::promoteParentTiles(const MapTile& mapTile) {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        // Mark the cached ancestors of the tile as recently used. This keeps the
+        // low-zoom fallback chain of the current viewport in the cache, tiles
+        // unrelated to the current view are always evicted first.
+        for (MapTile parentTile = mapTile; parentTile.getZoom() > 0; ) {
+            parentTile = parentTile.getParent();
+            std::shared_ptr<TileData> tileData;
+            _cache.read(parentTile.getTileId(), tileData);
+        }
+    }
+
+    void MemoryCacheTileDataSource::storeRefreshedTile(const MapTile& mapTile, const std::shared_ptr<TileData>& tileData) {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        _cache.put(mapTile.getTileId(), tileData, tileData->getData()->size() + 16);
+        _cacheInsertCount++;
+    }
+
+    void MemoryCacheTileDataSource::removeTileFromCache(long long tileId) {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        if (_cache.exists(tileId)) {
+            _cache.remove(tileId);
+            _cacheRemoveCount++;
+        }
+    }
+
     std::size_t MemoryCacheTileDataSource::getCapacity() const {
         std::lock_guard<std::recursive_mutex> lock(_mutex);
         return _cache.capacity();
@@ -59,5 +132,13 @@ namespace carto {
         std::lock_guard<std::recursive_mutex> lock(_mutex);
         _cache.resize(capacityInBytes);
     }
+
+    CacheStats MemoryCacheTileDataSource::getCacheStats() const {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        long long elementCount = static_cast<long long>(_cache.keys().size());
+        long long evictionCount = std::max(_cacheInsertCount - _cacheRemoveCount - elementCount, static_cast<long long>(0));
+        float meanLoadLatency = _cacheMissCount > 0 ? static_cast<float>(_loadTimeSum / _cacheMissCount) : 0.0f;
+        return CacheStats(_cacheHitCount, _cacheMissCount, evictionCount, static_cast<std::size_t>(elementCount), _cache.capacity(), meanLoadLatency);
+    }
         
 }
@@ -25,6 +25,12 @@ namespace carto {
          * @param dataSource The datasource to be cached.
          */
         explicit MemoryCacheTileDataSource(const std::shared_ptr<TileDataSource>& dataSource);
+        /**
+         * Constructs a MemoryCacheTileDataSource object from tile data source with the specified cache capacity.
+         * @param dataSource The datasource to be cached.
+         * @param capacityInBytes The cache capacity in bytes.
+         */
+        MemoryCacheTileDataSource(const std::shared_ptr<TileDataSource>& dataSource, std::size_t capacityInBytes);
         virtual ~MemoryCacheTileDataSource();
     
         virtual std::shared_ptr<TileData> loadTile(const MapTile& mapTile);
@@ -34,11 +40,24 @@ namespace carto {
         virtual std::size_t getCapacity() const;
         
         virtual void setCapacity(std::size_t capacityInBytes);
+
+        virtual CacheStats getCacheStats() const;
     
     protected:
+        virtual void storeRefreshedTile(const MapTile& mapTile, const std::shared_ptr<TileData>& tileData);
+
+        virtual void removeTileFromCache(long long tileId);
+
+        void promoteParentTiles(const MapTile& mapTile);
+
         static const int DEFAULT_CAPACITY = 6 * 1024 * 1024;
 
         cache::timed_lru_cache<long long, std::shared_ptr<TileData> > _cache;
+        long long _cacheHitCount;
+        long long _cacheMissCount;
+        long long _cacheInsertCount;
+        long long _cacheRemoveCount;
+        double _loadTimeSum;
         mutable std::recursive_mutex _mutex;
     };
     
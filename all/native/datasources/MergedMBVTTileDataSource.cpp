@@ -5,6 +5,7 @@
 #include "utils/Log.h"
 
 #include <algorithm>
+#include <future>
 
 #include <stdext/zlib.h>
 
@@ -49,14 +50,26 @@ namespace carto {
     
     std::shared_ptr<TileData> MergedMBVTTileDataSource::loadTile(const MapTile& mapTile) {
         int zoom = mapTile.getZoom();
+        bool load1 = zoom <= _dataSource1->getMaxZoom() && zoom >= _dataSource1->getMinZoom();
+        bool load2 = zoom <= _dataSource2->getMaxZoom() && zoom >= _dataSource2->getMinZoom();
+
+        // Load the two sources concurrently, the serial load latencies would add up otherwise
         std::shared_ptr<TileData> result1;
         std::shared_ptr<TileData> result2;
-        if (zoom <= _dataSource1->getMaxZoom() && zoom >= _dataSource1->getMinZoom()) {
+        std::future<std::shared_ptr<TileData> > futureResult1;
+        if (load1 && load2) {
+            futureResult1 = std::async(std::launch::async, [this, mapTile]() {
+                return _dataSource1->loadTile(mapTile);
+            });
+        } else if (load1) {
             result1 = _dataSource1->loadTile(mapTile);
         }
-        if (zoom <= _dataSource2->getMaxZoom() && zoom >= _dataSource2->getMinZoom()) {
+        if (load2) {
             result2 = _dataSource2->loadTile(mapTile);
         }
+        if (futureResult1.valid()) {
+            result1 = futureResult1.get();
+        }
 
         if (result1 && result2) {
             // If either result contains 'replace with parent' then the only option is to pass this result on.
@@ -69,24 +82,26 @@ namespace carto {
             }
             
             // We have data for both sources, we can merge them. Note that we may need to decompress the data first.
+            // The layers themselves pass through unmodified as concatenated protobuf messages,
+            // so the merge is a copy, only the decompression is heavy. Decompress the two sources concurrently.
             std::shared_ptr<std::vector<unsigned char>> data1 = result1->getData()->getDataPtr();
             std::shared_ptr<std::vector<unsigned char>> data2 = result2->getData()->getDataPtr();
 
-            std::vector<unsigned char> mergedData;
-            mergedData.reserve(data1->size() + data2->size());
-
             std::vector<unsigned char> uncompressedData1;
-            if (zlib::inflate_gzip(data1->data(), data1->size(), uncompressedData1)) {
-                mergedData.insert(mergedData.end(), uncompressedData1.begin(), uncompressedData1.end());
-            } else {
-                mergedData.insert(mergedData.end(), data1->begin(), data1->end());
-            }
+            std::future<bool> futureInflated1 = std::async(std::launch::async, [&data1, &uncompressedData1]() {
+                return zlib::inflate_gzip(data1->data(), data1->size(), uncompressedData1);
+            });
             std::vector<unsigned char> uncompressedData2;
-            if (zlib::inflate_gzip(data2->data(), data2->size(), uncompressedData2)) {
-                mergedData.insert(mergedData.end(), uncompressedData2.begin(), uncompressedData2.end());
-            } else {
-                mergedData.insert(mergedData.end(), data2->begin(), data2->end());
-            }
+            bool inflated2 = zlib::inflate_gzip(data2->data(), data2->size(), uncompressedData2);
+            bool inflated1 = futureInflated1.get();
+
+            const std::vector<unsigned char>& mergedData1 = inflated1 ? uncompressedData1 : *data1;
+            const std::vector<unsigned char>& mergedData2 = inflated2 ? uncompressedData2 : *data2;
+
+            std::vector<unsigned char> mergedData;
+            mergedData.reserve(mergedData1.size() + mergedData2.size());
+            mergedData.insert(mergedData.end(), mergedData1.begin(), mergedData1.end());
+            mergedData.insert(mergedData.end(), mergedData2.begin(), mergedData2.end());
 
             auto mergedBinaryData = std::make_shared<BinaryData>(std::move(mergedData));
             return std::make_shared<TileData>(mergedBinaryData);
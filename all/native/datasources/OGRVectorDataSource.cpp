@@ -104,7 +104,8 @@ namespace carto {
         _localElements(),
         _dataBase(std::make_shared<OGRVectorDataBase>(fileName, false)),
         _poLayer(),
-        _poLayerSpatialRef()
+        _poLayerSpatialRef(),
+        _featureCache(FEATURE_CACHE_SIZE)
     {
         if (!styleSelector) {
             throw NullArgumentException("Null styleSelector");
@@ -128,7 +129,8 @@ namespace carto {
         _localElements(),
         _dataBase(dataBase),
         _poLayer(),
-        _poLayerSpatialRef()
+        _poLayerSpatialRef(),
+        _featureCache(FEATURE_CACHE_SIZE)
     {
         if (!styleSelector) {
             throw NullArgumentException("Null styleSelector");
@@ -158,6 +160,7 @@ namespace carto {
         {
             std::lock_guard<std::mutex> lock(_dataBase->_mutex);
             _codePage = codePage;
+            _featureCache.clear();
         }
         notifyElementsChanged();
     }
@@ -340,6 +343,8 @@ namespace carto {
             if (err != OGRERR_NONE) {
                 Log::Errorf("OGRVectorDataSource::commit: SyncToDisk failed, error code: %d", (int)err);
             }
+
+            _featureCache.clear();
         }
         notifyElementsChanged();
         return committedElements;
@@ -492,16 +497,33 @@ namespace carto {
 
         float simplifierScale = cullState->getViewState().estimateWorldPixelMeasure();
 
-        MapBounds bounds;
-        for (const MapPos& mapPos : cullState->getProjectionEnvelope(_projection).getConvexHull()) {
-            bounds.expandToContain(_poLayerSpatialRef->inverseTransform(mapPos.getX(), mapPos.getY(), mapPos.getZ()));
+        // Push the viewport convex hull down as the spatial filter. Compared to the
+        // bounding rectangle of the hull, this avoids materializing features outside
+        // of rotated or tilted viewports, as OGR tests intersection against the hull.
+        std::vector<MapPos> hullPoses = cullState->getProjectionEnvelope(_projection).getConvexHull();
+        if (hullPoses.size() >= 3) {
+            OGRLinearRing oHullRing;
+            for (const MapPos& mapPos : hullPoses) {
+                MapPos transPos = _poLayerSpatialRef->inverseTransform(mapPos.getX(), mapPos.getY(), mapPos.getZ());
+                oHullRing.addPoint(transPos.getX(), transPos.getY());
+            }
+            oHullRing.closeRings();
+            OGRPolygon oHullPoly;
+            oHullPoly.addRing(&oHullRing);
+            _poLayer->SetSpatialFilter(&oHullPoly);
+        } else {
+            MapBounds bounds;
+            for (const MapPos& mapPos : hullPoses) {
+                bounds.expandToContain(_poLayerSpatialRef->inverseTransform(mapPos.getX(), mapPos.getY(), mapPos.getZ()));
+            }
+            _poLayer->SetSpatialFilterRect(bounds.getMin().getX(), bounds.getMin().getY(), bounds.getMax().getX(), bounds.getMax().getY());
         }
-        _poLayer->SetSpatialFilterRect(bounds.getMin().getX(), bounds.getMin().getY(), bounds.getMax().getX(), bounds.getMax().getY());
 
         std::vector<std::shared_ptr<VectorElement>> elements;
         _poLayer->ResetReading();
         while (auto poFeature = std::shared_ptr<OGRFeature>(_poLayer->GetNextFeature(), OGRFeature::DestroyFeature)) {
-            auto elementIt = _localElements.find(poFeature->GetFID());
+            long long fid = poFeature->GetFID();
+            auto elementIt = _localElements.find(fid);
             if (elementIt != _localElements.end()) {
                 if (elementIt->second) {
                     elements.push_back(elementIt->second);
@@ -509,55 +531,65 @@ namespace carto {
                 continue;
             }
 
-            OGRGeometry* poGeometry = poFeature->GetGeometryRef();
-            if (!poGeometry) {
-                continue;
-            }
+            // Reuse the parsed geometry and decoded fields from the feature cache, if possible.
+            // The cache holds unsimplified geometry, so the simplifier can be applied per view.
+            std::shared_ptr<FeatureData> featureData;
+            if (!_featureCache.read(fid, featureData)) {
+                OGRGeometry* poGeometry = poFeature->GetGeometryRef();
+                if (!poGeometry) {
+                    continue;
+                }
 
-            std::map<std::string, Variant> metaData;
-            OGRFeatureDefn *poFDefn = _poLayer->GetLayerDefn();
-            if (poFDefn) {
-                for (int i = 0; i < poFDefn->GetFieldCount(); i++) {
-                    OGRFieldDefn* poFieldDefn = poFeature->GetFieldDefnRef(i);
-                    Variant value;
-                    switch (poFieldDefn->GetType()) {
-                    case OFTInteger:
-                        value = Variant(static_cast<long long>(poFeature->GetFieldAsInteger(i)));
-                        break;
-                    case OFTReal:
-                        value = Variant(poFeature->GetFieldAsDouble(i));
-                        break;
-                    default:
-                        {
-                            const char* strValue = poFeature->GetFieldAsString(i);
-                            if (!strValue) {
-                                continue;
-                            }
-                            char* utf8Value = CPLRecode(strValue, _codePage.c_str(), "UTF-8");
-                            if (utf8Value) {
-                                value = Variant(utf8Value);
-                                CPLFree(utf8Value);
-                            } else {
-                                value = Variant(strValue);
+                featureData = std::make_shared<FeatureData>();
+                OGRFeatureDefn *poFDefn = _poLayer->GetLayerDefn();
+                if (poFDefn) {
+                    for (int i = 0; i < poFDefn->GetFieldCount(); i++) {
+                        OGRFieldDefn* poFieldDefn = poFeature->GetFieldDefnRef(i);
+                        Variant value;
+                        switch (poFieldDefn->GetType()) {
+                        case OFTInteger:
+                            value = Variant(static_cast<long long>(poFeature->GetFieldAsInteger(i)));
+                            break;
+                        case OFTReal:
+                            value = Variant(poFeature->GetFieldAsDouble(i));
+                            break;
+                        default:
+                            {
+                                const char* strValue = poFeature->GetFieldAsString(i);
+                                if (!strValue) {
+                                    continue;
+                                }
+                                char* utf8Value = CPLRecode(strValue, _codePage.c_str(), "UTF-8");
+                                if (utf8Value) {
+                                    value = Variant(utf8Value);
+                                    CPLFree(utf8Value);
+                                } else {
+                                    value = Variant(strValue);
+                                }
                             }
+                            break;
                         }
-                        break;
+                        featureData->metaData[poFDefn->GetFieldDefn(i)->GetNameRef()] = value;
                     }
-                    metaData[poFDefn->GetFieldDefn(i)->GetNameRef()] = value;
+                }
+
+                featureData->geometry = createGeometry(poGeometry);
+                if (featureData->geometry) {
+                    _featureCache.put(fid, featureData, 1);
                 }
             }
-                
-            std::shared_ptr<Geometry> geometry = createGeometry(poGeometry);
+
+            std::shared_ptr<Geometry> geometry = featureData->geometry;
             if (_geometrySimplifier) {
                 if (geometry) {
                     geometry = _geometrySimplifier->simplify(geometry, _projection, cullState->getViewState().getProjectionSurface(), simplifierScale);
                 }
             }
             if (geometry) {
-                std::shared_ptr<VectorElement> vectorElement = createVectorElement(cullState->getViewState(), geometry, metaData);
+                std::shared_ptr<VectorElement> vectorElement = createVectorElement(cullState->getViewState(), geometry, featureData->metaData);
                 if (vectorElement) {
-                    vectorElement->setId(poFeature->GetFID());
-                    vectorElement->setMetaData(metaData);
+                    vectorElement->setId(fid);
+                    vectorElement->setMetaData(featureData->metaData);
                     attachElement(vectorElement);
                     elements.push_back(std::move(vectorElement));
                 }
@@ -828,6 +860,9 @@ namespace carto {
         return poFeature;
     }
 
+    // Maximum number of cached features, each cache entry is counted with unit size
+    const std::size_t OGRVectorDataSource::FEATURE_CACHE_SIZE = 16 * 1024;
+
 }
 
 #endif
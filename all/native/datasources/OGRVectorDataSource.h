@@ -16,6 +16,8 @@
 #include <map>
 #include <vector>
 
+#include <stdext/timed_lru_cache.h>
+
 class OGRGeometry;
 class OGRFeature;
 class OGRLayer;
@@ -206,7 +208,14 @@ namespace carto {
         
     private:
         struct LayerSpatialReference;
-        
+
+        // Parsed feature state, cached per FID so that repeated loads of the same
+        // area do not redo coordinate transformations and field decoding.
+        struct FeatureData {
+            std::shared_ptr<Geometry> geometry;
+            std::map<std::string, Variant> metaData;
+        };
+
         std::shared_ptr<Geometry> createGeometry(const OGRGeometry* poGeometry) const;
         
         std::shared_ptr<VectorElement> createVectorElement(const ViewState& viewState, const std::shared_ptr<Geometry>& geometry, const std::map<std::string, Variant>& metaData) const;
@@ -215,6 +224,8 @@ namespace carto {
 
         std::shared_ptr<OGRFeature> createOGRFeature(const std::shared_ptr<VectorElement>& element) const;
 
+        static const std::size_t FEATURE_CACHE_SIZE;
+
         std::string _codePage;
         std::shared_ptr<StyleSelector> _styleSelector;
         std::shared_ptr<GeometrySimplifier> _geometrySimplifier;
@@ -225,6 +236,8 @@ namespace carto {
         std::shared_ptr<OGRVectorDataBase> _dataBase;
         OGRLayer* _poLayer;
         std::shared_ptr<LayerSpatialReference> _poLayerSpatialRef;
+
+        cache::timed_lru_cache<long long, std::shared_ptr<FeatureData> > _featureCache;
     };
 }
 
@@ -51,7 +51,7 @@ namespace carto {
         if (zoom >= _dataSource1->getMinZoom()) {
             if (zoom <= _dataSource1->getMaxZoom()) {
                 result1 = _dataSource1->loadTile(mapTile);
-                if (result1 && !result1->isReplaceWithParent()) {
+                if (result1 && !result1->isReplaceWithParent() && result1->getErrorCode() == 0) {
                     return result1;
                 }
             } else {
@@ -62,7 +62,7 @@ namespace carto {
         if (zoom >= _dataSource2->getMinZoom()) {
             if (zoom <= _dataSource2->getMaxZoom()) {
                 result2 = _dataSource2->loadTile(mapTile);
-                if (result2 && !result2->isReplaceWithParent()) {
+                if (result2 && !result2->isReplaceWithParent() && result2->getErrorCode() == 0) {
                     return result2;
                 }
             } else {
@@ -15,6 +15,9 @@ namespace carto {
         TileDataSource(0, Const::MAX_SUPPORTED_ZOOM_LEVEL),
         _packageManager(packageManager),
         _cachedOpenPackageHandlers(),
+        _cachedIndexPackageHandlers(),
+        _cachedUnindexedPackageHandlers(),
+        _cachedTileMaskIndex(),
         _mutex()
     {
         if (!packageManager) {
@@ -43,44 +46,62 @@ namespace carto {
             _packageManager->accessLocalPackages([this, mapTileFlipped, &data](const std::map<std::shared_ptr<PackageInfo>, std::shared_ptr<PackageHandler> >& packageHandlerMap) {
                 std::lock_guard<std::mutex> lock(_mutex);
 
-                // Fast path: try already open packages
-                for (auto it = _cachedOpenPackageHandlers.begin(); it != _cachedOpenPackageHandlers.end(); it++) {
-                    const std::shared_ptr<PackageInfo>& packageInfo = it->first;
-                    std::shared_ptr<PackageTileMask> tileMask = packageInfo->getTileMask();
-                    if (tileMask) {
-                        if (tileMask->getTileStatus(mapTileFlipped) == PackageTileStatus::PACKAGE_TILE_STATUS_MISSING) {
-                            continue;
+                // Rebuild the combined tile mask index, if the packages have changed
+                if (!_cachedTileMaskIndex) {
+                    std::vector<std::shared_ptr<PackageTileMask> > tileMasks;
+                    _cachedIndexPackageHandlers.clear();
+                    _cachedUnindexedPackageHandlers.clear();
+                    for (auto it = packageHandlerMap.begin(); it != packageHandlerMap.end(); it++) {
+                        if (auto mapHandler = std::dynamic_pointer_cast<MapPackageHandler>(it->second)) {
+                            if (it->first->getTileMask() && _cachedIndexPackageHandlers.size() < MAX_INDEXED_PACKAGES) {
+                                tileMasks.push_back(it->first->getTileMask());
+                                _cachedIndexPackageHandlers.emplace_back(it->first, mapHandler);
+                            } else {
+                                _cachedUnindexedPackageHandlers.emplace_back(it->first, mapHandler);
+                            }
                         }
                     }
+                    _cachedTileMaskIndex = std::make_shared<PackageTileMask::Index>(tileMasks);
+                }
 
-                    data = it->second->loadTile(mapTileFlipped);
-                    if (data || tileMask) {
-                        std::rotate(_cachedOpenPackageHandlers.begin(), it, it + 1);
+                // Helper for loading a tile from a package, keeping a small number of packages open
+                auto loadPackageTile = [this](const std::shared_ptr<PackageInfo>& packageInfo, const std::shared_ptr<MapPackageHandler>& mapHandler, const MapTile& mapTile) -> std::shared_ptr<BinaryData> {
+                    for (auto it = _cachedOpenPackageHandlers.begin(); it != _cachedOpenPackageHandlers.end(); it++) {
+                        if (it->first == packageInfo) {
+                            std::rotate(_cachedOpenPackageHandlers.begin(), it, it + 1);
+                            return _cachedOpenPackageHandlers.front().second->loadTile(mapTile);
+                        }
+                    }
+                    mapHandler->openDatabase();
+                    _cachedOpenPackageHandlers.insert(_cachedOpenPackageHandlers.begin(), std::make_pair(packageInfo, mapHandler));
+                    if (_cachedOpenPackageHandlers.size() > MAX_OPEN_PACKAGES) {
+                        _cachedOpenPackageHandlers.back().second->closeDatabase();
+                        _cachedOpenPackageHandlers.pop_back();
+                    }
+                    return mapHandler->loadTile(mapTile);
+                };
+
+                // Fast path: a single index probe tells which packages contain the tile
+                std::uint64_t tileMaskBits = _cachedTileMaskIndex->findTileMasks(mapTileFlipped);
+                for (std::size_t i = 0; i < _cachedIndexPackageHandlers.size(); i++) {
+                    if (tileMaskBits & (1ULL << i)) {
+                        data = loadPackageTile(_cachedIndexPackageHandlers[i].first, _cachedIndexPackageHandlers[i].second, mapTileFlipped);
                         return;
                     }
                 }
 
-                // Slow path: try other packages
-                for (auto it = packageHandlerMap.begin(); it != packageHandlerMap.end(); it++) {
-                    if (auto mapHandler = std::dynamic_pointer_cast<MapPackageHandler>(it->second)) {
-                        const std::shared_ptr<PackageInfo>& packageInfo = it->first;
-                        std::shared_ptr<PackageTileMask> tileMask = packageInfo->getTileMask();
-                        if (tileMask) {
-                            if (tileMask->getTileStatus(mapTileFlipped) == PackageTileStatus::PACKAGE_TILE_STATUS_MISSING) {
-                                continue;
-                            }
+                // Slow path: try the packages that could not be indexed
+                for (auto it = _cachedUnindexedPackageHandlers.begin(); it != _cachedUnindexedPackageHandlers.end(); it++) {
+                    std::shared_ptr<PackageTileMask> tileMask = it->first->getTileMask();
+                    if (tileMask) {
+                        if (tileMask->getTileStatus(mapTileFlipped) == PackageTileStatus::PACKAGE_TILE_STATUS_MISSING) {
+                            continue;
                         }
+                    }
 
-                        mapHandler->openDatabase();
-                        data = mapHandler->loadTile(mapTileFlipped);
-                        if (data || tileMask) {
-                            _cachedOpenPackageHandlers.insert(_cachedOpenPackageHandlers.begin(), std::make_pair(packageInfo, mapHandler));
-                            if (_cachedOpenPackageHandlers.size() > MAX_OPEN_PACKAGES) {
-                                _cachedOpenPackageHandlers.back().second->closeDatabase();
-                                _cachedOpenPackageHandlers.pop_back();
-                            }
-                            return;
-                        }
+                    data = loadPackageTile(it->first, it->second, mapTileFlipped);
+                    if (data || tileMask) {
+                        return;
                     }
                 }
             });
@@ -115,6 +136,9 @@ namespace carto {
                 it->second->closeDatabase();
             }
             _dataSource._cachedOpenPackageHandlers.clear();
+            _dataSource._cachedIndexPackageHandlers.clear();
+            _dataSource._cachedUnindexedPackageHandlers.clear();
+            _dataSource._cachedTileMaskIndex.reset();
         }
         _dataSource.notifyTilesChanged(_dataSource._packageManager->getLocalPackages().empty()); // we need to remove all tiles only if there are no more packages left
     }
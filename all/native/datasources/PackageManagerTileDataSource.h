@@ -53,10 +53,14 @@ namespace carto {
         };
 
         static const int MAX_OPEN_PACKAGES = 4;
+        static const int MAX_INDEXED_PACKAGES = 64;
 
         const std::shared_ptr<PackageManager> _packageManager;
 
         mutable std::vector<std::pair<std::shared_ptr<PackageInfo>, std::shared_ptr<MapPackageHandler> > > _cachedOpenPackageHandlers;
+        mutable std::vector<std::pair<std::shared_ptr<PackageInfo>, std::shared_ptr<MapPackageHandler> > > _cachedIndexPackageHandlers;
+        mutable std::vector<std::pair<std::shared_ptr<PackageInfo>, std::shared_ptr<MapPackageHandler> > > _cachedUnindexedPackageHandlers;
+        mutable std::shared_ptr<PackageTileMask::Index> _cachedTileMaskIndex;
 
         mutable std::mutex _mutex;
 
@@ -1,24 +1,95 @@
 #include "PersistentCacheTileDataSource.h"
 #include "core/BinaryData.h"
+#include "datasources/CompactionListener.h"
 #include "datasources/TileDownloadListener.h"
 #include "utils/Log.h"
 #include "utils/TileUtils.h"
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
 
 #include <sqlite3pp.h>
 
+#include <stdext/zlib.h>
+
+#include <zlib.h>
+
+namespace {
+
+    bool isGZipData(const unsigned char* dataPtr, std::size_t dataSize) {
+        return dataSize >= 2 && dataPtr[0] == 0x1f && dataPtr[1] == 0x8b;
+    }
+
+    bool deflateGZip(const unsigned char* dataPtr, std::size_t dataSize, std::vector<unsigned char>& compressedData) {
+        z_stream stream;
+        std::memset(&stream, 0, sizeof(stream));
+        if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            return false;
+        }
+        compressedData.resize(deflateBound(&stream, static_cast<uLong>(dataSize)));
+        stream.next_in = const_cast<unsigned char*>(dataPtr);
+        stream.avail_in = static_cast<uInt>(dataSize);
+        stream.next_out = compressedData.data();
+        stream.avail_out = static_cast<uInt>(compressedData.size());
+        int result = deflate(&stream, Z_FINISH);
+        deflateEnd(&stream);
+        if (result != Z_STREAM_END) {
+            return false;
+        }
+        compressedData.resize(compressedData.size() - stream.avail_out);
+        return true;
+    }
+
+    bool deflateRawWithDictionary(const unsigned char* dataPtr, std::size_t dataSize, const std::vector<unsigned char>& dictionary, std::vector<unsigned char>& compressedData) {
+        z_stream stream;
+        std::memset(&stream, 0, sizeof(stream));
+        if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            return false;
+        }
+        if (deflateSetDictionary(&stream, dictionary.data(), static_cast<uInt>(dictionary.size())) != Z_OK) {
+            deflateEnd(&stream);
+            return false;
+        }
+        compressedData.resize(deflateBound(&stream, static_cast<uLong>(dataSize)));
+        stream.next_in = const_cast<unsigned char*>(dataPtr);
+        stream.avail_in = static_cast<uInt>(dataSize);
+        stream.next_out = compressedData.data();
+        stream.avail_out = static_cast<uInt>(compressedData.size());
+        int result = deflate(&stream, Z_FINISH);
+        deflateEnd(&stream);
+        if (result != Z_STREAM_END) {
+            return false;
+        }
+        compressedData.resize(compressedData.size() - stream.avail_out);
+        return true;
+    }
+
+}
+
 namespace carto {
     
     PersistentCacheTileDataSource::PersistentCacheTileDataSource(const std::shared_ptr<TileDataSource>& dataSource, const std::string& databasePath) :
         CacheTileDataSource(dataSource),
         _database(),
+        _pendingStores(0),
+        _cacheHitCount(0),
+        _cacheMissCount(0),
+        _cacheInsertCount(0),
+        _cacheRemoveCount(0),
+        _loadCount(0),
+        _loadTimeSum(0),
+        _lastCommitTime(),
+        _dictionary(),
+        _dictionarySamples(),
         _cacheOnlyMode(false),
+        _maxStaleness(-1),
         _downloadThreadPool(std::make_shared<CancelableThreadPool>()),
         _cache(DEFAULT_CAPACITY),
         _mutex()
     {
         _downloadThreadPool->setPoolSize(1);
+        _downloadThreadPool->setQoS(ThreadQoS::BACKGROUND);
         openDatabase(databasePath);
     }
     
@@ -38,6 +109,16 @@ namespace carto {
         _cacheOnlyMode = enabled;
     }
 
+    long long PersistentCacheTileDataSource::getMaxStaleness() const {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        return _maxStaleness;
+    }
+
+    void PersistentCacheTileDataSource::setMaxStaleness(long long stalenessMilliseconds) {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        _maxStaleness = stalenessMilliseconds < 0 ? -1 : stalenessMilliseconds;
+    }
+
     void PersistentCacheTileDataSource::startDownloadArea(const MapBounds& mapBounds, int minZoom, int maxZoom, const std::shared_ptr<TileDownloadListener>& tileDownloadListener) {
         auto task = std::make_shared<DownloadTask>(std::static_pointer_cast<PersistentCacheTileDataSource>(shared_from_this()), mapBounds, minZoom, maxZoom, tileDownloadListener);
         _downloadThreadPool->execute(task, 0);
@@ -46,7 +127,12 @@ namespace carto {
     void PersistentCacheTileDataSource::stopAllDownloads() {
         _downloadThreadPool->cancelAll();
     }
-    
+
+    void PersistentCacheTileDataSource::startCompaction(const std::shared_ptr<CompactionListener>& compactionListener) {
+        auto task = std::make_shared<CompactTask>(std::static_pointer_cast<PersistentCacheTileDataSource>(shared_from_this()), compactionListener);
+        _downloadThreadPool->execute(task, 0);
+    }
+
     std::shared_ptr<TileData> PersistentCacheTileDataSource::loadTile(const MapTile& mapTile) {
         std::unique_lock<std::recursive_mutex> lock(_mutex);
         
@@ -67,22 +153,47 @@ namespace carto {
             tileData = get(mapTile.getTileId());
             if (tileData) {
                 if (tileData->getMaxAge() != 0) {
+                    _cacheHitCount++;
+                    return tileData;
+                }
+                if (!_cacheOnlyMode && tileData->getData()) {
+                    // The tile has expired. Serve the stale tile and refresh it in the background
+                    // ('stale-while-revalidate'). Push the expiration time forward so that the
+                    // refresh is not retriggered on every lookup while it is pending or failing.
+                    tileData->setMaxAge(STALE_TILE_RETRY_DELAY);
+                    refreshTileAsync(mapTile);
+                    _cacheHitCount++;
                     return tileData;
                 }
             }
             _cache.remove(mapTile.getTileId());
+            _cacheRemoveCount++;
         }
-        
+        _cacheMissCount++;
+
         if (!_cacheOnlyMode) {
+            if (isTileFetchBlocked(mapTile.getTileId())) {
+                Log::Infof("PersistentCacheTileDataSource::loadTile: Fetching of %s is blocked due to recent failures", mapTile.toString().c_str());
+                return std::shared_ptr<TileData>();
+            }
+
             lock.unlock();
+            std::chrono::steady_clock::time_point loadStartTime = std::chrono::steady_clock::now();
             tileData = _dataSource->loadTile(mapTile);
+            std::chrono::steady_clock::time_point loadEndTime = std::chrono::steady_clock::now();
             lock.lock();
+            _loadCount++;
+            _loadTimeSum += std::chrono::duration_cast<std::chrono::duration<double> >(loadEndTime - loadStartTime).count();
+
+            registerTileFetchResult(mapTile.getTileId(), tileData);
         }
     
         if (tileData) {
+            applyTileTTL(tileData);
             if (tileData->getMaxAge() != 0 && !tileData->isReplaceWithParent() && tileData->getData()) {
                 _cache.put(mapTile.getTileId(), createTileId(mapTile.getTileId()), tileData->getData()->size());
                 if (_cache.exists(mapTile.getTileId())) { // make sure the tile was added
+                    _cacheInsertCount++;
                     store(mapTile.getTileId(), tileData);
                 }
             }
@@ -102,11 +213,18 @@ namespace carto {
         std::lock_guard<std::recursive_mutex> lock(_mutex);
         closeDatabase();
     }
+
+    void PersistentCacheTileDataSource::flush() {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        commitPendingStores();
+    }
         
     void PersistentCacheTileDataSource::clear() {
         try {
             std::lock_guard<std::recursive_mutex> lock(_mutex);
+            _cacheRemoveCount += static_cast<long long>(_cache.keys().size());
             _cache.clear(); // forces all elements to be removed, but can be slow
+            commitPendingStores();
         } catch (const std::exception& ex) {
             Log::Errorf("PersistentCacheTileDataSource::clear: Failed to clear cache: %s", ex.what());
         }
@@ -121,7 +239,46 @@ namespace carto {
         std::lock_guard<std::recursive_mutex> lock(_mutex);
         _cache.resize(capacityInBytes);
     }
+
+    CacheStats PersistentCacheTileDataSource::getCacheStats() const {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        long long elementCount = static_cast<long long>(_cache.keys().size());
+        long long evictionCount = std::max(_cacheInsertCount - _cacheRemoveCount - elementCount, static_cast<long long>(0));
+        float meanLoadLatency = _loadCount > 0 ? static_cast<float>(_loadTimeSum / _loadCount) : 0.0f;
+        return CacheStats(_cacheHitCount, _cacheMissCount, evictionCount, static_cast<std::size_t>(elementCount), _cache.capacity(), meanLoadLatency);
+    }
     
+    void PersistentCacheTileDataSource::storeRefreshedTile(const MapTile& mapTile, const std::shared_ptr<TileData>& tileData) {
+        try {
+            std::lock_guard<std::recursive_mutex> lock(_mutex);
+            if (_database && _cache.empty()) {
+                loadTileInfo();
+            }
+            _cache.put(mapTile.getTileId(), createTileId(mapTile.getTileId()), tileData->getData()->size());
+            if (_cache.exists(mapTile.getTileId())) { // make sure the tile was added
+                _cacheInsertCount++;
+                store(mapTile.getTileId(), tileData);
+            }
+        } catch (const std::exception& ex) {
+            Log::Errorf("PersistentCacheTileDataSource::storeRefreshedTile: Failed to store tile: %s", ex.what());
+        }
+    }
+
+    void PersistentCacheTileDataSource::removeTileFromCache(long long tileId) {
+        try {
+            std::lock_guard<std::recursive_mutex> lock(_mutex);
+            if (_database && _cache.empty()) {
+                loadTileInfo();
+            }
+            if (_cache.exists(tileId)) {
+                _cacheRemoveCount++;
+            }
+            _cache.remove(tileId); // removes the corresponding database row via the element deleter
+        } catch (const std::exception& ex) {
+            Log::Errorf("PersistentCacheTileDataSource::removeTileFromCache: Failed to remove tile: %s", ex.what());
+        }
+    }
+
     void PersistentCacheTileDataSource::openDatabase(const std::string& databasePath) {
         try {
             _database.reset(new sqlite3pp::database(databasePath.c_str()));
@@ -140,6 +297,23 @@ namespace carto {
             command2.execute();
             command2.finish();
 
+            // Keep the freelist incrementally vacuumable, so that background compaction can
+            // release unused pages in small steps. This only takes effect for new databases,
+            // existing databases fall back to a full VACUUM during compaction.
+            sqlite3pp::command autoVacuumCommand(*_database, "PRAGMA auto_vacuum=INCREMENTAL");
+            autoVacuumCommand.execute();
+            autoVacuumCommand.finish();
+
+            // Use WAL journaling with relaxed syncing. Tile writes are batched into
+            // grouped transactions and the cache can tolerate losing the last batch.
+            sqlite3pp::query walQuery(*_database, "PRAGMA journal_mode=WAL");
+            for (auto it = walQuery.begin(); it != walQuery.end(); ++it);
+            walQuery.finish();
+
+            sqlite3pp::command command3(*_database, "PRAGMA synchronous=NORMAL");
+            command3.execute();
+            command3.finish();
+
             try {
                 sqlite3pp::query query1(*_database, "SELECT name FROM sqlite_master WHERE type='table' AND name='persistent_cache'");
                 for (auto it1 = query1.begin(); it1 != query1.end(); ++it1) {
@@ -155,9 +329,23 @@ namespace carto {
                 command.finish();
             }
 
-            sqlite3pp::command command3(*_database, "CREATE TABLE IF NOT EXISTS persistent_cache(tileId INTEGER NOT NULL PRIMARY KEY, compressed BLOB, time INTEGER, expirationTime INTEGER)");
-            command3.execute();
-            command3.finish();
+            sqlite3pp::command command4(*_database, "CREATE TABLE IF NOT EXISTS persistent_cache(tileId INTEGER NOT NULL PRIMARY KEY, compressed BLOB, time INTEGER, expirationTime INTEGER, encoding INTEGER NOT NULL DEFAULT 0)");
+            command4.execute();
+            command4.finish();
+
+            sqlite3pp::command command5(*_database, "CREATE TABLE IF NOT EXISTS persistent_cache_dictionary(id INTEGER NOT NULL PRIMARY KEY, dictionary BLOB)");
+            command5.execute();
+            command5.finish();
+
+            try {
+                sqlite3pp::command command6(*_database, "ALTER TABLE persistent_cache ADD COLUMN encoding INTEGER NOT NULL DEFAULT 0");
+                command6.execute();
+                command6.finish();
+            } catch (const std::exception&) {
+                // The encoding column already exists
+            }
+
+            loadDictionary();
         } catch (const std::exception& ex) {
             Log::Errorf("PersistentCacheTileDataSource::openDatabase: Failed to initialize database: %s", ex.what());
             _database.reset();
@@ -170,6 +358,8 @@ namespace carto {
             return;
         }
 
+        commitPendingStores();
+
         try {
             if (_database->disconnect() != SQLITE_OK) {
                 Log::Error("PersistentCacheTileDataSource::closeDatabase: Failed to close database");
@@ -181,6 +371,8 @@ namespace carto {
         }
 
         _cache.clear(); // NOTE: as the database is closed at this point, elements are not removed
+        _dictionary.clear();
+        _dictionarySamples.clear();
     }
     
     void PersistentCacheTileDataSource::loadTileInfo() {
@@ -201,6 +393,58 @@ namespace carto {
             Log::Errorf("PersistentCacheTileDataSource::loadTileInfo: Failed to query tile set from the database: %s", ex.what());
         }
     }
+
+    void PersistentCacheTileDataSource::loadDictionary() {
+        _dictionary.clear();
+        _dictionarySamples.clear();
+
+        try {
+            sqlite3pp::query query(*_database, "SELECT dictionary FROM persistent_cache_dictionary WHERE id=0");
+            for (auto it = query.begin(); it != query.end(); ++it) {
+                std::size_t dictionarySize = (*it).column_bytes(0);
+                const unsigned char* dictionaryPtr = static_cast<const unsigned char*>((*it).get<const void*>(0));
+                _dictionary.assign(dictionaryPtr, dictionaryPtr + dictionarySize);
+            }
+            query.finish();
+        } catch (const std::exception& ex) {
+            Log::Errorf("PersistentCacheTileDataSource::loadDictionary: Failed to query dictionary from the database: %s", ex.what());
+        }
+    }
+
+    void PersistentCacheTileDataSource::updateDictionary(const std::vector<unsigned char>& data) {
+        if (!_dictionary.empty() || data.empty()) {
+            return;
+        }
+
+        // Collect a bounded sample from each payload. Once enough samples are gathered,
+        // concatenate them into a preset dictionary and persist it. The dictionary is
+        // built only once per database, as stored entries must remain decodable with it.
+        std::size_t sampleSize = std::min(data.size(), static_cast<std::size_t>(DICTIONARY_SAMPLE_SIZE));
+        _dictionarySamples.emplace_back(data.begin(), data.begin() + sampleSize);
+        if (_dictionarySamples.size() < static_cast<std::size_t>(DICTIONARY_SAMPLE_COUNT)) {
+            return;
+        }
+
+        std::vector<unsigned char> dictionary;
+        dictionary.reserve(DICTIONARY_SAMPLE_COUNT * DICTIONARY_SAMPLE_SIZE);
+        for (const std::vector<unsigned char>& sample : _dictionarySamples) {
+            dictionary.insert(dictionary.end(), sample.begin(), sample.end());
+        }
+        _dictionarySamples.clear();
+
+        // Store the dictionary outside of the batched tile transactions,
+        // a rolled back batch must not take the dictionary with it
+        commitPendingStores();
+        try {
+            sqlite3pp::command command(*_database, "INSERT OR REPLACE INTO persistent_cache_dictionary(id, dictionary) VALUES(0, :dictionary)");
+            command.bind(":dictionary", dictionary.data(), static_cast<unsigned int>(dictionary.size()));
+            command.execute();
+            command.finish();
+            _dictionary = std::move(dictionary);
+        } catch (const std::exception& ex) {
+            Log::Errorf("PersistentCacheTileDataSource::updateDictionary: Failed to store dictionary in the database: %s", ex.what());
+        }
+    }
     
     std::shared_ptr<TileData> PersistentCacheTileDataSource::get(long long tileId) {
         if (!_database) {
@@ -209,7 +453,7 @@ namespace carto {
     
         try {
             // Get the tile from the database
-            sqlite3pp::query query(*_database, "SELECT compressed, expirationTime FROM persistent_cache WHERE tileId=:tileId");
+            sqlite3pp::query query(*_database, "SELECT compressed, expirationTime, encoding FROM persistent_cache WHERE tileId=:tileId");
             query.bind(":tileId", static_cast<std::uint64_t>(tileId));
             auto qit = query.begin();
             if (qit == query.end()) {
@@ -218,16 +462,34 @@ namespace carto {
                 return std::shared_ptr<TileData>();
             }
             
-            // Construct TileData from the blob returned from the database
+            // Construct TileData from the blob returned from the database.
+            // Dictionary-compressed and gzipped blobs are decompressed, other blobs are passed through as-is.
             std::size_t dataSize = (*qit).column_bytes(0);
             const unsigned char* dataPtr = static_cast<const unsigned char*>((*qit).get<const void*>(0));
             long long expirationTime = (*qit).get<std::uint64_t>(1);
-            auto data = std::make_shared<BinaryData>(dataPtr, dataSize);
+            int encoding = (*qit).get<int>(2);
+            std::shared_ptr<BinaryData> data;
+            std::vector<unsigned char> uncompressedData;
+            if (encoding == BLOB_ENCODING_DICTIONARY_DEFLATE) {
+                if (_dictionary.empty() || !zlib::inflate_raw(dataPtr, dataSize, _dictionary.data(), _dictionary.size(), uncompressedData)) {
+                    Log::Error("PersistentCacheTileDataSource::get: Failed to decompress dictionary-compressed tile data");
+                    return std::shared_ptr<TileData>();
+                }
+                data = std::make_shared<BinaryData>(std::move(uncompressedData));
+            } else if (isGZipData(dataPtr, dataSize) && zlib::inflate_gzip(dataPtr, dataSize, uncompressedData)) {
+                data = std::make_shared<BinaryData>(std::move(uncompressedData));
+            } else {
+                data = std::make_shared<BinaryData>(dataPtr, dataSize);
+            }
             query.finish();
             
             auto tileData = std::make_shared<TileData>(data);
             if (expirationTime != 0) {
                 long long maxAge = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::time_point(std::chrono::milliseconds(expirationTime)) - std::chrono::system_clock::now()).count();
+                if (maxAge <= 0 && _maxStaleness >= 0 && -maxAge > _maxStaleness) {
+                    // The tile expired too long ago to be served even stale, treat it as missing
+                    return std::shared_ptr<TileData>();
+                }
                 tileData->setMaxAge(maxAge > 0 ? maxAge : 0);
             }
             return tileData;
@@ -248,20 +510,73 @@ namespace carto {
             expirationTime = std::chrono::duration_cast<std::chrono::milliseconds>((std::chrono::system_clock::now() + std::chrono::milliseconds(tileData->getMaxAge())).time_since_epoch()).count();
         }
 
-        // Add tile to the database
+        // Compress the blob before storing, unless the data is already gzipped or
+        // compression does not help (already-compressed formats like PNG/JPEG tiles).
+        // Prefer the shared dictionary, as tiles share lots of redundancy (layer names, key strings).
+        const std::shared_ptr<BinaryData>& data = tileData->getData();
+        std::vector<unsigned char> compressedData;
+        int encoding = BLOB_ENCODING_DEFAULT;
+        bool storeCompressed = false;
+        if (!isGZipData(data->data(), data->size())) {
+            updateDictionary(*data->getDataPtr());
+            if (!_dictionary.empty()) {
+                storeCompressed = deflateRawWithDictionary(data->data(), data->size(), _dictionary, compressedData) && compressedData.size() < data->size();
+                if (storeCompressed) {
+                    encoding = BLOB_ENCODING_DICTIONARY_DEFLATE;
+                }
+            }
+            if (!storeCompressed) {
+                storeCompressed = deflateGZip(data->data(), data->size(), compressedData) && compressedData.size() < data->size();
+            }
+        }
+
+        // Add tile to the database. Inserts are grouped into larger transactions
+        // and committed when the batch grows big or old enough.
         try {
-            sqlite3pp::command command(*_database, "INSERT OR REPLACE INTO persistent_cache(tileId, compressed, time, expirationTime) VALUES (:tileId, :compressed, :time, :expirationTime)");
+            if (_pendingStores == 0) {
+                _database->execute("BEGIN");
+                _lastCommitTime = std::chrono::steady_clock::now();
+            }
+
+            sqlite3pp::command command(*_database, "INSERT OR REPLACE INTO persistent_cache(tileId, compressed, time, expirationTime, encoding) VALUES (:tileId, :compressed, :time, :expirationTime, :encoding)");
             command.bind(":tileId", static_cast<std::uint64_t>(tileId));
-            command.bind(":compressed", tileData->getData()->data(), static_cast<unsigned int>(tileData->getData()->size()));
+            if (storeCompressed) {
+                command.bind(":compressed", compressedData.data(), static_cast<unsigned int>(compressedData.size()));
+            } else {
+                command.bind(":compressed", data->data(), static_cast<unsigned int>(data->size()));
+            }
             command.bind(":time", static_cast<std::uint64_t>(time));
             command.bind(":expirationTime", static_cast<std::uint64_t>(expirationTime));
+            command.bind(":encoding", encoding);
             command.execute();
             command.finish();
+            _pendingStores++;
+
+            if (_pendingStores >= MAX_PENDING_STORES || std::chrono::steady_clock::now() - _lastCommitTime >= std::chrono::milliseconds(MAX_COMMIT_INTERVAL_MS)) {
+                commitPendingStores();
+            }
         } catch (const std::exception& ex) {
             Log::Errorf("PersistentCacheTileDataSource::store: Failed to store tile data in the database: %s", ex.what());
         }
     }
 
+    void PersistentCacheTileDataSource::commitPendingStores() {
+        if (!_database || _pendingStores == 0) {
+            return;
+        }
+
+        try {
+            _database->execute("COMMIT");
+        } catch (const std::exception& ex) {
+            Log::Errorf("PersistentCacheTileDataSource::commitPendingStores: Failed to commit stored tiles: %s", ex.what());
+            try {
+                _database->execute("ROLLBACK");
+            } catch (const std::exception&) {
+            }
+        }
+        _pendingStores = 0;
+    }
+
     void PersistentCacheTileDataSource::remove(long long tileId) {
         if (!_database) {
             return;
@@ -276,7 +591,45 @@ namespace carto {
             Log::Errorf("PersistentCacheTileDataSource::remove: Failed to remove tile from the database: %s", ex.what());
         }
     }
-    
+
+    bool PersistentCacheTileDataSource::verifyTile(long long tileId) {
+        if (!_database) {
+            return false;
+        }
+
+        // Check that the stored blob exists and still decompresses cleanly.
+        // Uncompressed blobs are passed through as-is by the load path, so only their presence can be checked.
+        try {
+            sqlite3pp::query query(*_database, "SELECT compressed, encoding FROM persistent_cache WHERE tileId=:tileId");
+            query.bind(":tileId", static_cast<std::uint64_t>(tileId));
+            auto qit = query.begin();
+            if (qit == query.end()) {
+                return false;
+            }
+            std::size_t dataSize = (*qit).column_bytes(0);
+            const unsigned char* dataPtr = static_cast<const unsigned char*>((*qit).get<const void*>(0));
+            int encoding = (*qit).get<int>(1);
+            if (!dataPtr || dataSize == 0) {
+                return false;
+            }
+            std::vector<unsigned char> uncompressedData;
+            if (encoding == BLOB_ENCODING_DICTIONARY_DEFLATE) {
+                if (_dictionary.empty() || !zlib::inflate_raw(dataPtr, dataSize, _dictionary.data(), _dictionary.size(), uncompressedData)) {
+                    return false;
+                }
+            } else if (isGZipData(dataPtr, dataSize)) {
+                if (!zlib::inflate_gzip(dataPtr, dataSize, uncompressedData)) {
+                    return false;
+                }
+            }
+            query.finish();
+            return true;
+        } catch (const std::exception& ex) {
+            Log::Errorf("PersistentCacheTileDataSource::verifyTile: Failed to verify tile data: %s", ex.what());
+            return false;
+        }
+    }
+
     std::shared_ptr<long long> PersistentCacheTileDataSource::createTileId(long long tileId) {
         std::weak_ptr<PersistentCacheTileDataSource> cacheWeak(std::static_pointer_cast<PersistentCacheTileDataSource>(shared_from_this()));
         auto tileIdDeleter = [cacheWeak](long long* tileIdPtr) {
@@ -333,7 +686,10 @@ namespace carto {
         for (int zoom = minZoom; zoom <= maxZoom; zoom++) {
             MapTile mapTile1 = TileUtils::CalculateMapTile(_mapBounds.getMin(), zoom, projection);
             MapTile mapTile2 = TileUtils::CalculateMapTile(_mapBounds.getMax(), zoom, projection);
-            for (int y = std::min(mapTile1.getY(), mapTile2.getY()); y <= std::max(mapTile1.getY(), mapTile2.getY()); y++) {
+            // Iterate the rows from bottom to top. The tiles are stored keyed by the id of the
+            // flipped tile, so this visits the tiles in increasing storage key order and the
+            // cache database b-tree gets sequential appends instead of random-order inserts.
+            for (int y = std::max(mapTile1.getY(), mapTile2.getY()); y >= std::min(mapTile1.getY(), mapTile2.getY()); y--) {
                 if (isCanceled()) {
                     break;
                 }
@@ -371,4 +727,142 @@ namespace carto {
         Log::Info("PersistentCacheTileDataSource:: DownloadTask: Finished downloading");
     }
 
+    PersistentCacheTileDataSource::CompactTask::CompactTask(const std::shared_ptr<PersistentCacheTileDataSource>& dataSource, const std::shared_ptr<CompactionListener>& listener) :
+        _dataSource(dataSource),
+        _compactionListener(listener)
+    {
+    }
+
+    void PersistentCacheTileDataSource::CompactTask::run() {
+        auto dataSource = _dataSource.lock();
+        if (!dataSource) {
+            return;
+        }
+        if (!dataSource->isOpen()) {
+            Log::Warn("PersistentCacheTileDataSource:: CompactTask: Database is not open, skipping compaction");
+            return;
+        }
+
+        Log::Info("PersistentCacheTileDataSource:: CompactTask: Starting compaction");
+
+        if (_compactionListener) {
+            _compactionListener->onCompactionStarting();
+        }
+
+        // Collect the stored tile ids first; the rows are then processed one by one
+        // with the mutex released in between, so tile loading is not blocked for long.
+        std::vector<long long> tileIds;
+        {
+            std::lock_guard<std::recursive_mutex> lock(dataSource->_mutex);
+            if (!dataSource->_database) {
+                return;
+            }
+            dataSource->commitPendingStores();
+            if (dataSource->_cache.empty()) {
+                dataSource->loadTileInfo(); // trims the stored tile set down to the configured capacity
+            }
+            try {
+                sqlite3pp::query query(*dataSource->_database, "SELECT tileId FROM persistent_cache");
+                for (auto it = query.begin(); it != query.end(); ++it) {
+                    tileIds.push_back((*it).get<std::uint64_t>(0));
+                }
+                query.finish();
+            } catch (const std::exception& ex) {
+                Log::Errorf("PersistentCacheTileDataSource:: CompactTask: Failed to query tile set from the database: %s", ex.what());
+                return;
+            }
+        }
+
+        // Drop rows that are no longer part of the trimmed tile set and rows that fail verification
+        std::size_t droppedCount = 0;
+        for (std::size_t i = 0; i < tileIds.size(); i++) {
+            if (isCanceled()) {
+                return;
+            }
+            {
+                std::lock_guard<std::recursive_mutex> lock(dataSource->_mutex);
+                if (!dataSource->_database) {
+                    return;
+                }
+                if (!dataSource->_cache.exists(tileIds[i])) {
+                    dataSource->remove(tileIds[i]);
+                    droppedCount++;
+                } else if (!dataSource->verifyTile(tileIds[i])) {
+                    dataSource->_cache.remove(tileIds[i]); // removes the database row via the element deleter
+                    dataSource->_cacheRemoveCount++;
+                    droppedCount++;
+                }
+            }
+            if (_compactionListener) {
+                _compactionListener->onCompactionProgress(static_cast<float>(90.0 * (i + 1) / tileIds.size()));
+            }
+        }
+        if (droppedCount > 0) {
+            Log::Infof("PersistentCacheTileDataSource:: CompactTask: Dropped %d stale or corrupt tiles", static_cast<int>(droppedCount));
+        }
+
+        // Release the freed pages back to the file system. Incremental vacuuming is done
+        // in small chunks with the mutex released in between; databases created before
+        // incremental vacuuming was enabled require a full VACUUM instead.
+        bool incrementalVacuum = false;
+        {
+            std::lock_guard<std::recursive_mutex> lock(dataSource->_mutex);
+            if (!dataSource->_database) {
+                return;
+            }
+            try {
+                sqlite3pp::query query(*dataSource->_database, "PRAGMA auto_vacuum");
+                for (auto it = query.begin(); it != query.end(); ++it) {
+                    incrementalVacuum = (*it).get<int>(0) == 2;
+                }
+                query.finish();
+            } catch (const std::exception& ex) {
+                Log::Errorf("PersistentCacheTileDataSource:: CompactTask: Failed to query vacuum mode: %s", ex.what());
+            }
+        }
+
+        try {
+            if (incrementalVacuum) {
+                while (!isCanceled()) {
+                    std::lock_guard<std::recursive_mutex> lock(dataSource->_mutex);
+                    if (!dataSource->_database) {
+                        return;
+                    }
+                    dataSource->commitPendingStores(); // vacuuming can not run inside a transaction
+                    long long freePageCount = 0;
+                    sqlite3pp::query query(*dataSource->_database, "PRAGMA freelist_count");
+                    for (auto it = query.begin(); it != query.end(); ++it) {
+                        freePageCount = (*it).get<std::uint64_t>(0);
+                    }
+                    query.finish();
+                    if (freePageCount == 0) {
+                        break;
+                    }
+                    std::string vacuumCommand = "PRAGMA incremental_vacuum(" + std::to_string(VACUUM_PAGE_CHUNK) + ")";
+                    dataSource->_database->execute(vacuumCommand.c_str());
+                }
+            } else {
+                std::lock_guard<std::recursive_mutex> lock(dataSource->_mutex);
+                if (!dataSource->_database) {
+                    return;
+                }
+                dataSource->commitPendingStores(); // vacuuming can not run inside a transaction
+                dataSource->_database->execute("VACUUM");
+            }
+        } catch (const std::exception& ex) {
+            Log::Errorf("PersistentCacheTileDataSource:: CompactTask: Failed to vacuum the database: %s", ex.what());
+        }
+
+        if (isCanceled()) {
+            return;
+        }
+
+        if (_compactionListener) {
+            _compactionListener->onCompactionProgress(100.0f);
+            _compactionListener->onCompactionCompleted();
+        }
+
+        Log::Info("PersistentCacheTileDataSource:: CompactTask: Finished compaction");
+    }
+
 }
@@ -12,7 +12,9 @@
 #include "components/DirectorPtr.h"
 #include "datasources/CacheTileDataSource.h"
 
+#include <chrono>
 #include <string>
+#include <vector>
 
 #include <stdext/timed_lru_cache.h>
 
@@ -21,6 +23,7 @@ namespace sqlite3pp {
 }
 
 namespace carto {
+    class CompactionListener;
     class TileDownloadListener;
 
     /**
@@ -30,6 +33,8 @@ namespace carto {
      * The database contains table "persistent_cache" with the following fields:
      * "tileId" (tile id), "compressed" (compressed tile image),
      * "time" (the time the tile was cached in milliseconds from epoch).
+     * Tile blobs are transparently compressed using a shared compression dictionary
+     * that is built from the first cached tiles and stored in table "persistent_cache_dictionary".
      * Default cache capacity is 50MB.
      */
     class PersistentCacheTileDataSource : public CacheTileDataSource {
@@ -57,6 +62,22 @@ namespace carto {
          */
         void setCacheOnlyMode(bool enabled);
 
+        /**
+         * Returns the maximum staleness of tiles served from the cache.
+         * @return The maximum staleness of the served tiles in milliseconds, or -1 if no bound is set.
+         */
+        long long getMaxStaleness() const;
+        /**
+         * Sets the maximum staleness of tiles served from the cache.
+         * An expired cached tile is normally served immediately and refreshed in the background,
+         * so the map stays available during connectivity problems. This bound limits how long
+         * past its expiration time a tile may still be served this way: a tile that expired
+         * longer ago is dropped from the cache and fetched synchronously instead.
+         * By default no bound is set and expired tiles are served regardless of their age.
+         * @param stalenessMilliseconds The maximum staleness of the served tiles in milliseconds, or -1 to remove the bound.
+         */
+        void setMaxStaleness(long long stalenessMilliseconds);
+
         /**
          * Starts downloading the specified area. The area will be stored in the cache.
          * Note that is the area is too big or cache is already filled, subsequent downloaded tiles
@@ -72,6 +93,17 @@ namespace carto {
          */
         void stopAllDownloads();
 
+        /**
+         * Starts background compaction of the cache database.
+         * Compaction verifies the integrity of the cached tiles and drops corrupt entries,
+         * trims the cache down to the configured capacity and releases unused pages
+         * back to the file system. Long-lived caches can otherwise grow well past their
+         * useful content. The compaction runs on a background thread and can be stopped
+         * via stopAllDownloads.
+         * @param compactionListener The listener to use that will receive compaction progress callbacks. Can be null.
+         */
+        void startCompaction(const std::shared_ptr<CompactionListener>& compactionListener);
+
         /**
          * Returns the status of the cache database.
          * @return True if the persistent cache database is open and working, false otherwise.
@@ -84,6 +116,14 @@ namespace carto {
          */
         void close();
 
+        /**
+         * Commits any batched tile writes to the cache database.
+         * Tile stores are grouped into larger transactions for performance.
+         * Call this when the application is put into the background to make sure
+         * all cached tiles are persisted.
+         */
+        void flush();
+
         virtual std::shared_ptr<TileData> loadTile(const MapTile& mapTile);
         
         virtual void clear();
@@ -92,6 +132,8 @@ namespace carto {
 
         virtual void setCapacity(std::size_t capacityInBytes);
 
+        virtual CacheStats getCacheStats() const;
+
     protected:
         class DownloadTask : public CancelableTask {
         public:
@@ -107,23 +149,65 @@ namespace carto {
             DirectorPtr<TileDownloadListener> _downloadListener;
         };
 
+        class CompactTask : public CancelableTask {
+        public:
+            CompactTask(const std::shared_ptr<PersistentCacheTileDataSource>& dataSource, const std::shared_ptr<CompactionListener>& listener);
+
+            virtual void run();
+
+        private:
+            std::weak_ptr<PersistentCacheTileDataSource> _dataSource;
+            DirectorPtr<CompactionListener> _compactionListener;
+        };
+
         static const int DEFAULT_CAPACITY = 50 * 1024 * 1024;
 
+        static const int VACUUM_PAGE_CHUNK = 256;
+
+        static const int MAX_PENDING_STORES = 16;
+        static const int MAX_COMMIT_INTERVAL_MS = 1000;
+
+        static const int DICTIONARY_SAMPLE_COUNT = 16;
+        static const int DICTIONARY_SAMPLE_SIZE = 2 * 1024;
+
+        static const int BLOB_ENCODING_DEFAULT = 0;
+        static const int BLOB_ENCODING_DICTIONARY_DEFLATE = 1;
+
+        virtual void storeRefreshedTile(const MapTile& mapTile, const std::shared_ptr<TileData>& tileData);
+
+        virtual void removeTileFromCache(long long tileId);
+
         void openDatabase(const std::string& databasePath);
         void closeDatabase();
         void loadTileInfo();
+        void loadDictionary();
+        void updateDictionary(const std::vector<unsigned char>& data);
 
         void downloadArea(const MapBounds& mapBounds, int minZoom, int maxZoom, const std::shared_ptr<TileDownloadListener>& listener);
         
         std::shared_ptr<TileData> get(long long tileId);
         void store(long long tileId, const std::shared_ptr<TileData>& tileData);
         void remove(long long tileId);
+        void commitPendingStores();
+        bool verifyTile(long long tileId);
 
         std::shared_ptr<long long> createTileId(long long tileId);
         
         std::unique_ptr<sqlite3pp::database> _database;
-        
+        int _pendingStores;
+        long long _cacheHitCount;
+        long long _cacheMissCount;
+        long long _cacheInsertCount;
+        long long _cacheRemoveCount;
+        long long _loadCount;
+        double _loadTimeSum;
+        std::chrono::steady_clock::time_point _lastCommitTime;
+
+        std::vector<unsigned char> _dictionary;
+        std::vector<std::vector<unsigned char> > _dictionarySamples;
+
         bool _cacheOnlyMode;
+        long long _maxStaleness;
 
         std::shared_ptr<CancelableThreadPool> _downloadThreadPool;
         
@@ -40,6 +40,17 @@ namespace carto {
         }
     }
         
+    void TileDataSource::notifyTilesChanged(const MapBounds& mapBounds, int minZoom, int maxZoom) {
+        std::vector<std::shared_ptr<OnChangeListener> > onChangeListeners;
+        {
+            std::lock_guard<std::mutex> lock(_onChangeListenersMutex);
+            onChangeListeners = _onChangeListeners;
+        }
+        for (const std::shared_ptr<OnChangeListener>& listener : onChangeListeners) {
+            listener->onTilesChanged(mapBounds, minZoom, maxZoom);
+        }
+    }
+        
     void TileDataSource::registerOnChangeListener(const std::shared_ptr<OnChangeListener>& listener) {
         std::lock_guard<std::mutex> lock(_onChangeListenersMutex);
         _onChangeListeners.push_back(listener);
@@ -38,6 +38,15 @@ namespace carto {
              * @param removeTiles The remove tiles flag.
              */
             virtual void onTilesChanged(bool removeTiles) = 0;
+
+            /**
+             * Listener method that gets called when tiles within a region have changed and need to be updated.
+             * The default implementation simply forwards the call to the unscoped onTilesChanged method.
+             * @param mapBounds The bounds of the changed region, in the coordinate system of the data source projection.
+             * @param minZoom The minimum zoom level of the changed tiles (inclusive).
+             * @param maxZoom The maximum zoom level of the changed tiles (inclusive).
+             */
+            virtual void onTilesChanged(const MapBounds& mapBounds, int minZoom, int maxZoom) { onTilesChanged(false); }
         };
         
         virtual ~TileDataSource();
@@ -81,6 +90,16 @@ namespace carto {
          * @param removeTiles The remove tiles flag.
          */
         virtual void notifyTilesChanged(bool removeTiles);
+
+        /**
+         * Notifies listeners that tiles within the specified region have changed.
+         * Unlike the unscoped notifyTilesChanged, only tiles intersecting the region are reloaded
+         * and other tiles are kept, avoiding a full refresh.
+         * @param mapBounds The bounds of the changed region, in the coordinate system of the data source projection.
+         * @param minZoom The minimum zoom level of the changed tiles (inclusive).
+         * @param maxZoom The maximum zoom level of the changed tiles (inclusive).
+         */
+        virtual void notifyTilesChanged(const MapBounds& mapBounds, int minZoom, int maxZoom);
     
         /**
          * Registers listener for data source change events.
@@ -0,0 +1,68 @@
+#include "CacheStats.h"
+
+#include <sstream>
+
+namespace carto {
+
+    CacheStats::CacheStats() :
+        _hitCount(0),
+        _missCount(0),
+        _evictionCount(0),
+        _elementCount(0),
+        _capacityInBytes(0),
+        _meanLoadLatency(0.0f)
+    {
+    }
+
+    CacheStats::CacheStats(long long hitCount, long long missCount, long long evictionCount, std::size_t elementCount, std::size_t capacityInBytes, float meanLoadLatency) :
+        _hitCount(hitCount),
+        _missCount(missCount),
+        _evictionCount(evictionCount),
+        _elementCount(elementCount),
+        _capacityInBytes(capacityInBytes),
+        _meanLoadLatency(meanLoadLatency)
+    {
+    }
+
+    long long CacheStats::getHitCount() const {
+        return _hitCount;
+    }
+
+    long long CacheStats::getMissCount() const {
+        return _missCount;
+    }
+
+    long long CacheStats::getEvictionCount() const {
+        return _evictionCount;
+    }
+
+    std::size_t CacheStats::getElementCount() const {
+        return _elementCount;
+    }
+
+    std::size_t CacheStats::getCapacityInBytes() const {
+        return _capacityInBytes;
+    }
+
+    float CacheStats::getMeanLoadLatency() const {
+        return _meanLoadLatency;
+    }
+
+    bool CacheStats::operator ==(const CacheStats& cacheStats) const {
+        return _hitCount == cacheStats._hitCount && _missCount == cacheStats._missCount
+            && _evictionCount == cacheStats._evictionCount && _elementCount == cacheStats._elementCount
+            && _capacityInBytes == cacheStats._capacityInBytes && _meanLoadLatency == cacheStats._meanLoadLatency;
+    }
+
+    bool CacheStats::operator !=(const CacheStats& cacheStats) const {
+        return !(*this == cacheStats);
+    }
+
+    std::string CacheStats::toString() const {
+        std::stringstream ss;
+        ss << "CacheStats [hits=" << _hitCount << ", misses=" << _missCount << ", evictions=" << _evictionCount
+           << ", elements=" << _elementCount << ", capacity=" << _capacityInBytes << ", meanLoadLatency=" << _meanLoadLatency << "]";
+        return ss.str();
+    }
+
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2016 CartoDB. All rights reserved.
+ * Copying and using this code is allowed only according
+ * to license terms, as given in https://cartodb.com/terms/
+ */
+
+#ifndef _CARTO_CACHESTATS_H_
+#define _CARTO_CACHESTATS_H_
+
+#include <cstddef>
+#include <string>
+
+namespace carto {
+
+    /**
+     * A container class that holds a snapshot of tile cache usage counters.
+     * The counters are cumulative since the creation of the cache data source.
+     */
+    class CacheStats {
+    public:
+        /**
+         * Constructs an empty CacheStats object. All counters will be zero.
+         */
+        CacheStats();
+        /**
+         * Constructs a CacheStats object from usage counters.
+         * @param hitCount The number of tile requests served from the cache.
+         * @param missCount The number of tile requests forwarded to the original data source.
+         * @param evictionCount The number of tiles dropped from the cache due to capacity limits or expiration.
+         * @param elementCount The current number of tiles in the cache.
+         * @param capacityInBytes The capacity of the cache in bytes.
+         * @param meanLoadLatency The mean duration of the original data source loads in seconds.
+         */
+        CacheStats(long long hitCount, long long missCount, long long evictionCount, std::size_t elementCount, std::size_t capacityInBytes, float meanLoadLatency);
+
+        /**
+         * Returns the number of tile requests that were served from the cache.
+         * @return The number of cache hits.
+         */
+        long long getHitCount() const;
+        /**
+         * Returns the number of tile requests that were forwarded to the original data source.
+         * @return The number of cache misses.
+         */
+        long long getMissCount() const;
+        /**
+         * Returns the number of tiles dropped from the cache due to capacity limits or expiration.
+         * @return The number of cache evictions.
+         */
+        long long getEvictionCount() const;
+        /**
+         * Returns the current number of tiles in the cache.
+         * @return The number of cached tiles.
+         */
+        std::size_t getElementCount() const;
+        /**
+         * Returns the capacity of the cache.
+         * @return The capacity of the cache in bytes.
+         */
+        std::size_t getCapacityInBytes() const;
+        /**
+         * Returns the mean duration of the original data source loads.
+         * @return The mean load duration in seconds.
+         */
+        float getMeanLoadLatency() const;
+
+        /**
+         * Checks for equality between this and another cache stats object.
+         * @param cacheStats The other cache stats object.
+         * @return True if equal.
+         */
+        bool operator ==(const CacheStats& cacheStats) const;
+        /**
+         * Checks for inequality between this and another cache stats object.
+         * @param cacheStats The other cache stats object.
+         * @return True if not equal.
+         */
+        bool operator !=(const CacheStats& cacheStats) const;
+
+        /**
+         * Creates a string representation of this cache stats object, useful for logging.
+         * @return The string representation of this cache stats object.
+         */
+        std::string toString() const;
+
+    private:
+        long long _hitCount;
+        long long _missCount;
+        long long _evictionCount;
+        std::size_t _elementCount;
+        std::size_t _capacityInBytes;
+        float _meanLoadLatency;
+    };
+
+}
+
+#endif
@@ -1,14 +1,17 @@
 #include "TileData.h"
 #include "core/BinaryData.h"
+#include "utils/MemoryStats.h"
 
 namespace carto {
-    
+
     TileData::TileData(const std::shared_ptr<BinaryData>& data) :
-        _data(data), _expirationTime(), _replaceWithParent(false), _mutex()
+        _data(data), _expirationTime(), _replaceWithParent(false), _errorCode(0), _mutex()
     {
+        MemoryStats::Allocated(MemoryStats::SUBSYSTEM_TILE_CACHE, _data ? _data->size() : 0);
     }
 
     TileData::~TileData() {
+        MemoryStats::Freed(MemoryStats::SUBSYSTEM_TILE_CACHE, _data ? _data->size() : 0);
     }
 
     long long TileData::getMaxAge() const {
@@ -42,6 +45,16 @@ namespace carto {
         _replaceWithParent = flag;
     }
     
+    int TileData::getErrorCode() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _errorCode;
+    }
+
+    void TileData::setErrorCode(int errorCode) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _errorCode = errorCode;
+    }
+
     const std::shared_ptr<BinaryData>& TileData::getData() const {
         return _data;
     }
@@ -49,16 +49,28 @@ namespace carto {
          */
         void setReplaceWithParent(bool flag);
         
+        /**
+         * Returns the error code of the tile load attempt.
+         * @return The HTTP status code of a failed load attempt (for example 404 or 503), -1 for network-level failures, or 0 if the tile was loaded successfully.
+         */
+        int getErrorCode() const;
+        /**
+         * Sets the error code of the tile load attempt.
+         * @param errorCode The HTTP status code of a failed load attempt, -1 for network-level failures, or 0 if the tile was loaded successfully.
+         */
+        void setErrorCode(int errorCode);
+
         /**
          * Returns tile data as binary data.
          * @return Tile data as binary data.
          */
         const std::shared_ptr<BinaryData>& getData() const;
-        
+
     private:
         const std::shared_ptr<BinaryData> _data;
         std::shared_ptr<std::chrono::steady_clock::time_point> _expirationTime;
         bool _replaceWithParent;
+        int _errorCode;
         mutable std::mutex _mutex;
     };
 
@@ -16,8 +16,11 @@
 #include <geocoding/Geocoder.h>
 #include <geocoding/RevGeocoder.h>
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <functional>
+#include <utility>
 
 namespace {
 
@@ -26,6 +29,23 @@ namespace {
         template <typename T> carto::Variant operator() (T val) const { return carto::Variant(val); }
     };
 
+    std::uint32_t CalculateHilbertIndex(std::uint32_t x, std::uint32_t y) {
+        std::uint32_t d = 0;
+        for (std::uint32_t s = 1 << 15; s > 0; s >>= 1) {
+            std::uint32_t rx = (x & s) != 0 ? 1 : 0;
+            std::uint32_t ry = (y & s) != 0 ? 1 : 0;
+            d += s * s * ((3 * rx) ^ ry);
+            if (ry == 0) {
+                if (rx == 1) {
+                    x = s - 1 - x;
+                    y = s - 1 - y;
+                }
+                std::swap(x, y);
+            }
+        }
+        return d;
+    }
+
 }
 
 namespace carto {
@@ -51,6 +71,7 @@ namespace carto {
         std::vector<std::pair<geocoding::Address, float> > addrs = geocoder->findAddresses(request->getQuery(), options);
 
         std::vector<std::shared_ptr<GeocodingResult> > results;
+        results.reserve(addrs.size());
         for (const std::pair<geocoding::Address, float>& addr : addrs) {
             results.push_back(TranslateAddress(request->getProjection(), addr.first, addr.second));
         }
@@ -62,19 +83,45 @@ namespace carto {
         std::vector<std::pair<geocoding::Address, float> > addrs = revGeocoder->findAddresses(posWgs84.getX(), posWgs84.getY(), request->getSearchRadius());
 
         std::vector<std::shared_ptr<GeocodingResult> > results;
+        results.reserve(addrs.size());
         for (const std::pair<geocoding::Address, float>& addr : addrs) {
             results.push_back(TranslateAddress(request->getProjection(), addr.first, addr.second));
         }
         return results;
     }
 
+    std::vector<std::size_t> GeocodingProxy::CalculateBatchOrder(const std::vector<std::shared_ptr<ReverseGeocodingRequest> >& requests) {
+        // Map the request locations to a 16-bit grid and order them along the Hilbert curve.
+        // Processing a batch in this order keeps consecutive index and database accesses
+        // spatially local, so the geocoder page caches are amortized over each cluster.
+        std::vector<std::pair<std::uint32_t, std::size_t> > order;
+        order.reserve(requests.size());
+        for (std::size_t i = 0; i < requests.size(); i++) {
+            MapPos posWgs84 = requests[i]->getProjection()->toWgs84(requests[i]->getLocation());
+            double u = std::max(0.0, std::min(1.0, (posWgs84.getX() + 180.0) / 360.0));
+            double v = std::max(0.0, std::min(1.0, (posWgs84.getY() + 90.0) / 180.0));
+            std::uint32_t x = static_cast<std::uint32_t>(u * 65535.0);
+            std::uint32_t y = static_cast<std::uint32_t>(v * 65535.0);
+            order.emplace_back(CalculateHilbertIndex(x, y), i);
+        }
+        std::sort(order.begin(), order.end());
+
+        std::vector<std::size_t> indices;
+        indices.reserve(order.size());
+        for (const std::pair<std::uint32_t, std::size_t>& item : order) {
+            indices.push_back(item.second);
+        }
+        return indices;
+    }
+
     GeocodingProxy::GeocodingProxy() {
     }
 
     std::shared_ptr<GeocodingResult> GeocodingProxy::TranslateAddress(const std::shared_ptr<Projection>& proj, const geocoding::Address& addr, float rank) {
         std::vector<std::shared_ptr<Feature> > features;
+        features.reserve(addr.features.size());
         std::transform(addr.features.begin(), addr.features.end(), std::back_inserter(features), std::bind(&GeocodingProxy::TranslateFeature, proj, std::placeholders::_1));
-        auto featureCollection = std::make_shared<FeatureCollection>(features);
+        auto featureCollection = std::make_shared<FeatureCollection>(std::move(features));
         std::vector<std::string> categories(addr.categories.begin(), addr.categories.end());
         Address address(addr.country, addr.region, addr.county, addr.locality, addr.neighbourhood, addr.street, addr.postcode, addr.houseNumber, addr.name, categories);
         return std::make_shared<GeocodingResult>(proj, address, rank, featureCollection);
@@ -34,6 +34,8 @@ namespace carto {
 
         static std::vector<std::shared_ptr<GeocodingResult> > CalculateAddresses(const std::shared_ptr<geocoding::RevGeocoder>& revGeocoder, const std::shared_ptr<ReverseGeocodingRequest>& request);
 
+        static std::vector<std::size_t> CalculateBatchOrder(const std::vector<std::shared_ptr<ReverseGeocodingRequest> >& requests);
+
     private:
         GeocodingProxy();
 
@@ -1,6 +1,11 @@
 #ifdef _CARTO_GEOCODING_SUPPORT
 
 #include "GeocodingService.h"
+#include "components/Exceptions.h"
+#include "geocoding/GeocodingSession.h"
+#include "utils/Log.h"
+
+#include <thread>
 
 namespace carto {
 
@@ -10,6 +15,51 @@ namespace carto {
     GeocodingService::~GeocodingService() {
     }
 
+    std::vector<std::shared_ptr<GeocodingResult> > GeocodingService::calculateAddresses(const std::shared_ptr<GeocodingRequest>& request, const std::shared_ptr<GeocodingSession>& session) const {
+        if (!request) {
+            throw NullArgumentException("Null request");
+        }
+
+        if (!session) {
+            return calculateAddresses(request);
+        }
+
+        std::vector<std::shared_ptr<GeocodingResult> > results;
+        if (session->findCachedResults(request, results)) {
+            return results;
+        }
+
+        // If the query extends an already cached query, serve the locally re-filtered
+        // results of the shorter query instantly and refresh the query in the background
+        if (session->findSpeculativeResults(request, results)) {
+            refreshAddressesInBackground(request, session);
+            return results;
+        }
+
+        results = calculateAddresses(request);
+        session->cacheResults(request, results);
+        return results;
+    }
+
+    void GeocodingService::refreshAddressesInBackground(const std::shared_ptr<GeocodingRequest>& request, const std::shared_ptr<GeocodingSession>& session) const {
+        long long refreshId = session->beginRefresh(request);
+        if (refreshId == -1) {
+            return; // a refresh for the same request is already pending
+        }
+
+        std::shared_ptr<const GeocodingService> service = shared_from_this();
+        std::thread refreshThread([service, session, request, refreshId]() {
+            try {
+                std::vector<std::shared_ptr<GeocodingResult> > results = service->calculateAddresses(request);
+                session->commitRefresh(refreshId, request, results);
+            } catch (const std::exception& ex) {
+                session->cancelRefresh(refreshId);
+                Log::Errorf("GeocodingService::refreshAddressesInBackground: Failed to refresh results: %s", ex.what());
+            }
+        });
+        refreshThread.detach();
+    }
+
 }
 
 #endif
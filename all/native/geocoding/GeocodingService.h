@@ -16,11 +16,12 @@
 #include <vector>
 
 namespace carto {
+    class GeocodingSession;
 
     /**
      * An abstract base class for geocoding services.
      */
-    class GeocodingService {
+    class GeocodingService : public std::enable_shared_from_this<GeocodingService> {
     public:
         virtual ~GeocodingService();
 
@@ -32,11 +33,29 @@ namespace carto {
          */
         virtual std::vector<std::shared_ptr<GeocodingResult> > calculateAddresses(const std::shared_ptr<GeocodingRequest>& request) const = 0;
 
+        /**
+         * Calculates matching addresses from the specified geocoding request using a geocoding session.
+         * The session keeps the state of incremental search-as-you-type queries warm: results of
+         * recently evaluated queries are reused and refinements of queries without matches are skipped.
+         * When the query extends an already evaluated query, the cached results are re-filtered and
+         * re-ranked locally and returned without waiting for the service, while the query itself is
+         * refreshed from the service in the background for subsequent calls.
+         * The session assumes autocomplete (prefix search) semantics and should be used together
+         * with services that have the autocomplete flag set.
+         * @param request The geocoding request to use.
+         * @param session The geocoding session to use. Can be null, in which case the request is evaluated directly.
+         * @result The list of matching geocoding results, sorted by descending ranks.
+         * @throws std::runtime_error If IO error occured during the calculation.
+         */
+        virtual std::vector<std::shared_ptr<GeocodingResult> > calculateAddresses(const std::shared_ptr<GeocodingRequest>& request, const std::shared_ptr<GeocodingSession>& session) const;
+
     protected:
         /**
          * The default constructor.
          */
         GeocodingService();
+
+        void refreshAddressesInBackground(const std::shared_ptr<GeocodingRequest>& request, const std::shared_ptr<GeocodingSession>& session) const;
     };
     
 }
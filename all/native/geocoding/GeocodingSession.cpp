@@ -0,0 +1,249 @@
+#ifdef _CARTO_GEOCODING_SUPPORT
+
+#include "GeocodingSession.h"
+#include "projections/Projection.h"
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+#include <utility>
+
+namespace carto {
+
+    GeocodingSession::GeocodingSession() :
+        _capacity(DEFAULT_CAPACITY),
+        _cacheEntries(),
+        _refreshGeneration(0),
+        _pendingRefreshId(-1),
+        _pendingRefreshQuery(),
+        _pendingRefreshConstraintsKey(),
+        _mutex()
+    {
+    }
+
+    GeocodingSession::~GeocodingSession() {
+    }
+
+    std::size_t GeocodingSession::getCapacity() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _capacity;
+    }
+
+    void GeocodingSession::setCapacity(std::size_t capacity) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _capacity = capacity;
+        while (_cacheEntries.size() > _capacity) {
+            _cacheEntries.pop_back();
+        }
+    }
+
+    void GeocodingSession::clear() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _cacheEntries.clear();
+        _refreshGeneration++;
+        _pendingRefreshId = -1;
+    }
+
+    bool GeocodingSession::findCachedResults(const std::shared_ptr<GeocodingRequest>& request, std::vector<std::shared_ptr<GeocodingResult> >& results) const {
+        std::string query = request->getQuery();
+        std::string constraintsKey = BuildConstraintsKey(request);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto it = _cacheEntries.begin(); it != _cacheEntries.end(); it++) {
+            if (it->constraintsKey != constraintsKey) {
+                continue;
+            }
+            if (it->query == query) {
+                results = it->results;
+                _cacheEntries.splice(_cacheEntries.begin(), _cacheEntries, it);
+                return true;
+            }
+            // With prefix search semantics, extending a query without matches can not produce matches
+            if (it->results.empty() && !it->query.empty() && query.compare(0, it->query.size(), it->query) == 0) {
+                results.clear();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool GeocodingSession::findSpeculativeResults(const std::shared_ptr<GeocodingRequest>& request, std::vector<std::shared_ptr<GeocodingResult> >& results) const {
+        std::string query = request->getQuery();
+        std::string constraintsKey = BuildConstraintsKey(request);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // Find the cached entry with the longest query the current query extends
+        const CacheEntry* bestEntry = nullptr;
+        for (auto it = _cacheEntries.begin(); it != _cacheEntries.end(); it++) {
+            if (it->constraintsKey != constraintsKey || it->results.empty()) {
+                continue;
+            }
+            if (it->query.size() >= query.size() || query.compare(0, it->query.size(), it->query) != 0) {
+                continue;
+            }
+            if (!bestEntry || it->query.size() > bestEntry->query.size()) {
+                bestEntry = &*it;
+            }
+        }
+        if (!bestEntry) {
+            return false;
+        }
+
+        // If the local filter drops everything, fall back to evaluating the query directly,
+        // as the extended query may still match results outside of the cached set
+        results = FilterResults(bestEntry->results, query);
+        return !results.empty();
+    }
+
+    void GeocodingSession::cacheResults(const std::shared_ptr<GeocodingRequest>& request, const std::vector<std::shared_ptr<GeocodingResult> >& results) {
+        std::string query = request->getQuery();
+        std::string constraintsKey = BuildConstraintsKey(request);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _refreshGeneration++; // directly evaluated queries supersede pending refreshes of abandoned queries
+        storeResults(query, constraintsKey, results);
+    }
+
+    long long GeocodingSession::beginRefresh(const std::shared_ptr<GeocodingRequest>& request) {
+        std::string query = request->getQuery();
+        std::string constraintsKey = BuildConstraintsKey(request);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_pendingRefreshId != -1 && _pendingRefreshQuery == query && _pendingRefreshConstraintsKey == constraintsKey) {
+            return -1;
+        }
+        _refreshGeneration++;
+        _pendingRefreshId = _refreshGeneration;
+        _pendingRefreshQuery = query;
+        _pendingRefreshConstraintsKey = constraintsKey;
+        return _pendingRefreshId;
+    }
+
+    void GeocodingSession::commitRefresh(long long refreshId, const std::shared_ptr<GeocodingRequest>& request, const std::vector<std::shared_ptr<GeocodingResult> >& results) {
+        std::string query = request->getQuery();
+        std::string constraintsKey = BuildConstraintsKey(request);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (refreshId == _pendingRefreshId) {
+            _pendingRefreshId = -1;
+        }
+        if (refreshId != _refreshGeneration) {
+            return; // the query was abandoned while the refresh was in flight, drop the stale results
+        }
+        storeResults(query, constraintsKey, results);
+    }
+
+    void GeocodingSession::cancelRefresh(long long refreshId) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (refreshId == _pendingRefreshId) {
+            _pendingRefreshId = -1;
+        }
+    }
+
+    void GeocodingSession::storeResults(const std::string& query, const std::string& constraintsKey, const std::vector<std::shared_ptr<GeocodingResult> >& results) {
+        // Note: must be called with the mutex locked
+        for (auto it = _cacheEntries.begin(); it != _cacheEntries.end(); it++) {
+            if (it->query == query && it->constraintsKey == constraintsKey) {
+                it->results = results;
+                _cacheEntries.splice(_cacheEntries.begin(), _cacheEntries, it);
+                return;
+            }
+        }
+        _cacheEntries.push_front(CacheEntry { query, constraintsKey, results });
+        while (_cacheEntries.size() > _capacity) {
+            _cacheEntries.pop_back();
+        }
+    }
+
+    std::vector<std::shared_ptr<GeocodingResult> > GeocodingSession::FilterResults(const std::vector<std::shared_ptr<GeocodingResult> >& results, const std::string& query) {
+        std::vector<std::string> queryTokens = TokenizeString(query);
+
+        // Keep the results where every query token is a prefix of some address token.
+        // Results where more query tokens match complete address tokens are ranked first,
+        // results with equal scores keep their original rank-based order.
+        std::vector<std::pair<int, std::shared_ptr<GeocodingResult> > > scoredResults;
+        for (const std::shared_ptr<GeocodingResult>& result : results) {
+            std::vector<std::string> addressTokens = TokenizeAddress(result->getAddress());
+            int score = 0;
+            bool match = true;
+            for (const std::string& queryToken : queryTokens) {
+                bool tokenMatch = false;
+                for (const std::string& addressToken : addressTokens) {
+                    if (addressToken.compare(0, queryToken.size(), queryToken) == 0) {
+                        tokenMatch = true;
+                        if (addressToken.size() == queryToken.size()) {
+                            score++;
+                            break;
+                        }
+                    }
+                }
+                if (!tokenMatch) {
+                    match = false;
+                    break;
+                }
+            }
+            if (match) {
+                scoredResults.emplace_back(score, result);
+            }
+        }
+        std::stable_sort(scoredResults.begin(), scoredResults.end(), [](const std::pair<int, std::shared_ptr<GeocodingResult> >& scoredResult1, const std::pair<int, std::shared_ptr<GeocodingResult> >& scoredResult2) {
+            return scoredResult1.first > scoredResult2.first;
+        });
+
+        std::vector<std::shared_ptr<GeocodingResult> > filteredResults;
+        filteredResults.reserve(scoredResults.size());
+        for (const std::pair<int, std::shared_ptr<GeocodingResult> >& scoredResult : scoredResults) {
+            filteredResults.push_back(scoredResult.second);
+        }
+        return filteredResults;
+    }
+
+    std::vector<std::string> GeocodingSession::TokenizeString(const std::string& str) {
+        std::vector<std::string> tokens;
+        std::string token;
+        for (char c : str) {
+            unsigned char uc = static_cast<unsigned char>(c);
+            if (uc > 127 || std::isalnum(uc)) {
+                token += static_cast<char>(uc > 127 ? uc : std::tolower(uc));
+            } else if (!token.empty()) {
+                tokens.push_back(token);
+                token.clear();
+            }
+        }
+        if (!token.empty()) {
+            tokens.push_back(token);
+        }
+        return tokens;
+    }
+
+    std::vector<std::string> GeocodingSession::TokenizeAddress(const Address& address) {
+        const std::string* fields[] = {
+            &address.getName(), &address.getHouseNumber(), &address.getStreet(),
+            &address.getNeighbourhood(), &address.getLocality(), &address.getCounty(),
+            &address.getRegion(), &address.getCountry(), &address.getPostcode()
+        };
+        std::vector<std::string> tokens;
+        for (const std::string* field : fields) {
+            if (!field->empty()) {
+                std::vector<std::string> fieldTokens = TokenizeString(*field);
+                tokens.insert(tokens.end(), fieldTokens.begin(), fieldTokens.end());
+            }
+        }
+        return tokens;
+    }
+
+    std::string GeocodingSession::BuildConstraintsKey(const std::shared_ptr<GeocodingRequest>& request) {
+        std::stringstream ss;
+        ss << request->getProjection()->getName();
+        if (request->isLocationDefined()) {
+            MapPos location = request->getLocation();
+            ss << "," << location.getX() << "," << location.getY();
+        }
+        ss << "," << request->getLocationRadius();
+        return ss.str();
+    }
+
+}
+
+#endif
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2016 CartoDB. All rights reserved.
+ * Copying and using this code is allowed only according
+ * to license terms, as given in https://cartodb.com/terms/
+ */
+
+#ifndef _CARTO_GEOCODINGSESSION_H_
+#define _CARTO_GEOCODINGSESSION_H_
+
+#ifdef _CARTO_GEOCODING_SUPPORT
+
+#include "geocoding/GeocodingRequest.h"
+#include "geocoding/GeocodingResult.h"
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace carto {
+
+    /**
+     * A geocoding session that keeps the state of incremental search-as-you-type queries warm.
+     * A session caches the results of recently evaluated queries, so repeated queries within
+     * the session (oscillating keystrokes, backspacing) are served from the cache. The session
+     * assumes autocomplete (prefix search) semantics: once a query has returned no results,
+     * queries extending it are assumed to return no results as well and are not evaluated.
+     * When a query extends an already cached query, the cached results are re-filtered and
+     * re-ranked locally and served instantly, while the extended query is refreshed from the
+     * service in the background. Background refreshes of abandoned queries are dropped.
+     * Note: this class is experimental and may change or even be removed in future SDK versions.
+     */
+    class GeocodingSession {
+    public:
+        /**
+         * Constructs a new GeocodingSession object with empty state.
+         */
+        GeocodingSession();
+        virtual ~GeocodingSession();
+
+        /**
+         * Returns the maximum number of queries the session keeps cached.
+         * @return The maximum number of queries the session keeps cached.
+         */
+        std::size_t getCapacity() const;
+        /**
+         * Sets the maximum number of queries the session keeps cached.
+         * @param capacity The new maximum number of cached queries. The default is 32.
+         */
+        void setCapacity(std::size_t capacity);
+
+        /**
+         * Clears the cached state of the session. This method should be called
+         * when the search input is reset.
+         */
+        void clear();
+
+        bool findCachedResults(const std::shared_ptr<GeocodingRequest>& request, std::vector<std::shared_ptr<GeocodingResult> >& results) const;
+
+        bool findSpeculativeResults(const std::shared_ptr<GeocodingRequest>& request, std::vector<std::shared_ptr<GeocodingResult> >& results) const;
+
+        void cacheResults(const std::shared_ptr<GeocodingRequest>& request, const std::vector<std::shared_ptr<GeocodingResult> >& results);
+
+        long long beginRefresh(const std::shared_ptr<GeocodingRequest>& request);
+
+        void commitRefresh(long long refreshId, const std::shared_ptr<GeocodingRequest>& request, const std::vector<std::shared_ptr<GeocodingResult> >& results);
+
+        void cancelRefresh(long long refreshId);
+
+    private:
+        struct CacheEntry {
+            std::string query;
+            std::string constraintsKey;
+            std::vector<std::shared_ptr<GeocodingResult> > results;
+        };
+
+        void storeResults(const std::string& query, const std::string& constraintsKey, const std::vector<std::shared_ptr<GeocodingResult> >& results);
+
+        static std::string BuildConstraintsKey(const std::shared_ptr<GeocodingRequest>& request);
+        static std::vector<std::shared_ptr<GeocodingResult> > FilterResults(const std::vector<std::shared_ptr<GeocodingResult> >& results, const std::string& query);
+        static std::vector<std::string> TokenizeString(const std::string& str);
+        static std::vector<std::string> TokenizeAddress(const Address& address);
+
+        static const int DEFAULT_CAPACITY = 32;
+
+        std::size_t _capacity;
+        mutable std::list<CacheEntry> _cacheEntries;
+
+        long long _refreshGeneration;
+        long long _pendingRefreshId;
+        std::string _pendingRefreshQuery;
+        std::string _pendingRefreshConstraintsKey;
+
+        mutable std::mutex _mutex;
+    };
+
+}
+
+#endif
+
+#endif
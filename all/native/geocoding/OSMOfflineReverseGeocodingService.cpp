@@ -41,7 +41,23 @@ namespace carto {
 
         return GeocodingProxy::CalculateAddresses(_revGeocoder, request);
     }
-    
+
+    std::vector<std::vector<std::shared_ptr<GeocodingResult> > > OSMOfflineReverseGeocodingService::calculateAddressesBatch(const std::vector<std::shared_ptr<ReverseGeocodingRequest> >& requests) const {
+        for (const std::shared_ptr<ReverseGeocodingRequest>& request : requests) {
+            if (!request) {
+                throw NullArgumentException("Null request");
+            }
+        }
+
+        // Process the requests in Hilbert curve order, so that consecutive queries stay
+        // spatially close and each index descent is amortized over a whole cluster of points
+        std::vector<std::vector<std::shared_ptr<GeocodingResult> > > results(requests.size());
+        for (std::size_t index : GeocodingProxy::CalculateBatchOrder(requests)) {
+            results[index] = GeocodingProxy::CalculateAddresses(_revGeocoder, requests[index]);
+        }
+        return results;
+    }
+
 }
 
 #endif
@@ -43,6 +43,8 @@ namespace carto {
 
         virtual std::vector<std::shared_ptr<GeocodingResult> > calculateAddresses(const std::shared_ptr<ReverseGeocodingRequest>& request) const;
 
+        virtual std::vector<std::vector<std::shared_ptr<GeocodingResult> > > calculateAddressesBatch(const std::vector<std::shared_ptr<ReverseGeocodingRequest> >& requests) const;
+
     protected:
         std::shared_ptr<geocoding::RevGeocoder> _revGeocoder;
     };
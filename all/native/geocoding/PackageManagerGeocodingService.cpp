@@ -8,6 +8,10 @@
 
 #include <geocoding/Geocoder.h>
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 #include <sqlite3pp.h>
 
 namespace carto {
@@ -17,7 +21,8 @@ namespace carto {
         _autocomplete(false),
         _language(),
         _cachedPackageDatabaseMap(),
-        _cachedGeocoder(),
+        _cachedGeocoderMap(),
+        _emptyQueryPrefixMap(),
         _mutex()
     {
         if (!packageManager) {
@@ -42,7 +47,8 @@ namespace carto {
         std::lock_guard<std::mutex> lock(_mutex);
         if (autocomplete != _autocomplete) {
             _autocomplete = autocomplete;
-            _cachedGeocoder.reset();
+            _cachedGeocoderMap.clear();
+            _emptyQueryPrefixMap.clear();
         }
     }
 
@@ -55,7 +61,8 @@ namespace carto {
         std::lock_guard<std::mutex> lock(_mutex);
         if (lang != _language) {
             _language = lang;
-            _cachedGeocoder.reset();
+            _cachedGeocoderMap.clear();
+            _emptyQueryPrefixMap.clear();
         }
     }
 
@@ -64,7 +71,7 @@ namespace carto {
             throw NullArgumentException("Null request");
         }
 
-        // Do routing via package manager, so that all packages are locked during routing
+        // Do geocoding via package manager, so that all packages are locked during geocoding
         std::vector<std::shared_ptr<GeocodingResult> > results;
         _packageManager->accessLocalPackages([this, &results, &request](const std::map<std::shared_ptr<PackageInfo>, std::shared_ptr<PackageHandler> >& packageHandlerMap) {
             // Build map of geocoding databases
@@ -75,27 +82,120 @@ namespace carto {
                 }
             }
 
-            // Now check if we have to reinitialize the geocoder
-            std::lock_guard<std::mutex> lock(_mutex);
-            if (!_cachedGeocoder || packageDatabaseMap != _cachedPackageDatabaseMap) {
-                auto geocoder = std::make_shared<geocoding::Geocoder>();
-                geocoder->setAutocomplete(_autocomplete);
-                geocoder->setLanguage(_language);
+            // Now check if we have to reinitialize the geocoders. Note that each package gets
+            // a dedicated geocoder instance, so the packages can be queried in parallel.
+            bool autocomplete = false;
+            std::vector<std::pair<std::shared_ptr<PackageInfo>, std::shared_ptr<geocoding::Geocoder> > > packageGeocoders;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (packageDatabaseMap != _cachedPackageDatabaseMap) {
+                    _cachedPackageDatabaseMap = packageDatabaseMap;
+                    _cachedGeocoderMap.clear();
+                    _emptyQueryPrefixMap.clear();
+                }
                 for (auto it = packageDatabaseMap.begin(); it != packageDatabaseMap.end(); it++) {
-                    try {
-                        if (!geocoder->import(it->second)) {
-                            throw FileException("Failed to import geocoding database " + it->first->getPackageId(), "");
+                    std::shared_ptr<geocoding::Geocoder>& geocoder = _cachedGeocoderMap[it->first];
+                    if (!geocoder) {
+                        geocoder = std::make_shared<geocoding::Geocoder>();
+                        geocoder->setAutocomplete(_autocomplete);
+                        geocoder->setLanguage(_language);
+                        try {
+                            if (!geocoder->import(it->second)) {
+                                throw FileException("Failed to import geocoding database " + it->first->getPackageId(), "");
+                            }
+                        }
+                        catch (const std::exception& ex) {
+                            _cachedGeocoderMap.erase(it->first);
+                            throw GenericException("Exception while importing geocoding database " + it->first->getPackageId(), ex.what());
                         }
                     }
-                    catch (const std::exception& ex) {
-                        throw GenericException("Exception while importing geocoding database " + it->first->getPackageId(), ex.what());
+
+                    // With prefix search semantics, skip the packages that had no matches for a prefix of the query
+                    if (_autocomplete) {
+                        auto prefixIt = _emptyQueryPrefixMap.find(it->first);
+                        if (prefixIt != _emptyQueryPrefixMap.end()) {
+                            bool empty = std::any_of(prefixIt->second.begin(), prefixIt->second.end(), [&request](const std::string& prefix) {
+                                return request->getQuery().compare(0, prefix.size(), prefix) == 0;
+                            });
+                            if (empty) {
+                                continue;
+                            }
+                        }
                     }
+                    packageGeocoders.emplace_back(it->first, geocoder);
                 }
-                _cachedPackageDatabaseMap = packageDatabaseMap;
-                _cachedGeocoder = geocoder;
+                autocomplete = _autocomplete;
             }
 
-            results = GeocodingProxy::CalculateAddresses(_cachedGeocoder, request);
+            // Query the packages on parallel workers. Once enough high-confidence results have
+            // been collected, the remaining packages are skipped.
+            std::mutex resultsMutex;
+            std::atomic<std::size_t> packageIndex(0);
+            std::atomic<bool> finished(false);
+            std::exception_ptr exception;
+            std::vector<std::shared_ptr<PackageInfo> > emptyPackages;
+
+            std::size_t workerCount = std::min(packageGeocoders.size(), static_cast<std::size_t>(MAX_GEOCODING_WORKERS));
+            std::vector<std::thread> workers;
+            workers.reserve(workerCount);
+            for (std::size_t i = 0; i < workerCount; i++) {
+                workers.emplace_back([&]() {
+                    while (!finished) {
+                        std::size_t index = packageIndex++;
+                        if (index >= packageGeocoders.size()) {
+                            break;
+                        }
+
+                        std::vector<std::shared_ptr<GeocodingResult> > packageResults;
+                        try {
+                            packageResults = GeocodingProxy::CalculateAddresses(packageGeocoders[index].second, request);
+                        }
+                        catch (...) {
+                            std::lock_guard<std::mutex> lock(resultsMutex);
+                            if (!exception) {
+                                exception = std::current_exception();
+                            }
+                            finished = true;
+                            break;
+                        }
+
+                        std::lock_guard<std::mutex> lock(resultsMutex);
+                        if (packageResults.empty()) {
+                            emptyPackages.push_back(packageGeocoders[index].first);
+                        }
+                        results.insert(results.end(), packageResults.begin(), packageResults.end());
+                        std::size_t highConfidenceCount = std::count_if(results.begin(), results.end(), [](const std::shared_ptr<GeocodingResult>& result) {
+                            return result->getRank() >= HIGH_CONFIDENCE_RANK;
+                        });
+                        if (highConfidenceCount >= MIN_HIGH_CONFIDENCE_RESULTS) {
+                            finished = true;
+                        }
+                    }
+                });
+            }
+            for (std::thread& worker : workers) {
+                worker.join();
+            }
+
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+
+            // Remember the packages that had no matches, so that refinements of the query can skip them
+            if (autocomplete && !request->getQuery().empty()) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                for (const std::shared_ptr<PackageInfo>& packageInfo : emptyPackages) {
+                    std::vector<std::string>& prefixes = _emptyQueryPrefixMap[packageInfo];
+                    prefixes.push_back(request->getQuery());
+                    if (prefixes.size() > MAX_EMPTY_QUERY_PREFIXES) {
+                        prefixes.erase(prefixes.begin());
+                    }
+                }
+            }
+
+            std::stable_sort(results.begin(), results.end(), [](const std::shared_ptr<GeocodingResult>& result1, const std::shared_ptr<GeocodingResult>& result2) {
+                return result1->getRank() > result2->getRank();
+            });
         });
         return results;
     }
@@ -108,13 +208,16 @@ namespace carto {
     void PackageManagerGeocodingService::PackageManagerListener::onPackagesChanged() {
         std::lock_guard<std::mutex> lock(_service._mutex);
         _service._cachedPackageDatabaseMap.clear();
-        _service._cachedGeocoder.reset();
+        _service._cachedGeocoderMap.clear();
+        _service._emptyQueryPrefixMap.clear();
     }
 
     void PackageManagerGeocodingService::PackageManagerListener::onStylesChanged() {
         // Impossible
     }
 
+    const float PackageManagerGeocodingService::HIGH_CONFIDENCE_RANK = 0.9f;
+
 }
 
 #endif
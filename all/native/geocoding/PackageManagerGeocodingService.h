@@ -70,12 +70,18 @@ namespace carto {
             PackageManagerGeocodingService& _service;
         };
 
+        static const int MAX_GEOCODING_WORKERS = 4;
+        static const int MIN_HIGH_CONFIDENCE_RESULTS = 10;
+        static const int MAX_EMPTY_QUERY_PREFIXES = 16;
+        static const float HIGH_CONFIDENCE_RANK;
+
         const std::shared_ptr<PackageManager> _packageManager;
         bool _autocomplete;
         std::string _language;
 
         mutable std::map<std::shared_ptr<PackageInfo>, std::shared_ptr<sqlite3pp::database> > _cachedPackageDatabaseMap;
-        mutable std::shared_ptr<geocoding::Geocoder> _cachedGeocoder;
+        mutable std::map<std::shared_ptr<PackageInfo>, std::shared_ptr<geocoding::Geocoder> > _cachedGeocoderMap;
+        mutable std::map<std::shared_ptr<PackageInfo>, std::vector<std::string> > _emptyQueryPrefixMap;
 
         mutable std::mutex _mutex;
 
@@ -53,38 +53,61 @@ namespace carto {
         // Do routing via package manager, so that all packages are locked during routing
         std::vector<std::shared_ptr<GeocodingResult> > results;
         _packageManager->accessLocalPackages([this, &results, &request](const std::map<std::shared_ptr<PackageInfo>, std::shared_ptr<PackageHandler> >& packageHandlerMap) {
-            // Build map of geocoding databases
-            std::map<std::shared_ptr<PackageInfo>, std::shared_ptr<sqlite3pp::database> > packageDatabaseMap;
-            for (auto it = packageHandlerMap.begin(); it != packageHandlerMap.end(); it++) {
-                if (auto geocodingHandler = std::dynamic_pointer_cast<GeocodingPackageHandler>(it->second)) {
-                    packageDatabaseMap[it->first] = geocodingHandler->getGeocodingDatabase();
-                }
-            }
+            results = GeocodingProxy::CalculateAddresses(getRevGeocoder(packageHandlerMap), request);
+        });
+        return results;
+    }
 
-            // Now check if we have to reinitialize the geocoder
-            std::lock_guard<std::mutex> lock(_mutex);
-            if (!_cachedRevGeocoder || packageDatabaseMap != _cachedPackageDatabaseMap) {
-                auto revGeocoder = std::make_shared<geocoding::RevGeocoder>();
-                revGeocoder->setLanguage(_language);
-                for (auto it = packageDatabaseMap.begin(); it != packageDatabaseMap.end(); it++) {
-                    try {
-                        if (!revGeocoder->import(it->second)) {
-                            throw FileException("Failed to import geocoding database " + it->first->getPackageId(), "");
-                        }
-                    }
-                    catch (const std::exception& ex) {
-                        throw GenericException("Exception while importing geocoding database " + it->first->getPackageId(), ex.what());
-                    }
-                }
-                _cachedPackageDatabaseMap = packageDatabaseMap;
-                _cachedRevGeocoder = revGeocoder;
+    std::vector<std::vector<std::shared_ptr<GeocodingResult> > > PackageManagerReverseGeocodingService::calculateAddressesBatch(const std::vector<std::shared_ptr<ReverseGeocodingRequest> >& requests) const {
+        for (const std::shared_ptr<ReverseGeocodingRequest>& request : requests) {
+            if (!request) {
+                throw NullArgumentException("Null request");
             }
+        }
 
-            results = GeocodingProxy::CalculateAddresses(_cachedRevGeocoder, request);
+        // Lock the packages and initialize the geocoder only once for the whole batch.
+        // The requests are processed in Hilbert curve order, so that consecutive queries
+        // stay spatially close and each index descent is amortized over a cluster of points.
+        std::vector<std::vector<std::shared_ptr<GeocodingResult> > > results(requests.size());
+        _packageManager->accessLocalPackages([this, &results, &requests](const std::map<std::shared_ptr<PackageInfo>, std::shared_ptr<PackageHandler> >& packageHandlerMap) {
+            std::shared_ptr<geocoding::RevGeocoder> revGeocoder = getRevGeocoder(packageHandlerMap);
+            for (std::size_t index : GeocodingProxy::CalculateBatchOrder(requests)) {
+                results[index] = GeocodingProxy::CalculateAddresses(revGeocoder, requests[index]);
+            }
         });
         return results;
     }
-    
+
+    std::shared_ptr<geocoding::RevGeocoder> PackageManagerReverseGeocodingService::getRevGeocoder(const std::map<std::shared_ptr<PackageInfo>, std::shared_ptr<PackageHandler> >& packageHandlerMap) const {
+        // Build map of geocoding databases
+        std::map<std::shared_ptr<PackageInfo>, std::shared_ptr<sqlite3pp::database> > packageDatabaseMap;
+        for (auto it = packageHandlerMap.begin(); it != packageHandlerMap.end(); it++) {
+            if (auto geocodingHandler = std::dynamic_pointer_cast<GeocodingPackageHandler>(it->second)) {
+                packageDatabaseMap[it->first] = geocodingHandler->getGeocodingDatabase();
+            }
+        }
+
+        // Now check if we have to reinitialize the geocoder
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_cachedRevGeocoder || packageDatabaseMap != _cachedPackageDatabaseMap) {
+            auto revGeocoder = std::make_shared<geocoding::RevGeocoder>();
+            revGeocoder->setLanguage(_language);
+            for (auto it = packageDatabaseMap.begin(); it != packageDatabaseMap.end(); it++) {
+                try {
+                    if (!revGeocoder->import(it->second)) {
+                        throw FileException("Failed to import geocoding database " + it->first->getPackageId(), "");
+                    }
+                }
+                catch (const std::exception& ex) {
+                    throw GenericException("Exception while importing geocoding database " + it->first->getPackageId(), ex.what());
+                }
+            }
+            _cachedPackageDatabaseMap = packageDatabaseMap;
+            _cachedRevGeocoder = revGeocoder;
+        }
+        return _cachedRevGeocoder;
+    }
+
     PackageManagerReverseGeocodingService::PackageManagerListener::PackageManagerListener(PackageManagerReverseGeocodingService& service) :
         _service(service)
     {
@@ -46,6 +46,8 @@ namespace carto {
 
         virtual std::vector<std::shared_ptr<GeocodingResult> > calculateAddresses(const std::shared_ptr<ReverseGeocodingRequest>& request) const;
 
+        virtual std::vector<std::vector<std::shared_ptr<GeocodingResult> > > calculateAddressesBatch(const std::vector<std::shared_ptr<ReverseGeocodingRequest> >& requests) const;
+
     protected:
         class PackageManagerListener : public PackageManager::OnChangeListener {
         public:
@@ -58,6 +60,8 @@ namespace carto {
             PackageManagerReverseGeocodingService& _service;
         };
 
+        std::shared_ptr<geocoding::RevGeocoder> getRevGeocoder(const std::map<std::shared_ptr<PackageInfo>, std::shared_ptr<PackageHandler> >& packageHandlerMap) const;
+
         const std::shared_ptr<PackageManager> _packageManager;
         std::string _language;
 
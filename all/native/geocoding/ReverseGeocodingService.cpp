@@ -7,6 +7,15 @@ namespace carto {
     ReverseGeocodingService::ReverseGeocodingService() {
     }
 
+    std::vector<std::vector<std::shared_ptr<GeocodingResult> > > ReverseGeocodingService::calculateAddressesBatch(const std::vector<std::shared_ptr<ReverseGeocodingRequest> >& requests) const {
+        std::vector<std::vector<std::shared_ptr<GeocodingResult> > > results;
+        results.reserve(requests.size());
+        for (const std::shared_ptr<ReverseGeocodingRequest>& request : requests) {
+            results.push_back(calculateAddresses(request));
+        }
+        return results;
+    }
+
     ReverseGeocodingService::~ReverseGeocodingService() {
     }
 
@@ -32,6 +32,17 @@ namespace carto {
          */
         virtual std::vector<std::shared_ptr<GeocodingResult> > calculateAddresses(const std::shared_ptr<ReverseGeocodingRequest>& request) const = 0;
 
+        /**
+         * Calculates matching addresses for a batch of reverse geocoding requests.
+         * The default implementation simply processes the requests one by one, but services
+         * backed by a local index reorder the requests spatially and amortize the index
+         * access cost, making this considerably faster than individual calls on bulk workloads.
+         * @param requests The list of reverse geocoding requests to use.
+         * @result The list of result lists, one per request, in the order of the requests.
+         * @throws std::runtime_error If IO error occured during the calculation.
+         */
+        virtual std::vector<std::vector<std::shared_ptr<GeocodingResult> > > calculateAddressesBatch(const std::vector<std::shared_ptr<ReverseGeocodingRequest> >& requests) const;
+
     protected:
         /**
          * The default constructor.
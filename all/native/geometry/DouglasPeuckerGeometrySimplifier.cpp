@@ -23,13 +23,22 @@ namespace carto {
         }
 
         void approximate(const MapPos* points, std::size_t pointCount, double minDist, unsigned char* keys) const {
+            // Project all points once. The distance loops can then work on packed
+            // coordinates without doing any projection math per span.
+            std::vector<cglib::vec3<double> > positions;
+            positions.reserve(pointCount);
+            for (std::size_t i = 0; i < pointCount; i++) {
+                positions.push_back(_projectionSurface->calculatePosition(_projection->toInternal(points[i])));
+            }
+
+            double minDistSqr = minDist * minDist;
             std::stack<SubPoly> stack;
             stack.push(SubPoly(0, pointCount - 1));
             while (!stack.empty()) {
                 SubPoly subPoly = stack.top();
                 stack.pop();
-                KeyInfo keyInfo = findKey(points, subPoly.first, subPoly.last);
-                if (keyInfo.index && minDist < keyInfo.dist) {
+                KeyInfo keyInfo = findKey(positions.data(), subPoly.first, subPoly.last);
+                if (keyInfo.index && minDistSqr < keyInfo.distSqr) {
                     keys[keyInfo.index] = 1;
                     stack.push(SubPoly(keyInfo.index, subPoly.last));
                     stack.push(SubPoly(subPoly.first, keyInfo.index));
@@ -46,43 +55,29 @@ namespace carto {
         };
 
         struct KeyInfo {
-            KeyInfo(std::size_t index = 0, double dist = 0) : index(index), dist(dist) { }
+            KeyInfo(std::size_t index = 0, double distSqr = 0) : index(index), distSqr(distSqr) { }
 
             std::size_t index;
-            double dist;
+            double distSqr;
         };
 
-        static double FindSegmentDistance(const cglib::vec3<double>& s1, const cglib::vec3<double>& s2, const cglib::vec3<double>& p) {
+        static KeyInfo findKey(const cglib::vec3<double>* positions, std::size_t first, std::size_t last) {
             // NOTE: not really correct on spherical surface but, but should still give reasonable results
-            cglib::vec3<double> v = (s2 - s1);
-            cglib::vec3<double> w = (p - s1);
-            double cw = cglib::dot_product(v, w);
-            if (cw <= 0) {
-                return cglib::length(p - s1);
-            }
-            double cv = cglib::norm(v);
-            if (cv <= cw) {
-                return cglib::length(p - s2);
-            }
-
-            double fraction = cv == 0 ? 0 : cw / cv;
-            cglib::vec3<double> pProj = s1 + (s2 - s1) * fraction;
-            return cglib::length(pProj - p);
-        }
-
-        KeyInfo findKey(const MapPos* points, std::size_t first, std::size_t last) const {
             KeyInfo keyInfo;
 
-            cglib::vec3<double> s1 = _projectionSurface->calculatePosition(_projection->toInternal(points[first]));
-            cglib::vec3<double> s2 = _projectionSurface->calculatePosition(_projection->toInternal(points[last]));
+            cglib::vec3<double> s1 = positions[first];
+            cglib::vec3<double> v = positions[last] - s1;
+            double cv = cglib::norm(v);
+            double invCV = (cv == 0 ? 0 : 1.0 / cv);
+            // Branch-free loop over the packed coordinates, computes squared point-segment distances
             for (std::size_t current = first + 1; current < last; current++) {
-                cglib::vec3<double> p = _projectionSurface->calculatePosition(_projection->toInternal(points[current]));
-                double dist = FindSegmentDistance(s1, s2, p);
-                if (dist < keyInfo.dist) {
-                    continue;
+                cglib::vec3<double> w = positions[current] - s1;
+                double fraction = std::min(1.0, std::max(0.0, cglib::dot_product(v, w) * invCV));
+                double distSqr = cglib::norm(w - v * fraction);
+                if (distSqr >= keyInfo.distSqr) {
+                    keyInfo.index = current;
+                    keyInfo.distSqr = distSqr;
                 }
-                keyInfo.index = current;
-                keyInfo.dist = dist;
             }
             return keyInfo;
         }
@@ -37,7 +37,7 @@ namespace carto {
          * Returns the properties of the feature.
          * @return The properties of the feature.
          */
-        const Variant& getProperties() const;
+        virtual const Variant& getProperties() const;
     
     protected:
         const std::shared_ptr<Geometry> _geometry;
@@ -238,7 +238,17 @@ namespace carto {
         std::vector<MapPos> ring;
         ring.reserve(value.Size());
         for (rapidjson::SizeType i = 0; i < value.Size(); i++) {
-            ring.push_back(readPoint(value[i]));
+            const rapidjson::Value& coords = value[i];
+            if (!coords.IsArray()) {
+                throw ParseException("Wrong JSON type for coordinates");
+            }
+            if (coords.Size() < 2) {
+                throw ParseException("Too few components in coordinates");
+            }
+            ring.emplace_back(coords[0].GetDouble(), coords[1].GetDouble(), coords.Size() > 2 ? coords[2].GetDouble() : 0);
+        }
+        if (_targetProjection) {
+            ring = _targetProjection->fromWgs84(ring);
         }
         return ring;
     }
@@ -13,7 +13,10 @@
 #include "projections/Projection.h"
 #include "utils/Log.h"
 
+#include <atomic>
+#include <cstring>
 #include <stdexcept>
+#include <thread>
 
 #include <rapidjson/rapidjson.h>
 #include <rapidjson/writer.h>
@@ -86,24 +89,76 @@ namespace carto {
 
         std::lock_guard<std::mutex> lock(_mutex);
 
-        rapidjson::StringBuffer geoJSON;
-        rapidjson::Writer<rapidjson::StringBuffer> writer(geoJSON);
-        rapidjson::Document doc;
-        writeFeatureCollection(featureCollection, doc, doc.GetAllocator());
-        doc.Accept(writer);
-        return geoJSON.GetString();
-    }
+        // Serialize the features in parallel, each worker writing its features into its own
+        // buffer. The buffers are complete GeoJSON objects, so the final document can be
+        // assembled by plain concatenation into a preallocated string, without building
+        // a single large DOM for the whole collection.
+        int featureCount = featureCollection->getFeatureCount();
+        std::vector<std::string> featureGeoJSONs(featureCount);
+        std::atomic<int> featureIndex(0);
+        std::mutex exceptionMutex;
+        std::exception_ptr exceptionPtr;
 
-    void GeoJSONGeometryWriter::writeFeatureCollection(const std::shared_ptr<FeatureCollection>& featureCollection, rapidjson::Value& value, rapidjson::MemoryPoolAllocator<rapidjson::CrtAllocator>& allocator) const {
-        value.SetObject();
-        value.AddMember("type", "FeatureCollection", allocator);
-        rapidjson::Value featuresValue;
-        featuresValue.SetArray();
-        for (int i = 0; i < featureCollection->getFeatureCount(); i++) {
-            featuresValue.PushBack(rapidjson::Value(), allocator);
-            writeFeature(featureCollection->getFeature(i), featuresValue[i], allocator);
+        auto writeThreadFn = [&]() {
+            while (true) {
+                int i = featureIndex.fetch_add(1);
+                if (i >= featureCount) {
+                    return;
+                }
+                try {
+                    rapidjson::StringBuffer featureGeoJSON;
+                    rapidjson::Writer<rapidjson::StringBuffer> writer(featureGeoJSON);
+                    rapidjson::Document doc;
+                    writeFeature(featureCollection->getFeature(i), doc, doc.GetAllocator());
+                    doc.Accept(writer);
+                    featureGeoJSONs[i].assign(featureGeoJSON.GetString(), featureGeoJSON.GetSize());
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(exceptionMutex);
+                    if (!exceptionPtr) {
+                        exceptionPtr = std::current_exception();
+                    }
+                    featureIndex = featureCount;
+                    return;
+                }
+            }
+        };
+
+        std::size_t threadCount = std::min(static_cast<std::size_t>(std::max(std::thread::hardware_concurrency(), 1U)), static_cast<std::size_t>(featureCount));
+        if (threadCount < 2) {
+            writeThreadFn();
+        } else {
+            std::vector<std::thread> threads;
+            threads.reserve(threadCount);
+            for (std::size_t i = 0; i < threadCount; i++) {
+                threads.emplace_back(writeThreadFn);
+            }
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+        }
+
+        if (exceptionPtr) {
+            std::rethrow_exception(exceptionPtr);
+        }
+
+        const char* header = "{\"type\":\"FeatureCollection\",\"features\":[";
+        const char* footer = "]}";
+        std::size_t totalSize = std::strlen(header) + std::strlen(footer) + (featureCount > 0 ? featureCount - 1 : 0);
+        for (const std::string& featureGeoJSON : featureGeoJSONs) {
+            totalSize += featureGeoJSON.size();
+        }
+
+        std::string geoJSON;
+        geoJSON.reserve(totalSize);
+        geoJSON += header;
+        for (int i = 0; i < featureCount; i++) {
+            if (i > 0) {
+                geoJSON += ',';
+            }
+            geoJSON += featureGeoJSONs[i];
         }
-        value.AddMember("features", featuresValue.Move(), allocator);
+        geoJSON += footer;
+        return geoJSON;
     }
 
     void GeoJSONGeometryWriter::writeFeature(const std::shared_ptr<Feature>& feature, rapidjson::Value& value, rapidjson::MemoryPoolAllocator<rapidjson::CrtAllocator>& allocator) const {
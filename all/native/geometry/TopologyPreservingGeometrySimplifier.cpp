@@ -0,0 +1,248 @@
+#include "TopologyPreservingGeometrySimplifier.h"
+#include "core/MapPos.h"
+#include "geometry/Geometry.h"
+#include "geometry/LineGeometry.h"
+#include "geometry/PolygonGeometry.h"
+#include "geometry/MultiGeometry.h"
+#include "geometry/MultiLineGeometry.h"
+#include "geometry/MultiPolygonGeometry.h"
+#include "projections/Projection.h"
+#include "projections/ProjectionSurface.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+
+namespace carto {
+
+    class TopologyPreservingGeometrySimplifier::Helper {
+    public:
+        Helper(const TopologyPreservingGeometrySimplifier& simplifier, const std::shared_ptr<Projection>& projection, const std::shared_ptr<ProjectionSurface>& projectionSurface, float scale) :
+            _simplifier(simplifier),
+            _projection(projection),
+            _projectionSurface(projectionSurface),
+            _scale(scale),
+            _vertexNeighbors(),
+            _arcCache()
+        {
+        }
+
+        void registerGeometry(const std::shared_ptr<Geometry>& geometry) {
+            if (auto polygonGeometry = std::dynamic_pointer_cast<PolygonGeometry>(geometry)) {
+                registerRing(polygonGeometry->getPoses());
+                for (const std::vector<MapPos>& holeRing : polygonGeometry->getHoles()) {
+                    registerRing(holeRing);
+                }
+            } else if (auto multiGeometry = std::dynamic_pointer_cast<MultiGeometry>(geometry)) {
+                for (int i = 0; i < multiGeometry->getGeometryCount(); i++) {
+                    registerGeometry(multiGeometry->getGeometry(i));
+                }
+            }
+        }
+
+        std::shared_ptr<Geometry> simplifyGeometry(const std::shared_ptr<Geometry>& geometry) const {
+            if (auto polygonGeometry = std::dynamic_pointer_cast<PolygonGeometry>(geometry)) {
+                std::vector<MapPos> mapPoses = simplifyRing(polygonGeometry->getPoses());
+                if (mapPoses.size() < 3) {
+                    return std::shared_ptr<Geometry>();
+                }
+                bool simplified = mapPoses.size() < polygonGeometry->getPoses().size();
+                std::vector<std::vector<MapPos> > holes;
+                for (const std::vector<MapPos>& holeRing : polygonGeometry->getHoles()) {
+                    std::vector<MapPos> holeMapPoses = simplifyRing(holeRing);
+                    if (holeMapPoses.size() < holeRing.size()) {
+                        simplified = true;
+                    }
+                    if (holeMapPoses.size() >= 3) {
+                        holes.push_back(std::move(holeMapPoses));
+                    }
+                }
+                if (simplified) {
+                    return std::make_shared<PolygonGeometry>(mapPoses, holes);
+                }
+            } else if (auto multiPolygonGeometry = std::dynamic_pointer_cast<MultiPolygonGeometry>(geometry)) {
+                std::vector<std::shared_ptr<PolygonGeometry> > polygons;
+                bool simplified = false;
+                for (int i = 0; i < multiPolygonGeometry->getGeometryCount(); i++) {
+                    std::shared_ptr<Geometry> geom = simplifyGeometry(multiPolygonGeometry->getGeometry(i));
+                    if (geom != multiPolygonGeometry->getGeometry(i)) {
+                        simplified = true;
+                    }
+                    if (auto polygon = std::dynamic_pointer_cast<PolygonGeometry>(geom)) {
+                        polygons.push_back(polygon);
+                    }
+                }
+                if (simplified) {
+                    return std::make_shared<MultiPolygonGeometry>(polygons);
+                }
+            } else if (std::dynamic_pointer_cast<LineGeometry>(geometry) || std::dynamic_pointer_cast<MultiLineGeometry>(geometry)) {
+                // Lines do not participate in the shared topology, simplify them independently
+                return _simplifier.simplify(geometry, _projection, _projectionSurface, _scale);
+            } else if (auto multiGeometry = std::dynamic_pointer_cast<MultiGeometry>(geometry)) {
+                std::vector<std::shared_ptr<Geometry> > geoms;
+                bool simplified = false;
+                for (int i = 0; i < multiGeometry->getGeometryCount(); i++) {
+                    std::shared_ptr<Geometry> geom = simplifyGeometry(multiGeometry->getGeometry(i));
+                    if (geom != multiGeometry->getGeometry(i)) {
+                        simplified = true;
+                    }
+                    if (geom) {
+                        geoms.push_back(geom);
+                    }
+                }
+                if (simplified) {
+                    return std::make_shared<MultiGeometry>(geoms);
+                }
+            }
+            return geometry;
+        }
+
+    private:
+        struct ArcHash {
+            std::size_t operator ()(const std::vector<MapPos>& arc) const {
+                std::size_t hash = arc.size();
+                for (const MapPos& pos : arc) {
+                    hash = hash * 31 + std::hash<MapPos>()(pos);
+                }
+                return hash;
+            }
+        };
+
+        void registerRing(const std::vector<MapPos>& ring) {
+            if (ring.size() < 3) {
+                return;
+            }
+            for (std::size_t i = 0; i < ring.size(); i++) {
+                std::vector<MapPos>& neighbors = _vertexNeighbors[ring[i]];
+                addNeighbor(neighbors, ring[(i + ring.size() - 1) % ring.size()]);
+                addNeighbor(neighbors, ring[(i + 1) % ring.size()]);
+            }
+        }
+
+        static void addNeighbor(std::vector<MapPos>& neighbors, const MapPos& pos) {
+            // 3 distinct neighbors are enough to mark the vertex as a junction
+            if (neighbors.size() < 3 && std::find(neighbors.begin(), neighbors.end(), pos) == neighbors.end()) {
+                neighbors.push_back(pos);
+            }
+        }
+
+        bool isJunction(const MapPos& pos) const {
+            auto it = _vertexNeighbors.find(pos);
+            return it != _vertexNeighbors.end() && it->second.size() != 2;
+        }
+
+        static bool comparePos(const MapPos& pos1, const MapPos& pos2) {
+            if (pos1.getX() != pos2.getX()) {
+                return pos1.getX() < pos2.getX();
+            }
+            if (pos1.getY() != pos2.getY()) {
+                return pos1.getY() < pos2.getY();
+            }
+            return pos1.getZ() < pos2.getZ();
+        }
+
+        std::vector<MapPos> simplifyRing(const std::vector<MapPos>& ring) const {
+            if (ring.size() < 3) {
+                return ring;
+            }
+
+            // Rotate the ring to start at a junction vertex, so that each boundary shared
+            // with an adjacent ring becomes a whole number of arcs. Rings without junctions
+            // are rotated and oriented to a coordinate-based canonical form, so that
+            // coincident rings (for example, an island and the matching hole) share one arc.
+            std::size_t startIndex = ring.size();
+            for (std::size_t i = 0; i < ring.size(); i++) {
+                if (isJunction(ring[i])) {
+                    startIndex = i;
+                    break;
+                }
+            }
+            bool canonicalize = startIndex == ring.size();
+            if (canonicalize) {
+                startIndex = 0;
+                for (std::size_t i = 1; i < ring.size(); i++) {
+                    if (comparePos(ring[i], ring[startIndex])) {
+                        startIndex = i;
+                    }
+                }
+            }
+
+            std::vector<MapPos> rotatedRing;
+            rotatedRing.reserve(ring.size() + 1);
+            rotatedRing.insert(rotatedRing.end(), ring.begin() + startIndex, ring.end());
+            rotatedRing.insert(rotatedRing.end(), ring.begin(), ring.begin() + startIndex);
+            if (canonicalize && comparePos(rotatedRing.back(), rotatedRing[1])) {
+                std::reverse(rotatedRing.begin() + 1, rotatedRing.end());
+            }
+            rotatedRing.push_back(rotatedRing.front());
+
+            // Split the closed ring into arcs at junction vertices, simplify each arc
+            // and concatenate the results back into a ring
+            std::vector<MapPos> simplifiedRing;
+            simplifiedRing.reserve(rotatedRing.size());
+            std::size_t arcStart = 0;
+            for (std::size_t i = 1; i < rotatedRing.size(); i++) {
+                if (i + 1 == rotatedRing.size() || isJunction(rotatedRing[i])) {
+                    std::vector<MapPos> arc(rotatedRing.begin() + arcStart, rotatedRing.begin() + i + 1);
+                    std::vector<MapPos> simplifiedArc = simplifyArc(arc);
+                    simplifiedRing.insert(simplifiedRing.end(), simplifiedArc.begin() + (simplifiedRing.empty() ? 0 : 1), simplifiedArc.end());
+                    arcStart = i;
+                }
+            }
+            simplifiedRing.pop_back(); // drop the duplicated closing vertex
+            return simplifiedRing;
+        }
+
+        std::vector<MapPos> simplifyArc(const std::vector<MapPos>& arc) const {
+            // Simplify each arc once, in canonical direction, so that both rings sharing
+            // a boundary get the exact same simplified vertex sequence
+            bool reversed = std::lexicographical_compare(arc.rbegin(), arc.rend(), arc.begin(), arc.end(), comparePos);
+            std::vector<MapPos> canonicalArc(arc);
+            if (reversed) {
+                std::reverse(canonicalArc.begin(), canonicalArc.end());
+            }
+
+            auto it = _arcCache.find(canonicalArc);
+            if (it == _arcCache.end()) {
+                std::vector<MapPos> simplifiedCanonicalArc = _simplifier.simplifyRing(canonicalArc, _projection, _projectionSurface, _scale);
+                it = _arcCache.emplace(std::move(canonicalArc), std::move(simplifiedCanonicalArc)).first;
+            }
+
+            std::vector<MapPos> simplifiedArc = it->second;
+            if (reversed) {
+                std::reverse(simplifiedArc.begin(), simplifiedArc.end());
+            }
+            return simplifiedArc;
+        }
+
+        const TopologyPreservingGeometrySimplifier& _simplifier;
+        std::shared_ptr<Projection> _projection;
+        std::shared_ptr<ProjectionSurface> _projectionSurface;
+        float _scale;
+
+        std::unordered_map<MapPos, std::vector<MapPos> > _vertexNeighbors;
+        mutable std::unordered_map<std::vector<MapPos>, std::vector<MapPos>, ArcHash> _arcCache;
+    };
+
+    TopologyPreservingGeometrySimplifier::TopologyPreservingGeometrySimplifier(float tolerance) :
+        DouglasPeuckerGeometrySimplifier(tolerance)
+    {
+    }
+
+    std::vector<std::shared_ptr<Geometry> > TopologyPreservingGeometrySimplifier::simplifyAll(const std::vector<std::shared_ptr<Geometry> >& geometries, const std::shared_ptr<Projection>& projection, const std::shared_ptr<ProjectionSurface>& projectionSurface, float scale) const {
+        Helper helper(*this, projection, projectionSurface, scale);
+        for (const std::shared_ptr<Geometry>& geometry : geometries) {
+            if (geometry) {
+                helper.registerGeometry(geometry);
+            }
+        }
+
+        std::vector<std::shared_ptr<Geometry> > simplifiedGeometries;
+        simplifiedGeometries.reserve(geometries.size());
+        for (const std::shared_ptr<Geometry>& geometry : geometries) {
+            simplifiedGeometries.push_back(geometry ? helper.simplifyGeometry(geometry) : geometry);
+        }
+        return simplifiedGeometries;
+    }
+
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2016 CartoDB. All rights reserved.
+ * Copying and using this code is allowed only according
+ * to license terms, as given in https://cartodb.com/terms/
+ */
+
+#ifndef _CARTO_TOPOLOGYPRESERVINGGEOMETRYSIMPLIFIER_H_
+#define _CARTO_TOPOLOGYPRESERVINGGEOMETRYSIMPLIFIER_H_
+
+#include "geometry/DouglasPeuckerGeometrySimplifier.h"
+
+#include <vector>
+
+namespace carto {
+
+    /**
+     * A topology-aware geometry simplifier for data sets with shared polygon boundaries.
+     * When a batch of geometries is simplified, the boundaries are first split into arcs
+     * at junction vertices and arcs shared between adjacent polygons are detected.
+     * Each arc is then simplified exactly once using the Ramer-Douglas-Peucker algorithm
+     * and the polygon rings are reassembled from the simplified arcs. As both sides of
+     * a shared boundary use the same simplified arc, no slivers or gaps appear between
+     * adjacent polygons. Adjacent polygons are expected to share exact vertex coordinates
+     * along their common boundaries.
+     * When used outside of batch mode, the simplifier behaves like DouglasPeuckerGeometrySimplifier.
+     */
+    class TopologyPreservingGeometrySimplifier : public DouglasPeuckerGeometrySimplifier {
+    public:
+        /**
+         * Constructs a new simplifier, given tolerance.
+         * @param tolerance The maximum error for simplification. The tolerance value gives maximum error in pixels.
+         */
+        explicit TopologyPreservingGeometrySimplifier(float tolerance);
+
+        /**
+         * Performs batch simplification of the given geometries, given relative scale.
+         * Boundaries shared between the polygons of the batch are simplified consistently.
+         * @param geometries The list of geometries to simplify together. Null geometries are allowed and passed through.
+         * @param projection The projection used for the geometries.
+         * @param projectionSurface The projection surface used for the geometries.
+         * @param scale Relative scale for simplification, this is proportional to 2^zoom.
+         * @return The list of simplified geometries, in the same order as the input list.
+         *         Original geometries may be returned if simplification failed or was not needed.
+         *         Null pointers may be returned for geometries that should be discarded.
+         */
+        std::vector<std::shared_ptr<Geometry> > simplifyAll(const std::vector<std::shared_ptr<Geometry> >& geometries, const std::shared_ptr<Projection>& projection, const std::shared_ptr<ProjectionSurface>& projectionSurface, float scale) const;
+
+    private:
+        class Helper;
+    };
+}
+
+#endif
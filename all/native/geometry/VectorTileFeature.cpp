@@ -1,4 +1,5 @@
 #include "VectorTileFeature.h"
+#include "geometry/VectorTileFeatureData.h"
 
 namespace carto {
 
@@ -6,7 +7,21 @@ namespace carto {
         Feature(geometry, std::move(properties)),
         _id(id),
         _mapTile(mapTile),
-        _layerName(layerName)
+        _layerName(layerName),
+        _featureData(),
+        _lazyProperties(),
+        _propertiesOnce()
+    {
+    }
+
+    VectorTileFeature::VectorTileFeature(long long id, const MapTile& mapTile, const std::string& layerName, const std::shared_ptr<Geometry>& geometry, std::shared_ptr<VectorTileFeatureData> featureData) :
+        Feature(geometry, Variant()),
+        _id(id),
+        _mapTile(mapTile),
+        _layerName(layerName),
+        _featureData(std::move(featureData)),
+        _lazyProperties(),
+        _propertiesOnce()
     {
     }
     
@@ -24,5 +39,19 @@ namespace carto {
     const std::string& VectorTileFeature::getLayerName() const {
         return _layerName;
     }
+
+    const std::shared_ptr<VectorTileFeatureData>& VectorTileFeature::getFeatureData() const {
+        return _featureData;
+    }
+
+    const Variant& VectorTileFeature::getProperties() const {
+        if (_featureData) {
+            std::call_once(_propertiesOnce, [this]() {
+                _lazyProperties = _featureData->toVariant();
+            });
+            return _lazyProperties;
+        }
+        return Feature::getProperties();
+    }
     
 }
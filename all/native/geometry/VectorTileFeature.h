@@ -12,8 +12,10 @@
 
 #include <string>
 #include <memory>
+#include <mutex>
 
 namespace carto {
+    class VectorTileFeatureData;
 
     /**
      * A vector tile feature consisting of id, layer, geometry and properties.
@@ -29,6 +31,18 @@ namespace carto {
          * @param properties The properties of the feature.
          */
         VectorTileFeature(long long id, const MapTile& mapTile, const std::string& layerName, const std::shared_ptr<Geometry>& geometry, Variant properties);
+#ifndef SWIG
+        /**
+         * Constructs a VectorTileFeature object from id, layer name, geometry and compact feature data.
+         * The properties variant is materialized lazily on the first getProperties call.
+         * @param id The id of the feature.
+         * @param mapTile The map tile of this feature
+         * @param layerName The name of the layer of the feature.
+         * @param geometry The geometry of the feature.
+         * @param featureData The compact feature data of the feature.
+         */
+        VectorTileFeature(long long id, const MapTile& mapTile, const std::string& layerName, const std::shared_ptr<Geometry>& geometry, std::shared_ptr<VectorTileFeatureData> featureData);
+#endif
         virtual ~VectorTileFeature();
 
         /**
@@ -48,11 +62,24 @@ namespace carto {
          * @return The layer name of the feature.
          */
         const std::string& getLayerName() const;
-        
+
+#ifndef SWIG
+        /**
+         * Returns the compact feature data of the feature. Can be null if the feature was constructed from a Variant.
+         * @return The compact feature data of the feature.
+         */
+        const std::shared_ptr<VectorTileFeatureData>& getFeatureData() const;
+#endif
+
+        virtual const Variant& getProperties() const;
+
     protected:
         const long long _id;
         const MapTile _mapTile;
         const std::string _layerName;
+        const std::shared_ptr<VectorTileFeatureData> _featureData;
+        mutable Variant _lazyProperties;
+        mutable std::once_flag _propertiesOnce;
     };
     
 }
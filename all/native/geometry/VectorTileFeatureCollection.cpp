@@ -1,9 +1,11 @@
 #include "VectorTileFeatureCollection.h"
 
+#include <iterator>
+
 namespace carto {
 
-    VectorTileFeatureCollection::VectorTileFeatureCollection(const std::vector<std::shared_ptr<VectorTileFeature> >& features) :
-        FeatureCollection(features.begin(), features.end())
+    VectorTileFeatureCollection::VectorTileFeatureCollection(std::vector<std::shared_ptr<VectorTileFeature> > features) :
+        FeatureCollection(std::make_move_iterator(features.begin()), std::make_move_iterator(features.end()))
     {
     }
 
@@ -24,7 +24,7 @@ namespace carto {
          * Constructs a VectorTileFeatureCollection from a vector of vector tile features.
          * @param features The features for the collection.
          */
-        explicit VectorTileFeatureCollection(const std::vector<std::shared_ptr<VectorTileFeature> >& features);
+        explicit VectorTileFeatureCollection(std::vector<std::shared_ptr<VectorTileFeature> > features);
         virtual ~VectorTileFeatureCollection();
 
         /**
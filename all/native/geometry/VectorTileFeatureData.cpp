@@ -0,0 +1,89 @@
+#include "VectorTileFeatureData.h"
+
+#include <map>
+
+namespace carto {
+
+    VectorTileFeatureData::VectorTileFeatureData(const std::shared_ptr<std::vector<const std::string*> >& keyTable) :
+        _keyTable(keyTable),
+        _properties()
+    {
+    }
+
+    void VectorTileFeatureData::addProperty(int keyIndex) {
+        PropertyValue value;
+        value.type = PropertyValue::TYPE_NULL;
+        _properties.emplace_back(keyIndex, std::move(value));
+    }
+
+    void VectorTileFeatureData::addProperty(int keyIndex, bool boolVal) {
+        PropertyValue value;
+        value.type = PropertyValue::TYPE_BOOL;
+        value.boolVal = boolVal;
+        _properties.emplace_back(keyIndex, std::move(value));
+    }
+
+    void VectorTileFeatureData::addProperty(int keyIndex, long long longVal) {
+        PropertyValue value;
+        value.type = PropertyValue::TYPE_LONG;
+        value.longVal = longVal;
+        _properties.emplace_back(keyIndex, std::move(value));
+    }
+
+    void VectorTileFeatureData::addProperty(int keyIndex, double doubleVal) {
+        PropertyValue value;
+        value.type = PropertyValue::TYPE_DOUBLE;
+        value.doubleVal = doubleVal;
+        _properties.emplace_back(keyIndex, std::move(value));
+    }
+
+    void VectorTileFeatureData::addProperty(int keyIndex, const std::string& stringVal) {
+        PropertyValue value;
+        value.type = PropertyValue::TYPE_STRING;
+        value.stringVal = stringVal;
+        _properties.emplace_back(keyIndex, std::move(value));
+    }
+
+    std::size_t VectorTileFeatureData::getPropertyCount() const {
+        return _properties.size();
+    }
+
+    const std::string& VectorTileFeatureData::getPropertyKey(std::size_t index) const {
+        return *(*_keyTable)[_properties[index].first];
+    }
+
+    Variant VectorTileFeatureData::getPropertyValue(std::size_t index) const {
+        const PropertyValue& value = _properties[index].second;
+        switch (value.type) {
+        case PropertyValue::TYPE_BOOL:
+            return Variant(value.boolVal);
+        case PropertyValue::TYPE_LONG:
+            return Variant(value.longVal);
+        case PropertyValue::TYPE_DOUBLE:
+            return Variant(value.doubleVal);
+        case PropertyValue::TYPE_STRING:
+            return Variant(value.stringVal);
+        default:
+            return Variant();
+        }
+    }
+
+    bool VectorTileFeatureData::getProperty(const std::string& key, Variant& value) const {
+        for (std::size_t i = 0; i < _properties.size(); i++) {
+            if (getPropertyKey(i) == key) {
+                value = getPropertyValue(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Variant VectorTileFeatureData::toVariant() const {
+        std::map<std::string, Variant> object;
+        for (std::size_t i = 0; i < _properties.size(); i++) {
+            object[getPropertyKey(i)] = getPropertyValue(i);
+        }
+        return Variant(object);
+    }
+
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2016 CartoDB. All rights reserved.
+ * Copying and using this code is allowed only according
+ * to license terms, as given in https://cartodb.com/terms/
+ */
+
+#ifndef _CARTO_VECTORTILEFEATUREDATA_H_
+#define _CARTO_VECTORTILEFEATUREDATA_H_
+
+#include "core/Variant.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace carto {
+
+    /**
+     * A compact internal representation of vector tile feature properties.
+     * Property keys are interned in the process-wide string table and referenced
+     * through a key table shared between the features of a tile, the values are
+     * kept as tagged values in a contiguous array.
+     * Generic Variant objects are built only when the properties are actually accessed.
+     */
+    class VectorTileFeatureData {
+    public:
+        explicit VectorTileFeatureData(const std::shared_ptr<std::vector<const std::string*> >& keyTable);
+
+        void addProperty(int keyIndex);
+        void addProperty(int keyIndex, bool boolVal);
+        void addProperty(int keyIndex, long long longVal);
+        void addProperty(int keyIndex, double doubleVal);
+        void addProperty(int keyIndex, const std::string& stringVal);
+
+        std::size_t getPropertyCount() const;
+        const std::string& getPropertyKey(std::size_t index) const;
+        Variant getPropertyValue(std::size_t index) const;
+
+        bool getProperty(const std::string& key, Variant& value) const;
+
+        Variant toVariant() const;
+
+    private:
+        struct PropertyValue {
+            enum Type { TYPE_NULL, TYPE_BOOL, TYPE_LONG, TYPE_DOUBLE, TYPE_STRING };
+
+            PropertyValue() : type(TYPE_NULL), longVal(0), stringVal() { }
+
+            Type type;
+            union {
+                bool boolVal;
+                long long longVal;
+                double doubleVal;
+            };
+            std::string stringVal;
+        };
+
+        std::shared_ptr<std::vector<const std::string*> > _keyTable;
+        std::vector<std::pair<int, PropertyValue> > _properties;
+    };
+
+}
+
+#endif
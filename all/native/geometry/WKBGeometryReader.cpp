@@ -25,6 +25,10 @@ namespace carto {
     {
     }
 
+    bool WKBGeometryReader::Stream::eof() const {
+        return _offset >= _data.size();
+    }
+
     void WKBGeometryReader::Stream::pushBigEndian(bool little) {
         _bigEndian.push(little);
     }
@@ -90,6 +94,21 @@ namespace carto {
         return readGeometry(stream);
     }
 
+    std::vector<std::shared_ptr<Geometry> > WKBGeometryReader::readGeometries(const std::shared_ptr<BinaryData>& wkbData) const {
+        if (!wkbData) {
+            throw NullArgumentException("Null wkbData");
+        }
+
+        std::vector<std::shared_ptr<Geometry> > geometries;
+        Stream stream(*wkbData->getDataPtr());
+        while (!stream.eof()) {
+            if (auto geometry = readGeometry(stream)) {
+                geometries.push_back(std::move(geometry));
+            }
+        }
+        return geometries;
+    }
+
     std::shared_ptr<Geometry> WKBGeometryReader::readGeometry(Stream& stream) const {
         unsigned char bigEndian = stream.readByte();
         stream.pushBigEndian(bigEndian == WKB_XDR);
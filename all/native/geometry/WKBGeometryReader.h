@@ -38,17 +38,30 @@ namespace carto {
          */
         std::shared_ptr<Geometry> readGeometry(const std::shared_ptr<BinaryData>& wkbData) const;
 
+        /**
+         * Reads a list of geometries from the specified WKB data stream.
+         * The stream is expected to contain concatenated WKB geometries without separators.
+         * Reading a large batch of geometries this way is considerably faster than
+         * reading them one by one.
+         * @param wkbData The WKB data stream to read.
+         * @return The list of geometries read from the stream. Empty if the data is empty.
+         * @throws std::runtime_error If reading fails.
+         */
+        std::vector<std::shared_ptr<Geometry> > readGeometries(const std::shared_ptr<BinaryData>& wkbData) const;
+
     private:
         struct Stream {
             Stream(const std::vector<unsigned char>& data);
 
+            bool eof() const;
+
             void pushBigEndian(bool little);
             void popBigEndian();
 
             unsigned char readByte();
             std::uint32_t readUInt32();
             double readDouble();
-        
+
         private:
             const std::vector<unsigned char>& _data;
             std::size_t _offset;
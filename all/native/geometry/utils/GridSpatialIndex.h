@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2016 CartoDB. All rights reserved.
+ * Copying and using this code is allowed only according
+ * to license terms, as given in https://cartodb.com/terms/
+ */
+
+#ifndef _CARTO_GRIDSPATIALINDEX_H_
+#define _CARTO_GRIDSPATIALINDEX_H_
+
+#include "geometry/utils/SpatialIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+namespace carto {
+
+    template <typename T>
+    class GridSpatialIndex : public SpatialIndex<T> {
+    public:
+        explicit GridSpatialIndex(double cellSize);
+        virtual ~GridSpatialIndex() { }
+
+        virtual std::size_t size() const;
+        virtual void reserve(std::size_t size);
+
+        virtual void clear();
+        virtual void insert(const cglib::bbox3<double>& bounds, const T& object);
+        virtual bool remove(const cglib::bbox3<double>& bounds, const T& object);
+        virtual bool remove(const T& object);
+
+        virtual std::vector<T> query(const cglib::frustum3<double>& frustum) const;
+        virtual std::vector<T> query(const cglib::bbox3<double>& bounds) const;
+        virtual std::vector<T> getAll() const;
+
+    private:
+        class Record {
+        public:
+            Record(const cglib::bbox3<double>& bounds, const T& object);
+
+            cglib::bbox3<double> bounds;
+            T object;
+            bool removed;
+        };
+
+        static long long CalculateCellId(int x, int y);
+        static float FloorToFloat(double value);
+        static float CeilToFloat(double value);
+
+        void calculateCellRange(const cglib::bbox3<double>& bounds, int& x0, int& y0, int& x1, int& y1) const;
+
+        const double _cellSize;
+
+        std::vector<Record> _records;
+        // Conservatively rounded 2D bounds of the records, kept as packed structure-of-arrays
+        // float buffers so that the rejection test in query can be vectorized by the compiler
+        std::vector<float> _boundsMinX;
+        std::vector<float> _boundsMinY;
+        std::vector<float> _boundsMaxX;
+        std::vector<float> _boundsMaxY;
+        std::unordered_map<long long, std::vector<std::size_t> > _cells;
+        std::size_t _count;
+    };
+
+    template <typename T>
+    GridSpatialIndex<T>::GridSpatialIndex(double cellSize) :
+        _cellSize(cellSize),
+        _records(),
+        _boundsMinX(),
+        _boundsMinY(),
+        _boundsMaxX(),
+        _boundsMaxY(),
+        _cells(),
+        _count(0)
+    {
+    }
+
+    template <typename T>
+    std::size_t GridSpatialIndex<T>::size() const {
+        return _count;
+    }
+
+    template <typename T>
+    void GridSpatialIndex<T>::reserve(std::size_t size) {
+        _records.reserve(size);
+        _boundsMinX.reserve(size);
+        _boundsMinY.reserve(size);
+        _boundsMaxX.reserve(size);
+        _boundsMaxY.reserve(size);
+    }
+
+    template <typename T>
+    void GridSpatialIndex<T>::clear() {
+        _records.clear();
+        _boundsMinX.clear();
+        _boundsMinY.clear();
+        _boundsMaxX.clear();
+        _boundsMaxY.clear();
+        _cells.clear();
+        _count = 0;
+    }
+
+    template <typename T>
+    void GridSpatialIndex<T>::insert(const cglib::bbox3<double>& bounds, const T& object) {
+        std::size_t index = _records.size();
+        _records.emplace_back(bounds, object);
+        _boundsMinX.push_back(FloorToFloat(bounds.min(0)));
+        _boundsMinY.push_back(FloorToFloat(bounds.min(1)));
+        _boundsMaxX.push_back(CeilToFloat(bounds.max(0)));
+        _boundsMaxY.push_back(CeilToFloat(bounds.max(1)));
+
+        int x0, y0, x1, y1;
+        calculateCellRange(bounds, x0, y0, x1, y1);
+        for (int y = y0; y <= y1; y++) {
+            for (int x = x0; x <= x1; x++) {
+                _cells[CalculateCellId(x, y)].push_back(index);
+            }
+        }
+        _count++;
+    }
+
+    template <typename T>
+    bool GridSpatialIndex<T>::remove(const cglib::bbox3<double>& bounds, const T& object) {
+        bool removed = false;
+        for (Record& record : _records) {
+            if (!record.removed && record.bounds == bounds && record.object == object) {
+                record.removed = true;
+                _count--;
+                removed = true;
+            }
+        }
+        return removed;
+    }
+
+    template <typename T>
+    bool GridSpatialIndex<T>::remove(const T& object) {
+        bool removed = false;
+        for (Record& record : _records) {
+            if (!record.removed && record.object == object) {
+                record.removed = true;
+                _count--;
+                removed = true;
+            }
+        }
+        return removed;
+    }
+
+    template <typename T>
+    std::vector<T> GridSpatialIndex<T>::query(const cglib::frustum3<double>& frustum) const {
+        std::vector<T> results;
+        for (const Record& record : _records) {
+            if (!record.removed && frustum.inside(record.bounds)) {
+                results.push_back(record.object);
+            }
+        }
+        return results;
+    }
+
+    template <typename T>
+    std::vector<T> GridSpatialIndex<T>::query(const cglib::bbox3<double>& bounds) const {
+        std::vector<T> results;
+
+        // Gather candidate record indices from all overlapping cells
+        std::vector<std::size_t> candidateIndices;
+        int x0, y0, x1, y1;
+        calculateCellRange(bounds, x0, y0, x1, y1);
+        for (int y = y0; y <= y1; y++) {
+            for (int x = x0; x <= x1; x++) {
+                auto it = _cells.find(CalculateCellId(x, y));
+                if (it != _cells.end()) {
+                    candidateIndices.insert(candidateIndices.end(), it->second.begin(), it->second.end());
+                }
+            }
+        }
+        if (x0 != x1 || y0 != y1) {
+            // Records spanning multiple cells may be listed more than once
+            std::sort(candidateIndices.begin(), candidateIndices.end());
+            candidateIndices.erase(std::unique(candidateIndices.begin(), candidateIndices.end()), candidateIndices.end());
+        }
+
+        // Conservative branchless rejection test over the packed float bounds.
+        // The loop body is free of branches and loads from flat arrays, allowing
+        // the compiler to vectorize the test over multiple candidates at once.
+        float queryMinX = FloorToFloat(bounds.min(0));
+        float queryMinY = FloorToFloat(bounds.min(1));
+        float queryMaxX = CeilToFloat(bounds.max(0));
+        float queryMaxY = CeilToFloat(bounds.max(1));
+        std::vector<unsigned char> overlapFlags(candidateIndices.size());
+        for (std::size_t i = 0; i < candidateIndices.size(); i++) {
+            std::size_t index = candidateIndices[i];
+            overlapFlags[i] = static_cast<unsigned char>((_boundsMinX[index] <= queryMaxX) & (_boundsMaxX[index] >= queryMinX) & (_boundsMinY[index] <= queryMaxY) & (_boundsMaxY[index] >= queryMinY));
+        }
+
+        // Do the precise test only on the candidates that passed the rejection test
+        for (std::size_t i = 0; i < candidateIndices.size(); i++) {
+            if (overlapFlags[i]) {
+                const Record& record = _records[candidateIndices[i]];
+                if (!record.removed && record.bounds.inside(bounds)) {
+                    results.push_back(record.object);
+                }
+            }
+        }
+        return results;
+    }
+
+    template <typename T>
+    std::vector<T> GridSpatialIndex<T>::getAll() const {
+        std::vector<T> results;
+        results.reserve(_count);
+        for (const Record& record : _records) {
+            if (!record.removed) {
+                results.push_back(record.object);
+            }
+        }
+        return results;
+    }
+
+    template <typename T>
+    GridSpatialIndex<T>::Record::Record(const cglib::bbox3<double>& bounds, const T& object) :
+        bounds(bounds),
+        object(object),
+        removed(false)
+    {
+    }
+
+    template <typename T>
+    long long GridSpatialIndex<T>::CalculateCellId(int x, int y) {
+        return (static_cast<long long>(y) << 32) | static_cast<unsigned int>(x);
+    }
+
+    template <typename T>
+    float GridSpatialIndex<T>::FloorToFloat(double value) {
+        return std::nextafter(static_cast<float>(value), -std::numeric_limits<float>::infinity());
+    }
+
+    template <typename T>
+    float GridSpatialIndex<T>::CeilToFloat(double value) {
+        return std::nextafter(static_cast<float>(value), std::numeric_limits<float>::infinity());
+    }
+
+    template <typename T>
+    void GridSpatialIndex<T>::calculateCellRange(const cglib::bbox3<double>& bounds, int& x0, int& y0, int& x1, int& y1) const {
+        x0 = static_cast<int>(std::floor(bounds.min(0) / _cellSize));
+        y0 = static_cast<int>(std::floor(bounds.min(1) / _cellSize));
+        x1 = static_cast<int>(std::floor(bounds.max(0) / _cellSize));
+        y1 = static_cast<int>(std::floor(bounds.max(1) / _cellSize));
+    }
+
+}
+
+#endif
@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2016 CartoDB. All rights reserved.
+ * Copying and using this code is allowed only according
+ * to license terms, as given in https://cartodb.com/terms/
+ */
+
+#ifndef _CARTO_RTREESPATIALINDEX_H_
+#define _CARTO_RTREESPATIALINDEX_H_
+
+#include "geometry/utils/SpatialIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace carto {
+
+    /**
+     * A bulk-loaded packed R-tree. The tree is built lazily using sort-tile-recursive
+     * packing when the index is first queried after a modification. Nodes are stored in
+     * a contiguous array and traversed iteratively, which makes queries cache-friendly
+     * even for large data sets with heavily overlapping bounding boxes.
+     */
+    template <typename T>
+    class RTreeSpatialIndex : public SpatialIndex<T> {
+    public:
+        RTreeSpatialIndex();
+        virtual ~RTreeSpatialIndex() { }
+
+        virtual std::size_t size() const;
+        virtual void reserve(std::size_t size);
+
+        virtual void clear();
+        virtual void insert(const cglib::bbox3<double>& bounds, const T& object);
+        virtual bool remove(const cglib::bbox3<double>& bounds, const T& object);
+        virtual bool remove(const T& object);
+
+        virtual std::vector<T> query(const cglib::frustum3<double>& frustum) const;
+        virtual std::vector<T> query(const cglib::bbox3<double>& bounds) const;
+        virtual std::vector<T> getAll() const;
+
+    private:
+        class Record {
+        public:
+            Record(const cglib::bbox3<double>& bounds, const T& object);
+
+            cglib::bbox3<double> bounds;
+            T object;
+        };
+
+        class Node {
+        public:
+            Node();
+
+            cglib::bbox3<double> bounds;
+            std::size_t firstIndex; // index of the first child node or the first record, depending on the leaf flag
+            std::size_t count;
+            bool leaf;
+        };
+
+        static const std::size_t NODE_CAPACITY = 16;
+
+        void pack() const;
+
+        template <typename Predicate>
+        void queryNodes(const Predicate& predicate, std::vector<T>& results) const;
+
+        mutable std::vector<Record> _records;
+        mutable std::vector<Node> _nodes;
+        mutable std::size_t _rootIndex;
+        mutable bool _dirty;
+    };
+
+    template <typename T>
+    RTreeSpatialIndex<T>::RTreeSpatialIndex() :
+        _records(),
+        _nodes(),
+        _rootIndex(0),
+        _dirty(false)
+    {
+    }
+
+    template <typename T>
+    std::size_t RTreeSpatialIndex<T>::size() const {
+        return _records.size();
+    }
+
+    template <typename T>
+    void RTreeSpatialIndex<T>::reserve(std::size_t size) {
+        _records.reserve(size);
+    }
+
+    template <typename T>
+    void RTreeSpatialIndex<T>::clear() {
+        _records.clear();
+        _nodes.clear();
+        _rootIndex = 0;
+        _dirty = false;
+    }
+
+    template <typename T>
+    void RTreeSpatialIndex<T>::insert(const cglib::bbox3<double>& bounds, const T& object) {
+        _records.emplace_back(bounds, object);
+        _dirty = true;
+    }
+
+    template <typename T>
+    bool RTreeSpatialIndex<T>::remove(const cglib::bbox3<double>& bounds, const T& object) {
+        return remove(object);
+    }
+
+    template <typename T>
+    bool RTreeSpatialIndex<T>::remove(const T& object) {
+        std::size_t count = _records.size();
+        _records.erase(std::remove_if(_records.begin(), _records.end(), [&object](const Record& record) {
+            return record.object == object;
+        }), _records.end());
+        if (_records.size() == count) {
+            return false;
+        }
+        _dirty = true;
+        return true;
+    }
+
+    template <typename T>
+    std::vector<T> RTreeSpatialIndex<T>::query(const cglib::frustum3<double>& frustum) const {
+        std::vector<T> results;
+        queryNodes([&frustum](const cglib::bbox3<double>& bounds) {
+            return frustum.inside(bounds);
+        }, results);
+        return results;
+    }
+
+    template <typename T>
+    std::vector<T> RTreeSpatialIndex<T>::query(const cglib::bbox3<double>& bounds) const {
+        std::vector<T> results;
+        queryNodes([&bounds](const cglib::bbox3<double>& recordBounds) {
+            return bounds.inside(recordBounds);
+        }, results);
+        return results;
+    }
+
+    template <typename T>
+    std::vector<T> RTreeSpatialIndex<T>::getAll() const {
+        std::vector<T> results;
+        results.reserve(_records.size());
+        for (const Record& record : _records) {
+            results.push_back(record.object);
+        }
+        return results;
+    }
+
+    template <typename T>
+    RTreeSpatialIndex<T>::Record::Record(const cglib::bbox3<double>& bounds, const T& object) :
+        bounds(bounds),
+        object(object)
+    {
+    }
+
+    template <typename T>
+    RTreeSpatialIndex<T>::Node::Node() :
+        bounds(cglib::bbox3<double>::smallest()),
+        firstIndex(0),
+        count(0),
+        leaf(true)
+    {
+    }
+
+    template <typename T>
+    void RTreeSpatialIndex<T>::pack() const {
+        _nodes.clear();
+        _rootIndex = 0;
+        _dirty = false;
+        if (_records.empty()) {
+            return;
+        }
+
+        // Sort-tile-recursive packing. Order the records by x coordinate, cut them into
+        // vertical slices and order each slice by y coordinate. Consecutive records then
+        // form spatially coherent leaves.
+        std::size_t leafCount = (_records.size() + NODE_CAPACITY - 1) / NODE_CAPACITY;
+        std::size_t sliceCount = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(leafCount))));
+        std::size_t sliceSize = sliceCount * NODE_CAPACITY;
+
+        std::sort(_records.begin(), _records.end(), [](const Record& record1, const Record& record2) {
+            return record1.bounds.center()(0) < record2.bounds.center()(0);
+        });
+        for (std::size_t i = 0; i < _records.size(); i += sliceSize) {
+            std::sort(_records.begin() + i, _records.begin() + std::min(i + sliceSize, _records.size()), [](const Record& record1, const Record& record2) {
+                return record1.bounds.center()(1) < record2.bounds.center()(1);
+            });
+        }
+
+        // Create the leaf nodes
+        for (std::size_t i = 0; i < _records.size(); i += NODE_CAPACITY) {
+            Node node;
+            node.firstIndex = i;
+            node.count = std::min(static_cast<std::size_t>(NODE_CAPACITY), _records.size() - i);
+            node.leaf = true;
+            for (std::size_t j = 0; j < node.count; j++) {
+                node.bounds.add(_records[i + j].bounds);
+            }
+            _nodes.push_back(node);
+        }
+
+        // Build the upper levels by grouping consecutive nodes, until a single root remains
+        std::size_t levelStart = 0;
+        std::size_t levelCount = _nodes.size();
+        while (levelCount > 1) {
+            std::size_t nextLevelStart = _nodes.size();
+            for (std::size_t i = 0; i < levelCount; i += NODE_CAPACITY) {
+                Node node;
+                node.firstIndex = levelStart + i;
+                node.count = std::min(static_cast<std::size_t>(NODE_CAPACITY), levelCount - i);
+                node.leaf = false;
+                for (std::size_t j = 0; j < node.count; j++) {
+                    node.bounds.add(_nodes[levelStart + i + j].bounds);
+                }
+                _nodes.push_back(node);
+            }
+            levelStart = nextLevelStart;
+            levelCount = _nodes.size() - nextLevelStart;
+        }
+        _rootIndex = _nodes.size() - 1;
+    }
+
+    template <typename T>
+    template <typename Predicate>
+    void RTreeSpatialIndex<T>::queryNodes(const Predicate& predicate, std::vector<T>& results) const {
+        if (_dirty) {
+            pack();
+        }
+        if (_nodes.empty()) {
+            return;
+        }
+
+        std::vector<std::size_t> nodeStack;
+        nodeStack.push_back(_rootIndex);
+        while (!nodeStack.empty()) {
+            const Node& node = _nodes[nodeStack.back()];
+            nodeStack.pop_back();
+            if (!predicate(node.bounds)) {
+                continue;
+            }
+
+            if (node.leaf) {
+                for (std::size_t i = 0; i < node.count; i++) {
+                    const Record& record = _records[node.firstIndex + i];
+                    if (predicate(record.bounds)) {
+                        results.push_back(record.object);
+                    }
+                }
+            } else {
+                for (std::size_t i = 0; i < node.count; i++) {
+                    nodeStack.push_back(node.firstIndex + i);
+                }
+            }
+        }
+    }
+
+}
+
+#endif
@@ -2,11 +2,19 @@
 #include "core/BinaryData.h"
 #include "components/Exceptions.h"
 #include "utils/Log.h"
+#include "utils/MemoryStats.h"
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
 
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
 #include <stdext/zlib.h>
 
 #include <jpeglib.h>
@@ -16,6 +24,83 @@
 namespace {
     const unsigned char NUTiHeader[4] = { 'N', 'U', 'T', 'i' };
 
+    // Specialized resampling loop for RGBA bitmaps. The horizontal span is split into
+    // first/middle/last samples so that the middle samples are completely branch-free
+    // with a constant weight, allowing compilers to auto-vectorize the accumulation.
+    void resampleRGBABitmap(const unsigned char* dsrc, unsigned int srcWidth, unsigned int srcHeight, unsigned char* ddest, unsigned int width, unsigned int height, bool bUpsampleY, float fh, int weightShift, const std::vector<int>& px1ab) {
+        for (std::size_t y2 = 0; y2 < height; y2++) {
+            int y1a = static_cast<int>((y2) * fh);
+            int y1b = static_cast<int>((y2 + 1) * fh);
+            if (bUpsampleY) {
+                y1b = y1a + 256;
+            }
+            y1b = std::min(y1b, static_cast<int>(256 * srcHeight - 1));
+            int y1c = y1a >> 8;
+            int y1d = y1b >> 8;
+
+            for (std::size_t x2 = 0; x2 < width; x2++) {
+                int x1a = px1ab[x2 * 2 + 0];
+                int x1b = px1ab[x2 * 2 + 1];
+                int x1c = x1a >> 8;
+                int x1d = x1b >> 8;
+
+                unsigned int accum[4] = { 0, 0, 0, 0 };
+                unsigned int wa = 0;
+                for (int y = y1c; y <= y1d; y++) {
+                    unsigned int weight_y = 256;
+                    if (y1c != y1d) {
+                        if (y == y1c)
+                            weight_y = 256 - (y1a & 0xFF);
+                        else if (y == y1d)
+                            weight_y = (y1b & 0xFF);
+                    }
+
+                    const unsigned char* dsrc2 = &dsrc[(y * srcWidth + x1c) * 4];
+                    if (x1c == x1d) {
+                        unsigned int w = (256 * weight_y) >> weightShift;
+                        accum[0] += dsrc2[0] * w;
+                        accum[1] += dsrc2[1] * w;
+                        accum[2] += dsrc2[2] * w;
+                        accum[3] += dsrc2[3] * w;
+                        wa += w;
+                    } else {
+                        unsigned int wFirst = ((256 - (x1a & 0xFF)) * weight_y) >> weightShift;
+                        accum[0] += dsrc2[0] * wFirst;
+                        accum[1] += dsrc2[1] * wFirst;
+                        accum[2] += dsrc2[2] * wFirst;
+                        accum[3] += dsrc2[3] * wFirst;
+                        dsrc2 += 4;
+
+                        unsigned int wMid = (256 * weight_y) >> weightShift;
+                        for (int x = x1c + 1; x < x1d; x++) {
+                            accum[0] += dsrc2[0] * wMid;
+                            accum[1] += dsrc2[1] * wMid;
+                            accum[2] += dsrc2[2] * wMid;
+                            accum[3] += dsrc2[3] * wMid;
+                            dsrc2 += 4;
+                        }
+
+                        unsigned int wLast = ((x1b & 0xFF) * weight_y) >> weightShift;
+                        accum[0] += dsrc2[0] * wLast;
+                        accum[1] += dsrc2[1] * wLast;
+                        accum[2] += dsrc2[2] * wLast;
+                        accum[3] += dsrc2[3] * wLast;
+
+                        wa += wFirst + wMid * (x1d - x1c - 1) + wLast;
+                    }
+                }
+                if (wa <= 0) {
+                    wa = std::numeric_limits<int>::max();
+                }
+
+                *ddest++ = accum[0] / wa;
+                *ddest++ = accum[1] / wa;
+                *ddest++ = accum[2] / wa;
+                *ddest++ = accum[3] / wa;
+            }
+        }
+    }
+
     struct LibPNGIOContainer {
         LibPNGIOContainer(const unsigned char* compressedDataPtr) : _compressedDataPtr(compressedDataPtr) { }
     
@@ -68,6 +153,143 @@ namespace {
         return data;
     }
 
+    // Vectorized kernels for the per-pixel conversion hot spots. Every decoded raster
+    // tile and marker bitmap passes through one of these loops, so the common
+    // conversions use NEON/SSSE3 on capable targets with a scalar tail/fallback.
+    // All kernels compute floor(c * a / 255) identically to the scalar loops.
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    inline uint8x8_t divideBy255(uint16x8_t val) {
+        val = vsraq_n_u16(val, val, 8); // floor(t / 255) == (t + (t >> 8) + 1) >> 8 for t < 65280
+        return vshrn_n_u16(vaddq_u16(val, vdupq_n_u16(1)), 8);
+    }
+#endif
+
+    void premultiplyAlphaRGBA(unsigned char* data, std::size_t pixelCount) {
+        std::size_t i = 0;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+        for (; i + 8 <= pixelCount; i += 8) {
+            uint8x8x4_t pix = vld4_u8(data + i * 4);
+            pix.val[0] = divideBy255(vmull_u8(pix.val[0], pix.val[3]));
+            pix.val[1] = divideBy255(vmull_u8(pix.val[1], pix.val[3]));
+            pix.val[2] = divideBy255(vmull_u8(pix.val[2], pix.val[3]));
+            vst4_u8(data + i * 4, pix);
+        }
+#elif defined(__SSSE3__)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i one = _mm_set1_epi16(1);
+        const __m128i alphaShuffle = _mm_setr_epi8(3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15);
+        const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+        for (; i + 4 <= pixelCount; i += 4) {
+            __m128i pix = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 4));
+            __m128i alpha = _mm_shuffle_epi8(pix, alphaShuffle);
+            __m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(pix, zero), _mm_unpacklo_epi8(alpha, zero));
+            __m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(pix, zero), _mm_unpackhi_epi8(alpha, zero));
+            lo = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), one), 8); // floor(t / 255)
+            hi = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), one), 8);
+            __m128i result = _mm_packus_epi16(lo, hi);
+            result = _mm_or_si128(_mm_andnot_si128(alphaMask, result), _mm_and_si128(alphaMask, pix));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i * 4), result);
+        }
+#endif
+        for (; i < pixelCount; i++) {
+            unsigned char* pix = data + i * 4;
+            unsigned int a = pix[3];
+            pix[0] = static_cast<unsigned char>(pix[0] * a / 255);
+            pix[1] = static_cast<unsigned char>(pix[1] * a / 255);
+            pix[2] = static_cast<unsigned char>(pix[2] * a / 255);
+        }
+    }
+
+    void swizzleBGRAToRGBA(const unsigned char* src, unsigned char* dest, std::size_t pixelCount) {
+        std::size_t i = 0;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+        for (; i + 8 <= pixelCount; i += 8) {
+            uint8x8x4_t pix = vld4_u8(src + i * 4);
+            uint8x8_t blue = pix.val[0];
+            pix.val[0] = pix.val[2];
+            pix.val[2] = blue;
+            vst4_u8(dest + i * 4, pix);
+        }
+#elif defined(__SSSE3__)
+        const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+        for (; i + 4 <= pixelCount; i += 4) {
+            __m128i pix = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i * 4), _mm_shuffle_epi8(pix, shuffle));
+        }
+#endif
+        for (; i < pixelCount; i++) {
+            dest[i * 4 + 0] = src[i * 4 + 2];
+            dest[i * 4 + 1] = src[i * 4 + 1];
+            dest[i * 4 + 2] = src[i * 4 + 0];
+            dest[i * 4 + 3] = src[i * 4 + 3];
+        }
+    }
+
+    void expandGrayscaleToRGBA(const unsigned char* src, unsigned char* dest, std::size_t pixelCount) {
+        std::size_t i = 0;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+        for (; i + 8 <= pixelCount; i += 8) {
+            uint8x8_t gray = vld1_u8(src + i);
+            uint8x8x4_t pix;
+            pix.val[0] = gray;
+            pix.val[1] = gray;
+            pix.val[2] = gray;
+            pix.val[3] = vdup_n_u8(255);
+            vst4_u8(dest + i * 4, pix);
+        }
+#elif defined(__SSSE3__)
+        const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+        const __m128i shuffles[4] = {
+            _mm_setr_epi8(0, 0, 0, -1, 1, 1, 1, -1, 2, 2, 2, -1, 3, 3, 3, -1),
+            _mm_setr_epi8(4, 4, 4, -1, 5, 5, 5, -1, 6, 6, 6, -1, 7, 7, 7, -1),
+            _mm_setr_epi8(8, 8, 8, -1, 9, 9, 9, -1, 10, 10, 10, -1, 11, 11, 11, -1),
+            _mm_setr_epi8(12, 12, 12, -1, 13, 13, 13, -1, 14, 14, 14, -1, 15, 15, 15, -1)
+        };
+        for (; i + 16 <= pixelCount; i += 16) {
+            __m128i gray = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            for (int n = 0; n < 4; n++) {
+                __m128i pix = _mm_or_si128(_mm_shuffle_epi8(gray, shuffles[n]), alphaMask);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + (i + n * 4) * 4), pix);
+            }
+        }
+#endif
+        for (; i < pixelCount; i++) {
+            dest[i * 4 + 0] = src[i];
+            dest[i * 4 + 1] = src[i];
+            dest[i * 4 + 2] = src[i];
+            dest[i * 4 + 3] = 255;
+        }
+    }
+
+    void expandRGBToRGBA(const unsigned char* src, unsigned char* dest, std::size_t pixelCount) {
+        std::size_t i = 0;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+        for (; i + 8 <= pixelCount; i += 8) {
+            uint8x8x3_t rgb = vld3_u8(src + i * 3);
+            uint8x8x4_t pix;
+            pix.val[0] = rgb.val[0];
+            pix.val[1] = rgb.val[1];
+            pix.val[2] = rgb.val[2];
+            pix.val[3] = vdup_n_u8(255);
+            vst4_u8(dest + i * 4, pix);
+        }
+#elif defined(__SSSE3__)
+        const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+        const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        for (; i + 6 <= pixelCount; i += 4) { // the 16-byte load covers 4 output pixels plus 4 bytes of lookahead
+            __m128i rgb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i * 4), _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alphaMask));
+        }
+#endif
+        for (; i < pixelCount; i++) {
+            dest[i * 4 + 0] = src[i * 3 + 0];
+            dest[i * 4 + 1] = src[i * 3 + 1];
+            dest[i * 4 + 2] = src[i * 3 + 2];
+            dest[i * 4 + 3] = 255;
+        }
+    }
+
 }
 
 namespace carto {
@@ -78,7 +300,8 @@ namespace carto {
         _height(0),
         _bytesPerPixel(0),
         _colorFormat(ColorFormat::COLOR_FORMAT_UNSUPPORTED),
-        _pixelData()
+        _pixelData(),
+        _contentHash(0)
     {
         loadFromUncompressedBytes(pixelData->data(), width, height, colorFormat, bytesPerRow);
     }
@@ -89,12 +312,14 @@ namespace carto {
         _height(0),
         _bytesPerPixel(0),
         _colorFormat(ColorFormat::COLOR_FORMAT_UNSUPPORTED),
-        _pixelData()
+        _pixelData(),
+        _contentHash(0)
     {
         loadFromUncompressedBytes(pixelData, width, height, colorFormat, bytesPerRow);
     }
     
     Bitmap::~Bitmap() {
+        MemoryStats::Freed(MemoryStats::SUBSYSTEM_BITMAP, _pixelData.capacity());
     }
     
     unsigned int Bitmap::getWidth() const {
@@ -112,7 +337,11 @@ namespace carto {
     unsigned int Bitmap::getBytesPerPixel() const {
         return _bytesPerPixel;
     }
-    
+
+    long long Bitmap::getContentHash() const {
+        return _contentHash;
+    }
+
     const std::vector<unsigned char>& Bitmap::getPixelData() const {
         return _pixelData;
     }
@@ -286,6 +515,12 @@ namespace carto {
             g_px1ab[x2 * 2 + 1] = x1b;
         }
     
+        // Use the specialized loop for the common RGBA case
+        if (_bytesPerPixel == 4) {
+            resampleRGBABitmap(dsrc, _width, _height, ddest, width, height, bUpsampleY, fh, weight_shift, g_px1ab);
+            return std::make_shared<Bitmap>(pixelData.data(), width, height, _colorFormat, -static_cast<int>(width * _bytesPerPixel));
+        }
+
         // For every output pixel
         for (std::size_t y2 = 0; y2 < height; y2++) {
             // Find the y-range of input pixels that will contribute:
@@ -395,39 +630,37 @@ namespace carto {
     
     std::shared_ptr<Bitmap> Bitmap::getRGBABitmap() const {
         std::vector<unsigned char> pixelData(_width * _height * 4, 255);
+
+        // Use the vectorized kernels for the common whole-frame conversions,
+        // fall back to the generic per-pixel loop for the rest
+        switch (_colorFormat) {
+        case ColorFormat::COLOR_FORMAT_GRAYSCALE:
+            expandGrayscaleToRGBA(_pixelData.data(), pixelData.data(), _width * _height);
+            return std::make_shared<Bitmap>(pixelData.data(), _width, _height, ColorFormat::COLOR_FORMAT_RGBA, -static_cast<int>(_width * 4));
+        case ColorFormat::COLOR_FORMAT_RGB:
+            expandRGBToRGBA(_pixelData.data(), pixelData.data(), _width * _height);
+            return std::make_shared<Bitmap>(pixelData.data(), _width, _height, ColorFormat::COLOR_FORMAT_RGBA, -static_cast<int>(_width * 4));
+        case ColorFormat::COLOR_FORMAT_RGBA:
+            std::copy(_pixelData.begin(), _pixelData.end(), pixelData.begin());
+            return std::make_shared<Bitmap>(pixelData.data(), _width, _height, ColorFormat::COLOR_FORMAT_RGBA, -static_cast<int>(_width * 4));
+        case ColorFormat::COLOR_FORMAT_BGRA:
+            swizzleBGRAToRGBA(_pixelData.data(), pixelData.data(), _width * _height);
+            return std::make_shared<Bitmap>(pixelData.data(), _width, _height, ColorFormat::COLOR_FORMAT_RGBA, -static_cast<int>(_width * 4));
+        default:
+            break;
+        }
+
         for (unsigned int i = 0; i < _height; i++) {
             for (unsigned int j = 0; j < _width; j++) {
                 unsigned int destIndex = (i * _width + j) * 4;
                 unsigned int srcIndex = (i * _width + j) * _bytesPerPixel;
                 switch (_colorFormat) {
-                case ColorFormat::COLOR_FORMAT_GRAYSCALE:
-                    pixelData[destIndex + 0] = _pixelData[srcIndex];
-                    pixelData[destIndex + 1] = _pixelData[srcIndex];
-                    pixelData[destIndex + 2] = _pixelData[srcIndex];
-                    break;
                 case ColorFormat::COLOR_FORMAT_GRAYSCALE_ALPHA:
                     pixelData[destIndex + 0] = _pixelData[srcIndex];
                     pixelData[destIndex + 1] = _pixelData[srcIndex];
                     pixelData[destIndex + 2] = _pixelData[srcIndex];
                     pixelData[destIndex + 3] = _pixelData[srcIndex + 1];
                     break;
-                case ColorFormat::COLOR_FORMAT_RGB:
-                    pixelData[destIndex + 0] = _pixelData[srcIndex + 0];
-                    pixelData[destIndex + 1] = _pixelData[srcIndex + 1];
-                    pixelData[destIndex + 2] = _pixelData[srcIndex + 2];
-                    break;
-                case ColorFormat::COLOR_FORMAT_RGBA:
-                    pixelData[destIndex + 0] = _pixelData[srcIndex + 0];
-                    pixelData[destIndex + 1] = _pixelData[srcIndex + 1];
-                    pixelData[destIndex + 2] = _pixelData[srcIndex + 2];
-                    pixelData[destIndex + 3] = _pixelData[srcIndex + 3];
-                    break;
-                case ColorFormat::COLOR_FORMAT_BGRA:
-                    pixelData[destIndex + 0] = _pixelData[srcIndex + 2];
-                    pixelData[destIndex + 1] = _pixelData[srcIndex + 1];
-                    pixelData[destIndex + 2] = _pixelData[srcIndex + 0];
-                    pixelData[destIndex + 3] = _pixelData[srcIndex + 3];
-                    break;
                 case ColorFormat::COLOR_FORMAT_RGBA_4444:
                     {
                         unsigned short color = *reinterpret_cast<const unsigned short*>(&_pixelData[srcIndex]);
@@ -478,28 +711,49 @@ namespace carto {
     }
 
     std::shared_ptr<Bitmap> Bitmap::CreateFromCompressed(const unsigned char* compressedData, std::size_t dataSize) {
+        return CreateFromCompressed(compressedData, dataSize, 0, 0);
+    }
+
+    std::shared_ptr<Bitmap> Bitmap::CreateFromCompressed(const std::shared_ptr<BinaryData>& compressedData, unsigned int maxWidth, unsigned int maxHeight) {
+        if (!compressedData) {
+            throw NullArgumentException("Null compressedData");
+        }
+        return CreateFromCompressed(compressedData->data(), compressedData->size(), maxWidth, maxHeight);
+    }
+
+    std::shared_ptr<Bitmap> Bitmap::CreateFromCompressed(const unsigned char* compressedData, std::size_t dataSize, unsigned int maxWidth, unsigned int maxHeight) {
         if (!compressedData) {
             throw NullArgumentException("Null compressedData");
         }
         std::shared_ptr<Bitmap> bitmap(new Bitmap);
-        if (!bitmap->loadFromCompressedBytes(compressedData, dataSize)) {
+        if (!bitmap->loadFromCompressedBytes(compressedData, dataSize, maxWidth, maxHeight)) {
             return std::shared_ptr<Bitmap>();
         }
+
+        // Codec-level downsampling works at fixed ratios and is not supported by all
+        // formats, resize the decoded bitmap if it is still larger than the target size
+        if (maxWidth > 0 && maxHeight > 0 && (bitmap->getWidth() > maxWidth || bitmap->getHeight() > maxHeight)) {
+            double scale = std::min(static_cast<double>(maxWidth) / bitmap->getWidth(), static_cast<double>(maxHeight) / bitmap->getHeight());
+            unsigned int width = std::max(1U, static_cast<unsigned int>(bitmap->getWidth() * scale + 0.5));
+            unsigned int height = std::max(1U, static_cast<unsigned int>(bitmap->getHeight() * scale + 0.5));
+            bitmap = bitmap->getResizedBitmap(width, height);
+        }
         return bitmap;
     }
-    
+
     Bitmap::Bitmap() :
         _width(0),
         _height(0),
         _bytesPerPixel(0),
         _colorFormat(ColorFormat::COLOR_FORMAT_UNSUPPORTED),
-        _pixelData()
+        _pixelData(),
+        _contentHash(0)
     {
     }
 
-    bool Bitmap::loadFromCompressedBytes(const unsigned char* compressedData, std::size_t dataSize) {
+    bool Bitmap::loadFromCompressedBytes(const unsigned char* compressedData, std::size_t dataSize, unsigned int maxWidth, unsigned int maxHeight) {
         if (IsJPEG(compressedData, dataSize)) {
-            return loadJPEG(compressedData, dataSize);
+            return loadJPEG(compressedData, dataSize, maxWidth, maxHeight);
         } else if (IsPNG(compressedData, dataSize)) {
             return loadPNG(compressedData, dataSize);
         } else if (IsWEBP(compressedData, dataSize)) {
@@ -510,7 +764,7 @@ namespace carto {
             std::vector<unsigned char> uncompressedData;
             if (zlib::inflate_gzip(compressedData, dataSize, uncompressedData)) {
                 Log::Info("Bitmap::loadFromCompressedBytes: Image is gzipped, decompressing");
-                return loadFromCompressedBytes(uncompressedData.data(), uncompressedData.size());
+                return loadFromCompressedBytes(uncompressedData.data(), uncompressedData.size(), maxWidth, maxHeight);
             } else {
                 Log::Error("Bitmap::loadFromCompressedBytes: Unsupported image format");
                 return false;
@@ -556,6 +810,7 @@ namespace carto {
             
         // Allocate space
         _pixelData.resize(_width * _height * _bytesPerPixel);
+        MemoryStats::Allocated(MemoryStats::SUBSYSTEM_BITMAP, _pixelData.capacity());
     
         // Copy data from pixelData to _pixelData
         unsigned int newBytesPerRow = _width * _bytesPerPixel;
@@ -564,6 +819,11 @@ namespace carto {
         if (convert) {
             for (unsigned int i = 0; i < _height; i++) {
                 unsigned int flippedI = (_height - 1 - i);
+                if (_colorFormat == ColorFormat::COLOR_FORMAT_BGRA) {
+                    const unsigned char* srcRow = pixelData + (bytesPerRow < 0 ? flippedI : i) * std::abs(bytesPerRow);
+                    swizzleBGRAToRGBA(srcRow, &_pixelData[flippedI * newBytesPerRow], _width);
+                    continue;
+                }
                 for (unsigned int j = 0; j < newActualBytesPerRow; j += _bytesPerPixel) {
                     unsigned int destIndex = flippedI * newBytesPerRow + j;
                     unsigned int srcIndex = (bytesPerRow < 0 ? flippedI : i) * std::abs(bytesPerRow) + j;
@@ -636,9 +896,30 @@ namespace carto {
             }
         }
         
+        updateContentHash();
         return true;
     }
-    
+
+    void Bitmap::updateContentHash() {
+        // FNV-1a over the pixel data, seeded with the bitmap parameters. The hash is
+        // calculated once per bitmap, so that bitmaps with equal contents can be
+        // detected later without comparing or rehashing the pixel data.
+        std::uint64_t hash = 0xcbf29ce484222325ULL;
+        auto combine = [&hash](std::uint64_t value) {
+            for (int i = 0; i < 8; i++) {
+                hash = (hash ^ ((value >> (i * 8)) & 0xff)) * 0x100000001b3ULL;
+            }
+        };
+        combine(_width);
+        combine(_height);
+        combine(_bytesPerPixel);
+        combine(static_cast<std::uint64_t>(_colorFormat));
+        for (unsigned char component : _pixelData) {
+            hash = (hash ^ component) * 0x100000001b3ULL;
+        }
+        _contentHash = static_cast<long long>(hash);
+    }
+
     bool Bitmap::IsJPEG(const unsigned char* compressedData, std::size_t dataSize) {
         if (dataSize < 4) {
             return false;
@@ -661,7 +942,7 @@ namespace carto {
         return std::equal(NUTiHeader, NUTiHeader + sizeof(NUTiHeader), compressedData);
     }
         
-    bool Bitmap::loadJPEG(const unsigned char* compressedData, std::size_t dataSize) {
+    bool Bitmap::loadJPEG(const unsigned char* compressedData, std::size_t dataSize, unsigned int maxWidth, unsigned int maxHeight) {
         jpeg_decompress_struct cinfo;
         JPEGErrorManager jerr;
         cinfo.err = jpeg_std_error(&jerr.pub);
@@ -681,6 +962,21 @@ namespace carto {
     
         // Read headers, prepare to decompress
         jpeg_read_header(&cinfo, TRUE);
+
+        // If a smaller target size is requested, let the codec downsample the image while
+        // decoding. The codec supports power-of-two ratios up to 1/8, the smallest ratio
+        // that still keeps the image at least as large as the target size is used.
+        if (maxWidth > 0 && maxHeight > 0) {
+            cinfo.scale_num = 1;
+            cinfo.scale_denom = 1;
+            for (unsigned int denom = 2; denom <= 8; denom *= 2) {
+                if ((cinfo.image_width + denom - 1) / denom < maxWidth || (cinfo.image_height + denom - 1) / denom < maxHeight) {
+                    break;
+                }
+                cinfo.scale_denom = denom;
+            }
+        }
+
         jpeg_start_decompress(&cinfo);
     
         _width = cinfo.output_width;
@@ -702,7 +998,8 @@ namespace carto {
         _bytesPerPixel = cinfo.output_components;
         int bytesPerRow = _width * _bytesPerPixel;
         _pixelData.resize(bytesPerRow * _height);
-    
+        MemoryStats::Allocated(MemoryStats::SUBSYSTEM_BITMAP, _pixelData.capacity());
+
         // Read lines, flip y
         while (cinfo.output_scanline < _height) {
             unsigned char* pixelDataPtr = &_pixelData[(_height - 1 - cinfo.output_scanline) * bytesPerRow];
@@ -712,7 +1009,8 @@ namespace carto {
         // Finish and free the memory
         jpeg_finish_decompress(&cinfo);
         jpeg_destroy_decompress(&cinfo);
-    
+
+        updateContentHash();
         return true;
     }
     
@@ -819,6 +1117,7 @@ namespace carto {
     
         // Allocate the image_data as a big block, to be given to opengl
         _pixelData.resize(bytesPerRow * _height);
+        MemoryStats::Allocated(MemoryStats::SUBSYSTEM_BITMAP, _pixelData.capacity());
         unsigned char* pixelDataPtr = _pixelData.data();
     
         // Set row start pointers
@@ -834,50 +1133,66 @@ namespace carto {
     
         if (premultiply) {
             // Premultiply alpha
-            for (std::size_t i = 0; i < _pixelData.size(); i += _bytesPerPixel) {
-                for (std::size_t j = 0; j < _bytesPerPixel - 1; j++) {
-                    _pixelData[i + j] = (_pixelData[i + j] * _pixelData[i + _bytesPerPixel - 1]) / 255;
+            if (_colorFormat == ColorFormat::COLOR_FORMAT_RGBA) {
+                premultiplyAlphaRGBA(_pixelData.data(), _width * _height);
+            } else {
+                for (std::size_t i = 0; i < _pixelData.size(); i += _bytesPerPixel) {
+                    for (std::size_t j = 0; j < _bytesPerPixel - 1; j++) {
+                        _pixelData[i + j] = (_pixelData[i + j] * _pixelData[i + _bytesPerPixel - 1]) / 255;
+                    }
                 }
             }
         }
     
         // Free memory
         png_destroy_read_struct(&pngPtr, &infoPtr, &endInfo);
-    
+
+        updateContentHash();
         return true;
     }
         
     bool Bitmap::loadWEBP(const unsigned char* compressedData, std::size_t dataSize) {
-        WebPBitstreamFeatures features;
-        if (WebPGetFeatures(compressedData, dataSize, &features) != VP8_STATUS_OK) {
+        WebPDecoderConfig config;
+        if (!WebPInitDecoderConfig(&config)) {
+            Log::Error("Bitmap::loadWEBP: Failed to initialize WEBP decoder");
+            return false;
+        }
+        if (WebPGetFeatures(compressedData, dataSize, &config.input) != VP8_STATUS_OK) {
             Log::Error("Bitmap::loadWEBP: Failed to load WEBP features");
             return false;
         }
-        
-        _width = features.width;
-        _height = features.height;
-    
-        unsigned char* decodedData;
-        if (features.has_alpha) {
+
+        _width = config.input.width;
+        _height = config.input.height;
+
+        if (config.input.has_alpha) {
             _bytesPerPixel = 4;
             _colorFormat = ColorFormat::COLOR_FORMAT_RGBA;
-            decodedData = WebPDecodeRGBA(compressedData, dataSize, NULL, NULL);
+            config.output.colorspace = MODE_RGBA;
         } else {
             _bytesPerPixel = 3;
             _colorFormat = ColorFormat::COLOR_FORMAT_RGB;
-            decodedData = WebPDecodeRGB(compressedData, dataSize, NULL, NULL);
+            config.output.colorspace = MODE_RGB;
         }
-        
+
         unsigned int bytesPerRow = _width * _bytesPerPixel;
         _pixelData.resize(_height * bytesPerRow);
-        for (unsigned int i = 0; i < _height; i++) {
-            for (unsigned int j = 0; j < bytesPerRow; j++) {
-                _pixelData[(_height - i - 1) * bytesPerRow + j] = decodedData[i * bytesPerRow + j];
-            }
+        MemoryStats::Allocated(MemoryStats::SUBSYSTEM_BITMAP, _pixelData.capacity());
+
+        // Decode directly into the pixel buffer, letting the codec flip the rows
+        // to the internal bottom-up order. This avoids a separate full-frame copy
+        // from a codec-owned buffer for every decoded bitmap.
+        config.options.flip = 1;
+        config.output.u.RGBA.rgba = _pixelData.data();
+        config.output.u.RGBA.stride = static_cast<int>(bytesPerRow);
+        config.output.u.RGBA.size = _pixelData.size();
+        config.output.is_external_memory = 1;
+        if (WebPDecode(compressedData, dataSize, &config) != VP8_STATUS_OK) {
+            Log::Error("Bitmap::loadWEBP: Failed to decode WEBP data");
+            return false;
         }
-        
-        WebPFree(decodedData);
-        
+
+        updateContentHash();
         return true;
     }
     
@@ -894,11 +1209,13 @@ namespace carto {
     
         unsigned int bytesPerRow = _width * _bytesPerPixel;
         _pixelData.resize(_height * bytesPerRow);
+        MemoryStats::Allocated(MemoryStats::SUBSYSTEM_BITMAP, _pixelData.capacity());
         for (unsigned int i = 0; i < _height; i++) {
             const unsigned char* row = &compressedData[offset + i * bytesPerRow];
             std::copy(row, row + bytesPerRow, &_pixelData[i * bytesPerRow]);
         }
-    
+
+        updateContentHash();
         return true;
     }
         
@@ -113,7 +113,15 @@ namespace carto {
          * @return The bytes per pixel parameter of this bitmap.
          */
         unsigned int getBytesPerPixel() const;
-    
+
+        /**
+         * Returns the hash calculated from the contents of this bitmap.
+         * The hash is calculated once, when the bitmap is constructed. Bitmaps with
+         * equal dimensions, color format and pixel data have equal content hashes.
+         * @return The 64-bit hash of the bitmap contents.
+         */
+        long long getContentHash() const;
+
         /**
          * Returns the pixel data of this bitmap.
          * @return A byte vector of the bitmap's pixel data.
@@ -188,20 +196,48 @@ namespace carto {
          * @return The bitmap created from the compressed data. If the decompression fails, null is returned.
          */
         static std::shared_ptr<Bitmap> CreateFromCompressed(const unsigned char* compressedData, std::size_t dataSize);
-        
+
+        /**
+         * Creates a new bitmap from compressed byte vector, downsampling the image to the given maximum size.
+         * For JPEG images the downsampling is done by the codec while decoding, so large images can be
+         * loaded at a fraction of the full decode cost. Other formats are decoded at full resolution
+         * and then resized.
+         * If the power of two conversion flag is set, additional padding will be added to the image to make it's dimensions power of two.
+         * @param compressedData The compressed bitmap data.
+         * @param maxWidth The maximum width of the created bitmap. Use 0 for unconstrained width.
+         * @param maxHeight The maximum height of the created bitmap. Use 0 for unconstrained height.
+         * @return The bitmap created from the compressed data. If the decompression fails, null is returned.
+         */
+        static std::shared_ptr<Bitmap> CreateFromCompressed(const std::shared_ptr<BinaryData>& compressedData, unsigned int maxWidth, unsigned int maxHeight);
+        /**
+         * Creates a new bitmap from compressed byte data, downsampling the image to the given maximum size.
+         * For JPEG images the downsampling is done by the codec while decoding, so large images can be
+         * loaded at a fraction of the full decode cost. Other formats are decoded at full resolution
+         * and then resized.
+         * If the power of two conversion flag is set, additional padding will be added to the image to make it's dimensions power of two.
+         * @param compressedData The compressed bitmap data.
+         * @param dataSize size of the compressed data.
+         * @param maxWidth The maximum width of the created bitmap. Use 0 for unconstrained width.
+         * @param maxHeight The maximum height of the created bitmap. Use 0 for unconstrained height.
+         * @return The bitmap created from the compressed data. If the decompression fails, null is returned.
+         */
+        static std::shared_ptr<Bitmap> CreateFromCompressed(const unsigned char* compressedData, std::size_t dataSize, unsigned int maxWidth, unsigned int maxHeight);
+
     protected:
         Bitmap();
-        
-        bool loadFromCompressedBytes(const unsigned char* compressedData, std::size_t dataSize);
+
+        bool loadFromCompressedBytes(const unsigned char* compressedData, std::size_t dataSize, unsigned int maxWidth, unsigned int maxHeight);
         bool loadFromUncompressedBytes(const unsigned char* pixelData, unsigned int width, unsigned int height,
                                        ColorFormat::ColorFormat colorFormat, int bytesPerRow);
-    
+
+        void updateContentHash();
+
         static bool IsJPEG(const unsigned char* compressedData, std::size_t dataSize);
         static bool IsPNG(const unsigned char* compressedData, std::size_t dataSize);
         static bool IsWEBP(const unsigned char* compressedData, std::size_t dataSize);
         static bool IsNUTI(const unsigned char* compressedData, std::size_t dataSize);
     
-        bool loadJPEG(const unsigned char* compressedData, std::size_t dataSize);
+        bool loadJPEG(const unsigned char* compressedData, std::size_t dataSize, unsigned int maxWidth, unsigned int maxHeight);
         bool loadPNG(const unsigned char* compressedData, std::size_t dataSize);
         bool loadWEBP(const unsigned char* compressedData, std::size_t dataSize);
         bool loadNUTI(const unsigned char* compressedData, std::size_t dataSize);
@@ -215,6 +251,8 @@ namespace carto {
         ColorFormat::ColorFormat _colorFormat;
     
         std::vector<unsigned char> _pixelData;
+
+        long long _contentHash;
     };
     
 }
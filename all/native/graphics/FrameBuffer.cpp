@@ -144,23 +144,4 @@ namespace carto {
         }
     }
 
-    void FrameBuffer::destroy() const {
-        if (_fboId != 0) {
-            glDeleteFramebuffers(1, &_fboId);
-            _fboId = 0;
-
-            if (!_depthStencilRBIds.empty()) {
-                glDeleteRenderbuffers(static_cast<int>(_depthStencilRBIds.size()), _depthStencilRBIds.data());
-                _depthStencilRBIds.clear();
-            }
-
-            if (_colorTexId != 0) {
-                glDeleteTextures(1, &_colorTexId);
-                _colorTexId = 0;
-            }
-
-            GLContext::CheckGLError("FrameBuffer::destroy");
-        }
-    }
-    
 }
@@ -37,7 +37,6 @@ namespace carto {
         FrameBuffer(const std::shared_ptr<FrameBufferManager>& frameBufferManager, int width, int height, bool color, bool depth, bool stencil);
 
         void create() const;
-        void destroy() const;
 
     private:
         int _width;
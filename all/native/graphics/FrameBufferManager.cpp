@@ -80,18 +80,14 @@ namespace carto {
         std::lock_guard<std::mutex> lock(_mutex);
 
         if (frameBuffer) {
-            if (std::this_thread::get_id() == _glThreadId) {
-                frameBuffer->destroy();
+            // Queue the resources for deletion, the queues are flushed in per-frame batches
+            if (frameBuffer->_fboId != 0) {
+                _deleteFBOIdQueue.push_back(frameBuffer->_fboId);
             }
-            else {
-                if (frameBuffer->_fboId != 0) {
-                    _deleteFBOIdQueue.push_back(frameBuffer->_fboId);
-                }
-                if (frameBuffer->_colorTexId != 0) {
-                    _deleteTexIdQueue.push_back(frameBuffer->_colorTexId);
-                }
-                _deleteRBIdQueue.insert(_deleteRBIdQueue.end(), frameBuffer->_depthStencilRBIds.begin(), frameBuffer->_depthStencilRBIds.end());
+            if (frameBuffer->_colorTexId != 0) {
+                _deleteTexIdQueue.push_back(frameBuffer->_colorTexId);
             }
+            _deleteRBIdQueue.insert(_deleteRBIdQueue.end(), frameBuffer->_depthStencilRBIds.begin(), frameBuffer->_depthStencilRBIds.end());
             delete frameBuffer;
         }
     }
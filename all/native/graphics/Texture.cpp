@@ -40,6 +40,7 @@ namespace carto {
 
     Texture::Texture(const std::shared_ptr<TextureManager>& textureManager, const std::shared_ptr<Bitmap>& bitmap, bool genMipmaps, bool repeat) :
         _bitmap(bitmap),
+        _mipmapBitmaps(),
         _mipmaps(genMipmaps),
         _repeat(repeat),
         _sizeInBytes(0),
@@ -63,6 +64,19 @@ namespace carto {
         }
 
         _sizeInBytes = static_cast<std::size_t>((_mipmaps ? MIPMAP_SIZE_MULTIPLIER : 1.0) * _bitmap->getWidth() * _bitmap->getHeight() * _bitmap->getBytesPerPixel());
+
+        // Generate the mip chain already on the calling thread with a box downsample,
+        // so that the GL thread only has to upload the prebuilt levels
+        if (_mipmaps) {
+            std::shared_ptr<Bitmap> mipmapBitmap = _bitmap;
+            while (mipmapBitmap->getWidth() > 1 || mipmapBitmap->getHeight() > 1) {
+                mipmapBitmap = mipmapBitmap->getResizedBitmap(std::max(mipmapBitmap->getWidth() / 2, 1U), std::max(mipmapBitmap->getHeight() / 2, 1U));
+                if (!mipmapBitmap) {
+                    break;
+                }
+                _mipmapBitmaps.push_back(mipmapBitmap);
+            }
+        }
     }
 
     void Texture::load() const {
@@ -71,15 +85,6 @@ namespace carto {
         }
     }
 
-    void Texture::unload() const {
-        if (_texId != 0) {
-            glDeleteTextures(1, &_texId);
-            _texId = 0;
-
-            GLContext::CheckGLError("Texture::unload");
-        }
-    }
-    
     GLuint Texture::loadFromBitmap(const Bitmap& bitmap, bool genMipmaps, bool repeat) const {
         if (bitmap.getColorFormat() == ColorFormat::COLOR_FORMAT_UNSUPPORTED) {
             Log::Error("Texture::loadFromBitmap: Failed to create texture from bitmap, unsupported color format");
@@ -88,9 +93,13 @@ namespace carto {
 
         GLint oldTexId = 0;
         glGetIntegerv(GL_TEXTURE_BINDING_2D, &oldTexId);
-        
-        GLuint texId = 0;
-        glGenTextures(1, &texId);
+
+        // Try to reuse a recycled texture object with matching dimensions and format,
+        // as respecifying its storage is much cheaper for the driver than a fresh allocation
+        GLuint texId = _textureManager->reserveTexId(TextureManager::TexturePoolKey(bitmap.getWidth(), bitmap.getHeight(), bitmap.getColorFormat(), genMipmaps, repeat));
+        if (texId == 0) {
+            glGenTextures(1, &texId);
+        }
         glBindTexture(GL_TEXTURE_2D, texId);
     
         const std::vector<unsigned char>& pixelData = bitmap.getPixelData();
@@ -119,8 +128,17 @@ namespace carto {
                     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, std::min(MAX_ANISOTROPY, deviceMaxAnisotropy));
                 }
             }
-    
-            glGenerateMipmap(GL_TEXTURE_2D);
+
+            // Upload the prebuilt mip levels, this avoids stalling the GL thread with glGenerateMipmap
+            if (!_mipmapBitmaps.empty()) {
+                for (std::size_t i = 0; i < _mipmapBitmaps.size(); i++) {
+                    const Bitmap& mipmapBitmap = *_mipmapBitmaps[i];
+                    glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(i + 1), mipmapBitmap.getColorFormat(), mipmapBitmap.getWidth(), mipmapBitmap.getHeight(),
+                            0, mipmapBitmap.getColorFormat(), GL_UNSIGNED_BYTE, mipmapBitmap.getPixelData().data());
+                }
+            } else {
+                glGenerateMipmap(GL_TEXTURE_2D);
+            }
         }
 
         glBindTexture(GL_TEXTURE_2D, oldTexId);
@@ -10,6 +10,7 @@
 #include "graphics/utils/GLContext.h"
 
 #include <memory>
+#include <vector>
 
 #include <cglib/vec.h>
 
@@ -37,7 +38,6 @@ namespace carto {
         Texture(const std::shared_ptr<TextureManager>& textureManager, const std::shared_ptr<Bitmap>& bitmap, bool genMipmaps, bool repeat);
 
         void load() const;
-        void unload() const;
 
     private:
         static const int MAX_ANISOTROPY;
@@ -45,8 +45,9 @@ namespace carto {
         static const double MIPMAP_SIZE_MULTIPLIER;
     
         GLuint loadFromBitmap(const Bitmap& bitmap, bool genMipmaps, bool repeat) const;
-        
+
         std::shared_ptr<Bitmap> _bitmap;
+        std::vector<std::shared_ptr<Bitmap> > _mipmapBitmaps;
         bool _mipmaps;
         bool _repeat;
         
@@ -1,4 +1,5 @@
 #include "TextureManager.h"
+#include "graphics/Bitmap.h"
 #include "graphics/Texture.h"
 #include "utils/Log.h"
 
@@ -8,6 +9,9 @@ namespace carto {
         _glThreadId(),
         _createQueue(),
         _deleteTexIdQueue(),
+        _recycleTexIdQueue(),
+        _texIdPool(),
+        _texIdPoolClearPending(false),
         _mutex()
     {
     }
@@ -40,14 +44,46 @@ namespace carto {
         return texture;
     }
 
-    void TextureManager::processTextures() {
+    void TextureManager::clearTexturePool() {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _texIdPoolClearPending = true;
+    }
+
+    bool TextureManager::processTextures() {
         std::vector<std::weak_ptr<Texture> > createQueue;
+        bool texturesPending = false;
         {
             std::lock_guard<std::mutex> lock(_mutex);
 
             if (std::this_thread::get_id() != _glThreadId) {
                 Log::Warn("TextureManager::processTextures: Method called from wrong thread!");
-                return;
+                return false;
+            }
+
+            // Move recycled texture objects to the pool, evict the overflow into the delete batch
+            for (const std::pair<TexturePoolKey, GLuint>& recycledTexId : _recycleTexIdQueue) {
+                _texIdPool[recycledTexId.first].push_back(recycledTexId.second);
+            }
+            _recycleTexIdQueue.clear();
+            if (_texIdPoolClearPending) {
+                for (auto it = _texIdPool.begin(); it != _texIdPool.end(); it++) {
+                    _deleteTexIdQueue.insert(_deleteTexIdQueue.end(), it->second.begin(), it->second.end());
+                }
+                _texIdPool.clear();
+                _texIdPoolClearPending = false;
+            }
+            std::size_t pooledCount = 0;
+            for (auto it = _texIdPool.begin(); it != _texIdPool.end(); it++) {
+                pooledCount += it->second.size();
+            }
+            for (auto it = _texIdPool.begin(); it != _texIdPool.end() && pooledCount > MAX_POOLED_TEXTURES; ) {
+                while (!it->second.empty() && pooledCount > MAX_POOLED_TEXTURES) {
+                    _deleteTexIdQueue.push_back(it->second.back());
+                    it->second.pop_back();
+                    pooledCount--;
+                }
+                it = (it->second.empty() ? _texIdPool.erase(it) : ++it);
             }
 
             if (!_deleteTexIdQueue.empty()) {
@@ -55,31 +91,61 @@ namespace carto {
                 _deleteTexIdQueue.clear();
             }
 
-            for (const std::weak_ptr<Texture>& textureWeak : _createQueue) {
-                if (auto texture = textureWeak.lock()) {
+            // Upload textures in creation order, but limit the amount of data uploaded during
+            // a single frame. The remaining textures are uploaded during subsequent frames,
+            // textures that get drawn before that are loaded on demand.
+            std::size_t uploadedBytes = 0;
+            std::size_t uploadedCount = 0;
+            while (uploadedCount < _createQueue.size()) {
+                if (auto texture = _createQueue[uploadedCount].lock()) {
+                    if (uploadedBytes > 0 && uploadedBytes + texture->getSize() > MAX_UPLOAD_BYTES_PER_FRAME) {
+                        break;
+                    }
                     texture->load();
+                    uploadedBytes += texture->getSize();
                 }
+                uploadedCount++;
             }
-            std::swap(createQueue, _createQueue); // release the textures only after lock is released
+            createQueue.assign(_createQueue.begin(), _createQueue.begin() + uploadedCount); // release the textures only after lock is released
+            _createQueue.erase(_createQueue.begin(), _createQueue.begin() + uploadedCount);
+            texturesPending = !_createQueue.empty();
         }
 
         GLContext::CheckGLError("TextureManager::processTextures");
+        return texturesPending;
+    }
+
+    GLuint TextureManager::reserveTexId(const TexturePoolKey& key) {
+        auto it = _texIdPool.find(key);
+        if (it == _texIdPool.end() || it->second.empty()) {
+            return 0;
+        }
+        GLuint texId = it->second.back();
+        it->second.pop_back();
+        return texId;
     }
 
     void TextureManager::deleteTexture(Texture* texture) {
         std::lock_guard<std::mutex> lock(_mutex);
 
         if (texture) {
-            if (std::this_thread::get_id() == _glThreadId) {
-                texture->unload();
-            }
-            else {
-                if (texture->_texId != 0) {
-                    _deleteTexIdQueue.push_back(texture->_texId);
+            if (texture->_texId != 0) {
+                // Recycle the texture object instead of deleting it. Tile textures share
+                // dimensions and formats, so pooling avoids constant driver-level reallocation.
+                TexturePoolKey key(texture->_bitmap->getWidth(), texture->_bitmap->getHeight(), texture->_bitmap->getColorFormat(), texture->_mipmaps, texture->_repeat);
+                if (std::this_thread::get_id() == _glThreadId) {
+                    _texIdPool[key].push_back(texture->_texId);
+                }
+                else {
+                    _recycleTexIdQueue.emplace_back(key, texture->_texId);
                 }
             }
             delete texture;
         }
     }
 
+    const std::size_t TextureManager::MAX_UPLOAD_BYTES_PER_FRAME = 16 * 1024 * 1024;
+
+    const std::size_t TextureManager::MAX_POOLED_TEXTURES = 32;
+
 }
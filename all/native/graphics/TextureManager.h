@@ -9,9 +9,12 @@
 
 #include "graphics/Texture.h"
 
+#include <map>
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 namespace carto {
@@ -23,17 +26,42 @@ namespace carto {
 
         std::thread::id getGLThreadId() const;
         void setGLThreadId(std::thread::id id);
-    
+
         std::shared_ptr<Texture> createTexture(const std::shared_ptr<Bitmap>& bitmap, bool genMipmaps, bool repeat);
 
-        void processTextures();
-    
+        void clearTexturePool();
+
+        bool processTextures();
+
     private:
+        friend class Texture;
+
+        struct TexturePoolKey {
+            int width;
+            int height;
+            GLint format;
+            bool mipmaps;
+            bool repeat;
+
+            TexturePoolKey(int width, int height, GLint format, bool mipmaps, bool repeat) : width(width), height(height), format(format), mipmaps(mipmaps), repeat(repeat) { }
+
+            bool operator < (const TexturePoolKey& key) const {
+                return std::tie(width, height, format, mipmaps, repeat) < std::tie(key.width, key.height, key.format, key.mipmaps, key.repeat);
+            }
+        };
+
+        GLuint reserveTexId(const TexturePoolKey& key); // NOTE: must be called from the GL thread
         void deleteTexture(Texture* texture);
 
+        static const std::size_t MAX_UPLOAD_BYTES_PER_FRAME;
+        static const std::size_t MAX_POOLED_TEXTURES;
+
         std::thread::id _glThreadId;
         std::vector<std::weak_ptr<Texture> > _createQueue;
         std::vector<GLuint> _deleteTexIdQueue;
+        std::vector<std::pair<TexturePoolKey, GLuint> > _recycleTexIdQueue;
+        std::map<TexturePoolKey, std::vector<GLuint> > _texIdPool; // accessed only from the GL thread
+        bool _texIdPoolClearPending;
         mutable std::mutex _mutex;
     };
     
@@ -51,9 +51,11 @@ namespace carto {
         _projectionMat(),
         _modelviewMat(),
         _modelviewProjectionMat(),
+        _invModelviewProjectionMat(),
         _rteModelviewMat(),
         _rteModelviewProjectionMat(),
         _rteSkyProjectionMat(),
+        _cameraGeneration(0),
         _horizontalLayerOffsetDir(0)
     {
     }
@@ -248,6 +250,10 @@ namespace carto {
         return _modelviewProjectionMat;
     }
     
+    const cglib::mat4x4<double>& ViewState::getInvModelviewProjectionMat() const {
+        return _invModelviewProjectionMat;
+    }
+
     const cglib::mat4x4<float>& ViewState::getRTEModelviewMat() const {
         return _rteModelviewMat;
     }
@@ -263,7 +269,11 @@ namespace carto {
     const cglib::frustum3<double>& ViewState::getFrustum() const {
         return _frustum;
     }
-    
+
+    unsigned int ViewState::getCameraGeneration() const {
+        return _cameraGeneration;
+    }
+
     int ViewState::getScreenWidth() const {
         return _width;
     }
@@ -307,10 +317,11 @@ namespace carto {
     }
 
     void ViewState::clampFocusPos(const Options& options) {
-        bool seamlessPanning = options.isSeamlessPanning();
-        bool restrictedPanning = options.isRestrictedPanning();
-        RenderProjectionMode::RenderProjectionMode renderProjectionMode = options.getRenderProjectionMode();
-        std::shared_ptr<ProjectionSurface> projectionSurface = options.getProjectionSurface();
+        std::shared_ptr<const Options::Snapshot> optionsSnapshot = options.getSnapshot();
+        bool seamlessPanning = optionsSnapshot->seamlessPanning;
+        bool restrictedPanning = optionsSnapshot->restrictedPanning;
+        RenderProjectionMode::RenderProjectionMode renderProjectionMode = optionsSnapshot->renderProjectionMode;
+        std::shared_ptr<ProjectionSurface> projectionSurface = optionsSnapshot->projectionSurface;
         
         MapBounds mapBounds = options.getAdjustedInternalPanBounds(false);
         MapPos mapPos = projectionSurface->calculateMapPos(_focusPos);
@@ -427,13 +438,16 @@ namespace carto {
     }
     
     void ViewState::calculateViewState(const Options& options) {
-        // If FOV or tile draw size changed, recalculate zoom0Distance
-        std::shared_ptr<ProjectionSurface> projectionSurface = options.getProjectionSurface();
-        int FOVY = options.getFieldOfViewY();
-        int tileDrawSize = options.getTileDrawSize();
-        float dpi = options.getDPI();
-        MapRange zoomRange = options.getZoomRange();
-        bool restrictedPanning = options.isRestrictedPanning();
+        // If FOV or tile draw size changed, recalculate zoom0Distance.
+        // Read all the options from a single snapshot, this gives a consistent
+        // set of values with a single atomic load.
+        std::shared_ptr<const Options::Snapshot> optionsSnapshot = options.getSnapshot();
+        std::shared_ptr<ProjectionSurface> projectionSurface = optionsSnapshot->projectionSurface;
+        int FOVY = optionsSnapshot->fovY;
+        int tileDrawSize = optionsSnapshot->tileDrawSize;
+        float dpi = optionsSnapshot->dpi;
+        MapRange zoomRange = optionsSnapshot->zoomRange;
+        bool restrictedPanning = optionsSnapshot->restrictedPanning;
         if (projectionSurface != _projectionSurface || FOVY != _fovY || tileDrawSize != _tileDrawSize || dpi != _dpi || zoomRange != _zoomRange || restrictedPanning != _restrictedPanning || _screenSizeChanged) {
             _fovY = FOVY;
             _tileDrawSize = tileDrawSize;
@@ -511,8 +525,10 @@ namespace carto {
             _rotationState.xAxis = cglib::vec3<float>::convert(cglib::proj_o(cglib::col_vector(invCameraMatrix, 0)));
             _rotationState.yAxis = cglib::vec3<float>::convert(cglib::proj_o(cglib::col_vector(invCameraMatrix, 1)));
 
-            // Double precision mvp matrix and frustum
+            // Double precision mvp matrix, its inverse and frustum. These are cached here so that
+            // the consumers do not have to recalculate them every time they touch the camera.
             _modelviewProjectionMat = _projectionMat * _modelviewMat;
+            _invModelviewProjectionMat = cglib::inverse(_modelviewProjectionMat);
             _frustum = cglib::gl_projection_frustum(_modelviewProjectionMat);
 
             // Rte modleview matrix only requires float precision
@@ -525,9 +541,11 @@ namespace carto {
             _rteModelviewProjectionMat = cglib::mat4x4<float>::convert(_projectionMat) * _rteModelviewMat;
 
             // Calculate Rte sky matrix
-            float skyFar = _zoom0Distance * options.getDrawDistance();
+            float skyFar = _zoom0Distance * optionsSnapshot->drawDistance;
             cglib::mat4x4<double> skyProjectionMat = calculatePerspMat(_halfFOVY, _near, skyFar, options);
             _rteSkyProjectionMat = cglib::mat4x4<float>::convert(skyProjectionMat) * _rteModelviewMat;
+
+            _cameraGeneration++;
         }
     }
     
@@ -538,15 +556,14 @@ namespace carto {
         }
 
         std::shared_ptr<ProjectionSurface> projectionSurface = _projectionSurface;
-        cglib::mat4x4<double> modelviewProjectionMat = _modelviewProjectionMat;
+        cglib::mat4x4<double> invModelviewProjectionMat = _invModelviewProjectionMat;
         if (options) {
             projectionSurface = options->getProjectionSurface();
-            modelviewProjectionMat = calculateModelViewMat(*options);
+            invModelviewProjectionMat = cglib::inverse(calculateModelViewMat(*options));
         }
         if (!projectionSurface) {
             return cglib::vec3<double>(std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::quiet_NaN());
         }
-        cglib::mat4x4<double> invModelviewProjectionMat = cglib::inverse(modelviewProjectionMat);
 
         // Transform 2 points with different z values from world to screen
         cglib::vec3<double> screenPos0(screenPos(0) / _width * 2 - 1, 1 - screenPos(1) / _height * 2, -1);
@@ -587,7 +604,7 @@ namespace carto {
             return 0;
         }
 
-        cglib::mat4x4<double> invModelviewProjectionMat = cglib::inverse(_modelviewProjectionMat);
+        const cglib::mat4x4<double>& invModelviewProjectionMat = _invModelviewProjectionMat;
 
         // Try consecutive horizontal points
         cglib::vec3<double> worldPos = cglib::vec3<double>::zero();
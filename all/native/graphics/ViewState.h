@@ -261,6 +261,12 @@ namespace carto {
          * @return The modelview-projection matrix.
          */
         const cglib::mat4x4<double>& getModelviewProjectionMat() const;
+        /**
+         * Returns the inverse of the modelview-projection matrix. The inverse is calculated once per camera change
+         * and cached, so this is much cheaper than inverting the modelview-projection matrix at the call site.
+         * @return The inverse of the modelview-projection matrix.
+         */
+        const cglib::mat4x4<double>& getInvModelviewProjectionMat() const;
         /**
          * Returns the relative-to-eye modelview matrix. This equivalent to the modelview matrix with the first
          * three elements of the last column set to 0.
@@ -284,7 +290,15 @@ namespace carto {
          * @return The view frustum.
          */
         const cglib::frustum3<double>& getFrustum() const;
-    
+
+        /**
+         * Returns the camera generation counter. The counter is incremented every time the cached view
+         * matrices are recalculated, thus consumers can compare generations to detect camera changes
+         * instead of comparing the matrices themselves.
+         * @return The camera generation counter.
+         */
+        unsigned int getCameraGeneration() const;
+
         /**
          * Returns the screen width.
          * @return The current screen width.
@@ -422,12 +436,15 @@ namespace carto {
         cglib::mat4x4<double> _projectionMat;
         cglib::mat4x4<double> _modelviewMat;
         cglib::mat4x4<double> _modelviewProjectionMat;
+        cglib::mat4x4<double> _invModelviewProjectionMat;
         cglib::mat4x4<float> _rteModelviewMat;
         cglib::mat4x4<float> _rteModelviewProjectionMat;
         cglib::mat4x4<float> _rteSkyProjectionMat;
 
         cglib::frustum3<double> _frustum;
-    
+
+        unsigned int _cameraGeneration;
+
         int _horizontalLayerOffsetDir;
     };
     
@@ -37,6 +37,10 @@ namespace carto {
 
         DISCARD_FRAMEBUFFER = HasGLExtension("GL_EXT_discard_framebuffer");
 
+        INSTANCED_ARRAYS = HasGLExtension("GL_EXT_instanced_arrays");
+
+        VERTEX_ARRAY_OBJECT = HasGLExtension("GL_OES_vertex_array_object");
+
         PACKED_DEPTH_STENCIL = HasGLExtension("GL_OES_packed_depth_stencil");
 
 #if !defined(__APPLE__) && defined(GL_EXT_discard_framebuffer)
@@ -44,6 +48,31 @@ namespace carto {
             _DiscardFramebufferEXT = reinterpret_cast<PFNGLDISCARDFRAMEBUFFEREXTPROC>(eglGetProcAddress("glDiscardFramebufferEXT"));
         }
 #endif
+
+#if !defined(__APPLE__) && defined(GL_EXT_instanced_arrays)
+        if (INSTANCED_ARRAYS) {
+            _VertexAttribDivisorEXT = reinterpret_cast<PFNGLVERTEXATTRIBDIVISOREXTPROC>(eglGetProcAddress("glVertexAttribDivisorEXT"));
+            _DrawElementsInstancedEXT = reinterpret_cast<PFNGLDRAWELEMENTSINSTANCEDEXTPROC>(eglGetProcAddress("glDrawElementsInstancedEXT"));
+            if (!_VertexAttribDivisorEXT || !_DrawElementsInstancedEXT) {
+                INSTANCED_ARRAYS = false;
+            }
+        }
+#elif !defined(GL_EXT_instanced_arrays)
+        INSTANCED_ARRAYS = false;
+#endif
+
+#if !defined(__APPLE__) && defined(GL_OES_vertex_array_object)
+        if (VERTEX_ARRAY_OBJECT) {
+            _GenVertexArraysOES = reinterpret_cast<PFNGLGENVERTEXARRAYSOESPROC>(eglGetProcAddress("glGenVertexArraysOES"));
+            _BindVertexArrayOES = reinterpret_cast<PFNGLBINDVERTEXARRAYOESPROC>(eglGetProcAddress("glBindVertexArrayOES"));
+            _DeleteVertexArraysOES = reinterpret_cast<PFNGLDELETEVERTEXARRAYSOESPROC>(eglGetProcAddress("glDeleteVertexArraysOES"));
+            if (!_GenVertexArraysOES || !_BindVertexArrayOES || !_DeleteVertexArraysOES) {
+                VERTEX_ARRAY_OBJECT = false;
+            }
+        }
+#elif !defined(GL_OES_vertex_array_object)
+        VERTEX_ARRAY_OBJECT = false;
+#endif
     }
         
     void GLContext::CheckGLError(const char* place) {
@@ -64,6 +93,76 @@ namespace carto {
 #endif
     }
     
+    void GLContext::VertexAttribDivisorEXT(GLuint index, GLuint divisor) {
+        std::lock_guard<std::recursive_mutex> lock(_Mutex);
+
+#ifdef GL_EXT_instanced_arrays
+#ifdef __APPLE__
+        ::glVertexAttribDivisorEXT(index, divisor);
+#else
+        if (_VertexAttribDivisorEXT) {
+            _VertexAttribDivisorEXT(index, divisor);
+        }
+#endif
+#endif
+    }
+
+    void GLContext::DrawElementsInstancedEXT(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instanceCount) {
+        std::lock_guard<std::recursive_mutex> lock(_Mutex);
+
+#ifdef GL_EXT_instanced_arrays
+#ifdef __APPLE__
+        ::glDrawElementsInstancedEXT(mode, count, type, indices, instanceCount);
+#else
+        if (_DrawElementsInstancedEXT) {
+            _DrawElementsInstancedEXT(mode, count, type, indices, instanceCount);
+        }
+#endif
+#endif
+    }
+
+    void GLContext::GenVertexArraysOES(GLsizei n, GLuint* arrays) {
+        std::lock_guard<std::recursive_mutex> lock(_Mutex);
+
+#ifdef GL_OES_vertex_array_object
+#ifdef __APPLE__
+        ::glGenVertexArraysOES(n, arrays);
+#else
+        if (_GenVertexArraysOES) {
+            _GenVertexArraysOES(n, arrays);
+        }
+#endif
+#endif
+    }
+
+    void GLContext::BindVertexArrayOES(GLuint array) {
+        std::lock_guard<std::recursive_mutex> lock(_Mutex);
+
+#ifdef GL_OES_vertex_array_object
+#ifdef __APPLE__
+        ::glBindVertexArrayOES(array);
+#else
+        if (_BindVertexArrayOES) {
+            _BindVertexArrayOES(array);
+        }
+#endif
+#endif
+    }
+
+    void GLContext::DeleteVertexArraysOES(GLsizei n, const GLuint* arrays) {
+        std::lock_guard<std::recursive_mutex> lock(_Mutex);
+
+#ifdef GL_OES_vertex_array_object
+#ifdef __APPLE__
+        ::glDeleteVertexArraysOES(n, arrays);
+#else
+        if (_DeleteVertexArraysOES) {
+            _DeleteVertexArraysOES(n, arrays);
+        }
+#endif
+#endif
+    }
+
     GLContext::GLContext() {
     }
     
@@ -73,6 +172,10 @@ namespace carto {
 
     bool GLContext::DISCARD_FRAMEBUFFER = false;
 
+    bool GLContext::INSTANCED_ARRAYS = false;
+
+    bool GLContext::VERTEX_ARRAY_OBJECT = false;
+
     bool GLContext::PACKED_DEPTH_STENCIL = false;
     
     std::size_t GLContext::MAX_VERTEXBUFFER_SIZE = 65535; // Should NOT exceed 64k!
@@ -81,6 +184,17 @@ namespace carto {
     PFNGLDISCARDFRAMEBUFFEREXTPROC GLContext::_DiscardFramebufferEXT = nullptr;
 #endif
 
+#if !defined(__APPLE__) && defined(GL_EXT_instanced_arrays)
+    PFNGLVERTEXATTRIBDIVISOREXTPROC GLContext::_VertexAttribDivisorEXT = nullptr;
+    PFNGLDRAWELEMENTSINSTANCEDEXTPROC GLContext::_DrawElementsInstancedEXT = nullptr;
+#endif
+
+#if !defined(__APPLE__) && defined(GL_OES_vertex_array_object)
+    PFNGLGENVERTEXARRAYSOESPROC GLContext::_GenVertexArraysOES = nullptr;
+    PFNGLBINDVERTEXARRAYOESPROC GLContext::_BindVertexArrayOES = nullptr;
+    PFNGLDELETEVERTEXARRAYSOESPROC GLContext::_DeleteVertexArraysOES = nullptr;
+#endif
+
     std::unordered_set<std::string> GLContext::_ExtensionCache;
         
     std::recursive_mutex GLContext::_Mutex;
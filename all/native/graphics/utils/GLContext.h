@@ -15,9 +15,11 @@
 #include <GLES2/gl2ext.h>
 #endif
 
+#include <algorithm>
 #include <mutex>
 #include <string>
 #include <unordered_set>
+#include <vector>
 #include <atomic>
 
 namespace carto {
@@ -30,10 +32,30 @@ namespace carto {
 
         static bool DISCARD_FRAMEBUFFER;
 
+        static bool INSTANCED_ARRAYS;
+
+        static bool VERTEX_ARRAY_OBJECT;
+
         static bool PACKED_DEPTH_STENCIL;
 
         static std::size_t MAX_VERTEXBUFFER_SIZE;
-    
+
+        static const std::size_t VERTEXBUFFER_CHUNK_SIZE = 4096;
+
+        /**
+         * Grows a CPU-side vertex buffer to at least the given size, rounding the size up
+         * to a multiple of VERTEXBUFFER_CHUNK_SIZE. The chunked growth avoids repeated
+         * reallocations when the geometry size varies slightly from frame to frame; the
+         * buffer keeps its high-water capacity until explicitly trimmed.
+         */
+        template <typename T>
+        static void ResizeVertexBuffer(std::vector<T>& buf, std::size_t size, std::size_t maxSize) {
+            if (buf.size() < size) {
+                std::size_t chunkedSize = (size + VERTEXBUFFER_CHUNK_SIZE - 1) / VERTEXBUFFER_CHUNK_SIZE * VERTEXBUFFER_CHUNK_SIZE;
+                buf.resize(std::min(chunkedSize, maxSize));
+            }
+        }
+
         static bool HasGLExtension(const char* extension);
     
         static void LoadExtensions();
@@ -41,7 +63,17 @@ namespace carto {
         static void CheckGLError(const char* place);
 
         static void DiscardFramebufferEXT(GLenum target, GLsizei numAttachments, const GLenum* attachments);
-    
+
+        static void VertexAttribDivisorEXT(GLuint index, GLuint divisor);
+
+        static void DrawElementsInstancedEXT(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instanceCount);
+
+        static void GenVertexArraysOES(GLsizei n, GLuint* arrays);
+
+        static void BindVertexArrayOES(GLuint array);
+
+        static void DeleteVertexArraysOES(GLsizei n, const GLuint* arrays);
+
     private:
         GLContext();
 
@@ -49,6 +81,17 @@ namespace carto {
         static PFNGLDISCARDFRAMEBUFFEREXTPROC _DiscardFramebufferEXT;
 #endif
 
+#if !defined(__APPLE__) && defined(GL_EXT_instanced_arrays)
+        static PFNGLVERTEXATTRIBDIVISOREXTPROC _VertexAttribDivisorEXT;
+        static PFNGLDRAWELEMENTSINSTANCEDEXTPROC _DrawElementsInstancedEXT;
+#endif
+
+#if !defined(__APPLE__) && defined(GL_OES_vertex_array_object)
+        static PFNGLGENVERTEXARRAYSOESPROC _GenVertexArraysOES;
+        static PFNGLBINDVERTEXARRAYOESPROC _BindVertexArrayOES;
+        static PFNGLDELETEVERTEXARRAYSOESPROC _DeleteVertexArraysOES;
+#endif
+
         static std::unordered_set<std::string> _ExtensionCache;
     
         static std::recursive_mutex _Mutex;
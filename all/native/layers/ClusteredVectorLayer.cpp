@@ -15,6 +15,7 @@
 #include "vectorelements/Point.h"
 #include "vectorelements/Billboard.h"
 #include "vectorelements/NMLModel.h"
+#include "styles/PointStyle.h"
 #include "utils/Const.h"
 #include "utils/Log.h"
 
@@ -25,6 +26,8 @@
 #include <memory>
 #include <utility>
 #include <numeric>
+#include <algorithm>
+#include <thread>
 
 #include <cglib/vec.h>
 
@@ -37,6 +40,8 @@ namespace carto {
         _minClusterDistance(100),
         _maxClusterZoom(Const::MAX_SUPPORTED_ZOOM_LEVEL),
         _animatedClusters(true),
+        _clusterPointStyle(),
+        _clusterPointZoom(0),
         _dpiScale(1),
         _clusters(),
         _projectionSurface(),
@@ -44,6 +49,7 @@ namespace carto {
         _rootClusterIdx(-1),
         _renderClusterIdxs(),
         _refreshRootCluster(true),
+        _pendingElementEdits(),
         _clusterMutex()
     {
         if (!clusterElementBuilder) {
@@ -95,6 +101,38 @@ namespace carto {
         std::lock_guard<std::recursive_mutex> lock(_mutex);
         _animatedClusters = animated; // NOTE: no need to refresh
     }
+
+    std::shared_ptr<PointStyle> ClusteredVectorLayer::getClusterPointStyle() const {
+        std::lock_guard<std::mutex> lock(_clusterMutex);
+        return _clusterPointStyle;
+    }
+
+    void ClusteredVectorLayer::setClusterPointStyle(const std::shared_ptr<PointStyle>& style) {
+        {
+            std::lock_guard<std::mutex> lock(_clusterMutex);
+            _clusterPointStyle = style;
+            // Drop the cached point elements, they are rebuilt with the new style
+            if (_clusters) {
+                for (Cluster& cluster : *_clusters) {
+                    cluster.pointElement.reset();
+                }
+            }
+        }
+        redraw();
+    }
+
+    float ClusteredVectorLayer::getClusterPointZoom() const {
+        std::lock_guard<std::mutex> lock(_clusterMutex);
+        return _clusterPointZoom;
+    }
+
+    void ClusteredVectorLayer::setClusterPointZoom(float zoom) {
+        {
+            std::lock_guard<std::mutex> lock(_clusterMutex);
+            _clusterPointZoom = zoom;
+        }
+        redraw();
+    }
     
     bool ClusteredVectorLayer::expandCluster(const std::shared_ptr<VectorElement>& clusterElement, float px) {
         bool updated = false;
@@ -139,6 +177,15 @@ namespace carto {
         return VectorLayer::onDrawFrame(deltaSeconds, billboardSorter, styleCache, viewState) || refresh;
     }
 
+    bool ClusteredVectorLayer::onDrawFrameBillboards(float deltaSeconds, BillboardSorter& billboardSorter, StyleTextureCache& styleCache, const ViewState& viewState) {
+        if (!isVisible() || !_lastCullState || !getVisibleZoomRange().inRange(viewState.getZoom()) || getOpacity() <= 0) {
+            return false;
+        }
+
+        bool refresh = renderClusters(viewState, deltaSeconds);
+        return VectorLayer::onDrawFrameBillboards(deltaSeconds, billboardSorter, styleCache, viewState) || refresh;
+    }
+
     void ClusteredVectorLayer::refreshElement(const std::shared_ptr<VectorElement>& element, bool remove) {
         {
             std::lock_guard<std::recursive_mutex> lock(_mutex);
@@ -146,7 +193,11 @@ namespace carto {
                 syncRendererElement(element, _lastCullState->getViewState(), remove);
             }
         }
-        refresh();
+        {
+            std::lock_guard<std::mutex> lock(_clusterMutex);
+            _pendingElementEdits.emplace_back(element, remove);
+        }
+        VectorLayer::refresh();
     }
 
     std::shared_ptr<CancelableTask> ClusteredVectorLayer::createFetchTask(const std::shared_ptr<CullState>& cullState) {
@@ -168,16 +219,25 @@ namespace carto {
 
         std::vector<std::shared_ptr<VectorElement> > vectorElements = std::static_pointer_cast<LocalVectorDataSource>(layer->_dataSource.get())->getAll();
         bool refresh = false;
+        std::vector<std::pair<std::shared_ptr<VectorElement>, bool> > elementEdits;
         {
             std::lock_guard<std::mutex> lock(layer->_clusterMutex);
             refresh = layer->_refreshRootCluster;
             if (!layer->_clusters) {
                 refresh = true;
             }
+            std::swap(elementEdits, layer->_pendingElementEdits);
+            if (elementEdits.size() > MAX_INCREMENTAL_EDITS) {
+                refresh = true;
+            }
             layer->_refreshRootCluster = false;
         }
         if (refresh) {
             layer->rebuildClusters(vectorElements);
+        } else if (!elementEdits.empty()) {
+            if (!layer->updateClusters(elementEdits)) {
+                layer->rebuildClusters(vectorElements);
+            }
         }
         return false;
     }
@@ -232,7 +292,7 @@ namespace carto {
             }
 
             // Rebuild clusters, by doing bottom-up merging into a single cluster
-            rootClusterIdx = mergeClusters(clusterIdxs.begin(), clusterIdxs.end(), *clusters, *projectionSurface, 1).front();
+            rootClusterIdx = buildClusterTree(clusterIdxs, *clusters, *projectionSurface);
         }
 
         // Synchronize cluster data
@@ -244,6 +304,110 @@ namespace carto {
         _renderClusterIdxs.clear();
     }
 
+    int ClusteredVectorLayer::buildClusterTree(std::vector<int>& clusterIdxs, std::vector<Cluster>& clusters, const ProjectionSurface& projectionSurface) const {
+        typedef std::pair<std::vector<int>::iterator, std::vector<int>::iterator> ClusterIdxRange;
+
+        // For small data sets or single-core devices simply merge everything on the calling thread
+        unsigned int threadCount = std::max(std::thread::hardware_concurrency(), 1U);
+        if (threadCount < 2 || clusterIdxs.size() <= 4 * THRESHOLD) {
+            return mergeClusters(clusterIdxs.begin(), clusterIdxs.end(), clusters, projectionSurface, 1).front();
+        }
+
+        // Partition the points spatially by recursively splitting the largest partition
+        // at the median along the axis of bigger extent. This keeps the partitions balanced
+        // regardless of the point distribution.
+        std::vector<ClusterIdxRange> partitions;
+        partitions.emplace_back(clusterIdxs.begin(), clusterIdxs.end());
+        while (partitions.size() < threadCount) {
+            std::size_t largest = 0;
+            for (std::size_t i = 1; i < partitions.size(); i++) {
+                if (partitions[i].second - partitions[i].first > partitions[largest].second - partitions[largest].first) {
+                    largest = i;
+                }
+            }
+            ClusterIdxRange range = partitions[largest];
+            std::size_t count = range.second - range.first;
+            if (count <= 4 * THRESHOLD) {
+                break;
+            }
+
+            MapPos minPos(std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity());
+            MapPos maxPos(-std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity());
+            for (auto it = range.first; it != range.second; it++) {
+                const MapPos& pos = clusters[*it].staticPos;
+                minPos = MapPos(std::min(minPos.getX(), pos.getX()), std::min(minPos.getY(), pos.getY()));
+                maxPos = MapPos(std::max(maxPos.getX(), pos.getX()), std::max(maxPos.getY(), pos.getY()));
+            }
+            int axis = (maxPos.getX() - minPos.getX() > maxPos.getY() - minPos.getY() ? 0 : 1);
+
+            std::vector<int>::iterator mid = range.first + count / 2;
+            std::nth_element(range.first, mid, range.second, [axis, &clusters](int clusterIdx1, int clusterIdx2) {
+                return clusters[clusterIdx1].staticPos[axis] < clusters[clusterIdx2].staticPos[axis];
+            });
+            partitions[largest] = ClusterIdxRange(range.first, mid);
+            partitions.emplace_back(mid, range.second);
+        }
+
+        // Cluster the partitions in parallel. Each thread works on a private copy of its
+        // partition, so no synchronization on the shared cluster vector is needed.
+        std::vector<std::vector<Cluster> > partitionClusters(partitions.size());
+        std::vector<std::vector<int> > partitionTopIdxs(partitions.size());
+        std::vector<std::thread> threads;
+        threads.reserve(partitions.size());
+        for (std::size_t i = 0; i < partitions.size(); i++) {
+            threads.emplace_back([this, i, &partitions, &partitionClusters, &partitionTopIdxs, &clusters, &projectionSurface]() {
+                std::size_t count = partitions[i].second - partitions[i].first;
+                std::vector<Cluster>& localClusters = partitionClusters[i];
+                localClusters.reserve(count * 2);
+                std::vector<int> localClusterIdxs;
+                localClusterIdxs.reserve(count);
+                for (auto it = partitions[i].first; it != partitions[i].second; it++) {
+                    localClusterIdxs.push_back(static_cast<int>(localClusters.size()));
+                    localClusters.push_back(clusters[*it]);
+                }
+                partitionTopIdxs[i] = mergeClusters(localClusterIdxs.begin(), localClusterIdxs.end(), localClusters, projectionSurface, THRESHOLD);
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        // Splice the partition cluster trees back into the shared cluster vector,
+        // translating local indices to shared indices
+        std::vector<int> topClusterIdxs;
+        topClusterIdxs.reserve(partitions.size() * THRESHOLD);
+        for (std::size_t i = 0; i < partitions.size(); i++) {
+            std::size_t count = partitions[i].second - partitions[i].first;
+            int base = static_cast<int>(clusters.size()) - static_cast<int>(count);
+            auto remapClusterIdx = [&partitions, i, count, base](int localClusterIdx) {
+                if (localClusterIdx == -1) {
+                    return -1;
+                }
+                if (localClusterIdx < static_cast<int>(count)) {
+                    return *(partitions[i].first + localClusterIdx);
+                }
+                return base + localClusterIdx;
+            };
+
+            for (std::size_t j = 0; j < count; j++) {
+                clusters[*(partitions[i].first + j)].parentClusterIdx = remapClusterIdx(partitionClusters[i][j].parentClusterIdx);
+            }
+            for (std::size_t j = count; j < partitionClusters[i].size(); j++) {
+                Cluster cluster = partitionClusters[i][j];
+                cluster.parentClusterIdx = remapClusterIdx(cluster.parentClusterIdx);
+                cluster.childClusterIdx[0] = remapClusterIdx(cluster.childClusterIdx[0]);
+                cluster.childClusterIdx[1] = remapClusterIdx(cluster.childClusterIdx[1]);
+                clusters.push_back(cluster);
+            }
+            for (int localClusterIdx : partitionTopIdxs[i]) {
+                topClusterIdxs.push_back(remapClusterIdx(localClusterIdx));
+            }
+        }
+
+        // Finally merge the boundary clusters of the partitions into a single root
+        return mergeClusters(topClusterIdxs.begin(), topClusterIdxs.end(), clusters, projectionSurface, 1).front();
+    }
+
     int ClusteredVectorLayer::createSingletonCluster(const std::shared_ptr<VectorElement>& element, std::vector<Cluster>& clusters, const ProjectionSurface& projectionSurface) const {
         MapPos mapPos;
         if (!element->isVisible() || !GetVectorElementPos(element, mapPos)) {
@@ -443,6 +607,126 @@ namespace carto {
         return clusterIdxs;
     }
 
+    bool ClusteredVectorLayer::updateClusters(const std::vector<std::pair<std::shared_ptr<VectorElement>, bool> >& elementEdits) {
+        std::shared_ptr<ProjectionSurface> projectionSurface;
+        if (auto mapRenderer = _mapRenderer.lock()) {
+            projectionSurface = mapRenderer->getProjectionSurface();
+        }
+        if (!projectionSurface) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(_clusterMutex);
+        if (!_clusters || projectionSurface != _projectionSurface) {
+            return false;
+        }
+
+        // Apply edits one-by-one, touching only the affected branches of the cluster tree.
+        // An updated element is simply removed and then re-inserted at its current position.
+        for (const std::pair<std::shared_ptr<VectorElement>, bool>& elementEdit : elementEdits) {
+            int singletonClusterIdx = FindSingletonCluster(elementEdit.first, *_clusters);
+            if (singletonClusterIdx != -1) {
+                removeElementCluster(singletonClusterIdx, *_clusters, _rootClusterIdx);
+            }
+            if (!elementEdit.second) {
+                int clusterIdx = createSingletonCluster(elementEdit.first, *_clusters, *projectionSurface);
+                if (clusterIdx != -1) {
+                    insertElementCluster(clusterIdx, *_clusters, *projectionSurface, _rootClusterIdx);
+                }
+            }
+        }
+
+        // The singleton clusters no longer form an ordered prefix, force a full comparison on the next explicit refresh
+        _singletonClusterCount = -1;
+        return true;
+    }
+
+    void ClusteredVectorLayer::insertElementCluster(int clusterIdx, std::vector<Cluster>& clusters, const ProjectionSurface& projectionSurface, int& rootClusterIdx) const {
+        if (rootClusterIdx == -1) {
+            rootClusterIdx = clusterIdx;
+            return;
+        }
+
+        // Descend towards the closer child while the merge distance of the node exceeds
+        // the distance to the new element. The new element then belongs next to the final node.
+        MapPos mapPos = clusters[clusterIdx].staticPos;
+        cglib::vec3<double> pos = projectionSurface.calculatePosition(_dataSource->getProjection()->toInternal(mapPos));
+        int siblingClusterIdx = rootClusterIdx;
+        while (clusters[siblingClusterIdx].elementCount > 1) {
+            const Cluster& cluster = clusters[siblingClusterIdx];
+            cglib::vec3<double> clusterPos = projectionSurface.calculatePosition(_dataSource->getProjection()->toInternal(cluster.staticPos));
+            if (projectionSurface.calculateDistance(pos, clusterPos) >= cluster.maxDistance) {
+                break;
+            }
+            cglib::vec3<double> childPos1 = projectionSurface.calculatePosition(_dataSource->getProjection()->toInternal(clusters[cluster.childClusterIdx[0]].staticPos));
+            cglib::vec3<double> childPos2 = projectionSurface.calculatePosition(_dataSource->getProjection()->toInternal(clusters[cluster.childClusterIdx[1]].staticPos));
+            siblingClusterIdx = cluster.childClusterIdx[projectionSurface.calculateDistance(pos, childPos1) <= projectionSurface.calculateDistance(pos, childPos2) ? 0 : 1];
+        }
+
+        // Splice a new merged cluster between the found node and its parent
+        int parentClusterIdx = clusters[siblingClusterIdx].parentClusterIdx;
+        int mergedClusterIdx = createMergedCluster(siblingClusterIdx, clusterIdx, clusters, projectionSurface);
+        clusters[mergedClusterIdx].parentClusterIdx = parentClusterIdx;
+        if (parentClusterIdx == -1) {
+            rootClusterIdx = mergedClusterIdx;
+        } else {
+            Cluster& parentCluster = clusters[parentClusterIdx];
+            parentCluster.childClusterIdx[parentCluster.childClusterIdx[0] == siblingClusterIdx ? 0 : 1] = mergedClusterIdx;
+        }
+
+        // Update the ancestors of the merged cluster
+        for (int ancestorClusterIdx = parentClusterIdx; ancestorClusterIdx != -1; ancestorClusterIdx = clusters[ancestorClusterIdx].parentClusterIdx) {
+            Cluster& ancestorCluster = clusters[ancestorClusterIdx];
+            int n = ancestorCluster.elementCount;
+            ancestorCluster.staticPos = MapPos((ancestorCluster.staticPos.getX() * n + mapPos.getX()) / (n + 1), (ancestorCluster.staticPos.getY() * n + mapPos.getY()) / (n + 1));
+            ancestorCluster.bounds.add(clusters[clusterIdx].bounds);
+            ancestorCluster.elementCount = n + 1;
+            ancestorCluster.clusterElement.reset();
+        }
+    }
+
+    void ClusteredVectorLayer::removeElementCluster(int clusterIdx, std::vector<Cluster>& clusters, int& rootClusterIdx) const {
+        MapPos mapPos = clusters[clusterIdx].staticPos;
+        int parentClusterIdx = clusters[clusterIdx].parentClusterIdx;
+        if (parentClusterIdx == -1) {
+            rootClusterIdx = -1;
+        } else {
+            // Replace the parent cluster with the sibling of the removed cluster
+            Cluster& parentCluster = clusters[parentClusterIdx];
+            int siblingClusterIdx = parentCluster.childClusterIdx[parentCluster.childClusterIdx[0] == clusterIdx ? 1 : 0];
+            int grandParentClusterIdx = parentCluster.parentClusterIdx;
+            clusters[siblingClusterIdx].parentClusterIdx = grandParentClusterIdx;
+            if (grandParentClusterIdx == -1) {
+                rootClusterIdx = siblingClusterIdx;
+            } else {
+                Cluster& grandParentCluster = clusters[grandParentClusterIdx];
+                grandParentCluster.childClusterIdx[grandParentCluster.childClusterIdx[0] == parentClusterIdx ? 0 : 1] = siblingClusterIdx;
+            }
+
+            // Update the ancestors. Note that the bounds are not shrunk, they remain valid supersets for culling
+            for (int ancestorClusterIdx = grandParentClusterIdx; ancestorClusterIdx != -1; ancestorClusterIdx = clusters[ancestorClusterIdx].parentClusterIdx) {
+                Cluster& ancestorCluster = clusters[ancestorClusterIdx];
+                int n = ancestorCluster.elementCount;
+                ancestorCluster.staticPos = MapPos((ancestorCluster.staticPos.getX() * n - mapPos.getX()) / (n - 1), (ancestorCluster.staticPos.getY() * n - mapPos.getY()) / (n - 1));
+                ancestorCluster.elementCount = n - 1;
+                ancestorCluster.clusterElement.reset();
+            }
+
+            // Mark the detached parent cluster as unused
+            parentCluster.elementCount = 0;
+            parentCluster.childClusterIdx[0] = parentCluster.childClusterIdx[1] = -1;
+            parentCluster.parentClusterIdx = -1;
+            parentCluster.clusterElement.reset();
+        }
+
+        // Mark the removed singleton cluster as unused
+        Cluster& cluster = clusters[clusterIdx];
+        cluster.elementCount = 0;
+        cluster.parentClusterIdx = -1;
+        cluster.vectorElement.reset();
+        cluster.clusterElement.reset();
+    }
+
     bool ClusteredVectorLayer::renderClusters(const ViewState& viewState, float deltaSeconds) {
         std::lock_guard<std::mutex> lock(_clusterMutex);
         if (!_clusters) {
@@ -473,12 +757,22 @@ namespace carto {
         _renderClusterIdxs.clear();
         bool refresh = renderCluster(_rootClusterIdx, viewState, renderState, deltaSeconds);
         
+        // Check if the simplified point representation should be used for this frame
+        bool usePointClusters = _clusterPointStyle && viewState.getZoom() < _clusterPointZoom;
+
         // First pass, create rendering elements from scratch
         for (int clusterIdx : _renderClusterIdxs) {
             Cluster& cluster = (*renderState.clusters)[clusterIdx];
             std::shared_ptr<VectorElement> element;
             if (cluster.elementCount == 1 && cluster.transitionPos == cluster.staticPos) {
                 element = cluster.vectorElement;
+            } else if (usePointClusters && cluster.elementCount > 1) {
+                // Simplified representation, bypasses the cluster element builder and
+                // routes the cluster through the much cheaper point pipeline
+                if (!cluster.pointElement) {
+                    cluster.pointElement = std::make_shared<Point>(cluster.transitionPos, _clusterPointStyle);
+                }
+                element = cluster.pointElement;
             } else {
                 if (!cluster.clusterElement) {
                     if (_clusterBuilderMode == ClusterBuilderMode::CLUSTER_BUILDER_MODE_ELEMENT_COUNT && cluster.elementCount > 1) {
@@ -502,9 +796,18 @@ namespace carto {
         // Second pass, update positions of clustering elements
         for (int clusterIdx : _renderClusterIdxs) {
             Cluster& cluster = (*renderState.clusters)[clusterIdx];
-            if (cluster.clusterElement && !(cluster.elementCount == 1 && cluster.transitionPos == cluster.staticPos)) {
-                SetVectorElementPos(cluster.clusterElement, cluster.transitionPos);
-                billboardsChanged = syncRendererElement(cluster.clusterElement, viewState, false) || billboardsChanged;
+            if (cluster.elementCount == 1 && cluster.transitionPos == cluster.staticPos) {
+                continue;
+            }
+            std::shared_ptr<VectorElement> element;
+            if (usePointClusters && cluster.elementCount > 1) {
+                element = cluster.pointElement;
+            } else {
+                element = cluster.clusterElement;
+            }
+            if (element) {
+                SetVectorElementPos(element, cluster.transitionPos);
+                billboardsChanged = syncRendererElement(element, viewState, false) || billboardsChanged;
             }
         }
 
@@ -647,6 +950,15 @@ namespace carto {
         return _dataSource->getProjection()->fromInternal(internalPos + MapVec(std::cos(angle), std::sin(angle)) * dist);
     }
 
+    int ClusteredVectorLayer::FindSingletonCluster(const std::shared_ptr<VectorElement>& element, const std::vector<Cluster>& clusters) {
+        for (std::size_t i = 0; i < clusters.size(); i++) {
+            if (clusters[i].elementCount == 1 && clusters[i].vectorElement == element) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
     void ClusteredVectorLayer::StoreVectorElements(int clusterIdx, const std::vector<Cluster>& clusters, std::vector<std::shared_ptr<VectorElement> >& elements) {
         if (clusterIdx == -1) {
             return;
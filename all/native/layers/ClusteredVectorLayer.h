@@ -26,6 +26,8 @@
 namespace carto {
     class VectorElement;
     class LocalVectorDataSource;
+    class Point;
+    class PointStyle;
     class ProjectionSurface;
 
     /**
@@ -83,6 +85,33 @@ namespace carto {
          */
         void setAnimatedClusters(bool animated);
 
+        /**
+         * Returns the style used for simplified cluster points.
+         * @return The style used for simplified cluster points or null if the simplified mode is disabled.
+         */
+        std::shared_ptr<PointStyle> getClusterPointStyle() const;
+        /**
+         * Sets the style for simplified cluster points. When the style is defined, clusters are
+         * rendered as plain points with this style below the cluster point zoom level, bypassing
+         * the cluster element builder and the billboard pipeline. This keeps frame times flat
+         * even with thousands of visible clusters. By default the style is null and
+         * all clusters are rendered through the cluster element builder.
+         * @param style The new style for simplified cluster points.
+         */
+        void setClusterPointStyle(const std::shared_ptr<PointStyle>& style);
+
+        /**
+         * Returns the maximum zoom level at which clusters are rendered as simplified points.
+         * @return The maximum zoom level for simplified cluster points.
+         */
+        float getClusterPointZoom() const;
+        /**
+         * Sets the maximum zoom level at which clusters are rendered as simplified points.
+         * The simplified mode also requires the cluster point style to be defined. The default is 0 (disabled).
+         * @param zoom The new maximum zoom level for simplified cluster points.
+         */
+        void setClusterPointZoom(float zoom);
+
         /**
          * Expands or shrinks the given cluster element. In expanded state,
          * all elements of the cluster are placed at specified distance from the cluster center.
@@ -103,6 +132,7 @@ namespace carto {
             cglib::bbox3<double> bounds;
             int elementCount;
             std::shared_ptr<VectorElement> clusterElement;
+            std::shared_ptr<Point> pointElement;
             std::shared_ptr<VectorElement> vectorElement;
             int parentClusterIdx;
             int childClusterIdx[2];
@@ -127,6 +157,7 @@ namespace carto {
         };
 
         static const std::size_t THRESHOLD = 100;
+        static const std::size_t MAX_INCREMENTAL_EDITS = 256;
 
         const DirectorPtr<ClusterElementBuilder> _clusterElementBuilder;
         ClusterBuilderMode::ClusterBuilderMode _clusterBuilderMode;
@@ -134,6 +165,8 @@ namespace carto {
         float _minClusterDistance;
         float _maxClusterZoom;
         bool _animatedClusters;
+        std::shared_ptr<PointStyle> _clusterPointStyle;
+        float _clusterPointZoom;
         float _dpiScale;
         std::shared_ptr<std::vector<Cluster> > _clusters;
         std::shared_ptr<ProjectionSurface> _projectionSurface;
@@ -141,25 +174,33 @@ namespace carto {
         int _rootClusterIdx;
         std::vector<int> _renderClusterIdxs;
         bool _refreshRootCluster;
-        mutable std::mutex _clusterMutex; // for _minClusterDistance, _maxClusterZoom, _dpiScale, _rootClusterIdx, _refreshRootCluster, _renderClusters, _renderClusterIdxs
+        std::vector<std::pair<std::shared_ptr<VectorElement>, bool> > _pendingElementEdits;
+        mutable std::mutex _clusterMutex; // for _minClusterDistance, _maxClusterZoom, _dpiScale, _rootClusterIdx, _refreshRootCluster, _renderClusters, _renderClusterIdxs, _pendingElementEdits
 
         virtual bool onDrawFrame(float deltaSeconds, BillboardSorter& billboardSorter, StyleTextureCache& styleCache, const ViewState& viewState);
+        virtual bool onDrawFrameBillboards(float deltaSeconds, BillboardSorter& billboardSorter, StyleTextureCache& styleCache, const ViewState& viewState);
 
         virtual void refreshElement(const std::shared_ptr<VectorElement>& element, bool remove);
 
         virtual std::shared_ptr<CancelableTask> createFetchTask(const std::shared_ptr<CullState>& cullState);
 
         void rebuildClusters(const std::vector<std::shared_ptr<VectorElement> >& vectorElements);
+        int buildClusterTree(std::vector<int>& clusterIdxs, std::vector<Cluster>& clusters, const ProjectionSurface& projectionSurface) const;
         int createSingletonCluster(const std::shared_ptr<VectorElement>& element, std::vector<Cluster>& clusters, const ProjectionSurface& projectionSurface) const;
         int createMergedCluster(int clusterIdx1, int clusterIdx2, std::vector<Cluster>& clusters, const ProjectionSurface& projectionSurface) const;
         std::vector<int> mergeClusters(std::vector<int>::iterator clustersBegin, std::vector<int>::iterator clustersEnd, std::vector<Cluster>& clusters, const ProjectionSurface& projectionSurface, std::size_t maxClusters) const;
 
+        bool updateClusters(const std::vector<std::pair<std::shared_ptr<VectorElement>, bool> >& elementEdits);
+        void insertElementCluster(int clusterIdx, std::vector<Cluster>& clusters, const ProjectionSurface& projectionSurface, int& rootClusterIdx) const;
+        void removeElementCluster(int clusterIdx, std::vector<Cluster>& clusters, int& rootClusterIdx) const;
+
         bool renderClusters(const ViewState& viewState, float deltaSeconds);
         bool renderCluster(int clusterIdx, const ViewState& viewState, RenderState& renderState, float deltaSeconds);
         bool animateCluster(int clusterIdx, RenderState& renderState, float deltaSeconds);
         bool moveCluster(int clusterIdx, const MapPos& targetPos, const RenderState& renderState, float deltaSeconds);
         MapPos createExpandedElementPos(RenderState& renderState) const;
 
+        static int FindSingletonCluster(const std::shared_ptr<VectorElement>& element, const std::vector<Cluster>& clusters);
         static void StoreVectorElements(int clusterIdx, const std::vector<Cluster>& clusters, std::vector<std::shared_ptr<VectorElement> >& elements);
         static bool GetVectorElementPos(const std::shared_ptr<VectorElement>& vectorElement, MapPos& pos);
         static bool SetVectorElementPos(const std::shared_ptr<VectorElement>& vectorElement, const MapPos& pos);
@@ -56,6 +56,7 @@ namespace carto {
         _overlayDragGeometryPos(),
         _overlayDragStarted(false),
         _overlayDragMode(VectorElementDragMode::VECTOR_ELEMENT_DRAG_MODE_VERTEX),
+        _editSessionGeometry(),
         _vectorEditEventListener()
     {
     }
@@ -83,6 +84,7 @@ namespace carto {
             _overlayDragPoint.reset();
             _overlayDragGeometry.reset();
             _overlayDragStarted = false;
+            _editSessionGeometry.reset();
 
             _overlayStyleNormal.reset();
             _overlayStyleVirtual.reset();
@@ -192,7 +194,20 @@ namespace carto {
         }
         return VectorLayer::syncRendererElement(element, viewState, remove);
     }
-    
+
+    void EditableVectorLayer::refreshElement(const std::shared_ptr<VectorElement>& element, bool remove) {
+        VectorLayer::refreshElement(element, remove);
+
+        bool selected = false;
+        {
+            std::lock_guard<std::recursive_mutex> lock(_mutex);
+            selected = IsSameElement(element, _selectedVectorElement);
+        }
+        if (selected) {
+            redraw(); // the selection overlay is drawn outside of the billboard pass
+        }
+    }
+
     void EditableVectorLayer::registerDataSourceListener() {
         _dataSourceListener = std::make_shared<DataSourceListener>(std::static_pointer_cast<EditableVectorLayer>(shared_from_this()));
         _dataSource->registerOnChangeListener(_dataSourceListener);
@@ -398,6 +413,7 @@ namespace carto {
                         layer->_overlayDragPoint.reset();
                         layer->_overlayDragGeometry.reset();
                         layer->_overlayDragStarted = false;
+                        layer->_editSessionGeometry.reset();
                         layer->refresh();
                         return true;
                     case VectorElementDragResult::VECTOR_ELEMENT_DRAG_RESULT_MODIFY:
@@ -436,9 +452,11 @@ namespace carto {
                 layer->_overlayDragGeometry.reset();
                 switch (dragResult) {
                     case VectorElementDragResult::VECTOR_ELEMENT_DRAG_RESULT_IGNORE:
+                        layer->_editSessionGeometry.reset();
                         layer->refresh();
                         break;
                     case VectorElementDragResult::VECTOR_ELEMENT_DRAG_RESULT_STOP:
+                        layer->_editSessionGeometry.reset();
                         layer->refresh();
                         return true;
                     case VectorElementDragResult::VECTOR_ELEMENT_DRAG_RESULT_MODIFY:
@@ -475,6 +493,11 @@ namespace carto {
             geometry = updateGeometryPoints(geometry, viewState, mapPos0, mapPos1);
         }
 
+        if (_overlayDragStarted && updateEditSessionGeometry(element, geometry)) {
+            return; // the geometry is committed at the end of the drag gesture
+        }
+        _editSessionGeometry.reset();
+
         DirectorPtr<VectorEditEventListener> vectorEditEventListener = _vectorEditEventListener;
 
         if (vectorEditEventListener) {
@@ -526,11 +549,13 @@ namespace carto {
     void EditableVectorLayer::removeElement(std::shared_ptr<VectorElement> element) {
         DirectorPtr<VectorEditEventListener> vectorEditEventListener = _vectorEditEventListener;
 
+        _editSessionGeometry.reset();
+
         if (vectorEditEventListener) {
             vectorEditEventListener->onElementDelete(element);
         }
         element.reset();
-        
+
         syncElementOverlayPoints(element);
         redraw();
     }
@@ -547,9 +572,14 @@ namespace carto {
         int offset = 0;
         int index = static_cast<int>(it - _overlayPoints.begin());
 
-        std::shared_ptr<Geometry> geometry = element->getGeometry();
+        std::shared_ptr<Geometry> geometry = getEditSessionGeometry(element);
         geometry = updateGeometryPoint(geometry, offset, index, mapPos);
 
+        if (geometry && _overlayDragStarted && updateEditSessionGeometry(element, geometry)) {
+            return; // the geometry is committed at the end of the drag gesture
+        }
+        _editSessionGeometry.reset();
+
         DirectorPtr<VectorEditEventListener> vectorEditEventListener = _vectorEditEventListener;
 
         if (geometry) {
@@ -641,9 +671,10 @@ namespace carto {
         int offset = 0;
         int index = static_cast<int>(it - _overlayPoints.begin());
 
-        std::shared_ptr<Geometry> geometry = element->getGeometry();
+        std::shared_ptr<Geometry> geometry = getEditSessionGeometry(element);
         geometry = removeGeometryPoint(geometry, offset, index);
-    
+        _editSessionGeometry.reset();
+
         DirectorPtr<VectorEditEventListener> vectorEditEventListener = _vectorEditEventListener;
 
         if (geometry) {
@@ -736,14 +767,78 @@ namespace carto {
         offset += points;
         return geometry;
     }
-    
+
+    std::shared_ptr<Geometry> EditableVectorLayer::getEditSessionGeometry(const std::shared_ptr<VectorElement>& element) const {
+        if (_editSessionGeometry && IsSameElement(element, _selectedVectorElement)) { // NOTE: locked already
+            return _editSessionGeometry;
+        }
+        return element->getGeometry();
+    }
+
+    bool EditableVectorLayer::updateEditSessionGeometry(const std::shared_ptr<VectorElement>& element, const std::shared_ptr<Geometry>& geometry) {
+        if (!element->isVisible()) {
+            return false;
+        }
+
+        std::shared_ptr<ProjectionSurface> projectionSurface;
+        if (auto mapRenderer = _mapRenderer.lock()) {
+            projectionSurface = mapRenderer->getProjectionSurface();
+        }
+        if (!projectionSurface) {
+            return false;
+        }
+
+        // Build the draw data directly from the uncommitted geometry and push it to the renderer,
+        // bypassing the data source. The data source and the edit event listener are notified only
+        // once, at the end of the drag gesture. The change generation of the element is captured
+        // so that concurrent refreshes keep the session draw data instead of rebuilding it.
+        if (auto point = std::dynamic_pointer_cast<Point>(element)) {
+            auto pointGeometry = std::dynamic_pointer_cast<PointGeometry>(geometry);
+            if (!pointGeometry) {
+                return false;
+            }
+            auto drawData = std::make_shared<PointDrawData>(*pointGeometry, *point->getStyle(), *_dataSource->getProjection(), *projectionSurface);
+            drawData->setChangeGeneration(point->getChangeGeneration());
+            drawData->setProjectionSurface(projectionSurface);
+            point->setDrawData(drawData);
+            _pointRenderer->updateElement(point);
+        } else if (auto line = std::dynamic_pointer_cast<Line>(element)) {
+            auto lineGeometry = std::dynamic_pointer_cast<LineGeometry>(geometry);
+            if (!lineGeometry) {
+                return false;
+            }
+            auto drawData = std::make_shared<LineDrawData>(*lineGeometry, *line->getStyle(), *_dataSource->getProjection(), *projectionSurface);
+            drawData->setChangeGeneration(line->getChangeGeneration());
+            drawData->setProjectionSurface(projectionSurface);
+            line->setDrawData(drawData);
+            _lineRenderer->updateElement(line);
+        } else if (auto polygon = std::dynamic_pointer_cast<Polygon>(element)) {
+            auto polygonGeometry = std::dynamic_pointer_cast<PolygonGeometry>(geometry);
+            if (!polygonGeometry) {
+                return false;
+            }
+            auto drawData = std::make_shared<PolygonDrawData>(*polygonGeometry, *polygon->getStyle(), *_dataSource->getProjection(), *projectionSurface);
+            drawData->setChangeGeneration(polygon->getChangeGeneration());
+            drawData->setProjectionSurface(projectionSurface);
+            polygon->setDrawData(drawData);
+            _polygonRenderer->updateElement(polygon);
+        } else {
+            return false; // other element types are committed on every drag event
+        }
+
+        _editSessionGeometry = geometry;
+        syncElementOverlayPoints(element);
+        redraw();
+        return true;
+    }
+
     void EditableVectorLayer::syncElementOverlayPoints(const std::shared_ptr<VectorElement>& element) {
         std::lock_guard<std::recursive_mutex> lock(_mutex);
 
         std::vector<std::shared_ptr<Point> > overlayPoints;
         if (element && element->isVisible()) {
             int index = 0;
-            std::shared_ptr<Geometry> geometry = element->getGeometry();
+            std::shared_ptr<Geometry> geometry = getEditSessionGeometry(element);
             createGeometryOverlayPoints(geometry, index, overlayPoints);
         }
         
@@ -804,8 +899,12 @@ namespace carto {
         std::shared_ptr<Point> overlayPoint;
         if (index >= 0 && index < static_cast<int>(_overlayPoints.size())) {
             overlayPoint = _overlayPoints[index];
+            std::shared_ptr<PointStyle> style = overlayPoint == _overlayDragPoint ? _overlayStyleSelected : (virtualPoint ? _overlayStyleVirtual : _overlayStyleNormal);
+            if (overlayPoint->getPos() == mapPos && overlayPoint->getStyle() == style && overlayPoint->getDrawData()) {
+                return overlayPoint; // unchanged, keep the cached draw data
+            }
             overlayPoint->setPos(mapPos);
-            overlayPoint->setStyle(overlayPoint == _overlayDragPoint ? _overlayStyleSelected : (virtualPoint ? _overlayStyleVirtual : _overlayStyleNormal));
+            overlayPoint->setStyle(style);
         } else {
             overlayPoint = std::make_shared<Point>(mapPos, virtualPoint ? _overlayStyleVirtual : _overlayStyleNormal);
         }
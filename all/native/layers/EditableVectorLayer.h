@@ -72,6 +72,8 @@ namespace carto {
         virtual bool onDrawFrame(float deltaSeconds, BillboardSorter& billboardSorter, StyleTextureCache& styleCache, const ViewState& viewState);
         virtual void onSurfaceDestroyed();
 
+        virtual void refreshElement(const std::shared_ptr<VectorElement>& element, bool remove);
+
         virtual void addRendererElement(const std::shared_ptr<VectorElement>& element);
         virtual bool refreshRendererElements();
         virtual bool syncRendererElement(const std::shared_ptr<VectorElement>& element, const ViewState& viewState, bool remove);
@@ -119,6 +121,9 @@ namespace carto {
         void removeElementPoint(std::shared_ptr<VectorElement> element, const std::shared_ptr<Point>& dragPoint);
         std::shared_ptr<Geometry> removeGeometryPoint(std::shared_ptr<Geometry> geometry, int& offset, int index);
 
+        std::shared_ptr<Geometry> getEditSessionGeometry(const std::shared_ptr<VectorElement>& element) const;
+        bool updateEditSessionGeometry(const std::shared_ptr<VectorElement>& element, const std::shared_ptr<Geometry>& geometry);
+
         void syncElementOverlayPoints(const std::shared_ptr<VectorElement>& element);
         void createGeometryOverlayPoints(const std::shared_ptr<Geometry>& geometry, int& index, std::vector<std::shared_ptr<Point> >& overlayPoints) const;
         std::shared_ptr<Point> createOverlayPoint(const MapPos& mapPos, bool virtualPoint, int index) const;
@@ -141,6 +146,7 @@ namespace carto {
         MapPos _overlayDragGeometryPos;
         bool _overlayDragStarted;
         VectorElementDragMode::VectorElementDragMode _overlayDragMode;
+        std::shared_ptr<Geometry> _editSessionGeometry; // uncommitted geometry of the selected element during an active drag
 
         ThreadSafeDirectorPtr<VectorEditEventListener> _vectorEditEventListener;
     };
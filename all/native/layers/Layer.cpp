@@ -50,6 +50,19 @@ namespace carto {
         refresh();
     }
     
+    std::string Layer::getCompositingGroup() const {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        return _compositingGroup;
+    }
+
+    void Layer::setCompositingGroup(const std::string& group) {
+        {
+            std::lock_guard<std::recursive_mutex> lock(_mutex);
+            _compositingGroup = group;
+        }
+        redraw();
+    }
+
     MapRange Layer::getVisibleZoomRange() {
         std::lock_guard<std::recursive_mutex> lock(_mutex);
         return _visibleZoomRange;
@@ -125,6 +138,8 @@ namespace carto {
         _opacity(1.0f),
         _visible(true),
         _visibleZoomRange(0, std::numeric_limits<float>::infinity()),
+        _compositingGroup(),
+        _contentGeneration(0),
         _mutex(),
         _surfaceCreated(false)
     {
@@ -165,7 +180,13 @@ namespace carto {
         return _lastCullState;
     }
 
+    unsigned int Layer::getContentGeneration() const {
+        return _contentGeneration.load();
+    }
+
     void Layer::redraw() const {
+        _contentGeneration++;
+
         std::shared_ptr<MapRenderer> mapRenderer;
         {
             std::lock_guard<std::recursive_mutex> lock(_mutex);
@@ -184,15 +205,29 @@ namespace carto {
     void Layer::onSurfaceCreated(const std::shared_ptr<ShaderManager>& shaderManager, const std::shared_ptr<TextureManager>& textureManager) {
         _surfaceCreated = true;
     }
-    
+
+    void Layer::warmUpStyles(StyleTextureCache& styleCache) {
+    }
+
+    void Layer::setReducedQuality(bool reduced) {
+    }
+
     bool Layer::onDrawFrame3D(float deltaSeconds, BillboardSorter& billboardSorter, StyleTextureCache& styleCache, const ViewState& viewState) {
         return false;
     }
-    
+
+    bool Layer::onDrawFrameBillboards(float deltaSeconds, BillboardSorter& billboardSorter, StyleTextureCache& styleCache, const ViewState& viewState) {
+        return false;
+    }
+
     void Layer::onSurfaceDestroyed() {
         _surfaceCreated = false;
     }
-    
+
+    void Layer::onMemoryWarning() {
+    }
+
+
     std::shared_ptr<Bitmap> Layer::getBackgroundBitmap() const {
         return std::shared_ptr<Bitmap>();
     }
@@ -16,6 +16,7 @@
 #include <atomic>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <vector>
 
 #include <cglib/ray.h>
@@ -90,6 +91,20 @@ namespace carto {
          */
         void setVisible(bool visible);
     
+        /**
+         * Returns the compositing group of this layer.
+         * @return The compositing group name, or an empty string if the layer is not grouped.
+         */
+        std::string getCompositingGroup() const;
+        /**
+         * Sets the compositing group of this layer. Consecutive layers sharing a non-empty group name
+         * are rendered into a cached offscreen buffer that is re-composited until any member layer changes.
+         * Grouping rarely-changing layers below frequently-changing ones reduces the per-frame rendering cost.
+         * By default, layers are not grouped.
+         * @param group The new compositing group name, or an empty string to disable grouping.
+         */
+        void setCompositingGroup(const std::string& group);
+
         /**
          * Returns the visible zoom range of this layer.
          * @return The visible zoom range of this layer.
@@ -144,6 +159,8 @@ namespace carto {
     
         std::shared_ptr<CullState> getLastCullState() const;
 
+        unsigned int getContentGeneration() const;
+
         void redraw() const;
     
         virtual void loadData(const std::shared_ptr<CullState>& cullState) = 0;
@@ -152,10 +169,15 @@ namespace carto {
 
         virtual bool isSurfaceCreated() const;
         virtual void onSurfaceCreated(const std::shared_ptr<ShaderManager>& shaderManager, const std::shared_ptr<TextureManager>& textureManager);
+        virtual void warmUpStyles(StyleTextureCache& styleCache);
+        virtual void setReducedQuality(bool reduced);
         virtual bool onDrawFrame(float deltaSeconds, BillboardSorter& billboardSorter, StyleTextureCache& styleCache, const ViewState& viewState) = 0;
         virtual bool onDrawFrame3D(float deltaSeconds, BillboardSorter& billboardSorter, StyleTextureCache& styleCache, const ViewState& viewState);
+        virtual bool onDrawFrameBillboards(float deltaSeconds, BillboardSorter& billboardSorter, StyleTextureCache& styleCache, const ViewState& viewState);
         virtual void onSurfaceDestroyed();
-        
+
+        virtual void onMemoryWarning();
+
         virtual std::shared_ptr<Bitmap> getBackgroundBitmap() const;
         virtual std::shared_ptr<Bitmap> getSkyBitmap() const;
         
@@ -180,9 +202,13 @@ namespace carto {
         std::atomic<float> _opacity;
         
         std::atomic<bool> _visible;
-        
+
         MapRange _visibleZoomRange;
 
+        std::string _compositingGroup;
+
+        mutable std::atomic<unsigned int> _contentGeneration;
+
         mutable std::recursive_mutex _mutex;
 
     private:
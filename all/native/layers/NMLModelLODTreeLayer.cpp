@@ -10,7 +10,11 @@
 #include "renderers/NMLModelLODTreeRenderer.h"
 #include "renderers/components/CullState.h"
 #include "renderers/components/RayIntersectedElement.h"
+#ifdef _CARTO_ROUTING_SUPPORT
+#include "routing/RoutingResult.h"
+#endif
 #include "ui/NMLModelLODTreeClickInfo.h"
+#include "utils/Const.h"
 #include "utils/Log.h"
 
 #include <nml/GLModel.h>
@@ -46,7 +50,14 @@ namespace {
         cglib::vec3<double> projSize = projBounds.size();
         return (float) std::max(projSize(0), projSize(1));
     }
-    
+
+    long long estimateTriangleCount(const carto::nml::ModelLODTreeNode* node) {
+        // Uncompressed non-indexed mesh data per triangle: 3 vertices with positions, normals and texture coordinates
+        static const long long TRIANGLE_FOOTPRINT = 96;
+
+        return (node->model().mesh_footprint() + TRIANGLE_FOOTPRINT - 1) / TRIANGLE_FOOTPRINT;
+    }
+
 }
     
 namespace carto {
@@ -55,6 +66,7 @@ namespace carto {
         Layer(),
         _maxMemorySize(DEFAULT_MAX_MEMORY_SIZE),
         _LODResolutionFactor(1),
+        _maxDrawnTriangleCount(0),
         _mapTileList(),
         _mapTileListViewState(),
         _modelLODTreeMap(),
@@ -65,6 +77,10 @@ namespace carto {
         _textureCache(DEFAULT_TEXTURE_CACHE_SIZE),
         _nodeDrawDataMap(),
         _lastMapTilesFetchTask(),
+#ifdef _CARTO_ROUTING_SUPPORT
+        _prefetchRoute(),
+        _lastRoutePrefetchTask(),
+#endif
         _fetchingModelLODTrees(),
         _fetchingMeshes(),
         _fetchingTextures(),
@@ -77,7 +93,7 @@ namespace carto {
             throw NullArgumentException("Null dataSource");
         }
 
-        _fetchThreadPool->setPoolSize(1);
+        _fetchThreadPool->setPoolSize(2);
     }
     
     NMLModelLODTreeLayer::~NMLModelLODTreeLayer() {
@@ -89,6 +105,17 @@ namespace carto {
         return _dataSource;
     }
 
+    int NMLModelLODTreeLayer::getFetchThreadCount() const {
+        return _fetchThreadPool->getPoolSize();
+    }
+
+    void NMLModelLODTreeLayer::setFetchThreadCount(int threadCount) {
+        if (threadCount < 1) {
+            throw OutOfRangeException("Fetch thread count must be positive");
+        }
+        _fetchThreadPool->setPoolSize(threadCount);
+    }
+
     std::size_t NMLModelLODTreeLayer::getMaxMemorySize() const {
         std::lock_guard<std::recursive_mutex> lock(_mutex);
         return _maxMemorySize;
@@ -111,6 +138,34 @@ namespace carto {
         refresh();
     }
 
+    long long NMLModelLODTreeLayer::getMaxDrawnTriangleCount() const {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        return _maxDrawnTriangleCount;
+    }
+
+    void NMLModelLODTreeLayer::setMaxDrawnTriangleCount(long long count) {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        _maxDrawnTriangleCount = count;
+        refresh();
+    }
+
+#ifdef _CARTO_ROUTING_SUPPORT
+    std::shared_ptr<RoutingResult> NMLModelLODTreeLayer::getPrefetchRoute() const {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        return _prefetchRoute;
+    }
+
+    void NMLModelLODTreeLayer::setPrefetchRoute(const std::shared_ptr<RoutingResult>& route) {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        _prefetchRoute = route;
+        if (_lastRoutePrefetchTask) {
+            _lastRoutePrefetchTask->cancel();
+            _lastRoutePrefetchTask.reset();
+        }
+        refresh();
+    }
+#endif
+
     std::shared_ptr<NMLModelLODTreeEventListener> NMLModelLODTreeLayer::getNMLModelLODTreeEventListener() const {
         return _nmlModelLODTreeEventListener.get();
     }
@@ -232,6 +287,20 @@ namespace carto {
             _envelopeThreadPool->execute(task, getUpdatePriority());
             _lastMapTilesFetchTask = task;
         }
+
+#ifdef _CARTO_ROUTING_SUPPORT
+        if (_prefetchRoute) {
+            if (_lastRoutePrefetchTask) {
+                _lastRoutePrefetchTask->cancel();
+            }
+
+            auto prefetchTask = std::make_shared<RoutePrefetchTask>(std::static_pointer_cast<NMLModelLODTreeLayer>(shared_from_this()), _prefetchRoute, cullState);
+            if (_envelopeThreadPool) {
+                _envelopeThreadPool->execute(prefetchTask, getUpdatePriority() + PREFETCH_LOADING_PRIORITY_OFFSET);
+                _lastRoutePrefetchTask = prefetchTask;
+            }
+        }
+#endif
     }
     
     bool NMLModelLODTreeLayer::isDataAvailable(const NMLModelLODTree* modelLODTree, int nodeId) {
@@ -317,6 +386,40 @@ namespace carto {
         return true;
     }
     
+#ifdef _CARTO_ROUTING_SUPPORT
+    void NMLModelLODTreeLayer::prefetchNodeData(const NMLModelLODTree* modelLODTree, int nodeId) {
+        auto meshMapIt = modelLODTree->getMeshBindingsMap().find(nodeId);
+        if (meshMapIt != modelLODTree->getMeshBindingsMap().end()) {
+            for (auto listIt = meshMapIt->second.begin(); listIt != meshMapIt->second.end(); listIt++) {
+                const NMLModelLODTree::MeshBinding& binding = *listIt;
+
+                std::shared_ptr<nml::GLMesh> glMesh;
+                if (_meshMap.find(binding.meshId) == _meshMap.end() && !_meshCache.read(binding.meshId, glMesh)) {
+                    if (!_fetchingMeshes.exists(binding.meshId)) {
+                        auto task = std::make_shared<MeshFetchTask>(std::static_pointer_cast<NMLModelLODTreeLayer>(shared_from_this()), binding);
+                        _fetchThreadPool->execute(task, getUpdatePriority() + PREFETCH_LOADING_PRIORITY_OFFSET);
+                    }
+                }
+            }
+        }
+
+        auto textureMapIt = modelLODTree->getTextureBindingsMap().find(nodeId);
+        if (textureMapIt != modelLODTree->getTextureBindingsMap().end()) {
+            for (auto listIt = textureMapIt->second.begin(); listIt != textureMapIt->second.end(); listIt++) {
+                const NMLModelLODTree::TextureBinding& binding = *listIt;
+
+                std::shared_ptr<nml::GLTexture> glTexture;
+                if (_textureMap.find(binding.textureId) == _textureMap.end() && !_textureCache.read(binding.textureId, glTexture)) {
+                    if (!_fetchingTextures.exists(binding.textureId)) {
+                        auto task = std::make_shared<TextureFetchTask>(std::static_pointer_cast<NMLModelLODTreeLayer>(shared_from_this()), binding);
+                        _fetchThreadPool->execute(task, getUpdatePriority() + PREFETCH_LOADING_PRIORITY_OFFSET);
+                    }
+                }
+            }
+        }
+    }
+#endif
+
     void NMLModelLODTreeLayer::updateModelLODTrees(const MapTileList& mapTileList, ModelLODTreeMap& modelLODTreeMap) {
         for (auto it = mapTileList.begin(); it != mapTileList.end(); it++) {
             const NMLModelLODTreeDataSource::MapTile& mapTile = *it;
@@ -393,7 +496,18 @@ namespace carto {
     
         cglib::mat4x4<double> mvpMatrix = viewState.getModelviewProjectionMat();
         cglib::frustum3<double> frustum = cglib::gl_projection_frustum(mvpMatrix);
-    
+
+        // Collect drawn and subdivided nodes of the previous draw list. The subdivision
+        // decisions below are biased towards repeating the previous decisions, otherwise
+        // small camera oscillations around a subdivision threshold would re-stream the models.
+        std::unordered_set<long long> prevDrawnNodeIds;
+        std::unordered_set<long long> prevSubdividedNodeIds;
+        for (auto it = _nodeDrawDataMap.begin(); it != _nodeDrawDataMap.end(); it++) {
+            prevDrawnNodeIds.insert(it->first);
+            const std::vector<long long>& parentIds = it->second->getParentIds();
+            prevSubdividedNodeIds.insert(parentIds.begin(), parentIds.end());
+        }
+
         // Create initial node queue from roots
         std::priority_queue<SizeNodePair> initialQueue;
         for (auto it = _modelLODTreeMap.begin(); it != _modelLODTreeMap.end(); it++) {
@@ -409,6 +523,7 @@ namespace carto {
     
         // Create new queue by taking root nodes from initial queue until size limits are exceeded
         std::size_t totalSize = 0;
+        long long totalTriangleCount = 0;
         std::priority_queue<SizeNodePair> queue;
         while (!initialQueue.empty()) {
             SizeNodePair sizeNodePair = initialQueue.top();
@@ -424,11 +539,13 @@ namespace carto {
                 continue;
             }
     
-            // Test if this node can be added or we have already exceeded max memory footprint
+            // Test if this node can be added or we have already exceeded max memory footprint or the triangle budget
             std::size_t nodeSize = node->model().texture_footprint() + node->model().mesh_footprint();
-            if (totalSize + nodeSize <= _maxMemorySize) {
+            long long nodeTriangleCount = estimateTriangleCount(node);
+            if (totalSize + nodeSize <= _maxMemorySize && (_maxDrawnTriangleCount <= 0 || totalTriangleCount + nodeTriangleCount <= _maxDrawnTriangleCount)) {
                 queue.push(sizeNodePair);
                 totalSize += nodeSize;
+                totalTriangleCount += nodeTriangleCount;
             }
         }
     
@@ -445,28 +562,38 @@ namespace carto {
             const nml::ModelLODTreeNode* node = modelLODTree->getSourceNode(nodeId);
     
             // Decide whether to subdivide this node - this depends on node screen size estimation and whether we can stay within memory size constraints after subdividing
-            if (screenSize * _LODResolutionFactor > 2 && node->children_ids_size() > 0) {
+            float splitThreshold = 2;
+            long long globalNodeId = modelLODTree->getGlobalNodeId(nodeId);
+            if (prevSubdividedNodeIds.count(globalNodeId) > 0) {
+                splitThreshold /= LOD_HYSTERESIS_FACTOR;
+            } else if (prevDrawnNodeIds.count(globalNodeId) > 0) {
+                splitThreshold *= LOD_HYSTERESIS_FACTOR;
+            }
+            if (screenSize * _LODResolutionFactor > splitThreshold && node->children_ids_size() > 0) {
                 childList.clear();
                 std::size_t nodeSize = node->model().texture_footprint() + node->model().mesh_footprint();
                 std::size_t childListTotalSize = totalSize - nodeSize;
+                long long childListTotalTriangleCount = totalTriangleCount - estimateTriangleCount(node);
                 for (int i = 0; i < node->children_ids_size(); i++) {
                     const nml::ModelLODTreeNode* childNode = modelLODTree->getSourceNode(node->children_ids(i));
-    
+
                     // If child node is visible, add it to child list
                     cglib::bbox3<double> childModelBounds = calculateBounds(childNode->model().bounds(), CalculateLocalMat(viewState, modelLODTree));
                     if (frustum.inside(childModelBounds)) {
                         childList.push_back(childNode);
                         std::size_t childNodeSize = childNode->model().texture_footprint() + childNode->model().mesh_footprint();
                         childListTotalSize += childNodeSize;
+                        childListTotalTriangleCount += estimateTriangleCount(childNode);
                     }
                 }
-                if (childListTotalSize <= _maxMemorySize) {
+                if (childListTotalSize <= _maxMemorySize && (_maxDrawnTriangleCount <= 0 || childListTotalTriangleCount <= _maxDrawnTriangleCount)) {
                     for (std::size_t i = 0; i < childList.size(); i++) {
                         const nml::ModelLODTreeNode* childNode = childList[i];
                         float screenSize = calculateProjectedScreenSize(childNode->bounds(), mvpMatrix * CalculateLocalMat(viewState, modelLODTree));
                         queue.push(SizeNodePair(screenSize, Node(modelLODTree, childNode->id())));
                     }
                     totalSize = childListTotalSize;
+                    totalTriangleCount = childListTotalTriangleCount;
                     continue;
                 }
             }
@@ -573,15 +700,17 @@ namespace carto {
             if (it != _nodeDrawDataMap.end() && !it->second->isOffset()) {
                 nodeDrawData = it->second;
             } else {
-                auto glModel = std::make_shared<nml::GLModel>(modelLODTree->getSourceNode(nodeId)->model());
-    
+                const nml::ModelLODTreeNode* node = modelLODTree->getSourceNode(nodeId);
+                auto glModel = std::make_shared<nml::GLModel>(node->model());
+                std::size_t glSize = node->model().texture_footprint() + node->model().mesh_footprint();
+
                 std::vector<long long> globalParentIds;
                 for (int parentId = nodeId; parentId != 0; ) {
                     parentId = modelLODTree->getNodeParentId(parentId);
                     globalParentIds.push_back(modelLODTree->getGlobalNodeId(parentId));
                 }
-    
-                nodeDrawData = std::make_shared<NMLModelLODTreeDrawData>(std::static_pointer_cast<NMLModelLODTree>(const_cast<NMLModelLODTree*>(modelLODTree)->shared_from_this()), modelLODTree->getGlobalNodeId(nodeId), globalParentIds, glModel, *projectionSurface);
+
+                nodeDrawData = std::make_shared<NMLModelLODTreeDrawData>(std::static_pointer_cast<NMLModelLODTree>(const_cast<NMLModelLODTree*>(modelLODTree)->shared_from_this()), modelLODTree->getGlobalNodeId(nodeId), globalParentIds, glModel, glSize, *projectionSurface);
             }
     
             updateMeshes(modelLODTree, nodeId, nodeDrawData->getGLModel(), meshMap);
@@ -628,7 +757,7 @@ namespace carto {
         std::unique_lock<std::recursive_mutex> lock(layer->_mutex);
         
         // If view has changed, cancel all previous task and fetch new list of map tiles
-        if (layer->_mapTileListViewState.getModelviewProjectionMat() != _cullState->getViewState().getModelviewProjectionMat()) {
+        if (layer->_mapTileListViewState.getCameraGeneration() != _cullState->getViewState().getCameraGeneration()) {
             layer->_fetchThreadPool->cancelAll();
 
             std::shared_ptr<CullState> cullState = _cullState;
@@ -666,6 +795,117 @@ namespace carto {
         std::swap(layer->_nodeDrawDataMap, nodeDrawDataMap);
     }
     
+#ifdef _CARTO_ROUTING_SUPPORT
+    NMLModelLODTreeLayer::RoutePrefetchTask::RoutePrefetchTask(const std::shared_ptr<NMLModelLODTreeLayer>& layer, const std::shared_ptr<RoutingResult>& route, const std::shared_ptr<CullState>& cullState) :
+        _layer(layer),
+        _route(route),
+        _cullState(cullState)
+    {
+    }
+
+    void NMLModelLODTreeLayer::RoutePrefetchTask::run() {
+        const std::shared_ptr<NMLModelLODTreeLayer>& layer = _layer.lock();
+        if (!layer) {
+            return;
+        }
+
+        if (isCanceled()) {
+            return;
+        }
+
+        std::shared_ptr<ProjectionSurface> projectionSurface = _cullState->getViewState().getProjectionSurface();
+        if (!projectionSurface) {
+            return;
+        }
+
+        std::vector<MapPos> routePoints = _route->getProjection()->toInternal(_route->getPoints());
+        if (routePoints.size() < 2) {
+            return;
+        }
+
+        // Find the route point closest to the current camera focus
+        MapPos focusPos = projectionSurface->calculateMapPos(_cullState->getViewState().getFocusPos());
+        std::size_t startIndex = 0;
+        double closestDistSqr = (routePoints[0] - focusPos).lengthSqr();
+        for (std::size_t i = 1; i < routePoints.size(); i++) {
+            double distSqr = (routePoints[i] - focusPos).lengthSqr();
+            if (distSqr < closestDistSqr) {
+                closestDistSqr = distSqr;
+                startIndex = i;
+            }
+        }
+
+        // Walk along the route ahead of the camera, splitting the corridor into chunk bounds
+        std::vector<MapBounds> chunkBoundsList;
+        MapBounds chunkBounds;
+        chunkBounds.expandToContain(routePoints[startIndex]);
+        double totalDist = 0;
+        double chunkDist = 0;
+        for (std::size_t i = startIndex + 1; i < routePoints.size() && totalDist < ROUTE_PREFETCH_DISTANCE; i++) {
+            double dist = (routePoints[i] - routePoints[i - 1]).length();
+            chunkBounds.expandToContain(routePoints[i]);
+            totalDist += dist;
+            chunkDist += dist;
+            if (chunkDist >= ROUTE_PREFETCH_CHUNK_LENGTH) {
+                chunkBoundsList.push_back(chunkBounds);
+                chunkBounds = MapBounds();
+                chunkBounds.expandToContain(routePoints[i]);
+                chunkDist = 0;
+            }
+        }
+        if (chunkDist > 0) {
+            chunkBoundsList.push_back(chunkBounds);
+        }
+
+        // Fetch the map tile list of each corridor chunk from the data source
+        MapTileList mapTileList;
+        for (std::size_t i = 0; i < chunkBoundsList.size(); i++) {
+            if (isCanceled()) {
+                return;
+            }
+
+            const MapBounds& bounds = chunkBoundsList[i];
+            MapPos minPos(bounds.getMin().getX() - ROUTE_PREFETCH_CORRIDOR_WIDTH, bounds.getMin().getY() - ROUTE_PREFETCH_CORRIDOR_WIDTH);
+            MapPos maxPos(bounds.getMax().getX() + ROUTE_PREFETCH_CORRIDOR_WIDTH, bounds.getMax().getY() + ROUTE_PREFETCH_CORRIDOR_WIDTH);
+            auto chunkCullState = std::make_shared<CullState>(MapEnvelope(MapBounds(minPos, maxPos)), _cullState->getViewState());
+            try {
+                MapTileList chunkMapTileList = layer->_dataSource->loadMapTiles(chunkCullState);
+                mapTileList.insert(mapTileList.end(), chunkMapTileList.begin(), chunkMapTileList.end());
+            } catch (const std::exception& ex) {
+                Log::Errorf("NMLModelLODTreeLayer::RoutePrefetchTask: Exception while loading tiles: %s", ex.what());
+                return;
+            }
+        }
+
+        std::lock_guard<std::recursive_mutex> lock(layer->_mutex);
+        if (isCanceled()) {
+            return;
+        }
+
+        // Schedule background loading of missing LOD trees. For already resident trees,
+        // prefetch the coarsest (root) meshes and textures.
+        for (auto it = mapTileList.begin(); it != mapTileList.end(); it++) {
+            const NMLModelLODTreeDataSource::MapTile& mapTile = *it;
+
+            std::shared_ptr<NMLModelLODTree> modelLODTree;
+            auto modelLODTreeIt = layer->_modelLODTreeMap.find(mapTile.modelLODTreeId);
+            if (modelLODTreeIt != layer->_modelLODTreeMap.end()) {
+                modelLODTree = modelLODTreeIt->second;
+            } else if (!layer->_modelLODTreeCache.read(mapTile.modelLODTreeId, modelLODTree)) {
+                if (!layer->_fetchingModelLODTrees.exists(mapTile.modelLODTreeId)) {
+                    auto task = std::make_shared<ModelLODTreeFetchTask>(layer, mapTile);
+                    layer->_fetchThreadPool->execute(task, layer->getUpdatePriority() + PREFETCH_LOADING_PRIORITY_OFFSET);
+                }
+                continue;
+            }
+
+            if (modelLODTree->getSourceNodeCount() > 0) {
+                layer->prefetchNodeData(modelLODTree.get(), 0);
+            }
+        }
+    }
+#endif
+
     NMLModelLODTreeLayer::ModelLODTreeFetchTask::ModelLODTreeFetchTask(const std::shared_ptr<NMLModelLODTreeLayer>& layer, const NMLModelLODTreeDataSource::MapTile& mapTile) :
         _layer(layer),
         _mapTile(mapTile)
@@ -811,7 +1051,15 @@ namespace carto {
         }
         layer->_fetchingTextures.remove(_binding.textureId);
     }
-    
+
+    const float NMLModelLODTreeLayer::LOD_HYSTERESIS_FACTOR = 1.25f;
+
+#ifdef _CARTO_ROUTING_SUPPORT
+    const double NMLModelLODTreeLayer::ROUTE_PREFETCH_DISTANCE = Const::WORLD_SIZE / 8192.0; // approximately 5km at the equator
+    const double NMLModelLODTreeLayer::ROUTE_PREFETCH_CHUNK_LENGTH = Const::WORLD_SIZE / 32768.0;
+    const double NMLModelLODTreeLayer::ROUTE_PREFETCH_CORRIDOR_WIDTH = Const::WORLD_SIZE / 65536.0;
+#endif
+
 }
 
 #endif
@@ -28,6 +28,9 @@ namespace carto {
     class NMLModelLODTreeDrawData;
     class NMLModelLODTreeRenderer;
     class NMLModelLODTreeEventListener;
+#ifdef _CARTO_ROUTING_SUPPORT
+    class RoutingResult;
+#endif
 
     namespace nml {
         class GLModel;
@@ -54,6 +57,20 @@ namespace carto {
          */
         std::shared_ptr<NMLModelLODTreeDataSource> getDataSource() const;
 
+        /**
+         * Returns the number of threads used for fetching and decoding model meshes and textures.
+         * @return The number of fetch threads. The default is 2.
+         */
+        int getFetchThreadCount() const;
+        /**
+         * Sets the number of threads used for fetching and decoding model meshes and textures.
+         * Meshes and textures of different nodes are independent, so on multi-core devices
+         * increasing the fetch thread count reduces the time until a refined LOD level
+         * becomes fully visible.
+         * @param threadCount The new number of fetch threads. The minimum is 1.
+         */
+        void setFetchThreadCount(int threadCount);
+
         /**
          * Returns memory usage constraints for the layer.
          * @return The memory usage constraints for the layer.
@@ -80,7 +97,40 @@ namespace carto {
          * @param factor The relative LOD resolution factor.
          */
         void setLODResolutionFactor(float factor);
-    
+
+        /**
+         * Returns the maximum number of triangles the layer draws per frame.
+         * @return The maximum number of drawn triangles, or 0 if no limit is set.
+         */
+        long long getMaxDrawnTriangleCount() const;
+        /**
+         * Sets the maximum number of triangles the layer draws per frame.
+         * When a limit is set, model LOD levels are selected so that the estimated total
+         * triangle count of the drawn models stays under the limit, with the models taking
+         * the largest projected screen area refined first. This makes the rendering cost
+         * of the layer predictable regardless of the view, which is especially useful
+         * on low-end devices. The triangle counts are estimated from mesh data sizes,
+         * so the limit is approximate. By default no limit is set and LOD selection
+         * is constrained by the memory size limit only.
+         * @param count The maximum number of drawn triangles. Use 0 to remove the limit.
+         */
+        void setMaxDrawnTriangleCount(long long count);
+
+#ifdef _CARTO_ROUTING_SUPPORT
+        /**
+         * Returns the route used for prefetching model data.
+         * @return The route along which model data is prefetched. Can be null if prefetching is disabled.
+         */
+        std::shared_ptr<RoutingResult> getPrefetchRoute() const;
+        /**
+         * Sets the route used for prefetching model data. When a route is set, model LOD trees and
+         * the coarsest meshes and textures along the route corridor ahead of the camera are loaded
+         * at background priority, so that the models are already resident once the camera arrives.
+         * @param route The route along which model data is prefetched. Can be null to disable prefetching.
+         */
+        void setPrefetchRoute(const std::shared_ptr<RoutingResult>& route);
+#endif
+
         /**
          * Returns the NML model event listener.
          * @return The NML model event listener.
@@ -195,29 +245,55 @@ namespace carto {
             std::weak_ptr<NMLModelLODTreeLayer> _layer;
             NMLModelLODTree::TextureBinding _binding;
         };
-    
+
+#ifdef _CARTO_ROUTING_SUPPORT
+        class RoutePrefetchTask : public CancelableTask {
+        public:
+            RoutePrefetchTask(const std::shared_ptr<NMLModelLODTreeLayer>& layer, const std::shared_ptr<RoutingResult>& route, const std::shared_ptr<CullState>& cullState);
+            virtual void run();
+
+        private:
+            std::weak_ptr<NMLModelLODTreeLayer> _layer;
+            std::shared_ptr<RoutingResult> _route;
+            std::shared_ptr<CullState> _cullState;
+        };
+#endif
+
         bool isDataAvailable(const NMLModelLODTree* modelLODTree, int nodeId);
         bool loadModelLODTrees(const MapTileList& mapTileList, bool checkOnly);
         bool loadMeshes(const NMLModelLODTree* modelLODTree, int nodeId, bool checkOnly);
         bool loadTextures(const NMLModelLODTree* modelLODTree, int nodeId, bool checkOnly);
+#ifdef _CARTO_ROUTING_SUPPORT
+        void prefetchNodeData(const NMLModelLODTree* modelLODTree, int nodeId);
+#endif
         void updateModelLODTrees(const MapTileList& mapTileList, ModelLODTreeMap& modelLODTreeMap);
         void updateMeshes(const NMLModelLODTree* modelLODTree, int nodeId, std::shared_ptr<nml::GLModel> glModel, MeshMap& meshMap);
         void updateTextures(const NMLModelLODTree* modelLODTree, int nodeId, std::shared_ptr<nml::GLModel> glModel, TextureMap& textureMap);
         void updateDrawLists(const ViewState& viewState, MeshMap& meshMap, TextureMap& textureMap, NodeDrawDataMap& nodeDrawDataMap);
 
         static cglib::mat4x4<double> CalculateLocalMat(const ViewState& viewState, const NMLModelLODTree* modelLODTree);
-    
+
+        static const float LOD_HYSTERESIS_FACTOR; // subdivision threshold scaling between splitting and merging, to avoid re-streaming when the camera oscillates around the threshold
+
         static const int MODELLODTREE_LOADING_PRIORITY_OFFSET = 1;
         static const int MESH_LOADING_PRIORITY_OFFSET = 0;
         static const int TEXTURE_LOADING_PRIORITY_OFFSET = 0;
+        static const int PREFETCH_LOADING_PRIORITY_OFFSET = -1;
+
+#ifdef _CARTO_ROUTING_SUPPORT
+        static const double ROUTE_PREFETCH_DISTANCE; // length of the prefetched route corridor ahead of the camera, in internal units
+        static const double ROUTE_PREFETCH_CHUNK_LENGTH; // the corridor is split into datasource queries of roughly this length, in internal units
+        static const double ROUTE_PREFETCH_CORRIDOR_WIDTH; // half width of the prefetched route corridor, in internal units
+#endif
 
         static const int DEFAULT_MODELLODTREE_CACHE_SIZE = 64;
         static const int DEFAULT_MAX_MEMORY_SIZE = 80 * 1024 * 1024;
         static const int DEFAULT_MESH_CACHE_SIZE = 80 * 1024 * 1024;
         static const int DEFAULT_TEXTURE_CACHE_SIZE = 80 * 1024 * 1024;
-    
+
         std::size_t _maxMemorySize;
         float _LODResolutionFactor;
+        long long _maxDrawnTriangleCount;
     
         MapTileList _mapTileList;
         ViewState _mapTileListViewState;
@@ -230,6 +306,10 @@ namespace carto {
         NodeDrawDataMap _nodeDrawDataMap;
     
         std::shared_ptr<MapTilesFetchTask> _lastMapTilesFetchTask;
+#ifdef _CARTO_ROUTING_SUPPORT
+        std::shared_ptr<RoutingResult> _prefetchRoute;
+        std::shared_ptr<RoutePrefetchTask> _lastRoutePrefetchTask;
+#endif
         FetchingTasks _fetchingModelLODTrees;
         FetchingTasks _fetchingMeshes;
         FetchingTasks _fetchingTextures;
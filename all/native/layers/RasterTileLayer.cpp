@@ -16,6 +16,7 @@
 
 #include <array>
 #include <algorithm>
+#include <cstdlib>
 
 #include <vt/TileId.h>
 #include <vt/Tile.h>
@@ -75,6 +76,8 @@ namespace carto {
     RasterTileLayer::RasterTileLayer(const std::shared_ptr<TileDataSource>& dataSource) :
         TileLayer(dataSource),
         _rasterTileEventListener(),
+        _tileQuality(RasterTileQuality::RASTER_TILE_QUALITY_HIGH),
+        _reducedTextureQuality(false),
         _visibleTileIds(),
         _tempDrawDatas(),
         _visibleCache(128 * 1024 * 1024), // limit should be never reached during normal use cases
@@ -96,6 +99,41 @@ namespace carto {
         _preloadingCache.resize(capacityInBytes);
     }
     
+    RasterTileQuality::RasterTileQuality RasterTileLayer::getTileQuality() const {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        return _tileQuality;
+    }
+
+    void RasterTileLayer::setTileQuality(RasterTileQuality::RasterTileQuality quality) {
+        {
+            std::lock_guard<std::recursive_mutex> lock(_mutex);
+            _tileQuality = quality;
+        }
+        tilesChanged(false); // reload the tiles, so that they are resampled with the new quality
+    }
+
+    void RasterTileLayer::setReducedQuality(bool reduced) {
+        // NOTE: instead of switching to coarser tiles as the base class does, downsample
+        // the textures one quality step. This keeps the visible tile set and does not
+        // cause any refetching, only cheap re-decoding of the already cached tile data.
+        {
+            std::lock_guard<std::recursive_mutex> lock(_mutex);
+            if (_reducedTextureQuality == reduced) {
+                return;
+            }
+            _reducedTextureQuality = reduced;
+        }
+        tilesChanged(false); // reload the tiles, so that they are resampled with the new effective quality
+    }
+
+    RasterTileQuality::RasterTileQuality RasterTileLayer::getEffectiveTileQuality() const {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        if (_reducedTextureQuality && _tileQuality > RasterTileQuality::RASTER_TILE_QUALITY_LOW) {
+            return static_cast<RasterTileQuality::RasterTileQuality>(_tileQuality - 1);
+        }
+        return _tileQuality;
+    }
+
     std::shared_ptr<RasterTileEventListener> RasterTileLayer::getRasterTileEventListener() const {
         return _rasterTileEventListener.get();
     }
@@ -157,7 +195,7 @@ namespace carto {
             tileThreadPool = _tileThreadPool;
         }
         if (tileThreadPool) {
-            tileThreadPool->execute(task, preloadingTile ? getUpdatePriority() + PRELOADING_PRIORITY_OFFSET : getUpdatePriority());
+            tileThreadPool->execute(task, preloadingTile ? getUpdatePriority() + PRELOADING_PRIORITY_OFFSET : getUpdatePriority(), preloadingTile ? ThreadQoS::BACKGROUND : ThreadQoS::UTILITY);
         }
     }
     
@@ -189,6 +227,52 @@ namespace carto {
         refresh();
     }
 
+    void RasterTileLayer::tilesChanged(const MapBounds& mapBounds, int minZoom, int maxZoom) {
+        minZoom = std::max(minZoom, getMinZoom());
+        maxZoom = std::min(maxZoom, getMaxZoom());
+
+        // Count the affected tiles, if the region is too large, simply do a full refresh
+        unsigned int tileCount = 0;
+        for (int zoom = minZoom; zoom <= maxZoom; zoom++) {
+            MapTile mapTile1 = calculateMapTile(mapBounds.getMin(), zoom);
+            MapTile mapTile2 = calculateMapTile(mapBounds.getMax(), zoom);
+            unsigned int dx = std::abs(mapTile1.getX() - mapTile2.getX()) + 1;
+            unsigned int dy = std::abs(mapTile1.getY() - mapTile2.getY()) + 1;
+            tileCount += dx * dy;
+        }
+        if (maxZoom < minZoom || tileCount > MAX_REGION_INVALIDATION_TILES) {
+            tilesChanged(false);
+            return;
+        }
+
+        // Invalidate current tasks that intersect the region
+        for (const std::shared_ptr<FetchTaskBase>& task : _fetchingTiles.getTasks()) {
+            const MapTile& tile = task->getTile();
+            if (tile.getZoom() >= minZoom && tile.getZoom() <= maxZoom && calculateMapTileBounds(tile.getFlipped()).intersects(mapBounds)) {
+                task->invalidate();
+            }
+        }
+
+        // Expire the cached tiles within the region. Visible tiles are kept warm until
+        // the refetched versions replace them, preloaded tiles are simply dropped.
+        {
+            std::lock_guard<std::recursive_mutex> lock(_mutex);
+            std::chrono::steady_clock::time_point expirationTime = std::chrono::steady_clock::now();
+            for (int zoom = minZoom; zoom <= maxZoom; zoom++) {
+                MapTile mapTile1 = calculateMapTile(mapBounds.getMin(), zoom);
+                MapTile mapTile2 = calculateMapTile(mapBounds.getMax(), zoom);
+                for (int y = std::min(mapTile1.getY(), mapTile2.getY()); y <= std::max(mapTile1.getY(), mapTile2.getY()); y++) {
+                    for (int x = std::min(mapTile1.getX(), mapTile2.getX()); x <= std::max(mapTile1.getX(), mapTile2.getX()); x++) {
+                        long long tileId = MapTile(x, y, zoom, 0).getFlipped().getTileId();
+                        _visibleCache.invalidate(tileId, expirationTime);
+                        _preloadingCache.remove(tileId);
+                    }
+                }
+            }
+        }
+        refresh();
+    }
+
     void RasterTileLayer::calculateDrawData(const MapTile& visTile, const MapTile& closestTile, bool preloadingTile) {
         std::lock_guard<std::recursive_mutex> lock(_mutex);
 
@@ -448,6 +532,14 @@ namespace carto {
                 if (dataSourceTile != _tile) {
                     bitmap = ExtractSubTile(_tile, dataSourceTile, bitmap);
                 }
+
+                // Downsample the bitmap before it is uploaded as a texture, if lower quality was requested
+                RasterTileQuality::RasterTileQuality quality = layer->getEffectiveTileQuality();
+                if (quality != RasterTileQuality::RASTER_TILE_QUALITY_HIGH) {
+                    unsigned int scale = (quality == RasterTileQuality::RASTER_TILE_QUALITY_LOW ? 4 : 2);
+                    bitmap = bitmap->getResizedBitmap(std::max(bitmap->getWidth() / scale, 1U), std::max(bitmap->getHeight() / scale, 1U));
+                }
+
                 std::shared_ptr<vt::TileTransformer> tileTransformer = layer->getTileTransformer();
                 std::shared_ptr<vt::Tile> vtTile = CreateVectorTile(_tile, bitmap, tileTransformer);
                 std::size_t tileSize = EXTRA_TILE_FOOTPRINT + vtTile->getResidentSize();
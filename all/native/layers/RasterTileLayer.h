@@ -25,7 +25,29 @@ namespace carto {
     namespace vt {
         class Tile;
     }
-    
+
+    namespace RasterTileQuality {
+        /**
+         * Raster tile texture quality.
+         */
+        enum RasterTileQuality {
+            /**
+             * Tiles are downsampled to quarter resolution before they are uploaded as textures.
+             * This cuts GPU tile memory usage 16x compared to full quality.
+             */
+            RASTER_TILE_QUALITY_LOW = 0,
+            /**
+             * Tiles are downsampled to half resolution before they are uploaded as textures.
+             * This cuts GPU tile memory usage 4x compared to full quality.
+             */
+            RASTER_TILE_QUALITY_MEDIUM = 1,
+            /**
+             * Tiles are uploaded as textures at full resolution.
+             */
+            RASTER_TILE_QUALITY_HIGH = 2
+        };
+    };
+
     /**
      * A tile layer where each tile is a bitmap. Should be used together with corresponding data source.
      */
@@ -56,7 +78,21 @@ namespace carto {
          * @param capacityInBytes The new tile bitmap cache capacity in bytes.
          */
         void setTextureCacheCapacity(std::size_t capacityInBytes);
-    
+
+        /**
+         * Returns the quality of the raster tile textures.
+         * @return The quality of the raster tile textures. The default is RASTER_TILE_QUALITY_HIGH.
+         */
+        RasterTileQuality::RasterTileQuality getTileQuality() const;
+        /**
+         * Sets the quality of the raster tile textures. Fetched tiles are downsampled on the
+         * fetch threads before they are uploaded as textures, so lower quality modes reduce
+         * GPU tile memory usage and texture bandwidth at the expense of visual sharpness.
+         * Changing the quality invalidates all current tiles of the layer.
+         * @param quality The new quality of the raster tile textures.
+         */
+        void setTileQuality(RasterTileQuality::RasterTileQuality quality);
+
         /**
          * Returns the raster tile event listener.
          * @return The raster tile event listener.
@@ -86,6 +122,7 @@ namespace carto {
         virtual void fetchTile(const MapTile& mapTile, bool preloadingTile, bool invalidated);
         virtual void clearTiles(bool preloadingTiles);
         virtual void tilesChanged(bool removeTiles);
+        virtual void tilesChanged(const MapBounds& mapBounds, int minZoom, int maxZoom);
 
         virtual void calculateDrawData(const MapTile& visTile, const MapTile& closestTile, bool preloadingTile);
         virtual void refreshDrawData(const std::shared_ptr<CullState>& cullState);
@@ -107,14 +144,21 @@ namespace carto {
         virtual void registerDataSourceListener();
         virtual void unregisterDataSourceListener();
 
-    private:    
+        virtual void setReducedQuality(bool reduced);
+
+        RasterTileQuality::RasterTileQuality getEffectiveTileQuality() const;
+
+    private:
         static const int DEFAULT_CULL_DELAY = 200;
-        static const int PRELOADING_PRIORITY_OFFSET = -2;
+        static const unsigned int MAX_REGION_INVALIDATION_TILES = 4096;
         static const int EXTRA_TILE_FOOTPRINT = 4096;
         static const int DEFAULT_PRELOADING_CACHE_SIZE = 10 * 1024 * 1024;
         
         ThreadSafeDirectorPtr<RasterTileEventListener> _rasterTileEventListener;
 
+        RasterTileQuality::RasterTileQuality _tileQuality;
+        bool _reducedTextureQuality;
+
         std::vector<long long> _visibleTileIds;
         std::vector<std::shared_ptr<TileDrawData> > _tempDrawDatas;
         
@@ -2,10 +2,14 @@
 #include "core/BinaryData.h"
 #include "components/Exceptions.h"
 #include "components/CancelableTask.h"
+#include "components/CancelableThreadPool.h"
+#include "components/Options.h"
+#include "datasources/MemoryCacheTileDataSource.h"
 #include "datasources/components/TileData.h"
 #include "layers/TileLoadListener.h"
 #include "layers/UTFGridEventListener.h"
 #include "layers/components/UTFGridTile.h"
+#include "network/NetworkEstimator.h"
 #include "projections/Projection.h"
 #include "projections/ProjectionSurface.h"
 #include "renderers/components/CullState.h"
@@ -19,8 +23,27 @@
 #include "utils/TileUtils.h"
 #include "utils/Log.h"
 
+#include <algorithm>
+
 #include <vt/TileTransformer.h>
 
+namespace {
+
+    bool FrustumContainsBBox(const cglib::frustum3<double>& frustum, const cglib::bbox3<double>& bbox) {
+        // The frustum is convex, so it contains the bounding box iff it contains all its corners
+        for (int n = 0; n < 8; n++) {
+            cglib::vec3<double> corner((n & 1) != 0 ? bbox.max(0) : bbox.min(0),
+                                       (n & 2) != 0 ? bbox.max(1) : bbox.min(1),
+                                       (n & 4) != 0 ? bbox.max(2) : bbox.min(2));
+            if (!frustum.inside(corner)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
+
 namespace carto {
 
     TileLayer::~TileLayer() {
@@ -64,7 +87,20 @@ namespace carto {
         }
         refresh();
     }
-    
+
+    int TileLayer::getPreloadingTileBudget() const {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        return _preloadingTileBudget;
+    }
+
+    void TileLayer::setPreloadingTileBudget(int tileBudget) {
+        {
+            std::lock_guard<std::recursive_mutex> lock(_mutex);
+            _preloadingTileBudget = tileBudget;
+        }
+        refresh();
+    }
+
     bool TileLayer::isSynchronizedRefresh() const {
         return _synchronizedRefresh;
     }
@@ -137,6 +173,23 @@ namespace carto {
         return TileUtils::CalculateMapTileBounds(mapTile, _dataSource->getProjection());
     }
     
+    std::vector<MapTile> TileLayer::getVisibleTiles() const {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        return _visibleTiles;
+    }
+
+    void TileLayer::preloadTiles(const std::vector<MapTile>& mapTiles) {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        for (const MapTile& mapTile : mapTiles) {
+            if (mapTile.getZoom() < getMinZoom() || mapTile.getZoom() > getMaxZoom()) {
+                continue;
+            }
+            int tileMask = (1 << mapTile.getZoom()) - 1;
+            MapTile tile(mapTile.getX() & tileMask, mapTile.getY() & tileMask, mapTile.getZoom(), _frameNr);
+            fetchTile(tile, false, false);
+        }
+    }
+
     void TileLayer::clearTileCaches(bool all) {
         clearTiles(true);
         if (all) {
@@ -159,11 +212,55 @@ namespace carto {
     void TileLayer::setUTFGridEventListener(const std::shared_ptr<UTFGridEventListener>& utfGridEventListener) {
         _utfGridEventListener.set(utfGridEventListener);
     }
-    
+
+    Variant TileLayer::getTileLoadStatistics() const {
+        static const char* stageNames[TILE_LOAD_STAGE_COUNT] = { "fetch", "decode" };
+
+        picojson::object stats;
+        std::lock_guard<std::mutex> lock(_tileLoadSamplesMutex);
+        for (int stage = 0; stage < TILE_LOAD_STAGE_COUNT; stage++) {
+            std::vector<float> samples = _tileLoadSamples[stage];
+            std::sort(samples.begin(), samples.end());
+
+            picojson::object stageStats;
+            stageStats["count"] = picojson::value(static_cast<std::int64_t>(samples.size()));
+            if (!samples.empty()) {
+                stageStats["p50"] = picojson::value(static_cast<double>(samples[samples.size() * 50 / 100]));
+                stageStats["p90"] = picojson::value(static_cast<double>(samples[samples.size() * 90 / 100]));
+                stageStats["p99"] = picojson::value(static_cast<double>(samples[samples.size() * 99 / 100]));
+            }
+            stats[stageNames[stage]] = picojson::value(stageStats);
+        }
+        return Variant::FromPicoJSON(picojson::value(stats));
+    }
+
     bool TileLayer::isUpdateInProgress() const {
         return !_fetchingTiles.getTasks().empty();
     }
+
+    void TileLayer::onMemoryWarning() {
+        clearTileCaches(false); // drop the preloading tiles, the visible tiles are kept
+        if (auto cacheDataSource = std::dynamic_pointer_cast<MemoryCacheTileDataSource>(_dataSource.get())) {
+            cacheDataSource->clear(); // NOTE: persistent caches are left alone, only memory is reclaimed
+        }
+    }
     
+    void TileLayer::setReducedQuality(bool reduced) {
+        {
+            std::lock_guard<std::recursive_mutex> lock(_mutex);
+            if (_qualityReduced == reduced) {
+                return;
+            }
+            _qualityReduced = reduced;
+        }
+        refresh();
+    }
+
+    float TileLayer::getAdjustedZoomLevelBias() const {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        return _zoomLevelBias - (_qualityReduced ? REDUCED_QUALITY_ZOOM_LEVEL_BIAS : 0.0f);
+    }
+
     TileLayer::DataSourceListener::DataSourceListener(const std::shared_ptr<TileLayer>& layer) :
         _layer(layer)
     {
@@ -176,7 +273,15 @@ namespace carto {
             Log::Error("TileLayer::DataSourceListener: Lost connection to layer");
         }
     }
-        
+
+    void TileLayer::DataSourceListener::onTilesChanged(const MapBounds& mapBounds, int minZoom, int maxZoom) {
+        if (std::shared_ptr<TileLayer> layer = _layer.lock()) {
+            layer->tilesChanged(mapBounds, minZoom, maxZoom);
+        } else {
+            Log::Error("TileLayer::DataSourceListener: Lost connection to layer");
+        }
+    }
+
     TileLayer::TileLayer(const std::shared_ptr<TileDataSource>& dataSource) :
         Layer(),
         _synchronizedRefresh(false),
@@ -191,15 +296,30 @@ namespace carto {
         _frameNr(0),
         _lastFrameNr(-1),
         _preloading(false),
+        _preloadingTileBudget(DEFAULT_PRELOADING_TILE_BUDGET),
         _substitutionPolicy(TileSubstitutionPolicy::TILE_SUBSTITUTION_POLICY_ALL),
         _zoomLevelBias(0.0f),
         _maxOverzoomLevel(MAX_PARENT_SEARCH_DEPTH),
         _maxUnderzoomLevel(MAX_CHILD_SEARCH_DEPTH),
+        _qualityReduced(false),
         _visibleTiles(),
+        _lastFocusPosValid(false),
+        _lastFocusPos(),
+        _lastFocusPosTime(),
+        _lastZoomValid(false),
+        _lastZoom(0),
+        _lastZoomTime(),
         _preloadingTiles(),
-        _utfGridTiles(),
+        _preloadingTileScale(PRELOADING_TILE_SCALE),
+        _lastCacheEvictionCountValid(false),
+        _lastCacheEvictionCount(0),
+        _fetchFirstRequestTimes(),
+        _utfGridTiles(DEFAULT_UTFGRID_CACHE_SIZE),
         _tileRenderer(),
-        _tileTransformer()
+        _tileTransformer(),
+        _tileLoadSamples(),
+        _tileLoadSampleIndexes(),
+        _tileLoadSamplesMutex()
     {
         if (!dataSource) {
             throw NullArgumentException("Null dataSource");
@@ -233,15 +353,6 @@ namespace carto {
 
         _calculatingTiles = true;
 
-        // Remove UTF grid tiles that are missing from the cache
-        for (auto it = _utfGridTiles.begin(); it != _utfGridTiles.end(); ) {
-            if (!tileExists(it->first, false) && !tileExists(it->first, true)) {
-                it = _utfGridTiles.erase(it);
-            } else {
-                it++;
-            }
-        }
-    
         // Cancel old tasks
         for (const std::shared_ptr<FetchTaskBase>& task : _fetchingTiles.getTasks()) {
             task->cancel();
@@ -255,7 +366,7 @@ namespace carto {
             return;
         }
         
-        if (!_lastCullState || _frameNr != _lastFrameNr || cullState->getViewState().getModelviewProjectionMat() != _lastCullState->getViewState().getModelviewProjectionMat()) {
+        if (!_lastCullState || _frameNr != _lastFrameNr || cullState->getViewState().getCameraGeneration() != _lastCullState->getViewState().getCameraGeneration()) {
             // If the view has changed calculate new visible tiles, otherwise use the old ones
             calculateVisibleTiles(cullState);
         }
@@ -266,25 +377,195 @@ namespace carto {
         if (_preloading) {
             // Find replacements for preloading tiles
             findTiles(_preloadingTiles, true);
-            
-            // Pre-fetch up to 2 levels of parent tiles
-            std::vector<MapTile> allTiles = _visibleTiles;
-            allTiles.insert(allTiles.end(), _preloadingTiles.begin(), _preloadingTiles.end());
-            for (const MapTile& visTile : allTiles) {
-                if (visTile.getZoom() > 0) {
-                    int tileMask = (1 << visTile.getZoom()) - 1;
-                    MapTile tile(visTile.getX() & tileMask, visTile.getY() & tileMask, visTile.getZoom(), visTile.getFrameNr());
-                    fetchTile(tile.getParent(), true, false);
-                }
+
+            // Split the speculative tile budget between parent tiles, tiles in the panning
+            // direction and child tiles. The per-class weights are fixed, the total budget
+            // is configurable and adapts to the eviction pressure of the tile cache.
+            int tileBudget = calculatePreloadingTileBudget();
+            int parentTileBudget = static_cast<int>(tileBudget * PRELOADING_PARENT_BUDGET_WEIGHT);
+            int childTileBudget = static_cast<int>(tileBudget * PRELOADING_CHILD_BUDGET_WEIGHT);
+            int flankingTileBudget = tileBudget - parentTileBudget - childTileBudget;
+
+            // Pre-fetch parent tiles of the visible and preloading tiles
+            prefetchParentTiles(parentTileBudget);
+
+            // Predictively prefetch tiles along the current camera motion path
+            prefetchPredictedTiles(cullState, flankingTileBudget);
+
+            // Anticipate zoom-in: pre-fetch the children of the visible tiles
+            prefetchZoomInTiles(cullState, childTileBudget);
+        }
+
+        // Anticipate zoom-out: fetch the parents of the visible tiles ahead of time,
+        // so the zoom-out transition renders final-quality tiles immediately
+        prefetchZoomOutTiles(cullState);
+
+        // Re-sort pending fetch tasks based on their distance from the camera
+        if (auto options = _options.lock()) {
+            if (options->isTileFetchReprioritization()) {
+                reprioritizeFetchTasks(cullState->getViewState());
             }
         }
-    
+
         _calculatingTiles = false;
         _refreshedTiles = true;
         
         refreshDrawData(cullState);
     }
 
+    int TileLayer::calculatePreloadingTileBudget() {
+        int tileBudget = _preloadingTileBudget;
+
+        // Reduce the budget when the tile cache is under pressure. If the cache reports
+        // evictions between view changes, speculative tiles are already pushing out
+        // recently used tiles, so preloading is scaled back.
+        if (auto cacheDataSource = std::dynamic_pointer_cast<CacheTileDataSource>(_dataSource.get())) {
+            long long evictionCount = cacheDataSource->getCacheStats().getEvictionCount();
+            if (_lastCacheEvictionCountValid && evictionCount > _lastCacheEvictionCount) {
+                long long evictionDelta = evictionCount - _lastCacheEvictionCount;
+                tileBudget = static_cast<int>(std::max(static_cast<long long>(0), static_cast<long long>(tileBudget) - evictionDelta));
+            }
+            _lastCacheEvictionCountValid = true;
+            _lastCacheEvictionCount = evictionCount;
+        }
+        return tileBudget;
+    }
+
+    void TileLayer::prefetchParentTiles(int& tileBudget) {
+        std::vector<MapTile> allTiles = _visibleTiles;
+        allTiles.insert(allTiles.end(), _preloadingTiles.begin(), _preloadingTiles.end());
+        for (const MapTile& visTile : allTiles) {
+            if (tileBudget <= 0) {
+                return;
+            }
+            if (visTile.getZoom() > 0) {
+                int tileMask = (1 << visTile.getZoom()) - 1;
+                MapTile tile(visTile.getX() & tileMask, visTile.getY() & tileMask, visTile.getZoom(), visTile.getFrameNr());
+                fetchTile(tile.getParent(), true, false);
+                tileBudget--;
+            }
+        }
+    }
+
+    void TileLayer::prefetchPredictedTiles(const std::shared_ptr<CullState>& cullState, int& tileBudget) {
+        const ViewState& viewState = cullState->getViewState();
+        std::shared_ptr<ProjectionSurface> projectionSurface = viewState.getProjectionSurface();
+        if (!projectionSurface) {
+            return;
+        }
+
+        std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
+        cglib::vec3<double> focusPos = viewState.getFocusPos();
+
+        bool lastFocusPosValid = _lastFocusPosValid;
+        cglib::vec3<double> lastFocusPos = _lastFocusPos;
+        float deltaSeconds = std::chrono::duration_cast<std::chrono::duration<float> >(currentTime - _lastFocusPosTime).count();
+
+        _lastFocusPosValid = true;
+        _lastFocusPos = focusPos;
+        _lastFocusPosTime = currentTime;
+
+        if (!lastFocusPosValid || deltaSeconds <= 0 || deltaSeconds > MAX_PREDICTION_SAMPLE_AGE_SECONDS) {
+            return;
+        }
+        if (focusPos == lastFocusPos) {
+            return;
+        }
+
+        // Extrapolate the camera focus assuming constant velocity
+        cglib::vec3<double> predictedFocusPos = focusPos + (focusPos - lastFocusPos) * static_cast<double>(PREDICTION_LOOKAHEAD_SECONDS / deltaSeconds);
+        MapPos predictedMapPos = _dataSource->getProjection()->fromInternal(projectionSurface->calculateMapPos(predictedFocusPos));
+
+        int zoom = static_cast<int>(viewState.getZoom() + getAdjustedZoomLevelBias() + DISCRETE_ZOOM_LEVEL_BIAS);
+        zoom = std::max(getMinZoom(), std::min(getMaxZoom(), zoom));
+
+        // Fetch a small neighborhood around the predicted focus tile. The tiles are fetched
+        // as preloading tiles, so they do not compete with the visible tile fetches.
+        MapTile centerTile = calculateMapTile(predictedMapPos, zoom).getFlipped();
+        int tileMask = (1 << zoom) - 1;
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                if (tileBudget <= 0) {
+                    return;
+                }
+                MapTile tile((centerTile.getX() + dx) & tileMask, (centerTile.getY() + dy) & tileMask, zoom, _frameNr);
+                MapTile flippedTile(tile.getX(), tileMask - (tile.getY() & tileMask), zoom, 0);
+                if (calculateMapTileBounds(flippedTile).intersects(_dataSource->getDataExtent())) {
+                    fetchTile(tile, true, false);
+                    tileBudget--;
+                }
+            }
+        }
+    }
+
+    void TileLayer::prefetchZoomInTiles(const std::shared_ptr<CullState>& cullState, int& tileBudget) {
+        const ViewState& viewState = cullState->getViewState();
+
+        // Use the zoom sample from the previous view change, the sample is updated
+        // by prefetchZoomOutTiles afterwards
+        std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
+        float deltaSeconds = std::chrono::duration_cast<std::chrono::duration<float> >(currentTime - _lastZoomTime).count();
+        if (!_lastZoomValid || deltaSeconds <= 0 || deltaSeconds > MAX_PREDICTION_SAMPLE_AGE_SECONDS) {
+            return;
+        }
+
+        // Fetch child tiles only when the camera is zooming in
+        if (viewState.getZoom() <= _lastZoom) {
+            return;
+        }
+
+        // The visible tiles are sorted by the distance from the camera, so the budget
+        // is spent on the children of the closest tiles first
+        for (const MapTile& visTile : _visibleTiles) {
+            if (visTile.getZoom() >= getMaxZoom()) {
+                continue;
+            }
+            int tileMask = (1 << visTile.getZoom()) - 1;
+            MapTile tile(visTile.getX() & tileMask, visTile.getY() & tileMask, visTile.getZoom(), visTile.getFrameNr());
+            for (int n = 0; n < 4; n++) {
+                if (tileBudget <= 0) {
+                    return;
+                }
+                fetchTile(tile.getChild(n), true, false);
+                tileBudget--;
+            }
+        }
+    }
+
+    void TileLayer::prefetchZoomOutTiles(const std::shared_ptr<CullState>& cullState) {
+        const ViewState& viewState = cullState->getViewState();
+
+        std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
+        float zoom = viewState.getZoom();
+
+        bool lastZoomValid = _lastZoomValid;
+        float lastZoom = _lastZoom;
+        float deltaSeconds = std::chrono::duration_cast<std::chrono::duration<float> >(currentTime - _lastZoomTime).count();
+
+        _lastZoomValid = true;
+        _lastZoom = zoom;
+        _lastZoomTime = currentTime;
+
+        if (!lastZoomValid || deltaSeconds <= 0 || deltaSeconds > MAX_PREDICTION_SAMPLE_AGE_SECONDS) {
+            return;
+        }
+
+        // Fetch parent tiles only when the camera is zooming out
+        if (zoom >= lastZoom) {
+            return;
+        }
+
+        // Bounded to a single zoom level. The parents are fetched as preloading tiles,
+        // so they are decoded at low priority behind the visible tile fetches.
+        for (const MapTile& visTile : _visibleTiles) {
+            if (visTile.getZoom() > 0) {
+                int tileMask = (1 << visTile.getZoom()) - 1;
+                MapTile tile(visTile.getX() & tileMask, visTile.getY() & tileMask, visTile.getZoom(), visTile.getFrameNr());
+                fetchTile(tile.getParent(), true, false);
+            }
+        }
+    }
+
     void TileLayer::updateTileLoadListener() {
         bool calculatingTiles = _calculatingTiles;
     
@@ -304,7 +585,27 @@ namespace carto {
             }
         }
     }
-    
+
+    void TileLayer::addTileLoadSample(TileLoadStage::TileLoadStage stage, const MapTile& tile, float queueDelay, float duration) {
+        {
+            std::lock_guard<std::mutex> lock(_tileLoadSamplesMutex);
+            std::vector<float>& samples = _tileLoadSamples[stage];
+            std::size_t& sampleIndex = _tileLoadSampleIndexes[stage];
+            if (samples.size() < static_cast<std::size_t>(MAX_TILE_LOAD_SAMPLES)) {
+                samples.push_back(duration);
+            } else {
+                samples[sampleIndex] = duration;
+            }
+            sampleIndex = (sampleIndex + 1) % MAX_TILE_LOAD_SAMPLES;
+        }
+
+        DirectorPtr<TileLoadListener> tileLoadListener = _tileLoadListener;
+
+        if (tileLoadListener) {
+            tileLoadListener->onTileLoadProgress(tile, stage, queueDelay, duration);
+        }
+    }
+
     void TileLayer::calculateRayIntersectedElements(const cglib::ray3<double>& ray, const ViewState& viewState, std::vector<RayIntersectedElement>& results) const {
         DirectorPtr<TileDataSource> utfGridDataSource = _utfGridDataSource;
 
@@ -321,7 +622,7 @@ namespace carto {
         }
 
         MapPos mapPos = utfGridDataSource->getProjection()->fromInternal(projectionSurface->calculateMapPos(ray(t)));
-        int zoom = std::min(getMaxZoom(), static_cast<int>(viewState.getZoom() + getZoomLevelBias() + DISCRETE_ZOOM_LEVEL_BIAS));
+        int zoom = std::min(getMaxZoom(), static_cast<int>(viewState.getZoom() + getAdjustedZoomLevelBias() + DISCRETE_ZOOM_LEVEL_BIAS));
 
         // Try to get the tile from cache
         std::shared_ptr<UTFGridTile> utfGridTile;
@@ -330,9 +631,7 @@ namespace carto {
             if (std::abs(flippedMapTile.getZoom() - zoom) < std::abs(utfGridTileZoom - zoom)) {
                 if (tileExists(flippedMapTile, false) || tileExists(flippedMapTile, true)) {
                     std::lock_guard<std::recursive_mutex> lock(_mutex);
-                    auto it = _utfGridTiles.find(flippedMapTile);
-                    if (it != _utfGridTiles.end()) {
-                        utfGridTile = it->second;
+                    if (_utfGridTiles.read(flippedMapTile.getTileId(), utfGridTile)) {
                         utfGridTileZoom = flippedMapTile.getZoom();
                     }
                 }
@@ -356,7 +655,7 @@ namespace carto {
             int y = static_cast<int>(std::floor(yRel * utfGridTile->getYSize()));
             int keyId = utfGridTile->getKeyId(x, y);
             if (keyId != 0) {
-                auto elementInfo = std::make_shared<Variant>(utfGridTile->getData(utfGridTile->getKey(keyId)));
+                auto elementInfo = std::make_shared<Variant>(utfGridTile->getData(keyId));
                 std::shared_ptr<Layer> thisLayer = std::const_pointer_cast<Layer>(shared_from_this());
                 results.push_back(RayIntersectedElement(elementInfo, thisLayer, ray(t), ray(t), false));
             }
@@ -384,14 +683,24 @@ namespace carto {
         _visibleTiles.clear();
         _preloadingTiles.clear();
 
+        // Scale the speculative preloading area with available network bandwidth.
+        // On slow/congested connections preloading is kept close to the visible area,
+        // so the speculative fetches do not compete with the visible tile fetches.
+        _preloadingTileScale = PRELOADING_TILE_SCALE;
+        float bandwidth = NetworkEstimator::GetBandwidthEstimate();
+        if (bandwidth >= 0) {
+            double t = std::max(0.0, std::min(1.0, (bandwidth - PRELOADING_MIN_BANDWIDTH) / (PRELOADING_MAX_BANDWIDTH - PRELOADING_MIN_BANDWIDTH)));
+            _preloadingTileScale = MIN_PRELOADING_TILE_SCALE + (PRELOADING_TILE_SCALE - MIN_PRELOADING_TILE_SCALE) * t;
+        }
+
         // Recursively calculate visible tiles
-        calculateVisibleTilesRecursive(cullState, MapTile(0, 0, 0, _frameNr), _dataSource->getDataExtent());
+        calculateVisibleTilesRecursive(cullState, MapTile(0, 0, 0, _frameNr), _dataSource->getDataExtent(), false);
         if (auto options = _options.lock()) {
             if (options->getRenderProjectionMode() == RenderProjectionMode::RENDER_PROJECTION_MODE_PLANAR && options->isSeamlessPanning()) {
                 // Additional visibility testing has to be done if seamless panning is enabled
                 for (int i = 1; i <= 5; i++) {
-                    calculateVisibleTilesRecursive(cullState, MapTile(-i, 0, 0, _frameNr), _dataSource->getDataExtent());
-                    calculateVisibleTilesRecursive(cullState, MapTile( i, 0, 0, _frameNr), _dataSource->getDataExtent());
+                    calculateVisibleTilesRecursive(cullState, MapTile(-i, 0, 0, _frameNr), _dataSource->getDataExtent(), false);
+                    calculateVisibleTilesRecursive(cullState, MapTile( i, 0, 0, _frameNr), _dataSource->getDataExtent(), false);
                 }
             }
         }
@@ -400,7 +709,7 @@ namespace carto {
         sortTiles(_preloadingTiles, cullState->getViewState(), true);
     }
 
-    void TileLayer::calculateVisibleTilesRecursive(const std::shared_ptr<CullState>& cullState, const MapTile& tile, const MapBounds& dataExtent) {
+    void TileLayer::calculateVisibleTilesRecursive(const std::shared_ptr<CullState>& cullState, const MapTile& tile, const MapBounds& dataExtent, bool insideFrustum) {
         const ViewState& viewState = cullState->getViewState();
         const cglib::frustum3<double>& visibleFrustum = viewState.getFrustum();
         
@@ -416,20 +725,29 @@ namespace carto {
         
         cglib::bbox3<double> tileBounds = _tileTransformer->calculateTileBBox(vt::TileId(tile.getZoom(), tile.getX(), tile.getY()));
         cglib::vec3<double> tileCenter = tileBounds.center();
-        cglib::bbox3<double> preloadingBounds(tileCenter + (tileBounds.min - tileCenter) * PRELOADING_TILE_SCALE, tileCenter + (tileBounds.max - tileCenter) * PRELOADING_TILE_SCALE);
 
-        bool inPreloadingFrustum = visibleFrustum.inside(preloadingBounds);
-        if (!inPreloadingFrustum) {
-            return;
+        // If an ancestor tile was fully inside the frustum, the whole subtree is visible
+        // and no further frustum tests are needed
+        bool inVisibleFrustum = true;
+        if (!insideFrustum) {
+            cglib::bbox3<double> preloadingBounds(tileCenter + (tileBounds.min - tileCenter) * _preloadingTileScale, tileCenter + (tileBounds.max - tileCenter) * _preloadingTileScale);
+
+            bool inPreloadingFrustum = visibleFrustum.inside(preloadingBounds);
+            if (!inPreloadingFrustum) {
+                return;
+            }
+            inVisibleFrustum = visibleFrustum.inside(tileBounds);
+            if (inVisibleFrustum && FrustumContainsBBox(visibleFrustum, tileBounds)) {
+                insideFrustum = true;
+            }
         }
-        bool inVisibleFrustum = visibleFrustum.inside(tileBounds);
         
         // Map tile is visible, calculate distance using camera plane
         const cglib::mat4x4<double>& mvpMat = viewState.getModelviewProjectionMat();
         double tileW = tileCenter(0) * mvpMat(3, 0) + tileCenter(1) * mvpMat(3, 1) + tileCenter(2) * mvpMat(3, 2) + mvpMat(3, 3);
-        double zoomDistance = tileW * std::pow(2.0f, tile.getZoom() - getZoomLevelBias());
+        double zoomDistance = tileW * std::pow(2.0f, tile.getZoom() - getAdjustedZoomLevelBias());
         bool subDivide = zoomDistance < SUBDIVISION_THRESHOLD * Const::SQRT_2;
-        int targetTileZoom = std::min(getMaxZoom(), static_cast<int>(viewState.getZoom() + getZoomLevelBias() + DISCRETE_ZOOM_LEVEL_BIAS));
+        int targetTileZoom = std::min(getMaxZoom(), static_cast<int>(viewState.getZoom() + getAdjustedZoomLevelBias() + DISCRETE_ZOOM_LEVEL_BIAS));
         if (getMinZoom() > tile.getZoom()) {
             subDivide = true;
         } else if (targetTileZoom <= tile.getZoom()) {
@@ -439,7 +757,7 @@ namespace carto {
         if (subDivide) {
             // The tile is too coarse, keep subdividing
             for (int n = 0; n < 4; n++) {
-                calculateVisibleTilesRecursive(cullState, tile.getChild(n), dataExtent);
+                calculateVisibleTilesRecursive(cullState, tile.getChild(n), dataExtent, insideFrustum);
             }
         } else {
             // Add the tile to visible tiles, sort by the distnace to the camera
@@ -489,6 +807,51 @@ namespace carto {
         });
     }
     
+    void TileLayer::reprioritizeFetchTasks(const ViewState& viewState) {
+        std::shared_ptr<CancelableThreadPool> tileThreadPool;
+        {
+            std::lock_guard<std::recursive_mutex> lock(_mutex);
+            tileThreadPool = _tileThreadPool;
+        }
+        if (!tileThreadPool) {
+            return;
+        }
+
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+        // Tag pending tasks with their distance from the camera. Also keep track of the time
+        // each tile was first requested, entries of finished tiles are dropped here.
+        typedef std::pair<double, std::shared_ptr<FetchTaskBase> > TaggedTask;
+        std::vector<TaggedTask> taggedTasks;
+        std::vector<std::shared_ptr<FetchTaskBase> > tasks = _fetchingTiles.getTasks();
+        taggedTasks.reserve(tasks.size());
+        std::unordered_map<long long, std::chrono::steady_clock::time_point> firstRequestTimes;
+        for (const std::shared_ptr<FetchTaskBase>& task : tasks) {
+            const MapTile& mapTile = task->getTile();
+            auto it = _fetchFirstRequestTimes.find(mapTile.getTileId());
+            firstRequestTimes[mapTile.getTileId()] = (it != _fetchFirstRequestTimes.end() ? it->second : now);
+
+            cglib::vec3<double> center = _tileTransformer->calculateTileOrigin(vt::TileId(mapTile.getZoom(), mapTile.getX(), mapTile.getY()));
+            taggedTasks.emplace_back(cglib::length(center - viewState.getCameraPos()), task);
+        }
+        std::swap(_fetchFirstRequestTimes, firstRequestTimes);
+
+        // Sort tasks based on the distance
+        std::sort(taggedTasks.begin(), taggedTasks.end(), [](const TaggedTask& task1, const TaggedTask& task2) {
+            return task1.first < task2.first;
+        });
+
+        // Recalculate task priorities, penalize distant tiles and boost long-pending tiles
+        for (std::size_t i = 0; i < taggedTasks.size(); i++) {
+            const std::shared_ptr<FetchTaskBase>& task = taggedTasks[i].second;
+            int priority = getUpdatePriority() + (task->isPreloading() ? PRELOADING_PRIORITY_OFFSET : 0);
+            priority -= static_cast<int>(std::min(i, static_cast<std::size_t>(MAX_FETCH_PRIORITY_PENALTY)));
+            auto age = std::chrono::duration_cast<std::chrono::seconds>(now - _fetchFirstRequestTimes[task->getTile().getTileId()]);
+            priority += std::min(static_cast<int>(age.count()), MAX_FETCH_PRIORITY_BONUS);
+            tileThreadPool->reprioritize(task, priority, task->isPreloading() ? ThreadQoS::BACKGROUND : ThreadQoS::UTILITY);
+        }
+    }
+
     void TileLayer::findTiles(const std::vector<MapTile>& visTiles, bool preloadingTiles) {
         for (const MapTile& visTile : visTiles) {
             int tileMask = (1 << visTile.getZoom()) - 1;
@@ -590,6 +953,11 @@ namespace carto {
         return MapBounds(MapPos(std::min(tilePos0.getX(), tilePos1.getX()), std::min(-tilePos0.getY(), -tilePos1.getY())), MapPos(std::max(tilePos0.getX(), tilePos1.getX()), std::max(-tilePos0.getY(), -tilePos1.getY())));
     }
 
+    void TileLayer::tilesChanged(const MapBounds& mapBounds, int minZoom, int maxZoom) {
+        // By default fall back to a full refresh, subclasses may implement partial refresh
+        tilesChanged(false);
+    }
+
     std::shared_ptr<vt::TileTransformer> TileLayer::getTileTransformer() const {
         std::lock_guard<std::recursive_mutex> lock(_mutex);
         return _tileTransformer;
@@ -626,7 +994,8 @@ namespace carto {
         _dataSourceTiles(),
         _preloadingTile(preloadingTile),
         _started(false),
-        _invalidated(false)
+        _invalidated(false),
+        _queueTime(std::chrono::steady_clock::now())
     {
         for (MapTile dataSourceTile = tile; true; ) {
             int zoom = dataSourceTile.getZoom();
@@ -640,6 +1009,10 @@ namespace carto {
         }
     }
     
+    const MapTile& TileLayer::FetchTaskBase::getTile() const {
+        return _tile;
+    }
+
     bool TileLayer::FetchTaskBase::isPreloading() const {
         return _preloadingTile;
     }
@@ -678,7 +1051,9 @@ namespace carto {
             }
             _started = true;
         }
-        
+
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
         bool refresh = false;
         try {
             refresh = loadTile(layer) && !_preloadingTile;
@@ -689,7 +1064,11 @@ namespace carto {
         catch (const std::exception& ex) {
             Log::Errorf("TileLayer::FetchTaskBase: Exception while loading tile: %s", ex.what());
         }
-    
+
+        layer->addTileLoadSample(TileLoadStage::TILE_LOAD_STAGE_FETCH, _tile,
+                                 std::chrono::duration_cast<std::chrono::duration<float> >(startTime - _queueTime).count(),
+                                 std::chrono::duration_cast<std::chrono::duration<float> >(std::chrono::steady_clock::now() - startTime).count());
+
         layer->_fetchingTiles.remove(_tile.getTileId());
 
         if (refresh) {
@@ -735,7 +1114,7 @@ namespace carto {
             std::shared_ptr<UTFGridTile> utfTile = UTFGridTile::DecodeUTFTile(tileData->getData());
             if (utfTile) {
                 std::lock_guard<std::recursive_mutex> lock(tileLayer->_mutex);
-                tileLayer->_utfGridTiles[dataSourceTile] = utfTile; // we ignore expiration info here
+                tileLayer->_utfGridTiles.put(dataSourceTile.getTileId(), utfTile, utfTile->getResidentSize()); // we ignore expiration info here
                 refresh = true;
             } else {
                 Log::Error("TileLayer::FetchTaskBase: Failed to decode UTF grid tile");
@@ -746,8 +1125,20 @@ namespace carto {
     }
 
     const float TileLayer::DISCRETE_ZOOM_LEVEL_BIAS = 0.001f;
+    const float TileLayer::REDUCED_QUALITY_ZOOM_LEVEL_BIAS = 1.0f;
 
     const double TileLayer::PRELOADING_TILE_SCALE = 1.5;
+    const double TileLayer::MIN_PRELOADING_TILE_SCALE = 1.1;
+
+    const double TileLayer::PRELOADING_MIN_BANDWIDTH = 256 * 1024; // bytes per second
+    const double TileLayer::PRELOADING_MAX_BANDWIDTH = 4 * 1024 * 1024;
+
+    const int TileLayer::DEFAULT_PRELOADING_TILE_BUDGET = 48;
+    const float TileLayer::PRELOADING_PARENT_BUDGET_WEIGHT = 0.25f;
+    const float TileLayer::PRELOADING_CHILD_BUDGET_WEIGHT = 0.25f;
+
+    const float TileLayer::PREDICTION_LOOKAHEAD_SECONDS = 0.5f;
+    const float TileLayer::MAX_PREDICTION_SAMPLE_AGE_SECONDS = 1.0f;
     const float TileLayer::SUBDIVISION_THRESHOLD = Const::WORLD_SIZE;
     
 }
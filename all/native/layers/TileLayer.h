@@ -10,20 +10,25 @@
 #include "core/MapPos.h"
 #include "core/MapBounds.h"
 #include "core/MapTile.h"
+#include "core/Variant.h"
 #include "components/CancelableTask.h"
 #include "components/DirectorPtr.h"
 #include "datasources/TileDataSource.h"
 #include "layers/Layer.h"
+#include "layers/TileLoadListener.h"
 #include "layers/components/FetchingTileTasks.h"
 
 #include <atomic>
+#include <chrono>
+#include <mutex>
 #include <unordered_map>
 
+#include <stdext/timed_lru_cache.h>
+
 namespace carto {
     class CancelableTask;
     class CullState;
     class TileRenderer;
-    class TileLoadListener;
     class UTFGridTile;
     class UTFGridEventListener;
     namespace vt {
@@ -85,7 +90,7 @@ namespace carto {
          * Loading a new frame may take some time, previous frame is shown during loading.
          * @param frameNr The frame number to display.
          */
-        void setFrameNr(int frameNr);
+        virtual void setFrameNr(int frameNr);
     
         /**
          * Returns the state of the preloading flag of this layer.
@@ -102,7 +107,22 @@ namespace carto {
          * @param preloading The new preloading state of the layer.
          */
         void setPreloading(bool preloading);
-        
+
+        /**
+         * Returns the speculative tile budget used when preloading is enabled.
+         * @return The maximum number of speculative tile fetches per view change.
+         */
+        int getPreloadingTileBudget() const;
+        /**
+         * Sets the speculative tile budget used when preloading is enabled. The budget limits
+         * how many parent tiles, tiles in the panning direction and child tiles are prefetched
+         * per view change, so speculative fetches do not evict the visible tiles and their
+         * immediate neighbors from the tile cache. The budget is automatically reduced when
+         * the underlying cache data source reports evictions. The default is 48.
+         * @param tileBudget The new tile budget. Use 0 to disable speculative prefetching.
+         */
+        void setPreloadingTileBudget(int tileBudget);
+
         /**
          * Returns the state of the synchronized refresh flag.
          * @return The state of the synchronized refresh flag.
@@ -188,6 +208,20 @@ namespace carto {
          */
         MapBounds calculateMapTileBounds(const MapTile& mapTile) const;
 
+        /**
+         * Returns the list of tiles currently visible in the view.
+         * @return The list of visible tiles.
+         */
+        std::vector<MapTile> getVisibleTiles() const;
+
+        /**
+         * Schedules immediate loading of the specified tiles into the layer tile cache.
+         * Tiles that are already cached are skipped. This can be used to warm up the layer
+         * before the first frame is drawn, for example when restoring a previous map session.
+         * @param mapTiles The list of tiles to load.
+         */
+        void preloadTiles(const std::vector<MapTile>& mapTiles);
+
         /**
          * Clears layer tile caches. This will release memory allocated to tiles.
          * @param all True if all tiles should be released, otherwise only preloading (invisible) tiles are released.
@@ -215,7 +249,15 @@ namespace carto {
          * @param utfGridEventListener The UTF grid event listener.
          */
         void setUTFGridEventListener(const std::shared_ptr<UTFGridEventListener>& utfGridEventListener);
-    
+
+        /**
+         * Returns aggregated tile load timing statistics for this layer.
+         * The statistics contain sample counts and 50th/90th/99th percentile durations
+         * in seconds for the fetch and decode stages, keyed by stage name.
+         * @return The aggregated tile load statistics.
+         */
+        Variant getTileLoadStatistics() const;
+
         virtual bool isUpdateInProgress() const;
         
     protected:
@@ -224,7 +266,8 @@ namespace carto {
             explicit DataSourceListener(const std::shared_ptr<TileLayer>& layer);
             
             virtual void onTilesChanged(bool removeTiles);
-            
+            virtual void onTilesChanged(const MapBounds& mapBounds, int minZoom, int maxZoom);
+
         private:
             std::weak_ptr<TileLayer> _layer;
         };
@@ -232,7 +275,8 @@ namespace carto {
         class FetchTaskBase : public CancelableTask {
         public:
             FetchTaskBase(const std::shared_ptr<TileLayer>& layer, const MapTile& tile, bool preloadingTile);
-            
+
+            const MapTile& getTile() const;
             bool isPreloading() const;
             bool isInvalidated() const;
             void invalidate();
@@ -252,6 +296,7 @@ namespace carto {
             bool _preloadingTile;
             bool _started;
             bool _invalidated;
+            std::chrono::steady_clock::time_point _queueTime;
         };
         
         explicit TileLayer(const std::shared_ptr<TileDataSource>& dataSource);
@@ -271,6 +316,7 @@ namespace carto {
         virtual void fetchTile(const MapTile& tile, bool preloadingTile, bool invalidated) = 0;
         virtual void clearTiles(bool preloadingTiles) = 0;
         virtual void tilesChanged(bool removeTiles) = 0;
+        virtual void tilesChanged(const MapBounds& mapBounds, int minZoom, int maxZoom);
 
         virtual void calculateDrawData(const MapTile& visTile, const MapTile& closestTile, bool preloadingTile) = 0;
         virtual void refreshDrawData(const std::shared_ptr<CullState>& cullState) = 0;
@@ -282,15 +328,26 @@ namespace carto {
         virtual void calculateRayIntersectedElements(const cglib::ray3<double>& ray, const ViewState& viewState, std::vector<RayIntersectedElement>& results) const;
         virtual bool processClick(ClickType::ClickType clickType, const RayIntersectedElement& intersectedElement, const ViewState& viewState) const;
 
+        virtual void onMemoryWarning();
+
+        virtual void setReducedQuality(bool reduced);
+
         MapBounds calculateInternalTileBounds(const MapTile& mapTile) const;
 
+        float getAdjustedZoomLevelBias() const;
+
         std::shared_ptr<vt::TileTransformer> getTileTransformer() const;
         void resetTileTransformer();
 
         std::shared_ptr<TileRenderer> getTileRenderer() const;
         void setTileRenderer(const std::shared_ptr<TileRenderer>& renderer);
 
+        void addTileLoadSample(TileLoadStage::TileLoadStage stage, const MapTile& tile, float queueDelay, float duration);
+
         static const float DISCRETE_ZOOM_LEVEL_BIAS;
+        static const float REDUCED_QUALITY_ZOOM_LEVEL_BIAS; // extra bias applied in reduced quality mode, makes the layer use coarser tiles
+
+        static const int PRELOADING_PRIORITY_OFFSET = -2;
 
         std::atomic<bool> _synchronizedRefresh;
 
@@ -312,33 +369,74 @@ namespace carto {
         int _lastFrameNr;
     
         bool _preloading;
-        
+        int _preloadingTileBudget;
+
         TileSubstitutionPolicy::TileSubstitutionPolicy _substitutionPolicy;
     
         float _zoomLevelBias;
         int _maxOverzoomLevel;
         int _maxUnderzoomLevel;
+        bool _qualityReduced;
     
     private:
         void calculateVisibleTiles(const std::shared_ptr<CullState>& cullState);
-        void calculateVisibleTilesRecursive(const std::shared_ptr<CullState>& cullState, const MapTile& mapTile, const MapBounds& dataExtent);
+        void calculateVisibleTilesRecursive(const std::shared_ptr<CullState>& cullState, const MapTile& mapTile, const MapBounds& dataExtent, bool insideFrustum);
+
+        int calculatePreloadingTileBudget();
+        void prefetchParentTiles(int& tileBudget);
+        void prefetchPredictedTiles(const std::shared_ptr<CullState>& cullState, int& tileBudget);
+        void prefetchZoomInTiles(const std::shared_ptr<CullState>& cullState, int& tileBudget);
+        void prefetchZoomOutTiles(const std::shared_ptr<CullState>& cullState);
 
         void sortTiles(std::vector<MapTile>& tiles, const ViewState& viewState, bool preloadingTiles);
+        void reprioritizeFetchTasks(const ViewState& viewState);
         void findTiles(const std::vector<MapTile>& visTiles, bool preloadingTiles);
         bool findParentTile(const MapTile& visTile, const MapTile& tile, int depth, bool preloadingCache, bool preloadingTile);
         int findChildTiles(const MapTile& visTile, const MapTile& tile, int depth, bool preloadingCache, bool preloadingTile);
     
         static const int MAX_PARENT_SEARCH_DEPTH = 6;
         static const int MAX_CHILD_SEARCH_DEPTH = 3;
+
+        static const int MAX_FETCH_PRIORITY_PENALTY = 8;
+        static const int MAX_FETCH_PRIORITY_BONUS = 10; // must exceed MAX_FETCH_PRIORITY_PENALTY to prevent starvation of distant tiles
         
         static const double PRELOADING_TILE_SCALE;
+        static const double MIN_PRELOADING_TILE_SCALE;
         static const float SUBDIVISION_THRESHOLD;
-        
+
+        static const double PRELOADING_MIN_BANDWIDTH;
+        static const double PRELOADING_MAX_BANDWIDTH;
+
+        static const int DEFAULT_PRELOADING_TILE_BUDGET;
+        static const float PRELOADING_PARENT_BUDGET_WEIGHT;
+        static const float PRELOADING_CHILD_BUDGET_WEIGHT;
+
+        static const float PREDICTION_LOOKAHEAD_SECONDS;
+        static const float MAX_PREDICTION_SAMPLE_AGE_SECONDS;
+
+        static const int DEFAULT_UTFGRID_CACHE_SIZE = 4 * 1024 * 1024;
+
+        static const int MAX_TILE_LOAD_SAMPLES = 1024;
+        static const int TILE_LOAD_STAGE_COUNT = 2;
+
         std::vector<MapTile> _visibleTiles;
+        bool _lastFocusPosValid;
+        cglib::vec3<double> _lastFocusPos;
+        std::chrono::steady_clock::time_point _lastFocusPosTime;
+        bool _lastZoomValid;
+        float _lastZoom;
+        std::chrono::steady_clock::time_point _lastZoomTime;
         std::vector<MapTile> _preloadingTiles;
-        std::unordered_map<MapTile, std::shared_ptr<UTFGridTile> > _utfGridTiles;
+        double _preloadingTileScale;
+        bool _lastCacheEvictionCountValid;
+        long long _lastCacheEvictionCount;
+        std::unordered_map<long long, std::chrono::steady_clock::time_point> _fetchFirstRequestTimes;
+        cache::timed_lru_cache<long long, std::shared_ptr<UTFGridTile> > _utfGridTiles;
         std::shared_ptr<TileRenderer> _tileRenderer;
         std::shared_ptr<vt::TileTransformer> _tileTransformer;
+        std::vector<float> _tileLoadSamples[TILE_LOAD_STAGE_COUNT];
+        std::size_t _tileLoadSampleIndexes[TILE_LOAD_STAGE_COUNT];
+        mutable std::mutex _tileLoadSamplesMutex;
     };
     
 }
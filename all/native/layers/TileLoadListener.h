@@ -7,8 +7,26 @@
 #ifndef _CARTO_TILELOADLISTENER_H_
 #define _CARTO_TILELOADLISTENER_H_
 
+#include "core/MapTile.h"
+
 namespace carto {
 
+    namespace TileLoadStage {
+        /**
+         * Tile loading stages.
+         */
+        enum TileLoadStage {
+            /**
+             * The tile data was fetched from the data source.
+             */
+            TILE_LOAD_STAGE_FETCH,
+            /**
+             * The fetched tile data was decoded.
+             */
+            TILE_LOAD_STAGE_DECODE
+        };
+    }
+
     /**
      * Interface for monitoring tile loading events.
      */
@@ -20,12 +38,22 @@ namespace carto {
          * Listener method that gets called when all visible raster tiles have finished loading.
          */
         virtual void onVisibleTilesLoaded() { }
-    
+
         /**
          * Listener method that gets called when all preloading raster tiles have finished loading.
          * This method gets called after onVisibleTilesLoaded() and only if preloading is enabled.
          */
         virtual void onPreloadingTilesLoaded() { }
+
+        /**
+         * Listener method that gets called when a single tile has finished a loading stage.
+         * The method is called from a background worker thread, so the implementation must be fast.
+         * @param tile The tile that finished the stage.
+         * @param stage The finished loading stage.
+         * @param queueDelay The time the stage spent queued before it was started, in seconds.
+         * @param duration The time spent executing the stage, in seconds.
+         */
+        virtual void onTileLoadProgress(const MapTile& tile, TileLoadStage::TileLoadStage stage, float queueDelay, float duration) { }
     };
         
 }
@@ -32,6 +32,15 @@ namespace carto {
         return static_cast<int>(count);
     }
 
+    void TorqueTileLayer::setFrameNr(int frameNr) {
+        // Re-anchor the decoded frame window of the decoder. This may invalidate the loaded
+        // tiles, so it must be done before the base class refreshes the layer.
+        if (auto decoder = std::static_pointer_cast<TorqueTileDecoder>(getTileDecoder())) {
+            decoder->setBaseFrameNr(frameNr);
+        }
+        VectorTileLayer::setFrameNr(frameNr);
+    }
+
     bool TorqueTileLayer::onDrawFrame(float deltaSeconds, BillboardSorter& billboardSorter, StyleTextureCache& styleCache, const ViewState& viewState) {
         updateTileLoadListener();
 
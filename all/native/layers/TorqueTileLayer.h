@@ -35,6 +35,8 @@ namespace carto {
          */
         int countVisibleFeatures(int frameNr) const;
 
+        virtual void setFrameNr(int frameNr);
+
     protected:
         virtual bool onDrawFrame(float deltaSeconds, BillboardSorter& billboardSorter, StyleTextureCache& styleCache, const ViewState& viewState);
     };
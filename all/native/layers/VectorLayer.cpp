@@ -1,6 +1,7 @@
 #include "VectorLayer.h"
 #include "components/Exceptions.h"
 #include "components/CancelableThreadPool.h"
+#include "components/Options.h"
 #include "datasources/VectorDataSource.h"
 #include "graphics/Bitmap.h"
 #include "layers/VectorElementEventListener.h"
@@ -36,7 +37,10 @@
 #include "vectorelements/Popup.h"
 #include "ui/VectorElementClickInfo.h"
 #include "utils/Log.h"
+#include "utils/PoolAllocator.h"
 
+#include <atomic>
+#include <thread>
 #include <vector>
 
 namespace carto {
@@ -171,6 +175,13 @@ namespace carto {
         _nmlModelRenderer->onSurfaceCreated(shaderManager, textureManager);
     }
     
+    void VectorLayer::warmUpStyles(StyleTextureCache& styleCache) {
+        // Pre-create the textures of the bitmap-based renderers, other renderers
+        // either do not use style textures or create them per-frame anyway
+        _billboardRenderer->warmUpStyles(styleCache);
+        _pointRenderer->warmUpStyles(styleCache);
+    }
+
     bool VectorLayer::onDrawFrame(float deltaSeconds, BillboardSorter& billboardSorter, StyleTextureCache& styleCache, const ViewState& viewState) {
         if (std::shared_ptr<MapRenderer> mapRenderer = _mapRenderer.lock()) {
             float opacity = getOpacity();
@@ -202,7 +213,11 @@ namespace carto {
         }
         return false;
     }
-    
+
+    bool VectorLayer::onDrawFrameBillboards(float deltaSeconds, BillboardSorter& billboardSorter, StyleTextureCache& styleCache, const ViewState& viewState) {
+        return _billboardRenderer->onDrawFrame(deltaSeconds, billboardSorter, styleCache, viewState);
+    }
+
     void VectorLayer::onSurfaceDestroyed() {
         _billboardRenderer->onSurfaceDestroyed();
         _geometryCollectionRenderer->onSurfaceDestroyed();
@@ -213,7 +228,16 @@ namespace carto {
         _nmlModelRenderer->onSurfaceDestroyed();
         Layer::onSurfaceDestroyed();
     }
-    
+
+    void VectorLayer::onMemoryWarning() {
+        // Trim the CPU-side geometry assembly buffers back from their high-water sizes
+        _geometryCollectionRenderer->trimBuffers();
+        _lineRenderer->trimBuffers();
+        _pointRenderer->trimBuffers();
+        _polygonRenderer->trimBuffers();
+        Layer::onMemoryWarning();
+    }
+
     void VectorLayer::calculateRayIntersectedElements(const cglib::ray3<double>& ray, const ViewState& viewState, std::vector<RayIntersectedElement>& results) const {
         std::shared_ptr<VectorLayer> thisLayer = std::static_pointer_cast<VectorLayer>(std::const_pointer_cast<Layer>(shared_from_this()));
         _billboardRenderer->calculateRayIntersectedElements(thisLayer, ray, viewState, results);
@@ -285,13 +309,15 @@ namespace carto {
 
         if (mapRenderer) {
             if (billboardsChanged) {
-                // Billboards were added, calculate new placements
+                // Billboards were changed, calculate new placements. This also requests
+                // a redraw, without invalidating the cached layers frame buffer.
                 mapRenderer->billboardsChanged();
+            } else {
+                mapRenderer->requestRedraw();
             }
-            mapRenderer->requestRedraw();
         }
     }
-    
+
     void VectorLayer::addRendererElement(const std::shared_ptr<VectorElement>& element) {
         if (!element->isVisible()) {
             return;
@@ -300,58 +326,110 @@ namespace carto {
         std::shared_ptr<ProjectionSurface> projectionSurface;
         {
             std::lock_guard<std::recursive_mutex> lock(_mutex);
-            if (auto mapRenderer = _mapRenderer.lock()) {
-                projectionSurface = mapRenderer->getProjectionSurface();
+            if (auto options = _options.lock()) {
+                projectionSurface = options->getProjectionSurface();
             }
         }
         if (!projectionSurface) {
             return;
         }
 
+        // Rebuild the draw data only if the element has changed after the existing draw data was built.
+        // The change generation is captured before building, so that concurrent changes simply trigger another rebuild.
         if (const std::shared_ptr<Label>& label = std::dynamic_pointer_cast<Label>(element)) {
-            if (!label->getDrawData() || label->getDrawData()->isOffset()) {
-                label->setDrawData(std::make_shared<LabelDrawData>(*label, *label->getStyle(), *_dataSource->getProjection(), *projectionSurface, _lastCullState->getViewState()));
+            long long changeGeneration = label->getChangeGeneration();
+            std::shared_ptr<BillboardDrawData> drawData = label->getDrawData();
+            if (!drawData || drawData->isOffset() || drawData->getProjectionSurface() != projectionSurface || drawData->getChangeGeneration() != changeGeneration) {
+                drawData = std::allocate_shared<LabelDrawData>(PoolAllocator<LabelDrawData>(), *label, *label->getStyle(), *_dataSource->getProjection(), *projectionSurface, _lastCullState->getViewState());
+                drawData->setChangeGeneration(changeGeneration);
+                drawData->setProjectionSurface(projectionSurface);
+                label->setDrawData(drawData);
             }
             _billboardRenderer->addElement(label);
         } else if (const std::shared_ptr<Line>& line = std::dynamic_pointer_cast<Line>(element)) {
-            if (!line->getDrawData() || line->getDrawData()->isOffset()) {
-                line->setDrawData(std::make_shared<LineDrawData>(*line->getGeometry(), *line->getStyle(), *_dataSource->getProjection(), *projectionSurface));
+            long long changeGeneration = line->getChangeGeneration();
+            std::shared_ptr<LineDrawData> drawData = line->getDrawData();
+            if (!drawData || drawData->isOffset() || drawData->getProjectionSurface() != projectionSurface || drawData->getChangeGeneration() != changeGeneration) {
+                if (drawData && !drawData->isOffset() && drawData->getProjectionSurface() == projectionSurface) {
+                    // The geometry is unchanged (changing it resets the draw data), reuse the tessellation
+                    drawData = std::allocate_shared<LineDrawData>(PoolAllocator<LineDrawData>(), *drawData, *line->getStyle());
+                } else {
+                    drawData = std::allocate_shared<LineDrawData>(PoolAllocator<LineDrawData>(), *line->getGeometry(), *line->getStyle(), *_dataSource->getProjection(), *projectionSurface);
+                }
+                drawData->setChangeGeneration(changeGeneration);
+                drawData->setProjectionSurface(projectionSurface);
+                line->setDrawData(drawData);
             }
             _lineRenderer->addElement(line);
         } else if (const std::shared_ptr<Marker>& marker = std::dynamic_pointer_cast<Marker>(element)) {
-            if (!marker->getDrawData() || marker->getDrawData()->isOffset()) {
-                marker->setDrawData(std::make_shared<MarkerDrawData>(*marker, *marker->getStyle(), *_dataSource->getProjection(), *projectionSurface));
+            long long changeGeneration = marker->getChangeGeneration();
+            std::shared_ptr<BillboardDrawData> drawData = marker->getDrawData();
+            if (!drawData || drawData->isOffset() || drawData->getProjectionSurface() != projectionSurface || drawData->getChangeGeneration() != changeGeneration) {
+                drawData = std::allocate_shared<MarkerDrawData>(PoolAllocator<MarkerDrawData>(), *marker, *marker->getStyle(), *_dataSource->getProjection(), *projectionSurface);
+                drawData->setChangeGeneration(changeGeneration);
+                drawData->setProjectionSurface(projectionSurface);
+                marker->setDrawData(drawData);
             }
             _billboardRenderer->addElement(marker);
         } else if (const std::shared_ptr<Point>& point = std::dynamic_pointer_cast<Point>(element)) {
-            if (!point->getDrawData() || point->getDrawData()->isOffset()) {
-                point->setDrawData(std::make_shared<PointDrawData>(*point->getGeometry(), *point->getStyle(), *_dataSource->getProjection(), *projectionSurface));
+            long long changeGeneration = point->getChangeGeneration();
+            std::shared_ptr<PointDrawData> drawData = point->getDrawData();
+            if (!drawData || drawData->isOffset() || drawData->getProjectionSurface() != projectionSurface || drawData->getChangeGeneration() != changeGeneration) {
+                drawData = std::allocate_shared<PointDrawData>(PoolAllocator<PointDrawData>(), *point->getGeometry(), *point->getStyle(), *_dataSource->getProjection(), *projectionSurface);
+                drawData->setChangeGeneration(changeGeneration);
+                drawData->setProjectionSurface(projectionSurface);
+                point->setDrawData(drawData);
             }
             _pointRenderer->addElement(point);
         } else if (const std::shared_ptr<Polygon>& polygon = std::dynamic_pointer_cast<Polygon>(element)) {
-            if (!polygon->getDrawData() || polygon->getDrawData()->isOffset()) {
-                polygon->setDrawData(std::make_shared<PolygonDrawData>(*polygon->getGeometry(), *polygon->getStyle(), *_dataSource->getProjection(), *projectionSurface));
+            long long changeGeneration = polygon->getChangeGeneration();
+            std::shared_ptr<PolygonDrawData> drawData = polygon->getDrawData();
+            if (!drawData || drawData->isOffset() || drawData->getProjectionSurface() != projectionSurface || drawData->getChangeGeneration() != changeGeneration) {
+                drawData = std::allocate_shared<PolygonDrawData>(PoolAllocator<PolygonDrawData>(), *polygon, *polygon->getStyle(), *_dataSource->getProjection(), *projectionSurface, drawData);
+                drawData->setChangeGeneration(changeGeneration);
+                drawData->setProjectionSurface(projectionSurface);
+                polygon->setDrawData(drawData);
             }
             _polygonRenderer->addElement(polygon);
         } else if (const std::shared_ptr<GeometryCollection>& geomCollection = std::dynamic_pointer_cast<GeometryCollection>(element)) {
-            if (!geomCollection->getDrawData() || geomCollection->getDrawData()->isOffset()) {
-                geomCollection->setDrawData(std::make_shared<GeometryCollectionDrawData>(*geomCollection->getGeometry(), *geomCollection->getStyle(), *_dataSource->getProjection(), *projectionSurface));
+            long long changeGeneration = geomCollection->getChangeGeneration();
+            std::shared_ptr<GeometryCollectionDrawData> drawData = geomCollection->getDrawData();
+            if (!drawData || drawData->isOffset() || drawData->getProjectionSurface() != projectionSurface || drawData->getChangeGeneration() != changeGeneration) {
+                drawData = std::allocate_shared<GeometryCollectionDrawData>(PoolAllocator<GeometryCollectionDrawData>(), *geomCollection->getGeometry(), *geomCollection->getStyle(), *_dataSource->getProjection(), *projectionSurface);
+                drawData->setChangeGeneration(changeGeneration);
+                drawData->setProjectionSurface(projectionSurface);
+                geomCollection->setDrawData(drawData);
             }
             _geometryCollectionRenderer->addElement(geomCollection);
         } else if (const std::shared_ptr<Polygon3D>& polygon3D = std::dynamic_pointer_cast<Polygon3D>(element)) {
-            if (!polygon3D->getDrawData() || polygon3D->getDrawData()->isOffset()) {
-                polygon3D->setDrawData(std::make_shared<Polygon3DDrawData>(*polygon3D, *polygon3D->getStyle(), *_dataSource->getProjection(), *projectionSurface));
+            long long changeGeneration = polygon3D->getChangeGeneration();
+            std::shared_ptr<Polygon3DDrawData> drawData = polygon3D->getDrawData();
+            if (!drawData || drawData->isOffset() || drawData->getProjectionSurface() != projectionSurface || drawData->getChangeGeneration() != changeGeneration) {
+                drawData = std::make_shared<Polygon3DDrawData>(*polygon3D, *polygon3D->getStyle(), *_dataSource->getProjection(), *projectionSurface, drawData);
+                drawData->setChangeGeneration(changeGeneration);
+                drawData->setProjectionSurface(projectionSurface);
+                polygon3D->setDrawData(drawData);
             }
             _polygon3DRenderer->addElement(polygon3D);
         } else if (const std::shared_ptr<NMLModel>& nmlModel = std::dynamic_pointer_cast<NMLModel>(element)) {
-            if (!nmlModel->getDrawData() || nmlModel->getDrawData()->isOffset()) {
-                nmlModel->setDrawData(std::make_shared<NMLModelDrawData>(*nmlModel, *nmlModel->getStyle(), *_dataSource->getProjection(), *projectionSurface));
+            long long changeGeneration = nmlModel->getChangeGeneration();
+            std::shared_ptr<NMLModelDrawData> drawData = nmlModel->getDrawData();
+            if (!drawData || drawData->isOffset() || drawData->getProjectionSurface() != projectionSurface || drawData->getChangeGeneration() != changeGeneration) {
+                drawData = std::allocate_shared<NMLModelDrawData>(PoolAllocator<NMLModelDrawData>(), *nmlModel, *nmlModel->getStyle(), *_dataSource->getProjection(), *projectionSurface);
+                drawData->setChangeGeneration(changeGeneration);
+                drawData->setProjectionSurface(projectionSurface);
+                nmlModel->setDrawData(drawData);
             }
             _nmlModelRenderer->addElement(nmlModel);
         } else if (const std::shared_ptr<Popup>& popup = std::dynamic_pointer_cast<Popup>(element)) {
-            if (!popup->getDrawData() || popup->getDrawData()->isOffset()) {
+            long long changeGeneration = popup->getChangeGeneration();
+            std::shared_ptr<BillboardDrawData> drawData = popup->getDrawData();
+            if (!drawData || drawData->isOffset() || drawData->getProjectionSurface() != projectionSurface || drawData->getChangeGeneration() != changeGeneration) {
                 if (auto options = _options.lock()) {
-                    popup->setDrawData(std::make_shared<PopupDrawData>(*popup, *popup->getStyle(), *_dataSource->getProjection(), *projectionSurface, options, _lastCullState->getViewState()));
+                    drawData = std::allocate_shared<PopupDrawData>(PoolAllocator<PopupDrawData>(), *popup, *popup->getStyle(), *_dataSource->getProjection(), *projectionSurface, options, _lastCullState->getViewState());
+                    drawData->setChangeGeneration(changeGeneration);
+                    drawData->setProjectionSurface(projectionSurface);
+                    popup->setDrawData(drawData);
                 } else {
                     return;
                 }
@@ -360,6 +438,64 @@ namespace carto {
         }
     }
     
+    void VectorLayer::buildPolygonDrawDatas(const std::vector<std::shared_ptr<VectorElement> >& elements) {
+        std::shared_ptr<ProjectionSurface> projectionSurface;
+        {
+            std::lock_guard<std::recursive_mutex> lock(_mutex);
+            if (auto options = _options.lock()) {
+                projectionSurface = options->getProjectionSurface();
+            }
+        }
+        if (!projectionSurface) {
+            return;
+        }
+
+        // Collect the polygons whose draw data needs to be rebuilt
+        std::vector<std::shared_ptr<Polygon> > stalePolygons;
+        for (const std::shared_ptr<VectorElement>& element : elements) {
+            if (const std::shared_ptr<Polygon>& polygon = std::dynamic_pointer_cast<Polygon>(element)) {
+                if (polygon->isVisible()) {
+                    std::shared_ptr<PolygonDrawData> drawData = polygon->getDrawData();
+                    if (!drawData || drawData->isOffset() || drawData->getProjectionSurface() != projectionSurface || drawData->getChangeGeneration() != polygon->getChangeGeneration()) {
+                        stalePolygons.push_back(polygon);
+                    }
+                }
+            }
+        }
+
+        // For small batches or single-core devices simply let addRendererElement triangulate
+        unsigned int threadCount = std::max(std::thread::hardware_concurrency(), 1U);
+        if (threadCount < 2 || stalePolygons.size() < threadCount * 4) {
+            return;
+        }
+
+        // Triangulate in parallel, addRendererElement will then find fresh draw data and skip
+        // the rebuild. Concurrent element changes simply bump the change generation and cause
+        // another rebuild, so no synchronization beyond the element mutex is needed.
+        std::atomic<std::size_t> polygonIndex(0);
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount);
+        for (unsigned int i = 0; i < threadCount; i++) {
+            threads.emplace_back([this, &stalePolygons, &polygonIndex, &projectionSurface]() {
+                while (true) {
+                    std::size_t index = polygonIndex.fetch_add(1);
+                    if (index >= stalePolygons.size()) {
+                        break;
+                    }
+                    const std::shared_ptr<Polygon>& polygon = stalePolygons[index];
+                    long long changeGeneration = polygon->getChangeGeneration();
+                    auto drawData = std::allocate_shared<PolygonDrawData>(PoolAllocator<PolygonDrawData>(), *polygon, *polygon->getStyle(), *_dataSource->getProjection(), *projectionSurface, polygon->getDrawData());
+                    drawData->setChangeGeneration(changeGeneration);
+                    drawData->setProjectionSurface(projectionSurface);
+                    polygon->setDrawData(drawData);
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
     bool VectorLayer::refreshRendererElements() {
         bool billboardsChanged = _billboardRenderer->getElementCount() > 0; // if there are any billboards currently, assume they have changed (or removed)
         _billboardRenderer->refreshElements();
@@ -382,8 +518,8 @@ namespace carto {
         std::shared_ptr<ProjectionSurface> projectionSurface;
         {
             std::lock_guard<std::recursive_mutex> lock(_mutex);
-            if (auto mapRenderer = _mapRenderer.lock()) {
-                projectionSurface = mapRenderer->getProjectionSurface();
+            if (auto options = _options.lock()) {
+                projectionSurface = options->getProjectionSurface();
             }
         }
         if (!projectionSurface) {
@@ -393,7 +529,11 @@ namespace carto {
         // Update/remove the draw data of a single element in one of the renderers,
         if (const std::shared_ptr<Label>& label = std::dynamic_pointer_cast<Label>(element)) {
             if (visible && !remove) {
-                label->setDrawData(std::make_shared<LabelDrawData>(*label, *label->getStyle(), *_dataSource->getProjection(), *projectionSurface, viewState));
+                long long changeGeneration = label->getChangeGeneration();
+                auto drawData = std::allocate_shared<LabelDrawData>(PoolAllocator<LabelDrawData>(), *label, *label->getStyle(), *_dataSource->getProjection(), *projectionSurface, viewState);
+                drawData->setChangeGeneration(changeGeneration);
+                drawData->setProjectionSurface(projectionSurface);
+                label->setDrawData(drawData);
                 _billboardRenderer->updateElement(label);
             } else {
                 _billboardRenderer->removeElement(label);
@@ -401,14 +541,29 @@ namespace carto {
             billboardsChanged = true;
         } else if (const std::shared_ptr<Line>& line = std::dynamic_pointer_cast<Line>(element)) {
             if (visible && !remove) {
-                line->setDrawData(std::make_shared<LineDrawData>(*line->getGeometry(), *line->getStyle(), *_dataSource->getProjection(), *projectionSurface));
+                long long changeGeneration = line->getChangeGeneration();
+                std::shared_ptr<LineDrawData> drawData = line->getDrawData();
+                if (drawData && !drawData->isOffset() && drawData->getProjectionSurface() == projectionSurface) {
+                    // The geometry is unchanged (changing it resets the draw data), reuse the tessellation;
+                    // fully compatible styles additionally reuse the vertex arrays
+                    drawData = std::allocate_shared<LineDrawData>(PoolAllocator<LineDrawData>(), *drawData, *line->getStyle());
+                } else {
+                    drawData = std::allocate_shared<LineDrawData>(PoolAllocator<LineDrawData>(), *line->getGeometry(), *line->getStyle(), *_dataSource->getProjection(), *projectionSurface);
+                }
+                drawData->setChangeGeneration(changeGeneration);
+                drawData->setProjectionSurface(projectionSurface);
+                line->setDrawData(drawData);
                 _lineRenderer->updateElement(line);
             } else {
                 _lineRenderer->removeElement(line);
             }
         } else if (const std::shared_ptr<Marker>& marker = std::dynamic_pointer_cast<Marker>(element)) {
             if (visible && !remove) {
-                marker->setDrawData(std::make_shared<MarkerDrawData>(*marker, *marker->getStyle(), *_dataSource->getProjection(), *projectionSurface));
+                long long changeGeneration = marker->getChangeGeneration();
+                auto drawData = std::allocate_shared<MarkerDrawData>(PoolAllocator<MarkerDrawData>(), *marker, *marker->getStyle(), *_dataSource->getProjection(), *projectionSurface);
+                drawData->setChangeGeneration(changeGeneration);
+                drawData->setProjectionSurface(projectionSurface);
+                marker->setDrawData(drawData);
                 _billboardRenderer->updateElement(marker);
             } else {
                 _billboardRenderer->removeElement(marker);
@@ -416,35 +571,55 @@ namespace carto {
             billboardsChanged = true;
         } else if (const std::shared_ptr<Point>& point = std::dynamic_pointer_cast<Point>(element)) {
             if (visible && !remove) {
-                point->setDrawData(std::make_shared<PointDrawData>(*point->getGeometry(), *point->getStyle(), *_dataSource->getProjection(), *projectionSurface));
+                long long changeGeneration = point->getChangeGeneration();
+                auto drawData = std::allocate_shared<PointDrawData>(PoolAllocator<PointDrawData>(), *point->getGeometry(), *point->getStyle(), *_dataSource->getProjection(), *projectionSurface);
+                drawData->setChangeGeneration(changeGeneration);
+                drawData->setProjectionSurface(projectionSurface);
+                point->setDrawData(drawData);
                 _pointRenderer->updateElement(point);
             } else {
                 _pointRenderer->removeElement(point);
             }
         } else if (const std::shared_ptr<Polygon>& polygon = std::dynamic_pointer_cast<Polygon>(element)) {
             if (visible && !remove) {
-                polygon->setDrawData(std::make_shared<PolygonDrawData>(*polygon->getGeometry(), *polygon->getStyle(), *_dataSource->getProjection(), *projectionSurface));
+                long long changeGeneration = polygon->getChangeGeneration();
+                auto drawData = std::allocate_shared<PolygonDrawData>(PoolAllocator<PolygonDrawData>(), *polygon, *polygon->getStyle(), *_dataSource->getProjection(), *projectionSurface, polygon->getDrawData());
+                drawData->setChangeGeneration(changeGeneration);
+                drawData->setProjectionSurface(projectionSurface);
+                polygon->setDrawData(drawData);
                 _polygonRenderer->updateElement(polygon);
             } else {
                 _polygonRenderer->removeElement(polygon);
             }
         } else if (const std::shared_ptr<GeometryCollection>& geomCollection = std::dynamic_pointer_cast<GeometryCollection>(element)) {
             if (visible && !remove) {
-                geomCollection->setDrawData(std::make_shared<GeometryCollectionDrawData>(*geomCollection->getGeometry(), *geomCollection->getStyle(), *_dataSource->getProjection(), *projectionSurface));
+                long long changeGeneration = geomCollection->getChangeGeneration();
+                auto drawData = std::allocate_shared<GeometryCollectionDrawData>(PoolAllocator<GeometryCollectionDrawData>(), *geomCollection->getGeometry(), *geomCollection->getStyle(), *_dataSource->getProjection(), *projectionSurface);
+                drawData->setChangeGeneration(changeGeneration);
+                drawData->setProjectionSurface(projectionSurface);
+                geomCollection->setDrawData(drawData);
                 _geometryCollectionRenderer->updateElement(geomCollection);
             } else {
                 _geometryCollectionRenderer->removeElement(geomCollection);
             }
         } else if (const std::shared_ptr<Polygon3D>& polygon3D = std::dynamic_pointer_cast<Polygon3D>(element)) {
             if (visible && !remove) {
-                polygon3D->setDrawData(std::make_shared<Polygon3DDrawData>(*polygon3D, *polygon3D->getStyle(), *_dataSource->getProjection(), *projectionSurface));
+                long long changeGeneration = polygon3D->getChangeGeneration();
+                auto drawData = std::make_shared<Polygon3DDrawData>(*polygon3D, *polygon3D->getStyle(), *_dataSource->getProjection(), *projectionSurface, polygon3D->getDrawData());
+                drawData->setChangeGeneration(changeGeneration);
+                drawData->setProjectionSurface(projectionSurface);
+                polygon3D->setDrawData(drawData);
                 _polygon3DRenderer->updateElement(polygon3D);
             } else {
                 _polygon3DRenderer->removeElement(polygon3D);
             }
         } else if (const std::shared_ptr<NMLModel>& nmlModel = std::dynamic_pointer_cast<NMLModel>(element)) {
             if (visible && !remove) {
-                nmlModel->setDrawData(std::make_shared<NMLModelDrawData>(*nmlModel, *nmlModel->getStyle(), *_dataSource->getProjection(), *projectionSurface));
+                long long changeGeneration = nmlModel->getChangeGeneration();
+                auto drawData = std::allocate_shared<NMLModelDrawData>(PoolAllocator<NMLModelDrawData>(), *nmlModel, *nmlModel->getStyle(), *_dataSource->getProjection(), *projectionSurface);
+                drawData->setChangeGeneration(changeGeneration);
+                drawData->setProjectionSurface(projectionSurface);
+                nmlModel->setDrawData(drawData);
                 _nmlModelRenderer->updateElement(nmlModel);
             } else {
                 _nmlModelRenderer->removeElement(nmlModel);
@@ -452,7 +627,11 @@ namespace carto {
         } else if (const std::shared_ptr<Popup>& popup = std::dynamic_pointer_cast<Popup>(element)) {
             if (visible && !remove) {
                 if (auto options = _options.lock()) {
-                    popup->setDrawData(std::make_shared<PopupDrawData>(*popup, *popup->getStyle(), *_dataSource->getProjection(), *projectionSurface, options, viewState));
+                    long long changeGeneration = popup->getChangeGeneration();
+                    auto drawData = std::allocate_shared<PopupDrawData>(PoolAllocator<PopupDrawData>(), *popup, *popup->getStyle(), *_dataSource->getProjection(), *projectionSurface, options, viewState);
+                    drawData->setChangeGeneration(changeGeneration);
+                    drawData->setProjectionSurface(projectionSurface);
+                    popup->setDrawData(drawData);
                     _billboardRenderer->updateElement(popup);
                 }
             } else {
@@ -619,6 +798,9 @@ namespace carto {
             return false;
         }
 
+        // Triangulate polygon batches on worker threads before locking the layer
+        layer->buildPolygonDrawDatas(vectorData->getElements());
+
         std::lock_guard<std::recursive_mutex> lock(layer->_mutex);
         for (const std::shared_ptr<VectorElement>& element : vectorData->getElements()) {
             layer->addRendererElement(element);
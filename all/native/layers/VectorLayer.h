@@ -125,15 +125,20 @@ namespace carto {
         virtual void offsetLayerHorizontally(double offset);
         
         virtual void onSurfaceCreated(const std::shared_ptr<ShaderManager>& shaderManager, const std::shared_ptr<TextureManager>& textureManager);
+        virtual void warmUpStyles(StyleTextureCache& styleCache);
         virtual bool onDrawFrame(float deltaSeconds, BillboardSorter& billboardSorter, StyleTextureCache& styleCache, const ViewState& viewState);
+        virtual bool onDrawFrameBillboards(float deltaSeconds, BillboardSorter& billboardSorter, StyleTextureCache& styleCache, const ViewState& viewState);
         virtual void onSurfaceDestroyed();
-        
+
+        virtual void onMemoryWarning();
+
         virtual void calculateRayIntersectedElements(const cglib::ray3<double>& ray, const ViewState& viewState, std::vector<RayIntersectedElement>& results) const;
         virtual bool processClick(ClickType::ClickType clickType, const RayIntersectedElement& intersectedElement, const ViewState& viewState) const;
 
         virtual void refreshElement(const std::shared_ptr<VectorElement>& element, bool remove);
 
         virtual void addRendererElement(const std::shared_ptr<VectorElement>& element);
+        void buildPolygonDrawDatas(const std::vector<std::shared_ptr<VectorElement> >& elements);
         virtual bool refreshRendererElements();
         virtual bool syncRendererElement(const std::shared_ptr<VectorElement>& element, const ViewState& viewState, bool remove);
         
@@ -144,11 +149,8 @@ namespace carto {
 
         const DirectorPtr<VectorDataSource> _dataSource;
         std::shared_ptr<VectorDataSource::OnChangeListener> _dataSourceListener;
-        
-        std::atomic<bool> _zBuffering;
 
-    private:
-        ThreadSafeDirectorPtr<VectorElementEventListener> _vectorElementEventListener;
+        std::atomic<bool> _zBuffering;
 
         std::shared_ptr<BillboardRenderer> _billboardRenderer;
         std::shared_ptr<GeometryCollectionRenderer> _geometryCollectionRenderer;
@@ -157,7 +159,10 @@ namespace carto {
         std::shared_ptr<PolygonRenderer> _polygonRenderer;
         std::shared_ptr<Polygon3DRenderer> _polygon3DRenderer;
         std::shared_ptr<NMLModelRenderer> _nmlModelRenderer;
-    
+
+    private:
+        ThreadSafeDirectorPtr<VectorElementEventListener> _vectorElementEventListener;
+
         std::shared_ptr<CancelableTask> _lastTask;
     };
     
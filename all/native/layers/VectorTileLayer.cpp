@@ -6,6 +6,7 @@
 #include "graphics/utils/BackgroundBitmapGenerator.h"
 #include "graphics/utils/SkyBitmapGenerator.h"
 #include "datasources/TileDataSource.h"
+#include "datasources/components/TileData.h"
 #include "layers/VectorTileEventListener.h"
 #include "projections/Projection.h"
 #include "projections/ProjectionSurface.h"
@@ -16,6 +17,7 @@
 #include "ui/VectorTileClickInfo.h"
 #include "utils/Log.h"
 #include "utils/Const.h"
+#include "utils/GeneralUtils.h"
 #include "vectortiles/VectorTileDecoder.h"
 
 #include <vt/TileId.h>
@@ -39,6 +41,8 @@ namespace carto {
         _skyBitmap(),
         _poleTiles(),
         _labelCullThreadPool(std::make_shared<CancelableThreadPool>()),
+        _decodeThreadPool(std::make_shared<CancelableThreadPool>()),
+        _decodingTiles(),
         _visibleTileIds(),
         _tempDrawDatas(),
         _visibleCache(DEFAULT_VISIBLE_CACHE_SIZE),
@@ -49,11 +53,14 @@ namespace carto {
         }
 
         _labelCullThreadPool->setPoolSize(1);
+        _decodeThreadPool->setPoolSize(1);
 
         setCullDelay(DEFAULT_CULL_DELAY);
     }
-    
+
     VectorTileLayer::~VectorTileLayer() {
+        _decodeThreadPool->cancelAll();
+        _decodeThreadPool->deinit();
         _labelCullThreadPool->cancelAll();
         _labelCullThreadPool->deinit();
     }
@@ -71,7 +78,18 @@ namespace carto {
         std::lock_guard<std::recursive_mutex> lock(_mutex);
         _preloadingCache.resize(capacityInBytes);
     }
-    
+
+    int VectorTileLayer::getDecoderThreadCount() const {
+        return _decodeThreadPool->getPoolSize();
+    }
+
+    void VectorTileLayer::setDecoderThreadCount(int threadCount) {
+        if (threadCount < 1) {
+            throw OutOfRangeException("Decoder thread count must be positive");
+        }
+        _decodeThreadPool->setPoolSize(threadCount);
+    }
+
     VectorTileRenderOrder::VectorTileRenderOrder VectorTileLayer::getLabelRenderOrder() const {
         std::lock_guard<std::recursive_mutex> lock(_mutex);
         return _labelRenderOrder;
@@ -129,7 +147,7 @@ namespace carto {
     
     void VectorTileLayer::fetchTile(const MapTile& tile, bool preloadingTile, bool invalidated) {
         long long tileId = getTileId(tile);
-        if (_fetchingTiles.exists(tileId)) {
+        if (_fetchingTiles.exists(tileId) || _decodingTiles.exists(tileId)) {
             return;
         }
 
@@ -159,7 +177,7 @@ namespace carto {
             tileThreadPool = _tileThreadPool;
         }
         if (tileThreadPool) {
-            tileThreadPool->execute(task, preloadingTile ? getUpdatePriority() + PRELOADING_PRIORITY_OFFSET : getUpdatePriority());
+            tileThreadPool->execute(task, preloadingTile ? getUpdatePriority() + PRELOADING_PRIORITY_OFFSET : getUpdatePriority(), preloadingTile ? ThreadQoS::BACKGROUND : ThreadQoS::UTILITY);
         }
     }
 
@@ -177,6 +195,9 @@ namespace carto {
         for (const std::shared_ptr<FetchTaskBase>& task : _fetchingTiles.getTasks()) {
             task->invalidate();
         }
+        for (const std::shared_ptr<DecodeTask>& task : _decodingTiles.getTasks()) {
+            task->invalidate();
+        }
 
         // Flush caches
         if (removeTiles) {
@@ -249,6 +270,16 @@ namespace carto {
     }
     
     void VectorTileLayer::refreshDrawData(const std::shared_ptr<CullState>& cullState) {
+        // Cancel decodes of tiles that the camera has moved far away from. The decoders
+        // abort such decodes at the next internal checkpoint. Tiles within the parent
+        // prefetch range of the current zoom level are kept, as they may still be needed.
+        int zoom = GeneralUtils::Clamp(static_cast<int>(cullState->getViewState().getZoom()), getMinZoom(), getMaxZoom());
+        for (const std::shared_ptr<DecodeTask>& task : _decodingTiles.getTasks()) {
+            if (std::abs(task->getTile().getZoom() - zoom) > MAX_DECODE_ZOOM_DISTANCE) {
+                task->cancel();
+            }
+        }
+
         // Move tiles between caches
         {
             std::lock_guard<std::recursive_mutex> lock(_mutex);
@@ -278,7 +309,7 @@ namespace carto {
         bool refresh = false;
         bool cull = false;
         if (std::shared_ptr<TileRenderer> tileRenderer = getTileRenderer()) {
-            if (!(_synchronizedRefresh && _fetchingTiles.getVisibleCount() > 0)) {
+            if (!(_synchronizedRefresh && _fetchingTiles.getVisibleCount() + _decodingTiles.getVisibleCount() > 0)) {
                 std::vector<std::shared_ptr<TileDrawData>> drawDatas = _tempDrawDatas;
 
                 // Add poles
@@ -302,7 +333,7 @@ namespace carto {
             }
         }
     
-        if (!_lastCullState || cullState->getViewState().getModelviewProjectionMat() != _lastCullState->getViewState().getModelviewProjectionMat()) {
+        if (!_lastCullState || cullState->getViewState().getCameraGeneration() != _lastCullState->getViewState().getCameraGeneration()) {
             cull = true;
         }
     
@@ -569,33 +600,120 @@ namespace carto {
                 break;
             }
     
+            // Hand the fetched data over to the decoder thread pool. Decoding is a separate
+            // pipeline stage so that expensive styles do not serialize behind network fetches.
+            long long tileId = layer->getTileId(_tile);
+            auto decodeTask = std::make_shared<DecodeTask>(layer, _tile, isPreloading(), dataSourceTile, tileData);
+            if (isInvalidated()) {
+                decodeTask->invalidate();
+            }
+            layer->_decodingTiles.add(tileId, decodeTask);
+            layer->_decodeThreadPool->execute(decodeTask, isPreloading() ? layer->getUpdatePriority() + PRELOADING_PRIORITY_OFFSET : layer->getUpdatePriority(), isPreloading() ? ThreadQoS::BACKGROUND : ThreadQoS::INTERACTIVE);
+
+            refresh = true; // NOTE: need to refresh even when invalidated
+            break;
+        }
+        
+        return refresh;
+    }
+
+    VectorTileLayer::DecodeTask::DecodeTask(const std::shared_ptr<VectorTileLayer>& layer, const MapTile& tile, bool preloadingTile, const MapTile& dataSourceTile, const std::shared_ptr<TileData>& tileData) :
+        _layer(layer),
+        _tile(tile),
+        _dataSourceTile(dataSourceTile),
+        _tileData(tileData),
+        _preloadingTile(preloadingTile),
+        _invalidated(false),
+        _queueTime(std::chrono::steady_clock::now())
+    {
+    }
+
+    const MapTile& VectorTileLayer::DecodeTask::getTile() const {
+        return _tile;
+    }
+
+    bool VectorTileLayer::DecodeTask::isPreloading() const {
+        return _preloadingTile;
+    }
+
+    bool VectorTileLayer::DecodeTask::isInvalidated() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _invalidated;
+    }
+
+    void VectorTileLayer::DecodeTask::invalidate() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _invalidated = true;
+    }
+
+    void VectorTileLayer::DecodeTask::run() {
+        std::shared_ptr<VectorTileLayer> layer = _layer.lock();
+        if (!layer) {
+            return;
+        }
+
+        long long tileId = layer->getTileId(_tile);
+        if (isCanceled()) {
+            layer->_decodingTiles.remove(tileId);
+            return;
+        }
+
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+        bool refresh = false;
+        try {
             vt::TileId vtTile(_tile.getZoom(), _tile.getX(), _tile.getY());
-            vt::TileId vtDataSourceTile(dataSourceTile.getZoom(), dataSourceTile.getX(), dataSourceTile.getY());
+            vt::TileId vtDataSourceTile(_dataSourceTile.getZoom(), _dataSourceTile.getX(), _dataSourceTile.getY());
             std::shared_ptr<vt::TileTransformer> tileTransformer = layer->getTileTransformer();
-            std::shared_ptr<VectorTileDecoder::TileMap> tileMap = layer->_tileDecoder->decodeTile(vtDataSourceTile, vtTile, tileTransformer, tileData->getData());
+
+            // Tile transformers are constructed solely from the render projection mode
+            // (see TileLayer::resetTileTransformer), so the mode can be used as a key component.
+            // The raw data instance keys the tile contents, a refetched tile never matches old entries.
+            bool sphericalProjection = std::dynamic_pointer_cast<vt::SphericalTileTransformer>(tileTransformer) ? true : false;
+            SharedTileMapKey sharedTileMapKey(layer->_dataSource.get(), _tileData->getData(), _tile.getTileId(), layer->_tileDecoder, layer->_tileDecoder->getChangeGeneration(), sphericalProjection);
+
+            std::shared_ptr<VectorTileDecoder::TileMap> tileMap;
+            {
+                std::lock_guard<std::mutex> lock(_SharedTileMapMutex);
+                auto it = _SharedTileMaps.find(sharedTileMapKey);
+                if (it != _SharedTileMaps.end()) {
+                    tileMap = it->second.lock();
+                }
+            }
+            if (!tileMap) {
+                tileMap = layer->_tileDecoder->decodeTile(vtDataSourceTile, vtTile, tileTransformer, _tileData->getData(), std::static_pointer_cast<CancelableTask>(shared_from_this()));
+                if (tileMap) {
+                    std::lock_guard<std::mutex> lock(_SharedTileMapMutex);
+                    if (_SharedTileMaps.size() >= MAX_SHARED_TILE_MAPS) {
+                        for (auto it = _SharedTileMaps.begin(); it != _SharedTileMaps.end(); ) {
+                            it = (it->second.expired() ? _SharedTileMaps.erase(it) : std::next(it));
+                        }
+                    }
+                    _SharedTileMaps[sharedTileMapKey] = tileMap;
+                }
+            }
             if (tileMap) {
                 // Construct tile info - keep original data if interactivity is required
-                VectorTileLayer::TileInfo tileInfo(layer->calculateMapTileBounds(dataSourceTile.getFlipped()), layer->_vectorTileEventListener.get() ? tileData->getData() : std::shared_ptr<BinaryData>(), tileMap);
+                VectorTileLayer::TileInfo tileInfo(layer->calculateMapTileBounds(_dataSourceTile.getFlipped()), layer->_vectorTileEventListener.get() ? _tileData->getData() : std::shared_ptr<BinaryData>(), tileMap);
 
                 // Store tile to cache, unless invalidated
                 if (!isInvalidated()) {
-                    long long tileId = layer->getTileId(_tile);
                     std::lock_guard<std::recursive_mutex> lock(layer->_mutex);
                     if (layer->getTileTransformer() == tileTransformer) { // extra check that the tile is created with correct transformer. Otherwise simply drop it.
                         if (isPreloading()) {
                             layer->_preloadingCache.put(tileId, tileInfo, tileInfo.getSize());
-                            if (tileData->getMaxAge() >= 0) {
-                                layer->_preloadingCache.invalidate(tileId, std::chrono::steady_clock::now() + std::chrono::milliseconds(tileData->getMaxAge()));
+                            if (_tileData->getMaxAge() >= 0) {
+                                layer->_preloadingCache.invalidate(tileId, std::chrono::steady_clock::now() + std::chrono::milliseconds(_tileData->getMaxAge()));
                             }
                         } else {
                             layer->_visibleCache.put(tileId, tileInfo, tileInfo.getSize());
-                            if (tileData->getMaxAge() >= 0) {
-                                layer->_visibleCache.invalidate(tileId, std::chrono::steady_clock::now() + std::chrono::milliseconds(tileData->getMaxAge()));
+                            if (_tileData->getMaxAge() >= 0) {
+                                layer->_visibleCache.invalidate(tileId, std::chrono::steady_clock::now() + std::chrono::milliseconds(_tileData->getMaxAge()));
                             }
                         }
                     }
                 }
-                
+
                 // Debug tile performance issues
                 if (Log::IsShowDebug()) {
                     int maxDrawCallCount = 0;
@@ -607,20 +725,38 @@ namespace carto {
                         maxDrawCallCount = std::max(maxDrawCallCount, drawCallCount);
                     }
                     if (maxDrawCallCount >= 20) {
-                        Log::Debugf("VectorTileLayer::FetchTask: Tile requires %d draw calls", maxDrawCallCount);
+                        Log::Debugf("VectorTileLayer::DecodeTask: Tile requires %d draw calls", maxDrawCallCount);
                     }
                 }
-                
-                refresh = true; // NOTE: need to refresh even when invalidated
-            } else if (!tileData->getData()->empty()) {
-                Log::Error("VectorTileLayer::FetchTask: Failed to decode tile");
+
+                refresh = !isPreloading();
+            } else if (!isCanceled() && !_tileData->getData()->empty()) {
+                Log::Error("VectorTileLayer::DecodeTask: Failed to decode tile");
+            }
+        }
+        catch (const std::exception& ex) {
+            Log::Errorf("VectorTileLayer::DecodeTask: Exception while decoding tile: %s", ex.what());
+        }
+
+        layer->addTileLoadSample(TileLoadStage::TILE_LOAD_STAGE_DECODE, _tile,
+                                 std::chrono::duration_cast<std::chrono::duration<float> >(startTime - _queueTime).count(),
+                                 std::chrono::duration_cast<std::chrono::duration<float> >(std::chrono::steady_clock::now() - startTime).count());
+
+        layer->_decodingTiles.remove(tileId);
+
+        if (refresh) {
+            std::shared_ptr<MapRenderer> mapRenderer;
+            {
+                std::lock_guard<std::recursive_mutex> lock(layer->_mutex);
+                mapRenderer = layer->_mapRenderer.lock();
+            }
+            if (mapRenderer) {
+                mapRenderer->layerChanged(layer->shared_from_this(), false);
+                mapRenderer->requestRedraw();
             }
-            break;
         }
-        
-        return refresh;
     }
-        
+
     VectorTileLayer::LabelCullTask::LabelCullTask(const std::shared_ptr<VectorTileLayer>& layer, const std::shared_ptr<TileRenderer>& tileRenderer, const ViewState& viewState) :
         _layer(layer),
         _tileRenderer(tileRenderer),
@@ -654,5 +790,10 @@ namespace carto {
         }
         return size;
     }
-    
+
+    const std::size_t VectorTileLayer::MAX_SHARED_TILE_MAPS = 1024;
+
+    std::map<VectorTileLayer::SharedTileMapKey, std::weak_ptr<VectorTileDecoder::TileMap> > VectorTileLayer::_SharedTileMaps;
+    std::mutex VectorTileLayer::_SharedTileMapMutex;
+
 }
@@ -17,14 +17,19 @@
 
 #include <memory>
 #include <map>
+#include <mutex>
+#include <tuple>
 
 #include <stdext/timed_lru_cache.h>
 
 namespace carto {
+    class BinaryData;
+    class TileData;
     class TileDrawData;
     class VectorTileEventListener;
     namespace vt {
         class Tile;
+        class TileTransformer;
     }
         
     namespace VectorTileRenderOrder {
@@ -82,7 +87,21 @@ namespace carto {
          * @param capacityInBytes The new tile bitmap cache capacity in bytes.
          */
         void setTileCacheCapacity(std::size_t capacityInBytes);
-        
+
+        /**
+         * Returns the number of threads used for decoding fetched tiles.
+         * @return The number of decoder threads. The default is 1.
+         */
+        int getDecoderThreadCount() const;
+        /**
+         * Sets the number of threads used for decoding fetched tiles.
+         * By default a single decoder thread is used and tile decoding is serialized behind tile fetching.
+         * On multi-core devices increasing the decoder thread count allows fetching and decoding to
+         * proceed in parallel, reducing the time to full frame after zooming or panning.
+         * @param threadCount The new number of decoder threads. The minimum is 1.
+         */
+        void setDecoderThreadCount(int threadCount);
+
         /**
          * Returns the current display order of the labels.
          * @return The display order of the labels. Default is VECTOR_TILE_RENDER_ORDER_LAYER.
@@ -172,6 +191,26 @@ namespace carto {
             virtual bool loadTile(const std::shared_ptr<TileLayer>& tileLayer);
         };
         
+        class DecodeTask : public CancelableTask {
+        public:
+            DecodeTask(const std::shared_ptr<VectorTileLayer>& layer, const MapTile& tile, bool preloadingTile, const MapTile& dataSourceTile, const std::shared_ptr<TileData>& tileData);
+
+            const MapTile& getTile() const;
+            bool isPreloading() const;
+            bool isInvalidated() const;
+            void invalidate();
+            virtual void run();
+
+        private:
+            std::weak_ptr<VectorTileLayer> _layer;
+            MapTile _tile;
+            MapTile _dataSourceTile;
+            std::shared_ptr<TileData> _tileData;
+            bool _preloadingTile;
+            bool _invalidated;
+            std::chrono::steady_clock::time_point _queueTime;
+        };
+
         class LabelCullTask : public CancelableTask {
         public:
             LabelCullTask(const std::shared_ptr<VectorTileLayer>& layer, const std::shared_ptr<TileRenderer>& tileRenderer, const ViewState& viewState);
@@ -202,10 +241,10 @@ namespace carto {
             std::shared_ptr<VectorTileDecoder::TileMap> _tileMap;
         };
 
+        static const int MAX_DECODE_ZOOM_DISTANCE = 2; // decodes of tiles further away from the current zoom level are canceled
         static const int BACKGROUND_BLOCK_SIZE = 16;
         static const int BACKGROUND_BLOCK_COUNT = 16;
         static const int DEFAULT_CULL_DELAY = 200;
-        static const int PRELOADING_PRIORITY_OFFSET = -2;
         static const int EXTRA_TILE_FOOTPRINT = 4096;
         static const int DEFAULT_VISIBLE_CACHE_SIZE = 512 * 1024 * 1024; // NOTE: the limit should never be reached in normal cases
         static const int DEFAULT_PRELOADING_CACHE_SIZE = 10 * 1024 * 1024;
@@ -226,12 +265,27 @@ namespace carto {
         mutable std::shared_ptr<vt::Tile> _poleTiles[2];
 
         std::shared_ptr<CancelableThreadPool> _labelCullThreadPool;
+        std::shared_ptr<CancelableThreadPool> _decodeThreadPool;
+
+        FetchingTileTasks<DecodeTask> _decodingTiles;
 
         std::vector<long long> _visibleTileIds;
         std::vector<std::shared_ptr<TileDrawData> > _tempDrawDatas;
 
         cache::timed_lru_cache<long long, TileInfo> _visibleCache;
         cache::timed_lru_cache<long long, TileInfo> _preloadingCache;
+
+        // Process-wide store of decoded tile maps. Layers that share the same data source,
+        // decoder and render projection mode (for example, the sides of a split-screen
+        // comparison view) reuse each other's decoded tiles instead of decoding identical
+        // data twice. The store holds weak references, so a decoded tile stays available
+        // only while some layer cache retains it.
+        typedef std::tuple<std::shared_ptr<TileDataSource>, std::shared_ptr<BinaryData>, long long, std::shared_ptr<VectorTileDecoder>, unsigned int, bool> SharedTileMapKey;
+
+        static const std::size_t MAX_SHARED_TILE_MAPS;
+
+        static std::map<SharedTileMapKey, std::weak_ptr<VectorTileDecoder::TileMap> > _SharedTileMaps;
+        static std::mutex _SharedTileMapMutex;
     };
     
 }
@@ -4,6 +4,8 @@
 
 #include <boost/lexical_cast.hpp>
 
+#include <picojson/picojson.h>
+
 #include <rapidjson/rapidjson.h>
 #include <rapidjson/document.h>
 
@@ -11,37 +13,39 @@
 
 namespace {
 
-    carto::Variant rapidJSONToVariant(const rapidjson::Value& value) {
-        if (value.IsString()) {
-            return carto::Variant(value.GetString());
-        } else if (value.IsInt()) {
-            return carto::Variant(static_cast<long long>(value.GetInt()));
-        } else if (value.IsUint()) {
-            return carto::Variant(static_cast<long long>(value.GetUint()));
-        } else if (value.IsInt64()) {
-            return carto::Variant(static_cast<long long>(value.GetInt64()));
-        } else if (value.IsUint64()) {
-            return carto::Variant(static_cast<long long>(value.GetUint64()));
-        } else if (value.IsNumber()) {
-            return carto::Variant(value.GetDouble());
-        } else if (value.IsArray()) {
-            std::vector<carto::Variant> values;
-            for (rapidjson::Value::ConstValueIterator it = value.Begin(); it != value.End(); it++) {
-                values.push_back(rapidJSONToVariant(*it));
-            }
-            return carto::Variant(values);
-        } else if (value.IsObject()) {
-            std::map<std::string, carto::Variant> valueMap;
+    // Convert directly to picojson and wrap the result as a single Variant.
+    // Building nested Variant objects through the array/map constructors would
+    // copy every subtree once per nesting level.
+    picojson::value rapidJSONToPicoJSON(const rapidjson::Value& value) {
+        if (value.IsObject()) {
+            picojson::value object(picojson::object_type, true);
             for (rapidjson::Value::ConstMemberIterator it = value.MemberBegin(); it != value.MemberEnd(); it++) {
                 if (!it->name.IsString()) {
                     continue;
                 }
-          
-                valueMap[it->name.GetString()] = rapidJSONToVariant(it->value);
+
+                object.set(it->name.GetString(), rapidJSONToPicoJSON(it->value));
             }
-            return carto::Variant(valueMap);
+            return object;
+        } else if (value.IsArray()) {
+            std::vector<picojson::value> array;
+            array.reserve(value.Size());
+            for (rapidjson::SizeType i = 0; i < value.Size(); i++) {
+                array.push_back(rapidJSONToPicoJSON(value[i]));
+            }
+            return picojson::value(std::move(array));
+        } else if (value.IsString()) {
+            return picojson::value(value.GetString());
+        } else if (value.IsInt64()) {
+            return picojson::value(value.GetInt64());
+        } else if (value.IsUint64()) {
+            return picojson::value(static_cast<std::int64_t>(value.GetUint64()));
+        } else if (value.IsNumber()) {
+            return picojson::value(value.GetDouble());
+        } else if (value.IsBool()) {
+            return picojson::value(value.GetBool());
         }
-        return carto::Variant();
+        return picojson::value();
     }
 
 }
@@ -73,7 +77,7 @@ namespace carto {
                     continue;
                 }
 
-                data[it->name.GetString()] = rapidJSONToVariant(it->value);
+                data[it->name.GetString()] = Variant::FromPicoJSON(rapidJSONToPicoJSON(it->value));
             }
         }
 
@@ -87,7 +91,7 @@ namespace carto {
 
             cols = std::max(cols, static_cast<unsigned int>(column.size()));
         }
-        std::vector<int> keyIds;
+        std::vector<std::uint16_t> keyIds;
         keyIds.reserve(cols * rows);
         for (unsigned int i = 0; i < rows; i++) {
             std::string columnUTF8 = doc["grid"][i].GetString();
@@ -105,7 +109,11 @@ namespace carto {
                 if (code >= 93) code--;
                 if (code >= 35) code--;
                 code -= 32;
-                keyIds.push_back(code);
+                if (code > 65535) {
+                    Log::Warnf("UTFGridTile::DecodeUTFTile: Key id out of range");
+                    code = 0;
+                }
+                keyIds.push_back(static_cast<std::uint16_t>(code));
             }
         }
         return std::make_shared<UTFGridTile>(keys, data, keyIds, cols, rows);
@@ -10,48 +10,71 @@
 #include "core/Variant.h"
 
 #include <memory>
+#include <cstdint>
 #include <map>
 #include <vector>
 #include <string>
 
 namespace carto {
     class BinaryData;
-        
+
     class UTFGridTile {
     public:
-        UTFGridTile(const std::vector<std::string>& keys, const std::map<std::string, Variant>& data, const std::vector<int>& keyIds, int xSize, int ySize) : _keys(keys), _data(data), _keyIds(keyIds), _xSize(xSize), _ySize(ySize) { }
+        UTFGridTile(const std::vector<std::string>& keys, const std::map<std::string, Variant>& data, const std::vector<std::uint16_t>& keyIds, int xSize, int ySize) : _keys(keys), _data(data), _keyValues(), _keyIds(keyIds), _xSize(xSize), _ySize(ySize) {
+            // Intern the data values per key id, so that lookups do not require key/map searches
+            _keyValues.reserve(_keys.size());
+            for (const std::string& key : _keys) {
+                auto it = _data.find(key);
+                _keyValues.push_back(it != _data.end() ? it->second : Variant());
+            }
+        }
 
         std::string getKey(int keyId) const {
             return keyId >= 0 && keyId <= static_cast<int>(_keys.size()) ? _keys[keyId] : std::string();
         }
-        
+
         Variant getData(const std::string& key) const {
             auto it = _data.find(key);
             return it != _data.end() ? it->second : Variant();
         }
 
+        Variant getData(int keyId) const {
+            return keyId >= 0 && keyId < static_cast<int>(_keyValues.size()) ? _keyValues[keyId] : Variant();
+        }
+
         int getXSize() const {
             return _xSize;
         }
-        
+
         int getYSize() const {
             return _ySize;
         }
-        
+
         int getKeyId(int x, int y) const {
             return x >= 0 && y >= 0 && x < getXSize() && y < getYSize() ? _keyIds[y * getXSize() + x] : 0;
         }
 
+        std::size_t getResidentSize() const {
+            std::size_t dataSize = 0;
+            for (const std::string& key : _keys) {
+                dataSize += key.size() + EXTRA_KEY_FOOTPRINT;
+            }
+            return _keyIds.size() * sizeof(std::uint16_t) + dataSize;
+        }
+
         static std::shared_ptr<UTFGridTile> DecodeUTFTile(const std::shared_ptr<BinaryData>& tileData);
 
     private:
+        static const int EXTRA_KEY_FOOTPRINT = 1024; // approximation of the interned data value footprint per key
+
         std::vector<std::string> _keys;
         std::map<std::string, Variant> _data;
-        std::vector<int> _keyIds;
+        std::vector<Variant> _keyValues;
+        std::vector<std::uint16_t> _keyIds;
         int _xSize;
         int _ySize;
     };
-    
+
 }
 
 #endif
@@ -10,6 +10,8 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include <stdext/zlib.h>
+
 #if defined(_WIN32)
 #define CARTO_HTTP_SOCKET_IMPL WinSockImpl
 #include "network/HTTPClientWinSockImpl.h"
@@ -35,25 +37,123 @@ namespace carto {
         _impl->setTimeout(milliseconds);
     }
 
+    void HTTPClient::setMaxConnectionsPerHost(int connectionCount) {
+        _impl->setMaxConnectionsPerHost(connectionCount);
+    }
+
     int HTTPClient::get(const std::string& url, const std::map<std::string, std::string>& requestHeaders, std::map<std::string, std::string>& responseHeaders, std::shared_ptr<BinaryData>& responseData, int* statusCode) const {
         Request request("GET", url);
         request.headers.insert(requestHeaders.begin(), requestHeaders.end());
         if (request.headers.count("Accept") == 0) {
             request.headers["Accept"] = "*/*";
         }
+        bool decodeBody = false;
+        if (request.headers.count("Accept-Encoding") == 0) {
+            // Advertise compressed transfer support, the response body is decoded below.
+            // If the caller sets the header explicitly, the body is returned as-is.
+            request.headers["Accept-Encoding"] = "gzip";
+            decodeBody = true;
+        }
 
-        std::vector<unsigned char> content;
-        content.reserve(65536);
-        auto handlerFn = [&content](std::uint64_t offset, std::uint64_t length, const unsigned char* buf, std::size_t size) -> bool {
-            if (content.size() != offset) {
-                content.resize(static_cast<std::size_t>(offset));
+        // Coalesce concurrent requests for the same URL: the first requester performs the
+        // transfer, later requesters with an identical request attach to it and reuse the
+        // response instead of issuing a duplicate request. Request headers are part of the
+        // key, as they may affect the response.
+        std::string transferKey = request.url;
+        for (const std::pair<const std::string, std::string>& header : request.headers) {
+            transferKey += '\n' + header.first + ':' + header.second;
+        }
+
+        std::shared_ptr<InFlightTransfer> transfer;
+        bool leader = false;
+        {
+            std::lock_guard<std::mutex> lock(_InFlightTransferMutex);
+            auto it = _InFlightTransferMap.find(transferKey);
+            if (it != _InFlightTransferMap.end()) {
+                transfer = it->second;
+                transfer->subscriberCount++;
+            } else {
+                transfer = std::make_shared<InFlightTransfer>();
+                _InFlightTransferMap[transferKey] = transfer;
+                leader = true;
             }
-            content.insert(content.end(), buf, buf + size);
-            return true;
-        };
+        }
 
         Response response;
-        int code = makeRequest(request, response, handlerFn, 0);
+        std::vector<unsigned char> content;
+        int code = -1;
+        if (leader) {
+            content.reserve(65536);
+            auto handlerFn = [&content](std::uint64_t offset, std::uint64_t length, const unsigned char* buf, std::size_t size) -> bool {
+                if (content.size() != offset) {
+                    content.resize(static_cast<std::size_t>(offset));
+                }
+                content.insert(content.end(), buf, buf + size);
+                return true;
+            };
+
+            try {
+                code = makeRequest(request, response, handlerFn, 0);
+            } catch (...) {
+                // Detach the subscribers with a failure result, they can not reuse this transfer
+                {
+                    std::lock_guard<std::mutex> lock(_InFlightTransferMutex);
+                    _InFlightTransferMap.erase(transferKey);
+                }
+                {
+                    std::lock_guard<std::mutex> lock(transfer->mutex);
+                    transfer->finished = true;
+                }
+                transfer->condition.notify_all();
+                throw;
+            }
+
+            // Publish the result. The response is copied only if other requesters attached
+            // to the transfer while it was in flight; no new requesters can attach after
+            // the transfer is removed from the map.
+            bool shared = false;
+            {
+                std::lock_guard<std::mutex> lock(_InFlightTransferMutex);
+                _InFlightTransferMap.erase(transferKey);
+                shared = transfer->subscriberCount > 0;
+            }
+            {
+                std::lock_guard<std::mutex> lock(transfer->mutex);
+                transfer->code = code;
+                if (shared) {
+                    transfer->response = response;
+                    transfer->content = content;
+                }
+                transfer->finished = true;
+            }
+            transfer->condition.notify_all();
+        } else {
+            if (_log) {
+                Log::Infof("HTTPClient::get: Attaching to identical request already in flight, URL: %s", url.c_str());
+            }
+            std::unique_lock<std::mutex> lock(transfer->mutex);
+            transfer->condition.wait(lock, [&transfer] { return transfer->finished; });
+            code = transfer->code;
+            response = transfer->response;
+            content = transfer->content;
+        }
+
+        if (code == 0 && decodeBody && !content.empty()) {
+            auto it = response.headers.find("Content-Encoding");
+            if (it != response.headers.end() && it->second != "identity") {
+                std::vector<unsigned char> decodedContent;
+                if (it->second == "gzip" && zlib::inflate_gzip(content.data(), content.size(), decodedContent)) {
+                    content = std::move(decodedContent);
+                    response.headers.erase("Content-Encoding");
+                    response.headers.erase("Content-Length");
+                } else {
+                    if (_log) {
+                        Log::Errorf("HTTPClient::get: Failed to decode response body with encoding %s, URL: %s", it->second.c_str(), url.c_str());
+                    }
+                    code = -1;
+                }
+            }
+        }
         responseHeaders.insert(response.headers.begin(), response.headers.end());
         responseData = std::make_shared<BinaryData>(std::move(content));
         if (statusCode) {
@@ -95,7 +195,7 @@ namespace carto {
         if (request.headers.count("Accept") == 0) {
             request.headers["Accept"] = "*/*";
         }
-        if (offset > 0) {
+        if (offset > 0 && request.headers.count("Range") == 0) {
             request.headers["Range"] = "bytes=" + boost::lexical_cast<std::string>(offset) + "-";
         }
 
@@ -177,4 +277,11 @@ namespace carto {
     HTTPClient::Impl::~Impl() {
     }
 
+    void HTTPClient::Impl::setMaxConnectionsPerHost(int connectionCount) {
+        // The default implementation relies on the platform HTTP stack to manage its connection pool
+    }
+
+    std::map<std::string, std::shared_ptr<HTTPClient::InFlightTransfer> > HTTPClient::_InFlightTransferMap;
+    std::mutex HTTPClient::_InFlightTransferMutex;
+
 }
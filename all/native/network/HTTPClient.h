@@ -12,6 +12,7 @@
 #include <map>
 #include <vector>
 #include <mutex>
+#include <condition_variable>
 #include <cstdint>
 #include <functional>
 
@@ -25,6 +26,7 @@ namespace carto {
         explicit HTTPClient(bool log);
 
         void setTimeout(int milliseconds);
+        void setMaxConnectionsPerHost(int connectionCount);
 
         int get(const std::string& url, const std::map<std::string, std::string>& requestHeaders, std::map<std::string, std::string>& responseHeaders, std::shared_ptr<BinaryData>& responseData, int* statusCode = 0) const;
         int post(const std::string& url, const std::string& contentType, const std::shared_ptr<BinaryData>& requestData, const std::map<std::string, std::string>& requestHeaders, std::map<std::string, std::string>& responseHeaders, std::shared_ptr<BinaryData>& responseData);
@@ -71,6 +73,7 @@ namespace carto {
             virtual ~Impl();
 
             virtual void setTimeout(int milliseconds) = 0;
+            virtual void setMaxConnectionsPerHost(int connectionCount);
             virtual bool makeRequest(const HTTPClient::Request& request, HeadersFunc headersFn, DataFunc dataFn) const = 0;
         };
 
@@ -79,10 +82,23 @@ namespace carto {
         class IOSImpl;
         class WinSockImpl;
 
+        struct InFlightTransfer {
+            std::mutex mutex;
+            std::condition_variable condition;
+            bool finished = false;
+            int code = -1;
+            int subscriberCount = 0;
+            Response response;
+            std::vector<unsigned char> content;
+        };
+
         int makeRequest(Request request, Response& response, HandlerFunc handlerFn, std::uint64_t offset) const;
 
         bool _log;
         std::unique_ptr<Impl> _impl;
+
+        static std::map<std::string, std::shared_ptr<InFlightTransfer> > _InFlightTransferMap;
+        static std::mutex _InFlightTransferMutex;
     };
 
 }
@@ -13,11 +13,17 @@ namespace carto {
 
     HTTPClient::PionImpl::PionImpl(bool log) :
         _log(log),
+        _maxConnectionsPerHost(DEFAULT_MAX_CONNECTIONS_PER_HOST),
         _connectionMap(),
         _mutex()
     {
     }
 
+    void HTTPClient::PionImpl::setMaxConnectionsPerHost(int connectionCount) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _maxConnectionsPerHost = connectionCount;
+    }
+
     bool HTTPClient::PionImpl::makeRequest(const HTTPClient::Request& request, HeadersFunc headersFn, DataFunc dataFn) const {
         // Parse request URL
         std::string proto, host, path, query;
@@ -52,9 +58,8 @@ namespace carto {
             result = makeRequest(*connection, request, headersFn, dataFn);
 
             if (result) {
-                std::lock_guard<std::mutex> lock(_mutex);
                 if (request.method == "GET") {
-                    _connectionMap.insert(std::make_pair(connectionKey, connection));
+                    releaseConnection(connectionKey, connection);
                 }
                 return result;
             }
@@ -69,14 +74,32 @@ namespace carto {
         result = makeRequest(*connection, request, headersFn, dataFn);
 
         if (result) {
-            std::lock_guard<std::mutex> lock(_mutex);
             if (request.method == "GET") {
-                _connectionMap.insert(std::make_pair(connectionKey, connection));
+                releaseConnection(connectionKey, connection);
             }
         }
         return result;
     }
 
+    void HTTPClient::PionImpl::releaseConnection(const std::pair<std::string, int>& connectionKey, const std::shared_ptr<Connection>& connection) const {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // Drop pooled connections that are no longer usable
+        auto range = _connectionMap.equal_range(connectionKey);
+        for (auto it = range.first; it != range.second; ) {
+            if (!it->second->isValid()) {
+                it = _connectionMap.erase(it);
+            } else {
+                it++;
+            }
+        }
+
+        // Keep the number of idle connections per host bounded
+        if (_connectionMap.count(connectionKey) < static_cast<std::size_t>(_maxConnectionsPerHost)) {
+            _connectionMap.insert(std::make_pair(connectionKey, connection));
+        }
+    }
+
     bool HTTPClient::PionImpl::makeRequest(Connection& connection, const HTTPClient::Request& request, HeadersFunc headersFn, DataFunc dataFn) const {
         std::string url = request.url;
         std::string proto, host, path, query;
@@ -142,7 +165,7 @@ namespace carto {
 
         // Check Keep-Alive directive
         connection.maxRequests--;
-        it = pionResponse.get_headers().find("Keep-Alive");
+        auto it = pionResponse.get_headers().find("Keep-Alive");
         if (it != pionResponse.get_headers().end()) {
             std::cmatch what;
             if (std::regex_match(it->second.c_str(), what, std::regex(".*[^a-zA-Z0-9]timeout=([0-9]*).*"))) {
@@ -160,7 +183,7 @@ namespace carto {
 
         // Read Content-Length
         std::uint64_t contentLength = std::numeric_limits<std::uint64_t>::max();
-        auto it = pionResponse.get_headers().find("Content-Length");
+        it = pionResponse.get_headers().find("Content-Length");
         if (it != pionResponse.get_headers().end()) {
             contentLength = boost::lexical_cast<std::uint64_t>(it->second);
         }
@@ -194,18 +217,71 @@ namespace carto {
         return !cancel;
     }
 
+    asio::ip::address HTTPClient::PionImpl::ResolveHostAddress(const std::string& host, std::uint16_t port, asio::error_code& error) {
+        std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
+        {
+            std::lock_guard<std::mutex> lock(_DNSCacheMutex);
+            auto it = _DNSCache.find(host);
+            if (it != _DNSCache.end() && it->second.second > currentTime) {
+                return it->second.first;
+            }
+        }
+
+        // Resolve outside of the lock, so a slow resolution does not block cached lookups of other hosts
+        asio::io_service ioService;
+        asio::ip::tcp::resolver resolver(ioService);
+        asio::ip::tcp::resolver::query query(host, boost::lexical_cast<std::string>(port));
+        asio::ip::tcp::resolver::iterator it = resolver.resolve(query, error);
+        if (error) {
+            return asio::ip::address();
+        }
+        asio::ip::address address = it->endpoint().address();
+
+        {
+            std::lock_guard<std::mutex> lock(_DNSCacheMutex);
+            _DNSCache[host] = std::make_pair(address, currentTime + std::chrono::seconds(DNS_CACHE_TTL_SECONDS));
+        }
+        return address;
+    }
+
+    void HTTPClient::PionImpl::InvalidateHostAddress(const std::string& host) {
+        std::lock_guard<std::mutex> lock(_DNSCacheMutex);
+        _DNSCache.erase(host);
+    }
+
     HTTPClient::PionImpl::Connection::Connection(const std::string& host, std::uint16_t port) :
         maxRequests(std::numeric_limits<int>::max()), keepAliveTime(), ioService(), connection()
     {
+        // Resolve the host address through the shared cache, so repeated connections
+        // to the same tile host do not block on DNS
+        asio::error_code resolveError;
+        asio::ip::address address = ResolveHostAddress(host, port, resolveError);
+
         // Connect to server
         connection = std::make_shared<pion::tcp::connection>(ioService);
         connection->set_lifecycle(pion::tcp::connection::LIFECYCLE_KEEPALIVE);
-        asio::error_code socketError = connection->connect(host, port);
+        asio::error_code socketError;
+        if (!resolveError) {
+            socketError = connection->connect(address, port);
+            if (socketError) {
+                // The cached address may be stale after a network change, re-resolve and retry
+                InvalidateHostAddress(host);
+                socketError = connection->connect(host, port);
+            }
+        } else {
+            socketError = connection->connect(host, port);
+        }
         if (socketError) {
             connection.reset();
         }
     }
 
+    const int HTTPClient::PionImpl::DEFAULT_MAX_CONNECTIONS_PER_HOST = 8;
+    const int HTTPClient::PionImpl::DNS_CACHE_TTL_SECONDS = 60;
+
+    std::map<std::string, std::pair<asio::ip::address, std::chrono::steady_clock::time_point> > HTTPClient::PionImpl::_DNSCache;
+    std::mutex HTTPClient::PionImpl::_DNSCacheMutex;
+
     bool HTTPClient::PionImpl::Connection::isValid() const {
         if (!connection) {
             return false;
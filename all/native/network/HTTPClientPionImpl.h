@@ -20,6 +20,7 @@ namespace carto {
     public:
         explicit PionImpl(bool log);
 
+        virtual void setMaxConnectionsPerHost(int connectionCount);
         virtual bool makeRequest(const HTTPClient::Request& request, HeadersFunc headersFn, DataFunc dataFn) const;
 
     private:
@@ -36,7 +37,19 @@ namespace carto {
 
         bool makeRequest(Connection& connection, const HTTPClient::Request& request, HeadersFunc headersFn, DataFunc dataFn) const;
 
+        void releaseConnection(const std::pair<std::string, int>& connectionKey, const std::shared_ptr<Connection>& connection) const;
+
+        static asio::ip::address ResolveHostAddress(const std::string& host, std::uint16_t port, asio::error_code& error);
+        static void InvalidateHostAddress(const std::string& host);
+
+        static const int DEFAULT_MAX_CONNECTIONS_PER_HOST;
+        static const int DNS_CACHE_TTL_SECONDS;
+
+        static std::map<std::string, std::pair<asio::ip::address, std::chrono::steady_clock::time_point> > _DNSCache;
+        static std::mutex _DNSCacheMutex;
+
         bool _log;
+        int _maxConnectionsPerHost;
         mutable std::multimap<std::pair<std::string, int>, std::shared_ptr<Connection> > _connectionMap;
         mutable std::mutex _mutex;
     };
@@ -0,0 +1,72 @@
+#include "NetworkEstimator.h"
+
+#include <algorithm>
+
+namespace carto {
+
+    float NetworkEstimator::GetBandwidthEstimate() {
+        std::lock_guard<std::mutex> lock(_Mutex);
+        return _BandwidthEstimate;
+    }
+
+    float NetworkEstimator::GetRTTEstimate() {
+        std::lock_guard<std::mutex> lock(_Mutex);
+        return _RTTEstimate;
+    }
+
+    int NetworkEstimator::GetRecommendedConcurrency() {
+        std::lock_guard<std::mutex> lock(_Mutex);
+        return static_cast<int>(_ConcurrencyLimit);
+    }
+
+    void NetworkEstimator::BeginRequest() {
+        std::unique_lock<std::mutex> lock(_Mutex);
+        _Condition.wait(lock, [] {
+            return _ActiveRequestCount < static_cast<int>(_ConcurrencyLimit);
+        });
+        _ActiveRequestCount++;
+    }
+
+    void NetworkEstimator::EndRequest(std::size_t size, float duration, bool success) {
+        std::lock_guard<std::mutex> lock(_Mutex);
+        _ActiveRequestCount--;
+
+        bool congested = !success;
+        if (success && duration > 0) {
+            float bandwidth = size / duration;
+            _BandwidthEstimate = (_BandwidthEstimate < 0 ? bandwidth : _BandwidthEstimate + (bandwidth - _BandwidthEstimate) * ESTIMATE_SMOOTHING_FACTOR);
+            if (size <= MAX_RTT_PROBE_SIZE) {
+                // Small responses are dominated by the round-trip time, use them as RTT probes
+                _RTTEstimate = (_RTTEstimate < 0 ? duration : _RTTEstimate + (duration - _RTTEstimate) * ESTIMATE_SMOOTHING_FACTOR);
+            }
+
+            // Treat latency inflating well past the predicted transfer time as congestion
+            if (_BandwidthEstimate > 0 && _RTTEstimate > 0) {
+                float expectedDuration = size / _BandwidthEstimate + _RTTEstimate;
+                congested = duration > expectedDuration * CONGESTION_LATENCY_FACTOR;
+            }
+        }
+
+        if (congested) {
+            _ConcurrencyLimit = std::max(static_cast<float>(MIN_CONCURRENCY), _ConcurrencyLimit * 0.5f);
+        } else if (success) {
+            _ConcurrencyLimit = std::min(static_cast<float>(MAX_CONCURRENCY), _ConcurrencyLimit + 1.0f / _ConcurrencyLimit);
+        }
+
+        _Condition.notify_all();
+    }
+
+    NetworkEstimator::NetworkEstimator() {
+    }
+
+    const float NetworkEstimator::ESTIMATE_SMOOTHING_FACTOR = 0.125f;
+    const float NetworkEstimator::CONGESTION_LATENCY_FACTOR = 4.0f;
+
+    int NetworkEstimator::_ActiveRequestCount = 0;
+    float NetworkEstimator::_ConcurrencyLimit = 4.0f;
+    float NetworkEstimator::_BandwidthEstimate = -1.0f;
+    float NetworkEstimator::_RTTEstimate = -1.0f;
+    std::mutex NetworkEstimator::_Mutex;
+    std::condition_variable NetworkEstimator::_Condition;
+
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2016 CartoDB. All rights reserved.
+ * Copying and using this code is allowed only according
+ * to license terms, as given in https://cartodb.com/terms/
+ */
+
+#ifndef _CARTO_NETWORKESTIMATOR_H_
+#define _CARTO_NETWORKESTIMATOR_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+namespace carto {
+
+    /**
+     * Bandwidth/latency estimator and adaptive concurrency controller for HTTP tile requests.
+     * Request durations are fed into exponentially smoothed bandwidth and round-trip time
+     * estimates. An AIMD-style controller uses the estimates to adapt the number of
+     * concurrent requests: the limit is increased additively while requests complete in the
+     * expected time and halved when requests fail or their latency inflates well past the
+     * transfer time predicted by the current estimates (a sign of congestion/bufferbloat).
+     * The state is shared by all HTTP data sources, as they compete for the same link.
+     */
+    class NetworkEstimator {
+    public:
+        static float GetBandwidthEstimate();
+        static float GetRTTEstimate();
+        static int GetRecommendedConcurrency();
+
+        static void BeginRequest();
+        static void EndRequest(std::size_t size, float duration, bool success);
+
+    private:
+        NetworkEstimator();
+
+        static const int MIN_CONCURRENCY = 2;
+        static const int MAX_CONCURRENCY = 16;
+
+        static const std::size_t MAX_RTT_PROBE_SIZE = 4 * 1024;
+
+        static const float ESTIMATE_SMOOTHING_FACTOR;
+        static const float CONGESTION_LATENCY_FACTOR;
+
+        static int _ActiveRequestCount;
+        static float _ConcurrencyLimit;
+        static float _BandwidthEstimate;
+        static float _RTTEstimate;
+        static std::mutex _Mutex;
+        static std::condition_variable _Condition;
+    };
+
+}
+
+#endif
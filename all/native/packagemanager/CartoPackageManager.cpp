@@ -132,6 +132,22 @@ namespace carto {
         return NetworkUtils::BuildURLFromParameters(url, params);
     }
 
+    std::string CartoPackageManager::createPackageDiffURL(const std::string& packageId, int sourceVersion, int targetVersion, const std::string& baseURL) const {
+        std::string appToken;
+        if (!LicenseManager::GetInstance().getParameter("appToken", appToken, false)) {
+            return std::string(); // invalid URL
+        }
+
+        std::map<std::string, std::string> tagValues;
+        tagValues["key"] = appToken;
+        std::string url = GeneralUtils::ReplaceTags(baseURL, tagValues, "{", "}", true);
+
+        std::map<std::string, std::string> params;
+        params["update"] = "1";
+        params["diff_version"] = boost::lexical_cast<std::string>(sourceVersion);
+        return NetworkUtils::BuildURLFromParameters(url, params);
+    }
+
     std::shared_ptr<PackageInfo> CartoPackageManager::getCustomPackage(const std::string& packageId, int version) const {
         static std::regex re("^bbox\\(\\s*([0-9-.eE]*)\\s*,\\s*([0-9-.eE]*)\\s*,\\s*([0-9-.eE]*)\\s*,\\s*([0-9-.eE]*)\\s*\\)$");
         
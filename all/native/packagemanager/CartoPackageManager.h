@@ -56,6 +56,8 @@ namespace carto {
 
         virtual std::string createPackageURL(const std::string& packageId, int version, const std::string& baseURL, bool downloaded) const;
 
+        virtual std::string createPackageDiffURL(const std::string& packageId, int sourceVersion, int targetVersion, const std::string& baseURL) const;
+
         virtual std::shared_ptr<PackageInfo> getCustomPackage(const std::string& packageId, int version) const;
 
         virtual bool updateStyle(const std::string& styleName);
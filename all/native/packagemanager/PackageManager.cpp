@@ -7,6 +7,7 @@
 #include "projections/EPSG3857.h"
 #include "packagemanager/handlers/PackageHandler.h"
 #include "packagemanager/handlers/PackageHandlerFactory.h"
+#include "packagemanager/handlers/MapPackageHandler.h"
 #include "utils/URLFileLoader.h"
 #include "utils/GeneralUtils.h"
 #include "utils/Log.h"
@@ -15,9 +16,14 @@
 #include <memory>
 #include <utility>
 #include <algorithm>
+#include <atomic>
 #include <limits>
 #include <time.h>
 
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
 #include <boost/lexical_cast.hpp>
 
 #include <stdext/utf8_filesystem.h>
@@ -39,12 +45,38 @@
 
 namespace {
 
+    picojson::value rapidJSONToPicoJSON(const rapidjson::Value& value) {
+        if (value.IsObject()) {
+            picojson::value object(picojson::object_type, true);
+            for (rapidjson::Value::ConstMemberIterator it = value.MemberBegin(); it != value.MemberEnd(); it++) {
+                object.set(it->name.GetString(), rapidJSONToPicoJSON(it->value));
+            }
+            return object;
+        } else if (value.IsArray()) {
+            std::vector<picojson::value> array;
+            array.reserve(value.Size());
+            for (rapidjson::SizeType i = 0; i < value.Size(); i++) {
+                array.push_back(rapidJSONToPicoJSON(value[i]));
+            }
+            return picojson::value(std::move(array));
+        } else if (value.IsString()) {
+            return picojson::value(value.GetString());
+        } else if (value.IsInt64()) {
+            return picojson::value(value.GetInt64());
+        } else if (value.IsUint64()) {
+            return picojson::value(static_cast<std::int64_t>(value.GetUint64()));
+        } else if (value.IsNumber()) {
+            return picojson::value(value.GetDouble());
+        } else if (value.IsBool()) {
+            return picojson::value(value.GetBool());
+        }
+        return picojson::value();
+    }
+
     std::shared_ptr<carto::PackageMetaInfo> createPackageMetaInfo(const rapidjson::Value& value) {
-        rapidjson::StringBuffer metaInfo;
-        rapidjson::Writer<rapidjson::StringBuffer> writer(metaInfo);
-        value.Accept(writer);
-        carto::Variant var = carto::Variant::FromString(metaInfo.GetString());
-        return std::make_shared<carto::PackageMetaInfo>(var);
+        // Convert the subtree directly, serializing to a JSON string and re-parsing
+        // it would be much more expensive for metadata-heavy packages
+        return std::make_shared<carto::PackageMetaInfo>(carto::Variant::FromPicoJSON(rapidJSONToPicoJSON(value)));
     }
 
 }
@@ -64,6 +96,8 @@ namespace carto {
         _packageManagerThread(),
         _onChangeListeners(),
         _stopped(true),
+        _downloadConcurrency(DEFAULT_DOWNLOAD_CONCURRENCY),
+        _tileCacheCapacity(DEFAULT_TILE_CACHE_CAPACITY),
         _prevTaskId(-1),
         _prevAction(PackageAction::PACKAGE_ACTION_WAITING),
         _prevRoundedProgress(0),
@@ -195,6 +229,31 @@ namespace carto {
         return std::string();
     }
 
+    int PackageManager::getDownloadConcurrency() const {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        return _downloadConcurrency;
+    }
+
+    void PackageManager::setDownloadConcurrency(int concurrency) {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        _downloadConcurrency = std::max(1, concurrency);
+    }
+
+    int PackageManager::getTileCacheCapacity() const {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        return _tileCacheCapacity;
+    }
+
+    void PackageManager::setTileCacheCapacity(int capacity) {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        _tileCacheCapacity = std::max(0, capacity);
+        for (auto it = _packageHandlerCache.begin(); it != _packageHandlerCache.end(); it++) {
+            if (auto mapHandler = std::dynamic_pointer_cast<MapPackageHandler>(it->second)) {
+                mapHandler->setCacheCapacity(_tileCacheCapacity);
+            }
+        }
+    }
+
     std::vector<std::shared_ptr<PackageInfo> > PackageManager::getServerPackages() const {
         try {
             std::lock_guard<std::recursive_mutex> lock(_mutex);
@@ -349,6 +408,9 @@ namespace carto {
                 if (!handler) {
                     continue;
                 }
+                if (auto mapHandler = std::dynamic_pointer_cast<MapPackageHandler>(handler)) {
+                    mapHandler->setCacheCapacity(_tileCacheCapacity);
+                }
                 it = _packageHandlerCache.insert(std::make_pair(packageInfo, handler)).first;
             }
             packageHandlerMap[packageInfo] = it->second;
@@ -796,12 +858,6 @@ namespace carto {
             // Determine file size, copy file
             std::uint64_t fileSize = 0;
             {
-                FILE* fpDestRaw = utf8_filesystem::fopen(packageFileName.c_str(), "wb");
-                if (!fpDestRaw) {
-                    throw PackageException(PackageErrorType::PACKAGE_ERROR_TYPE_SYSTEM, std::string("Could not create file ") + packageFileName);
-                }
-                std::shared_ptr<FILE> fpDest(fpDestRaw, fclose);
-
                 updateTaskStatus(taskId, PackageAction::PACKAGE_ACTION_COPYING, 0.0f);
 
                 std::string sourceURL = task.packageLocation;
@@ -809,29 +865,45 @@ namespace carto {
                     sourceURL = "file://" + sourceURL;
                 }
 
-                URLFileLoader loader;
-                loader.setLocalFiles(true);
-                bool result = loader.stream(sourceURL, [&](std::uint64_t length, const unsigned char* buf, std::size_t size) {
-                    if (isTaskCancelled(taskId)) {
-                        return false;
+                // If the source is a local file, try to hard-link it into the manager storage.
+                // This makes importing preloaded packages near-instant and avoids duplicating
+                // the file on disk. If linking is not possible, fall back to copying.
+                bool linked = false;
+                if (sourceURL.substr(0, 7) == "file://") {
+                    linked = LinkLocalFile(sourceURL.substr(7), packageFileName, fileSize);
+                }
+
+                if (!linked) {
+                    FILE* fpDestRaw = utf8_filesystem::fopen(packageFileName.c_str(), "wb");
+                    if (!fpDestRaw) {
+                        throw PackageException(PackageErrorType::PACKAGE_ERROR_TYPE_SYSTEM, std::string("Could not create file ") + packageFileName);
                     }
+                    std::shared_ptr<FILE> fpDest(fpDestRaw, fclose);
 
-                    if (fwrite(buf, sizeof(unsigned char), size, fpDest.get()) != size) {
-                        Log::Errorf("PackageManager: Storage full? Could not write to package file %s", packageFileName.c_str());
-                        return false;
+                    URLFileLoader loader;
+                    loader.setLocalFiles(true);
+                    bool result = loader.stream(sourceURL, [&](std::uint64_t length, const unsigned char* buf, std::size_t size) {
+                        if (isTaskCancelled(taskId)) {
+                            return false;
+                        }
+
+                        if (fwrite(buf, sizeof(unsigned char), size, fpDest.get()) != size) {
+                            Log::Errorf("PackageManager: Storage full? Could not write to package file %s", packageFileName.c_str());
+                            return false;
+                        }
+                        fileSize += size;
+                        if (length > 0) {
+                            updateTaskStatus(taskId, PackageAction::PACKAGE_ACTION_COPYING, static_cast<float>(fileSize) / static_cast<float>(length));
+                        }
+                        return true;
+                    });
+
+                    if (isTaskCancelled(taskId)) {
+                        throw CancelException();
                     }
-                    fileSize += size;
-                    if (length > 0) {
-                        updateTaskStatus(taskId, PackageAction::PACKAGE_ACTION_COPYING, static_cast<float>(fileSize) / static_cast<float>(length));
+                    if (!result) {
+                        throw PackageException(PackageErrorType::PACKAGE_ERROR_TYPE_SYSTEM, "Failed to import package " + task.packageId);
                     }
-                    return true;
-                });
-
-                if (isTaskCancelled(taskId)) {
-                    throw CancelException();
-                }
-                if (!result) {
-                    throw PackageException(PackageErrorType::PACKAGE_ERROR_TYPE_SYSTEM, "Failed to import package " + task.packageId);
                 }
                 updateTaskStatus(taskId, PackageAction::PACKAGE_ACTION_COPYING, 1.0f);
             }
@@ -897,6 +969,7 @@ namespace carto {
 
         // Check if the package is already downloaded
         bool downloaded = false;
+        int downloadedVersion = -1;
         {
             std::lock_guard<std::recursive_mutex> lock(_mutex);
             sqlite3pp::query query(*_localDb, "SELECT version FROM packages WHERE package_id=:package_id AND valid=1");
@@ -907,15 +980,42 @@ namespace carto {
                     return true;
                 }
                 downloaded = true;
+                downloadedVersion = qit->get<int>(0);
             }
         }
 
         // Create new package file or reuse partly downloaded file
         bool packageSizeIndeterminate = package->getSize() == 0;
         std::string packageFileName = createLocalFilePath(createPackageFileName(task.packageId, task.packageType, task.packageVersion));
+        bool keepPackageFile = false;
         try {
-            // Try to download the package
-            for (int retry = 0; true; retry++) {
+            // If an older version of the package is already downloaded, try to download only the
+            // changed tiles and patch the existing package instead of downloading everything
+            bool delta = false;
+            if (downloaded && task.packageVersion > downloadedVersion && task.packageType == PackageType::PACKAGE_TYPE_MAP) {
+                delta = downloadPackageDiff(taskId, task.packageId, task.packageType, downloadedVersion, task.packageVersion, task.packageLocation, packageFileName);
+                if (delta) {
+                    updateTaskStatus(taskId, PackageAction::PACKAGE_ACTION_DOWNLOADING, 1.0f);
+                }
+            }
+
+            // Use chunked download with parallel range requests for large packages of known size
+            bool chunked = false;
+            if (!delta && !packageSizeIndeterminate && package->getSize() >= DOWNLOAD_CHUNK_SIZE) {
+                std::string packageURL = createPackageURL(task.packageId, task.packageVersion, task.packageLocation, downloaded);
+                if (packageURL.empty()) {
+                    throw PackageException(PackageErrorType::PACKAGE_ERROR_TYPE_NO_OFFLINE_PLAN, "Offline packages not available");
+                }
+                keepPackageFile = true; // downloaded chunks can be resumed later
+                chunked = downloadPackageChunks(taskId, task.packageId, task.packageVersion, packageURL, packageFileName, package->getSize());
+                keepPackageFile = false;
+                if (chunked) {
+                    updateTaskStatus(taskId, PackageAction::PACKAGE_ACTION_DOWNLOADING, 1.0f);
+                }
+            }
+
+            // Try to download the package as a single stream
+            for (int retry = 0; !delta && !chunked; retry++) {
                 if (retry > 0) {
                     utf8_filesystem::unlink(packageFileName.c_str());
                     Log::Infof("PackageManager: Retrying package %s download", task.packageId.c_str());
@@ -1051,7 +1151,9 @@ namespace carto {
             throw;
         }
         catch (...) {
-            utf8_filesystem::unlink(packageFileName.c_str());
+            if (!keepPackageFile) {
+                utf8_filesystem::unlink(packageFileName.c_str());
+            }
             throw;
         }
 
@@ -1059,6 +1161,311 @@ namespace carto {
         return true;
     }
 
+    bool PackageManager::downloadPackageChunks(int taskId, const std::string& packageId, int packageVersion, const std::string& packageURL, const std::string& packageFileName, std::uint64_t fileSize) {
+        std::uint64_t chunkCount = (fileSize + DOWNLOAD_CHUNK_SIZE - 1) / DOWNLOAD_CHUNK_SIZE;
+
+        // Make sure the package file exists
+        {
+            FILE* fpRaw = utf8_filesystem::fopen(packageFileName.c_str(), "ab");
+            if (!fpRaw) {
+                throw PackageException(PackageErrorType::PACKAGE_ERROR_TYPE_SYSTEM, std::string("Could not create download package file ") + packageFileName);
+            }
+            fclose(fpRaw);
+        }
+
+        // Load the checksums of the persisted chunks
+        std::map<std::uint64_t, std::string> chunkChecksumMap;
+        {
+            std::lock_guard<std::recursive_mutex> lock(_mutex);
+            sqlite3pp::query query(*_localDb, "SELECT chunk_index, checksum FROM package_chunks WHERE package_id=:package_id AND version=:version");
+            query.bind(":package_id", packageId.c_str());
+            query.bind(":version", packageVersion);
+            for (auto qit = query.begin(); qit != query.end(); qit++) {
+                chunkChecksumMap[static_cast<std::uint64_t>(qit->get<long long int>(0))] = qit->get<const char*>(1);
+            }
+        }
+
+        // Verify the persisted chunks against the package file, resume only the missing chunks
+        std::vector<std::uint64_t> missingChunks;
+        {
+            std::shared_ptr<FILE> fp;
+            if (FILE* fpRaw = utf8_filesystem::fopen(packageFileName.c_str(), "rb")) {
+                fp = std::shared_ptr<FILE>(fpRaw, fclose);
+            }
+            std::vector<unsigned char> chunkData;
+            for (std::uint64_t chunkIndex = 0; chunkIndex < chunkCount; chunkIndex++) {
+                auto it = chunkChecksumMap.find(chunkIndex);
+                if (it != chunkChecksumMap.end() && fp) {
+                    std::uint64_t chunkOffset = chunkIndex * DOWNLOAD_CHUNK_SIZE;
+                    std::size_t chunkSize = static_cast<std::size_t>(std::min(DOWNLOAD_CHUNK_SIZE, fileSize - chunkOffset));
+                    chunkData.resize(chunkSize);
+                    utf8_filesystem::fseek64(fp.get(), chunkOffset, SEEK_SET);
+                    if (fread(chunkData.data(), sizeof(unsigned char), chunkSize, fp.get()) == chunkSize) {
+                        if (CalculateDataHash(chunkData.data(), chunkSize) == it->second) {
+                            continue;
+                        }
+                    }
+                }
+                missingChunks.push_back(chunkIndex);
+            }
+        }
+
+        // Drop the records of the chunks that are missing or failed verification
+        if (!missingChunks.empty()) {
+            std::lock_guard<std::recursive_mutex> lock(_mutex);
+            for (std::uint64_t chunkIndex : missingChunks) {
+                sqlite3pp::command command(*_localDb, "DELETE FROM package_chunks WHERE package_id=:package_id AND version=:version AND chunk_index=:chunk_index");
+                command.bind(":package_id", packageId.c_str());
+                command.bind(":version", packageVersion);
+                command.bind(":chunk_index", static_cast<long long int>(chunkIndex));
+                command.execute();
+            }
+        }
+
+        // Download the missing chunks on parallel workers
+        if (!missingChunks.empty()) {
+            int concurrency = getDownloadConcurrency();
+            std::atomic<std::size_t> chunkListIndex(0);
+            std::atomic<std::uint64_t> downloadedSize((chunkCount - missingChunks.size()) * DOWNLOAD_CHUNK_SIZE);
+            std::atomic<bool> finished(false), rangeUnsupported(false);
+            std::atomic<int> errorCode(0);
+            std::mutex fileMutex;
+
+            std::size_t workerCount = std::min(missingChunks.size(), static_cast<std::size_t>(concurrency));
+            std::vector<std::thread> workers;
+            workers.reserve(workerCount);
+            for (std::size_t i = 0; i < workerCount; i++) {
+                workers.emplace_back([&]() {
+                    while (!finished) {
+                        std::size_t index = chunkListIndex++;
+                        if (index >= missingChunks.size()) {
+                            break;
+                        }
+                        std::uint64_t chunkIndex = missingChunks[index];
+                        std::uint64_t chunkOffset = chunkIndex * DOWNLOAD_CHUNK_SIZE;
+                        std::size_t chunkSize = static_cast<std::size_t>(std::min(DOWNLOAD_CHUNK_SIZE, fileSize - chunkOffset));
+
+                        std::vector<unsigned char> chunkData;
+                        chunkData.reserve(chunkSize);
+                        int code = DownloadFileRange(packageURL, [this, taskId, chunkOffset, chunkSize, &chunkData, &rangeUnsupported](std::uint64_t offset, std::uint64_t length, const unsigned char* buf, std::size_t size) {
+                            if (isTaskCancelled(taskId) || isTaskPaused(taskId)) {
+                                return false;
+                            }
+                            if (offset != chunkOffset + chunkData.size()) {
+                                if (offset < chunkOffset) {
+                                    rangeUnsupported = true;
+                                }
+                                return false;
+                            }
+                            std::size_t usedSize = static_cast<std::size_t>(std::min(static_cast<std::uint64_t>(size), static_cast<std::uint64_t>(chunkSize - chunkData.size())));
+                            chunkData.insert(chunkData.end(), buf, buf + usedSize);
+                            return chunkData.size() < chunkSize;
+                        }, chunkOffset, chunkSize);
+
+                        if (finished || isTaskCancelled(taskId) || isTaskPaused(taskId) || rangeUnsupported) {
+                            finished = true;
+                            break;
+                        }
+                        if (chunkData.size() != chunkSize) {
+                            // Code 0 with an incomplete chunk means the connection dropped mid-chunk
+                            errorCode = (code != 0 ? code : -1);
+                            finished = true;
+                            break;
+                        }
+
+                        // Store the chunk and persist its checksum
+                        std::string checksum = CalculateDataHash(chunkData.data(), chunkData.size());
+                        {
+                            std::lock_guard<std::mutex> lock(fileMutex);
+                            FILE* fpRaw = utf8_filesystem::fopen(packageFileName.c_str(), "r+b");
+                            if (!fpRaw) {
+                                Log::Errorf("PackageManager: Could not open package file %s", packageFileName.c_str());
+                                errorCode = 1; // positive non-HTTP code, reported as a system error
+                                finished = true;
+                                break;
+                            }
+                            std::shared_ptr<FILE> fp(fpRaw, fclose);
+                            utf8_filesystem::fseek64(fp.get(), chunkOffset, SEEK_SET);
+                            if (fwrite(chunkData.data(), sizeof(unsigned char), chunkData.size(), fp.get()) != chunkData.size()) {
+                                Log::Errorf("PackageManager: Storage full? Could not write to package file %s", packageFileName.c_str());
+                                errorCode = 1; // positive non-HTTP code, reported as a system error
+                                finished = true;
+                                break;
+                            }
+                        }
+                        {
+                            std::lock_guard<std::recursive_mutex> lock(_mutex);
+                            sqlite3pp::command command(*_localDb, "INSERT INTO package_chunks(package_id, version, chunk_index, checksum) VALUES(:package_id, :version, :chunk_index, :checksum)");
+                            command.bind(":package_id", packageId.c_str());
+                            command.bind(":version", packageVersion);
+                            command.bind(":chunk_index", static_cast<long long int>(chunkIndex));
+                            command.bind(":checksum", checksum.c_str());
+                            command.execute();
+                        }
+
+                        std::uint64_t totalSize = (downloadedSize += chunkSize);
+                        updateTaskStatus(taskId, PackageAction::PACKAGE_ACTION_DOWNLOADING, static_cast<float>(totalSize) / static_cast<float>(fileSize));
+                    }
+                });
+            }
+            for (std::thread& worker : workers) {
+                worker.join();
+            }
+
+            if (isTaskCancelled(taskId)) {
+                std::lock_guard<std::recursive_mutex> lock(_mutex);
+                sqlite3pp::command command(*_localDb, "DELETE FROM package_chunks WHERE package_id=:package_id AND version=:version");
+                command.bind(":package_id", packageId.c_str());
+                command.bind(":version", packageVersion);
+                command.execute();
+                throw CancelException();
+            }
+            if (isTaskPaused(taskId)) {
+                throw PauseException();
+            }
+            if (rangeUnsupported) {
+                // The server does not support range requests, restart with a single stream
+                Log::Infof("PackageManager: Range requests not supported for package %s, using single stream", packageId.c_str());
+                std::lock_guard<std::recursive_mutex> lock(_mutex);
+                sqlite3pp::command command(*_localDb, "DELETE FROM package_chunks WHERE package_id=:package_id AND version=:version");
+                command.bind(":package_id", packageId.c_str());
+                command.bind(":version", packageVersion);
+                command.execute();
+                utf8_filesystem::unlink(packageFileName.c_str());
+                return false;
+            }
+            switch (errorCode) {
+            case 0:
+                break;
+            case 402: // Payment required
+                throw PackageException(PackageErrorType::PACKAGE_ERROR_TYPE_DOWNLOAD_LIMIT_EXCEEDED, "Subscription limit exceeded while downloading: " + packageId);
+            case 403: // Forbidden
+                throw PackageException(PackageErrorType::PACKAGE_ERROR_TYPE_NO_OFFLINE_PLAN, "Offline packages not available");
+            case 406: // Not acceptable
+                throw PackageException(PackageErrorType::PACKAGE_ERROR_TYPE_PACKAGE_TOO_BIG, "Package contains too many tiles: " + packageId);
+            default:
+                throw PackageException(errorCode < 0 ? PackageErrorType::PACKAGE_ERROR_TYPE_CONNECTION : PackageErrorType::PACKAGE_ERROR_TYPE_SYSTEM, "Failed to download package " + packageId);
+            }
+        }
+
+        // Verify that every chunk was persisted before dropping the chunk records,
+        // the records are the only way to resume an incomplete download
+        {
+            std::lock_guard<std::recursive_mutex> lock(_mutex);
+            std::uint64_t persistedChunkCount = 0;
+            sqlite3pp::query query(*_localDb, "SELECT COUNT(*) FROM package_chunks WHERE package_id=:package_id AND version=:version");
+            query.bind(":package_id", packageId.c_str());
+            query.bind(":version", packageVersion);
+            for (auto qit = query.begin(); qit != query.end(); qit++) {
+                persistedChunkCount = static_cast<std::uint64_t>(qit->get<long long int>(0));
+            }
+            if (persistedChunkCount != chunkCount) {
+                throw PackageException(PackageErrorType::PACKAGE_ERROR_TYPE_SYSTEM, "Failed to download package " + packageId);
+            }
+
+            // All chunks downloaded and persisted, the chunk records are no longer needed
+            sqlite3pp::command command(*_localDb, "DELETE FROM package_chunks WHERE package_id=:package_id AND version=:version");
+            command.bind(":package_id", packageId.c_str());
+            command.bind(":version", packageVersion);
+            command.execute();
+        }
+        return true;
+    }
+
+    bool PackageManager::downloadPackageDiff(int taskId, const std::string& packageId, PackageType::PackageType packageType, int sourceVersion, int targetVersion, const std::string& baseURL, const std::string& packageFileName) {
+        std::string diffURL = createPackageDiffURL(packageId, sourceVersion, targetVersion, baseURL);
+        if (diffURL.empty()) {
+            return false;
+        }
+
+        std::string sourceFileName = createLocalFilePath(createPackageFileName(packageId, packageType, sourceVersion));
+        std::string diffFileName = packageFileName + ".diff";
+        try {
+            // Download the diff package. In case of errors simply fall back to the full package download.
+            {
+                FILE* fpRaw = utf8_filesystem::fopen(diffFileName.c_str(), "wb");
+                if (!fpRaw) {
+                    throw PackageException(PackageErrorType::PACKAGE_ERROR_TYPE_SYSTEM, std::string("Could not create package diff file ") + diffFileName);
+                }
+                std::shared_ptr<FILE> fp(fpRaw, fclose);
+                int errorCode = DownloadFile(diffURL, [this, fp, taskId, diffFileName](std::uint64_t offset, std::uint64_t length, const unsigned char* buf, std::size_t size) {
+                    if (isTaskCancelled(taskId)) {
+                        return false;
+                    }
+                    if (isTaskPaused(taskId)) {
+                        return false;
+                    }
+
+                    if (fwrite(buf, sizeof(unsigned char), size, fp.get()) != size) {
+                        Log::Errorf("PackageManager: Storage full? Could not write to package diff file %s", diffFileName.c_str());
+                        return false;
+                    }
+                    if (length != std::numeric_limits<std::uint64_t>::max() && length > 0) {
+                        updateTaskStatus(taskId, PackageAction::PACKAGE_ACTION_DOWNLOADING, static_cast<float>(offset + size) / static_cast<float>(length));
+                    }
+                    return true;
+                });
+
+                if (isTaskCancelled(taskId)) {
+                    throw CancelException();
+                }
+                if (isTaskPaused(taskId)) {
+                    throw PauseException();
+                }
+                if (errorCode != 0) {
+                    Log::Infof("PackageManager: Diff not available for package %s, downloading full package", packageId.c_str());
+                    utf8_filesystem::unlink(diffFileName.c_str());
+                    return false;
+                }
+            }
+
+            // Copy the current package file, so that the diff can be applied without touching the valid package
+            {
+                FILE* fpSrcRaw = utf8_filesystem::fopen(sourceFileName.c_str(), "rb");
+                if (!fpSrcRaw) {
+                    utf8_filesystem::unlink(diffFileName.c_str());
+                    return false;
+                }
+                std::shared_ptr<FILE> fpSrc(fpSrcRaw, fclose);
+                FILE* fpDstRaw = utf8_filesystem::fopen(packageFileName.c_str(), "wb");
+                if (!fpDstRaw) {
+                    throw PackageException(PackageErrorType::PACKAGE_ERROR_TYPE_SYSTEM, std::string("Could not create download package file ") + packageFileName);
+                }
+                std::shared_ptr<FILE> fpDst(fpDstRaw, fclose);
+                while (!feof(fpSrc.get())) {
+                    unsigned char buf[65536];
+                    std::size_t n = fread(buf, sizeof(unsigned char), sizeof(buf), fpSrc.get());
+                    if (n > 0) {
+                        if (fwrite(buf, sizeof(unsigned char), n, fpDst.get()) != n) {
+                            throw PackageException(PackageErrorType::PACKAGE_ERROR_TYPE_SYSTEM, std::string("Could not write to package file ") + packageFileName);
+                        }
+                    }
+                    if (isTaskCancelled(taskId)) {
+                        throw CancelException();
+                    }
+                }
+            }
+
+            // Let the package handler patch the copied database
+            bool patched = false;
+            if (auto handler = PackageHandlerFactory(_serverEncKey, _localEncKey).createPackageHandler(packageType, packageFileName)) {
+                patched = handler->importPackageDiff(diffFileName, sourceVersion, targetVersion);
+            }
+            utf8_filesystem::unlink(diffFileName.c_str());
+            if (!patched) {
+                utf8_filesystem::unlink(packageFileName.c_str());
+                return false;
+            }
+        }
+        catch (...) {
+            utf8_filesystem::unlink(diffFileName.c_str());
+            throw;
+        }
+
+        Log::Infof("PackageManager: Package %s updated using diff", packageId.c_str());
+        return true;
+    }
+
     bool PackageManager::removePackage(int taskId) {
         Task task = _taskQueue->getTask(taskId);
 
@@ -1192,6 +1599,11 @@ namespace carto {
                 packageType = static_cast<PackageType::PackageType>(qit->get<int>(1));
                 int version = qit->get<int>(2);
                 packageFileName = createLocalFilePath(createPackageFileName(packageId, packageType, version));
+
+                sqlite3pp::command command(*_localDb, "DELETE FROM package_chunks WHERE package_id=:package_id AND version=:version");
+                command.bind(":package_id", packageId.c_str());
+                command.bind(":version", version);
+                command.execute();
             }
 
             if (packageFileName.empty()) {
@@ -1374,6 +1786,10 @@ namespace carto {
         return baseURL;
     }
 
+    std::string PackageManager::createPackageDiffURL(const std::string& packageId, int sourceVersion, int targetVersion, const std::string& baseURL) const {
+        return std::string(); // diff downloads are not supported by default
+    }
+
     std::shared_ptr<PackageInfo> PackageManager::getCustomPackage(const std::string& packageId, int version) const {
         return std::shared_ptr<PackageInfo>();
     }
@@ -1465,6 +1881,14 @@ namespace carto {
                     name TEXT,
                     value TEXT
                 ))SQL");
+        db.execute(R"SQL(
+                CREATE TABLE IF NOT EXISTS package_chunks (
+                    package_id TEXT NOT NULL,
+                    version INTEGER NOT NULL,
+                    chunk_index INTEGER NOT NULL,
+                    checksum TEXT NOT NULL,
+                    PRIMARY KEY (package_id, version, chunk_index)
+                ))SQL");
         db.execute("CREATE INDEX IF NOT EXISTS packages_package_id ON packages(package_id)");
         
         std::string dbHash;
@@ -1500,9 +1924,13 @@ namespace carto {
     }
 
     std::string PackageManager::CalculateKeyHash(const std::string& encKey) {
+        return CalculateDataHash(reinterpret_cast<const unsigned char*>(encKey.c_str()), encKey.size());
+    }
+
+    std::string PackageManager::CalculateDataHash(const unsigned char* data, std::size_t size) {
         CryptoPP::SHA1 hash;
         unsigned char digest[CryptoPP::SHA1::DIGESTSIZE];
-        hash.CalculateDigest(digest, reinterpret_cast<const unsigned char*>(encKey.c_str()), encKey.size());
+        hash.CalculateDigest(digest, data, size);
         std::string sha1;
         CryptoPP::HexEncoder encoder;
         encoder.Attach(new CryptoPP::StringSink(sha1));
@@ -1547,6 +1975,33 @@ namespace carto {
         return NetworkUtils::StreamHTTPResponse("GET", url, requestHeaders, responseHeaders, handler, offset, Log::IsShowDebug());
     }
 
+    int PackageManager::DownloadFileRange(const std::string& url, NetworkUtils::HandlerFunc handler, std::uint64_t offset, std::uint64_t size) {
+        Log::Debugf("PackageManager::DownloadFileRange: %s (%lld-%lld)", url.c_str(), static_cast<long long>(offset), static_cast<long long>(offset + size - 1));
+        std::map<std::string, std::string> requestHeaders = NetworkUtils::CreateAppRefererHeader();
+        requestHeaders["Range"] = "bytes=" + boost::lexical_cast<std::string>(offset) + "-" + boost::lexical_cast<std::string>(offset + size - 1);
+        std::map<std::string, std::string> responseHeaders;
+        return NetworkUtils::StreamHTTPResponse("GET", url, requestHeaders, responseHeaders, handler, offset, Log::IsShowDebug());
+    }
+
+    bool PackageManager::LinkLocalFile(const std::string& sourceFileName, const std::string& destFileName, std::uint64_t& fileSize) {
+#ifdef _WIN32
+        // Hard links are not supported on all target file systems, fall back to copying
+        return false;
+#else
+        utf8_filesystem::stat st;
+        if (utf8_filesystem::fstat(sourceFileName.c_str(), &st) != 0) {
+            return false;
+        }
+        utf8_filesystem::unlink(destFileName.c_str());
+        if (::link(sourceFileName.c_str(), destFileName.c_str()) != 0) {
+            return false;
+        }
+        Log::Debugf("PackageManager::LinkLocalFile: Linked %s", sourceFileName.c_str());
+        fileSize = static_cast<std::uint64_t>(st.st_size);
+        return true;
+#endif
+    }
+
     PackageManager::PersistentTaskQueue::PersistentTaskQueue(const std::string& dbFileName) {
         _localDb = std::make_shared<sqlite3pp::database>(dbFileName.c_str());
         _localDb->execute("PRAGMA encoding='UTF-8'");
@@ -1675,6 +2130,9 @@ namespace carto {
     }
 
     const int PackageManager::DEFAULT_TILEMASK_ZOOMLEVEL = 14;
+    const int PackageManager::DEFAULT_DOWNLOAD_CONCURRENCY = 4;
+    const int PackageManager::DEFAULT_TILE_CACHE_CAPACITY = 64;
+    const std::uint64_t PackageManager::DOWNLOAD_CHUNK_SIZE = 4 * 1024 * 1024;
 }
 
 #endif
@@ -120,6 +120,33 @@ namespace carto {
          */
         std::string getSchema() const;
 
+        /**
+         * Returns the number of parallel connections used for package downloads.
+         * @return The number of parallel connections used for package downloads.
+         */
+        int getDownloadConcurrency() const;
+        /**
+         * Sets the number of parallel connections used for package downloads.
+         * Large packages are downloaded in fixed-size chunks using HTTP range requests, with
+         * the chunks spread over the given number of connections. Downloaded chunks are
+         * persisted, so an interrupted download resumes with only the missing chunks.
+         * @param concurrency The number of parallel connections to use. The default is 4.
+         */
+        void setDownloadConcurrency(int concurrency);
+
+        /**
+         * Returns the capacity of the per-package caches for decrypted tiles.
+         * @return The capacity of the per-package tile caches, in tiles.
+         */
+        int getTileCacheCapacity() const;
+        /**
+         * Sets the capacity of the per-package caches for decrypted tiles.
+         * Recently used tiles are kept in memory in decrypted and decompressed form,
+         * so revisiting them avoids repeated database access and decryption work.
+         * @param capacity The capacity of the per-package tile caches, in tiles. Use 0 to disable the caches. The default is 64.
+         */
+        void setTileCacheCapacity(int capacity);
+
         /**
          * Returns the list of available server packages.
          * Note that the list must be retrieved from the server first, using startPackageListDownload.
@@ -242,7 +269,8 @@ namespace carto {
         virtual std::string createPackageFileName(const std::string& packageId, PackageType::PackageType packageType, int version) const;
         virtual std::string createPackageListURL(const std::string& baseURL) const;
         virtual std::string createPackageURL(const std::string& packageId, int version, const std::string& baseURL, bool downloaded) const;
-        
+        virtual std::string createPackageDiffURL(const std::string& packageId, int sourceVersion, int targetVersion, const std::string& baseURL) const;
+
         virtual std::shared_ptr<PackageInfo> getCustomPackage(const std::string& packageId, int version) const;
 
         virtual bool updateStyle(const std::string& styleName);
@@ -312,6 +340,8 @@ namespace carto {
         bool downloadPackageList(int taskId);
         bool importPackage(int taskId);
         bool downloadPackage(int taskId);
+        bool downloadPackageChunks(int taskId, const std::string& packageId, int packageVersion, const std::string& packageURL, const std::string& packageFileName, std::uint64_t fileSize);
+        bool downloadPackageDiff(int taskId, const std::string& packageId, PackageType::PackageType packageType, int sourceVersion, int targetVersion, const std::string& baseURL, const std::string& packageFileName);
         bool removePackage(int taskId);
         bool downloadStyle(int taskId);
         
@@ -333,6 +363,7 @@ namespace carto {
         static void InitializeDb(sqlite3pp::database& db, const std::string& encKey);
         static bool CheckDbEncryption(sqlite3pp::database& db, const std::string& encKey);
         static std::string CalculateKeyHash(const std::string& encKey);
+        static std::string CalculateDataHash(const unsigned char* data, std::size_t size);
 
         static MapTile CalculateMapTile(const MapPos& mapPos, int zoom, const std::shared_ptr<Projection>& proj);
 
@@ -340,8 +371,14 @@ namespace carto {
         static std::string EncodeTileMask(const std::shared_ptr<PackageTileMask>& tileMask);
 
         static int DownloadFile(const std::string& url, NetworkUtils::HandlerFunc handler, std::uint64_t offset = 0);
+        static int DownloadFileRange(const std::string& url, NetworkUtils::HandlerFunc handler, std::uint64_t offset, std::uint64_t size);
+
+        static bool LinkLocalFile(const std::string& sourceFileName, const std::string& destFileName, std::uint64_t& fileSize);
 
         static const int DEFAULT_TILEMASK_ZOOMLEVEL;
+        static const int DEFAULT_DOWNLOAD_CONCURRENCY;
+        static const int DEFAULT_TILE_CACHE_CAPACITY;
+        static const std::uint64_t DOWNLOAD_CHUNK_SIZE;
 
         const std::string _packageListURL;
         const std::string _packageListFileName;
@@ -356,6 +393,8 @@ namespace carto {
         std::shared_ptr<std::thread> _packageManagerThread;
         std::vector<std::shared_ptr<OnChangeListener> > _onChangeListeners;
         bool _stopped;
+        int _downloadConcurrency;
+        int _tileCacheCapacity;
 
         int _prevTaskId;
         PackageAction::PackageAction _prevAction;
@@ -7,6 +7,7 @@
 
 #include <vector>
 #include <algorithm>
+#include <bitset>
 
 namespace {
     enum { NP = 255 };
@@ -152,25 +153,30 @@ namespace carto {
     
     PackageTileMask::PackageTileMask(const std::string& stringValue, int maxZoom) :
         _stringValue(stringValue),
-        _rootNode(),
-        _maxZoomLevel(maxZoom)
+        _maxZoomLevel(maxZoom),
+        _insideBits(),
+        _internalBits(),
+        _internalRanks()
     {
         std::queue<bool> data = decodeBase64(stringValue);
-        _rootNode = DecodeTileNode(data, MapTile(0, 0, 0, 0));
+        buildFlatTree(DecodeTileNode(data, MapTile(0, 0, 0, 0)));
     }
 
     PackageTileMask::PackageTileMask(const std::vector<MapTile>& tiles, int clipZoom) :
         _stringValue(),
-        _rootNode(),
-        _maxZoomLevel(0)
+        _maxZoomLevel(0),
+        _insideBits(),
+        _internalBits(),
+        _internalRanks()
     {
         std::unordered_set<MapTile> tileSet(tiles.begin(), tiles.end());
-        _rootNode = BuildTileNode(tileSet, MapTile(0, 0, 0, 0), clipZoom);
+        std::shared_ptr<TileNode> rootNode = BuildTileNode(tileSet, MapTile(0, 0, 0, 0), clipZoom);
         for (const MapTile& tile : tiles) {
             _maxZoomLevel = std::max(_maxZoomLevel, tile.getZoom());
         }
-        std::vector<bool> data = EncodeTileNode(_rootNode);
+        std::vector<bool> data = EncodeTileNode(rootNode);
         _stringValue = encodeBase64(std::move(data));
+        buildFlatTree(rootNode);
     }
 
     const std::string& PackageTileMask::getStringValue() const {
@@ -193,7 +199,9 @@ namespace carto {
             throw NullArgumentException("Null projection");
         }
 
-        std::vector<std::vector<MapPos> > poly = CalculateTileNodeBoundingPolygon(_rootNode, projection);
+        std::queue<bool> data = decodeBase64(_stringValue);
+        std::shared_ptr<TileNode> rootNode = DecodeTileNode(data, MapTile(0, 0, 0, 0));
+        std::vector<std::vector<MapPos> > poly = CalculateTileNodeBoundingPolygon(rootNode, projection);
 
         std::vector<std::vector<MapPos> > optimizedPoly;
         for (std::size_t i = 0; i < poly.size(); i++) {
@@ -206,37 +214,55 @@ namespace carto {
     }
 
     PackageTileStatus::PackageTileStatus PackageTileMask::getTileStatus(const MapTile& mapTile) const {
-        if (std::shared_ptr<TileNode> node = findTileNode(mapTile)) {
-            if (mapTile.getZoom() <= _maxZoomLevel) {
-                return (node->inside ? PackageTileStatus::PACKAGE_TILE_STATUS_FULL : PackageTileStatus::PACKAGE_TILE_STATUS_MISSING);
-            }
+        if (mapTile.getZoom() > _maxZoomLevel || _insideBits.empty()) {
+            return PackageTileStatus::PACKAGE_TILE_STATUS_MISSING;
+        }
+        if (mapTile.getX() < 0 || mapTile.getY() < 0 || mapTile.getX() >= (1 << mapTile.getZoom()) || mapTile.getY() >= (1 << mapTile.getZoom())) {
+            return PackageTileStatus::PACKAGE_TILE_STATUS_MISSING;
         }
-        return PackageTileStatus::PACKAGE_TILE_STATUS_MISSING;
-    }
 
-    std::shared_ptr<PackageTileMask::TileNode> PackageTileMask::findTileNode(const MapTile& tile) const {
-        if (tile.getZoom() == 0) {
-            if (tile.getX() == 0 && tile.getY() == 0) {
-                return _rootNode;
+        std::size_t index = 0;
+        for (int zoom = mapTile.getZoom(); zoom > 0; zoom--) {
+            if ((_internalBits[index >> 6] & (1ULL << (index & 63))) == 0) {
+                break; // the node is a leaf, it covers all its subtiles
             }
-            return std::shared_ptr<TileNode>();
+            int dx = (mapTile.getX() >> (zoom - 1)) & 1;
+            int dy = (mapTile.getY() >> (zoom - 1)) & 1;
+            index = findFlatNodeRank(index) * 4 + 1 + dy * 2 + dx;
         }
+        return ((_insideBits[index >> 6] & (1ULL << (index & 63))) != 0 ? PackageTileStatus::PACKAGE_TILE_STATUS_FULL : PackageTileStatus::PACKAGE_TILE_STATUS_MISSING);
+    }
 
-        std::shared_ptr<TileNode> parentNode = findTileNode(MapTile(tile.getX() / 2, tile.getY() / 2, tile.getZoom() - 1, tile.getFrameNr()));
-        if (parentNode) {
-            for (int i = 0; i < 4; i++) {
-                const std::shared_ptr<TileNode>& node = parentNode->subNodes[i];
-                if (node) {
-                    if (node->tile == tile) {
-                        return node;
-                    }
-                }
+    void PackageTileMask::buildFlatTree(const std::shared_ptr<TileNode>& rootNode) {
+        std::queue<std::shared_ptr<TileNode> > nodeQueue;
+        nodeQueue.push(rootNode);
+        std::size_t index = 0;
+        std::uint32_t rank = 0;
+        while (!nodeQueue.empty()) {
+            std::shared_ptr<TileNode> node = nodeQueue.front();
+            nodeQueue.pop();
+            if ((index & 63) == 0) {
+                _insideBits.push_back(0);
+                _internalBits.push_back(0);
+                _internalRanks.push_back(rank);
             }
-            if (parentNode->inside) {
-                return parentNode;
+            if (node->inside) {
+                _insideBits[index >> 6] |= 1ULL << (index & 63);
             }
+            if (node->subNodes[0]) {
+                _internalBits[index >> 6] |= 1ULL << (index & 63);
+                rank++;
+                for (int i = 0; i < 4; i++) {
+                    nodeQueue.push(node->subNodes[i]);
+                }
+            }
+            index++;
         }
-        return std::shared_ptr<TileNode>();
+    }
+
+    std::size_t PackageTileMask::findFlatNodeRank(std::size_t index) const {
+        std::uint64_t precedingBits = _internalBits[index >> 6] & ((1ULL << (index & 63)) - 1);
+        return _internalRanks[index >> 6] + std::bitset<64>(precedingBits).count();
     }
 
     std::shared_ptr<PackageTileMask::TileNode> PackageTileMask::BuildTileNode(const std::unordered_set<MapTile>& tileSet, const MapTile& tile, int clipZoom) {
@@ -324,4 +350,111 @@ namespace carto {
         return poly;
     }
 
+    PackageTileMask::Index::Index(const std::vector<std::shared_ptr<PackageTileMask> >& tileMasks) :
+        _insideMasks(),
+        _internalBits(),
+        _internalRanks(),
+        _zoomMasks()
+    {
+        enum : std::int64_t { RESOLVED_INSIDE = -1, RESOLVED_OUTSIDE = -2 };
+
+        std::size_t maskCount = std::min(tileMasks.size(), static_cast<std::size_t>(64));
+        int maxZoomLevel = 0;
+        for (std::size_t i = 0; i < maskCount; i++) {
+            if (tileMasks[i]) {
+                maxZoomLevel = std::max(maxZoomLevel, tileMasks[i]->getMaxZoomLevel());
+            }
+        }
+        _zoomMasks.assign(maxZoomLevel + 1, 0);
+        for (std::size_t i = 0; i < maskCount; i++) {
+            if (tileMasks[i]) {
+                for (int zoom = 0; zoom <= tileMasks[i]->getMaxZoomLevel(); zoom++) {
+                    _zoomMasks[zoom] |= 1ULL << i;
+                }
+            }
+        }
+
+        // Do a simultaneous breadth-first walk over all the masks, merging them into a single flat tree.
+        // Each mask is tracked either via its current node index or as already resolved inside/outside.
+        std::queue<std::vector<std::int64_t> > nodeQueue;
+        {
+            std::vector<std::int64_t> rootStates(maskCount);
+            for (std::size_t i = 0; i < maskCount; i++) {
+                rootStates[i] = (tileMasks[i] && !tileMasks[i]->_insideBits.empty() ? 0 : static_cast<std::int64_t>(RESOLVED_OUTSIDE));
+            }
+            nodeQueue.push(std::move(rootStates));
+        }
+        std::size_t index = 0;
+        std::uint32_t rank = 0;
+        while (!nodeQueue.empty()) {
+            std::vector<std::int64_t> states = std::move(nodeQueue.front());
+            nodeQueue.pop();
+            if ((index & 63) == 0) {
+                _internalBits.push_back(0);
+                _internalRanks.push_back(rank);
+            }
+
+            std::uint64_t insideMask = 0;
+            bool internal = false;
+            for (std::size_t i = 0; i < maskCount; i++) {
+                if (states[i] == RESOLVED_INSIDE) {
+                    insideMask |= 1ULL << i;
+                } else if (states[i] >= 0) {
+                    const PackageTileMask& tileMask = *tileMasks[i];
+                    std::size_t nodeIndex = static_cast<std::size_t>(states[i]);
+                    if (tileMask._insideBits[nodeIndex >> 6] & (1ULL << (nodeIndex & 63))) {
+                        insideMask |= 1ULL << i;
+                    }
+                    if (tileMask._internalBits[nodeIndex >> 6] & (1ULL << (nodeIndex & 63))) {
+                        internal = true;
+                    }
+                }
+            }
+            _insideMasks.push_back(insideMask);
+
+            if (internal) {
+                _internalBits[index >> 6] |= 1ULL << (index & 63);
+                rank++;
+                for (int idx = 0; idx < 4; idx++) {
+                    std::vector<std::int64_t> subStates(maskCount);
+                    for (std::size_t i = 0; i < maskCount; i++) {
+                        subStates[i] = states[i];
+                        if (states[i] >= 0) {
+                            const PackageTileMask& tileMask = *tileMasks[i];
+                            std::size_t nodeIndex = static_cast<std::size_t>(states[i]);
+                            if (tileMask._internalBits[nodeIndex >> 6] & (1ULL << (nodeIndex & 63))) {
+                                subStates[i] = static_cast<std::int64_t>(tileMask.findFlatNodeRank(nodeIndex) * 4 + 1 + idx);
+                            } else {
+                                subStates[i] = (tileMask._insideBits[nodeIndex >> 6] & (1ULL << (nodeIndex & 63)) ? static_cast<std::int64_t>(RESOLVED_INSIDE) : static_cast<std::int64_t>(RESOLVED_OUTSIDE));
+                            }
+                        }
+                    }
+                    nodeQueue.push(std::move(subStates));
+                }
+            }
+            index++;
+        }
+    }
+
+    std::uint64_t PackageTileMask::Index::findTileMasks(const MapTile& mapTile) const {
+        if (mapTile.getZoom() >= static_cast<int>(_zoomMasks.size()) || _insideMasks.empty()) {
+            return 0;
+        }
+        if (mapTile.getX() < 0 || mapTile.getY() < 0 || mapTile.getX() >= (1 << mapTile.getZoom()) || mapTile.getY() >= (1 << mapTile.getZoom())) {
+            return 0;
+        }
+
+        std::size_t index = 0;
+        for (int zoom = mapTile.getZoom(); zoom > 0; zoom--) {
+            if ((_internalBits[index >> 6] & (1ULL << (index & 63))) == 0) {
+                break; // the node is a leaf, it covers all its subtiles
+            }
+            int dx = (mapTile.getX() >> (zoom - 1)) & 1;
+            int dy = (mapTile.getY() >> (zoom - 1)) & 1;
+            std::size_t rank = _internalRanks[index >> 6] + std::bitset<64>(_internalBits[index >> 6] & ((1ULL << (index & 63)) - 1)).count();
+            index = rank * 4 + 1 + dy * 2 + dx;
+        }
+        return _insideMasks[index] & _zoomMasks[mapTile.getZoom()];
+    }
+
 }
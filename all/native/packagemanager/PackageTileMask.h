@@ -11,6 +11,7 @@
 #include "core/MapTile.h"
 
 #include <string>
+#include <cstdint>
 #include <memory>
 #include <queue>
 #include <vector>
@@ -47,6 +48,35 @@ namespace carto {
      */
     class PackageTileMask {
     public:
+        /**
+         * Combined index over multiple tile masks that answers 'which masks contain this tile'
+         * queries with a single probe instead of testing each mask separately.
+         * This class is intended for internal usage.
+         */
+        class Index {
+        public:
+            /**
+             * Constructs a combined index from a list of tile masks.
+             * Note: at most 64 tile masks can be indexed, the remaining masks are ignored.
+             * @param tileMasks The list of tile masks to index.
+             */
+            explicit Index(const std::vector<std::shared_ptr<PackageTileMask> >& tileMasks);
+
+            /**
+             * Returns a bitmask of the indexed tile masks that fully contain the given tile.
+             * Bit i of the result corresponds to the tile mask at index i of the original list.
+             * @param mapTile The tile to check.
+             * @return The bitmask of the tile masks containing the tile.
+             */
+            std::uint64_t findTileMasks(const MapTile& mapTile) const;
+
+        private:
+            std::vector<std::uint64_t> _insideMasks;   // per-node bitmask of the tile masks covering the node, level-order
+            std::vector<std::uint64_t> _internalBits;  // per-node 'node has children' flags, packed in 64-node blocks
+            std::vector<std::uint32_t> _internalRanks; // per-block count of 'internal' nodes in the preceding blocks
+            std::vector<std::uint64_t> _zoomMasks;     // per-zoom bitmask of the tile masks that include the zoom level
+        };
+
         /**
          * Constructs a new package tile mask instance from encoded string and maximum zoom level.
          * @param stringValue The encoded tile mask of the package
@@ -102,7 +132,8 @@ namespace carto {
             TileNode(const MapTile& tile, bool inside) : tile(tile), inside(inside) { }
         };
 
-        std::shared_ptr<TileNode> findTileNode(const MapTile& tile) const;
+        void buildFlatTree(const std::shared_ptr<TileNode>& rootNode);
+        std::size_t findFlatNodeRank(std::size_t index) const;
 
         static std::shared_ptr<TileNode> BuildTileNode(const std::unordered_set<MapTile>& tileSet, const MapTile& tile, int clipZoom);
         static std::shared_ptr<TileNode> DecodeTileNode(std::queue<bool>& data, const MapTile& tile);
@@ -110,8 +141,10 @@ namespace carto {
         static std::vector<std::vector<MapPos> > CalculateTileNodeBoundingPolygon(const std::shared_ptr<TileNode>& node, const std::shared_ptr<Projection>& proj);
 
         std::string _stringValue;
-        std::shared_ptr<TileNode> _rootNode;
         int _maxZoomLevel;
+        std::vector<std::uint64_t> _insideBits;    // per-node 'tile inside the package' flags, level-order, packed in 64-node blocks
+        std::vector<std::uint64_t> _internalBits;  // per-node 'node has children' flags, packed in 64-node blocks
+        std::vector<std::uint32_t> _internalRanks; // per-block count of 'internal' nodes in the preceding blocks
     };
 }
 
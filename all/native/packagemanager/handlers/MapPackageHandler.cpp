@@ -9,7 +9,6 @@
 #include <stdext/zlib.h>
 
 #include <sqlite3pp.h>
-#include <sqlite3ppext.h>
 
 #include <rc5.h>
 #include <sha.h>
@@ -23,13 +22,21 @@ namespace carto {
         PackageHandler(fileName),
         _serverEncKey(serverEncKey),
         _localEncKey(localEncKey),
+        _encrypted(false),
         _packageDb(),
-        _decryptFunc(),
-        _sharedDictionary()
+        _sharedDictionary(),
+        _cacheCapacity(DEFAULT_CACHE_CAPACITY),
+        _cachedDecryptedTiles(),
+        _prefetchThread(),
+        _prefetchTaskQueue(),
+        _prefetchStopped(false),
+        _prefetchCondition(),
+        _prefetchMutex()
     {
     }
 
     MapPackageHandler::~MapPackageHandler() {
+        closeDatabase();
     }
 
     void MapPackageHandler::openDatabase() {
@@ -47,22 +54,8 @@ namespace carto {
                 return;
             }
 
-            // Create new sqlite decryption function. First check if the database is crypted.
-            std::string encKey = _serverEncKey;
-            bool encrypted = CheckDbEncryption(*_packageDb, _serverEncKey + _localEncKey); // NOTE: this is a hack - though tiles are actually encrypted with server key only, with check that local key is included in the hash also
-            _decryptFunc.reset(new sqlite3pp::ext::function(*_packageDb));
-            _decryptFunc->create("tile_decrypt", [encrypted, encKey](sqlite3pp::ext::context& ctx) {
-                const unsigned char* encData = reinterpret_cast<const unsigned char*>(ctx.get<const void*>(0));
-                std::size_t encSize = ctx.args_bytes(0);
-                int zoom = ctx.get<int>(1);
-                int x = ctx.get<int>(2);
-                int y = ctx.get<int>(3);
-                std::vector<unsigned char> encVector(encData, encData + encSize);
-                if (encrypted) {
-                    DecryptTile(encVector, zoom, x, y, encKey);
-                }
-                ctx.result(encVector.empty() ? nullptr : &encVector[0], static_cast<int>(encVector.size()), false);
-            }, 4);
+            // Check if the database is crypted
+            _encrypted = CheckDbEncryption(*_packageDb, _serverEncKey + _localEncKey); // NOTE: this is a hack - though tiles are actually encrypted with server key only, with check that local key is included in the hash also
 
             // Try to load shared dictionary
             _sharedDictionary.reset();
@@ -81,35 +74,74 @@ namespace carto {
     void MapPackageHandler::closeDatabase() {
         std::lock_guard<std::recursive_mutex> lock(_mutex);
 
+        // Stop the prefetch thread and drop all cached tiles
+        std::shared_ptr<std::thread> prefetchThread;
+        {
+            std::lock_guard<std::mutex> prefetchLock(_prefetchMutex);
+            _prefetchStopped = true;
+            prefetchThread = _prefetchThread;
+            _prefetchThread.reset();
+            _prefetchTaskQueue = std::queue<PrefetchTask>();
+            _cachedDecryptedTiles.clear();
+            _prefetchCondition.notify_all();
+        }
+        if (prefetchThread) {
+            prefetchThread->join();
+        }
+        {
+            std::lock_guard<std::mutex> prefetchLock(_prefetchMutex);
+            _prefetchStopped = false;
+        }
+
+        _encrypted = false;
         _packageDb.reset();
-        _decryptFunc.reset();
         _sharedDictionary.reset();
     }
 
     std::shared_ptr<BinaryData> MapPackageHandler::loadTile(const MapTile& mapTile) {
+        // Serve the tile from the decrypted tile cache, if possible
+        {
+            std::lock_guard<std::mutex> prefetchLock(_prefetchMutex);
+            for (auto it = _cachedDecryptedTiles.begin(); it != _cachedDecryptedTiles.end(); it++) {
+                if (it->first == mapTile) {
+                    _cachedDecryptedTiles.splice(_cachedDecryptedTiles.begin(), _cachedDecryptedTiles, it);
+                    return _cachedDecryptedTiles.front().second;
+                }
+            }
+        }
+
         std::lock_guard<std::recursive_mutex> lock(_mutex);
 
         try {
             openDatabase();
 
-            // Try to load the tile (this could fail, as tile masks may not be complete to the last zoom level)
-            sqlite3pp::query query(*_packageDb, "SELECT tile_decrypt(tile_data, zoom_level, tile_column, tile_row) FROM tiles WHERE zoom_level=:zoom AND tile_column=:x AND tile_row=:y");
+            // Read the requested tile and its quadtree siblings in a single batched query
+            // (this could fail, as tile masks may not be complete to the last zoom level).
+            // The siblings are decrypted/decompressed on the prefetch thread, pipelining I/O with CPU work.
+            sqlite3pp::query query(*_packageDb, "SELECT tile_column, tile_row, tile_data FROM tiles WHERE zoom_level=:zoom AND tile_column IN (:x0, :x1) AND tile_row IN (:y0, :y1)");
             query.bind(":zoom", mapTile.getZoom());
-            query.bind(":x", mapTile.getX());
-            query.bind(":y", mapTile.getY());
+            query.bind(":x0", mapTile.getX() & ~1);
+            query.bind(":x1", mapTile.getX() | 1);
+            query.bind(":y0", mapTile.getY() & ~1);
+            query.bind(":y1", mapTile.getY() | 1);
+
+            bool found = false;
+            std::shared_ptr<BinaryData> tileData;
             for (auto qit = query.begin(); qit != query.end(); qit++) {
-                const unsigned char* dataPtr = reinterpret_cast<const unsigned char*>(qit->get<const void*>(0));
-                std::size_t dataSize = qit->column_bytes(0);
+                MapTile tile(qit->get<int>(0), qit->get<int>(1), mapTile.getZoom(), mapTile.getFrameNr());
+                const unsigned char* dataPtr = reinterpret_cast<const unsigned char*>(qit->get<const void*>(2));
+                std::size_t dataSize = qit->column_bytes(2);
                 std::vector<unsigned char> data(dataPtr, dataPtr + dataSize);
-                if (_sharedDictionary) {
-                    std::vector<unsigned char> uncompressedData;
-                    if (!zlib::inflate_raw(data.data(), data.size(), _sharedDictionary->data(), _sharedDictionary->size(), uncompressedData)) {
-                        Log::Warnf("MapPackageHandler::loadTile: Failed to decompress tile with shared dictionary");
-                        return std::shared_ptr<BinaryData>();
-                    }
-                    std::swap(data, uncompressedData);
+                if (tile == mapTile) {
+                    tileData = processTileData(std::move(data), tile, _encrypted, _sharedDictionary);
+                    storeCachedTile(tile, tileData);
+                    found = true;
+                } else {
+                    schedulePrefetchTask(tile, std::move(data));
                 }
-                return std::make_shared<BinaryData>(std::move(data));
+            }
+            if (found) {
+                return tileData;
             }
         }
         catch (const std::exception& ex) {
@@ -118,6 +150,88 @@ namespace carto {
         return std::shared_ptr<BinaryData>();
     }
 
+    std::size_t MapPackageHandler::getCacheCapacity() const {
+        std::lock_guard<std::mutex> prefetchLock(_prefetchMutex);
+        return _cacheCapacity;
+    }
+
+    void MapPackageHandler::setCacheCapacity(std::size_t capacity) {
+        std::lock_guard<std::mutex> prefetchLock(_prefetchMutex);
+        _cacheCapacity = capacity;
+        while (_cachedDecryptedTiles.size() > _cacheCapacity) {
+            _cachedDecryptedTiles.pop_back();
+        }
+    }
+
+    void MapPackageHandler::schedulePrefetchTask(const MapTile& mapTile, std::vector<unsigned char> data) {
+        std::lock_guard<std::mutex> prefetchLock(_prefetchMutex);
+
+        if (_cacheCapacity == 0) {
+            return;
+        }
+        for (auto it = _cachedDecryptedTiles.begin(); it != _cachedDecryptedTiles.end(); it++) {
+            if (it->first == mapTile) {
+                return;
+            }
+        }
+        if (!_prefetchThread) {
+            _prefetchThread = std::make_shared<std::thread>(&MapPackageHandler::runPrefetchThread, this);
+        }
+        _prefetchTaskQueue.push(PrefetchTask { mapTile, std::move(data), _encrypted, _sharedDictionary });
+        _prefetchCondition.notify_one();
+    }
+
+    void MapPackageHandler::runPrefetchThread() {
+        while (true) {
+            std::unique_lock<std::mutex> prefetchLock(_prefetchMutex);
+            _prefetchCondition.wait(prefetchLock, [this]() { return _prefetchStopped || !_prefetchTaskQueue.empty(); });
+            if (_prefetchStopped) {
+                return;
+            }
+            PrefetchTask task = std::move(_prefetchTaskQueue.front());
+            _prefetchTaskQueue.pop();
+            prefetchLock.unlock();
+
+            std::shared_ptr<BinaryData> tileData = processTileData(std::move(task.data), task.tile, task.encrypted, task.sharedDictionary);
+
+            storeCachedTile(task.tile, tileData);
+        }
+    }
+
+    void MapPackageHandler::storeCachedTile(const MapTile& mapTile, const std::shared_ptr<BinaryData>& tileData) {
+        std::lock_guard<std::mutex> prefetchLock(_prefetchMutex);
+
+        if (!tileData || _cacheCapacity == 0 || _prefetchStopped) {
+            return;
+        }
+        for (auto it = _cachedDecryptedTiles.begin(); it != _cachedDecryptedTiles.end(); it++) {
+            if (it->first == mapTile) {
+                _cachedDecryptedTiles.splice(_cachedDecryptedTiles.begin(), _cachedDecryptedTiles, it);
+                _cachedDecryptedTiles.front().second = tileData;
+                return;
+            }
+        }
+        _cachedDecryptedTiles.emplace_front(mapTile, tileData);
+        while (_cachedDecryptedTiles.size() > _cacheCapacity) {
+            _cachedDecryptedTiles.pop_back();
+        }
+    }
+
+    std::shared_ptr<BinaryData> MapPackageHandler::processTileData(std::vector<unsigned char> data, const MapTile& mapTile, bool encrypted, const std::shared_ptr<BinaryData>& sharedDictionary) const {
+        if (encrypted) {
+            DecryptTile(data, mapTile.getZoom(), mapTile.getX(), mapTile.getY(), _serverEncKey);
+        }
+        if (sharedDictionary) {
+            std::vector<unsigned char> uncompressedData;
+            if (!zlib::inflate_raw(data.data(), data.size(), sharedDictionary->data(), sharedDictionary->size(), uncompressedData)) {
+                Log::Warnf("MapPackageHandler::processTileData: Failed to decompress tile with shared dictionary");
+                return std::shared_ptr<BinaryData>();
+            }
+            std::swap(data, uncompressedData);
+        }
+        return std::make_shared<BinaryData>(std::move(data));
+    }
+
     void MapPackageHandler::onImportPackage() {
         std::lock_guard<std::recursive_mutex> lock(_mutex);
 
@@ -135,6 +249,82 @@ namespace carto {
     void MapPackageHandler::onDeletePackage() {
     }
 
+    bool MapPackageHandler::importPackageDiff(const std::string& diffFileName, int sourceVersion, int targetVersion) {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+        try {
+            sqlite3pp::database packageDb;
+            if (packageDb.connect_v2(_fileName.c_str(), SQLITE_OPEN_READWRITE) != SQLITE_OK) {
+                Log::Errorf("MapPackageHandler::importPackageDiff: Failed to open database %s", _fileName.c_str());
+                return false;
+            }
+            sqlite3pp::command attachCommand(packageDb, "ATTACH DATABASE :file_name AS diff");
+            attachCommand.bind(":file_name", diffFileName.c_str());
+            attachCommand.execute();
+
+            // Check that the diff was generated from the version we actually have
+            auto getDiffMetaData = [&packageDb](const char* name) -> std::string {
+                sqlite3pp::query query(packageDb, "SELECT value FROM diff.metadata WHERE name=:name");
+                query.bind(":name", name);
+                for (auto qit = query.begin(); qit != query.end(); qit++) {
+                    return qit->get<const char*>(0);
+                }
+                return std::string();
+            };
+            if (getDiffMetaData("source_version") != std::to_string(sourceVersion) || getDiffMetaData("target_version") != std::to_string(targetVersion)) {
+                Log::Warnf("MapPackageHandler::importPackageDiff: Version mismatch in diff for %s", _fileName.c_str());
+                return false;
+            }
+
+            // The unchanged tiles are compressed with the shared dictionary, so the diff must use the same dictionary
+            sqlite3pp::query dictQuery(packageDb, "SELECT (SELECT value FROM metadata WHERE name='shared_zlib_dict') IS NOT (SELECT value FROM diff.metadata WHERE name='shared_zlib_dict')");
+            for (auto qit = dictQuery.begin(); qit != dictQuery.end(); qit++) {
+                if (qit->get<int>(0) != 0) {
+                    Log::Warnf("MapPackageHandler::importPackageDiff: Shared dictionary mismatch in diff for %s", _fileName.c_str());
+                    return false;
+                }
+            }
+
+            // Verify the hashes of the tiles the diff replaces or removes. A mismatch means the local database
+            // has diverged from the version the diff was generated from.
+            sqlite3pp::query hashQuery(packageDb, "SELECT d.tile_hash, t.tile_data FROM diff.obsolete_tiles d LEFT JOIN tiles t ON t.zoom_level=d.zoom_level AND t.tile_column=d.tile_column AND t.tile_row=d.tile_row");
+            for (auto qit = hashQuery.begin(); qit != hashQuery.end(); qit++) {
+                const char* hashPtr = qit->get<const char*>(0);
+                const unsigned char* dataPtr = reinterpret_cast<const unsigned char*>(qit->get<const void*>(1));
+                std::size_t dataSize = qit->column_bytes(1);
+                if (!hashPtr || !dataPtr || CalculateKeyHash(std::string(reinterpret_cast<const char*>(dataPtr), dataSize)) != hashPtr) {
+                    Log::Warnf("MapPackageHandler::importPackageDiff: Tile hash mismatch in diff for %s", _fileName.c_str());
+                    return false;
+                }
+            }
+
+            // Apply the diff: drop obsolete tiles, insert changed/added tiles, update metadata
+            sqlite3pp::transaction xct(packageDb);
+            {
+                sqlite3pp::command command1(packageDb, "DELETE FROM tiles WHERE EXISTS(SELECT 1 FROM diff.obsolete_tiles d WHERE d.zoom_level=tiles.zoom_level AND d.tile_column=tiles.tile_column AND d.tile_row=tiles.tile_row)");
+                command1.execute();
+                sqlite3pp::command command2(packageDb, "INSERT OR REPLACE INTO tiles(zoom_level, tile_column, tile_row, tile_data) SELECT zoom_level, tile_column, tile_row, tile_data FROM diff.tiles");
+                command2.execute();
+                sqlite3pp::command command3(packageDb, "DELETE FROM metadata WHERE name IN (SELECT name FROM diff.metadata) AND name NOT IN ('nutikeysha1', 'source_version', 'target_version', 'shared_zlib_dict')");
+                command3.execute();
+                sqlite3pp::command command4(packageDb, "INSERT INTO metadata(name, value) SELECT name, value FROM diff.metadata WHERE name NOT IN ('nutikeysha1', 'source_version', 'target_version', 'shared_zlib_dict')");
+                command4.execute();
+                xct.commit();
+            }
+
+            // Restore the encryption hash to the server key state, so that the patched database
+            // goes through the normal import path like a freshly downloaded package
+            if (CheckDbEncryption(packageDb, _serverEncKey + _localEncKey)) {
+                UpdateDbEncryption(packageDb, _serverEncKey);
+            }
+        }
+        catch (const std::exception& ex) {
+            Log::Errorf("MapPackageHandler::importPackageDiff: Exception %s", ex.what());
+            return false;
+        }
+        return true;
+    }
+
     std::shared_ptr<PackageTileMask> MapPackageHandler::calculateTileMask() const {
         std::lock_guard<std::recursive_mutex> lock(_mutex);
 
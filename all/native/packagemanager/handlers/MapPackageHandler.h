@@ -13,12 +13,13 @@
 #include "packagemanager/handlers/PackageHandler.h"
 
 #include <vector>
+#include <list>
+#include <queue>
+#include <thread>
+#include <condition_variable>
 
 namespace sqlite3pp {
     class database;
-    namespace ext {
-        class function;
-    }
 }
 
 namespace carto {
@@ -33,12 +34,30 @@ namespace carto {
         void closeDatabase();
         std::shared_ptr<BinaryData> loadTile(const MapTile& mapTile);
 
+        std::size_t getCacheCapacity() const;
+        void setCacheCapacity(std::size_t capacity);
+
         virtual void onImportPackage();
         virtual void onDeletePackage();
 
+        virtual bool importPackageDiff(const std::string& diffFileName, int sourceVersion, int targetVersion);
+
         virtual std::shared_ptr<PackageTileMask> calculateTileMask() const;
 
     private:
+        struct PrefetchTask {
+            MapTile tile;
+            std::vector<unsigned char> data;
+            bool encrypted;
+            std::shared_ptr<BinaryData> sharedDictionary;
+        };
+
+        void schedulePrefetchTask(const MapTile& mapTile, std::vector<unsigned char> data);
+        void runPrefetchThread();
+        void storeCachedTile(const MapTile& mapTile, const std::shared_ptr<BinaryData>& tileData);
+
+        std::shared_ptr<BinaryData> processTileData(std::vector<unsigned char> data, const MapTile& mapTile, bool encrypted, const std::shared_ptr<BinaryData>& sharedDictionary) const;
+
         static bool CheckDbEncryption(sqlite3pp::database& db, const std::string& encKey);
         static void UpdateDbEncryption(sqlite3pp::database& db, const std::string& encKey);
 
@@ -47,12 +66,23 @@ namespace carto {
         static void DecryptTile(std::vector<unsigned char>& data, int zoom, int x, int y, const std::string& encKey);
         static void SetCipherKeyIV(unsigned char* k, unsigned char* iv, int zoom, int x, int y, const std::string& encKey);
 
+        static const int DEFAULT_CACHE_CAPACITY = 64;
+
         const std::string _serverEncKey;
         const std::string _localEncKey;
 
+        bool _encrypted;
         std::unique_ptr<sqlite3pp::database> _packageDb;
-        std::unique_ptr<sqlite3pp::ext::function> _decryptFunc;
-        std::unique_ptr<BinaryData> _sharedDictionary;
+        std::shared_ptr<BinaryData> _sharedDictionary;
+
+        std::size_t _cacheCapacity;
+        std::list<std::pair<MapTile, std::shared_ptr<BinaryData> > > _cachedDecryptedTiles; // ordered from the most-recently used to the least-recently used
+
+        std::shared_ptr<std::thread> _prefetchThread;
+        std::queue<PrefetchTask> _prefetchTaskQueue;
+        bool _prefetchStopped;
+        std::condition_variable _prefetchCondition;
+        mutable std::mutex _prefetchMutex;
     };
     
 }
@@ -23,6 +23,8 @@ namespace carto {
         virtual void onImportPackage() = 0;
         virtual void onDeletePackage() = 0;
 
+        virtual bool importPackageDiff(const std::string& diffFileName, int sourceVersion, int targetVersion) { return false; }
+
         virtual std::shared_ptr<PackageTileMask> calculateTileMask() const = 0;
     
     protected:
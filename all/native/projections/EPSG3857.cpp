@@ -22,6 +22,26 @@ namespace carto {
         return MapPos(mapPos.getX() * METERS_TO_INTERNAL_EQUATOR, mapPos.getY() * METERS_TO_INTERNAL_EQUATOR, mapPos.getZ() * METERS_TO_INTERNAL_EQUATOR);
     }
 
+    std::vector<MapPos> EPSG3857::fromInternal(const std::vector<MapPos>& mapPosesInternal) const {
+        double scale = 1.0 / METERS_TO_INTERNAL_EQUATOR;
+        std::vector<MapPos> mapPoses;
+        mapPoses.reserve(mapPosesInternal.size());
+        for (const MapPos& mapPosInternal : mapPosesInternal) {
+            mapPoses.emplace_back(mapPosInternal.getX() * scale, mapPosInternal.getY() * scale, mapPosInternal.getZ() * scale);
+        }
+        return mapPoses;
+    }
+
+    std::vector<MapPos> EPSG3857::toInternal(const std::vector<MapPos>& mapPoses) const {
+        double scale = METERS_TO_INTERNAL_EQUATOR;
+        std::vector<MapPos> mapPosesInternal;
+        mapPosesInternal.reserve(mapPoses.size());
+        for (const MapPos& mapPos : mapPoses) {
+            mapPosesInternal.emplace_back(mapPos.getX() * scale, mapPos.getY() * scale, mapPos.getZ() * scale);
+        }
+        return mapPosesInternal;
+    }
+
     MapPos EPSG3857::fromWgs84(const MapPos& wgs84Pos) const {
         double x = wgs84Pos.getX() * Const::DEG_TO_RAD * EARTH_RADIUS;
         double a = std::sin(wgs84Pos.getY() * Const::DEG_TO_RAD);
@@ -35,6 +55,29 @@ namespace carto {
         return MapPos(x, y, mapPos.getZ());
     }
     
+    std::vector<MapPos> EPSG3857::fromWgs84(const std::vector<MapPos>& wgs84Poses) const {
+        std::vector<MapPos> mapPoses;
+        mapPoses.reserve(wgs84Poses.size());
+        for (const MapPos& wgs84Pos : wgs84Poses) {
+            double x = wgs84Pos.getX() * Const::DEG_TO_RAD * EARTH_RADIUS;
+            double a = std::sin(wgs84Pos.getY() * Const::DEG_TO_RAD);
+            double y = 0.5 * EARTH_RADIUS * std::log((1.0 + a) / (1.0 - a));
+            mapPoses.emplace_back(x, y, wgs84Pos.getZ());
+        }
+        return mapPoses;
+    }
+
+    std::vector<MapPos> EPSG3857::toWgs84(const std::vector<MapPos>& mapPoses) const {
+        std::vector<MapPos> wgs84Poses;
+        wgs84Poses.reserve(mapPoses.size());
+        for (const MapPos& mapPos : mapPoses) {
+            double x = mapPos.getX() / EARTH_RADIUS * Const::RAD_TO_DEG;
+            double y = 90.0 - Const::RAD_TO_DEG * (2.0 * std::atan(std::exp(-mapPos.getY() / EARTH_RADIUS)));
+            wgs84Poses.emplace_back(x, y, mapPos.getZ());
+        }
+        return wgs84Poses;
+    }
+
     std::string EPSG3857::getName() const {
         return "EPSG:3857";
     }
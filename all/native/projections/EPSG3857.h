@@ -23,9 +23,15 @@ namespace carto {
         virtual MapPos fromInternal(const MapPos& mapPosInternal) const;
         virtual MapPos toInternal(const MapPos& mapPos) const;
 
+        virtual std::vector<MapPos> fromInternal(const std::vector<MapPos>& mapPosesInternal) const;
+        virtual std::vector<MapPos> toInternal(const std::vector<MapPos>& mapPoses) const;
+
         virtual MapPos fromWgs84(const MapPos& wgs84Pos) const;
         virtual MapPos toWgs84(const MapPos& mapPos) const;
 
+        virtual std::vector<MapPos> fromWgs84(const std::vector<MapPos>& wgs84Poses) const;
+        virtual std::vector<MapPos> toWgs84(const std::vector<MapPos>& mapPoses) const;
+
         virtual std::string getName() const;
         
     private:
@@ -29,6 +29,24 @@ namespace carto {
         return MapPos(x, y, z);
     }
 
+    std::vector<MapPos> EPSG4326::fromInternal(const std::vector<MapPos>& mapPosesInternal) const {
+        std::vector<MapPos> mapPoses;
+        mapPoses.reserve(mapPosesInternal.size());
+        for (const MapPos& mapPosInternal : mapPosesInternal) {
+            mapPoses.push_back(fromInternal(mapPosInternal));
+        }
+        return mapPoses;
+    }
+
+    std::vector<MapPos> EPSG4326::toInternal(const std::vector<MapPos>& mapPoses) const {
+        std::vector<MapPos> mapPosesInternal;
+        mapPosesInternal.reserve(mapPoses.size());
+        for (const MapPos& mapPos : mapPoses) {
+            mapPosesInternal.push_back(toInternal(mapPos));
+        }
+        return mapPosesInternal;
+    }
+
     MapPos EPSG4326::fromWgs84(const MapPos& wgs84Pos) const {
         return wgs84Pos;
     }
@@ -37,6 +55,14 @@ namespace carto {
         return mapPos;
     }
     
+    std::vector<MapPos> EPSG4326::fromWgs84(const std::vector<MapPos>& wgs84Poses) const {
+        return wgs84Poses;
+    }
+
+    std::vector<MapPos> EPSG4326::toWgs84(const std::vector<MapPos>& mapPoses) const {
+        return mapPoses;
+    }
+
     std::string EPSG4326::getName() const {
         return "EPSG:4326";
     }
@@ -14,7 +14,44 @@ namespace carto {
     MapBounds Projection::getBounds() const {
         return _bounds;
     }
-        
+
+    std::vector<MapPos> Projection::fromInternal(const std::vector<MapPos>& poses) const {
+        std::vector<MapPos> transformedPoses;
+        transformedPoses.reserve(poses.size());
+        for (const MapPos& pos : poses) {
+            transformedPoses.push_back(fromInternal(pos));
+        }
+        return transformedPoses;
+    }
+
+    std::vector<MapPos> Projection::toInternal(const std::vector<MapPos>& poses) const {
+        std::vector<MapPos> transformedPoses;
+        transformedPoses.reserve(poses.size());
+        for (const MapPos& pos : poses) {
+            transformedPoses.push_back(toInternal(pos));
+        }
+        return transformedPoses;
+    }
+
+    std::vector<MapPos> Projection::fromWgs84(const std::vector<MapPos>& poses) const {
+        std::vector<MapPos> transformedPoses;
+        transformedPoses.reserve(poses.size());
+        for (const MapPos& pos : poses) {
+            transformedPoses.push_back(fromWgs84(pos));
+        }
+        return transformedPoses;
+    }
+
+    std::vector<MapPos> Projection::toWgs84(const std::vector<MapPos>& poses) const {
+        std::vector<MapPos> transformedPoses;
+        transformedPoses.reserve(poses.size());
+        for (const MapPos& pos : poses) {
+            transformedPoses.push_back(toWgs84(pos));
+        }
+        return transformedPoses;
+    }
+
+
     MapPos Projection::fromLatLong(double lat, double lng) const {
         return fromWgs84(MapPos(lng, lat));
     }
@@ -10,6 +10,8 @@
 #include "core/MapPos.h"
 #include "core/MapBounds.h"
 
+#include <vector>
+
 namespace carto {
     
     /**
@@ -37,7 +39,20 @@ namespace carto {
          * @return The transformed position in the internal coordinate system.
          */
         virtual MapPos toInternal(const MapPos& pos) const = 0;
-        
+
+        /**
+         * Transforms a list of positions from the internal coordinate system to the coordinate system of this projection.
+         * @param poses The positions in the internal coordinate system.
+         * @return The transformed positions in the coordinate system of this projection.
+         */
+        virtual std::vector<MapPos> fromInternal(const std::vector<MapPos>& poses) const;
+        /**
+         * Transforms a list of positions from the coordinate system of this projection to the internal coordinate system.
+         * @param poses The positions in the coordinate system of this projection.
+         * @return The transformed positions in the internal coordinate system.
+         */
+        virtual std::vector<MapPos> toInternal(const std::vector<MapPos>& poses) const;
+
         /**
          * Transforms a position from the WGS84 coordinate system to the coordinate system of this projection.
          * @param pos The position in the WGS84 coordinate system. It should be encoded as longitude-latitude.
@@ -50,7 +65,21 @@ namespace carto {
          * @return The transformed position in the WGS84 coordinate system. It is given as longitude-latitude.
          */
         virtual MapPos toWgs84(const MapPos& pos) const = 0;
-    
+
+        /**
+         * Transforms a list of positions from the WGS84 coordinate system to the coordinate system of this projection.
+         * When importing bulk geometry, this performs much better than transforming the positions one by one.
+         * @param poses The positions in the WGS84 coordinate system, encoded as longitude-latitude.
+         * @return The transformed positions in the coordinate system of this projection.
+         */
+        virtual std::vector<MapPos> fromWgs84(const std::vector<MapPos>& poses) const;
+        /**
+         * Transforms a list of positions from the coordinate system of this projection to the WGS84 coordinate system.
+         * @param poses The positions in the coordinate system of this projection.
+         * @return The transformed positions in the WGS84 coordinate system, encoded as longitude-latitude.
+         */
+        virtual std::vector<MapPos> toWgs84(const std::vector<MapPos>& poses) const;
+
         /**
          * Transforms a position given using latitutde-longitude coordinates from the WGS84 coordinate system to the coordinate system of this projection.
          * @param lat The latitude in the WGS84 coordinate system. It should be in range -90..90.
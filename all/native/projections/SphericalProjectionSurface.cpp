@@ -34,11 +34,18 @@ namespace carto {
     }
 
     void SphericalProjectionSurface::tesselateSegment(const MapPos& mapPos0, const MapPos& mapPos1, std::vector<MapPos>& mapPoses) const {
-        // TODO: make it faster, non-recursive
-        MapPos mapPosM;
-        if (SplitSegment(mapPos0, mapPos1, mapPosM)) {
-            tesselateSegment(mapPos0, mapPosM, mapPoses);
-            tesselateSegment(mapPosM, mapPos1, mapPoses);
+        // Convert the endpoints to spherical coordinates once and do the recursive splitting
+        // in spherical space. The internal <-> spherical conversions dominate the tesselation
+        // cost, this way each point is converted only once instead of once per recursion level.
+        tesselateSegmentSpherical(mapPos0, cglib::unit(InternalToSpherical(mapPos0)), mapPos1, cglib::unit(InternalToSpherical(mapPos1)), mapPoses);
+    }
+
+    void SphericalProjectionSurface::tesselateSegmentSpherical(const MapPos& mapPos0, const cglib::vec3<double>& pos0, const MapPos& mapPos1, const cglib::vec3<double>& pos1, std::vector<MapPos>& mapPoses) const {
+        cglib::vec3<double> posM;
+        if (SplitSegmentSpherical(pos0, pos1, posM)) {
+            MapPos mapPosM = SphericalToInternal(posM);
+            tesselateSegmentSpherical(mapPos0, pos0, mapPosM, posM, mapPoses);
+            tesselateSegmentSpherical(mapPosM, posM, mapPos1, pos1, mapPoses);
             return;
         }
 
@@ -47,29 +54,33 @@ namespace carto {
     }
 
     void SphericalProjectionSurface::tesselateTriangle(unsigned int i0, unsigned int i1, unsigned int i2, std::vector<unsigned int>& indices, std::vector<MapPos>& mapPoses) const {
-        const MapPos& mapPos0 = mapPoses.at(i0);
-        const MapPos& mapPos1 = mapPoses.at(i1);
-        const MapPos& mapPos2 = mapPoses.at(i2);
-        
-        // TODO: make it faster, non-recursive
-        MapPos mapPosM;
-        if (SplitSegment(mapPos0, mapPos1, mapPosM)) {
+        // Like tesselateSegment, convert the corners to spherical coordinates once and
+        // split in spherical space
+        cglib::vec3<double> pos0 = cglib::unit(InternalToSpherical(mapPoses.at(i0)));
+        cglib::vec3<double> pos1 = cglib::unit(InternalToSpherical(mapPoses.at(i1)));
+        cglib::vec3<double> pos2 = cglib::unit(InternalToSpherical(mapPoses.at(i2)));
+        tesselateTriangleSpherical(i0, pos0, i1, pos1, i2, pos2, indices, mapPoses);
+    }
+
+    void SphericalProjectionSurface::tesselateTriangleSpherical(unsigned int i0, const cglib::vec3<double>& pos0, unsigned int i1, const cglib::vec3<double>& pos1, unsigned int i2, const cglib::vec3<double>& pos2, std::vector<unsigned int>& indices, std::vector<MapPos>& mapPoses) const {
+        cglib::vec3<double> posM;
+        if (SplitSegmentSpherical(pos0, pos1, posM)) {
             unsigned int iM = static_cast<int>(mapPoses.size());
-            mapPoses.push_back(mapPosM);
-            tesselateTriangle(i2, i0, iM, indices, mapPoses);
-            tesselateTriangle(i1, i2, iM, indices, mapPoses);
+            mapPoses.push_back(SphericalToInternal(posM));
+            tesselateTriangleSpherical(i2, pos2, i0, pos0, iM, posM, indices, mapPoses);
+            tesselateTriangleSpherical(i1, pos1, i2, pos2, iM, posM, indices, mapPoses);
             return;
-        } else if (SplitSegment(mapPos0, mapPos2, mapPosM)) {
+        } else if (SplitSegmentSpherical(pos0, pos2, posM)) {
             unsigned int iM = static_cast<int>(mapPoses.size());
-            mapPoses.push_back(mapPosM);
-            tesselateTriangle(i0, i1, iM, indices, mapPoses);
-            tesselateTriangle(i1, i2, iM, indices, mapPoses);
+            mapPoses.push_back(SphericalToInternal(posM));
+            tesselateTriangleSpherical(i0, pos0, i1, pos1, iM, posM, indices, mapPoses);
+            tesselateTriangleSpherical(i1, pos1, i2, pos2, iM, posM, indices, mapPoses);
             return;
-        } else if (SplitSegment(mapPos1, mapPos2, mapPosM)) {
+        } else if (SplitSegmentSpherical(pos1, pos2, posM)) {
             unsigned int iM = static_cast<int>(mapPoses.size());
-            mapPoses.push_back(mapPosM);
-            tesselateTriangle(i0, i1, iM, indices, mapPoses);
-            tesselateTriangle(i2, i0, iM, indices, mapPoses);
+            mapPoses.push_back(SphericalToInternal(posM));
+            tesselateTriangleSpherical(i0, pos0, i1, pos1, iM, posM, indices, mapPoses);
+            tesselateTriangleSpherical(i2, pos2, i0, pos0, iM, posM, indices, mapPoses);
             return;
         }
 
@@ -141,9 +152,7 @@ namespace carto {
         return scaleMat;
     }
 
-    bool SphericalProjectionSurface::SplitSegment(const MapPos& mapPos0, const MapPos& mapPos1, MapPos& mapPosM) {
-        cglib::vec3<double> pos0 = cglib::unit(InternalToSpherical(mapPos0));
-        cglib::vec3<double> pos1 = cglib::unit(InternalToSpherical(mapPos1));
+    bool SphericalProjectionSurface::SplitSegmentSpherical(const cglib::vec3<double>& pos0, const cglib::vec3<double>& pos1, cglib::vec3<double>& posM) {
         double dot = cglib::dot_product(pos0, pos1);
         if (dot <= -1) {
             return false; // exactly on the opposite side, no way to split
@@ -152,7 +161,7 @@ namespace carto {
         if (angle * Const::EARTH_RADIUS < SEGMENT_SPLIT_THRESHOLD) {
             return false;
         }
-        mapPosM = SphericalToInternal(cglib::unit(pos0 + pos1));
+        posM = cglib::unit(pos0 + pos1);
         return true;
     }
 
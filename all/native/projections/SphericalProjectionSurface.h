@@ -38,7 +38,10 @@ namespace carto {
         virtual cglib::mat4x4<double> calculateTranslateMatrix(const cglib::vec3<double>& pos0, const cglib::vec3<double>& pos1, double t) const;
 
     private:
-        static bool SplitSegment(const MapPos& mapPos0, const MapPos& mapPos1, MapPos& mapPosM);
+        void tesselateSegmentSpherical(const MapPos& mapPos0, const cglib::vec3<double>& pos0, const MapPos& mapPos1, const cglib::vec3<double>& pos1, std::vector<MapPos>& mapPoses) const;
+        void tesselateTriangleSpherical(unsigned int i0, const cglib::vec3<double>& pos0, unsigned int i1, const cglib::vec3<double>& pos1, unsigned int i2, const cglib::vec3<double>& pos2, std::vector<unsigned int>& indices, std::vector<MapPos>& mapPoses) const;
+
+        static bool SplitSegmentSpherical(const cglib::vec3<double>& pos0, const cglib::vec3<double>& pos1, cglib::vec3<double>& posM);
         static MapPos SphericalToInternal(const cglib::vec3<double>& pos);
         static cglib::vec3<double> InternalToSpherical(const MapPos& mapPos);
         static cglib::mat3x3<double> LocalFrame(const cglib::vec3<double>& pos);
@@ -102,8 +102,9 @@ namespace carto {
            _skyBitmap = skyBitmap;
         }
 
-        // Draw sky and background
-        if (_skyTex || _backgroundTex) {
+        // Draw sky, background and spherical contour as a single pass, as all the quads share the same shader state
+        bool sphericalMode = _options.getRenderProjectionMode() == RenderProjectionMode::RENDER_PROJECTION_MODE_SPHERICAL;
+        if (_skyTex || _backgroundTex || sphericalMode) {
             // Prepare for drawing
             glUseProgram(_shader->getProgId());
             // Texture
@@ -111,50 +112,42 @@ namespace carto {
             glActiveTexture(GL_TEXTURE0);
             // Default lighting
             glUniform3f(_u_lightDir, 0, 0, 1);
-            // Transformation matrix
-            const cglib::mat4x4<float>& mvpMat = viewState.getRTESkyProjectionMat();
-            glUniformMatrix4fv(_u_mvpMat, 1, GL_FALSE, mvpMat.data());
             // Coords, texCoords, colors
             glEnableVertexAttribArray(_a_coord);
-            glEnableVertexAttribArray(_a_texCoord);
             glVertexAttrib3f(_a_normal, 0, 0, 1);
-    
+
             // Draw background and sky
-            if (viewState.isSkyVisible()) {
-                drawSky(viewState);
+            if (_skyTex || _backgroundTex) {
+                // Transformation matrix
+                const cglib::mat4x4<float>& mvpMat = viewState.getRTESkyProjectionMat();
+                glUniformMatrix4fv(_u_mvpMat, 1, GL_FALSE, mvpMat.data());
+                glEnableVertexAttribArray(_a_texCoord);
+
+                if (viewState.isSkyVisible()) {
+                    drawSky(viewState);
+                }
+                drawBackground(viewState);
+
+                glDisableVertexAttribArray(_a_texCoord);
             }
-            drawBackground(viewState);
 
-            // Disable bound arrays
-            glDisableVertexAttribArray(_a_coord);
-            glDisableVertexAttribArray(_a_texCoord);
-        }
-    
-        // Draw contour, if in spherical mode. This is a fix for geometry on the back side of the sphere.
-        if (_options.getRenderProjectionMode() == RenderProjectionMode::RENDER_PROJECTION_MODE_SPHERICAL) {
-            // Prepare for drawing
-            glUseProgram(_shader->getProgId());
-            // Texture
-            glUniform1i(_u_tex, 0);
-            glActiveTexture(GL_TEXTURE0);
-            // Default lighting
-            glUniform3f(_u_lightDir, 0, 0, 1);
-            // Transformation matrix
-            const cglib::mat4x4<float>& mvpMat = viewState.getRTEModelviewProjectionMat();
-            glUniformMatrix4fv(_u_mvpMat, 1, GL_FALSE, mvpMat.data());
-            // Coords, texCoords, colors
-            glEnableVertexAttribArray(_a_coord);
-            glVertexAttrib2f(_a_texCoord, 0, 0);
-            glVertexAttrib3f(_a_normal, 0, 0, 1);
+            // Draw contour, if in spherical mode. This is a fix for geometry on the back side of the sphere.
+            if (sphericalMode) {
+                // Transformation matrix
+                const cglib::mat4x4<float>& mvpMat = viewState.getRTEModelviewProjectionMat();
+                glUniformMatrix4fv(_u_mvpMat, 1, GL_FALSE, mvpMat.data());
+                glVertexAttrib2f(_a_texCoord, 0, 0);
 
-            glDepthMask(GL_TRUE);
-            glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+                glDepthMask(GL_TRUE);
+                glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
 
-            drawContour(viewState);
+                drawContour(viewState);
 
-            glDepthMask(GL_FALSE);
-            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+                glDepthMask(GL_FALSE);
+                glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+            }
 
+            // Disable bound arrays
             glDisableVertexAttribArray(_a_coord);
         }
 
@@ -94,6 +94,12 @@ namespace carto {
         _coordBuf(),
         _indexBuf(),
         _texCoordBuf(),
+        _coordVBO(0),
+        _texCoordVBO(0),
+        _colorVBO(0),
+        _indexVBO(0),
+        _indexVBOCount(0),
+        _vertexArray(0),
         _shader(),
         _a_color(0),
         _a_coord(0),
@@ -129,6 +135,14 @@ namespace carto {
         _u_mvpMat = _shader->getUniformLoc("u_mvpMat");
         _u_tex = _shader->getUniformLoc("u_tex");
 
+        // Buffer objects from the previous context are lost, new ones are created lazily
+        _coordVBO = 0;
+        _texCoordVBO = 0;
+        _colorVBO = 0;
+        _indexVBO = 0;
+        _indexVBOCount = 0;
+        _vertexArray = 0;
+
         // Drop elements
         std::vector<std::shared_ptr<Billboard>> elements;
         {
@@ -140,6 +154,23 @@ namespace carto {
         }
     }
     
+    void BillboardRenderer::warmUpStyles(StyleTextureCache& styleCache) {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+        // Create the textures of all the loaded elements, so that the first frame
+        // does not stall creating them one-by-one as the batches are drawn
+        for (const std::shared_ptr<Billboard>& element : _elements) {
+            std::shared_ptr<BillboardDrawData> drawData = element->getDrawData();
+            if (!drawData) {
+                continue;
+            }
+            const std::shared_ptr<Bitmap>& bitmap = drawData->getBitmap();
+            if (bitmap && !styleCache.get(bitmap, drawData->isGenMipmaps(), false)) {
+                styleCache.create(bitmap, drawData->isGenMipmaps(), false);
+            }
+        }
+    }
+
     bool BillboardRenderer::onDrawFrame(float deltaSeconds, BillboardSorter& billboardSorter, StyleTextureCache& styleCache, const ViewState& viewState) {
         std::lock_guard<std::recursive_mutex> lock(_mutex);
     
@@ -224,6 +255,9 @@ namespace carto {
             drawBatch(opacity, styleCache, viewState);
         }
     
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
         glDisableVertexAttribArray(_a_coord);
         glDisableVertexAttribArray(_a_texCoord);
         glDisableVertexAttribArray(_a_color);
@@ -232,6 +266,12 @@ namespace carto {
     }
     
     void BillboardRenderer::onSurfaceDestroyed() {
+        _coordVBO = 0;
+        _texCoordVBO = 0;
+        _colorVBO = 0;
+        _indexVBO = 0;
+        _indexVBOCount = 0;
+        _vertexArray = 0;
         _shader.reset();
     }
     
@@ -304,7 +344,34 @@ namespace carto {
             if (drawData->getTransition() == 0) {
                 continue;
             }
-    
+
+            // Reject billboards whose conservative bounding sphere the ray misses.
+            // This avoids building the actual quad and doing triangle tests for
+            // the vast majority of the elements when the layer is dense.
+            const std::array<cglib::vec2<float>, 4>& coords = drawData->getCoords();
+            double maxCoordLength = 0;
+            for (int i = 0; i < 4; i++) {
+                maxCoordLength = std::max(maxCoordLength, static_cast<double>(cglib::length(coords[i])));
+            }
+            double scale = (drawData->isScaleWithDPI() ? viewState.getUnitToDPCoef() : viewState.getUnitToPXCoef()) * drawData->getClickScale();
+            double radius = maxCoordLength;
+            switch (drawData->getScalingMode()) {
+            case BillboardScaling::BILLBOARD_SCALING_WORLD_SIZE:
+                break;
+            case BillboardScaling::BILLBOARD_SCALING_SCREEN_SIZE:
+                radius *= scale;
+                break;
+            case BillboardScaling::BILLBOARD_SCALING_CONST_SCREEN_SIZE:
+            default:
+                radius *= scale * drawData->getCameraPlaneZoomDistance();
+                break;
+            }
+            cglib::vec3<double> posDelta = drawData->getPos() - ray.origin;
+            double rayT = cglib::dot_product(posDelta, ray.direction) / cglib::norm(ray.direction);
+            if (cglib::norm(posDelta - ray.direction * rayT) > radius * radius) {
+                continue;
+            }
+
             if (!CalculateBillboardCoords(*drawData, viewState, coordBuf, 0, drawData->getClickScale())) {
                 continue;
             }
@@ -339,31 +406,22 @@ namespace carto {
         }
     }
         
-    void BillboardRenderer::BuildAndDrawBuffers(GLuint a_color,
-                                                GLuint a_coord,
-                                                GLuint a_texCoord,
-                                                std::vector<unsigned char>& colorBuf,
-                                                std::vector<float>& coordBuf,
-                                                std::vector<unsigned short>& indexBuf,
-                                                std::vector<float>& texCoordBuf,
-                                                std::vector<std::shared_ptr<BillboardDrawData> >& drawDataBuffer,
-                                                const cglib::vec2<float>& texCoordScale,
+    void BillboardRenderer::buildAndDrawBuffers(const cglib::vec2<float>& texCoordScale,
                                                 float opacity,
                                                 StyleTextureCache& styleCache,
                                                 const ViewState& viewState)
     {
         // Resize the buffers, if necessary
-        if (coordBuf.size() < drawDataBuffer.size() * 4 * 3) {
-            coordBuf.resize(std::min(drawDataBuffer.size() * 4 * 3, GLContext::MAX_VERTEXBUFFER_SIZE * 3));
-            texCoordBuf.resize(std::min(drawDataBuffer.size() * 4 * 2, GLContext::MAX_VERTEXBUFFER_SIZE * 2));
-            colorBuf.resize(std::min(drawDataBuffer.size() * 4 * 4, GLContext::MAX_VERTEXBUFFER_SIZE * 4));
-            indexBuf.resize(std::min(drawDataBuffer.size() * 6, GLContext::MAX_VERTEXBUFFER_SIZE));
+        if (_coordBuf.size() < _drawDataBuffer.size() * 4 * 3) {
+            _coordBuf.resize(std::min(_drawDataBuffer.size() * 4 * 3, GLContext::MAX_VERTEXBUFFER_SIZE * 3));
+            _texCoordBuf.resize(std::min(_drawDataBuffer.size() * 4 * 2, GLContext::MAX_VERTEXBUFFER_SIZE * 2));
+            _colorBuf.resize(std::min(_drawDataBuffer.size() * 4 * 4, GLContext::MAX_VERTEXBUFFER_SIZE * 4));
         }
-        
+
         // Calculate and draw buffers
         std::size_t drawDataIndex = 0;
-        for (std::size_t i = 0; i < drawDataBuffer.size(); i++) {
-            const std::shared_ptr<BillboardDrawData>& drawData = drawDataBuffer[i];
+        for (std::size_t i = 0; i < _drawDataBuffer.size(); i++) {
+            const std::shared_ptr<BillboardDrawData>& drawData = _drawDataBuffer[i];
 
             // Alpha value
             int alpha = std::min(256, static_cast<int>(256 * opacity * AnimationStyle::CalculateTransition(drawData->getAnimationStyle() ? drawData->getAnimationStyle()->getFadeAnimationType() : AnimationType::ANIMATION_TYPE_NONE, drawData->getTransition())));
@@ -371,10 +429,7 @@ namespace carto {
             // Check for possible overflow in the buffers
             if ((drawDataIndex + 1) * 6 > GLContext::MAX_VERTEXBUFFER_SIZE) {
                 // If it doesn't fit, stop and draw the buffers
-                glVertexAttribPointer(a_coord, 3, GL_FLOAT, GL_FALSE, 0, coordBuf.data());
-                glVertexAttribPointer(a_texCoord, 2, GL_FLOAT, GL_FALSE, 0, texCoordBuf.data());
-                glVertexAttribPointer(a_color, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, colorBuf.data());
-                glDrawElements(GL_TRIANGLES, drawDataIndex * 6, GL_UNSIGNED_SHORT, indexBuf.data());
+                drawBuffers(drawDataIndex);
                 // Start filling buffers from the beginning
                 drawDataIndex = 0;
             }
@@ -386,7 +441,7 @@ namespace carto {
             
             // Calculate coordinates
             float relativeSize = AnimationStyle::CalculateTransition(drawData->getAnimationStyle() ? drawData->getAnimationStyle()->getSizeAnimationType() : AnimationType::ANIMATION_TYPE_NONE, drawData->getTransition());
-            if (!CalculateBillboardCoords(*drawData, viewState, coordBuf, drawDataIndex, relativeSize)) {
+            if (!CalculateBillboardCoords(*drawData, viewState, _coordBuf, drawDataIndex, relativeSize)) {
                 continue;
             }
             
@@ -400,52 +455,121 @@ namespace carto {
             // Calculate texture coordinates
             std::size_t texCoordIndex = drawDataIndex * 4 * 2;
             if (!flip) {
-                texCoordBuf[texCoordIndex + 0] = 0.0f;
-                texCoordBuf[texCoordIndex + 1] = texCoordScale(1);
-                texCoordBuf[texCoordIndex + 2] = 0.0f;
-                texCoordBuf[texCoordIndex + 3] = 0.0f;
-                texCoordBuf[texCoordIndex + 4] = texCoordScale(0);
-                texCoordBuf[texCoordIndex + 5] = texCoordScale(1);
-                texCoordBuf[texCoordIndex + 6] = texCoordScale(0);
-                texCoordBuf[texCoordIndex + 7] = 0.0f;
+                _texCoordBuf[texCoordIndex + 0] = 0.0f;
+                _texCoordBuf[texCoordIndex + 1] = texCoordScale(1);
+                _texCoordBuf[texCoordIndex + 2] = 0.0f;
+                _texCoordBuf[texCoordIndex + 3] = 0.0f;
+                _texCoordBuf[texCoordIndex + 4] = texCoordScale(0);
+                _texCoordBuf[texCoordIndex + 5] = texCoordScale(1);
+                _texCoordBuf[texCoordIndex + 6] = texCoordScale(0);
+                _texCoordBuf[texCoordIndex + 7] = 0.0f;
             } else {
-                texCoordBuf[texCoordIndex + 0] = texCoordScale(0);
-                texCoordBuf[texCoordIndex + 1] = 0.0f;
-                texCoordBuf[texCoordIndex + 2] = texCoordScale(0);
-                texCoordBuf[texCoordIndex + 3] = texCoordScale(1);
-                texCoordBuf[texCoordIndex + 4] = 0.0f;
-                texCoordBuf[texCoordIndex + 5] = 0.0f;
-                texCoordBuf[texCoordIndex + 6] = 0.0f;
-                texCoordBuf[texCoordIndex + 7] = texCoordScale(1);
+                _texCoordBuf[texCoordIndex + 0] = texCoordScale(0);
+                _texCoordBuf[texCoordIndex + 1] = 0.0f;
+                _texCoordBuf[texCoordIndex + 2] = texCoordScale(0);
+                _texCoordBuf[texCoordIndex + 3] = texCoordScale(1);
+                _texCoordBuf[texCoordIndex + 4] = 0.0f;
+                _texCoordBuf[texCoordIndex + 5] = 0.0f;
+                _texCoordBuf[texCoordIndex + 6] = 0.0f;
+                _texCoordBuf[texCoordIndex + 7] = texCoordScale(1);
             }
             
             // Calculate colors
             const Color& color = drawData->getColor();
             std::size_t colorIndex = drawDataIndex * 4 * 4;
             for (int i = 0; i < 16; i += 4) {
-                colorBuf[colorIndex + i + 0] = static_cast<unsigned char>((color.getR() * alpha) >> 8);
-                colorBuf[colorIndex + i + 1] = static_cast<unsigned char>((color.getG() * alpha) >> 8);
-                colorBuf[colorIndex + i + 2] = static_cast<unsigned char>((color.getB() * alpha) >> 8);
-                colorBuf[colorIndex + i + 3] = static_cast<unsigned char>((color.getA() * alpha) >> 8);
+                _colorBuf[colorIndex + i + 0] = static_cast<unsigned char>((color.getR() * alpha) >> 8);
+                _colorBuf[colorIndex + i + 1] = static_cast<unsigned char>((color.getG() * alpha) >> 8);
+                _colorBuf[colorIndex + i + 2] = static_cast<unsigned char>((color.getB() * alpha) >> 8);
+                _colorBuf[colorIndex + i + 3] = static_cast<unsigned char>((color.getA() * alpha) >> 8);
             }
             
-            // Calculate indices
-            std::size_t indexIndex = drawDataIndex * 6;
-            unsigned short vertexIndex = static_cast<unsigned short>(drawDataIndex * 4);
-            indexBuf[indexIndex + 0] = vertexIndex + 0;
-            indexBuf[indexIndex + 1] = vertexIndex + 1;
-            indexBuf[indexIndex + 2] = vertexIndex + 2;
-            indexBuf[indexIndex + 3] = vertexIndex + 1;
-            indexBuf[indexIndex + 4] = vertexIndex + 3;
-            indexBuf[indexIndex + 5] = vertexIndex + 2;
-            
             drawDataIndex++;
         }
-        
-        glVertexAttribPointer(a_coord, 3, GL_FLOAT, GL_FALSE, 0, coordBuf.data());
-        glVertexAttribPointer(a_texCoord, 2, GL_FLOAT, GL_FALSE, 0, texCoordBuf.data());
-        glVertexAttribPointer(a_color, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, colorBuf.data());
-        glDrawElements(GL_TRIANGLES, drawDataIndex * 6, GL_UNSIGNED_SHORT, indexBuf.data());
+
+        drawBuffers(drawDataIndex);
+    }
+
+    void BillboardRenderer::drawBuffers(std::size_t drawDataCount) {
+        if (drawDataCount == 0) {
+            return;
+        }
+
+        // Create the persistent buffer objects lazily. The objects are reused between
+        // frames and batches, only their contents are streamed.
+        if (_coordVBO == 0) {
+            GLuint vbos[4] = { 0, 0, 0, 0 };
+            glGenBuffers(4, vbos);
+            _coordVBO = vbos[0];
+            _texCoordVBO = vbos[1];
+            _colorVBO = vbos[2];
+            _indexVBO = vbos[3];
+            _indexVBOCount = 0;
+
+            // Capture the attribute layout in a vertex array object, if supported.
+            // The layout references buffer names, not contents, so streaming new data
+            // into the buffers does not invalidate it and the per-draw attribute setup
+            // reduces to a single bind call.
+            if (GLContext::VERTEX_ARRAY_OBJECT) {
+                GLContext::GenVertexArraysOES(1, &_vertexArray);
+                GLContext::BindVertexArrayOES(_vertexArray);
+                glEnableVertexAttribArray(_a_coord);
+                glEnableVertexAttribArray(_a_texCoord);
+                glEnableVertexAttribArray(_a_color);
+                glBindBuffer(GL_ARRAY_BUFFER, _coordVBO);
+                glVertexAttribPointer(_a_coord, 3, GL_FLOAT, GL_FALSE, 0, 0);
+                glBindBuffer(GL_ARRAY_BUFFER, _texCoordVBO);
+                glVertexAttribPointer(_a_texCoord, 2, GL_FLOAT, GL_FALSE, 0, 0);
+                glBindBuffer(GL_ARRAY_BUFFER, _colorVBO);
+                glVertexAttribPointer(_a_color, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, 0);
+                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexVBO);
+                GLContext::BindVertexArrayOES(0);
+            }
+        }
+
+        // The index pattern is the same for every quad, so the index buffer is uploaded
+        // only when it needs to grow and stays static afterwards
+        if (_indexVBOCount < drawDataCount * 6) {
+            std::size_t quadCount = std::min(GLContext::MAX_VERTEXBUFFER_SIZE / 6, std::max(drawDataCount, _indexVBOCount / 6 * 2));
+            _indexBuf.resize(quadCount * 6);
+            for (std::size_t i = 0; i < quadCount; i++) {
+                unsigned short vertexIndex = static_cast<unsigned short>(i * 4);
+                _indexBuf[i * 6 + 0] = vertexIndex + 0;
+                _indexBuf[i * 6 + 1] = vertexIndex + 1;
+                _indexBuf[i * 6 + 2] = vertexIndex + 2;
+                _indexBuf[i * 6 + 3] = vertexIndex + 1;
+                _indexBuf[i * 6 + 4] = vertexIndex + 3;
+                _indexBuf[i * 6 + 5] = vertexIndex + 2;
+            }
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexVBO);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, _indexBuf.size() * sizeof(unsigned short), _indexBuf.data(), GL_STATIC_DRAW);
+            _indexVBOCount = _indexBuf.size();
+        }
+
+        // Stream the vertex data. Orphaning via glBufferData avoids synchronizing with
+        // draw calls still using the previous contents. Array buffer bindings are not
+        // part of vertex array object state, so streaming works the same on both paths.
+        glBindBuffer(GL_ARRAY_BUFFER, _coordVBO);
+        glBufferData(GL_ARRAY_BUFFER, drawDataCount * 4 * 3 * sizeof(float), _coordBuf.data(), GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, _texCoordVBO);
+        glBufferData(GL_ARRAY_BUFFER, drawDataCount * 4 * 2 * sizeof(float), _texCoordBuf.data(), GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, _colorVBO);
+        glBufferData(GL_ARRAY_BUFFER, drawDataCount * 4 * 4 * sizeof(unsigned char), _colorBuf.data(), GL_DYNAMIC_DRAW);
+
+        if (_vertexArray != 0) {
+            GLContext::BindVertexArrayOES(_vertexArray);
+            glDrawElements(GL_TRIANGLES, drawDataCount * 6, GL_UNSIGNED_SHORT, 0);
+            GLContext::BindVertexArrayOES(0);
+        } else {
+            glBindBuffer(GL_ARRAY_BUFFER, _coordVBO);
+            glVertexAttribPointer(_a_coord, 3, GL_FLOAT, GL_FALSE, 0, 0);
+            glBindBuffer(GL_ARRAY_BUFFER, _texCoordVBO);
+            glVertexAttribPointer(_a_texCoord, 2, GL_FLOAT, GL_FALSE, 0, 0);
+            glBindBuffer(GL_ARRAY_BUFFER, _colorVBO);
+            glVertexAttribPointer(_a_color, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, 0);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexVBO);
+            glDrawElements(GL_TRIANGLES, drawDataCount * 6, GL_UNSIGNED_SHORT, 0);
+        }
     }
         
     bool BillboardRenderer::calculateBaseBillboardDrawData(const std::shared_ptr<BillboardDrawData>& drawData, const ViewState& viewState) {
@@ -514,15 +638,14 @@ namespace carto {
     void BillboardRenderer::drawBatch(float opacity, StyleTextureCache& styleCache, const ViewState& viewState) {
         // Bind texture
         const std::shared_ptr<Bitmap>& bitmap = _drawDataBuffer.front()->getBitmap();
-        std::shared_ptr<Texture> texture = styleCache.get(bitmap);
+        std::shared_ptr<Texture> texture = styleCache.get(bitmap, _drawDataBuffer.front()->isGenMipmaps(), false);
         if (!texture) {
             texture = styleCache.create(bitmap, _drawDataBuffer.front()->isGenMipmaps(), false);
         }
         glBindTexture(GL_TEXTURE_2D, texture->getTexId());
         
         // Draw the draw datas, multiple passes may be necessary
-        BuildAndDrawBuffers(_a_color, _a_coord, _a_texCoord, _colorBuf, _coordBuf, _indexBuf, _texCoordBuf, _drawDataBuffer,
-                            texture->getTexCoordScale(), opacity, styleCache, viewState);
+        buildAndDrawBuffers(texture->getTexCoordScale(), opacity, styleCache, viewState);
     }
     
     const std::string BillboardRenderer::BILLBOARD_VERTEX_SHADER = R"GLSL(
@@ -43,6 +43,7 @@ namespace carto {
         void offsetLayerHorizontally(double offset);
     
         void onSurfaceCreated(const std::shared_ptr<ShaderManager>& shaderManager, const std::shared_ptr<TextureManager>& textureManager);
+        void warmUpStyles(StyleTextureCache& styleCache);
         bool onDrawFrame(float deltaSeconds, BillboardSorter& billboardSorter, StyleTextureCache& styleCache, const ViewState& viewState);
         void onDrawFrameSorted(float deltaSeconds, const std::vector<std::shared_ptr<BillboardDrawData> >& billboardDrawDatas, StyleTextureCache& styleCache, const ViewState& viewState);
         void onSurfaceDestroyed();
@@ -59,19 +60,13 @@ namespace carto {
         void calculateRayIntersectedElements(const std::shared_ptr<VectorLayer>& layer, const cglib::ray3<double>& ray, const ViewState& viewState, std::vector<RayIntersectedElement>& results) const;
     
     private:
-        static void BuildAndDrawBuffers(GLuint a_color,
-                                        GLuint a_coord,
-                                        GLuint a_texCoord,
-                                        std::vector<unsigned char>& colorBuf,
-                                        std::vector<float>& coordBuf,
-                                        std::vector<unsigned short>& indexBuf,
-                                        std::vector<float>& texCoordBuf,
-                                        std::vector<std::shared_ptr<BillboardDrawData> >& drawDataBuffer,
-                                        const cglib::vec2<float>& texCoordScale,
-                                        float opacity,
-                                        StyleTextureCache& styleCache,
-                                        const ViewState& viewState);
-        
+        void buildAndDrawBuffers(const cglib::vec2<float>& texCoordScale,
+                                 float opacity,
+                                 StyleTextureCache& styleCache,
+                                 const ViewState& viewState);
+
+        void drawBuffers(std::size_t drawDataCount);
+
         bool calculateBaseBillboardDrawData(const std::shared_ptr<BillboardDrawData>& drawData, const ViewState& viewState);
         
         void drawBatch(float opacity, StyleTextureCache& styleCache, const ViewState& viewState);
@@ -90,7 +85,14 @@ namespace carto {
         std::vector<float> _coordBuf;
         std::vector<unsigned short> _indexBuf;
         std::vector<float> _texCoordBuf;
-    
+
+        GLuint _coordVBO;
+        GLuint _texCoordVBO;
+        GLuint _colorVBO;
+        GLuint _indexVBO;
+        std::size_t _indexVBOCount;
+        GLuint _vertexArray;
+
         std::shared_ptr<Shader> _shader;
         GLuint _a_color;
         GLuint _a_coord;
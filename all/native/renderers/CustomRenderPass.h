@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2016 CartoDB. All rights reserved.
+ * Copying and using this code is allowed only according
+ * to license terms, as given in https://cartodb.com/terms/
+ */
+
+#ifndef _CARTO_CUSTOMRENDERPASS_H_
+#define _CARTO_CUSTOMRENDERPASS_H_
+
+namespace carto {
+
+    namespace CustomRenderPassSlot {
+        /**
+         * The point of the rendered frame at which a custom render pass is executed.
+         */
+        enum CustomRenderPassSlot {
+            /**
+             * The pass is executed after the background and sky are drawn, before any layers.
+             */
+            CUSTOM_RENDER_PASS_SLOT_BACKGROUND,
+            /**
+             * The pass is executed after all layers and billboards are drawn, before the watermark.
+             */
+            CUSTOM_RENDER_PASS_SLOT_LAYERS,
+            /**
+             * The pass is executed after the watermark, at the very end of the frame.
+             */
+            CUSTOM_RENDER_PASS_SLOT_OVERLAY
+        };
+    }
+
+    /**
+     * A custom render pass that can be registered with the map renderer and gets executed
+     * at a fixed point of every rendered frame. Custom render passes can be used to add
+     * post-processing or overlay effects on top of the built-in rendering pipeline.
+     * All the methods are called from GL renderer thread, not from main thread.
+     */
+    class CustomRenderPass {
+    public:
+        virtual ~CustomRenderPass() { }
+
+        /**
+         * Method that gets called when the rendering surface is created or recreated.
+         * GL resources used by the pass should be created here, any GL resources
+         * created before this call are no longer valid.
+         */
+        virtual void onSurfaceCreated() { }
+
+        /**
+         * Method that gets called every frame at the slot the pass was registered for.
+         * The default frame buffer of the view is bound when the method is called and
+         * the pass must bind it again before returning if it renders to its own frame
+         * buffer objects. Any other global GL state the pass changes (blending mode,
+         * depth testing, face culling) must be restored before returning.
+         */
+        virtual void onDrawFrame() { }
+
+        /**
+         * Method that gets called when the rendering surface is destroyed.
+         * GL resources should not be explicitly released here, as the GL context
+         * is already gone at this point.
+         */
+        virtual void onSurfaceDestroyed() { }
+    };
+
+}
+
+#endif
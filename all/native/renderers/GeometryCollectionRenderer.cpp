@@ -59,40 +59,13 @@ namespace carto {
 
         glDisable(GL_CULL_FACE);
 
+        // Draw the collections in three type-grouped passes, merging the members of all
+        // the collections into shared polygon/line/point batches. Interleaving the types
+        // per collection would force a batch flush on every type switch, making mixed
+        // collections much more expensive to draw than flat geometry.
         for (const std::shared_ptr<GeometryCollection>& element : _elements) {
             for (const std::shared_ptr<VectorElementDrawData>& drawData : element->getDrawData()->getDrawDatas()) {
-                if (std::shared_ptr<PointDrawData> pointDrawData = std::dynamic_pointer_cast<PointDrawData>(drawData)) {
-                    if (!_lineRenderer.isEmptyBatch()) {
-                        _lineRenderer.drawBatch(styleCache, viewState);
-                        _lineRenderer.unbind();
-                    } else if (!_polygonRenderer.isEmptyBatch()) {
-                        _polygonRenderer.drawBatch(styleCache, viewState);
-                        _polygonRenderer.unbind();
-                    }
-                    if (_pointRenderer.isEmptyBatch()) {
-                        _pointRenderer.bind(viewState);
-                    }
-                    _pointRenderer.addToBatch(pointDrawData, styleCache, viewState);
-                } else if (std::shared_ptr<LineDrawData> lineDrawData = std::dynamic_pointer_cast<LineDrawData>(drawData)) {
-                    if (!_pointRenderer.isEmptyBatch()) {
-                        _pointRenderer.drawBatch(styleCache, viewState);
-                        _pointRenderer.unbind();
-                    } else if (!_polygonRenderer.isEmptyBatch()) {
-                        _polygonRenderer.drawBatch(styleCache, viewState);
-                        _polygonRenderer.unbind();
-                    }
-                    if (_lineRenderer.isEmptyBatch()) {
-                        _lineRenderer.bind(viewState);
-                    }
-                    _lineRenderer.addToBatch(lineDrawData, styleCache, viewState);
-                } else if (std::shared_ptr<PolygonDrawData> polygonDrawData = std::dynamic_pointer_cast<PolygonDrawData>(drawData)) {
-                    if (!_pointRenderer.isEmptyBatch()) {
-                        _pointRenderer.drawBatch(styleCache, viewState);
-                        _pointRenderer.unbind();
-                    } else if (!_lineRenderer.isEmptyBatch()) {
-                        _lineRenderer.drawBatch(styleCache, viewState);
-                        _lineRenderer.unbind();
-                    }
+                if (std::shared_ptr<PolygonDrawData> polygonDrawData = std::dynamic_pointer_cast<PolygonDrawData>(drawData)) {
                     if (_polygonRenderer.isEmptyBatch()) {
                         _polygonRenderer.bind(viewState);
                     }
@@ -100,20 +73,41 @@ namespace carto {
                 }
             }
         }
+        if (!_polygonRenderer.isEmptyBatch()) {
+            _polygonRenderer.drawBatch(styleCache, viewState);
+            _polygonRenderer.unbind();
+        }
 
-        if (!_pointRenderer._drawDataBuffer.empty()) {
-            _pointRenderer.drawBatch(styleCache, viewState);
-            _pointRenderer.unbind();
+        for (const std::shared_ptr<GeometryCollection>& element : _elements) {
+            for (const std::shared_ptr<VectorElementDrawData>& drawData : element->getDrawData()->getDrawDatas()) {
+                if (std::shared_ptr<LineDrawData> lineDrawData = std::dynamic_pointer_cast<LineDrawData>(drawData)) {
+                    if (_lineRenderer.isEmptyBatch()) {
+                        _lineRenderer.bind(viewState);
+                    }
+                    _lineRenderer.addToBatch(lineDrawData, styleCache, viewState);
+                }
+            }
         }
-        if (!_lineRenderer._drawDataBuffer.empty()) {
+        if (!_lineRenderer.isEmptyBatch()) {
             _lineRenderer.drawBatch(styleCache, viewState);
             _lineRenderer.unbind();
         }
-        if (!_polygonRenderer._drawDataBuffer.empty()) {
-            _polygonRenderer.drawBatch(styleCache, viewState);
-            _polygonRenderer.unbind();
+
+        for (const std::shared_ptr<GeometryCollection>& element : _elements) {
+            for (const std::shared_ptr<VectorElementDrawData>& drawData : element->getDrawData()->getDrawDatas()) {
+                if (std::shared_ptr<PointDrawData> pointDrawData = std::dynamic_pointer_cast<PointDrawData>(drawData)) {
+                    if (_pointRenderer.isEmptyBatch()) {
+                        _pointRenderer.bind(viewState);
+                    }
+                    _pointRenderer.addToBatch(pointDrawData, styleCache, viewState);
+                }
+            }
         }
-        
+        if (!_pointRenderer.isEmptyBatch()) {
+            _pointRenderer.drawBatch(styleCache, viewState);
+            _pointRenderer.unbind();
+        }
+
         glEnable(GL_CULL_FACE);
     }
 
@@ -149,6 +143,12 @@ namespace carto {
         _elements.erase(std::remove(_elements.begin(), _elements.end(), element), _elements.end());
     }
 
+    void GeometryCollectionRenderer::trimBuffers() {
+        _pointRenderer.trimBuffers();
+        _lineRenderer.trimBuffers();
+        _polygonRenderer.trimBuffers();
+    }
+
     void GeometryCollectionRenderer::calculateRayIntersectedElements(const std::shared_ptr<VectorLayer>& layer, const cglib::ray3<double>& ray, const ViewState& viewState, std::vector<RayIntersectedElement>& results) const {
         std::lock_guard<std::mutex> lock(_mutex);
 
@@ -44,6 +44,8 @@ namespace carto {
 
         void calculateRayIntersectedElements(const std::shared_ptr<VectorLayer>& layer, const cglib::ray3<double>& ray, const ViewState& viewState, std::vector<RayIntersectedElement>& results) const;
 
+        void trimBuffers();
+
     private:
         std::vector<std::shared_ptr<GeometryCollection> > _elements;
         std::vector<std::shared_ptr<GeometryCollection> > _tempElements;
@@ -139,6 +139,17 @@ namespace carto {
         _elements.erase(std::remove(_elements.begin(), _elements.end(), element), _elements.end());
     }
     
+    void LineRenderer::trimBuffers() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        // Release the CPU-side vertex buffers. They are grown back to their
+        // steady-state sizes during the next frame.
+        std::vector<unsigned char>().swap(_colorBuf);
+        std::vector<float>().swap(_coordBuf);
+        std::vector<float>().swap(_normalBuf);
+        std::vector<float>().swap(_texCoordBuf);
+        std::vector<unsigned short>().swap(_indexBuf);
+    }
+
     void LineRenderer::calculateRayIntersectedElements(const std::shared_ptr<VectorLayer>& layer, const cglib::ray3<double>& ray, const ViewState& viewState, std::vector<RayIntersectedElement>& results) const {
         std::lock_guard<std::mutex> lock(_mutex);
     
@@ -178,16 +189,11 @@ namespace carto {
         }
         
         // Resize the buffers, if necessary
-        if (coordBuf.size() < totalCoordCount * 3) {
-            colorBuf.resize(std::min(totalCoordCount * 4, GLContext::MAX_VERTEXBUFFER_SIZE * 4));
-            coordBuf.resize(std::min(totalCoordCount * 3, GLContext::MAX_VERTEXBUFFER_SIZE * 3));
-            normalBuf.resize(std::min(totalCoordCount * 4, GLContext::MAX_VERTEXBUFFER_SIZE * 4));
-            texCoordBuf.resize(std::min(totalCoordCount * 2, GLContext::MAX_VERTEXBUFFER_SIZE * 2));
-        }
-        
-        if (indexBuf.size() < totalIndexCount) {
-            indexBuf.resize(std::min(totalIndexCount, GLContext::MAX_VERTEXBUFFER_SIZE));
-        }
+        GLContext::ResizeVertexBuffer(colorBuf, totalCoordCount * 4, GLContext::MAX_VERTEXBUFFER_SIZE * 4);
+        GLContext::ResizeVertexBuffer(coordBuf, totalCoordCount * 3, GLContext::MAX_VERTEXBUFFER_SIZE * 3);
+        GLContext::ResizeVertexBuffer(normalBuf, totalCoordCount * 4, GLContext::MAX_VERTEXBUFFER_SIZE * 4);
+        GLContext::ResizeVertexBuffer(texCoordBuf, totalCoordCount * 2, GLContext::MAX_VERTEXBUFFER_SIZE * 2);
+        GLContext::ResizeVertexBuffer(indexBuf, totalIndexCount, GLContext::MAX_VERTEXBUFFER_SIZE);
         
         // Calculate and draw buffers
         cglib::vec3<double> cameraPos = viewState.getCameraPos();
@@ -241,7 +247,8 @@ namespace carto {
                     );
                     normalScale = 0.5f;
                 }
-                const std::vector<cglib::vec3<double>*>& coords = drawData->getCoords()[i];
+                cglib::vec3<float> translate = cglib::vec3<float>::convert(drawData->getOrigins()[i] - cameraPos);
+                const std::vector<cglib::vec3<float> >& coords = drawData->getRelativeCoords()[i];
                 const std::vector<cglib::vec4<float> >& normals = drawData->getNormals()[i];
                 const std::vector<cglib::vec2<float> >& texCoords = drawData->getTexCoords()[i];
                 auto cit = coords.begin();
@@ -256,10 +263,10 @@ namespace carto {
                     colorIndex += 4;
 
                     // Coords
-                    const cglib::vec3<double>& pos = **cit;
-                    coordBuf[coordIndex + 0] = static_cast<float>(pos(0) - cameraPos(0));
-                    coordBuf[coordIndex + 1] = static_cast<float>(pos(1) - cameraPos(1));
-                    coordBuf[coordIndex + 2] = static_cast<float>(pos(2) - cameraPos(2));
+                    const cglib::vec3<float>& pos = *cit;
+                    coordBuf[coordIndex + 0] = pos(0) + translate(0);
+                    coordBuf[coordIndex + 1] = pos(1) + translate(1);
+                    coordBuf[coordIndex + 2] = pos(2) + translate(2);
                     coordIndex += 3;
 
                     // Normals
@@ -403,7 +410,7 @@ namespace carto {
 
         // Bind texture
         const std::shared_ptr<Bitmap>& bitmap = _lineDrawDataBuffer.front()->getBitmap();
-        std::shared_ptr<Texture> texture = styleCache.get(bitmap);
+        std::shared_ptr<Texture> texture = styleCache.get(bitmap, true, true);
         if (!texture) {
             texture = styleCache.create(bitmap, true, true);
         }
@@ -46,7 +46,9 @@ namespace carto {
         void removeElement(const std::shared_ptr<Line>& element);
     
         void calculateRayIntersectedElements(const std::shared_ptr<VectorLayer>& layer, const cglib::ray3<double>& ray, const ViewState& viewState, std::vector<RayIntersectedElement>& results) const;
-    
+
+        void trimBuffers();
+
     protected:
         friend class PolygonRenderer;
         friend class GeometryCollectionRenderer;
@@ -1,12 +1,13 @@
 #include "MapRenderer.h"
+#include "components/ClassRegistry.h"
 #include "components/Exceptions.h"
 #include "components/Layers.h"
 #include "components/ThreadWorker.h"
 #include "core/MapPos.h"
+#include "core/Variant.h"
 #include "core/ScreenPos.h"
 #include "core/ScreenBounds.h"
 #include "drawdatas/BillboardDrawData.h"
-#include "graphics/Bitmap.h"
 #include "graphics/FrameBuffer.h"
 #include "graphics/Shader.h"
 #include "graphics/Texture.h"
@@ -18,6 +19,7 @@
 #include "projections/Projection.h"
 #include "projections/ProjectionSurface.h"
 #include "renderers/BillboardRenderer.h"
+#include "renderers/CustomRenderPass.h"
 #include "renderers/MapRendererListener.h"
 #include "renderers/RendererCaptureListener.h"
 #include "renderers/RedrawRequestListener.h"
@@ -28,17 +30,26 @@
 #include "renderers/cameraevents/CameraZoomEvent.h"
 #include "renderers/workers/BillboardPlacementWorker.h"
 #include "renderers/workers/CullWorker.h"
+#include "renderers/workers/RendererCaptureWorker.h"
 #include "utils/Const.h"
 #include "utils/Log.h"
 #include "utils/ThreadUtils.h"
 
 #include <algorithm>
+#include <set>
 
 namespace carto {
 
     MapRenderer::MapRenderer(const std::shared_ptr<Layers>& layers, const std::shared_ptr<Options>& options) :
         _lastFrameTime(),
+        _lastFrameRenderTime(0),
+        _deferredDeltaSeconds(0),
+        _lastFrameDeferred(false),
+        _overBudgetSeconds(0),
+        _underBudgetSeconds(0),
+        _reducedQuality(false),
         _viewState(),
+        _viewStateSnapshot(),
         _frameBufferManager(),
         _shaderManager(),
         _textureManager(),
@@ -49,25 +60,40 @@ namespace carto {
         _currentBoundFBOs(),
         _screenFrameBuffer(),
         _screenBlendShader(),
+        _layersFrameBuffer(),
+        _layersFrameBufferLayers(),
+        _layersFrameBufferCameraGeneration(0),
+        _layersFrameBufferValid(false),
+        _sortedBillboardsCameraGeneration(0),
+        _sortedBillboardsValid(false),
         _backgroundRenderer(*options, *layers),
         _watermarkRenderer(*options),
         _billboardSorter(),
         _billboardDrawDataBuffer(),
         _billboardPlacementWorker(std::make_shared<BillboardPlacementWorker>()),
         _billboardPlacementThread(),
+        _rendererCaptureWorker(std::make_shared<RendererCaptureWorker>()),
+        _rendererCaptureThread(),
         _animationHandler(*this),
         _kineticEventHandler(*this, *options),
+        _frameProfiler(),
         _layers(layers),
         _options(options),
         _surfaceCreated(false),
         _surfaceChanged(false),
         _billboardsChanged(false),
+        _layersFrameBufferInvalidated(true),
         _renderProjectionChanged(false),
+        _renderProjectionChangeTime(),
         _redrawPending(false),
+        _warmUpPending(false),
+        _skippedFrameCount(0),
         _redrawRequestListener(),
         _mapRendererListener(),
         _rendererCaptureListeners(),
         _rendererCaptureListenersMutex(),
+        _customRenderPasses(),
+        _customRenderPassesMutex(),
         _onChangeListeners(),
         _onChangeListenersMutex(),
         _renderThreadCallbacks(),
@@ -85,7 +111,10 @@ namespace carto {
 
         _billboardPlacementWorker->setComponents(shared_from_this(), _billboardPlacementWorker);
         _billboardPlacementThread = std::thread(std::ref(*_billboardPlacementWorker));
-        
+
+        _rendererCaptureWorker->setComponents(shared_from_this(), _rendererCaptureWorker);
+        _rendererCaptureThread = std::thread(std::ref(*_rendererCaptureWorker));
+
         _optionsListener = std::make_shared<OptionsListener>(shared_from_this());
         _options->registerOnChangeListener(_optionsListener);
     }
@@ -99,6 +128,9 @@ namespace carto {
         
         _billboardPlacementWorker->stop();
         _billboardPlacementThread.detach();
+
+        _rendererCaptureWorker->stop();
+        _rendererCaptureThread.detach();
     }
         
     std::shared_ptr<RedrawRequestListener> MapRenderer::getRedrawRequestListener() const {
@@ -118,6 +150,12 @@ namespace carto {
     }
 
     ViewState MapRenderer::getViewState() const {
+        // Use the published frame snapshot, if available. This avoids contention
+        // with the GL thread which may hold the renderer mutex for a full frame.
+        if (std::shared_ptr<const ViewState> viewStateSnapshot = std::atomic_load(&_viewStateSnapshot)) {
+            return *viewStateSnapshot;
+        }
+
         std::lock_guard<std::recursive_mutex> lock(_mutex);
         ViewState viewState = _viewState;
         viewState.calculateViewState(*_options);
@@ -125,6 +163,12 @@ namespace carto {
     }
 
     std::shared_ptr<ProjectionSurface> MapRenderer::getProjectionSurface() const {
+        if (std::shared_ptr<const ViewState> viewStateSnapshot = std::atomic_load(&_viewStateSnapshot)) {
+            if (std::shared_ptr<ProjectionSurface> projectionSurface = viewStateSnapshot->getProjectionSurface()) {
+                return projectionSurface;
+            }
+        }
+
         std::lock_guard<std::recursive_mutex> lock(_mutex);
         std::shared_ptr<ProjectionSurface> projectionSurface = _viewState.getProjectionSurface();
         if (!projectionSurface) {
@@ -134,14 +178,89 @@ namespace carto {
     }
         
     void MapRenderer::requestRedraw() const {
+        requestRedraw(true);
+    }
+
+    void MapRenderer::requestRedraw(bool invalidateLayersFrameBuffer) const {
+        // Assume the redraw was requested because some layer contents changed,
+        // unless the caller explicitly states that only billboards need redrawing
+        if (invalidateLayersFrameBuffer) {
+            _layersFrameBufferInvalidated = true;
+        }
+
         DirectorPtr<RedrawRequestListener> redrawRequestListener = _redrawRequestListener;
 
         if (redrawRequestListener) {
-            _redrawPending = true;
+            // If a frame is already pending, the request is coalesced with it. The pending
+            // frame has not started rendering yet, so it will pick up the latest state.
+            if (_redrawPending.exchange(true)) {
+                _skippedFrameCount++;
+                return;
+            }
             redrawRequestListener->onRedrawRequested();
         }
     }
-    
+
+    int MapRenderer::getSkippedFrameCount() const {
+        return _skippedFrameCount.load();
+    }
+
+    void MapRenderer::warmUp() {
+        _warmUpPending = true;
+        requestRedraw();
+    }
+
+    void MapRenderer::onMemoryWarning() {
+        for (const std::shared_ptr<Layer>& layer : _layers->getAll()) {
+            layer->onMemoryWarning();
+        }
+
+        {
+            std::lock_guard<std::recursive_mutex> lock(_mutex);
+            if (_styleCache) {
+                _styleCache->clear();
+            }
+            if (_textureManager) {
+                _textureManager->clearTexturePool();
+            }
+        }
+
+        requestRedraw(); // the queued GL resource deletions are flushed at the beginning of the next frame
+    }
+
+    bool MapRenderer::isFrameProfilingEnabled() const {
+        return _frameProfiler.isEnabled();
+    }
+
+    void MapRenderer::setFrameProfilingEnabled(bool enabled) {
+        _frameProfiler.setEnabled(enabled);
+    }
+
+    std::string MapRenderer::getFrameProfilingTrace() const {
+        return _frameProfiler.exportTrace();
+    }
+
+    Variant MapRenderer::getLayerRenderStatistics() const {
+        std::vector<std::shared_ptr<Layer> > layers = _layers->getAll();
+
+        picojson::array layerStats;
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        for (std::size_t i = 0; i < layers.size(); i++) {
+            auto it = _layerRenderStatsMap.find(layers[i]);
+            if (it == _layerRenderStatsMap.end()) {
+                continue;
+            }
+            picojson::object stats;
+            stats["layerIndex"] = picojson::value(static_cast<std::int64_t>(i));
+            stats["layerType"] = picojson::value(ClassRegistry::GetClassName(typeid(*layers[i])));
+            stats["drawTime"] = picojson::value(static_cast<double>(it->second.drawTime));
+            stats["draw3DTime"] = picojson::value(static_cast<double>(it->second.draw3DTime));
+            stats["billboardTime"] = picojson::value(static_cast<double>(it->second.billboardTime));
+            layerStats.push_back(picojson::value(stats));
+        }
+        return Variant::FromPicoJSON(picojson::value(layerStats));
+    }
+
     void MapRenderer::captureRendering(const std::shared_ptr<RendererCaptureListener>& listener, bool waitWhileUpdating) {
         if (!listener) {
             throw NullArgumentException("Null listener");
@@ -154,6 +273,39 @@ namespace carto {
         requestRedraw();
     }
 
+    void MapRenderer::registerCustomRenderPass(const std::shared_ptr<CustomRenderPass>& renderPass, CustomRenderPassSlot::CustomRenderPassSlot slot) {
+        if (!renderPass) {
+            throw NullArgumentException("Null renderPass");
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_customRenderPassesMutex);
+            for (auto it = _customRenderPasses.begin(); it != _customRenderPasses.end(); ) {
+                if (it->first.get() == renderPass) {
+                    it = _customRenderPasses.erase(it);
+                } else {
+                    it++;
+                }
+            }
+            _customRenderPasses.push_back(std::make_pair(DirectorPtr<CustomRenderPass>(renderPass), slot));
+        }
+        requestRedraw();
+    }
+
+    void MapRenderer::unregisterCustomRenderPass(const std::shared_ptr<CustomRenderPass>& renderPass) {
+        {
+            std::lock_guard<std::mutex> lock(_customRenderPassesMutex);
+            for (auto it = _customRenderPasses.begin(); it != _customRenderPasses.end(); ) {
+                if (it->first.get() == renderPass) {
+                    it = _customRenderPasses.erase(it);
+                } else {
+                    it++;
+                }
+            }
+        }
+        requestRedraw();
+    }
+
     std::vector<std::shared_ptr<BillboardDrawData> > MapRenderer::getBillboardDrawDatas() const {
         std::lock_guard<std::recursive_mutex> lock(_mutex);
         return _billboardSorter.getSortedBillboardDrawDatas();
@@ -166,6 +318,10 @@ namespace carto {
     KineticEventHandler& MapRenderer::getKineticEventHandler() {
         return _kineticEventHandler;
     }
+
+    FrameProfiler& MapRenderer::getFrameProfiler() {
+        return _frameProfiler;
+    }
     
     void MapRenderer::calculateCameraEvent(CameraPanEvent& cameraEvent, float durationSeconds, bool updateKinetic) {
         if (durationSeconds > 0) {
@@ -312,6 +468,29 @@ namespace carto {
         }
     }
     
+    void MapRenderer::calculateCameraEvents(CameraPanEvent* panEvent, CameraRotationEvent* rotationEvent, CameraTiltEvent* tiltEvent, CameraZoomEvent* zoomEvent) {
+        {
+            std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+            // Calculate the combined focusPos, cameraPos and upVec based on all the given events
+            if (panEvent) {
+                panEvent->calculate(*_options, _viewState);
+            }
+            if (rotationEvent) {
+                rotationEvent->calculate(*_options, _viewState);
+            }
+            if (tiltEvent) {
+                tiltEvent->calculate(*_options, _viewState);
+            }
+            if (zoomEvent) {
+                zoomEvent->calculate(*_options, _viewState);
+            }
+        }
+
+        // Delay updating the layers, because view state will be updated only after onDrawFrame is called
+        viewChanged(true);
+    }
+
     void MapRenderer::moveToFitBounds(const MapBounds& mapBounds, const ScreenBounds& screenBounds, bool integerZoom, bool resetTilt, bool resetRotation, float durationSeconds) {
         CameraPanEvent cameraPanEvent;
         CameraRotationEvent cameraRotationEvent;
@@ -495,6 +674,13 @@ namespace carto {
         _screenFrameBuffer.reset();
         _screenBlendShader.reset();
 
+        // Reset cached layers frame buffer
+        _layersFrameBuffer.reset();
+        _layersFrameBufferLayers.clear();
+        _layersFrameBufferValid = false;
+        _sortedBillboardsValid = false;
+        _compositingGroups.clear();
+
         // Drop all thread callbacks, as context is invalidated
         {
             std::lock_guard<std::mutex> lock(_renderThreadCallbacksMutex);
@@ -508,7 +694,16 @@ namespace carto {
         for (const std::shared_ptr<Layer>& layer : _layers->getAll()) {
             layer->onSurfaceCreated(_shaderManager, _textureManager);
         }
-        
+
+        std::vector<std::pair<DirectorPtr<CustomRenderPass>, CustomRenderPassSlot::CustomRenderPassSlot> > customRenderPasses;
+        {
+            std::lock_guard<std::mutex> lock(_customRenderPassesMutex);
+            customRenderPasses = _customRenderPasses;
+        }
+        for (const auto& renderPass : customRenderPasses) {
+            renderPass.first->onSurfaceCreated();
+        }
+
         GLContext::CheckGLError("MapRenderer::onSurfaceCreated");
     }
     
@@ -519,12 +714,19 @@ namespace carto {
         _viewState.clampZoom(*_options);
         _viewState.clampFocusPos(*_options);
         _screenFrameBuffer.reset(); // reset, as this depends on the surface dimensions
+        _layersFrameBuffer.reset();
+        _layersFrameBufferValid = false;
+        _sortedBillboardsValid = false;
+        _compositingGroups.clear();
         _surfaceChanged = true;
+        std::atomic_store(&_viewStateSnapshot, std::make_shared<const ViewState>(_viewState));
     }
     
     void MapRenderer::onDrawFrame() {
         _redrawPending = false;
 
+        _frameProfiler.startFrame();
+
         std::vector<std::shared_ptr<OnChangeListener> > onChangeListeners;
         {
             std::lock_guard<std::mutex> lock(_onChangeListenersMutex);
@@ -538,10 +740,20 @@ namespace carto {
         _shaderManager->setGLThreadId(std::this_thread::get_id());
         _textureManager->setGLThreadId(std::this_thread::get_id());
 
+        // Eagerly create lazily-initialized resources before the map becomes visible
+        if (_warmUpPending.exchange(false)) {
+            handleWarmUp();
+        }
+
         // Create pending textures and shaders
         _frameBufferManager->processFrameBuffers();
         _shaderManager->processShaders();
-        _textureManager->processTextures();
+        if (_textureManager->processTextures()) {
+            // Texture uploads are throttled, finish the queue during the next frames
+            requestRedraw();
+        }
+
+        _frameProfiler.markStage(FrameProfiler::STAGE_RESOURCES);
 
         {
             std::lock_guard<std::recursive_mutex> lock(_mutex);
@@ -569,43 +781,105 @@ namespace carto {
             mapRendererListener->onBeforeDrawFrame();
         }
         
-        // Calculate camera params and make a synchronized copy of the view state
+        // Calculate camera params and make a synchronized copy of the view state.
+        // While a render projection switch is pending, keep the old projection surface,
+        // drawLayers will adopt the new surface once the layers are ready.
         ViewState viewState;
         {
             std::lock_guard<std::recursive_mutex> lock(_mutex);
-            _viewState.calculateViewState(*_options);
+            if (!_renderProjectionChanged) {
+                _viewState.calculateViewState(*_options);
+            }
             viewState = _viewState;
             _viewState.setHorizontalLayerOffsetDir(0);
         }
 
+        // Publish the frame snapshot, worker threads can read it without locking
+        std::atomic_store(&_viewStateSnapshot, std::make_shared<const ViewState>(viewState));
+
         // Don't delay calling the cull task, the view state was already updated
         if (_surfaceChanged.exchange(false)) {
             viewChanged(false);
         }
-        
-        // Calculate map moving animations and kinetic events
-        _animationHandler.calculate(viewState, deltaSeconds);
-        _kineticEventHandler.calculate(viewState, deltaSeconds);
+
+        _frameProfiler.markStage(FrameProfiler::STAGE_VIEW_STATE);
+
+
+        // Frame budget governor: if the last frame exceeded the target budget, defer
+        // non-essential stages to the next frame. Never defer two frames in a row.
+        bool deferNonEssential = false;
+        float targetFrameTime = _options->getTargetFrameTime();
+        if (targetFrameTime > 0 && _lastFrameRenderTime > targetFrameTime && !_lastFrameDeferred) {
+            deferNonEssential = true;
+        }
+        _lastFrameDeferred = deferNonEssential;
+
+        // Calculate map moving animations and kinetic events. When over the frame budget,
+        // the interpolation step is skipped and the elapsed time is carried over to the next frame.
+        if (deferNonEssential) {
+            _deferredDeltaSeconds += deltaSeconds;
+            requestRedraw();
+        } else {
+            _animationHandler.calculate(viewState, deltaSeconds + _deferredDeltaSeconds);
+            _kineticEventHandler.calculate(viewState, deltaSeconds + _deferredDeltaSeconds);
+            _deferredDeltaSeconds = 0;
+        }
+
+        _frameProfiler.markStage(FrameProfiler::STAGE_ANIMATION);
 
         initializeRenderState();
-    
+
+        std::chrono::steady_clock::time_point renderStartTime = std::chrono::steady_clock::now();
         _backgroundRenderer.onDrawFrame(viewState);
+        runCustomRenderPasses(CustomRenderPassSlot::CUSTOM_RENDER_PASS_SLOT_BACKGROUND);
+        _frameProfiler.markStage(FrameProfiler::STAGE_BACKGROUND);
         drawLayers(deltaSeconds, viewState);
+        runCustomRenderPasses(CustomRenderPassSlot::CUSTOM_RENDER_PASS_SLOT_LAYERS);
+        _frameProfiler.markStage(FrameProfiler::STAGE_LAYERS);
         _watermarkRenderer.onDrawFrame(viewState);
-    
+        runCustomRenderPasses(CustomRenderPassSlot::CUSTOM_RENDER_PASS_SLOT_OVERLAY);
+        _frameProfiler.markStage(FrameProfiler::STAGE_WATERMARK);
+        _lastFrameRenderTime = std::chrono::duration_cast<std::chrono::duration<float> >(std::chrono::steady_clock::now() - renderStartTime).count();
+
+        // Adaptive quality governor: under sustained over-budget frames (thermal throttling,
+        // background load) ask the layers to reduce their tile detail instead of letting every
+        // frame degrade uniformly. Restore the full detail once enough headroom returns.
+        if (targetFrameTime > 0 && _options->isAdaptiveTileQuality()) {
+            if (_lastFrameRenderTime > targetFrameTime) {
+                _overBudgetSeconds += deltaSeconds;
+                _underBudgetSeconds = 0;
+            } else if (_lastFrameRenderTime < targetFrameTime * ADAPTIVE_QUALITY_RESTORE_HEADROOM) {
+                _underBudgetSeconds += deltaSeconds;
+                _overBudgetSeconds = 0;
+            }
+            if (!_reducedQuality && _overBudgetSeconds >= ADAPTIVE_QUALITY_REDUCE_DELAY) {
+                setLayersReducedQuality(true);
+            } else if (_reducedQuality && _underBudgetSeconds >= ADAPTIVE_QUALITY_RESTORE_DELAY) {
+                setLayersReducedQuality(false);
+            }
+        } else if (_reducedQuality) {
+            setLayersReducedQuality(false);
+        }
+
         // Callback for synchronized rendering
         if (mapRendererListener) {
             mapRendererListener->onAfterDrawFrame();
         }
 
-        // Update billboard placements/visibility
-        if (_billboardsChanged.exchange(false)) {
-            _billboardPlacementWorker->init(BILLBOARD_PLACEMENT_TASK_DELAY);
+        // Update billboard placements/visibility, re-placement is deferred when over the frame budget
+        if (_billboardsChanged.load()) {
+            if (deferNonEssential) {
+                requestRedraw(false);
+            } else if (_billboardsChanged.exchange(false)) {
+                _billboardPlacementWorker->init(BILLBOARD_PLACEMENT_TASK_DELAY);
+            }
         }
         
         handleRenderThreadCallbacks();
         handleRendererCaptureCallbacks();
-        
+
+        _frameProfiler.markStage(FrameProfiler::STAGE_CALLBACKS);
+
         // Call listener to inform we are idle now, if no redraw request is pending
         if (!_redrawPending) {
             for (const std::shared_ptr<OnChangeListener>& onChangeListener : onChangeListeners) {
@@ -613,6 +887,8 @@ namespace carto {
             }
         }
 
+        _frameProfiler.endFrame();
+
         GLContext::CheckGLError("MapRenderer::onDrawFrame");
     }
     
@@ -646,11 +922,27 @@ namespace carto {
         _screenFrameBuffer.reset();
         _screenBlendShader.reset();
 
+        // Reset cached layers frame buffer
+        _layersFrameBuffer.reset();
+        _layersFrameBufferLayers.clear();
+        _layersFrameBufferValid = false;
+        _sortedBillboardsValid = false;
+        _compositingGroups.clear();
+
         // Clean up all opengl resources
+        std::vector<std::pair<DirectorPtr<CustomRenderPass>, CustomRenderPassSlot::CustomRenderPassSlot> > customRenderPasses;
+        {
+            std::lock_guard<std::mutex> lock(_customRenderPassesMutex);
+            customRenderPasses = _customRenderPasses;
+        }
+        for (const auto& renderPass : customRenderPasses) {
+            renderPass.first->onSurfaceDestroyed();
+        }
+
         for (const std::shared_ptr<Layer>& layer : _layers->getAll()) {
             layer->onSurfaceDestroyed();
         }
-        
+
         _watermarkRenderer.onSurfaceDestroyed();
         _backgroundRenderer.onSurfaceDestroyed();
 
@@ -769,6 +1061,7 @@ namespace carto {
      
     void MapRenderer::billboardsChanged() {
         _billboardsChanged = true;
+        requestRedraw(false); // billboards are drawn on top of the cached layers frame buffer, no need to invalidate it
     }
         
     void MapRenderer::layerChanged(const std::shared_ptr<Layer>& layer, bool delay) {
@@ -850,43 +1143,225 @@ namespace carto {
     
     void MapRenderer::drawLayers(float deltaSeconds, const ViewState& viewState) {
         bool needRedraw = false;
+        bool layersFrameBufferUsed = false;
         {
             std::vector<std::shared_ptr<Layer> > layers = _layers->getAll();
 
-            // Reset surfaces if renderprojection has changed
-            bool resetSurfaces = _renderProjectionChanged.exchange(false);
+            // Reset surfaces if renderprojection has changed. The switch is deferred until the
+            // cull worker and the layers have rebuilt their draw data for the new projection
+            // surface, so the old surface keeps rendering instead of a blank or half-built map.
+            // A timeout guards against layers that never become idle (continuous updates).
+            bool resetSurfaces = false;
+            if (_renderProjectionChanged) {
+                bool layersReady = _cullWorker->isIdle();
+                for (std::size_t i = 0; layersReady && i < layers.size(); i++) {
+                    layersReady = !layers[i]->isUpdateInProgress();
+                }
+                std::chrono::steady_clock::time_point changeTime;
+                {
+                    std::lock_guard<std::recursive_mutex> lock(_mutex);
+                    changeTime = _renderProjectionChangeTime;
+                }
+                if (layersReady || std::chrono::steady_clock::now() - changeTime > std::chrono::milliseconds(RENDER_PROJECTION_SWITCH_TIMEOUT)) {
+                    resetSurfaces = _renderProjectionChanged.exchange(false);
+                    std::lock_guard<std::recursive_mutex> lock(_mutex);
+                    _viewState.calculateViewState(*_options);
+                    _viewState.clampZoom(*_options);
+                    _viewState.clampFocusPos(*_options);
+                } else {
+                    needRedraw = true;
+                }
+            }
 
             // BillboardSorter modifications must be synchronized
             std::lock_guard<std::recursive_mutex> lock(_mutex);
-            
-            // Clear billboard before sorting
-            _billboardSorter.clear();
 
-            // Do base drawing pass
-            for (const std::shared_ptr<Layer>& layer : layers) {
-                if (viewState.getHorizontalLayerOffsetDir() != 0) {
-                    layer->offsetLayerHorizontally(viewState.getHorizontalLayerOffsetDir() * Const::WORLD_SIZE);
+            // Per-layer CPU times of the drawing passes of this frame, folded into the
+            // smoothed statistics once all the passes are done
+            std::map<const Layer*, LayerRenderStats> frameStats;
+
+            // The layers frame buffer holds the base and 3D drawing passes of the last frame.
+            // While the camera stays put and the layer contents do not change, it can be composited
+            // directly, so billboard-only updates do not have to repaint the other layers.
+            layersFrameBufferUsed = _layersFrameBufferValid
+                && !resetSurfaces
+                && !_layersFrameBufferInvalidated.load()
+                && _layersFrameBuffer
+                && _layersFrameBufferCameraGeneration == viewState.getCameraGeneration()
+                && _layersFrameBufferLayers == layers
+                && viewState.getHorizontalLayerOffsetDir() == 0;
+
+            // When additionally the billboards are unchanged since the last frame, the previous
+            // sorted billboard list is replayed as-is, skipping both the per-layer billboard
+            // collection and the distance sort. A fully static frame thus reduces to two composites.
+            bool billboardsReused = layersFrameBufferUsed
+                && _sortedBillboardsValid
+                && _sortedBillboardsCameraGeneration == viewState.getCameraGeneration()
+                && !_billboardsChanged.load();
+
+            bool captureLayers = false;
+            if (layersFrameBufferUsed) {
+                // Collect billboard draw datas, the other passes are composited from the frame buffer
+                if (!billboardsReused) {
+                    _billboardSorter.clear();
+                    for (const std::shared_ptr<Layer>& layer : layers) {
+                        std::chrono::steady_clock::time_point passStartTime = std::chrono::steady_clock::now();
+                        needRedraw = layer->onDrawFrameBillboards(deltaSeconds, _billboardSorter, *_styleCache, viewState) || needRedraw;
+                        frameStats[layer.get()].billboardTime += std::chrono::duration_cast<std::chrono::duration<float> >(std::chrono::steady_clock::now() - passStartTime).count();
+                    }
                 }
-    
-                // Initialize layer renderer if it was added after onSurfaceCreated was called
-                if (!layer->isSurfaceCreated() || resetSurfaces) {
-                    if (layer->isSurfaceCreated()) {
-                        layer->onSurfaceDestroyed();
+            } else {
+                // Clear billboard before sorting
+                _billboardSorter.clear();
+
+                // Capture the drawing passes into the frame buffer once the camera has come to rest.
+                // While the camera is moving, draw directly to avoid the extra compositing step.
+                captureLayers = !resetSurfaces
+                    && _layersFrameBufferCameraGeneration == viewState.getCameraGeneration()
+                    && viewState.getHorizontalLayerOffsetDir() == 0;
+
+                GLint prevBoundFBO = 0;
+                if (captureLayers) {
+                    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prevBoundFBO);
+
+                    if (!_layersFrameBuffer) {
+                        _layersFrameBuffer = _frameBufferManager->createFrameBuffer(_viewState.getWidth(), _viewState.getHeight(), true, true, true);
                     }
-                    layer->onSurfaceCreated(_shaderManager, _textureManager);
-                    layerChanged(layer, false);
+
+                    glBindFramebuffer(GL_FRAMEBUFFER, _layersFrameBuffer->getFBOId());
+
+                    glClearColor(0, 0, 0, 0);
+                    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+                    glDepthMask(GL_TRUE);
+                    glStencilMask(255);
+                    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+                    glDepthMask(GL_FALSE);
+                    glStencilMask(0);
+
+                    _layersFrameBufferInvalidated = false;
                 }
-    
-                needRedraw = layer->onDrawFrame(deltaSeconds, _billboardSorter, *_styleCache, viewState) || needRedraw;
+
+                // Do per-layer maintenance before drawing
+                std::chrono::steady_clock::time_point initStartTime = std::chrono::steady_clock::now();
+                bool initBudgetUsed = false;
+                for (const std::shared_ptr<Layer>& layer : layers) {
+                    if (viewState.getHorizontalLayerOffsetDir() != 0) {
+                        layer->offsetLayerHorizontally(viewState.getHorizontalLayerOffsetDir() * Const::WORLD_SIZE);
+                    }
+
+                    // Initialize layer renderer if it was added after onSurfaceCreated was called.
+                    // The initialization is time-sliced: when several layers are added at once, only
+                    // a bounded amount of work is done per frame and the remaining layers get
+                    // initialized and start rendering during the following frames. Surface resets
+                    // are done synchronously, as the old renderer resources are no longer valid.
+                    if (!layer->isSurfaceCreated() || resetSurfaces) {
+                        if (initBudgetUsed && !resetSurfaces) {
+                            needRedraw = true;
+                            continue;
+                        }
+                        if (layer->isSurfaceCreated()) {
+                            layer->onSurfaceDestroyed();
+                        }
+                        layer->onSurfaceCreated(_shaderManager, _textureManager);
+                        layerChanged(layer, false);
+                        if (std::chrono::steady_clock::now() - initStartTime >= std::chrono::milliseconds(LAYER_INITIALIZATION_FRAME_BUDGET)) {
+                            initBudgetUsed = true;
+                        }
+                    }
+                }
+
+                // Do base drawing pass. Consecutive layers sharing a compositing group are rendered
+                // into a cached per-group frame buffer and composited from it while their contents
+                // stay unchanged, so rarely-changing grouped layers cost a single blit per frame
+                // even when other layers animate.
+                std::set<std::string> activeGroups;
+                for (std::size_t i = 0; i < layers.size(); ) {
+                    std::string group = layers[i]->getCompositingGroup();
+                    std::size_t groupSize = 1;
+                    if (!group.empty()) {
+                        while (i + groupSize < layers.size() && layers[i + groupSize]->getCompositingGroup() == group) {
+                            groupSize++;
+                        }
+                    }
+
+                    if (group.empty() || !captureLayers) {
+                        // Draw directly. Grouped layers are also drawn directly while the camera
+                        // is moving, as the cached group contents could not be reused anyway.
+                        for (std::size_t j = 0; j < groupSize; j++) {
+                            if (!layers[i + j]->isSurfaceCreated()) {
+                                continue; // initialization was deferred to a later frame
+                            }
+                            std::chrono::steady_clock::time_point passStartTime = std::chrono::steady_clock::now();
+                            needRedraw = layers[i + j]->onDrawFrame(deltaSeconds, _billboardSorter, *_styleCache, viewState) || needRedraw;
+                            frameStats[layers[i + j].get()].drawTime += std::chrono::duration_cast<std::chrono::duration<float> >(std::chrono::steady_clock::now() - passStartTime).count();
+                        }
+                    } else {
+                        activeGroups.insert(group);
+                        std::vector<std::shared_ptr<Layer> > groupLayers(layers.begin() + i, layers.begin() + i + groupSize);
+                        needRedraw = drawCompositingGroup(group, groupLayers, deltaSeconds, viewState, frameStats) || needRedraw;
+                    }
+                    i += groupSize;
+                }
+
+                // Drop cached buffers of groups that are no longer present
+                if (captureLayers) {
+                    for (auto it = _compositingGroups.begin(); it != _compositingGroups.end(); ) {
+                        it = (activeGroups.count(it->first) == 0 ? _compositingGroups.erase(it) : ++it);
+                    }
+                }
+
+                // Do 3D drawing pass
+                for (const std::shared_ptr<Layer>& layer : layers) {
+                    if (!layer->isSurfaceCreated()) {
+                        continue; // initialization was deferred to a later frame
+                    }
+                    std::chrono::steady_clock::time_point passStartTime = std::chrono::steady_clock::now();
+                    needRedraw = layer->onDrawFrame3D(deltaSeconds, _billboardSorter, *_styleCache, viewState) || needRedraw;
+                    frameStats[layer.get()].draw3DTime += std::chrono::duration_cast<std::chrono::duration<float> >(std::chrono::steady_clock::now() - passStartTime).count();
+                }
+
+                if (captureLayers) {
+                    _layersFrameBuffer->discard(false, true, true);
+                    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(prevBoundFBO));
+
+                    // The frame buffer can be reused only if no layer animations are pending
+                    // and no layer contents were changed while drawing
+                    _layersFrameBufferLayers = layers;
+                    _layersFrameBufferValid = !needRedraw && !_layersFrameBufferInvalidated.load();
+                } else {
+                    _layersFrameBufferValid = false;
+                }
+                _layersFrameBufferCameraGeneration = viewState.getCameraGeneration();
             }
-            
-            // Do 3D drawing pass
-            for (const std::shared_ptr<Layer>& layer : layers) {
-                needRedraw = layer->onDrawFrame3D(deltaSeconds, _billboardSorter, *_styleCache, viewState) || needRedraw;
+
+            // Composite the frame buffer to the screen
+            if (layersFrameBufferUsed || captureLayers) {
+                blendFrameBuffer(_layersFrameBuffer);
             }
-            
+
             // Sort billboards, calculate rotation state
-            _billboardSorter.sort(viewState);
+            if (!billboardsReused) {
+                _billboardSorter.sort(viewState);
+            }
+
+            // The sorted list stays replayable only if no billboard animations are pending
+            // and no billboard contents were changed while drawing
+            _sortedBillboardsValid = !needRedraw && !_billboardsChanged.load();
+            _sortedBillboardsCameraGeneration = viewState.getCameraGeneration();
+
+            // Fold the measured pass times into the smoothed per-layer statistics and
+            // drop the entries of layers that are no longer attached. Frames composited
+            // from the cached buffers contribute zero times, as the layers cost nothing then.
+            for (auto it = _layerRenderStatsMap.begin(); it != _layerRenderStatsMap.end(); ) {
+                it = (std::find(layers.begin(), layers.end(), it->first) == layers.end() ? _layerRenderStatsMap.erase(it) : ++it);
+            }
+            for (const std::shared_ptr<Layer>& layer : layers) {
+                const LayerRenderStats& frame = frameStats[layer.get()];
+                LayerRenderStats& stats = _layerRenderStatsMap[layer];
+                stats.drawTime += (frame.drawTime - stats.drawTime) * LAYER_RENDER_STATS_SMOOTHING;
+                stats.draw3DTime += (frame.draw3DTime - stats.draw3DTime) * LAYER_RENDER_STATS_SMOOTHING;
+                stats.billboardTime += (frame.billboardTime - stats.billboardTime) * LAYER_RENDER_STATS_SMOOTHING;
+            }
         }
         
         // Draw billboards, grouped by layer renderer
@@ -913,12 +1388,180 @@ namespace carto {
             glEnable(GL_DEPTH_TEST);
         }
     
-        // Redraw, if needed
+        // Redraw, if needed. When the frame was composited from the layers frame buffer,
+        // only billboards requested the redraw and the frame buffer stays valid.
         if (needRedraw) {
-            requestRedraw();
+            requestRedraw(!layersFrameBufferUsed);
+        }
+    }
+
+    bool MapRenderer::drawCompositingGroup(const std::string& group, const std::vector<std::shared_ptr<Layer> >& groupLayers, float deltaSeconds, const ViewState& viewState, std::map<const Layer*, LayerRenderStats>& frameStats) {
+        CompositingGroup& compositingGroup = _compositingGroups[group];
+
+        std::vector<unsigned int> contentGenerations;
+        contentGenerations.reserve(groupLayers.size());
+        for (const std::shared_ptr<Layer>& layer : groupLayers) {
+            contentGenerations.push_back(layer->getContentGeneration());
+        }
+
+        // The cached buffer can be composited only while the member layers, their contents
+        // and the camera stay unchanged since the capture
+        bool needRedraw = false;
+        bool frameBufferUsable = compositingGroup.valid
+            && compositingGroup.frameBuffer
+            && compositingGroup.layers == groupLayers
+            && compositingGroup.contentGenerations == contentGenerations
+            && compositingGroup.cameraGeneration == viewState.getCameraGeneration();
+        if (!frameBufferUsable) {
+            GLint prevBoundFBO = 0;
+            glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prevBoundFBO);
+
+            if (!compositingGroup.frameBuffer) {
+                compositingGroup.frameBuffer = _frameBufferManager->createFrameBuffer(_viewState.getWidth(), _viewState.getHeight(), true, true, true);
+            }
+
+            glBindFramebuffer(GL_FRAMEBUFFER, compositingGroup.frameBuffer->getFBOId());
+
+            glClearColor(0, 0, 0, 0);
+            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+            glDepthMask(GL_TRUE);
+            glStencilMask(255);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+            glDepthMask(GL_FALSE);
+            glStencilMask(0);
+
+            for (const std::shared_ptr<Layer>& layer : groupLayers) {
+                if (!layer->isSurfaceCreated()) {
+                    needRedraw = true; // initialization was deferred, capture the group again once the layer is ready
+                    continue;
+                }
+                std::chrono::steady_clock::time_point passStartTime = std::chrono::steady_clock::now();
+                needRedraw = layer->onDrawFrame(deltaSeconds, _billboardSorter, *_styleCache, viewState) || needRedraw;
+                frameStats[layer.get()].drawTime += std::chrono::duration_cast<std::chrono::duration<float> >(std::chrono::steady_clock::now() - passStartTime).count();
+            }
+
+            compositingGroup.frameBuffer->discard(false, true, true);
+            glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(prevBoundFBO));
+
+            // The buffer can be reused only if no layer animations are pending.
+            // The generations are recorded before drawing, a change during the
+            // capture shows up as a mismatch and forces a recapture.
+            compositingGroup.layers = groupLayers;
+            compositingGroup.contentGenerations = contentGenerations;
+            compositingGroup.cameraGeneration = viewState.getCameraGeneration();
+            compositingGroup.valid = !needRedraw;
+        } else {
+            // Collect billboard draw datas, the base pass is composited from the cached buffer
+            for (const std::shared_ptr<Layer>& layer : groupLayers) {
+                if (!layer->isSurfaceCreated()) {
+                    needRedraw = true;
+                    continue;
+                }
+                std::chrono::steady_clock::time_point passStartTime = std::chrono::steady_clock::now();
+                needRedraw = layer->onDrawFrameBillboards(deltaSeconds, _billboardSorter, *_styleCache, viewState) || needRedraw;
+                frameStats[layer.get()].billboardTime += std::chrono::duration_cast<std::chrono::duration<float> >(std::chrono::steady_clock::now() - passStartTime).count();
+            }
+        }
+
+        blendFrameBuffer(compositingGroup.frameBuffer);
+        return needRedraw;
+    }
+
+    void MapRenderer::blendFrameBuffer(const std::shared_ptr<FrameBuffer>& frameBuffer) {
+        static const GLfloat screenVertices[8] = { -1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f };
+
+        if (!frameBuffer) {
+            return; // should not happen, just safety
+        }
+
+        if (!_screenBlendShader) {
+            static const ShaderSource shaderSource("blend", &BLEND_VERTEX_SHADER, &BLEND_FRAGMENT_SHADER);
+
+            _screenBlendShader = _shaderManager->createShader(shaderSource);
         }
+
+        glUseProgram(_screenBlendShader->getProgId());
+
+        glVertexAttribPointer(_screenBlendShader->getAttribLoc("a_coord"), 2, GL_FLOAT, GL_FALSE, 0, screenVertices);
+        glEnableVertexAttribArray(_screenBlendShader->getAttribLoc("a_coord"));
+
+        cglib::mat4x4<float> mvpMatrix = cglib::mat4x4<float>::identity();
+        glUniformMatrix4fv(_screenBlendShader->getUniformLoc("u_mvpMat"), 1, GL_FALSE, mvpMatrix.data());
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, frameBuffer->getColorTexId());
+        glUniform1i(_screenBlendShader->getUniformLoc("u_tex"), 0);
+        glUniform4f(_screenBlendShader->getUniformLoc("u_color"), 1.0f, 1.0f, 1.0f, 1.0f);
+        glUniform2f(_screenBlendShader->getUniformLoc("u_invScreenSize"), 1.0f / _viewState.getWidth(), 1.0f / _viewState.getHeight());
+
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        glDisableVertexAttribArray(_screenBlendShader->getAttribLoc("a_coord"));
+
+        GLContext::CheckGLError("MapRenderer::blendFrameBuffer");
     }
     
+    void MapRenderer::runCustomRenderPasses(CustomRenderPassSlot::CustomRenderPassSlot slot) {
+        std::vector<DirectorPtr<CustomRenderPass> > renderPasses;
+        {
+            std::lock_guard<std::mutex> lock(_customRenderPassesMutex);
+            for (const auto& renderPass : _customRenderPasses) {
+                if (renderPass.second == slot) {
+                    renderPasses.push_back(renderPass.first);
+                }
+            }
+        }
+        if (renderPasses.empty()) {
+            return;
+        }
+
+        for (const DirectorPtr<CustomRenderPass>& renderPass : renderPasses) {
+            renderPass->onDrawFrame();
+        }
+
+        GLContext::CheckGLError("MapRenderer::runCustomRenderPasses");
+    }
+
+    void MapRenderer::setLayersReducedQuality(bool reduced) {
+        Log::Infof("MapRenderer: %s tile quality of the layers", reduced ? "Reducing" : "Restoring");
+        _reducedQuality = reduced;
+        _overBudgetSeconds = 0;
+        _underBudgetSeconds = 0;
+        for (const std::shared_ptr<Layer>& layer : _layers->getAll()) {
+            layer->setReducedQuality(reduced);
+        }
+    }
+
+    void MapRenderer::handleWarmUp() {
+        // Create the blend shader and the screen frame buffer, both are otherwise created at first use
+        {
+            std::lock_guard<std::recursive_mutex> lock(_mutex);
+            if (!_screenBlendShader) {
+                static const ShaderSource shaderSource("blend", &BLEND_VERTEX_SHADER, &BLEND_FRAGMENT_SHADER);
+
+                _screenBlendShader = _shaderManager->createShader(shaderSource);
+            }
+            if (!_screenFrameBuffer && _viewState.getWidth() > 0 && _viewState.getHeight() > 0) {
+                _screenFrameBuffer = _frameBufferManager->createFrameBuffer(_viewState.getWidth(), _viewState.getHeight(), true, true, true);
+            }
+        }
+
+        // Pre-create the style textures of the loaded vector elements
+        for (const std::shared_ptr<Layer>& layer : _layers->getAll()) {
+            layer->warmUpStyles(*_styleCache);
+        }
+
+        // Compile all shader programs registered by the configured layers,
+        // allocate the frame buffers and drain the texture upload queue
+        _frameBufferManager->processFrameBuffers();
+        _shaderManager->processShaders();
+        while (_textureManager->processTextures()) { }
+
+        GLContext::CheckGLError("MapRenderer::handleWarmUp");
+    }
+
     void MapRenderer::handleRenderThreadCallbacks() {
         // Call all registered callbacks exacly once
         std::vector<std::shared_ptr<ThreadWorker> > renderThreadCallbacks;
@@ -932,20 +1575,17 @@ namespace carto {
     }
     
     void MapRenderer::handleRendererCaptureCallbacks() {
-        int width, height;
-        {
-            std::lock_guard<std::recursive_mutex> lock(_mutex);
-            width = _viewState.getWidth();
-            height = _viewState.getHeight();
-        }
-        std::shared_ptr<Bitmap> captureBitmap;
-        
+        ViewState viewState = getViewState();
+        int width = viewState.getWidth();
+        int height = viewState.getHeight();
+
         std::vector<std::pair<DirectorPtr<RendererCaptureListener>, bool> > rendererCaptureListeners;
         {
             std::lock_guard<std::mutex> lock(_rendererCaptureListenersMutex);
             _rendererCaptureListeners.swap(rendererCaptureListeners);
         }
 
+        std::vector<DirectorPtr<RendererCaptureListener> > readyListeners;
         bool callbacksPending = false;
         for (std::size_t i = 0; i < rendererCaptureListeners.size(); i++) {
             const DirectorPtr<RendererCaptureListener>& listener = rendererCaptureListeners[i].first;
@@ -965,14 +1605,17 @@ namespace carto {
                     continue;
                 }
             }
-            
-            if (!captureBitmap) {
-                std::vector<unsigned char> data(4 * width * height);
-                glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, &data[0]);
-                captureBitmap = std::make_shared<Bitmap>(data.data(), width, height, ColorFormat::COLOR_FORMAT_RGBA, -4 * width);
-            }
-            
-            listener->onMapRendered(captureBitmap);
+
+            readyListeners.push_back(listener);
+        }
+
+        if (!readyListeners.empty()) {
+            // Read the pixels on the render thread, but construct the bitmap and call the
+            // listeners on the capture worker thread, so that the render thread can continue
+            // with the next frame immediately.
+            auto data = std::make_shared<std::vector<unsigned char> >(4 * width * height);
+            glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data->data());
+            _rendererCaptureWorker->init(readyListeners, data, width, height);
         }
         if (callbacksPending) {
             requestRedraw();
@@ -996,10 +1639,10 @@ namespace carto {
             }
 
             if (optionName == "RenderProjectionMode") {
+                // The view state is not updated here, the render thread keeps showing the old
+                // projection surface until the layers have rebuilt their draw data for the new one
                 std::lock_guard<std::recursive_mutex> lock(mapRenderer->_mutex);
-                mapRenderer->_viewState.calculateViewState(*mapRenderer->_options);
-                mapRenderer->_viewState.clampZoom(*mapRenderer->_options);
-                mapRenderer->_viewState.clampFocusPos(*mapRenderer->_options);
+                mapRenderer->_renderProjectionChangeTime = std::chrono::steady_clock::now();
                 mapRenderer->_renderProjectionChanged = true;
                 updateView = true;
             }
@@ -1028,6 +1671,16 @@ namespace carto {
 
     const int MapRenderer::BILLBOARD_PLACEMENT_TASK_DELAY = 200;
 
+    const float MapRenderer::ADAPTIVE_QUALITY_REDUCE_DELAY = 2.0f;
+    const float MapRenderer::ADAPTIVE_QUALITY_RESTORE_DELAY = 10.0f;
+    const float MapRenderer::ADAPTIVE_QUALITY_RESTORE_HEADROOM = 0.75f;
+
+    const int MapRenderer::RENDER_PROJECTION_SWITCH_TIMEOUT = 2000;
+
+    const int MapRenderer::LAYER_INITIALIZATION_FRAME_BUDGET = 5;
+
+    const float MapRenderer::LAYER_RENDER_STATS_SMOOTHING = 0.2f;
+
     const int MapRenderer::STYLE_TEXTURE_CACHE_SIZE = 8 * 1024 * 1024;
 
     const std::string MapRenderer::BLEND_VERTEX_SHADER = R"GLSL(
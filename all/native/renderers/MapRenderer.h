@@ -11,14 +11,18 @@
 #include "graphics/ViewState.h"
 #include "renderers/components/StyleTextureCache.h"
 #include "renderers/BackgroundRenderer.h"
+#include "renderers/CustomRenderPass.h"
 #include "renderers/components/AnimationHandler.h"
 #include "renderers/components/BillboardSorter.h"
+#include "renderers/components/FrameProfiler.h"
 #include "renderers/components/KineticEventHandler.h"
 #include "renderers/WatermarkRenderer.h"
 
 #include <atomic>
 #include <chrono>
+#include <map>
 #include <memory>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -41,8 +45,10 @@ namespace carto {
     class RayIntersectedElement;
     class Options;
     class ThreadWorker;
+    class Variant;
     class CullWorker;
     class BillboardPlacementWorker;
+    class RendererCaptureWorker;
     class FrameBuffer;
     class Shader;
     class Texture;
@@ -100,24 +106,95 @@ namespace carto {
          * SDK automatically redraws the view when needed.
          */
         void requestRedraw() const;
-    
+
+        /**
+         * Returns the number of skipped frames. A frame is skipped when the view is refreshed
+         * while a previously requested refresh is still pending, in which case the two requests
+         * are coalesced into a single rendered frame. The counter can be used to verify that
+         * refresh requests from different sources (animations, kinetic events, loaded data)
+         * do not translate into redundant rendered frames.
+         * @return The number of skipped frames since the renderer was created.
+         */
+        int getSkippedFrameCount() const;
+
+        /**
+         * Warms up the renderer by creating GL resources that are otherwise created lazily:
+         * the shader programs of the configured layers are compiled, the screen frame buffer
+         * is allocated, the style textures of loaded vector elements are created and all
+         * pending textures are uploaded at the beginning of the next frame.
+         * Calling this while the map is still hidden (for example, behind a splash screen)
+         * avoids shader compilation and texture upload stalls during the first interaction.
+         */
+        void warmUp();
+
+        /**
+         * Notifies the renderer that the application has received a low memory warning from the system.
+         * Cached data that can be regenerated is released: preloaded tiles and in-memory tile caches
+         * of all layers, cached style textures and pooled GL resources. Cache capacities are not
+         * changed, so normal caching behavior resumes as new data is loaded.
+         */
+        void onMemoryWarning();
+
+        /**
+         * Returns the state of the frame profiling flag.
+         * @return True if frame profiling is enabled.
+         */
+        bool isFrameProfilingEnabled() const;
+        /**
+         * Enables or disables frame profiling. When enabled, the renderer collects
+         * per-stage frame timings that can be exported via getFrameProfilingTrace.
+         * Profiling is disabled by default.
+         * @param enabled The new state of the frame profiling flag.
+         */
+        void setFrameProfilingEnabled(bool enabled);
+        /**
+         * Returns the collected frame profiling data as a chrome://tracing compatible JSON document.
+         * The document also contains per-stage duration histograms with power-of-two microsecond buckets.
+         * @return The collected frame profiling data.
+         */
+        std::string getFrameProfilingTrace() const;
+        /**
+         * Returns per-layer rendering time statistics. The statistics are returned as a list of
+         * objects, one for each attached layer, containing the layer index, the layer type and the
+         * smoothed CPU times (in seconds) the render thread spent on the drawing passes of that
+         * layer during the recent frames. The times cover the draw call submission on the render
+         * thread, not the GPU execution of the submitted work.
+         * @return The per-layer rendering time statistics.
+         */
+        Variant getLayerRenderStatistics() const;
+
         /**
          * Captures map rendering as a bitmap. This operation is asynchronous and the result is returned via listener callback.
          * @param listener The listener interface that will receive the callback once rendering is available.
          * @param waitWhileUpdating If true, delay the capture until all asynchronous processes are finished (for example, until all tiles are loaded).
          */
         void captureRendering(const std::shared_ptr<RendererCaptureListener>& listener, bool waitWhileUpdating);
-        
+
+        /**
+         * Registers a custom render pass that gets executed at the given point of every rendered frame.
+         * If the pass is already registered, it is moved to the given slot.
+         * @param renderPass The custom render pass to register.
+         * @param slot The point of the frame at which the pass is executed.
+         */
+        void registerCustomRenderPass(const std::shared_ptr<CustomRenderPass>& renderPass, CustomRenderPassSlot::CustomRenderPassSlot slot);
+        /**
+         * Unregisters a previously registered custom render pass.
+         * @param renderPass The custom render pass to unregister.
+         */
+        void unregisterCustomRenderPass(const std::shared_ptr<CustomRenderPass>& renderPass);
+
         std::vector<std::shared_ptr<BillboardDrawData> > getBillboardDrawDatas() const;
     
         AnimationHandler& getAnimationHandler();
         KineticEventHandler& getKineticEventHandler();
+        FrameProfiler& getFrameProfiler();
         
         void calculateCameraEvent(CameraPanEvent& cameraEvent, float durationSeconds, bool updateKinetic);
         void calculateCameraEvent(CameraRotationEvent& cameraEvent, float durationSeconds, bool updateKinetic);
         void calculateCameraEvent(CameraTiltEvent& cameraEvent, float durationSeconds, bool updateKinetic);
         void calculateCameraEvent(CameraZoomEvent& cameraEvent, float durationSeconds, bool updateKinetic);
-    
+        void calculateCameraEvents(CameraPanEvent* panEvent, CameraRotationEvent* rotationEvent, CameraTiltEvent* tiltEvent, CameraZoomEvent* zoomEvent);
+
         void moveToFitBounds(const MapBounds& mapBounds, const ScreenBounds& screenBounds, bool integerZoom, bool resetTilt, bool resetRotation, float durationSeconds);
         
         void onSurfaceCreated();
@@ -141,6 +218,14 @@ namespace carto {
         void addRenderThreadCallback(const std::shared_ptr<ThreadWorker>& callback);
         
     private:
+        struct LayerRenderStats {
+            LayerRenderStats() : drawTime(0), draw3DTime(0), billboardTime(0) { }
+
+            float drawTime; // time of the base drawing pass, in seconds
+            float draw3DTime; // time of the 3D drawing pass, in seconds
+            float billboardTime; // time of the billboard collection pass, in seconds
+        };
+
         class OptionsListener : public Options::OnChangeListener {
         public:
             explicit OptionsListener(const std::shared_ptr<MapRenderer>& mapRenderer);
@@ -153,21 +238,47 @@ namespace carto {
 
         void initializeRenderState() const;
 
+        void requestRedraw(bool invalidateLayersFrameBuffer) const;
+
         void drawLayers(float deltaSeconds, const ViewState& viewState);
-        
+        bool drawCompositingGroup(const std::string& group, const std::vector<std::shared_ptr<Layer> >& groupLayers, float deltaSeconds, const ViewState& viewState, std::map<const Layer*, LayerRenderStats>& frameStats);
+        void blendFrameBuffer(const std::shared_ptr<FrameBuffer>& frameBuffer);
+
+        void runCustomRenderPasses(CustomRenderPassSlot::CustomRenderPassSlot slot);
+
+        void setLayersReducedQuality(bool reduced);
+
+        void handleWarmUp();
         void handleRenderThreadCallbacks();
         void handleRendererCaptureCallbacks();
 
         static const int BILLBOARD_PLACEMENT_TASK_DELAY;
 
+        static const float ADAPTIVE_QUALITY_REDUCE_DELAY; // Time (in seconds) the render stages must stay over the frame budget before tile quality is reduced
+        static const float ADAPTIVE_QUALITY_RESTORE_DELAY; // Time (in seconds) of sustained headroom before the full tile quality is restored
+        static const float ADAPTIVE_QUALITY_RESTORE_HEADROOM; // Fraction of the frame budget a frame must stay under to count as headroom
+
+        static const int RENDER_PROJECTION_SWITCH_TIMEOUT; // Maximum time (in ms) to keep rendering the old projection surface while layers rebuild their draw data
+
+        static const int LAYER_INITIALIZATION_FRAME_BUDGET; // Maximum time (in ms) spent per frame on initializing the renderers of freshly added layers
+
+        static const float LAYER_RENDER_STATS_SMOOTHING; // Weight of the latest frame in the smoothed per-layer render time statistics
+
         static const int STYLE_TEXTURE_CACHE_SIZE; // Size limit (in bytes) for style texture cache
 
         static const std::string BLEND_VERTEX_SHADER;
         static const std::string BLEND_FRAGMENT_SHADER;
         
         std::chrono::steady_clock::time_point _lastFrameTime;
-    
+        float _lastFrameRenderTime; // time spent in the render stages of the last frame, in seconds
+        float _deferredDeltaSeconds; // animation time skipped by the frame budget governor
+        bool _lastFrameDeferred;
+        float _overBudgetSeconds; // time the render stages have continuously stayed over the frame budget
+        float _underBudgetSeconds; // time the render stages have continuously stayed well under the frame budget
+        bool _reducedQuality;
+
         ViewState _viewState;
+        std::shared_ptr<const ViewState> _viewStateSnapshot; // immutable snapshot, accessed with std::atomic_load/atomic_store
 
         std::shared_ptr<FrameBufferManager> _frameBufferManager;
         std::shared_ptr<ShaderManager> _shaderManager;
@@ -184,7 +295,28 @@ namespace carto {
 
         std::shared_ptr<FrameBuffer> _screenFrameBuffer;
         std::shared_ptr<Shader> _screenBlendShader;
-        
+
+        std::shared_ptr<FrameBuffer> _layersFrameBuffer; // cached base and 3D drawing passes, valid only while the camera and the layer contents stay unchanged
+        std::vector<std::shared_ptr<Layer> > _layersFrameBufferLayers;
+        unsigned int _layersFrameBufferCameraGeneration;
+        bool _layersFrameBufferValid;
+        unsigned int _sortedBillboardsCameraGeneration; // sorted billboard list of the last frame, replayed while the camera and the billboards stay unchanged
+        bool _sortedBillboardsValid;
+
+        struct CompositingGroup {
+            CompositingGroup() : frameBuffer(), layers(), contentGenerations(), cameraGeneration(0), valid(false) { }
+
+            std::shared_ptr<FrameBuffer> frameBuffer; // cached base drawing pass of the member layers
+            std::vector<std::shared_ptr<Layer> > layers;
+            std::vector<unsigned int> contentGenerations;
+            unsigned int cameraGeneration;
+            bool valid;
+        };
+
+        std::map<std::string, CompositingGroup> _compositingGroups;
+
+        std::map<std::shared_ptr<Layer>, LayerRenderStats> _layerRenderStatsMap; // smoothed per-layer drawing pass times of the recent frames
+
         BackgroundRenderer _backgroundRenderer;
         WatermarkRenderer _watermarkRenderer;
         
@@ -192,9 +324,14 @@ namespace carto {
         std::vector<std::shared_ptr<BillboardDrawData> > _billboardDrawDataBuffer;
         std::shared_ptr<BillboardPlacementWorker> _billboardPlacementWorker;
         std::thread _billboardPlacementThread;
-    
+
+        std::shared_ptr<RendererCaptureWorker> _rendererCaptureWorker;
+        std::thread _rendererCaptureThread;
+
         AnimationHandler _animationHandler;
         KineticEventHandler _kineticEventHandler;
+
+        FrameProfiler _frameProfiler;
         
         const std::shared_ptr<Layers> _layers;
         const std::shared_ptr<Options> _options;
@@ -202,8 +339,12 @@ namespace carto {
         mutable std::atomic<bool> _surfaceCreated;
         mutable std::atomic<bool> _surfaceChanged;
         mutable std::atomic<bool> _billboardsChanged;
+        mutable std::atomic<bool> _layersFrameBufferInvalidated;
         mutable std::atomic<bool> _renderProjectionChanged;
+        std::chrono::steady_clock::time_point _renderProjectionChangeTime;
         mutable std::atomic<bool> _redrawPending;
+        mutable std::atomic<bool> _warmUpPending;
+        mutable std::atomic<int> _skippedFrameCount;
 
         ThreadSafeDirectorPtr<RedrawRequestListener> _redrawRequestListener;
 
@@ -212,6 +353,9 @@ namespace carto {
         std::vector<std::pair<DirectorPtr<RendererCaptureListener>, bool> > _rendererCaptureListeners;
         mutable std::mutex _rendererCaptureListenersMutex;
 
+        std::vector<std::pair<DirectorPtr<CustomRenderPass>, CustomRenderPassSlot::CustomRenderPassSlot> > _customRenderPasses;
+        mutable std::mutex _customRenderPassesMutex;
+
         std::vector<std::shared_ptr<OnChangeListener> > _onChangeListeners;
         mutable std::mutex _onChangeListenersMutex;
 
@@ -88,16 +88,27 @@ namespace carto {
 
         cglib::mat4x4<float> projMat = cglib::mat4x4<float>::convert(viewState.getProjectionMat());
 
-        // Create new models
+        // Create new models. Creation is amortized across frames using a per-frame byte budget,
+        // as creating all models of a refined LOD level in a single frame would stall the frame.
+        // Until a deferred model is created, the substitution logic below keeps drawing its
+        // closest created parent or children.
+        std::size_t createdSize = 0;
+        bool createPending = false;
         for (auto it = _drawRecordMap.begin(); it != _drawRecordMap.end(); it++) {
             ModelNodeDrawRecord& record = *it->second;
             if (!(record.used && !record.created)) {
                 continue;
             }
-    
+
+            if (createdSize > 0 && createdSize + record.drawData.getGLSize() > MAX_CREATED_SIZE_PER_FRAME) {
+                createPending = true;
+                continue;
+            }
+
             record.drawData.getGLModel()->create(*_glResourceManager);
 
             record.created = true;
+            createdSize += record.drawData.getGLSize();
         }
     
         // If a model is not used but created then keep it if it has a parent that is used but not created. Also check that it does not have a closer parent that is created.  
@@ -169,7 +180,7 @@ namespace carto {
         glDepthMask(GL_FALSE);
         glActiveTexture(GL_TEXTURE0);
 
-        return false;
+        return createPending;
     }
 
     void NMLModelLODTreeRenderer::onSurfaceDestroyed() {
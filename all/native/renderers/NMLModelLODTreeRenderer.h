@@ -64,7 +64,9 @@ namespace carto {
     
             ModelNodeDrawRecord(const NMLModelLODTreeDrawData& drawData) : drawData(drawData), parent(0), children(), used(false), created(false) { }
         };
-    
+
+        static const int MAX_CREATED_SIZE_PER_FRAME = 4 * 1024 * 1024; // byte budget for model creation during a single frame, deferred models are created during subsequent frames
+
         std::weak_ptr<MapRenderer> _mapRenderer;
         std::weak_ptr<Options> _options;
 
@@ -90,25 +90,43 @@ namespace carto {
         MapVec optionsMainLightDirection = options->getMainLightDirection();
         cglib::vec3<float> mainLightDir = cglib::vec3<float>::convert(cglib::unit(viewState.getProjectionSurface()->calculateVector(MapPos(0, 0), options->getMainLightDirection())));
 
-        // Draw models
-        cglib::mat4x4<float> projMat = cglib::mat4x4<float>::convert(viewState.getProjectionMat());
+        // Group elements by their shared source model. Repeated instances of the same model
+        // (for example the same model placed at many positions) then resolve their GL resources
+        // only once and are drawn consecutively, minimizing driver state changes.
+        std::map<std::shared_ptr<nml::Model>, std::vector<std::shared_ptr<NMLModel> > > instanceMap;
         for (const std::shared_ptr<NMLModel>& element : _elements) {
-            const NMLModelDrawData& drawData = *element->getDrawData();
+            instanceMap[element->getDrawData()->getSourceModel()].push_back(element);
+        }
 
-            Color drawDataColor = drawData.getColor();
-            cglib::vec4<float> modelColor = cglib::vec4<float>(drawDataColor.getR(), drawDataColor.getG(), drawDataColor.getB(), drawDataColor.getA()) * (1.0f / 255.0f);
-            std::shared_ptr<nml::Model> sourceModel = drawData.getSourceModel();
+        // Draw models
+        cglib::frustum3<double> frustum = cglib::gl_projection_frustum(viewState.getModelviewProjectionMat());
+        cglib::mat4x4<float> projMat = cglib::mat4x4<float>::convert(viewState.getProjectionMat());
+        for (auto it = instanceMap.begin(); it != instanceMap.end(); it++) {
+            const std::shared_ptr<nml::Model>& sourceModel = it->first;
             std::shared_ptr<nml::GLModel> glModel = _glModelMap[sourceModel];
             if (!glModel) {
                 glModel = std::make_shared<nml::GLModel>(*sourceModel);
                 glModel->create(*_glResourceManager);
                 _glModelMap[sourceModel] = glModel;
             }
-    
-            cglib::mat4x4<float> mvMat = cglib::mat4x4<float>::convert(viewState.getModelviewMat() * drawData.getLocalMat());
-            nml::RenderState renderState(projMat, mvMat, cglib::pointwise_product(ambientLightColor, modelColor), cglib::pointwise_product(mainLightColor, modelColor), -mainLightDir);
 
-            glModel->draw(*_glResourceManager, renderState);
+            cglib::bbox3<double> modelBounds = cglib::bbox3<double>::convert(glModel->getBounds());
+            for (const std::shared_ptr<NMLModel>& element : it->second) {
+                const NMLModelDrawData& drawData = *element->getDrawData();
+
+                // Skip instances that are outside of the view frustum
+                if (!frustum.inside(cglib::transform_bbox(modelBounds, drawData.getLocalMat()))) {
+                    continue;
+                }
+
+                Color drawDataColor = drawData.getColor();
+                cglib::vec4<float> modelColor = cglib::vec4<float>(drawDataColor.getR(), drawDataColor.getG(), drawDataColor.getB(), drawDataColor.getA()) * (1.0f / 255.0f);
+
+                cglib::mat4x4<float> mvMat = cglib::mat4x4<float>::convert(viewState.getModelviewMat() * drawData.getLocalMat());
+                nml::RenderState renderState(projMat, mvMat, cglib::pointwise_product(ambientLightColor, modelColor), cglib::pointwise_product(mainLightColor, modelColor), -mainLightDir);
+
+                glModel->draw(*_glResourceManager, renderState);
+            }
         }
 
         // Remove stale models
@@ -33,6 +33,25 @@ namespace carto {
         _a_texCoord(0),
         _u_mvpMat(0),
         _u_tex(0),
+        _instancedShader(),
+        _ia_color(0),
+        _ia_coord(0),
+        _ia_xAxis(0),
+        _ia_yAxis(0),
+        _ia_size(0),
+        _ia_corner(0),
+        _iu_mvpMat(0),
+        _iu_tex(0),
+        _iu_originShift(0),
+        _iu_coordScale(0),
+        _iu_texCoordScale(0),
+        _instanceVBO(0),
+        _instanceBufferDirty(true),
+        _instanceOrigin(0, 0, 0),
+        _instanceDrawDatas(),
+        _instanceRanges(),
+        _instanceIndexMap(),
+        _dirtyInstances(),
         _mutex()
     {
     }
@@ -43,17 +62,19 @@ namespace carto {
     void PointRenderer::offsetLayerHorizontally(double offset) {
         // Offset current draw data batch horizontally by the required amount
         std::lock_guard<std::mutex> lock(_mutex);
-    
+
         for (const std::shared_ptr<Point>& element : _elements) {
             element->getDrawData()->offsetHorizontally(offset);
         }
+        _instanceBufferDirty = true;
     }
     
     void PointRenderer::onSurfaceCreated(const std::shared_ptr<ShaderManager>& shaderManager, const std::shared_ptr<TextureManager>& textureManager) {
         static ShaderSource shaderSource("point", &POINT_VERTEX_SHADER, &POINT_FRAGMENT_SHADER);
-        
+        static ShaderSource instancedShaderSource("point_instanced", &POINT_INSTANCED_VERTEX_SHADER, &POINT_FRAGMENT_SHADER);
+
         _shader = shaderManager->createShader(shaderSource);
-    
+
         // Get shader variables locations
         glUseProgram(_shader->getProgId());
         _a_color = _shader->getAttribLoc("a_color");
@@ -62,6 +83,29 @@ namespace carto {
         _u_mvpMat = _shader->getUniformLoc("u_mvpMat");
         _u_tex = _shader->getUniformLoc("u_tex");
 
+        // Create the instanced shader, if the required extension is supported
+        _instancedShader.reset();
+        if (GLContext::INSTANCED_ARRAYS) {
+            _instancedShader = shaderManager->createShader(instancedShaderSource);
+
+            glUseProgram(_instancedShader->getProgId());
+            _ia_color = _instancedShader->getAttribLoc("a_color");
+            _ia_coord = _instancedShader->getAttribLoc("a_coord");
+            _ia_xAxis = _instancedShader->getAttribLoc("a_xAxis");
+            _ia_yAxis = _instancedShader->getAttribLoc("a_yAxis");
+            _ia_size = _instancedShader->getAttribLoc("a_size");
+            _ia_corner = _instancedShader->getAttribLoc("a_corner");
+            _iu_mvpMat = _instancedShader->getUniformLoc("u_mvpMat");
+            _iu_tex = _instancedShader->getUniformLoc("u_tex");
+            _iu_originShift = _instancedShader->getUniformLoc("u_originShift");
+            _iu_coordScale = _instancedShader->getUniformLoc("u_coordScale");
+            _iu_texCoordScale = _instancedShader->getUniformLoc("u_texCoordScale");
+        }
+
+        // The instance buffer belonged to the destroyed context
+        _instanceVBO = 0;
+        _instanceBufferDirty = true;
+
         // Drop elements
         std::vector<std::shared_ptr<Point>> elements;
         {
@@ -73,6 +117,23 @@ namespace carto {
         }
     }
     
+    void PointRenderer::warmUpStyles(StyleTextureCache& styleCache) {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        // Create the textures of all the loaded elements, so that the first frame
+        // does not stall creating them one-by-one as the batches are drawn
+        for (const std::shared_ptr<Point>& element : _elements) {
+            std::shared_ptr<PointDrawData> drawData = element->getDrawData();
+            if (!drawData) {
+                continue;
+            }
+            const std::shared_ptr<Bitmap>& bitmap = drawData->getBitmap();
+            if (bitmap && !styleCache.get(bitmap, true, false)) {
+                styleCache.create(bitmap, true, false);
+            }
+        }
+    }
+
     void PointRenderer::onDrawFrame(float deltaSeconds, StyleTextureCache& styleCache, const ViewState& viewState) {
         std::lock_guard<std::mutex> lock(_mutex);
         
@@ -80,23 +141,30 @@ namespace carto {
             // Early return, to avoid calling glUseProgram etc.
             return;
         }
-        
-        bind(viewState);
-    
-        // Draw points, batch by bitmap
-        for (const std::shared_ptr<Point>& element : _elements) {
-            std::shared_ptr<PointDrawData> drawData = element->getDrawData();
-            addToBatch(drawData, styleCache, viewState);
+
+        if (_instancedShader) {
+            // Instanced path, the per-point data is kept in a GL buffer and the quads are expanded in the vertex shader
+            drawInstanced(styleCache, viewState);
+        } else {
+            bind(viewState);
+
+            // Draw points, batch by bitmap
+            for (const std::shared_ptr<Point>& element : _elements) {
+                std::shared_ptr<PointDrawData> drawData = element->getDrawData();
+                addToBatch(drawData, styleCache, viewState);
+            }
+            drawBatch(styleCache, viewState);
+
+            unbind();
         }
-        drawBatch(styleCache, viewState);
-        
-        unbind();
-    
+
         GLContext::CheckGLError("PointRenderer::onDrawFrame");
     }
     
     void PointRenderer::onSurfaceDestroyed() {
         _shader.reset();
+        _instancedShader.reset();
+        _instanceVBO = 0;
     }
     
     void PointRenderer::addElement(const std::shared_ptr<Point>& element) {
@@ -107,24 +175,49 @@ namespace carto {
     
     void PointRenderer::refreshElements() {
         std::lock_guard<std::mutex> lock(_mutex);
+        if (_elements != _tempElements) {
+            _instanceBufferDirty = true;
+        }
         _elements.clear();
         _elements.swap(_tempElements);
     }
-        
+
     void PointRenderer::updateElement(const std::shared_ptr<Point>& element) {
         std::lock_guard<std::mutex> lock(_mutex);
         if (std::find(_elements.begin(), _elements.end(), element) == _elements.end()) {
             if (element->getDrawData()) {
                 _elements.push_back(element);
+                _instanceBufferDirty = true;
+            }
+        } else {
+            // Existing element, patch its instance record in-place if the bitmap did not change
+            auto it = _instanceIndexMap.find(element.get());
+            std::shared_ptr<PointDrawData> drawData = element->getDrawData();
+            if (it != _instanceIndexMap.end() && drawData && drawData->getBitmap() == _instanceDrawDatas[it->second]->getBitmap()) {
+                _instanceDrawDatas[it->second] = drawData;
+                _dirtyInstances.push_back(it->second);
+            } else {
+                _instanceBufferDirty = true;
             }
         }
     }
-    
+
     void PointRenderer::removeElement(const std::shared_ptr<Point>& element) {
         std::lock_guard<std::mutex> lock(_mutex);
         _elements.erase(std::remove(_elements.begin(), _elements.end(), element), _elements.end());
+        _instanceBufferDirty = true;
     }
     
+    void PointRenderer::trimBuffers() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        // Release the CPU-side vertex buffers. They are grown back to their
+        // steady-state sizes during the next frame.
+        std::vector<unsigned char>().swap(_colorBuf);
+        std::vector<float>().swap(_coordBuf);
+        std::vector<unsigned short>().swap(_indexBuf);
+        std::vector<float>().swap(_texCoordBuf);
+    }
+
     void PointRenderer::calculateRayIntersectedElements(const std::shared_ptr<VectorLayer>& layer, const cglib::ray3<double>& ray, const ViewState& viewState, std::vector<RayIntersectedElement>& results) const {
         std::lock_guard<std::mutex> lock(_mutex);
     
@@ -146,12 +239,10 @@ namespace carto {
                                             const ViewState& viewState)
     {
         // Resize the buffers, if necessary
-        if (coordBuf.size() < drawDataBuffer.size() * 4 * 3) {
-            coordBuf.resize(std::min(drawDataBuffer.size() * 4 * 3, GLContext::MAX_VERTEXBUFFER_SIZE * 3));
-            texCoordBuf.resize(std::min(drawDataBuffer.size() * 4 * 2, GLContext::MAX_VERTEXBUFFER_SIZE * 2));
-            colorBuf.resize(std::min(drawDataBuffer.size() * 4 * 4, GLContext::MAX_VERTEXBUFFER_SIZE * 4));
-            indexBuf.resize(std::min(drawDataBuffer.size() * 6, GLContext::MAX_VERTEXBUFFER_SIZE));
-        }
+        GLContext::ResizeVertexBuffer(coordBuf, drawDataBuffer.size() * 4 * 3, GLContext::MAX_VERTEXBUFFER_SIZE * 3);
+        GLContext::ResizeVertexBuffer(texCoordBuf, drawDataBuffer.size() * 4 * 2, GLContext::MAX_VERTEXBUFFER_SIZE * 2);
+        GLContext::ResizeVertexBuffer(colorBuf, drawDataBuffer.size() * 4 * 4, GLContext::MAX_VERTEXBUFFER_SIZE * 4);
+        GLContext::ResizeVertexBuffer(indexBuf, drawDataBuffer.size() * 6, GLContext::MAX_VERTEXBUFFER_SIZE);
     
         // Calculate and draw buffers
         cglib::vec3<double> cameraPos = viewState.getCameraPos();
@@ -320,7 +411,7 @@ namespace carto {
 
         // Bind texture
         const std::shared_ptr<Bitmap>& bitmap = _drawDataBuffer.front()->getBitmap();
-        std::shared_ptr<Texture> texture = styleCache.get(bitmap);
+        std::shared_ptr<Texture> texture = styleCache.get(bitmap, true, false);
         if (!texture) {
             texture = styleCache.create(bitmap, true, false);
         }
@@ -333,7 +424,170 @@ namespace carto {
         _drawDataBuffer.clear();
         _prevBitmap = nullptr;
     }
-    
+
+    void PointRenderer::drawInstanced(StyleTextureCache& styleCache, const ViewState& viewState) {
+        // Create or refresh the instance buffer
+        if (_instanceVBO == 0) {
+            glGenBuffers(1, &_instanceVBO);
+            _instanceBufferDirty = true;
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, _instanceVBO);
+        if (!_instanceBufferDirty) {
+            // The instance offsets are float32 values relative to _instanceOrigin, so their
+            // rounding error grows with the distance from the origin. Rebuild the buffer around
+            // the current camera position once the camera strays far enough that the error of
+            // points near the camera would become visible
+            double originDistance = cglib::length(viewState.getCameraPos() - _instanceOrigin);
+            if (originDistance > viewState.getUnitToDPCoef() * MAX_INSTANCE_ORIGIN_DISTANCE) {
+                _instanceBufferDirty = true;
+            }
+        }
+        if (_instanceBufferDirty) {
+            _instanceOrigin = viewState.getCameraPos();
+            rebuildInstanceBuffer();
+        } else if (!_dirtyInstances.empty()) {
+            // Patch only the changed instance records
+            unsigned char record[INSTANCE_STRIDE];
+            for (std::size_t index : _dirtyInstances) {
+                buildInstanceRecord(*_instanceDrawDatas[index], record);
+                glBufferSubData(GL_ARRAY_BUFFER, index * INSTANCE_STRIDE, INSTANCE_STRIDE, record);
+            }
+            _dirtyInstances.clear();
+        }
+        if (_instanceDrawDatas.empty()) {
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            return;
+        }
+
+        // Prepare for drawing
+        glUseProgram(_instancedShader->getProgId());
+        // Texture
+        glUniform1i(_iu_tex, 0);
+        // Matrix, origin shift relative to the camera, coordinate scale
+        const cglib::mat4x4<float>& mvpMat = viewState.getRTEModelviewProjectionMat();
+        glUniformMatrix4fv(_iu_mvpMat, 1, GL_FALSE, mvpMat.data());
+        cglib::vec3<float> originShift = cglib::vec3<float>::convert(_instanceOrigin - viewState.getCameraPos());
+        glUniform3f(_iu_originShift, originShift(0), originShift(1), originShift(2));
+        glUniform1f(_iu_coordScale, viewState.getUnitToDPCoef() * 0.5f);
+
+        // Per-vertex quad corners, shared by all instances
+        const float corners[4 * 2] = { -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f, -1.0f };
+        const unsigned short indices[6] = { 0, 1, 2, 1, 3, 2 };
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glEnableVertexAttribArray(_ia_corner);
+        glVertexAttribPointer(_ia_corner, 2, GL_FLOAT, GL_FALSE, 0, corners);
+
+        // Per-instance attributes
+        glBindBuffer(GL_ARRAY_BUFFER, _instanceVBO);
+        glEnableVertexAttribArray(_ia_coord);
+        glEnableVertexAttribArray(_ia_xAxis);
+        glEnableVertexAttribArray(_ia_yAxis);
+        glEnableVertexAttribArray(_ia_size);
+        glEnableVertexAttribArray(_ia_color);
+        GLContext::VertexAttribDivisorEXT(_ia_coord, 1);
+        GLContext::VertexAttribDivisorEXT(_ia_xAxis, 1);
+        GLContext::VertexAttribDivisorEXT(_ia_yAxis, 1);
+        GLContext::VertexAttribDivisorEXT(_ia_size, 1);
+        GLContext::VertexAttribDivisorEXT(_ia_color, 1);
+
+        // Draw each run of consecutive same-bitmap instances
+        std::size_t instanceOffset = 0;
+        for (const std::pair<std::shared_ptr<Bitmap>, GLsizei>& range : _instanceRanges) {
+            std::shared_ptr<Texture> texture = styleCache.get(range.first, true, false);
+            if (!texture) {
+                texture = styleCache.create(range.first, true, false);
+            }
+            glBindTexture(GL_TEXTURE_2D, texture->getTexId());
+            const cglib::vec2<float>& texCoordScale = texture->getTexCoordScale();
+            glUniform2f(_iu_texCoordScale, texCoordScale(0), texCoordScale(1));
+
+            // The extension has no base instance support, rebase the attribute pointers instead
+            std::size_t byteOffset = instanceOffset * INSTANCE_STRIDE;
+            glVertexAttribPointer(_ia_coord, 3, GL_FLOAT, GL_FALSE, INSTANCE_STRIDE, reinterpret_cast<const void*>(byteOffset + 0));
+            glVertexAttribPointer(_ia_xAxis, 3, GL_FLOAT, GL_FALSE, INSTANCE_STRIDE, reinterpret_cast<const void*>(byteOffset + 12));
+            glVertexAttribPointer(_ia_yAxis, 3, GL_FLOAT, GL_FALSE, INSTANCE_STRIDE, reinterpret_cast<const void*>(byteOffset + 24));
+            glVertexAttribPointer(_ia_size, 1, GL_FLOAT, GL_FALSE, INSTANCE_STRIDE, reinterpret_cast<const void*>(byteOffset + 36));
+            glVertexAttribPointer(_ia_color, 4, GL_UNSIGNED_BYTE, GL_TRUE, INSTANCE_STRIDE, reinterpret_cast<const void*>(byteOffset + 40));
+
+            GLContext::DrawElementsInstancedEXT(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, indices, range.second);
+
+            instanceOffset += range.second;
+        }
+
+        // Reset divisors, disable bound arrays
+        GLContext::VertexAttribDivisorEXT(_ia_coord, 0);
+        GLContext::VertexAttribDivisorEXT(_ia_xAxis, 0);
+        GLContext::VertexAttribDivisorEXT(_ia_yAxis, 0);
+        GLContext::VertexAttribDivisorEXT(_ia_size, 0);
+        GLContext::VertexAttribDivisorEXT(_ia_color, 0);
+        glDisableVertexAttribArray(_ia_coord);
+        glDisableVertexAttribArray(_ia_xAxis);
+        glDisableVertexAttribArray(_ia_yAxis);
+        glDisableVertexAttribArray(_ia_size);
+        glDisableVertexAttribArray(_ia_color);
+        glDisableVertexAttribArray(_ia_corner);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void PointRenderer::rebuildInstanceBuffer() {
+        _instanceDrawDatas.clear();
+        _instanceRanges.clear();
+        _instanceIndexMap.clear();
+        _dirtyInstances.clear();
+
+        // Collect the draw datas, batch consecutive elements sharing a bitmap
+        for (const std::shared_ptr<Point>& element : _elements) {
+            std::shared_ptr<PointDrawData> drawData = element->getDrawData();
+            if (!drawData) {
+                continue;
+            }
+            if (!_instanceRanges.empty() && _instanceRanges.back().first == drawData->getBitmap()) {
+                _instanceRanges.back().second++;
+            } else {
+                _instanceRanges.emplace_back(drawData->getBitmap(), 1);
+            }
+            _instanceIndexMap[element.get()] = _instanceDrawDatas.size();
+            _instanceDrawDatas.push_back(std::move(drawData));
+        }
+        if (_instanceDrawDatas.empty()) {
+            _instanceBufferDirty = false;
+            return;
+        }
+
+        // Pack the instance records and upload them. The records store float32 offsets
+        // from _instanceOrigin, which the caller has placed at the current camera position
+        // so that the points near the camera keep their full precision
+        std::vector<unsigned char> records(_instanceDrawDatas.size() * INSTANCE_STRIDE);
+        for (std::size_t i = 0; i < _instanceDrawDatas.size(); i++) {
+            buildInstanceRecord(*_instanceDrawDatas[i], records.data() + i * INSTANCE_STRIDE);
+        }
+        glBufferData(GL_ARRAY_BUFFER, records.size(), records.data(), GL_DYNAMIC_DRAW);
+
+        _instanceBufferDirty = false;
+    }
+
+    void PointRenderer::buildInstanceRecord(const PointDrawData& drawData, unsigned char* record) const {
+        float* floats = reinterpret_cast<float*>(record);
+        cglib::vec3<float> pos = cglib::vec3<float>::convert(drawData.getPos() - _instanceOrigin);
+        floats[0] = pos(0);
+        floats[1] = pos(1);
+        floats[2] = pos(2);
+        const cglib::vec3<float>& xAxis = drawData.getXAxis();
+        floats[3] = xAxis(0);
+        floats[4] = xAxis(1);
+        floats[5] = xAxis(2);
+        const cglib::vec3<float>& yAxis = drawData.getYAxis();
+        floats[6] = yAxis(0);
+        floats[7] = yAxis(1);
+        floats[8] = yAxis(2);
+        floats[9] = drawData.getSize();
+        const Color& color = drawData.getColor();
+        record[40] = color.getR();
+        record[41] = color.getG();
+        record[42] = color.getB();
+        record[43] = color.getA();
+    }
+
     const std::string PointRenderer::POINT_VERTEX_SHADER = R"GLSL(
         #version 100
         attribute vec4 a_coord;
@@ -349,6 +603,29 @@ namespace carto {
         }
     )GLSL";
 
+    const std::string PointRenderer::POINT_INSTANCED_VERTEX_SHADER = R"GLSL(
+        #version 100
+        attribute vec2 a_corner;
+        attribute vec3 a_coord;
+        attribute vec3 a_xAxis;
+        attribute vec3 a_yAxis;
+        attribute float a_size;
+        attribute vec4 a_color;
+        varying vec2 v_texCoord;
+        varying vec4 v_color;
+        uniform mat4 u_mvpMat;
+        uniform vec3 u_originShift;
+        uniform float u_coordScale;
+        uniform vec2 u_texCoordScale;
+        void main() {
+            float scale = a_size * u_coordScale;
+            vec3 pos = a_coord + u_originShift + a_xAxis * (a_corner.x * scale) + a_yAxis * (a_corner.y * scale);
+            v_texCoord = (a_corner + vec2(1.0, 1.0)) * 0.5 * u_texCoordScale;
+            v_color = a_color;
+            gl_Position = u_mvpMat * vec4(pos, 1.0);
+        }
+    )GLSL";
+
     const std::string PointRenderer::POINT_FRAGMENT_SHADER = R"GLSL(
         #version 100
         precision mediump float;
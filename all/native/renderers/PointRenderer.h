@@ -12,6 +12,7 @@
 #include <deque>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
 #include <vector>
 
 #include <cglib/vec.h>
@@ -38,6 +39,7 @@ namespace carto {
         void offsetLayerHorizontally(double offset);
     
         void onSurfaceCreated(const std::shared_ptr<ShaderManager>& shaderManager, const std::shared_ptr<TextureManager>& textureManager);
+        void warmUpStyles(StyleTextureCache& styleCache);
         void onDrawFrame(float deltaSeconds, StyleTextureCache& styleCache, const ViewState& viewState);
         void onSurfaceDestroyed();
     
@@ -48,6 +50,8 @@ namespace carto {
     
         void calculateRayIntersectedElements(const std::shared_ptr<VectorLayer>& layer, const cglib::ray3<double>& ray, const ViewState& viewState, std::vector<RayIntersectedElement>& results) const;
 
+        void trimBuffers();
+
     protected:
         friend class GeometryCollectionRenderer;
 
@@ -73,14 +77,23 @@ namespace carto {
 
         void bind(const ViewState& viewState);
         void unbind();
-        
+
         bool isEmptyBatch() const;
         void addToBatch(const std::shared_ptr<PointDrawData>& drawData, StyleTextureCache& styleCache, const ViewState& viewState);
         void drawBatch(StyleTextureCache& styleCache, const ViewState& viewState);
-    
+
+        void drawInstanced(StyleTextureCache& styleCache, const ViewState& viewState);
+        void rebuildInstanceBuffer();
+        void buildInstanceRecord(const PointDrawData& drawData, unsigned char* record) const;
+
         static const std::string POINT_VERTEX_SHADER;
+        static const std::string POINT_INSTANCED_VERTEX_SHADER;
         static const std::string POINT_FRAGMENT_SHADER;
-        
+
+        static const std::size_t INSTANCE_STRIDE = 44; // position, x/y axes, size as floats, color as 4 bytes
+
+        static constexpr double MAX_INSTANCE_ORIGIN_DISTANCE = 2097152.0; // in DPs; 2^21 keeps the float32 offset error of camera-proximate points below 1/8th of a DP
+
         std::vector<std::shared_ptr<Point> > _elements;
         std::vector<std::shared_ptr<Point> > _tempElements;
         
@@ -98,7 +111,28 @@ namespace carto {
         GLuint _a_texCoord;
         GLuint _u_mvpMat;
         GLuint _u_tex;
-    
+
+        std::shared_ptr<Shader> _instancedShader;
+        GLuint _ia_color;
+        GLuint _ia_coord;
+        GLuint _ia_xAxis;
+        GLuint _ia_yAxis;
+        GLuint _ia_size;
+        GLuint _ia_corner;
+        GLuint _iu_mvpMat;
+        GLuint _iu_tex;
+        GLuint _iu_originShift;
+        GLuint _iu_coordScale;
+        GLuint _iu_texCoordScale;
+
+        GLuint _instanceVBO;
+        bool _instanceBufferDirty;
+        cglib::vec3<double> _instanceOrigin;
+        std::vector<std::shared_ptr<PointDrawData> > _instanceDrawDatas;
+        std::vector<std::pair<std::shared_ptr<Bitmap>, GLsizei> > _instanceRanges; // consecutive runs of elements sharing a bitmap
+        std::unordered_map<const Point*, std::size_t> _instanceIndexMap;
+        std::vector<std::size_t> _dirtyInstances;
+
         mutable std::mutex _mutex;
     };
     
@@ -27,11 +27,13 @@ namespace carto {
         _colorBuf(),
         _attribBuf(),
         _coordBuf(),
+        _extrudeBuf(),
         _normalBuf(),
         _shader(),
         _a_color(0),
         _a_attrib(0),
         _a_coord(0),
+        _a_extrude(0),
         _a_normal(0),
         _u_ambientColor(0),
         _u_lightColor(0),
@@ -68,6 +70,7 @@ namespace carto {
         _a_color = _shader->getAttribLoc("a_color");
         _a_attrib = _shader->getAttribLoc("a_attrib");
         _a_coord = _shader->getAttribLoc("a_coord");
+        _a_extrude = _shader->getAttribLoc("a_extrude");
         _a_normal = _shader->getAttribLoc("a_normal");
         _u_ambientColor = _shader->getUniformLoc("u_ambientColor");
         _u_lightColor = _shader->getUniformLoc("u_lightColor");
@@ -108,6 +111,7 @@ namespace carto {
         glEnableVertexAttribArray(_a_color);
         glEnableVertexAttribArray(_a_attrib);
         glEnableVertexAttribArray(_a_coord);
+        glEnableVertexAttribArray(_a_extrude);
         glEnableVertexAttribArray(_a_normal);
         // Ambient light color
         const Color& ambientLightColor = options->getAmbientLightColor();
@@ -139,6 +143,7 @@ namespace carto {
         glDisableVertexAttribArray(_a_color);
         glDisableVertexAttribArray(_a_attrib);
         glDisableVertexAttribArray(_a_coord);
+        glDisableVertexAttribArray(_a_extrude);
         glDisableVertexAttribArray(_a_normal);
     
         GLContext::CheckGLError("Polygon3DRenderer::onDrawFrame");
@@ -185,12 +190,17 @@ namespace carto {
                 continue;
             }
     
-            // Test triangles
+            // Test triangles, apply extrusion to get the actual vertex positions
             double closestT = std::numeric_limits<double>::infinity();
             const std::vector<cglib::vec3<double> >& coords = drawData.getCoords();
+            const std::vector<cglib::vec3<float> >& extrusionVecs = drawData.getExtrusionVecs();
+            double height = drawData.getHeight();
             for (std::size_t i = 0; i < coords.size(); i += 3) {
+                cglib::vec3<double> p0 = coords[i + 0] + cglib::vec3<double>::convert(extrusionVecs[i + 0]) * height;
+                cglib::vec3<double> p1 = coords[i + 1] + cglib::vec3<double>::convert(extrusionVecs[i + 1]) * height;
+                cglib::vec3<double> p2 = coords[i + 2] + cglib::vec3<double>::convert(extrusionVecs[i + 2]) * height;
                 double t = 0;
-                if (cglib::intersect_triangle(coords[i + 0], coords[i + 1], coords[i + 2], ray, &t)) {
+                if (cglib::intersect_triangle(p0, p1, p2, ray, &t)) {
                     closestT = std::min(closestT, t);
                 }
             }
@@ -203,10 +213,12 @@ namespace carto {
     void Polygon3DRenderer::BuildAndDrawBuffers(GLuint a_color,
                                                 GLuint a_attrib,
                                                 GLuint a_coord,
+                                                GLuint a_extrude,
                                                 GLuint a_normal,
                                                 std::vector<unsigned char>& colorBuf,
                                                 std::vector<unsigned char>& attribBuf,
                                                 std::vector<float>& coordBuf,
+                                                std::vector<float>& extrudeBuf,
                                                 std::vector<float>& normalBuf,
                                                 std::vector<std::shared_ptr<Polygon3DDrawData> >& drawDataBuffer,
                                                 const ViewState& viewState)
@@ -216,12 +228,13 @@ namespace carto {
         for (const std::shared_ptr<Polygon3DDrawData>& drawData : drawDataBuffer) {
             totalCoordCount += drawData->getCoords().size();
         }
-    
+
         // Resize the buffers, if necessary
         if (colorBuf.size() < totalCoordCount * 4) {
             colorBuf.resize(std::min(totalCoordCount * 4, GLContext::MAX_VERTEXBUFFER_SIZE * 4));
             attribBuf.resize(std::min(totalCoordCount * 1, GLContext::MAX_VERTEXBUFFER_SIZE * 1));
             coordBuf.resize(std::min(totalCoordCount * 3, GLContext::MAX_VERTEXBUFFER_SIZE * 3));
+            extrudeBuf.resize(std::min(totalCoordCount * 3, GLContext::MAX_VERTEXBUFFER_SIZE * 3));
             normalBuf.resize(std::min(totalCoordCount * 3, GLContext::MAX_VERTEXBUFFER_SIZE * 3));
         }
     
@@ -243,21 +256,25 @@ namespace carto {
                 glVertexAttribPointer(a_color, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, colorBuf.data());
                 glVertexAttribPointer(a_attrib, 1, GL_UNSIGNED_BYTE, GL_FALSE, 0, attribBuf.data());
                 glVertexAttribPointer(a_coord, 3, GL_FLOAT, GL_FALSE, 0, coordBuf.data());
+                glVertexAttribPointer(a_extrude, 3, GL_FLOAT, GL_FALSE, 0, extrudeBuf.data());
                 glVertexAttribPointer(a_normal, 3, GL_FLOAT, GL_FALSE, 0, normalBuf.data());
                 glDrawArrays(GL_TRIANGLES, 0, coordIndex);
                 // Start filling buffers from the beginning
                 coordIndex = 0;
             }
-    
+
             // Coords and colors
             const Color& color = drawData->getColor();
             const Color& sideColor = drawData->getSideColor();
+            float height = drawData->getHeight();
+            const std::vector<cglib::vec3<float> >& extrusionVecs = drawData->getExtrusionVecs();
             const std::vector<cglib::vec3<float> >& normals = drawData->getNormals();
             const std::vector<unsigned char>& attribs = drawData->getAttribs();
             std::vector<cglib::vec3<double> >::const_iterator cit = coords.begin();
+            std::vector<cglib::vec3<float> >::const_iterator eit = extrusionVecs.begin();
             std::vector<cglib::vec3<float> >::const_iterator nit = normals.begin();
             std::vector<unsigned char>::const_iterator ait = attribs.begin();
-            for (; cit != coords.end() && nit != normals.end(); ++cit, ++nit, ait++) {
+            for (; cit != coords.end() && nit != normals.end(); ++cit, ++eit, ++nit, ait++) {
                 if (*ait) {
                     colorBuf[coordIndex * 4 + 0] = color.getR();
                     colorBuf[coordIndex * 4 + 1] = color.getG();
@@ -276,7 +293,12 @@ namespace carto {
                 coordBuf[coordIndex * 3 + 0] = static_cast<float>(coord(0) - cameraPos(0));
                 coordBuf[coordIndex * 3 + 1] = static_cast<float>(coord(1) - cameraPos(1));
                 coordBuf[coordIndex * 3 + 2] = static_cast<float>(coord(2) - cameraPos(2));
-                
+
+                const cglib::vec3<float>& extrusionVec = *eit;
+                extrudeBuf[coordIndex * 3 + 0] = extrusionVec(0) * height;
+                extrudeBuf[coordIndex * 3 + 1] = extrusionVec(1) * height;
+                extrudeBuf[coordIndex * 3 + 2] = extrusionVec(2) * height;
+
                 const cglib::vec3<float>& normal = *nit;
                 normalBuf[coordIndex * 3 + 0] = normal(0);
                 normalBuf[coordIndex * 3 + 1] = normal(1);
@@ -291,20 +313,22 @@ namespace carto {
             glVertexAttribPointer(a_color, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, colorBuf.data());
             glVertexAttribPointer(a_attrib, 1, GL_UNSIGNED_BYTE, GL_FALSE, 0, attribBuf.data());
             glVertexAttribPointer(a_coord, 3, GL_FLOAT, GL_FALSE, 0, coordBuf.data());
+            glVertexAttribPointer(a_extrude, 3, GL_FLOAT, GL_FALSE, 0, extrudeBuf.data());
             glVertexAttribPointer(a_normal, 3, GL_FLOAT, GL_FALSE, 0, normalBuf.data());
             glDrawArrays(GL_TRIANGLES, 0, coordIndex);
         }
     }
-        
+
     void Polygon3DRenderer::drawBatch(const ViewState& viewState) {
         // Draw the draw datas, multiple passes may be necessary
-        BuildAndDrawBuffers(_a_color, _a_attrib, _a_coord, _a_normal, _colorBuf, _attribBuf, _coordBuf, _normalBuf, _drawDataBuffer, viewState);
+        BuildAndDrawBuffers(_a_color, _a_attrib, _a_coord, _a_extrude, _a_normal, _colorBuf, _attribBuf, _coordBuf, _extrudeBuf, _normalBuf, _drawDataBuffer, viewState);
     }
 
     const std::string Polygon3DRenderer::POLYGON3D_VERTEX_SHADER = R"GLSL(
         #version 100
         attribute vec4 a_color;
-        attribute vec4 a_coord;
+        attribute vec3 a_coord;
+        attribute vec3 a_extrude;
         attribute float a_attrib;
         attribute vec3 a_normal;
         uniform vec4 u_ambientColor;
@@ -316,7 +340,7 @@ namespace carto {
             float dotProduct = max(0.0, dot(a_normal, u_lightDir));
             vec3 lighting = vec3(a_attrib, a_attrib, a_attrib) + (u_ambientColor.rgb + u_lightColor.rgb * dotProduct) * (1.0 - a_attrib);
             v_color = a_color * vec4(lighting, 1.0);
-            gl_Position = u_mvpMat * a_coord;
+            gl_Position = u_mvpMat * vec4(a_coord + a_extrude, 1.0);
         }
     )GLSL";
 
@@ -54,10 +54,12 @@ namespace carto {
         static void BuildAndDrawBuffers(GLuint a_color,
                                         GLuint a_attrib,
                                         GLuint a_coord,
+                                        GLuint a_extrude,
                                         GLuint a_normal,
                                         std::vector<unsigned char>& colorBuf,
                                         std::vector<unsigned char>& attribBuf,
                                         std::vector<float>& coordBuf,
+                                        std::vector<float>& extrudeBuf,
                                         std::vector<float>& normalBuf,
                                         std::vector<std::shared_ptr<Polygon3DDrawData> >& drawDataBuffer,
                                         const ViewState& viewState);
@@ -75,12 +77,14 @@ namespace carto {
         std::vector<unsigned char> _colorBuf;
         std::vector<unsigned char> _attribBuf;
         std::vector<float> _coordBuf;
+        std::vector<float> _extrudeBuf;
         std::vector<float> _normalBuf;
-    
+
         std::shared_ptr<Shader> _shader;
         GLuint _a_color;
         GLuint _a_attrib;
         GLuint _a_coord;
+        GLuint _a_extrude;
         GLuint _a_normal;
         GLuint _u_ambientColor;
         GLuint _u_lightColor;
@@ -130,6 +130,18 @@ namespace carto {
         _elements.erase(std::remove(_elements.begin(), _elements.end(), element), _elements.end());
     }
     
+    void PolygonRenderer::trimBuffers() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            // Release the CPU-side vertex buffers. They are grown back to their
+            // steady-state sizes during the next frame.
+            std::vector<unsigned char>().swap(_colorBuf);
+            std::vector<float>().swap(_coordBuf);
+            std::vector<unsigned short>().swap(_indexBuf);
+        }
+        _lineRenderer.trimBuffers();
+    }
+
     void PolygonRenderer::calculateRayIntersectedElements(const std::shared_ptr<VectorLayer>& layer, const cglib::ray3<double>& ray, const ViewState& viewState, std::vector<RayIntersectedElement>& results) const {
         std::lock_guard<std::mutex> lock(_mutex);
     
@@ -160,14 +172,9 @@ namespace carto {
         }
     
         // Resize the buffers, if necessary
-        if (coordBuf.size() < totalCoordCount * 3) {
-            colorBuf.resize(std::min(totalCoordCount * 4, GLContext::MAX_VERTEXBUFFER_SIZE * 4));
-            coordBuf.resize(std::min(totalCoordCount * 3, GLContext::MAX_VERTEXBUFFER_SIZE * 3));
-        }
-    
-        if (indexBuf.size() < totalIndexCount) {
-            indexBuf.resize(std::min(totalIndexCount, GLContext::MAX_VERTEXBUFFER_SIZE));
-        }
+        GLContext::ResizeVertexBuffer(colorBuf, totalCoordCount * 4, GLContext::MAX_VERTEXBUFFER_SIZE * 4);
+        GLContext::ResizeVertexBuffer(coordBuf, totalCoordCount * 3, GLContext::MAX_VERTEXBUFFER_SIZE * 3);
+        GLContext::ResizeVertexBuffer(indexBuf, totalIndexCount, GLContext::MAX_VERTEXBUFFER_SIZE);
     
         // View state specific data
         cglib::vec3<double> cameraPos = viewState.getCameraPos();
@@ -178,7 +185,6 @@ namespace carto {
             // Draw data vertex info may be split into multiple buffers, draw each one
             for (std::size_t i = 0; i < drawData->getCoords().size(); i++) {
                 // Check for possible overflow in the buffers
-                const std::vector<cglib::vec3<double> >& coords = drawData->getCoords()[i];
                 const std::vector<unsigned int>& indices = drawData->getIndices()[i];
                 if (indices.size() > GLContext::MAX_VERTEXBUFFER_SIZE) {
                     Log::Error("PolygonRenderer::BuildAndDrawBuffers: Maximum buffer size exceeded, polygon can't be drawn");
@@ -205,16 +211,17 @@ namespace carto {
                 
                 // Colors and coords
                 const Color& color = drawData->getColor();
-                for (const cglib::vec3<double>& pos : coords) {
+                cglib::vec3<float> translate = cglib::vec3<float>::convert(drawData->getOrigins()[i] - cameraPos);
+                for (const cglib::vec3<float>& pos : drawData->getRelativeCoords()[i]) {
                     colorBuf[colorIndex + 0] = color.getR();
                     colorBuf[colorIndex + 1] = color.getG();
                     colorBuf[colorIndex + 2] = color.getB();
                     colorBuf[colorIndex + 3] = color.getA();
                     colorIndex += 4;
-                    
-                    coordBuf[coordIndex + 0] = static_cast<float>(pos(0) - cameraPos(0));
-                    coordBuf[coordIndex + 1] = static_cast<float>(pos(1) - cameraPos(1));
-                    coordBuf[coordIndex + 2] = static_cast<float>(pos(2) - cameraPos(2));
+
+                    coordBuf[coordIndex + 0] = pos(0) + translate(0);
+                    coordBuf[coordIndex + 1] = pos(1) + translate(1);
+                    coordBuf[coordIndex + 2] = pos(2) + translate(2);
                     coordIndex += 3;
                 }
             }
@@ -49,6 +49,7 @@ namespace carto {
         _viewDir(0, 0, 0),
         _mainLightDir(0, 0, 0),
         _tiles(),
+        _retainedTiles(),
         _options(),
         _mutex()
     {
@@ -125,6 +126,7 @@ namespace carto {
         _firstDraw = true;
         _horizontalLayerOffset = 0;
         _tiles.clear();
+        _retainedTiles.clear();
         GLContext::CheckGLError("TileRenderer::onSurfaceCreated");
     }
     
@@ -214,6 +216,7 @@ namespace carto {
 
         Log::Debug("TileRenderer: Surface destroyed");
 
+        _retainedTiles.clear();
         _glRenderer->resetRenderer();
         _glRenderer.reset();
     }
@@ -238,28 +241,90 @@ namespace carto {
     }
     
     bool TileRenderer::refreshTiles(const std::vector<std::shared_ptr<TileDrawData> >& drawDatas) {
-        std::lock_guard<std::mutex> lock(_mutex);
-
-        if (!_glRenderer) {
-            return false;
-        }
-
+        // Build the new tile set before taking the renderer mutex, this runs
+        // on the culling thread and must not delay the rendering thread
         std::map<vt::TileId, std::shared_ptr<const vt::Tile> > tiles;
         for (const std::shared_ptr<TileDrawData>& drawData : drawDatas) {
             tiles[drawData->getVTTileId()] = drawData->getVTTile();
         }
 
-        bool changed = (tiles != _tiles) || (_horizontalLayerOffset != 0);
-        if (changed) {
-            if (!_firstDraw) {
-                _glRenderer->setVisibleTiles(tiles, _horizontalLayerOffset == 0);
+        // Drop parent placeholder tiles that are fully covered by their children,
+        // drawing them would only add overdraw underneath the children
+        for (auto it = tiles.begin(); it != tiles.end(); ) {
+            const vt::TileId& tileId = it->first;
+            bool covered = true;
+            for (int n = 0; n < 4; n++) {
+                vt::TileId subTileId(tileId.zoom + 1, tileId.x * 2 + (n % 2), tileId.y * 2 + (n / 2));
+                if (tiles.find(subTileId) == tiles.end()) {
+                    covered = false;
+                    break;
+                }
+            }
+            if (covered) {
+                it = tiles.erase(it);
+            } else {
+                it++;
+            }
+        }
+
+        std::shared_ptr<vt::GLTileRenderer> glRenderer;
+        bool blend = false;
+        bool changed = false;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if (!_glRenderer) {
+                return false;
+            }
+
+            changed = (tiles != _tiles) || (_horizontalLayerOffset != 0);
+            if (changed) {
+                // Retain the tiles that left the draw list. The GL renderer caches tile
+                // geometry buffers per tile object, so keeping recently visible tiles alive
+                // lets tiles returning into view rebind their buffers instead of re-uploading.
+                for (auto it = _tiles.begin(); it != _tiles.end(); it++) {
+                    if (tiles.find(it->first) == tiles.end()) {
+                        retainTile(it->first, it->second);
+                    }
+                }
+                for (auto it = _retainedTiles.begin(); it != _retainedTiles.end(); ) {
+                    it = (tiles.find(it->first) != tiles.end() ? _retainedTiles.erase(it) : ++it);
+                }
+
+                if (!_firstDraw) {
+                    glRenderer = _glRenderer;
+                    blend = _horizontalLayerOffset == 0;
+                }
+                _tiles = tiles;
+                _horizontalLayerOffset = 0;
             }
-            _tiles = std::move(tiles);
-            _horizontalLayerOffset = 0;
+        }
+
+        // Push the new tile set to the GL renderer outside of the renderer mutex.
+        // The GL renderer synchronizes internally (cullLabels relies on the same),
+        // so the rendering thread is not blocked while the new tiles are ingested.
+        if (glRenderer) {
+            glRenderer->setVisibleTiles(tiles, blend);
         }
         return changed;
     }
 
+    void TileRenderer::retainTile(const vt::TileId& tileId, const std::shared_ptr<const vt::Tile>& tile) {
+        for (auto it = _retainedTiles.begin(); it != _retainedTiles.end(); it++) {
+            if (it->first == tileId) {
+                _retainedTiles.erase(it);
+                break;
+            }
+        }
+        _retainedTiles.emplace_front(tileId, tile);
+
+        std::size_t retainedBytes = 0;
+        for (auto it = _retainedTiles.begin(); it != _retainedTiles.end(); ) {
+            retainedBytes += it->second->getResidentSize();
+            it = (retainedBytes > RETAINED_TILE_BYTE_BUDGET ? _retainedTiles.erase(it) : ++it);
+        }
+    }
+
     void TileRenderer::calculateRayIntersectedElements(const cglib::ray3<double>& ray, const ViewState& viewState, std::vector<std::tuple<vt::TileId, double, long long> >& results) const {
         std::lock_guard<std::mutex> lock(_mutex);
 
@@ -311,6 +376,8 @@ namespace carto {
         }
     }
 
+    const std::size_t TileRenderer::RETAINED_TILE_BYTE_BUDGET = 16 * 1024 * 1024;
+
     const std::string TileRenderer::LIGHTING_SHADER_2D = R"GLSL(
         uniform vec3 u_lightDir;
         vec4 applyLighting(vec4 color, vec3 normal) {
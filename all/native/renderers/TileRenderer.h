@@ -10,10 +10,12 @@
 #include "graphics/Color.h"
 #include "graphics/ViewState.h"
 
+#include <list>
 #include <memory>
 #include <mutex>
 #include <map>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include <cglib/ray.h>
@@ -63,8 +65,12 @@ namespace carto {
         void calculateRayIntersectedBitmaps(const cglib::ray3<double>& ray, const ViewState& viewState, std::vector<std::tuple<vt::TileId, double, vt::TileBitmap, cglib::vec2<float> > >& results) const;
     
     private:
+        void retainTile(const vt::TileId& tileId, const std::shared_ptr<const vt::Tile>& tile);
+
         static const int CLICK_RADIUS = 4;
 
+        static const std::size_t RETAINED_TILE_BYTE_BUDGET; // limit (in bytes) for recently visible tiles kept alive for their GL buffers
+
         static const std::string LIGHTING_SHADER_2D;
         static const std::string LIGHTING_SHADER_3D;
 
@@ -80,6 +86,7 @@ namespace carto {
         cglib::vec3<float> _viewDir;
         cglib::vec3<float> _mainLightDir;
         std::map<vt::TileId, std::shared_ptr<const vt::Tile> > _tiles;
+        std::list<std::pair<vt::TileId, std::shared_ptr<const vt::Tile> > > _retainedTiles; // ordered from the most-recently visible to the least-recently visible
 
         std::weak_ptr<Options> _options;
         
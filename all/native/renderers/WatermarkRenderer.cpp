@@ -54,7 +54,11 @@ namespace carto {
         _u_mvpMat = _shader->getUniformLoc("u_mvpMat");
         _a_coord = _shader->getAttribLoc("a_coord");
         _a_texCoord = _shader->getAttribLoc("a_texCoord");
-    
+
+        // Texture binding never changes, set it once. Other uniforms are refreshed lazily
+        glUniform1i(_u_tex, 0);
+        _mvpMatChanged = true;
+
         _textureManager = textureManager;
         _watermarkBitmap.reset();
         _watermarkTex.reset();
@@ -78,8 +82,9 @@ namespace carto {
         cglib::mat4x4<float> projectionMat = cglib::ortho4_matrix(-aspectRatio, aspectRatio, -1.0f, 1.0f, -2.0f, 2.0f);
         
         _modelviewProjectionMat = projectionMat * modelviewMat;
-        
+
         _surfaceChanged = true;
+        _mvpMatChanged = true;
     }
     
     void WatermarkRenderer::onDrawFrame(const ViewState& viewState) {
@@ -180,10 +185,11 @@ namespace carto {
     void WatermarkRenderer::drawWatermark(const ViewState& viewState) {
         // Prepare for drawing
         glUseProgram(_shader->getProgId());
-        // Texture
-        glUniform1i(_u_tex, 0);
-        // Matrix
-        glUniformMatrix4fv(_u_mvpMat, 1, GL_FALSE, _modelviewProjectionMat.data());
+        // Matrix. Uniform state is retained by the program, so upload only after changes
+        if (_mvpMatChanged) {
+            glUniformMatrix4fv(_u_mvpMat, 1, GL_FALSE, _modelviewProjectionMat.data());
+            _mvpMatChanged = false;
+        }
         // Coords, texCoords, colors
         glEnableVertexAttribArray(_a_coord);
         glEnableVertexAttribArray(_a_texCoord);
@@ -56,7 +56,8 @@ namespace carto {
         cglib::mat4x4<float> _modelviewProjectionMat;
         
         bool _surfaceChanged;
-    
+        bool _mvpMatChanged;
+
         std::shared_ptr<Shader> _shader;
         GLuint _u_tex;
         GLuint _u_mvpMat;
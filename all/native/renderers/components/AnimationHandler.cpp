@@ -36,11 +36,30 @@ namespace carto {
     }
     
     void AnimationHandler::calculate(const ViewState& viewState, float deltaSeconds) {
-        std::lock_guard<std::mutex> lock(_mutex);
-        calculatePan(viewState, deltaSeconds);
-        calculateRotation(viewState, deltaSeconds);
-        calculateTilt(viewState, deltaSeconds);
-        calculateZoom(viewState, deltaSeconds);
+        CameraPanEvent panEvent;
+        CameraRotationEvent rotationEvent;
+        CameraTiltEvent tiltEvent;
+        CameraZoomEvent zoomEvent;
+        bool panActive = false;
+        bool rotationActive = false;
+        bool tiltActive = false;
+        bool zoomActive = false;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            panActive = calculatePan(panEvent, viewState, deltaSeconds);
+            rotationActive = calculateRotation(rotationEvent, viewState, deltaSeconds);
+            tiltActive = calculateTilt(tiltEvent, viewState, deltaSeconds);
+            zoomActive = calculateZoom(zoomEvent, viewState, deltaSeconds);
+        }
+
+        // Apply all the active animations as a single combined camera update,
+        // the view state is recalculated and the layers are notified only once per frame
+        if (panActive || rotationActive || tiltActive || zoomActive) {
+            _mapRenderer.calculateCameraEvents(panActive ? &panEvent : nullptr,
+                                               rotationActive ? &rotationEvent : nullptr,
+                                               tiltActive ? &tiltEvent : nullptr,
+                                               zoomActive ? &zoomEvent : nullptr);
+        }
     }
     
     void AnimationHandler::setPanTarget(const MapPos& panTarget, float durationSeconds) {
@@ -107,7 +126,7 @@ namespace carto {
         _zoomDurationSeconds = 0;
     }
     
-    void AnimationHandler::calculatePan(const ViewState& viewState, float deltaSeconds) {
+    bool AnimationHandler::calculatePan(CameraPanEvent& cameraEvent, const ViewState& viewState, float deltaSeconds) {
         // Disregard the first calculation event, because the deltaSeconds parameter may be
         // very large. It's caused by on-demand rendering.
         if (_panStarted) {
@@ -127,14 +146,14 @@ namespace carto {
                 cglib::mat4x4<double> transform = projectionSurface->calculateTranslateMatrix(pos0, pos1, ratio);
                 newFocusPos = projectionSurface->calculateMapPos(cglib::transform_point(viewState.getFocusPos(), transform));
             }
-    
-            CameraPanEvent cameraEvent;
+
             cameraEvent.setPos(newFocusPos);
-            _mapRenderer.calculateCameraEvent(cameraEvent, 0, false);
+            return true;
         }
+        return false;
     }
     
-    void AnimationHandler::calculateRotation(const ViewState& viewState, float deltaSeconds) {
+    bool AnimationHandler::calculateRotation(CameraRotationEvent& cameraEvent, const ViewState& viewState, float deltaSeconds) {
         // Disregard the first calculation event, because the deltaSeconds parameter may be
         // very large. It's caused by on-demand rendering.
         if (_rotationStarted) {
@@ -157,17 +176,17 @@ namespace carto {
                 delta *= ratio;
                 newRotation = viewState.getRotation() + delta;
             }
-        
-            CameraRotationEvent cameraEvent;
+
             cameraEvent.setRotation(newRotation);
             if (_rotationTargetPos) {
                 cameraEvent.setTargetPos(*_rotationTargetPos);
             }
-            _mapRenderer.calculateCameraEvent(cameraEvent, 0, false);
+            return true;
         }
+        return false;
     }
     
-    void AnimationHandler::calculateTilt(const ViewState& viewState, float deltaSeconds) {
+    bool AnimationHandler::calculateTilt(CameraTiltEvent& cameraEvent, const ViewState& viewState, float deltaSeconds) {
         // Disregard the first calculation event, because the deltaSeconds parameter may be
         // very large. It's caused by on-demand rendering.
         if (_tiltStarted) {
@@ -185,14 +204,14 @@ namespace carto {
                 delta *= ratio;
                 newTilt = viewState.getTilt() + delta;
             }
-    
-            CameraTiltEvent cameraEvent;
+
             cameraEvent.setTilt(newTilt);
-            _mapRenderer.calculateCameraEvent(cameraEvent, 0, false);
+            return true;
         }
+        return false;
     }
     
-    void AnimationHandler::calculateZoom(const ViewState& viewState, float deltaSeconds) {
+    bool AnimationHandler::calculateZoom(CameraZoomEvent& cameraEvent, const ViewState& viewState, float deltaSeconds) {
         // Disregard the first calculation event, because the deltaSeconds parameter may be
         // very large. It's caused by on-demand rendering.
         if (_zoomStarted) {
@@ -210,14 +229,14 @@ namespace carto {
                 delta *= ratio;
                 newZoom = viewState.getZoom() + delta;
             }
-    
-            CameraZoomEvent cameraEvent;
+
             cameraEvent.setZoom(newZoom);
             if (_zoomTargetPos) {
                 cameraEvent.setTargetPos(*_zoomTargetPos);
             }
-            _mapRenderer.calculateCameraEvent(cameraEvent, 0, false);
+            return true;
         }
+        return false;
     }
     
 }
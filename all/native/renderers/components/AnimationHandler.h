@@ -13,9 +13,13 @@
 #include <mutex>
 
 namespace carto {
+    class CameraPanEvent;
+    class CameraRotationEvent;
+    class CameraTiltEvent;
+    class CameraZoomEvent;
     class MapRenderer;
     class ViewState;
-    
+
     class AnimationHandler {
     public:
         explicit AnimationHandler(MapRenderer& mapRenderer);
@@ -37,10 +41,10 @@ namespace carto {
         void stopZoom();
     
     private:
-        void calculatePan(const ViewState& viewState, float deltaSeconds);
-        void calculateRotation(const ViewState& viewState, float deltaSeconds);
-        void calculateTilt(const ViewState& viewState, float deltaSeconds);
-        void calculateZoom(const ViewState& viewState, float deltaSeconds);
+        bool calculatePan(CameraPanEvent& cameraEvent, const ViewState& viewState, float deltaSeconds);
+        bool calculateRotation(CameraRotationEvent& cameraEvent, const ViewState& viewState, float deltaSeconds);
+        bool calculateTilt(CameraTiltEvent& cameraEvent, const ViewState& viewState, float deltaSeconds);
+        bool calculateZoom(CameraZoomEvent& cameraEvent, const ViewState& viewState, float deltaSeconds);
     
         bool _panStarted;
         float _panDurationSeconds;
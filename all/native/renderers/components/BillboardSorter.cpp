@@ -7,12 +7,16 @@
 #include "utils/Log.h"
 #include "vectorelements/Billboard.h"
 
+#include <algorithm>
+#include <cmath>
 #include <functional>
 
 namespace carto {
 
     BillboardSorter::BillboardSorter() :
-        _billboardDrawDatas()
+        _billboardDrawDatas(),
+        _lastBillboardDrawDatas(),
+        _lastSortedBillboardDrawDatas()
     {
     }
     
@@ -31,9 +35,14 @@ namespace carto {
     
     void BillboardSorter::sort(const ViewState& viewState) {
         if (_billboardDrawDatas.empty()) {
+            _lastBillboardDrawDatas.clear();
+            _lastSortedBillboardDrawDatas.clear();
             return;
         }
 
+        // Check if the same billboards were added in the same order as in the last frame
+        bool sameBillboards = (_billboardDrawDatas == _lastBillboardDrawDatas);
+
         // Special '2D' mode
         bool is2DMode = false;
         if (viewState.getTilt() == 90) {
@@ -42,30 +51,77 @@ namespace carto {
             }
         }
     
-        // Calculate billboard distances
+        // Calculate billboard distances, keep track of billboards whose sort keys moved.
+        // The stored distances act as the baseline of the last ordering decision, so they
+        // are refreshed only when a billboard is reinserted or a full sort is done. Updating
+        // them every frame would let slow continuous camera movement drift the order
+        // arbitrarily far without ever crossing the threshold
+        std::vector<double> screenBottomDistances(_billboardDrawDatas.size());
+        std::vector<double> zoomDistances(_billboardDrawDatas.size());
+        std::vector<std::size_t> movedIndices;
         const cglib::mat4x4<double>& mvpMat = viewState.getModelviewProjectionMat();
-        for (const std::shared_ptr<BillboardDrawData>& drawData : _billboardDrawDatas) {
+        for (std::size_t i = 0; i < _billboardDrawDatas.size(); i++) {
+            const std::shared_ptr<BillboardDrawData>& drawData = _billboardDrawDatas[i];
             const cglib::vec3<double>& pos = drawData->getPos();
 
             // If in 2D mode, calculate proper distance from the bottom of the screen.
+            double screenBottomDistance = viewState.getHeight();
             if (is2DMode) {
                 cglib::vec2<float> screenPos = viewState.worldToScreen(pos);
-                drawData->setScreenBottomDistance(viewState.getHeight() - std::floor(screenPos(1)));
-            } else {
-                drawData->setScreenBottomDistance(viewState.getHeight());
+                screenBottomDistance = viewState.getHeight() - std::floor(screenPos(1));
             }
-    
+
             // Calculate distance to the camera plane, adjust to zoom
             double distance = pos(0) * mvpMat(3, 0) + pos(1) * mvpMat(3, 1) + pos(2) * mvpMat(3, 2) + mvpMat(3, 3);
             double zoomDistance = distance * viewState.get2PowZoom() / viewState.getZoom0Distance();
-            drawData->setCameraPlaneZoomDistance(zoomDistance);
+
+            screenBottomDistances[i] = screenBottomDistance;
+            zoomDistances[i] = zoomDistance;
+
+            if (sameBillboards) {
+                if (screenBottomDistance != drawData->getScreenBottomDistance() ||
+                    std::abs(zoomDistance - drawData->getCameraPlaneZoomDistance()) > std::abs(zoomDistance) * CAMERA_DISTANCE_CHANGE_RATIO) {
+                    movedIndices.push_back(i);
+                }
+            }
         }
 
-        // Sort billboards
         auto distanceComparator = [](const std::shared_ptr<BillboardDrawData>& drawData1, const std::shared_ptr<BillboardDrawData>& drawData2) {
             return drawData1->isBefore(*drawData2);
         };
+
+        // If the billboard set is unchanged, try to update the order from the last frame
+        // incrementally instead of doing a full sort
+        if (sameBillboards && _lastSortedBillboardDrawDatas.size() == _billboardDrawDatas.size()) {
+            if (movedIndices.empty()) {
+                // Nothing moved beyond the threshold, the old order is still valid
+                _billboardDrawDatas = _lastSortedBillboardDrawDatas;
+                return;
+            }
+            if (movedIndices.size() * INCREMENTAL_UPDATE_RATIO <= _billboardDrawDatas.size()) {
+                // Only a few billboards moved, refresh their baselines and reinsert them at their new positions
+                for (std::size_t index : movedIndices) {
+                    const std::shared_ptr<BillboardDrawData>& drawData = _billboardDrawDatas[index];
+                    drawData->setScreenBottomDistance(screenBottomDistances[index]);
+                    drawData->setCameraPlaneZoomDistance(zoomDistances[index]);
+                    auto it = std::find(_lastSortedBillboardDrawDatas.begin(), _lastSortedBillboardDrawDatas.end(), drawData);
+                    _lastSortedBillboardDrawDatas.erase(it);
+                    it = std::upper_bound(_lastSortedBillboardDrawDatas.begin(), _lastSortedBillboardDrawDatas.end(), drawData, distanceComparator);
+                    _lastSortedBillboardDrawDatas.insert(it, drawData);
+                }
+                _billboardDrawDatas = _lastSortedBillboardDrawDatas;
+                return;
+            }
+        }
+
+        // Full sort, refresh the baseline distances of every billboard
+        for (std::size_t i = 0; i < _billboardDrawDatas.size(); i++) {
+            _billboardDrawDatas[i]->setScreenBottomDistance(screenBottomDistances[i]);
+            _billboardDrawDatas[i]->setCameraPlaneZoomDistance(zoomDistances[i]);
+        }
+        _lastBillboardDrawDatas = _billboardDrawDatas;
         std::stable_sort(_billboardDrawDatas.begin(), _billboardDrawDatas.end(), distanceComparator);
+        _lastSortedBillboardDrawDatas = _billboardDrawDatas;
     }
     
     const std::vector<std::shared_ptr<BillboardDrawData> >& BillboardSorter::getSortedBillboardDrawDatas() const {
@@ -74,4 +130,8 @@ namespace carto {
 
     const float BillboardSorter::PLANAR_ZOOM_THRESHOLD = 10.0f;
 
+    const double BillboardSorter::CAMERA_DISTANCE_CHANGE_RATIO = 0.001;
+
+    const std::size_t BillboardSorter::INCREMENTAL_UPDATE_RATIO = 8;
+
 }
@@ -29,8 +29,12 @@ namespace carto {
     
     private:
         static const float PLANAR_ZOOM_THRESHOLD;
+        static const double CAMERA_DISTANCE_CHANGE_RATIO;
+        static const std::size_t INCREMENTAL_UPDATE_RATIO;
 
         std::vector<std::shared_ptr<BillboardDrawData> > _billboardDrawDatas;
+        std::vector<std::shared_ptr<BillboardDrawData> > _lastBillboardDrawDatas;
+        std::vector<std::shared_ptr<BillboardDrawData> > _lastSortedBillboardDrawDatas;
     };
     
 }
@@ -0,0 +1,117 @@
+#include "FrameProfiler.h"
+
+#include <algorithm>
+
+#include <picojson/picojson.h>
+
+namespace carto {
+
+    FrameProfiler::FrameProfiler() :
+        _enabled(false),
+        _epochTime(std::chrono::steady_clock::now()),
+        _frameStartTime(),
+        _lastMarkTime(),
+        _samples(),
+        _sampleIndex(0),
+        _histograms(),
+        _mutex()
+    {
+    }
+
+    bool FrameProfiler::isEnabled() const {
+        return _enabled.load(std::memory_order_relaxed);
+    }
+
+    void FrameProfiler::setEnabled(bool enabled) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (enabled && !_enabled.load()) {
+            _samples.clear();
+            _sampleIndex = 0;
+            std::fill(&_histograms[0][0], &_histograms[0][0] + STAGE_COUNT * HISTOGRAM_BUCKETS, 0);
+        }
+        _enabled.store(enabled);
+    }
+
+    void FrameProfiler::startFrame() {
+        if (!isEnabled()) {
+            return;
+        }
+        _frameStartTime = _lastMarkTime = std::chrono::steady_clock::now();
+    }
+
+    void FrameProfiler::markStage(Stage stage) {
+        if (!isEnabled()) {
+            return;
+        }
+        std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
+        addSample(stage, _lastMarkTime, currentTime - _lastMarkTime);
+        _lastMarkTime = currentTime;
+    }
+
+    void FrameProfiler::endFrame() {
+        if (!isEnabled()) {
+            return;
+        }
+        addSample(STAGE_FRAME, _frameStartTime, std::chrono::steady_clock::now() - _frameStartTime);
+    }
+
+    void FrameProfiler::addSample(Stage stage, std::chrono::steady_clock::time_point startTime, std::chrono::steady_clock::duration duration) {
+        if (!isEnabled()) {
+            return;
+        }
+
+        Sample sample;
+        sample.stage = stage;
+        sample.startTimeUS = std::chrono::duration_cast<std::chrono::microseconds>(startTime - _epochTime).count();
+        sample.durationUS = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_samples.size() < MAX_SAMPLES) {
+            _samples.push_back(sample);
+        } else {
+            _samples[_sampleIndex] = sample;
+            _sampleIndex = (_sampleIndex + 1) % MAX_SAMPLES;
+        }
+
+        int bucket = 0;
+        while (bucket + 1 < HISTOGRAM_BUCKETS && sample.durationUS >= (static_cast<std::int64_t>(2) << bucket)) {
+            bucket++;
+        }
+        _histograms[stage][bucket]++;
+    }
+
+    std::string FrameProfiler::exportTrace() const {
+        picojson::array traceEvents;
+        picojson::object histograms;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            std::size_t count = _samples.size();
+            for (std::size_t i = 0; i < count; i++) {
+                const Sample& sample = _samples[count == MAX_SAMPLES ? (_sampleIndex + i) % MAX_SAMPLES : i];
+                picojson::object event;
+                event["name"] = picojson::value(STAGE_NAMES[sample.stage]);
+                event["ph"] = picojson::value("X");
+                event["ts"] = picojson::value(static_cast<double>(sample.startTimeUS));
+                event["dur"] = picojson::value(static_cast<double>(sample.durationUS));
+                event["pid"] = picojson::value(0.0);
+                event["tid"] = picojson::value(sample.stage == STAGE_CULL ? 1.0 : 0.0);
+                traceEvents.push_back(picojson::value(event));
+            }
+            for (int stage = 0; stage < STAGE_COUNT; stage++) {
+                picojson::array buckets;
+                for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+                    buckets.push_back(picojson::value(static_cast<double>(_histograms[stage][i])));
+                }
+                histograms[STAGE_NAMES[stage]] = picojson::value(buckets);
+            }
+        }
+
+        picojson::object doc;
+        doc["traceEvents"] = picojson::value(traceEvents);
+        doc["histograms"] = picojson::value(histograms);
+        return picojson::value(doc).serialize();
+    }
+
+    const char* FrameProfiler::STAGE_NAMES[] = { "cull", "resources", "viewstate", "animation", "background", "layers", "watermark", "callbacks", "frame" };
+
+}
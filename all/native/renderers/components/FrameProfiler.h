@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2016 CartoDB. All rights reserved.
+ * Copying and using this code is allowed only according
+ * to license terms, as given in https://cartodb.com/terms/
+ */
+
+#ifndef _CARTO_FRAMEPROFILER_H_
+#define _CARTO_FRAMEPROFILER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace carto {
+
+    /**
+     * A lightweight profiler for frame rendering stages. Collects per-stage timings
+     * into a rolling sample buffer and per-stage duration histograms. The collected
+     * data can be exported as a chrome://tracing compatible JSON document.
+     * Adds near-zero overhead when disabled.
+     */
+    class FrameProfiler {
+    public:
+        enum Stage {
+            STAGE_CULL = 0,
+            STAGE_RESOURCES,
+            STAGE_VIEW_STATE,
+            STAGE_ANIMATION,
+            STAGE_BACKGROUND,
+            STAGE_LAYERS,
+            STAGE_WATERMARK,
+            STAGE_CALLBACKS,
+            STAGE_FRAME
+        };
+
+        FrameProfiler();
+
+        bool isEnabled() const;
+        void setEnabled(bool enabled);
+
+        void startFrame();
+        void markStage(Stage stage);
+        void endFrame();
+
+        void addSample(Stage stage, std::chrono::steady_clock::time_point startTime, std::chrono::steady_clock::duration duration);
+
+        std::string exportTrace() const;
+
+    private:
+        struct Sample {
+            Stage stage;
+            std::int64_t startTimeUS;
+            std::int64_t durationUS;
+        };
+
+        static const int STAGE_COUNT = STAGE_FRAME + 1;
+        static const int HISTOGRAM_BUCKETS = 20; // bucket index i covers durations [2^i, 2^(i+1)) microseconds
+        static const std::size_t MAX_SAMPLES = 16384;
+
+        static const char* STAGE_NAMES[STAGE_COUNT];
+
+        std::atomic<bool> _enabled;
+        std::chrono::steady_clock::time_point _epochTime;
+        std::chrono::steady_clock::time_point _frameStartTime;
+        std::chrono::steady_clock::time_point _lastMarkTime;
+        std::vector<Sample> _samples;
+        std::size_t _sampleIndex;
+        std::uint64_t _histograms[STAGE_COUNT][HISTOGRAM_BUCKETS];
+
+        mutable std::mutex _mutex;
+    };
+
+}
+
+#endif
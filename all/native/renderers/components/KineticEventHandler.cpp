@@ -174,10 +174,20 @@ namespace carto {
                 cglib::vec3<double> pos0 = projectionSurface->calculatePosition(_panPositions.first);
                 cglib::vec3<double> pos1 = projectionSurface->calculatePosition(_panPositions.second);
                 cglib::mat4x4<double> transform = projectionSurface->calculateTranslateMatrix(pos0, pos1, _panDelta);
-                MapPos newFocusPos = projectionSurface->calculateMapPos(cglib::transform_point(viewState.getFocusPos(), transform));
-                CameraPanEvent cameraEvent;
-                cameraEvent.setPos(newFocusPos);
-                _mapRenderer.calculateCameraEvent(cameraEvent, 0, false);
+                cglib::vec3<double> focusPos = cglib::transform_point(viewState.getFocusPos(), transform);
+
+                // If the movement has decayed below a pixel, the rest of the motion tail is
+                // not perceivable, stop immediately instead of rendering it frame by frame
+                double pixelDelta = projectionSurface->calculateDistance(viewState.getFocusPos(), focusPos) / viewState.estimateWorldPixelMeasure();
+                if (pixelDelta < KINETIC_STOP_TOLERANCE_PIXELS) {
+                    _pan = false;
+                    _panDelta = 0;
+                } else {
+                    MapPos newFocusPos = projectionSurface->calculateMapPos(focusPos);
+                    CameraPanEvent cameraEvent;
+                    cameraEvent.setPos(newFocusPos);
+                    _mapRenderer.calculateCameraEvent(cameraEvent, 0, false);
+                }
             }
         }
     }
@@ -193,11 +203,22 @@ namespace carto {
                 // Calculate delta time corrected position
                 float factor = std::pow(1.0f - KINETIC_ROTATION_SLOWDOWN, deltaSeconds);
                 float newRotation = -_rotationDelta * factor + viewState.getRotation() + _rotationDelta;
-                _rotationDelta += viewState.getRotation() - newRotation;
-                CameraRotationEvent cameraEvent;
-                cameraEvent.setRotation(newRotation);
-                cameraEvent.setTargetPos(_rotationTargetPos);
-                _mapRenderer.calculateCameraEvent(cameraEvent, 0, false);
+
+                // If the step rotates the screen corners by less than a pixel, the rest of the
+                // motion tail is not perceivable, stop immediately
+                double screenRadius = 0.5 * std::sqrt(static_cast<double>(viewState.getWidth()) * viewState.getWidth() + static_cast<double>(viewState.getHeight()) * viewState.getHeight());
+                double pixelDelta = std::abs(newRotation - viewState.getRotation()) * Const::DEG_TO_RAD * screenRadius;
+                if (pixelDelta < KINETIC_STOP_TOLERANCE_PIXELS) {
+                    _rotation = false;
+                    _rotationDelta = 0;
+                    _rotationDeltaSamples.clear();
+                } else {
+                    _rotationDelta += viewState.getRotation() - newRotation;
+                    CameraRotationEvent cameraEvent;
+                    cameraEvent.setRotation(newRotation);
+                    cameraEvent.setTargetPos(_rotationTargetPos);
+                    _mapRenderer.calculateCameraEvent(cameraEvent, 0, false);
+                }
             }
         }
     }
@@ -213,15 +234,28 @@ namespace carto {
                 // Calculate delta time corrected position
                 float factor = std::pow(1.0f - KINETIC_ZOOM_SLOWDOWN, deltaSeconds);
                 float newZoom = -_zoomDelta * factor + viewState.getZoom() + _zoomDelta;
-                _zoomDelta += viewState.getZoom() - newZoom;
-                CameraZoomEvent cameraEvent;
-                cameraEvent.setZoom(newZoom);
-                cameraEvent.setTargetPos(_zoomTargetPos);
-                _mapRenderer.calculateCameraEvent(cameraEvent, 0, false);
+
+                // If the step scales the screen corners by less than a pixel, the rest of the
+                // motion tail is not perceivable, stop immediately
+                double screenRadius = 0.5 * std::sqrt(static_cast<double>(viewState.getWidth()) * viewState.getWidth() + static_cast<double>(viewState.getHeight()) * viewState.getHeight());
+                double pixelDelta = std::abs(std::pow(2.0, static_cast<double>(newZoom) - viewState.getZoom()) - 1.0) * screenRadius;
+                if (pixelDelta < KINETIC_STOP_TOLERANCE_PIXELS) {
+                    _zoom = false;
+                    _zoomDelta = 0;
+                    _zoomDeltaSamples.clear();
+                } else {
+                    _zoomDelta += viewState.getZoom() - newZoom;
+                    CameraZoomEvent cameraEvent;
+                    cameraEvent.setZoom(newZoom);
+                    cameraEvent.setTargetPos(_zoomTargetPos);
+                    _mapRenderer.calculateCameraEvent(cameraEvent, 0, false);
+                }
             }
         }
     }
     
+    const float KineticEventHandler::KINETIC_STOP_TOLERANCE_PIXELS = 0.5f;
+
     const float KineticEventHandler::KINETIC_PAN_STOP_TOLERANCE = 0.007f;
     const float KineticEventHandler::KINETIC_PAN_START_TOLERANCE = 0.025f;
     const float KineticEventHandler::KINETIC_PAN_SLOWDOWN = 0.99f;
@@ -45,6 +45,8 @@ namespace carto {
         void handleRotation(const ViewState& viewState, float deltaSeconds);
         void handleZoom(const ViewState& viewState, float deltaSeconds);
     
+        static const float KINETIC_STOP_TOLERANCE_PIXELS; // stop once the per-frame movement decays below this screen-space threshold
+
         static const float KINETIC_PAN_START_TOLERANCE;
         static const float KINETIC_PAN_STOP_TOLERANCE;
         static const float KINETIC_PAN_SLOWDOWN;
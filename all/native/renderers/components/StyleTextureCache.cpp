@@ -33,20 +33,42 @@ namespace carto {
         _textureManager = textureManager;
     }
 
-    std::shared_ptr<Texture> StyleTextureCache::get(const std::shared_ptr<Bitmap>& bitmap) {
+    void StyleTextureCache::clear() {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _cache.clear();
+    }
+
+    std::shared_ptr<Texture> StyleTextureCache::get(const std::shared_ptr<Bitmap>& bitmap, bool genMipmaps, bool repeat) {
         std::lock_guard<std::mutex> lock(_mutex);
 
         std::shared_ptr<Texture> texture;
-        _cache.read(bitmap, texture);
+        if (bitmap) {
+            _cache.read(CalculateCacheKey(bitmap, genMipmaps, repeat), texture);
+        }
         return texture;
     }
-    
+
     std::shared_ptr<Texture> StyleTextureCache::create(const std::shared_ptr<Bitmap>& bitmap, bool genMipmaps, bool repeat) {
         std::lock_guard<std::mutex> lock(_mutex);
 
-        std::shared_ptr<Texture> texture = _textureManager->createTexture(bitmap, genMipmaps, repeat);
-        _cache.put(bitmap, texture, texture->getSize());
+        // As the cache is keyed by the bitmap contents, a texture created for an equal
+        // bitmap instance may already exist and can be shared
+        long long cacheKey = CalculateCacheKey(bitmap, genMipmaps, repeat);
+        std::shared_ptr<Texture> texture;
+        if (_cache.read(cacheKey, texture)) {
+            return texture;
+        }
+        texture = _textureManager->createTexture(bitmap, genMipmaps, repeat);
+        _cache.put(cacheKey, texture, texture->getSize());
         return texture;
     }
-        
+
+    long long StyleTextureCache::CalculateCacheKey(const std::shared_ptr<Bitmap>& bitmap, bool genMipmaps, bool repeat) {
+        long long hash = bitmap->getContentHash();
+        hash = hash * 31 + (genMipmaps ? 1 : 0);
+        hash = hash * 31 + (repeat ? 1 : 0);
+        return hash;
+    }
+
 }
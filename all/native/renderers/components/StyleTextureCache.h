@@ -26,15 +26,19 @@ namespace carto {
         void setCapacity(std::size_t capacityInBytes);
 
         void setTextureManager(const std::shared_ptr<TextureManager>& textureManager);
-        
+
+        void clear();
+
         std::shared_ptr<Texture> create(const std::shared_ptr<Bitmap>& bitmap, bool genMipmaps, bool repeat);
-    
-        std::shared_ptr<Texture> get(const std::shared_ptr<Bitmap>& bitmap);
+
+        std::shared_ptr<Texture> get(const std::shared_ptr<Bitmap>& bitmap, bool genMipmaps, bool repeat);
 
     private:
+        static long long CalculateCacheKey(const std::shared_ptr<Bitmap>& bitmap, bool genMipmaps, bool repeat);
+
         std::shared_ptr<TextureManager> _textureManager;
 
-        cache::timed_lru_cache<std::shared_ptr<Bitmap>, std::shared_ptr<Texture> > _cache;
+        cache::timed_lru_cache<long long, std::shared_ptr<Texture> > _cache;
         
         mutable std::mutex _mutex;
     };
@@ -11,6 +11,7 @@
 #include "vectorelements/GeometryCollection.h"
 #include "utils/Const.h"
 #include "utils/Log.h"
+#include "utils/PoolAllocator.h"
 
 #include <utility>
 #include <algorithm>
@@ -41,15 +42,15 @@ namespace carto {
     void GeometryCollectionDrawData::addDrawData(const Geometry &geometry, const GeometryCollectionStyle &style, const Projection& projection, const ProjectionSurface& projectionSurface) {
         if (auto pointGeometry = dynamic_cast<const PointGeometry*>(&geometry)) {
             if (style.getPointStyle()) {
-                _drawDatas.push_back(std::make_shared<PointDrawData>(*pointGeometry, *style.getPointStyle(), projection, projectionSurface));
+                _drawDatas.push_back(std::allocate_shared<PointDrawData>(PoolAllocator<PointDrawData>(), *pointGeometry, *style.getPointStyle(), projection, projectionSurface));
             }
         } else if (auto lineGeometry = dynamic_cast<const LineGeometry*>(&geometry)) {
             if (style.getLineStyle()) {
-                _drawDatas.push_back(std::make_shared<LineDrawData>(*lineGeometry, *style.getLineStyle(), projection, projectionSurface));
+                _drawDatas.push_back(std::allocate_shared<LineDrawData>(PoolAllocator<LineDrawData>(), *lineGeometry, *style.getLineStyle(), projection, projectionSurface));
             }
         } else if (auto polygonGeometry = dynamic_cast<const PolygonGeometry*>(&geometry)) {
             if (style.getPolygonStyle()) {
-                _drawDatas.push_back(std::make_shared<PolygonDrawData>(*polygonGeometry, *style.getPolygonStyle(), projection, projectionSurface));
+                _drawDatas.push_back(std::allocate_shared<PolygonDrawData>(PoolAllocator<PolygonDrawData>(), *polygonGeometry, *style.getPolygonStyle(), projection, projectionSurface));
             }
         } else if (auto geomCollection = dynamic_cast<const MultiGeometry*>(&geometry)) {
             for (int i = 0; i < geomCollection->getGeometryCount(); i++) {
@@ -6,6 +6,7 @@
 #include "projections/Projection.h"
 #include "projections/ProjectionSurface.h"
 #include "styles/LineStyle.h"
+#include "styles/LineStyleBuilder.h"
 #include "vectorelements/Line.h"
 #include "vectorelements/Polygon.h"
 #include "utils/Const.h"
@@ -21,11 +22,18 @@ namespace carto {
         _bitmap(style.getBitmap()),
         _normalScale(style.getWidth() / 2),
         _clickScale(style.getClickWidth() == -1 ? std::max(1.0f, 1 + (IDEAL_CLICK_WIDTH - style.getWidth()) * CLICK_WIDTH_COEF / style.getWidth()) : style.getClickWidth()),
+        _lineJoinType(style.getLineJoinType()),
+        _lineEndType(style.getLineEndType()),
+        _width(style.getWidth()),
+        _stretchFactor(style.getStretchFactor()),
         _poses(),
+        _posNormals(),
         _coords(),
         _normals(),
         _texCoords(),
-        _indices()
+        _indices(),
+        _origins(),
+        _relativeCoords()
     {
         init(geometry.getPoses(), projection, projectionSurface, style);
     }
@@ -35,18 +43,82 @@ namespace carto {
         _bitmap(style.getBitmap()),
         _normalScale(style.getWidth() / 2),
         _clickScale(std::max(1.0f, 1 + (IDEAL_CLICK_WIDTH - style.getWidth()) * CLICK_WIDTH_COEF / style.getWidth())),
+        _lineJoinType(style.getLineJoinType()),
+        _lineEndType(style.getLineEndType()),
+        _width(style.getWidth()),
+        _stretchFactor(style.getStretchFactor()),
         _poses(),
+        _posNormals(),
         _coords(),
         _normals(),
         _texCoords(),
-        _indices()
+        _indices(),
+        _origins(),
+        _relativeCoords()
     {
         init(poses, projection, projectionSurface, style);
     }
         
+    LineDrawData::LineDrawData(const LineDrawData& lineDrawData, const LineStyle& style) :
+        VectorElementDrawData(style.getColor()),
+        _bitmap(style.getBitmap()),
+        _normalScale(style.getWidth() / 2),
+        _clickScale(style.getClickWidth() == -1 ? std::max(1.0f, 1 + (IDEAL_CLICK_WIDTH - style.getWidth()) * CLICK_WIDTH_COEF / style.getWidth()) : style.getClickWidth()),
+        _lineJoinType(style.getLineJoinType()),
+        _lineEndType(style.getLineEndType()),
+        _width(style.getWidth()),
+        _stretchFactor(style.getStretchFactor()),
+        _poses(lineDrawData._poses),
+        _posNormals(lineDrawData._posNormals),
+        _coords(),
+        _normals(),
+        _texCoords(),
+        _indices(),
+        _origins(),
+        _relativeCoords()
+    {
+        if (lineDrawData.isStyleCompatible(style)) {
+            // The vertex arrays can be reused as-is, remap the coordinate pointers to our own copy of the pose array
+            _normals = lineDrawData._normals;
+            _texCoords = lineDrawData._texCoords;
+            _indices = lineDrawData._indices;
+            _coords.resize(lineDrawData._coords.size());
+            for (std::size_t i = 0; i < lineDrawData._coords.size(); i++) {
+                _coords[i].reserve(lineDrawData._coords[i].size());
+                for (cglib::vec3<double>* pos : lineDrawData._coords[i]) {
+                    _coords[i].push_back(&_poses[pos - lineDrawData._poses.data()]);
+                }
+            }
+            _origins = lineDrawData._origins;
+            _relativeCoords = lineDrawData._relativeCoords;
+        } else {
+            // The style parameters baked into the vertex arrays differ, but the tesselation
+            // of the line can still be reused
+            buildVertexArrays(style);
+        }
+        setIsOffset(lineDrawData.isOffset());
+    }
+
     LineDrawData::~LineDrawData() {
     }
-    
+
+    bool LineDrawData::isStyleCompatible(const LineStyle& style) const {
+        // Color and width are applied at draw time, joins/caps and the bitmap are baked into the tessellation
+        if (style.getLineJoinType() != _lineJoinType || style.getLineEndType() != _lineEndType) {
+            return false;
+        }
+        if (style.getBitmap() != _bitmap) {
+            return false;
+        }
+        // Texture coordinates of textured lines depend on the width and stretch factor
+        if (_bitmap != LineStyleBuilder::GetDefaultBitmap()) {
+            if (style.getWidth() != _width || style.getStretchFactor() != _stretchFactor) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     const std::shared_ptr<Bitmap> LineDrawData::getBitmap() const {
         return _bitmap;
     }
@@ -62,7 +134,15 @@ namespace carto {
     const std::vector<std::vector<cglib::vec3<double>*> >& LineDrawData::getCoords() const {
         return _coords;
     }
-    
+
+    const std::vector<cglib::vec3<double> >& LineDrawData::getOrigins() const {
+        return _origins;
+    }
+
+    const std::vector<std::vector<cglib::vec3<float> > >& LineDrawData::getRelativeCoords() const {
+        return _relativeCoords;
+    }
+
     const std::vector<std::vector<cglib::vec4<float> > >& LineDrawData::getNormals() const {
         return _normals;
     }
@@ -79,35 +159,46 @@ namespace carto {
         for (cglib::vec3<double>& pos : _poses) {
             pos(0) += offset;
         }
+        // The relative coordinates stay valid, only the origins need to follow the poses
+        for (cglib::vec3<double>& origin : _origins) {
+            origin(0) += offset;
+        }
         setIsOffset(true);
     }
     
     void LineDrawData::init(const std::vector<MapPos>& poses, const Projection& projection, const ProjectionSurface& projectionSurface, const LineStyle& style) {
         // Calculate real coordinates and tesselate the line
-        std::vector<cglib::vec3<float> > posNormals;
         _poses.reserve(poses.size());
-        posNormals.reserve(poses.size());
+        _posNormals.reserve(poses.size());
+        const std::vector<MapPos> segmentPoses = projection.toInternal(poses);
         std::vector<MapPos> internalPoses;
-        for (std::size_t i = 1; i < poses.size(); i++) {
+        for (std::size_t i = 1; i < segmentPoses.size(); i++) {
             internalPoses.clear();
-            projectionSurface.tesselateSegment(projection.toInternal(poses[i - 1]), projection.toInternal(poses[i]), internalPoses);
+            projectionSurface.tesselateSegment(segmentPoses[i - 1], segmentPoses[i], internalPoses);
             for (const MapPos& internalPos : internalPoses) {
                 cglib::vec3<double> pos = projectionSurface.calculatePosition(internalPos);
                 if (_poses.empty() || pos != _poses.back()) {
                     _poses.push_back(pos);
-                    posNormals.push_back(cglib::vec3<float>::convert(projectionSurface.calculateNormal(internalPos)));
+                    _posNormals.push_back(cglib::vec3<float>::convert(projectionSurface.calculateNormal(internalPos)));
                 }
             }
         }
 
+        buildVertexArrays(style);
+    }
+
+    void LineDrawData::buildVertexArrays(const LineStyle& style) {
+        _coords.clear();
+        _normals.clear();
+        _texCoords.clear();
+        _indices.clear();
+        _origins.clear();
+        _relativeCoords.clear();
+
         if (_poses.size() < 2) {
-            _coords.clear();
-            _normals.clear();
-            _texCoords.clear();
-            _indices.clear();
             return;
         }
-    
+
         // Detect looped line
         bool loopedLine = (_poses.front() == _poses.back()) && (_poses.size() > 2);
 
@@ -135,7 +226,7 @@ namespace carto {
                 double dot = cglib::dot_product(prevLineVec, nextLineVec);
                 if (cglib::norm(prevLineVec) > 0) {
                     float deltaAngle = static_cast<float>(std::acos(std::max(-1.0, std::min(1.0, dot))) * Const::RAD_TO_DEG);
-                    if (cglib::dot_product(posNormals[i], cglib::vector_product(prevLineVec, nextLineVec)) < 0) {
+                    if (cglib::dot_product(_posNormals[i], cglib::vector_product(prevLineVec, nextLineVec)) < 0) {
                         deltaAngle = -deltaAngle;
                     }
                     deltaAngles[i - 1] = deltaAngle;
@@ -181,14 +272,14 @@ namespace carto {
 
         // Calculate initial state for line string
         cglib::vec3<float> nextLine = cglib::vec3<float>::convert(_poses[1] - _poses[0]);
-        cglib::vec3<float> nextPerpVec = cglib::unit(cglib::vector_product(posNormals[1], nextLine));
+        cglib::vec3<float> nextPerpVec = cglib::unit(cglib::vector_product(_posNormals[1], nextLine));
 
         cglib::vec3<float> nextNormalVec = nextPerpVec;
         bool resetNormalVec = true;
         if (style.getLineJoinType() == LineJoinType::LINE_JOIN_TYPE_MITER) {
             if (loopedLine) {
                 cglib::vec3<float> prevLine = cglib::vec3<float>::convert(_poses[0] - _poses[_poses.size() - 2]);
-                cglib::vec3<float> prevPerpVec = cglib::unit(cglib::vector_product(posNormals[0], prevLine));
+                cglib::vec3<float> prevPerpVec = cglib::unit(cglib::vector_product(_posNormals[0], prevLine));
 
                 float dot = cglib::dot_product(prevPerpVec, nextPerpVec);
                 if (dot >= LINE_JOIN_MIN_MITER_DOT) {
@@ -211,7 +302,7 @@ namespace carto {
 
             // Calculate line body
             cglib::vec3<float> prevLine = cglib::vec3<float>::convert(pos - prevPos);
-            cglib::vec3<float> prevPerpVec = cglib::unit(cglib::vector_product(posNormals[i], prevLine));
+            cglib::vec3<float> prevPerpVec = cglib::unit(cglib::vector_product(_posNormals[i], prevLine));
 
             // Trick to reuse already generated vertex data (only for mitered lines)
             if (!resetNormalVec && vertexIndex >= 2) {
@@ -231,7 +322,7 @@ namespace carto {
             if (style.getLineJoinType() == LineJoinType::LINE_JOIN_TYPE_MITER) {
                 if (i + 1 < _poses.size() || loopedLine) {
                     cglib::vec3<float> nextLine = cglib::vec3<float>::convert(nextPos - pos);
-                    cglib::vec3<float> nextPerpVec = cglib::unit(cglib::vector_product(posNormals[i1], nextLine));
+                    cglib::vec3<float> nextPerpVec = cglib::unit(cglib::vector_product(_posNormals[i1], nextLine));
 
                     float dot = cglib::dot_product(prevPerpVec, nextPerpVec);
                     if (dot >= LINE_JOIN_MIN_MITER_DOT) {
@@ -295,7 +386,7 @@ namespace carto {
                 if (segments > 0) {
                     float segmentDeltaAngle = deltaAngle / segments;
                     cglib::mat2x2<float> rot2DMat = cglib::rotate2_matrix(static_cast<float>(segmentDeltaAngle * Const::DEG_TO_RAD));
-                    cglib::mat3x3<float> rot3DMat = cglib::rotate3_matrix(posNormals[i], static_cast<float>(segmentDeltaAngle * Const::DEG_TO_RAD));
+                    cglib::mat3x3<float> rot3DMat = cglib::rotate3_matrix(_posNormals[i], static_cast<float>(segmentDeltaAngle * Const::DEG_TO_RAD));
                     bool leftTurn = (deltaAngle <= 0);
                     cglib::vec3<float> rotVec = prevNormalVec;
                     
@@ -361,7 +452,7 @@ namespace carto {
                 
                 if (style.getLineEndType() == LineEndType::LINE_END_TYPE_ROUND) {
                     // Last end point, lastLine contains the last valid line segment
-                    cglib::mat3x3<float> rot3DMat = cglib::rotate3_matrix(posNormals[_poses.size() - 1], static_cast<float>(segmentDeltaAngle * Const::DEG_TO_RAD));
+                    cglib::mat3x3<float> rot3DMat = cglib::rotate3_matrix(_posNormals[_poses.size() - 1], static_cast<float>(segmentDeltaAngle * Const::DEG_TO_RAD));
                     cglib::vec3<float> rotVec = lastPerpVec;
                     cglib::vec2<float> uvRotVec(-1, 0);
                 
@@ -376,7 +467,7 @@ namespace carto {
                 } else {
                     // Vertices
                     for (int s = -1; s <= 1; s += 2) {
-                        cglib::mat3x3<float> rot3DMat = cglib::rotate3_matrix(posNormals[_poses.size() - 1], static_cast<float>(-s * segmentDeltaAngle * Const::DEG_TO_RAD));
+                        cglib::mat3x3<float> rot3DMat = cglib::rotate3_matrix(_posNormals[_poses.size() - 1], static_cast<float>(-s * segmentDeltaAngle * Const::DEG_TO_RAD));
                         cglib::vec3<float> normalVec = cglib::transform(lastPerpVec, rot3DMat) * std::sqrt(2.0f);
                         coords.push_back(&_poses[_poses.size() - 1]);
                         normals.push_back(cglib::expand(normalVec, static_cast<float>(s)));
@@ -399,7 +490,7 @@ namespace carto {
                 
                 if (style.getLineEndType() == LineEndType::LINE_END_TYPE_ROUND) {
                     // First end point, firstLine contains the first valid line segment
-                    cglib::mat3x3<float> rot3DMat = cglib::rotate3_matrix(posNormals[0], static_cast<float>(segmentDeltaAngle * Const::DEG_TO_RAD));
+                    cglib::mat3x3<float> rot3DMat = cglib::rotate3_matrix(_posNormals[0], static_cast<float>(segmentDeltaAngle * Const::DEG_TO_RAD));
                     cglib::vec3<float> rotVec = firstPerpVec;
                     cglib::vec2<float> uvRotVec(1, 0);
                 
@@ -414,7 +505,7 @@ namespace carto {
                 } else {
                     // Vertices
                     for (int s = 1; s >= -1; s -= 2) {
-                        cglib::mat3x3<float> rot3DMat = cglib::rotate3_matrix(posNormals[0], static_cast<float>(s * segmentDeltaAngle * Const::DEG_TO_RAD));
+                        cglib::mat3x3<float> rot3DMat = cglib::rotate3_matrix(_posNormals[0], static_cast<float>(s * segmentDeltaAngle * Const::DEG_TO_RAD));
                         cglib::vec3<float> normalVec = cglib::transform(firstPerpVec, rot3DMat) * std::sqrt(2.0f);
                         coords.push_back(&_poses[0]);
                         normals.push_back(cglib::expand(normalVec, static_cast<float>(s)));
@@ -490,6 +581,20 @@ namespace carto {
         _normals.back().shrink_to_fit();
         _texCoords.back().shrink_to_fit();
         _indices.back().shrink_to_fit();
+
+        // Cache per-buffer origins and origin-relative coordinates for the draw path
+        _origins.reserve(_coords.size());
+        _relativeCoords.reserve(_coords.size());
+        for (const std::vector<cglib::vec3<double>*>& bufferCoords : _coords) {
+            cglib::vec3<double> origin = bufferCoords.empty() ? cglib::vec3<double>::zero() : *bufferCoords.front();
+            std::vector<cglib::vec3<float> > relativeCoords;
+            relativeCoords.reserve(bufferCoords.size());
+            for (const cglib::vec3<double>* pos : bufferCoords) {
+                relativeCoords.push_back(cglib::vec3<float>::convert(*pos - origin));
+            }
+            _origins.push_back(origin);
+            _relativeCoords.push_back(std::move(relativeCoords));
+        }
     }
     
     const float LineDrawData::LINE_ENDPOINT_TESSELATION_FACTOR = 0.004f;
@@ -8,6 +8,7 @@
 #define _CARTO_LINEDRAWDATA_H_
 
 #include "renderers/drawdatas/VectorElementDrawData.h"
+#include "styles/LineStyle.h"
 
 #include <memory>
 #include <vector>
@@ -17,18 +18,20 @@
 namespace carto {
     class Bitmap;
     class LineGeometry;
-    class LineStyle;
     class MapPos;
     class PolygonGeometry;
     class Projection;
     class ProjectionSurface;
-    
+
     class LineDrawData : public VectorElementDrawData {
     public:
         LineDrawData(const LineGeometry& geometry, const LineStyle& style, const Projection& projection, const ProjectionSurface& projectionSurface);
         LineDrawData(const std::vector<MapPos>& poses, const LineStyle& style, const Projection& projection, const ProjectionSurface& projectionSurface);
+        LineDrawData(const LineDrawData& lineDrawData, const LineStyle& style);
         virtual ~LineDrawData();
-    
+
+        bool isStyleCompatible(const LineStyle& style) const;
+
         const std::shared_ptr<Bitmap> getBitmap() const;
 
         float getNormalScale() const;
@@ -36,7 +39,11 @@ namespace carto {
         float getClickScale() const;
     
         const std::vector<std::vector<cglib::vec3<double>*> >& getCoords() const;
-    
+
+        const std::vector<cglib::vec3<double> >& getOrigins() const;
+
+        const std::vector<std::vector<cglib::vec3<float> > >& getRelativeCoords() const;
+
         const std::vector<std::vector<cglib::vec4<float> > >& getNormals() const;
     
         const std::vector<std::vector<cglib::vec2<float> > >& getTexCoords() const;
@@ -55,22 +62,37 @@ namespace carto {
         static const float CLICK_WIDTH_COEF;
         
         void init(const std::vector<MapPos>& poses, const Projection& projection, const ProjectionSurface& projectionSurface, const LineStyle& style);
-    
+        void buildVertexArrays(const LineStyle& style);
+
         std::shared_ptr<Bitmap> _bitmap;
-    
+
         float _normalScale;
 
         float _clickScale;
-    
-        // Actual line coordinates
+
+        // Style parameters baked into the tessellation
+        LineJoinType::LineJoinType _lineJoinType;
+        LineEndType::LineEndType _lineEndType;
+        float _width;
+        float _stretchFactor;
+
+        // Actual line coordinates and surface normals from the tesselation,
+        // kept so that restyling can rebuild the vertex arrays without re-tesselating
         std::vector<cglib::vec3<double> > _poses;
-    
+        std::vector<cglib::vec3<float> > _posNormals;
+
         // Origin point and normal for each vertex
         std::vector<std::vector<cglib::vec3<double>*> > _coords;
         std::vector<std::vector<cglib::vec4<float> > > _normals;
         std::vector<std::vector<cglib::vec2<float> > > _texCoords;
     
         std::vector<std::vector<unsigned int> > _indices;
+
+        // Per-buffer origin and origin-relative coordinates. The renderer translates each
+        // buffer by (origin - cameraPos) once and adds the small relative offsets in float
+        // precision, instead of converting every vertex from doubles at draw time
+        std::vector<cglib::vec3<double> > _origins;
+        std::vector<std::vector<cglib::vec3<float> > > _relativeCoords;
     };
     
 }
@@ -5,12 +5,13 @@
 
 namespace carto {
 
-    NMLModelLODTreeDrawData::NMLModelLODTreeDrawData(const std::shared_ptr<NMLModelLODTree>& modelLODTree, long long nodeId, const std::vector<long long>& parentIds, const std::shared_ptr<nml::GLModel>& glModel, const ProjectionSurface& projectionSurface) :
+    NMLModelLODTreeDrawData::NMLModelLODTreeDrawData(const std::shared_ptr<NMLModelLODTree>& modelLODTree, long long nodeId, const std::vector<long long>& parentIds, const std::shared_ptr<nml::GLModel>& glModel, std::size_t glSize, const ProjectionSurface& projectionSurface) :
         _modelLODTree(modelLODTree),
         _nodeId(nodeId),
         _parentIds(parentIds),
         _localMat(),
         _glModel(glModel),
+        _glSize(glSize),
         _proxyMap(modelLODTree->getProxyMap()),
         _isOffset(false)
     {
@@ -41,7 +42,11 @@ namespace carto {
     const std::shared_ptr<nml::GLModel>& NMLModelLODTreeDrawData::getGLModel() const {
         return _glModel;
     }
-    
+
+    std::size_t NMLModelLODTreeDrawData::getGLSize() const {
+        return _glSize;
+    }
+
     const std::shared_ptr<NMLModelLODTree::ProxyMap> NMLModelLODTreeDrawData::getProxyMap() const {
         return _proxyMap;
     }
@@ -23,14 +23,15 @@ namespace carto {
     
     class NMLModelLODTreeDrawData {
     public:
-        NMLModelLODTreeDrawData(const std::shared_ptr<NMLModelLODTree>& modelLODTree, long long nodeId, const std::vector<long long>& parentIds, const std::shared_ptr<nml::GLModel>& glModel, const ProjectionSurface& projectionSurface);
+        NMLModelLODTreeDrawData(const std::shared_ptr<NMLModelLODTree>& modelLODTree, long long nodeId, const std::vector<long long>& parentIds, const std::shared_ptr<nml::GLModel>& glModel, std::size_t glSize, const ProjectionSurface& projectionSurface);
         ~NMLModelLODTreeDrawData();
-    
+
         std::shared_ptr<NMLModelLODTree> getModelLODTree() const;
         long long getNodeId() const;
         const std::vector<long long>& getParentIds() const;
         const cglib::mat4x4<double>& getLocalMat() const;
         const std::shared_ptr<nml::GLModel>& getGLModel() const;
+        std::size_t getGLSize() const;
         const std::shared_ptr<NMLModelLODTree::ProxyMap> getProxyMap() const;
         
         bool isOffset() const;
@@ -42,6 +43,7 @@ namespace carto {
         std::vector<long long> _parentIds;
         cglib::mat4x4<double> _localMat;
         std::shared_ptr<nml::GLModel> _glModel;
+        std::size_t _glSize;
         std::shared_ptr<NMLModelLODTree::ProxyMap> _proxyMap;
         bool _isOffset;
     };
@@ -18,18 +18,46 @@
 
 namespace carto {
 
-    Polygon3DDrawData::Polygon3DDrawData(const Polygon3D& polygon3D, const Polygon3DStyle& style, const Projection& projection, const ProjectionSurface& projectionSurface) :
+    Polygon3DDrawData::Polygon3DDrawData(const Polygon3D& polygon3D, const Polygon3DStyle& style, const Projection& projection, const ProjectionSurface& projectionSurface, const std::shared_ptr<Polygon3DDrawData>& prevDrawData) :
         VectorElementDrawData(style.getColor()),
         _sideColor(GetPremultipliedColor(style.getSideColor())),
+        _geometry(polygon3D.getGeometry()),
+        _height(static_cast<float>(projection.toInternal(MapPos(0, 0, polygon3D.getHeight())).getZ())),
         _boundingBox(cglib::bbox3<double>::smallest()),
         _coords(),
+        _extrusionVecs(),
         _normals(),
         _attribs()
     {
-        const std::vector<MapPos>& poses = polygon3D.getGeometry()->getPoses();
-        const std::vector<std::vector<MapPos> >& holes = polygon3D.getGeometry()->getHoles();
-        float height = polygon3D.getHeight();
-        
+        // The base geometry depends only on the footprint and extrusion is applied at render
+        // time, so if the footprint did not change, the previous tesselation can be reused.
+        // This makes height-only restyling (for example, data-driven height animation) cheap.
+        // The coordinates depend on the projection surface, so after a surface switch everything is rebuilt.
+        if (prevDrawData && prevDrawData->_geometry == _geometry && !prevDrawData->isOffset() && prevDrawData->getProjectionSurface().get() == &projectionSurface) {
+            _coords = prevDrawData->_coords;
+            _extrusionVecs = prevDrawData->_extrusionVecs;
+            _normals = prevDrawData->_normals;
+            _attribs = prevDrawData->_attribs;
+        } else if (!buildGeometry(projection, projectionSurface)) {
+            return;
+        }
+
+        // Update bounding box based on the base and fully extruded coordinates
+        for (std::size_t i = 0; i < _coords.size(); i++) {
+            _boundingBox.add(_coords[i]);
+            _boundingBox.add(_coords[i] + cglib::vec3<double>::convert(_extrusionVecs[i]) * static_cast<double>(_height));
+        }
+
+        // Do sanity check on the size
+        if (_coords.size() > GLContext::MAX_VERTEXBUFFER_SIZE) {
+            Log::Error("Polygon3DDrawData::Polygon3DDrawData: Maximum buffer size exceeded, 3d polygon can't be drawn");
+        }
+    }
+
+    bool Polygon3DDrawData::buildGeometry(const Projection& projection, const ProjectionSurface& projectionSurface) {
+        const std::vector<MapPos>& poses = _geometry->getPoses();
+        const std::vector<std::vector<MapPos> >& holes = _geometry->getHoles();
+
         // Create tesselator
         TESSalloc ma;
         ma.memalloc = [](void* userData, unsigned int size) { return malloc(size); };
@@ -37,27 +65,26 @@ namespace carto {
         ma.extraVertices = 256;
         TESStesselator* tessPtr = tessNewTess(&ma);
         if (!tessPtr) {
-            Log::Error("Polygon3DDrawData::Polygon3DDrawData: Failed to created tesselator!");
-            return;
+            Log::Error("Polygon3DDrawData::buildGeometry: Failed to created tesselator!");
+            return false;
         }
         std::shared_ptr<TESStesselator> tess(tessPtr, tessDeleteTess);
-    
+
         // Prepare polygon exterior
         std::vector<std::vector<MapPos> > ringsInternalPoses(1 + holes.size());
         ringsInternalPoses[0].reserve(poses.size());
-        
+
         std::vector<double> posesArray(poses.size() * 3);
         for (std::size_t i = 0; i < poses.size(); i++) {
-            MapPos pos = poses[i];
-            pos.setZ(height);
-            MapPos internalPos = projection.toInternal(pos);
+            MapPos internalPos = projection.toInternal(poses[i]);
+            internalPos.setZ(0);
             posesArray[i * 3 + 0] = internalPos.getX();
             posesArray[i * 3 + 1] = internalPos.getY();
             posesArray[i * 3 + 2] = internalPos.getZ();
             ringsInternalPoses[0].push_back(internalPos);
         }
         tessAddContour(tess.get(), 3, posesArray.data(), sizeof(double) * 3, static_cast<unsigned int>(poses.size()));
-    
+
         // Prepare polygon holes
         std::vector<std::vector<double> > holesArray(holes.size());
         for (std::size_t n = 0; n < holes.size(); n++) {
@@ -65,9 +92,8 @@ namespace carto {
             std::vector<double>& holeArray = holesArray[n];
             holeArray.resize(hole.size() * 3);
             for (std::size_t i = 0; i < hole.size(); i++) {
-                MapPos pos = hole[i];
-                pos.setZ(height);
-                MapPos internalPos = projection.toInternal(pos);
+                MapPos internalPos = projection.toInternal(hole[i]);
+                internalPos.setZ(0);
                 holeArray[i * 3 + 0] = internalPos.getX();
                 holeArray[i * 3 + 1] = internalPos.getY();
                 holeArray[i * 3 + 2] = internalPos.getZ();
@@ -75,18 +101,18 @@ namespace carto {
             }
             tessAddContour(tess.get(), 3, holeArray.data(), sizeof(double) * 3, static_cast<unsigned int>(hole.size()));
         }
-    
+
         // Triangulate
         double normal[3] = { 0, 0, 1 };
         if (!tessTesselate(tess.get(), TESS_WINDING_ODD, TESS_POLYGONS, 3, 3, normal)) {
-            Log::Error("Polygon3DDrawData::Polygon3DDrawData: Failed to triangulate 3d polygon!");
-            return;
+            Log::Error("Polygon3DDrawData::buildGeometry: Failed to triangulate 3d polygon!");
+            return false;
         }
         const double* roofCoords = tessGetVertices(tess.get());
         const int* roofElements = tessGetElements(tess.get());
         std::size_t roofVertexCount = tessGetVertexCount(tess.get());
         std::size_t roofElementCount = tessGetElementCount(tess.get());
-    
+
         // Do projection-surface based tesselation
         std::vector<MapPos> roofInternalPoses;
         roofInternalPoses.reserve(roofVertexCount);
@@ -116,20 +142,39 @@ namespace carto {
             }
             std::swap(ringInternalPoses, tesselatedPoses);
         }
-        
+
         // Reserve space for roof and sides
         std::size_t edgeVertexCount = std::accumulate(ringsInternalPoses.begin(), ringsInternalPoses.end(), std::size_t(0), [](std::size_t count, const std::vector<MapPos>& ringInternalPoses) { return count + ringInternalPoses.size(); });
         _coords.reserve(roofIndices.size() + edgeVertexCount * 6);
+        _extrusionVecs.reserve(roofIndices.size() + edgeVertexCount * 6);
         _normals.reserve(roofIndices.size() + edgeVertexCount * 6);
-        
+        _attribs.reserve(roofIndices.size() + edgeVertexCount * 6);
+
+        // Precalculate positions, extrusion vectors and normals for the shared roof vertices.
+        // The projection surfaces are linear in the internal z coordinate, so the offset of a
+        // unit-height position can be scaled by the actual height when extruding.
+        std::vector<cglib::vec3<double> > roofPositions;
+        std::vector<cglib::vec3<float> > roofExtrusionVecs;
+        std::vector<cglib::vec3<float> > roofNormals;
+        roofPositions.reserve(roofInternalPoses.size());
+        roofExtrusionVecs.reserve(roofInternalPoses.size());
+        roofNormals.reserve(roofInternalPoses.size());
+        for (const MapPos& internalPos : roofInternalPoses) {
+            cglib::vec3<double> pos = projectionSurface.calculatePosition(internalPos);
+            roofPositions.push_back(pos);
+            roofExtrusionVecs.push_back(cglib::vec3<float>::convert(projectionSurface.calculatePosition(MapPos(internalPos.getX(), internalPos.getY(), 1)) - pos));
+            roofNormals.push_back(cglib::vec3<float>::convert(projectionSurface.calculateNormal(internalPos)));
+        }
+
         // Convert triangulator output to coord array
         for (std::size_t i = 0; i < roofIndices.size(); i++) {
             std::size_t index = roofIndices[i];
-            _coords.push_back(projectionSurface.calculatePosition(roofInternalPoses[index]));
-            _normals.push_back(cglib::vec3<float>::convert(projectionSurface.calculateNormal(roofInternalPoses[index])));
+            _coords.push_back(roofPositions[index]);
+            _extrusionVecs.push_back(roofExtrusionVecs[index]);
+            _normals.push_back(roofNormals[index]);
             _attribs.push_back(1);
         }
-        
+
         // Calculate sides
         for (std::size_t n = 0; n < ringsInternalPoses.size(); n++) {
             const std::vector<MapPos>& ringInternalPoses = ringsInternalPoses[n];
@@ -138,22 +183,40 @@ namespace carto {
             bool clockWise = GeomUtils::IsConcavePolygonClockwise(ringInternalPoses);
             // If calculating a whole, reverse the direction
             bool flipOrder = (n > 0 ? !clockWise : clockWise);
-            
+
+            // Precalculate base positions and extrusion vectors for the shared ring vertices
+            std::vector<cglib::vec3<double> > ringPositions;
+            std::vector<cglib::vec3<float> > ringExtrusionVecs;
+            ringPositions.reserve(ringInternalPoses.size());
+            ringExtrusionVecs.reserve(ringInternalPoses.size());
+            for (const MapPos& internalPos : ringInternalPoses) {
+                cglib::vec3<double> pos = projectionSurface.calculatePosition(internalPos);
+                ringPositions.push_back(pos);
+                ringExtrusionVecs.push_back(cglib::vec3<float>::convert(projectionSurface.calculatePosition(MapPos(internalPos.getX(), internalPos.getY(), 1)) - pos));
+            }
+
             for (std::size_t j = 1; j < ringInternalPoses.size(); j++) {
-                const MapPos& internalPos0 = ringInternalPoses[(flipOrder ? j : j - 1)];
-                const MapPos& internalPos1 = ringInternalPoses[(flipOrder ? j - 1 : j)];
-                cglib::vec3<double> p0r = projectionSurface.calculatePosition(internalPos0);
-                cglib::vec3<double> p1r = projectionSurface.calculatePosition(internalPos1);
-                cglib::vec3<double> p0b = projectionSurface.calculatePosition(MapPos(internalPos0.getX(), internalPos0.getY(), 0));
-                cglib::vec3<double> p1b = projectionSurface.calculatePosition(MapPos(internalPos1.getX(), internalPos1.getY(), 0));
-
-                // Add coordinates for 2 triangles
-                _coords.push_back(p0r);
-                _coords.push_back(p0b);
-                _coords.push_back(p1r);
-                _coords.push_back(p0b);
-                _coords.push_back(p1b);
-                _coords.push_back(p1r);
+                std::size_t i0 = (flipOrder ? j : j - 1);
+                std::size_t i1 = (flipOrder ? j - 1 : j);
+                const MapPos& internalPos0 = ringInternalPoses[i0];
+                const MapPos& internalPos1 = ringInternalPoses[i1];
+                const cglib::vec3<double>& p0 = ringPositions[i0];
+                const cglib::vec3<double>& p1 = ringPositions[i1];
+
+                // Add coordinates for 2 triangles, top vertices carry the extrusion vector
+                cglib::vec3<float> zeroVec(0, 0, 0);
+                _coords.push_back(p0);
+                _extrusionVecs.push_back(ringExtrusionVecs[i0]);
+                _coords.push_back(p0);
+                _extrusionVecs.push_back(zeroVec);
+                _coords.push_back(p1);
+                _extrusionVecs.push_back(ringExtrusionVecs[i1]);
+                _coords.push_back(p0);
+                _extrusionVecs.push_back(zeroVec);
+                _coords.push_back(p1);
+                _extrusionVecs.push_back(zeroVec);
+                _coords.push_back(p1);
+                _extrusionVecs.push_back(ringExtrusionVecs[i1]);
 
                 // Calculate side normal
                 cglib::vec3<double> normal = projectionSurface.calculateNormal(internalPos0);
@@ -167,14 +230,7 @@ namespace carto {
                 }
             }
         }
-
-        // Update bounding box based on calculated coordinates
-        _boundingBox.add(_coords.begin(), _coords.end());
-        
-        // Do sanity check on the size
-        if (_coords.size() > GLContext::MAX_VERTEXBUFFER_SIZE) {
-            Log::Error("Polygon3DDrawData::Polygon3DDrawData: Maximum buffer size exceeded, 3d polygon can't be drawn");
-        }
+        return true;
     }
     
     Polygon3DDrawData::~Polygon3DDrawData() {
@@ -188,10 +244,18 @@ namespace carto {
         return _boundingBox;
     }
 
+    float Polygon3DDrawData::getHeight() const {
+        return _height;
+    }
+
     const std::vector<cglib::vec3<double> >& Polygon3DDrawData::getCoords() const {
         return _coords;
     }
-    
+
+    const std::vector<cglib::vec3<float> >& Polygon3DDrawData::getExtrusionVecs() const {
+        return _extrusionVecs;
+    }
+
     const std::vector<cglib::vec3<float> >& Polygon3DDrawData::getNormals() const {
         return _normals;
     }
@@ -18,33 +18,46 @@
 namespace carto {
     class Polygon3D;
     class Polygon3DStyle;
+    class PolygonGeometry;
     class Projection;
     class ProjectionSurface;
-    
+
     class Polygon3DDrawData : public VectorElementDrawData {
     public:
-        Polygon3DDrawData(const Polygon3D& polygon3D, const Polygon3DStyle& style, const Projection& projection, const ProjectionSurface& projectionSurface);
+        Polygon3DDrawData(const Polygon3D& polygon3D, const Polygon3DStyle& style, const Projection& projection, const ProjectionSurface& projectionSurface, const std::shared_ptr<Polygon3DDrawData>& prevDrawData);
         virtual ~Polygon3DDrawData();
 
         const Color& getSideColor() const;
-    
+
         const cglib::bbox3<double>& getBoundingBox() const;
-    
+
+        float getHeight() const;
+
         const std::vector<cglib::vec3<double> >& getCoords() const;
-    
+
+        const std::vector<cglib::vec3<float> >& getExtrusionVecs() const;
+
         const std::vector<cglib::vec3<float> >& getNormals() const;
 
         const std::vector<unsigned char>& getAttribs() const;
-    
+
         virtual void offsetHorizontally(double offset);
-    
+
     private:
+        bool buildGeometry(const Projection& projection, const ProjectionSurface& projectionSurface);
+
         Color _sideColor;
-    
+
+        std::shared_ptr<const PolygonGeometry> _geometry;
+
+        float _height;
+
         cglib::bbox3<double> _boundingBox;
-    
+
         std::vector<cglib::vec3<double> > _coords;
 
+        std::vector<cglib::vec3<float> > _extrusionVecs;
+
         std::vector<cglib::vec3<float> > _normals;
 
         std::vector<unsigned char> _attribs;
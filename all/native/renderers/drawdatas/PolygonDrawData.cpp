@@ -10,6 +10,7 @@
 #include "vectorelements/Polygon.h"
 #include "utils/Const.h"
 #include "utils/Log.h"
+#include "utils/PoolAllocator.h"
 
 #include <cmath>
 #include <cstdlib>
@@ -22,14 +23,49 @@ namespace carto {
     PolygonDrawData::PolygonDrawData(const PolygonGeometry& geometry, const PolygonStyle& style, const Projection& projection, const ProjectionSurface& projectionSurface) :
         VectorElementDrawData(style.getColor()),
         _bitmap(style.getBitmap()),
+        _geometry(),
         _boundingBox(cglib::bbox3<double>::smallest()),
         _coords(),
+        _origins(),
+        _relativeCoords(),
         _indices(),
         _lineDrawDatas()
     {
+        buildGeometry(geometry, projection, projectionSurface);
+        buildLineDrawDatas(geometry, style, projection, projectionSurface);
+    }
+
+    PolygonDrawData::PolygonDrawData(const Polygon& polygon, const PolygonStyle& style, const Projection& projection, const ProjectionSurface& projectionSurface, const std::shared_ptr<PolygonDrawData>& prevDrawData) :
+        VectorElementDrawData(style.getColor()),
+        _bitmap(style.getBitmap()),
+        _geometry(polygon.getGeometry()),
+        _boundingBox(cglib::bbox3<double>::smallest()),
+        _coords(),
+        _origins(),
+        _relativeCoords(),
+        _indices(),
+        _lineDrawDatas()
+    {
+        // Triangulation depends only on the geometry, so if the geometry instance did not
+        // change, the triangulation of the previous draw data can be reused and only the
+        // style-dependent parts need to be rebuilt. The coordinates depend on the projection
+        // surface, so after a surface switch everything is rebuilt.
+        if (prevDrawData && prevDrawData->_geometry == _geometry && !prevDrawData->isOffset() && prevDrawData->getProjectionSurface().get() == &projectionSurface) {
+            _boundingBox = prevDrawData->_boundingBox;
+            _coords = prevDrawData->_coords;
+            _origins = prevDrawData->_origins;
+            _relativeCoords = prevDrawData->_relativeCoords;
+            _indices = prevDrawData->_indices;
+        } else {
+            buildGeometry(*_geometry, projection, projectionSurface);
+        }
+        buildLineDrawDatas(*_geometry, style, projection, projectionSurface);
+    }
+
+    void PolygonDrawData::buildGeometry(const PolygonGeometry& geometry, const Projection& projection, const ProjectionSurface& projectionSurface) {
         const std::vector<MapPos>& poses = geometry.getPoses();
         const std::vector<std::vector<MapPos> >& holes = geometry.getHoles();
-        
+
         // Create tesselator
         TESSalloc ma;
         ma.memalloc = [](void* userData, unsigned int size) { return malloc(size); };
@@ -37,52 +73,36 @@ namespace carto {
         ma.extraVertices = 256;
         TESStesselator* tessPtr = tessNewTess(&ma);
         if (!tessPtr) {
-            Log::Error("PolygonDrawData::PolygonDrawData: Failed to create tesselator!");
+            Log::Error("PolygonDrawData::buildGeometry: Failed to create tesselator!");
             return;
         }
         std::shared_ptr<TESStesselator> tess(tessPtr, tessDeleteTess);
 
-        // Add polygon exterior, calculate bounding box
+        // Add polygon exterior
         std::vector<double> posesArray(poses.size() * 3);
-        std::vector<MapPos> ringPoses;
-        ringPoses.reserve(poses.size() + 1);
         for (std::size_t i = 0; i < poses.size(); i++) {
             MapPos internalPos = projection.toInternal(poses[i]);
             posesArray[i * 3 + 0] = internalPos.getX();
             posesArray[i * 3 + 1] = internalPos.getY();
             posesArray[i * 3 + 2] = internalPos.getZ();
-            ringPoses.push_back(poses[i]);
         }
         tessAddContour(tess.get(), 3, posesArray.data(), sizeof(double) * 3, static_cast<unsigned int>(poses.size()));
-    
-        if (style.getLineStyle() && !poses.empty()) {
-            ringPoses.push_back(poses.front());
-            _lineDrawDatas.push_back(std::make_shared<LineDrawData>(ringPoses, *style.getLineStyle(), projection, projectionSurface));
-        }
-    
+
         // Add polygon holes
         for (const std::vector<MapPos>& hole : holes) {
-            ringPoses.clear();
-            ringPoses.reserve(hole.size() + 1);
             std::vector<double> holeArray(hole.size() * 3);
             for (std::size_t i = 0; i < hole.size(); i++) {
                 MapPos internalPos = projection.toInternal(hole[i]);
                 holeArray[i * 3 + 0] = internalPos.getX();
                 holeArray[i * 3 + 1] = internalPos.getY();
                 holeArray[i * 3 + 2] = internalPos.getZ();
-                ringPoses.push_back(hole[i]);
             }
             tessAddContour(tess.get(), 3, holeArray.data(), sizeof(double) * 3, static_cast<unsigned int>(hole.size()));
-    
-            if (style.getLineStyle() && !hole.empty()) {
-                ringPoses.push_back(hole.front());
-                _lineDrawDatas.push_back(std::make_shared<LineDrawData>(ringPoses, *style.getLineStyle(), projection, projectionSurface));
-            }
         }
-    
+
         // Triangulate
         if (!tessTesselate(tess.get(), TESS_WINDING_ODD, TESS_POLYGONS, 3, 3, NULL)) {
-            Log::Error("PolygonDrawData::PolygonDrawData: Failed to triangulate polygon!");
+            Log::Error("PolygonDrawData::buildGeometry: Failed to triangulate polygon!");
             return;
         }
         const double* coords = tessGetVertices(tess.get());
@@ -145,8 +165,47 @@ namespace carto {
 
         _coords.back().shrink_to_fit();
         _indices.back().shrink_to_fit();
+
+        // Cache per-buffer origins and origin-relative coordinates for the draw path
+        _origins.reserve(_coords.size());
+        _relativeCoords.reserve(_coords.size());
+        for (const std::vector<cglib::vec3<double> >& bufferCoords : _coords) {
+            cglib::vec3<double> origin = bufferCoords.empty() ? cglib::vec3<double>::zero() : bufferCoords.front();
+            std::vector<cglib::vec3<float> > relativeCoords;
+            relativeCoords.reserve(bufferCoords.size());
+            for (const cglib::vec3<double>& pos : bufferCoords) {
+                relativeCoords.push_back(cglib::vec3<float>::convert(pos - origin));
+            }
+            _origins.push_back(origin);
+            _relativeCoords.push_back(std::move(relativeCoords));
+        }
     }
-    
+
+    void PolygonDrawData::buildLineDrawDatas(const PolygonGeometry& geometry, const PolygonStyle& style, const Projection& projection, const ProjectionSurface& projectionSurface) {
+        if (!style.getLineStyle()) {
+            return;
+        }
+
+        const std::vector<MapPos>& poses = geometry.getPoses();
+        if (!poses.empty()) {
+            std::vector<MapPos> ringPoses;
+            ringPoses.reserve(poses.size() + 1);
+            ringPoses.assign(poses.begin(), poses.end());
+            ringPoses.push_back(poses.front());
+            _lineDrawDatas.push_back(std::allocate_shared<LineDrawData>(PoolAllocator<LineDrawData>(), ringPoses, *style.getLineStyle(), projection, projectionSurface));
+        }
+
+        for (const std::vector<MapPos>& hole : geometry.getHoles()) {
+            if (!hole.empty()) {
+                std::vector<MapPos> ringPoses;
+                ringPoses.reserve(hole.size() + 1);
+                ringPoses.assign(hole.begin(), hole.end());
+                ringPoses.push_back(hole.front());
+                _lineDrawDatas.push_back(std::allocate_shared<LineDrawData>(PoolAllocator<LineDrawData>(), ringPoses, *style.getLineStyle(), projection, projectionSurface));
+            }
+        }
+    }
+
     PolygonDrawData::~PolygonDrawData() {
     }
     
@@ -161,7 +220,15 @@ namespace carto {
     const std::vector<std::vector<cglib::vec3<double> > >& PolygonDrawData::getCoords() const {
         return _coords;
     }
-    
+
+    const std::vector<cglib::vec3<double> >& PolygonDrawData::getOrigins() const {
+        return _origins;
+    }
+
+    const std::vector<std::vector<cglib::vec3<float> > >& PolygonDrawData::getRelativeCoords() const {
+        return _relativeCoords;
+    }
+
     const std::vector<std::vector<unsigned int> >& PolygonDrawData::getIndices() const {
         return _indices;
     }
@@ -176,7 +243,12 @@ namespace carto {
                 coord(0) += offset;
             }
         }
-    
+
+        // The relative coordinates stay valid, only the origins need to follow the coords
+        for (cglib::vec3<double>& origin : _origins) {
+            origin(0) += offset;
+        }
+
         for (const std::shared_ptr<LineDrawData>& drawData : _lineDrawDatas) {
             drawData->offsetHorizontally(offset);
         }
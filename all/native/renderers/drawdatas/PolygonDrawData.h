@@ -19,14 +19,16 @@ namespace carto {
     class Bitmap;
     class LineDrawData;
     class MapPos;
+    class Polygon;
     class PolygonGeometry;
     class PolygonStyle;
     class Projection;
     class ProjectionSurface;
-    
+
     class PolygonDrawData : public VectorElementDrawData {
     public:
         PolygonDrawData(const PolygonGeometry& geometry, const PolygonStyle& style, const Projection& projection, const ProjectionSurface& projectionSurface);
+        PolygonDrawData(const Polygon& polygon, const PolygonStyle& style, const Projection& projection, const ProjectionSurface& projectionSurface, const std::shared_ptr<PolygonDrawData>& prevDrawData);
         virtual ~PolygonDrawData();
     
         const std::shared_ptr<Bitmap> getBitmap() const;
@@ -34,7 +36,11 @@ namespace carto {
         const cglib::bbox3<double>& getBoundingBox() const;
     
         const std::vector<std::vector<cglib::vec3<double> > >& getCoords() const;
-    
+
+        const std::vector<cglib::vec3<double> >& getOrigins() const;
+
+        const std::vector<std::vector<cglib::vec3<float> > >& getRelativeCoords() const;
+
         const std::vector<std::vector<unsigned int> >& getIndices() const;
     
         const std::vector<std::shared_ptr<LineDrawData> >& getLineDrawDatas() const;
@@ -42,12 +48,22 @@ namespace carto {
         virtual void offsetHorizontally(double offset);
     
     private:
+        void buildGeometry(const PolygonGeometry& geometry, const Projection& projection, const ProjectionSurface& projectionSurface);
+        void buildLineDrawDatas(const PolygonGeometry& geometry, const PolygonStyle& style, const Projection& projection, const ProjectionSurface& projectionSurface);
+
         std::shared_ptr<Bitmap> _bitmap;
-    
+
+        std::shared_ptr<const PolygonGeometry> _geometry;
+
         cglib::bbox3<double> _boundingBox;
     
         std::vector<std::vector<cglib::vec3<double> > > _coords;
 
+        // Per-buffer origin and origin-relative coordinates, used on the draw path to
+        // replace per-vertex double conversion with a single translation per buffer
+        std::vector<cglib::vec3<double> > _origins;
+        std::vector<std::vector<cglib::vec3<float> > > _relativeCoords;
+
         std::vector<std::vector<unsigned int> > _indices;
     
         std::vector<std::shared_ptr<LineDrawData> > _lineDrawDatas;
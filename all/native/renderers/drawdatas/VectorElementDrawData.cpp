@@ -8,7 +8,23 @@ namespace carto {
     const Color& VectorElementDrawData::getColor() const {
         return _color;
     }
-    
+
+    long long VectorElementDrawData::getChangeGeneration() const {
+        return _changeGeneration;
+    }
+
+    void VectorElementDrawData::setChangeGeneration(long long changeGeneration) {
+        _changeGeneration = changeGeneration;
+    }
+
+    const std::shared_ptr<ProjectionSurface>& VectorElementDrawData::getProjectionSurface() const {
+        return _projectionSurface;
+    }
+
+    void VectorElementDrawData::setProjectionSurface(const std::shared_ptr<ProjectionSurface>& projectionSurface) {
+        _projectionSurface = projectionSurface;
+    }
+
     bool VectorElementDrawData::isOffset() const {
         return _isOffset;
     }
@@ -22,6 +38,8 @@ namespace carto {
     
     VectorElementDrawData::VectorElementDrawData(const Color& color) :
         _color(GetPremultipliedColor(color)),
+        _changeGeneration(-1),
+        _projectionSurface(),
         _isOffset(false)
     {
     }
@@ -12,17 +12,24 @@
 #include <memory>
 
 namespace carto {
+    class ProjectionSurface;
     class VectorElement;
-    
+
     class VectorElementDrawData {
     public:
         virtual ~VectorElementDrawData();
-    
+
         const Color& getColor() const;
-        
+
+        long long getChangeGeneration() const;
+        void setChangeGeneration(long long changeGeneration);
+
+        const std::shared_ptr<ProjectionSurface>& getProjectionSurface() const;
+        void setProjectionSurface(const std::shared_ptr<ProjectionSurface>& projectionSurface);
+
         virtual bool isOffset() const;
         virtual void offsetHorizontally(double offset) = 0;
-    
+
     protected:
         static Color GetPremultipliedColor(const Color& color);
 
@@ -32,6 +39,8 @@ namespace carto {
 
     private:
         Color _color;
+        long long _changeGeneration;
+        std::shared_ptr<ProjectionSurface> _projectionSurface;
         bool _isOffset;
     };
     
@@ -13,7 +13,7 @@ namespace carto {
     BillboardPlacementWorker::BillboardPlacementWorker() :
         _stop(false),
         _idle(false),
-        _kdTree(),
+        _collisionGrid(COLLISION_GRID_CELL_SIZE),
         _pendingWakeup(false),
         _wakeupTime(std::chrono::steady_clock::now() + std::chrono::hours(24)),
         _mapRenderer(),
@@ -112,23 +112,37 @@ namespace carto {
         ViewState viewState = mapRenderer->getViewState();
         const cglib::mat4x4<float>& rteMVPMat = viewState.getRTEModelviewProjectionMat();
 
-        // Sort draw datas
-        auto distanceComparator = [](const std::shared_ptr<BillboardDrawData>& drawData1, const std::shared_ptr<BillboardDrawData>& drawData2) {
-            // Sort by overlappability
-            if (drawData1->isHideIfOverlapped() != drawData2->isHideIfOverlapped()) {
-                return drawData2->isHideIfOverlapped() < drawData1->isHideIfOverlapped();
-            }
-
-            // Sort using DrawData ordering
+        // Sort draw datas. The billboard sorter orders the list with the same DrawData
+        // ordering when building it, so normally only the overlappability grouping is
+        // missing and a linear stable partition replaces the full sort.
+        auto orderComparator = [](const std::shared_ptr<BillboardDrawData>& drawData1, const std::shared_ptr<BillboardDrawData>& drawData2) {
             return drawData1->isBefore(*drawData2);
         };
-        std::stable_sort(billboardDrawDatas.begin(), billboardDrawDatas.end(), distanceComparator);
+        if (std::is_sorted(billboardDrawDatas.begin(), billboardDrawDatas.end(), orderComparator)) {
+            std::stable_partition(billboardDrawDatas.begin(), billboardDrawDatas.end(), [](const std::shared_ptr<BillboardDrawData>& drawData) {
+                return drawData->isHideIfOverlapped();
+            });
+        } else {
+            auto distanceComparator = [](const std::shared_ptr<BillboardDrawData>& drawData1, const std::shared_ptr<BillboardDrawData>& drawData2) {
+                // Sort by overlappability
+                if (drawData1->isHideIfOverlapped() != drawData2->isHideIfOverlapped()) {
+                    return drawData2->isHideIfOverlapped() < drawData1->isHideIfOverlapped();
+                }
+
+                // Sort using DrawData ordering
+                return drawData1->isBefore(*drawData2);
+            };
+            std::stable_sort(billboardDrawDatas.begin(), billboardDrawDatas.end(), distanceComparator);
+        }
         std::reverse(billboardDrawDatas.begin(), billboardDrawDatas.end());
 
-        // Calculate billboard screen coordinates, add envelopes to the tree
+        // Calculate billboard screen coordinates, add envelopes to the collision grid.
+        // The grid is shared by the single placement pass over all layers, so billboards
+        // of different layers are deconflicted against each other.
         {
             std::lock_guard<std::mutex> lock(_mutex);
-            _kdTree.clear();
+            _collisionGrid.clear();
+            _collisionGrid.reserve(billboardDrawDatas.size());
         }
 
         std::vector<float> coordBuf(12);
@@ -169,7 +183,7 @@ namespace carto {
             bool overlapped = false;
             if (drawData->isHideIfOverlapped()) {
                 // Check that there are higher priority billboards overlapping with this one
-                const std::vector<MapEnvelope>& overlappedEnvelopes = _kdTree.query(bounds);
+                const std::vector<MapEnvelope>& overlappedEnvelopes = _collisionGrid.query(bounds);
                 for (const MapEnvelope& overlappedEnvelope : overlappedEnvelopes) {
                     if (overlappedEnvelope.intersects(envelope)) {
                         // Overlapping detected, hide this billboard
@@ -185,7 +199,7 @@ namespace carto {
                 drawData->setOverlapping(false);
                 changed = true;
                 if (drawData->isCausesOverlap()) {
-                    _kdTree.insert(bounds, envelope);
+                    _collisionGrid.insert(bounds, envelope);
                 }
             }
         }
@@ -197,4 +211,6 @@ namespace carto {
         return true;
     }
 
+    const double BillboardPlacementWorker::COLLISION_GRID_CELL_SIZE = 0.125; // in normalized device coordinates, the screen maps to a 16x16 grid
+
 }
@@ -9,7 +9,7 @@
 
 #include "components/ThreadWorker.h"
 #include "core/MapEnvelope.h"
-#include "geometry/utils/KDTreeSpatialIndex.h"
+#include "geometry/utils/GridSpatialIndex.h"
 
 #include <condition_variable>
 #include <memory>
@@ -39,11 +39,13 @@ namespace carto {
         void run();
         
         bool calculateBillboardPlacement();
-        
+
+        static const double COLLISION_GRID_CELL_SIZE;
+
         bool _stop;
         bool _idle;
-        
-        KDTreeSpatialIndex<MapEnvelope> _kdTree;
+
+        GridSpatialIndex<MapEnvelope> _collisionGrid;
         
         bool _pendingWakeup;
         std::chrono::steady_clock::time_point _wakeupTime;
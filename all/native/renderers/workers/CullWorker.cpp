@@ -3,6 +3,7 @@
 #include "projections/ProjectionSurface.h"
 #include "projections/PlanarProjectionSurface.h"
 #include "renderers/MapRenderer.h"
+#include "renderers/components/FrameProfiler.h"
 #include "utils/Const.h"
 #include "utils/GeomUtils.h"
 #include "utils/Log.h"
@@ -14,6 +15,7 @@ namespace carto {
         _layerWakeupMap(),
         _firstCull(true),
         _envelope(),
+        _envelopeViewState(),
         _viewState(),
         _mapRenderer(),
         _stop(false),
@@ -105,33 +107,69 @@ namespace carto {
                     continue;
                 }
                 
+                FrameProfiler& frameProfiler = mapRenderer->getFrameProfiler();
+                std::chrono::steady_clock::time_point cullStartTime;
+                if (frameProfiler.isEnabled()) {
+                    cullStartTime = std::chrono::steady_clock::now();
+                }
+
                 // Check if view state has changed
-                if (_firstCull || viewState.getModelviewProjectionMat() != _viewState.getModelviewProjectionMat() || viewState.getProjectionSurface() != _viewState.getProjectionSurface()) {
+                if (_firstCull || viewState.getCameraGeneration() != _viewState.getCameraGeneration() || viewState.getProjectionSurface() != _viewState.getProjectionSurface()) {
                     _firstCull = false;
                     _viewState = viewState;
-                    
+
                     // Calculate state
                     calculateCullState();
                 }
-                
+
                 // Update layers
                 updateLayers(layers);
+
+                if (frameProfiler.isEnabled()) {
+                    frameProfiler.addSample(FrameProfiler::STAGE_CULL, cullStartTime, std::chrono::steady_clock::now() - cullStartTime);
+                }
             }
         }
     }
     
     void CullWorker::calculateCullState() {
+        // For small camera movements the previous envelope, enlarged by VIEWPORT_SCALE,
+        // still covers the exact visible area. Keep it in that case: the cull pass becomes
+        // nearly free and the unchanged envelope avoids tile set churn in the layers.
+        if (checkEnvelopeReusable()) {
+            return;
+        }
+        _envelopeViewState = _viewState;
+
         // Calculate envelope for the visible frustum
         calculateEnvelope();
     }
-    
+
+    bool CullWorker::checkEnvelopeReusable() const {
+        std::shared_ptr<ProjectionSurface> projectionSurface = _viewState.getProjectionSurface();
+        if (!projectionSurface || projectionSurface != _envelopeViewState.getProjectionSurface()) {
+            return false;
+        }
+        if (_viewState.getWidth() != _envelopeViewState.getWidth() || _viewState.getHeight() != _envelopeViewState.getHeight()) {
+            return false;
+        }
+        // Any zoom/tilt/rotation change reshapes the envelope, only reuse it for pure pans.
+        // During panning these values are untouched, so exact comparison works.
+        if (_viewState.getZoom() != _envelopeViewState.getZoom() || _viewState.getTilt() != _envelopeViewState.getTilt() || _viewState.getRotation() != _envelopeViewState.getRotation()) {
+            return false;
+        }
+        double viewRange = cglib::length(_envelopeViewState.getCameraPos() - _envelopeViewState.getFocusPos());
+        double cameraDelta = cglib::length(_viewState.getCameraPos() - _envelopeViewState.getCameraPos());
+        return cameraDelta < viewRange * ENVELOPE_REUSE_THRESHOLD;
+    }
+
     void CullWorker::calculateEnvelope() {
         std::shared_ptr<ProjectionSurface> projectionSurface = _viewState.getProjectionSurface();
         if (!projectionSurface) {
             return;
         }
 
-        cglib::mat4x4<double> invMVPMat = cglib::inverse(_viewState.getModelviewProjectionMat());
+        const cglib::mat4x4<double>& invMVPMat = _viewState.getInvModelviewProjectionMat();
 
         bool addPole1 = _viewState.getFrustum().inside(projectionSurface->calculatePosition(MapPos(0, -std::numeric_limits<double>::infinity())));
         bool addPole2 = _viewState.getFrustum().inside(projectionSurface->calculatePosition(MapPos(0,  std::numeric_limits<double>::infinity())));
@@ -227,4 +265,6 @@ namespace carto {
     const int CullWorker::MAX_ENVELOPE_POINTS = 64;
 
     const float CullWorker::VIEWPORT_SCALE = 1.1f; // enlarge viewport envelope by approx. 10%
+
+    const float CullWorker::ENVELOPE_REUSE_THRESHOLD = 0.03f; // maximum camera movement (relative to the camera-focus distance) covered by the envelope enlargement
 }
@@ -43,23 +43,27 @@ namespace carto {
         void run();
     
         void calculateCullState();
+        bool checkEnvelopeReusable() const;
         void calculateEnvelope();
         void updateLayers(const std::vector<std::shared_ptr<Layer> >& layers);
-    
+
         static const int MAX_VIEWPORT_TESSELATION_LEVEL;
 
         static const int MAX_ENVELOPE_POINTS;
 
         static const float VIEWPORT_SCALE;
 
+        static const float ENVELOPE_REUSE_THRESHOLD;
+
         std::map<std::shared_ptr<Layer>, std::chrono::steady_clock::time_point> _layerWakeupMap;
         
         bool _firstCull;
         
         MapEnvelope _envelope;
-        
+        ViewState _envelopeViewState; // the view state the envelope was last fully computed for
+
         ViewState _viewState;
-    
+
         std::weak_ptr<MapRenderer> _mapRenderer;
         std::shared_ptr<CullWorker> _worker;
     
@@ -0,0 +1,93 @@
+#include "RendererCaptureWorker.h"
+#include "graphics/Bitmap.h"
+#include "renderers/MapRenderer.h"
+#include "renderers/RendererCaptureListener.h"
+#include "utils/Log.h"
+#include "utils/ThreadUtils.h"
+
+namespace carto {
+
+    RendererCaptureWorker::RendererCaptureWorker() :
+        _stop(false),
+        _idle(false),
+        _pendingCaptures(),
+        _mapRenderer(),
+        _condition(),
+        _mutex()
+    {
+    }
+
+    RendererCaptureWorker::~RendererCaptureWorker() {
+    }
+
+    void RendererCaptureWorker::setComponents(const std::weak_ptr<MapRenderer>& mapRenderer, const std::shared_ptr<RendererCaptureWorker>& worker) {
+        _mapRenderer = mapRenderer;
+        // When the map component gets destroyed all threads get detatched. Detatched threads need their worker objects to be alive,
+        // so worker objects need to keep references to themselves, until the loop finishes.
+        _worker = worker;
+    }
+
+    void RendererCaptureWorker::init(const std::vector<DirectorPtr<RendererCaptureListener> >& listeners, const std::shared_ptr<std::vector<unsigned char> >& data, int width, int height) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        Capture capture;
+        capture.listeners = listeners;
+        capture.data = data;
+        capture.width = width;
+        capture.height = height;
+        _pendingCaptures.push_back(std::move(capture));
+        _idle = false;
+        _condition.notify_one();
+    }
+
+    void RendererCaptureWorker::stop() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+        _condition.notify_all();
+    }
+
+    bool RendererCaptureWorker::isIdle() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _idle;
+    }
+
+    void RendererCaptureWorker::operator ()() {
+        run();
+        _worker.reset();
+    }
+
+    void RendererCaptureWorker::run() {
+        ThreadUtils::SetThreadPriority(ThreadPriority::LOW);
+
+        while (true) {
+            std::vector<Capture> captures;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+
+                if (_stop) {
+                    return;
+                }
+
+                if (_pendingCaptures.empty()) {
+                    _idle = true;
+                    _condition.wait(lock);
+                    _idle = false;
+                    continue;
+                }
+
+                std::swap(captures, _pendingCaptures);
+            }
+
+            deliverCaptures(captures);
+        }
+    }
+
+    void RendererCaptureWorker::deliverCaptures(const std::vector<Capture>& captures) {
+        for (const Capture& capture : captures) {
+            auto captureBitmap = std::make_shared<Bitmap>(capture.data->data(), capture.width, capture.height, ColorFormat::COLOR_FORMAT_RGBA, -4 * capture.width);
+            for (const DirectorPtr<RendererCaptureListener>& listener : capture.listeners) {
+                listener->onMapRendered(captureBitmap);
+            }
+        }
+    }
+
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2016 CartoDB. All rights reserved.
+ * Copying and using this code is allowed only according
+ * to license terms, as given in https://cartodb.com/terms/
+ */
+
+#ifndef _CARTO_RENDERERCAPTUREWORKER_H_
+#define _CARTO_RENDERERCAPTUREWORKER_H_
+
+#include "components/ThreadWorker.h"
+#include "components/DirectorPtr.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace carto {
+    class MapRenderer;
+    class RendererCaptureListener;
+
+    class RendererCaptureWorker : public ThreadWorker {
+    public:
+        RendererCaptureWorker();
+        virtual ~RendererCaptureWorker();
+
+        void setComponents(const std::weak_ptr<MapRenderer>& mapRenderer, const std::shared_ptr<RendererCaptureWorker>& worker);
+
+        void init(const std::vector<DirectorPtr<RendererCaptureListener> >& listeners, const std::shared_ptr<std::vector<unsigned char> >& data, int width, int height);
+
+        void stop();
+
+        bool isIdle() const;
+
+        void operator()();
+
+    private:
+        struct Capture {
+            std::vector<DirectorPtr<RendererCaptureListener> > listeners;
+            std::shared_ptr<std::vector<unsigned char> > data;
+            int width;
+            int height;
+        };
+
+        void run();
+
+        void deliverCaptures(const std::vector<Capture>& captures);
+
+        bool _stop;
+        bool _idle;
+
+        std::vector<Capture> _pendingCaptures;
+
+        std::weak_ptr<MapRenderer> _mapRenderer;
+        std::shared_ptr<RendererCaptureWorker> _worker;
+
+        std::condition_variable _condition;
+        mutable std::mutex _mutex;
+    };
+
+}
+
+#endif
@@ -106,11 +106,12 @@ namespace carto {
             throw GenericException("Failed to read routing data", result);
         }
         
+        // Parse the response in place, copy it into a string only for error reporting
         const char* responseDataPtr = reinterpret_cast<const char*>(responseData->data());
-        std::string json(responseDataPtr, responseDataPtr + responseData->size());
         rapidjson::Document responseDoc;
-        if (responseDoc.Parse<rapidjson::kParseDefaultFlags>(json.c_str()).HasParseError()) {
+        if (responseDoc.Parse<rapidjson::kParseDefaultFlags>(responseDataPtr, responseData->size()).HasParseError()) {
             std::string err = rapidjson::GetParseError_En(responseDoc.GetParseError());
+            std::string json(responseDataPtr, responseDataPtr + responseData->size());
             throw ParseException(err, json, static_cast<int>(responseDoc.GetErrorOffset()));
         }
 
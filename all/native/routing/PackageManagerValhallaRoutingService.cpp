@@ -5,19 +5,25 @@
 #include "packagemanager/PackageInfo.h"
 #include "packagemanager/handlers/ValhallaRoutingPackageHandler.h"
 #include "projections/Projection.h"
+#include "routing/RouteMatchingCompletionListener.h"
 #include "routing/RouteMatchingRequest.h"
 #include "routing/RouteMatchingResult.h"
+#include "routing/RoutingTask.h"
 #include "routing/ValhallaRoutingProxy.h"
 #include "utils/Const.h"
 #include "utils/Log.h"
 
+#include <algorithm>
+
 namespace carto {
 
     PackageManagerValhallaRoutingService::PackageManagerValhallaRoutingService(const std::shared_ptr<PackageManager>& packageManager) :
         RoutingService(),
         _packageManager(packageManager),
         _profile("pedestrian"),
+        _cacheSize(DEFAULT_CACHE_SIZE),
         _cachedPackageDatabases(),
+        _cachedRoutingContext(),
         _mutex()
     {
         if (!packageManager) {
@@ -40,7 +46,23 @@ namespace carto {
 
     void PackageManagerValhallaRoutingService::setProfile(const std::string& profile) {
         std::lock_guard<std::mutex> lock(_mutex);
-        _profile = profile;
+        if (profile != _profile) {
+            _profile = profile;
+            _cachedRoutingContext.reset();
+        }
+    }
+
+    std::size_t PackageManagerValhallaRoutingService::getCacheSize() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _cacheSize;
+    }
+
+    void PackageManagerValhallaRoutingService::setCacheSize(std::size_t sizeInBytes) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _cacheSize = sizeInBytes;
+        if (_cachedRoutingContext) {
+            ValhallaRoutingProxy::SetRoutingContextCacheSize(_cachedRoutingContext, sizeInBytes);
+        }
     }
 
     std::shared_ptr<RouteMatchingResult> PackageManagerValhallaRoutingService::matchRoute(const std::shared_ptr<RouteMatchingRequest>& request) const {
@@ -61,18 +83,25 @@ namespace carto {
                 }
             }
 
-            // Now check if we have already a cached route finder for the files. If not, create new instance.
-            std::lock_guard<std::mutex> lock(_mutex);
-            if (packageDatabases != _cachedPackageDatabases) {
-                _cachedPackageDatabases = packageDatabases;
-            }
-
-            result = ValhallaRoutingProxy::MatchRoute(_cachedPackageDatabases, _profile, request);
+            // Now check if we have already a cached routing context for the files. If not, create new instance.
+            result = ValhallaRoutingProxy::MatchRoute(getRoutingContext(packageDatabases), request);
         });
 
         return result;
     }
 
+    std::shared_ptr<RoutingTask> PackageManagerValhallaRoutingService::matchRoutes(const std::vector<std::shared_ptr<RouteMatchingRequest> >& requests, const std::shared_ptr<RouteMatchingCompletionListener>& listener) const {
+        for (const std::shared_ptr<RouteMatchingRequest>& request : requests) {
+            if (!request) {
+                throw NullArgumentException("Null request");
+            }
+        }
+
+        auto routingTask = std::make_shared<RoutingTask>();
+        scheduleTask(std::make_shared<MatchRoutesTask>(std::static_pointer_cast<const PackageManagerValhallaRoutingService>(shared_from_this()), requests, routingTask, listener));
+        return routingTask;
+    }
+
     std::shared_ptr<RoutingResult> PackageManagerValhallaRoutingService::calculateRoute(const std::shared_ptr<RoutingRequest>& request) const {
         if (!request) {
             throw NullArgumentException("Null request");
@@ -91,18 +120,80 @@ namespace carto {
                 }
             }
 
-            // Now check if we have already a cached route finder for the files. If not, create new instance.
-            std::lock_guard<std::mutex> lock(_mutex);
-            if (packageDatabases != _cachedPackageDatabases) {
-                _cachedPackageDatabases = packageDatabases;
-            }
-
-            result = ValhallaRoutingProxy::CalculateRoute(_cachedPackageDatabases, _profile, request);
+            // Now check if we have already a cached routing context for the files. If not, create new instance.
+            result = ValhallaRoutingProxy::CalculateRoute(getRoutingContext(packageDatabases), request, std::shared_ptr<RoutingTask>());
         });
 
         return result;
     }
             
+    std::shared_ptr<ValhallaRoutingContext> PackageManagerValhallaRoutingService::getRoutingContext(const std::vector<std::shared_ptr<sqlite3pp::database> >& packageDatabases) const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_cachedRoutingContext || packageDatabases != _cachedPackageDatabases) {
+            _cachedPackageDatabases = packageDatabases;
+            _cachedRoutingContext = ValhallaRoutingProxy::CreateRoutingContext(packageDatabases, _profile);
+            ValhallaRoutingProxy::SetRoutingContextCacheSize(_cachedRoutingContext, _cacheSize);
+        }
+        return _cachedRoutingContext;
+    }
+
+    PackageManagerValhallaRoutingService::MatchRoutesTask::MatchRoutesTask(const std::shared_ptr<const PackageManagerValhallaRoutingService>& service, const std::vector<std::shared_ptr<RouteMatchingRequest> >& requests, const std::shared_ptr<RoutingTask>& routingTask, const std::shared_ptr<RouteMatchingCompletionListener>& listener) :
+        CancelableTask(),
+        _service(service),
+        _requests(requests),
+        _routingTask(routingTask),
+        _listener(listener)
+    {
+    }
+
+    void PackageManagerValhallaRoutingService::MatchRoutesTask::run() {
+        std::shared_ptr<const PackageManagerValhallaRoutingService> service = _service.lock();
+        if (!service || _routingTask->isCanceled()) {
+            if (_listener) {
+                _listener->onRouteMatchingCancelled();
+            }
+            return;
+        }
+
+        try {
+            // Do route matching via package manager, so that all packages are locked during the batch
+            service->_packageManager->accessLocalPackages([this, &service](const std::map<std::shared_ptr<PackageInfo>, std::shared_ptr<PackageHandler> >& packageHandlerMap) {
+                // Build map of routing packages and graph files
+                std::vector<std::shared_ptr<sqlite3pp::database> > packageDatabases;
+                for (auto it = packageHandlerMap.begin(); it != packageHandlerMap.end(); it++) {
+                    if (auto valhallaRoutingHandler = std::dynamic_pointer_cast<ValhallaRoutingPackageHandler>(it->second)) {
+                        if (std::shared_ptr<sqlite3pp::database> database = valhallaRoutingHandler->getDatabase()) {
+                            packageDatabases.push_back(database);
+                        }
+                    }
+                }
+
+                // Process the batch on parallel workers. The first context has the warm tile cache,
+                // the extra contexts are throwaway instances for the duration of the batch.
+                std::size_t workerCount = std::min(_requests.size(), static_cast<std::size_t>(MAX_MATCHING_WORKERS));
+                std::vector<std::shared_ptr<ValhallaRoutingContext> > contexts;
+                contexts.reserve(workerCount);
+                for (std::size_t i = 0; i < workerCount; i++) {
+                    if (i == 0) {
+                        contexts.push_back(service->getRoutingContext(packageDatabases));
+                    } else {
+                        std::shared_ptr<ValhallaRoutingContext> context = ValhallaRoutingProxy::CreateRoutingContext(packageDatabases, service->getProfile());
+                        ValhallaRoutingProxy::SetRoutingContextCacheSize(context, service->getCacheSize());
+                        contexts.push_back(context);
+                    }
+                }
+
+                ValhallaRoutingProxy::MatchRoutes(contexts, _requests, _routingTask, _listener.get());
+            });
+        }
+        catch (const std::exception& ex) {
+            Log::Errorf("PackageManagerValhallaRoutingService::MatchRoutesTask: Exception while matching routes: %s", ex.what());
+            if (_listener) {
+                _listener->onRouteMatchingCancelled();
+            }
+        }
+    }
+
     PackageManagerValhallaRoutingService::PackageManagerListener::PackageManagerListener(PackageManagerValhallaRoutingService& service) :
         _service(service)
     {
@@ -111,6 +202,7 @@ namespace carto {
     void PackageManagerValhallaRoutingService::PackageManagerListener::onPackagesChanged() {
         std::lock_guard<std::mutex> lock(_service._mutex);
         _service._cachedPackageDatabases.clear();
+        _service._cachedRoutingContext.reset();
     }
 
     void PackageManagerValhallaRoutingService::PackageManagerListener::onStylesChanged() {
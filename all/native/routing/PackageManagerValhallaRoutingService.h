@@ -22,8 +22,10 @@ namespace sqlite3pp {
 }
 
 namespace carto {
+    class RouteMatchingCompletionListener;
     class RouteMatchingRequest;
     class RouteMatchingResult;
+    class ValhallaRoutingContext;
 
     /**
      * A routing service that uses routing packages from package manager.
@@ -48,6 +50,18 @@ namespace carto {
          */
         void setProfile(const std::string& profile);
 
+        /**
+         * Returns the maximum size of the graph tile cache.
+         * @return The maximum size of the graph tile cache in bytes.
+         */
+        std::size_t getCacheSize() const;
+        /**
+         * Sets the maximum size of the graph tile cache. The cache keeps recently used graph tiles
+         * in memory across requests, making repeated reroutes along the same corridor faster.
+         * @param sizeInBytes The new maximum size of the cache in bytes. The default is 16MB.
+         */
+        void setCacheSize(std::size_t sizeInBytes);
+
         /**
          * Matches specified points to the points on road network.
          * @param request The matching request.
@@ -56,6 +70,17 @@ namespace carto {
          */
         std::shared_ptr<RouteMatchingResult> matchRoute(const std::shared_ptr<RouteMatchingRequest>& request) const;
 
+        /**
+         * Starts asynchronous batch route matching. The requests are processed in a background
+         * thread on parallel workers that share the warm graph tile caches and the given listener
+         * is notified of individual results as they complete.
+         * @param requests The list of route matching requests to process.
+         * @param listener The listener to notify of the results. Can be null.
+         * @return A task handle that can be used to cancel the pending batch.
+         * @throws std::runtime_error If an error occured while starting the batch.
+         */
+        std::shared_ptr<RoutingTask> matchRoutes(const std::vector<std::shared_ptr<RouteMatchingRequest> >& requests, const std::shared_ptr<RouteMatchingCompletionListener>& listener) const;
+
         virtual std::shared_ptr<RoutingResult> calculateRoute(const std::shared_ptr<RoutingRequest>& request) const;
 
     protected:
@@ -70,14 +95,34 @@ namespace carto {
             PackageManagerValhallaRoutingService& _service;
         };
 
+        std::shared_ptr<ValhallaRoutingContext> getRoutingContext(const std::vector<std::shared_ptr<sqlite3pp::database> >& packageDatabases) const;
+
+        static const int DEFAULT_CACHE_SIZE = 16 * 1024 * 1024;
+        static const int MAX_MATCHING_WORKERS = 4;
+
         const std::shared_ptr<PackageManager> _packageManager;
         std::string _profile;
+        std::size_t _cacheSize;
 
         mutable std::vector<std::shared_ptr<sqlite3pp::database> > _cachedPackageDatabases;
+        mutable std::shared_ptr<ValhallaRoutingContext> _cachedRoutingContext;
 
         mutable std::mutex _mutex;
 
     private:
+        class MatchRoutesTask : public CancelableTask {
+        public:
+            MatchRoutesTask(const std::shared_ptr<const PackageManagerValhallaRoutingService>& service, const std::vector<std::shared_ptr<RouteMatchingRequest> >& requests, const std::shared_ptr<RoutingTask>& routingTask, const std::shared_ptr<RouteMatchingCompletionListener>& listener);
+
+            virtual void run();
+
+        private:
+            std::weak_ptr<const PackageManagerValhallaRoutingService> _service;
+            std::vector<std::shared_ptr<RouteMatchingRequest> > _requests;
+            std::shared_ptr<RoutingTask> _routingTask;
+            DirectorPtr<RouteMatchingCompletionListener> _listener;
+        };
+
         std::shared_ptr<PackageManagerListener> _packageManagerListener;
     };
     
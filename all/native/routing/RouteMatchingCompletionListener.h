@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2016 CartoDB. All rights reserved.
+ * Copying and using this code is allowed only according
+ * to license terms, as given in https://cartodb.com/terms/
+ */
+
+#ifndef _CARTO_ROUTEMATCHINGCOMPLETIONLISTENER_H_
+#define _CARTO_ROUTEMATCHINGCOMPLETIONLISTENER_H_
+
+#ifdef _CARTO_ROUTING_SUPPORT
+
+#include "routing/RouteMatchingRequest.h"
+#include "routing/RouteMatchingResult.h"
+
+#include <memory>
+#include <string>
+
+namespace carto {
+
+    /**
+     * Listener for asynchronous batch route matching.
+     */
+    class RouteMatchingCompletionListener {
+    public:
+        virtual ~RouteMatchingCompletionListener() { }
+
+        /**
+         * Listener method that is called when a route matching request of the batch has completed successfully.
+         * The method may be called from multiple worker threads, but the calls are serialized.
+         * @param request The original route matching request.
+         * @param result The corresponding route matching result.
+         */
+        virtual void onRouteMatched(const std::shared_ptr<RouteMatchingRequest>& request, const std::shared_ptr<RouteMatchingResult>& result) { }
+        /**
+         * Listener method that is called when a route matching request of the batch has failed.
+         * @param request The original route matching request.
+         * @param errorMessage The error message describing the reason of the failure.
+         */
+        virtual void onRouteMatchingFailed(const std::shared_ptr<RouteMatchingRequest>& request, const std::string& errorMessage) { }
+        /**
+         * Listener method that is called when all the requests of the batch have been processed.
+         */
+        virtual void onRouteMatchingCompleted() { }
+        /**
+         * Listener method that is called when the batch has been cancelled.
+         */
+        virtual void onRouteMatchingCancelled() { }
+    };
+
+}
+
+#endif
+
+#endif
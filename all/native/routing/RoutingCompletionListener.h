@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2016 CartoDB. All rights reserved.
+ * Copying and using this code is allowed only according
+ * to license terms, as given in https://cartodb.com/terms/
+ */
+
+#ifndef _CARTO_ROUTINGCOMPLETIONLISTENER_H_
+#define _CARTO_ROUTINGCOMPLETIONLISTENER_H_
+
+#ifdef _CARTO_ROUTING_SUPPORT
+
+#include "routing/RoutingResult.h"
+
+#include <memory>
+#include <string>
+
+namespace carto {
+
+    /**
+     * Listener for asynchronous routing calculations.
+     */
+    class RoutingCompletionListener {
+    public:
+        virtual ~RoutingCompletionListener() { }
+
+        /**
+         * Listener method that is called when the route calculation has completed successfully.
+         * @param result The calculated routing result.
+         */
+        virtual void onRoutingCompleted(const std::shared_ptr<RoutingResult>& result) { }
+        /**
+         * Listener method that is called when the route calculation has failed.
+         * @param errorMessage The error message describing the reason of the failure.
+         */
+        virtual void onRoutingFailed(const std::string& errorMessage) { }
+        /**
+         * Listener method that is called when the route calculation has been cancelled.
+         */
+        virtual void onRoutingCancelled() { }
+    };
+
+}
+
+#endif
+
+#endif
@@ -1,13 +1,83 @@
 #ifdef _CARTO_ROUTING_SUPPORT
 
 #include "RoutingService.h"
+#include "components/CancelableThreadPool.h"
+#include "components/Exceptions.h"
+#include "routing/RoutingCompletionListener.h"
+#include "routing/RoutingTask.h"
 
 namespace carto {
 
-    RoutingService::RoutingService() {
+    RoutingService::RoutingService() :
+        _routingThreadPool(std::make_shared<CancelableThreadPool>())
+    {
+        _routingThreadPool->setPoolSize(1);
     }
 
     RoutingService::~RoutingService() {
+        _routingThreadPool->deinit();
+    }
+
+    std::shared_ptr<RoutingTask> RoutingService::calculateRouteAsync(const std::shared_ptr<RoutingRequest>& request, const std::shared_ptr<RoutingCompletionListener>& listener) const {
+        if (!request) {
+            throw NullArgumentException("Null request");
+        }
+
+        auto routingTask = std::make_shared<RoutingTask>();
+        scheduleTask(std::make_shared<CalculateRouteTask>(shared_from_this(), request, routingTask, listener));
+        return routingTask;
+    }
+
+    std::shared_ptr<RoutingResult> RoutingService::calculateRouteTask(const std::shared_ptr<RoutingRequest>& request, const std::shared_ptr<RoutingTask>& task) const {
+        return calculateRoute(request);
+    }
+
+    void RoutingService::scheduleTask(const std::shared_ptr<CancelableTask>& task) const {
+        _routingThreadPool->execute(task);
+    }
+
+    RoutingService::CalculateRouteTask::CalculateRouteTask(const std::shared_ptr<const RoutingService>& service, const std::shared_ptr<RoutingRequest>& request, const std::shared_ptr<RoutingTask>& routingTask, const std::shared_ptr<RoutingCompletionListener>& listener) :
+        CancelableTask(),
+        _service(service),
+        _request(request),
+        _routingTask(routingTask),
+        _listener(listener)
+    {
+    }
+
+    void RoutingService::CalculateRouteTask::run() {
+        std::shared_ptr<const RoutingService> service = _service.lock();
+        if (!service || _routingTask->isCanceled()) {
+            if (_listener) {
+                _listener->onRoutingCancelled();
+            }
+            return;
+        }
+
+        std::shared_ptr<RoutingResult> result;
+        try {
+            result = service->calculateRouteTask(_request, _routingTask);
+        }
+        catch (const std::exception& ex) {
+            if (_listener) {
+                if (_routingTask->isCanceled()) {
+                    _listener->onRoutingCancelled();
+                } else {
+                    _listener->onRoutingFailed(ex.what());
+                }
+            }
+            return;
+        }
+
+        if (_listener) {
+            if (_routingTask->isCanceled()) {
+                _listener->onRoutingCancelled();
+            } else if (result) {
+                _listener->onRoutingCompleted(result);
+            } else {
+                _listener->onRoutingFailed("Route calculation failed");
+            }
+        }
     }
 
 }
@@ -9,17 +9,22 @@
 
 #ifdef _CARTO_ROUTING_SUPPORT
 
+#include "components/CancelableTask.h"
+#include "components/DirectorPtr.h"
 #include "routing/RoutingRequest.h"
 #include "routing/RoutingResult.h"
 
 #include <memory>
 
 namespace carto {
+    class CancelableThreadPool;
+    class RoutingCompletionListener;
+    class RoutingTask;
 
     /**
      * An abstract base class for routing services (either online or offline).
      */
-    class RoutingService {
+    class RoutingService : public std::enable_shared_from_this<RoutingService> {
     public:
         virtual ~RoutingService();
 
@@ -31,13 +36,43 @@ namespace carto {
          */
         virtual std::shared_ptr<RoutingResult> calculateRoute(const std::shared_ptr<RoutingRequest>& request) const = 0;
 
+        /**
+         * Starts an asynchronous routing calculation. The calculation is performed in a background
+         * thread and the given listener is notified of the outcome once the calculation has completed.
+         * @param request The routing request defining via points.
+         * @param listener The listener to notify of the outcome. Can be null.
+         * @return A task handle that can be used to cancel the pending calculation.
+         * @throws std::runtime_error If an error occured while starting the calculation.
+         */
+        virtual std::shared_ptr<RoutingTask> calculateRouteAsync(const std::shared_ptr<RoutingRequest>& request, const std::shared_ptr<RoutingCompletionListener>& listener) const;
+
     protected:
         /**
          * The default constructor.
          */
         RoutingService();
+
+        virtual std::shared_ptr<RoutingResult> calculateRouteTask(const std::shared_ptr<RoutingRequest>& request, const std::shared_ptr<RoutingTask>& task) const;
+
+        void scheduleTask(const std::shared_ptr<CancelableTask>& task) const;
+
+    private:
+        class CalculateRouteTask : public CancelableTask {
+        public:
+            CalculateRouteTask(const std::shared_ptr<const RoutingService>& service, const std::shared_ptr<RoutingRequest>& request, const std::shared_ptr<RoutingTask>& routingTask, const std::shared_ptr<RoutingCompletionListener>& listener);
+
+            virtual void run();
+
+        private:
+            std::weak_ptr<const RoutingService> _service;
+            std::shared_ptr<RoutingRequest> _request;
+            std::shared_ptr<RoutingTask> _routingTask;
+            DirectorPtr<RoutingCompletionListener> _listener;
+        };
+
+        std::shared_ptr<CancelableThreadPool> _routingThreadPool;
     };
-    
+
 }
 
 #endif
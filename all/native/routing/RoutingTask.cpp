@@ -0,0 +1,28 @@
+#ifdef _CARTO_ROUTING_SUPPORT
+
+#include "RoutingTask.h"
+
+namespace carto {
+
+    RoutingTask::RoutingTask() :
+        _canceled(false),
+        _mutex()
+    {
+    }
+
+    RoutingTask::~RoutingTask() {
+    }
+
+    bool RoutingTask::isCanceled() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _canceled;
+    }
+
+    void RoutingTask::cancel() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _canceled = true;
+    }
+
+}
+
+#endif
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2016 CartoDB. All rights reserved.
+ * Copying and using this code is allowed only according
+ * to license terms, as given in https://cartodb.com/terms/
+ */
+
+#ifndef _CARTO_ROUTINGTASK_H_
+#define _CARTO_ROUTINGTASK_H_
+
+#ifdef _CARTO_ROUTING_SUPPORT
+
+#include <mutex>
+
+namespace carto {
+
+    /**
+     * A handle for an asynchronous routing calculation.
+     * The handle can be used to cancel the calculation before it has completed.
+     */
+    class RoutingTask {
+    public:
+        RoutingTask();
+        virtual ~RoutingTask();
+
+        /**
+         * Returns the state of the cancel flag of the calculation.
+         * @return True if the calculation has been cancelled, false otherwise.
+         */
+        bool isCanceled() const;
+        /**
+         * Cancels the calculation. If the calculation has already completed, cancelling has no effect.
+         */
+        void cancel();
+
+    private:
+        bool _canceled;
+
+        mutable std::mutex _mutex;
+    };
+
+}
+
+#endif
+
+#endif
@@ -9,8 +9,12 @@
 #include "utils/Const.h"
 #include "utils/Log.h"
 
+#include <algorithm>
+#include <functional>
 #include <limits>
 
+#include <boost/lexical_cast.hpp>
+
 #include <sgre/Graph.h>
 #include <sgre/GraphBuilder.h>
 #include <sgre/Query.h>
@@ -77,17 +81,39 @@ namespace carto {
         {
             std::lock_guard<std::mutex> lock(_mutex);
             if (!_cachedRouteFinder) {
-                try {
-                    sgre::RuleList ruleList;
-                    if (_config.contains("rules")) {
-                        ruleList = sgre::RuleList::parse(_config.get("rules"));
+                // Look up the built graph from the process-wide cache first. This makes
+                // recreating the service with the same data and profile near-instant.
+                std::string cacheKey = boost::lexical_cast<std::string>(std::hash<std::string>()(_featureData.serialize())) + "/" + boost::lexical_cast<std::string>(std::hash<std::string>()(_config.serialize())) + "/" + _profile;
+                {
+                    std::lock_guard<std::mutex> cacheLock(_RouteFinderCacheMutex);
+                    auto it = std::find_if(_RouteFinderCache.begin(), _RouteFinderCache.end(), [&cacheKey](const std::pair<std::string, std::shared_ptr<sgre::RouteFinder> >& entry) {
+                        return entry.first == cacheKey;
+                    });
+                    if (it != _RouteFinderCache.end()) {
+                        _cachedRouteFinder = it->second;
+                        _RouteFinderCache.splice(_RouteFinderCache.begin(), _RouteFinderCache, it);
+                    }
+                }
+
+                if (!_cachedRouteFinder) {
+                    try {
+                        sgre::RuleList ruleList;
+                        if (_config.contains("rules")) {
+                            ruleList = sgre::RuleList::parse(_config.get("rules"));
+                        }
+                        ruleList.filter(_profile);
+                        sgre::GraphBuilder graphBuilder(std::move(ruleList));
+                        graphBuilder.importGeoJSON(_featureData);
+                        _cachedRouteFinder = sgre::RouteFinder::create(graphBuilder.build(), _config);
+                    } catch (const std::exception& ex) {
+                        throw GenericException("Failed to create routing graph", ex.what());
+                    }
+
+                    std::lock_guard<std::mutex> cacheLock(_RouteFinderCacheMutex);
+                    _RouteFinderCache.emplace_front(cacheKey, _cachedRouteFinder);
+                    if (_RouteFinderCache.size() > ROUTE_FINDER_CACHE_SIZE) {
+                        _RouteFinderCache.pop_back();
                     }
-                    ruleList.filter(_profile);
-                    sgre::GraphBuilder graphBuilder(std::move(ruleList));
-                    graphBuilder.importGeoJSON(_featureData);
-                    _cachedRouteFinder = sgre::RouteFinder::create(graphBuilder.build(), _config);
-                } catch (const std::exception& ex) {
-                    throw GenericException("Failed to create routing graph", ex.what());
                 }
             }
             routeFinder = _cachedRouteFinder;
@@ -242,6 +268,9 @@ namespace carto {
         return true;
     }
 
+    std::list<std::pair<std::string, std::shared_ptr<sgre::RouteFinder> > > SGREOfflineRoutingService::_RouteFinderCache;
+    std::mutex SGREOfflineRoutingService::_RouteFinderCacheMutex;
+
 }
 
 #endif
@@ -14,7 +14,9 @@
 
 #include <memory>
 #include <mutex>
+#include <list>
 #include <string>
+#include <utility>
 
 #include <picojson/picojson.h>
 
@@ -70,6 +72,8 @@ namespace carto {
         
         static bool TranslateInstructionCode(int instructionCode, RoutingAction::RoutingAction& action);
 
+        static const std::size_t ROUTE_FINDER_CACHE_SIZE = 4;
+
         picojson::value _featureData;
         picojson::value _config;
         std::string _profile;
@@ -77,6 +81,11 @@ namespace carto {
         mutable std::shared_ptr<sgre::RouteFinder> _cachedRouteFinder;
 
         mutable std::mutex _mutex;
+
+        // Process-wide cache of built routing graphs, so that recreating the service
+        // with the same data does not trigger a rebuild. Most recently used graphs are at the front.
+        static std::list<std::pair<std::string, std::shared_ptr<sgre::RouteFinder> > > _RouteFinderCache;
+        static std::mutex _RouteFinderCacheMutex;
     };
     
 }
@@ -2,12 +2,16 @@
 
 #include "ValhallaOfflineRoutingService.h"
 #include "components/Exceptions.h"
+#include "routing/RouteMatchingCompletionListener.h"
 #include "routing/RouteMatchingRequest.h"
 #include "routing/RouteMatchingResult.h"
+#include "routing/RoutingTask.h"
 #include "routing/ValhallaRoutingProxy.h"
 #include "utils/Const.h"
 #include "utils/Log.h"
 
+#include <algorithm>
+
 #include <sqlite3pp.h>
 
 namespace carto {
@@ -15,6 +19,9 @@ namespace carto {
     ValhallaOfflineRoutingService::ValhallaOfflineRoutingService(const std::string& path) :
         _database(),
         _profile("pedestrian"),
+        _cacheSize(DEFAULT_CACHE_SIZE),
+        _cachedRoutingContext(),
+        _pendingTask(),
         _mutex()
     {
         _database.reset(new sqlite3pp::database());
@@ -33,7 +40,23 @@ namespace carto {
 
     void ValhallaOfflineRoutingService::setProfile(const std::string& profile) {
         std::lock_guard<std::mutex> lock(_mutex);
-        _profile = profile;
+        if (profile != _profile) {
+            _profile = profile;
+            _cachedRoutingContext.reset();
+        }
+    }
+
+    std::size_t ValhallaOfflineRoutingService::getCacheSize() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _cacheSize;
+    }
+
+    void ValhallaOfflineRoutingService::setCacheSize(std::size_t sizeInBytes) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _cacheSize = sizeInBytes;
+        if (_cachedRoutingContext) {
+            ValhallaRoutingProxy::SetRoutingContextCacheSize(_cachedRoutingContext, sizeInBytes);
+        }
     }
 
     std::shared_ptr<RouteMatchingResult> ValhallaOfflineRoutingService::matchRoute(const std::shared_ptr<RouteMatchingRequest>& request) const {
@@ -41,7 +64,19 @@ namespace carto {
             throw NullArgumentException("Null request");
         }
 
-        return ValhallaRoutingProxy::MatchRoute(std::vector<std::shared_ptr<sqlite3pp::database> > { _database }, getProfile(), request);
+        return ValhallaRoutingProxy::MatchRoute(getRoutingContext(), request);
+    }
+
+    std::shared_ptr<RoutingTask> ValhallaOfflineRoutingService::matchRoutes(const std::vector<std::shared_ptr<RouteMatchingRequest> >& requests, const std::shared_ptr<RouteMatchingCompletionListener>& listener) const {
+        for (const std::shared_ptr<RouteMatchingRequest>& request : requests) {
+            if (!request) {
+                throw NullArgumentException("Null request");
+            }
+        }
+
+        auto routingTask = std::make_shared<RoutingTask>();
+        scheduleTask(std::make_shared<MatchRoutesTask>(std::static_pointer_cast<const ValhallaOfflineRoutingService>(shared_from_this()), requests, routingTask, listener));
+        return routingTask;
     }
 
     std::shared_ptr<RoutingResult> ValhallaOfflineRoutingService::calculateRoute(const std::shared_ptr<RoutingRequest>& request) const {
@@ -49,7 +84,80 @@ namespace carto {
             throw NullArgumentException("Null request");
         }
 
-        return ValhallaRoutingProxy::CalculateRoute(std::vector<std::shared_ptr<sqlite3pp::database> > { _database }, getProfile(), request);
+        return ValhallaRoutingProxy::CalculateRoute(getRoutingContext(), request, std::shared_ptr<RoutingTask>());
+    }
+
+    std::shared_ptr<RoutingTask> ValhallaOfflineRoutingService::calculateRouteAsync(const std::shared_ptr<RoutingRequest>& request, const std::shared_ptr<RoutingCompletionListener>& listener) const {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (std::shared_ptr<RoutingTask> pendingTask = _pendingTask.lock()) {
+                // Coalesce reroute requests, only the latest request is worth calculating
+                pendingTask->cancel();
+            }
+        }
+
+        std::shared_ptr<RoutingTask> task = RoutingService::calculateRouteAsync(request, listener);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _pendingTask = task;
+        return task;
+    }
+
+    std::shared_ptr<RoutingResult> ValhallaOfflineRoutingService::calculateRouteTask(const std::shared_ptr<RoutingRequest>& request, const std::shared_ptr<RoutingTask>& task) const {
+        return ValhallaRoutingProxy::CalculateRoute(getRoutingContext(), request, task);
+    }
+
+    std::shared_ptr<ValhallaRoutingContext> ValhallaOfflineRoutingService::getRoutingContext() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_cachedRoutingContext) {
+            _cachedRoutingContext = ValhallaRoutingProxy::CreateRoutingContext(std::vector<std::shared_ptr<sqlite3pp::database> > { _database }, _profile);
+            ValhallaRoutingProxy::SetRoutingContextCacheSize(_cachedRoutingContext, _cacheSize);
+        }
+        return _cachedRoutingContext;
+    }
+
+    ValhallaOfflineRoutingService::MatchRoutesTask::MatchRoutesTask(const std::shared_ptr<const ValhallaOfflineRoutingService>& service, const std::vector<std::shared_ptr<RouteMatchingRequest> >& requests, const std::shared_ptr<RoutingTask>& routingTask, const std::shared_ptr<RouteMatchingCompletionListener>& listener) :
+        CancelableTask(),
+        _service(service),
+        _requests(requests),
+        _routingTask(routingTask),
+        _listener(listener)
+    {
+    }
+
+    void ValhallaOfflineRoutingService::MatchRoutesTask::run() {
+        std::shared_ptr<const ValhallaOfflineRoutingService> service = _service.lock();
+        if (!service || _routingTask->isCanceled()) {
+            if (_listener) {
+                _listener->onRouteMatchingCancelled();
+            }
+            return;
+        }
+
+        try {
+            // Process the batch on parallel workers. The first context has the warm tile cache,
+            // the extra contexts are throwaway instances for the duration of the batch.
+            std::size_t workerCount = std::min(_requests.size(), static_cast<std::size_t>(MAX_MATCHING_WORKERS));
+            std::vector<std::shared_ptr<ValhallaRoutingContext> > contexts;
+            contexts.reserve(workerCount);
+            for (std::size_t i = 0; i < workerCount; i++) {
+                if (i == 0) {
+                    contexts.push_back(service->getRoutingContext());
+                } else {
+                    std::shared_ptr<ValhallaRoutingContext> context = ValhallaRoutingProxy::CreateRoutingContext(std::vector<std::shared_ptr<sqlite3pp::database> > { service->_database }, service->getProfile());
+                    ValhallaRoutingProxy::SetRoutingContextCacheSize(context, service->getCacheSize());
+                    contexts.push_back(context);
+                }
+            }
+
+            ValhallaRoutingProxy::MatchRoutes(contexts, _requests, _routingTask, _listener.get());
+        }
+        catch (const std::exception& ex) {
+            Log::Errorf("ValhallaOfflineRoutingService::MatchRoutesTask: Exception while matching routes: %s", ex.what());
+            if (_listener) {
+                _listener->onRouteMatchingCancelled();
+            }
+        }
     }
 
 }
@@ -14,14 +14,17 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 namespace sqlite3pp {
     class database;
 }
 
 namespace carto {
+    class RouteMatchingCompletionListener;
     class RouteMatchingRequest;
     class RouteMatchingResult;
+    class ValhallaRoutingContext;
 
     /**
      * An offline routing service that uses Valhalla routing tiles.
@@ -47,6 +50,18 @@ namespace carto {
          */
         void setProfile(const std::string& profile);
 
+        /**
+         * Returns the maximum size of the graph tile cache.
+         * @return The maximum size of the graph tile cache in bytes.
+         */
+        std::size_t getCacheSize() const;
+        /**
+         * Sets the maximum size of the graph tile cache. The cache keeps recently used graph tiles
+         * in memory across requests, making repeated reroutes along the same corridor faster.
+         * @param sizeInBytes The new maximum size of the cache in bytes. The default is 16MB.
+         */
+        void setCacheSize(std::size_t sizeInBytes);
+
         /**
          * Matches specified points to the points on road network.
          * @param request The matching request.
@@ -55,11 +70,57 @@ namespace carto {
          */
         std::shared_ptr<RouteMatchingResult> matchRoute(const std::shared_ptr<RouteMatchingRequest>& request) const;
 
+        /**
+         * Starts asynchronous batch route matching. The requests are processed in a background
+         * thread on parallel workers that share the warm graph tile caches and the given listener
+         * is notified of individual results as they complete.
+         * @param requests The list of route matching requests to process.
+         * @param listener The listener to notify of the results. Can be null.
+         * @return A task handle that can be used to cancel the pending batch.
+         * @throws std::runtime_error If an error occured while starting the batch.
+         */
+        std::shared_ptr<RoutingTask> matchRoutes(const std::vector<std::shared_ptr<RouteMatchingRequest> >& requests, const std::shared_ptr<RouteMatchingCompletionListener>& listener) const;
+
         virtual std::shared_ptr<RoutingResult> calculateRoute(const std::shared_ptr<RoutingRequest>& request) const;
 
+        /**
+         * Starts an asynchronous routing calculation. Unlike the generic base class method,
+         * a pending calculation previously started through this service is cancelled first,
+         * so only the latest request gets fully calculated.
+         * @param request The routing request defining via points.
+         * @param listener The listener to notify of the outcome. Can be null.
+         * @return A task handle that can be used to cancel the pending calculation.
+         * @throws std::runtime_error If an error occured while starting the calculation.
+         */
+        virtual std::shared_ptr<RoutingTask> calculateRouteAsync(const std::shared_ptr<RoutingRequest>& request, const std::shared_ptr<RoutingCompletionListener>& listener) const;
+
+    protected:
+        virtual std::shared_ptr<RoutingResult> calculateRouteTask(const std::shared_ptr<RoutingRequest>& request, const std::shared_ptr<RoutingTask>& task) const;
+
     private:
+        class MatchRoutesTask : public CancelableTask {
+        public:
+            MatchRoutesTask(const std::shared_ptr<const ValhallaOfflineRoutingService>& service, const std::vector<std::shared_ptr<RouteMatchingRequest> >& requests, const std::shared_ptr<RoutingTask>& routingTask, const std::shared_ptr<RouteMatchingCompletionListener>& listener);
+
+            virtual void run();
+
+        private:
+            std::weak_ptr<const ValhallaOfflineRoutingService> _service;
+            std::vector<std::shared_ptr<RouteMatchingRequest> > _requests;
+            std::shared_ptr<RoutingTask> _routingTask;
+            DirectorPtr<RouteMatchingCompletionListener> _listener;
+        };
+
+        std::shared_ptr<ValhallaRoutingContext> getRoutingContext() const;
+
+        static const int DEFAULT_CACHE_SIZE = 16 * 1024 * 1024;
+        static const int MAX_MATCHING_WORKERS = 4;
+
         std::shared_ptr<sqlite3pp::database> _database;
         std::string _profile;
+        std::size_t _cacheSize;
+        mutable std::shared_ptr<ValhallaRoutingContext> _cachedRoutingContext;
+        mutable std::weak_ptr<RoutingTask> _pendingTask;
         mutable std::mutex _mutex;
     };
     
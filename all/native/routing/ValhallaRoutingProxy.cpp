@@ -5,8 +5,10 @@
 #include "components/Exceptions.h"
 #include "projections/Projection.h"
 #include "projections/EPSG3857.h"
+#include "routing/RouteMatchingCompletionListener.h"
 #include "routing/RouteMatchingRequest.h"
 #include "routing/RouteMatchingResult.h"
+#include "routing/RoutingTask.h"
 #include "network/HTTPClient.h"
 #include "utils/NetworkUtils.h"
 #include "utils/Const.h"
@@ -20,6 +22,8 @@
 #include <vector>
 #include <unordered_map>
 #include <cstdint>
+#include <mutex>
+#include <thread>
 #include <sstream>
 #include <strstream>
 
@@ -89,7 +93,7 @@ namespace valhalla { namespace meili {
 
     class map_matcher_factory_t {
     public:
-        map_matcher_factory_t(const std::vector<std::shared_ptr<sqlite3pp::database>>& databases, const std::string& costing);
+        map_matcher_factory_t(const std::vector<std::shared_ptr<sqlite3pp::database>>& databases, const std::string& costing, std::size_t max_cache_size);
         ~map_matcher_factory_t();
 
         baldr::GraphReader& graphreader()
@@ -117,7 +121,7 @@ namespace valhalla { namespace meili {
     private:
         typedef sif::cost_ptr_t (*factory_function_t)(const boost::property_tree::ptree&);
 
-        static boost::property_tree::ptree make_reader_config();
+        static boost::property_tree::ptree make_reader_config(std::size_t max_cache_size);
         static boost::property_tree::ptree make_meili_config(const std::string& costing);
 
         boost::property_tree::ptree config_;
@@ -136,9 +140,9 @@ namespace valhalla { namespace meili {
                                                 const std::string& costing);
     };
 
-    map_matcher_factory_t::map_matcher_factory_t(const std::vector<std::shared_ptr<sqlite3pp::database>>& databases, const std::string& costing)
+    map_matcher_factory_t::map_matcher_factory_t(const std::vector<std::shared_ptr<sqlite3pp::database>>& databases, const std::string& costing, std::size_t max_cache_size)
         : config_(make_meili_config(costing)),
-          graphreader_(std::make_shared<baldr::GraphTileMBTStorage>(databases), make_reader_config()),
+          graphreader_(std::make_shared<baldr::GraphTileMBTStorage>(databases), make_reader_config(max_cache_size)),
           candidatequery_(graphreader_,
                           local_tile_size(graphreader_)/500,
                           local_tile_size(graphreader_)/500),
@@ -154,9 +158,9 @@ namespace valhalla { namespace meili {
     map_matcher_factory_t::~map_matcher_factory_t() {
     }
 
-    boost::property_tree::ptree map_matcher_factory_t::make_reader_config() {
+    boost::property_tree::ptree map_matcher_factory_t::make_reader_config(std::size_t max_cache_size) {
         boost::property_tree::ptree config;
-        config.put("max_cache_size", 16 * 1024 * 1024);
+        config.put("max_cache_size", max_cache_size);
         config.put("tile_dir", "");
         return config;
     }
@@ -282,13 +286,17 @@ namespace valhalla { namespace thor {
 
     class thor_worker_t {
     public:
-        thor_worker_t(const std::vector<std::shared_ptr<sqlite3pp::database>>& databases, const std::string& costing);
+        thor_worker_t(const std::vector<std::shared_ptr<sqlite3pp::database>>& databases, const std::string& costing, std::size_t max_cache_size);
         virtual ~thor_worker_t();
 
         std::list<valhalla::odin::TripPath> path_depart_at(const std::vector<valhalla::midgard::PointLL>& points, const boost::optional<int>& date_time_type);
 
+        void cleanup();
+
     protected:
-        static boost::property_tree::ptree make_reader_config();
+        static boost::property_tree::ptree make_reader_config(std::size_t max_cache_size);
+
+        void init_costing();
 
         void update_origin(baldr::PathLocation& origin, bool prior_is_node, const baldr::GraphId& through_edge);
         void get_path(PathAlgorithm* path_algorithm, baldr::PathLocation& origin, baldr::PathLocation& destination, std::vector<thor::PathInfo>& path_edges);
@@ -317,7 +325,7 @@ namespace valhalla { namespace thor {
         boost::optional<int> date_time_type;
     };
 
-    thor_worker_t::thor_worker_t(const std::vector<std::shared_ptr<sqlite3pp::database> >& databases, const std::string& costing) : reader(std::make_shared<baldr::GraphTileMBTStorage>(databases), make_reader_config()), costing(costing) {
+    thor_worker_t::thor_worker_t(const std::vector<std::shared_ptr<sqlite3pp::database> >& databases, const std::string& costing, std::size_t max_cache_size) : reader(std::make_shared<baldr::GraphTileMBTStorage>(databases), make_reader_config(max_cache_size)), costing(costing) {
         factory.Register("auto", sif::CreateAutoCost);
         factory.Register("auto_shorter", sif::CreateAutoShorterCost);
         factory.Register("bus", sif::CreateBusCost);
@@ -327,6 +335,30 @@ namespace valhalla { namespace thor {
         factory.Register("truck", sif::CreateTruckCost);
         factory.Register("transit", sif::CreateTransitCost);
 
+        init_costing();
+    }
+
+    thor_worker_t::~thor_worker_t() {
+    }
+
+    void thor_worker_t::cleanup() {
+        // Clear per-request state of the path algorithms, but keep the reader with its warm tile cache
+        astar.Clear();
+        bidir_astar.Clear();
+        multi_modal_astar.Clear();
+
+        // Recreate the costing instances, the hierarchy limits may have been relaxed during the search
+        init_costing();
+    }
+
+    boost::property_tree::ptree thor_worker_t::make_reader_config(std::size_t max_cache_size) {
+        boost::property_tree::ptree config;
+        config.put("max_cache_size", max_cache_size);
+        config.put("tile_dir", "");
+        return config;
+    }
+
+    void thor_worker_t::init_costing() {
         boost::property_tree::ptree config_costing;
         if (costing == "multimodal" || costing == "transit") {
             mode_costing[0] = factory.Create("auto", config_costing);
@@ -341,16 +373,6 @@ namespace valhalla { namespace thor {
             mode_costing[static_cast<uint32_t>(mode)] = cost;
         }
     }
-    
-    thor_worker_t::~thor_worker_t() {
-    }
-
-    boost::property_tree::ptree thor_worker_t::make_reader_config() {
-        boost::property_tree::ptree config;
-        config.put("max_cache_size", 16 * 1024 * 1024);
-        config.put("tile_dir", "");
-        return config;
-    }
 
     thor::PathAlgorithm* thor_worker_t::get_path_algorithm(const std::string& routetype,
         const baldr::PathLocation& origin, const baldr::PathLocation& destination) {
@@ -627,6 +649,80 @@ namespace valhalla { namespace thor {
 
 namespace carto {
 
+    // A context object that persists the warm graph reader state (tile caches) across requests.
+    // Without a context, each request re-reads the graph tiles it touches from package storage.
+    class ValhallaRoutingContext {
+    public:
+        ValhallaRoutingContext(const std::vector<std::shared_ptr<sqlite3pp::database> >& databases, const std::string& profile) :
+            _databases(databases),
+            _profile(profile),
+            _cacheSize(DEFAULT_CACHE_SIZE),
+            _matcherFactory(),
+            _matcher(),
+            _worker(),
+            _mutex()
+        {
+        }
+
+        const std::string& getProfile() const {
+            return _profile;
+        }
+
+        void setCacheSize(std::size_t sizeInBytes) {
+            std::lock_guard<std::recursive_mutex> lock(_mutex);
+            if (sizeInBytes != _cacheSize) {
+                _cacheSize = sizeInBytes;
+                // The cache limit is fixed at reader construction time, drop the cached instances
+                _matcher.reset();
+                _matcherFactory.reset();
+                _worker.reset();
+            }
+        }
+
+        std::shared_ptr<valhalla::meili::MapMatcher> getMatcher() {
+            std::lock_guard<std::recursive_mutex> lock(_mutex);
+            if (!_matcher) {
+                _matcherFactory = std::make_shared<valhalla::meili::map_matcher_factory_t>(_databases, _profile, _cacheSize);
+                _matcher = std::shared_ptr<valhalla::meili::MapMatcher>(_matcherFactory->Create(_profile));
+                if (!_matcher) {
+                    throw std::runtime_error("Failed to create matcher instance");
+                }
+            }
+            return _matcher;
+        }
+
+        std::shared_ptr<valhalla::thor::thor_worker_t> getWorker() {
+            std::lock_guard<std::recursive_mutex> lock(_mutex);
+            if (!_worker) {
+                _worker = std::make_shared<valhalla::thor::thor_worker_t>(_databases, _profile, _cacheSize);
+            }
+            return _worker;
+        }
+
+        std::recursive_mutex& getMutex() {
+            return _mutex;
+        }
+
+    private:
+        static const std::size_t DEFAULT_CACHE_SIZE = 16 * 1024 * 1024;
+
+        const std::vector<std::shared_ptr<sqlite3pp::database> > _databases;
+        const std::string _profile;
+        std::size_t _cacheSize;
+        std::shared_ptr<valhalla::meili::map_matcher_factory_t> _matcherFactory; // NOTE: the matcher references the factory, keep the factory alive
+        std::shared_ptr<valhalla::meili::MapMatcher> _matcher;
+        std::shared_ptr<valhalla::thor::thor_worker_t> _worker;
+        mutable std::recursive_mutex _mutex;
+    };
+
+    std::shared_ptr<ValhallaRoutingContext> ValhallaRoutingProxy::CreateRoutingContext(const std::vector<std::shared_ptr<sqlite3pp::database> >& databases, const std::string& profile) {
+        return std::make_shared<ValhallaRoutingContext>(databases, profile);
+    }
+
+    void ValhallaRoutingProxy::SetRoutingContextCacheSize(const std::shared_ptr<ValhallaRoutingContext>& context, std::size_t sizeInBytes) {
+        context->setCacheSize(sizeInBytes);
+    }
+
     std::shared_ptr<RouteMatchingResult> ValhallaRoutingProxy::MatchRoute(const std::string& baseURL, const std::string& profile, const std::shared_ptr<RouteMatchingRequest>& request) {
         EPSG3857 epsg3857;
         std::shared_ptr<Projection> proj = request->getProjection();
@@ -660,15 +756,15 @@ namespace carto {
             throw NetworkException("Failed to fetch response"); // NOTE: we may have error messages, thus do not return from here
         }
 
-        std::string responseString;
-        if (responseData) {
-            responseString = std::string(reinterpret_cast<const char*>(responseData->data()), responseData->size());
-        } else {
+        if (!responseData) {
             throw GenericException("Empty response");
         }
 
+        // Parse the response in place, without copying it into an intermediate string
         picojson::value response;
-        std::string err = picojson::parse(response, responseString);
+        std::string err;
+        const char* responseBegin = reinterpret_cast<const char*>(responseData->data());
+        picojson::parse(response, responseBegin, responseBegin + responseData->size(), &err);
         if (!err.empty()) {
             throw GenericException("Failed to parse response", err);
         }
@@ -701,6 +797,10 @@ namespace carto {
     }
 
     std::shared_ptr<RouteMatchingResult> ValhallaRoutingProxy::MatchRoute(const std::vector<std::shared_ptr<sqlite3pp::database> >& databases, const std::string& profile, const std::shared_ptr<RouteMatchingRequest>& request) {
+        return MatchRoute(CreateRoutingContext(databases, profile), request);
+    }
+
+    std::shared_ptr<RouteMatchingResult> ValhallaRoutingProxy::MatchRoute(const std::shared_ptr<ValhallaRoutingContext>& context, const std::shared_ptr<RouteMatchingRequest>& request) {
         EPSG3857 epsg3857;
         std::shared_ptr<Projection> proj = request->getProjection();
 
@@ -713,11 +813,8 @@ namespace carto {
                 measurements.emplace_back(lnglat, request->getAccuracy(), searchRadius);
             }
 
-            valhalla::meili::map_matcher_factory_t factory(databases, profile);
-            std::shared_ptr<valhalla::meili::MapMatcher> matcher(factory.Create(profile));
-            if (!matcher) {
-                throw std::runtime_error("Failed to create matcher instance");
-            }
+            std::lock_guard<std::recursive_mutex> lock(context->getMutex());
+            std::shared_ptr<valhalla::meili::MapMatcher> matcher = context->getMatcher();
 
             std::vector<valhalla::meili::MatchResult> matchResults = matcher->OfflineMatch(measurements);
 
@@ -733,6 +830,55 @@ namespace carto {
         }
     }
 
+    void ValhallaRoutingProxy::MatchRoutes(const std::vector<std::shared_ptr<ValhallaRoutingContext> >& contexts, const std::vector<std::shared_ptr<RouteMatchingRequest> >& requests, const std::shared_ptr<RoutingTask>& task, const std::shared_ptr<RouteMatchingCompletionListener>& listener) {
+        std::mutex listenerMutex;
+
+        // Distribute the requests between the contexts, each context is processed by a dedicated worker thread
+        std::vector<std::thread> workers;
+        workers.reserve(contexts.size());
+        for (std::size_t workerIndex = 0; workerIndex < contexts.size(); workerIndex++) {
+            workers.emplace_back([&, workerIndex]() {
+                for (std::size_t i = workerIndex; i < requests.size(); i += contexts.size()) {
+                    if (task && task->isCanceled()) {
+                        return;
+                    }
+
+                    std::shared_ptr<RouteMatchingResult> result;
+                    std::string errorMessage;
+                    try {
+                        result = MatchRoute(contexts[workerIndex], requests[i]);
+                    }
+                    catch (const std::exception& ex) {
+                        errorMessage = ex.what();
+                    }
+
+                    if (task && task->isCanceled()) {
+                        return;
+                    }
+                    if (listener) {
+                        std::lock_guard<std::mutex> lock(listenerMutex);
+                        if (result) {
+                            listener->onRouteMatched(requests[i], result);
+                        } else {
+                            listener->onRouteMatchingFailed(requests[i], errorMessage);
+                        }
+                    }
+                }
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+
+        if (listener) {
+            if (task && task->isCanceled()) {
+                listener->onRouteMatchingCancelled();
+            } else {
+                listener->onRouteMatchingCompleted();
+            }
+        }
+    }
+
     std::shared_ptr<RoutingResult> ValhallaRoutingProxy::CalculateRoute(const std::string& baseURL, const std::string& profile, const std::shared_ptr<RoutingRequest>& request) {
         EPSG3857 epsg3857;
         std::shared_ptr<Projection> proj = request->getProjection();
@@ -768,15 +914,15 @@ namespace carto {
             throw NetworkException("Failed to fetch response"); // NOTE: we may have error messages, thus do not return from here
         }
 
-        std::string responseString;
-        if (responseData) {
-            responseString = std::string(reinterpret_cast<const char*>(responseData->data()), responseData->size());
-        } else {
+        if (!responseData) {
             throw GenericException("Empty response");
         }
 
+        // Parse the response in place, without copying it into an intermediate string
         picojson::value response;
-        std::string err = picojson::parse(response, responseString);
+        std::string err;
+        const char* responseBegin = reinterpret_cast<const char*>(responseData->data());
+        picojson::parse(response, responseBegin, responseBegin + responseData->size(), &err);
         if (!err.empty()) {
             throw GenericException("Failed to parse response", err);
         }
@@ -836,9 +982,17 @@ namespace carto {
     }
 
     std::shared_ptr<RoutingResult> ValhallaRoutingProxy::CalculateRoute(const std::vector<std::shared_ptr<sqlite3pp::database> >& databases, const std::string& profile, const std::shared_ptr<RoutingRequest>& request) {
+        return CalculateRoute(databases, profile, request, std::shared_ptr<RoutingTask>());
+    }
+
+    std::shared_ptr<RoutingResult> ValhallaRoutingProxy::CalculateRoute(const std::vector<std::shared_ptr<sqlite3pp::database> >& databases, const std::string& profile, const std::shared_ptr<RoutingRequest>& request, const std::shared_ptr<RoutingTask>& task) {
+        return CalculateRoute(CreateRoutingContext(databases, profile), request, task);
+    }
+
+    std::shared_ptr<RoutingResult> ValhallaRoutingProxy::CalculateRoute(const std::shared_ptr<ValhallaRoutingContext>& context, const std::shared_ptr<RoutingRequest>& request, const std::shared_ptr<RoutingTask>& task) {
         EPSG3857 epsg3857;
         std::shared_ptr<Projection> proj = request->getProjection();
-        
+
         std::list<valhalla::odin::TripPath> tripPaths;
         try {
             std::vector<valhalla::midgard::PointLL> points;
@@ -846,11 +1000,26 @@ namespace carto {
                 MapPos posWgs84 = proj->toWgs84(pos);
                 points.emplace_back(static_cast<float>(posWgs84.getX()), static_cast<float>(posWgs84.getY()));
             }
-            
-            valhalla::thor::thor_worker_t worker(databases, profile);
-            tripPaths = worker.path_depart_at(points, profile == "multimodal" ? boost::optional<int>(0) : boost::optional<int>());
+
+            if (task && task->isCanceled()) {
+                return std::shared_ptr<RoutingResult>();
+            }
+
+            std::lock_guard<std::recursive_mutex> lock(context->getMutex());
+            std::shared_ptr<valhalla::thor::thor_worker_t> worker = context->getWorker();
+            try {
+                tripPaths = worker->path_depart_at(points, context->getProfile() == "multimodal" ? boost::optional<int>(0) : boost::optional<int>());
+            }
+            catch (...) {
+                worker->cleanup();
+                throw;
+            }
+            worker->cleanup();
         }
         catch (const std::exception& ex) {
+            if (task && task->isCanceled()) {
+                return std::shared_ptr<RoutingResult>();
+            }
             throw GenericException("Exception while calculating route", ex.what());
         }
 
@@ -859,6 +1028,11 @@ namespace carto {
         std::vector<RoutingInstruction> instructions;
 
         for (valhalla::odin::TripPath& tripPath : tripPaths) {
+            if (task && task->isCanceled()) {
+                // The route is no longer needed, abandon the remaining legs
+                return std::shared_ptr<RoutingResult>();
+            }
+
             valhalla::odin::DirectionsOptions directionsOptions;
             valhalla::odin::DirectionsBuilder directions;
             valhalla::odin::TripDirections tripDirections;
@@ -19,16 +19,27 @@ namespace sqlite3pp {
 }
 
 namespace carto {
+    class RouteMatchingCompletionListener;
     class RouteMatchingRequest;
     class RouteMatchingResult;
-    
+    class RoutingTask;
+    class ValhallaRoutingContext;
+
     class ValhallaRoutingProxy {
     public:
+        static std::shared_ptr<ValhallaRoutingContext> CreateRoutingContext(const std::vector<std::shared_ptr<sqlite3pp::database> >& databases, const std::string& profile);
+        static void SetRoutingContextCacheSize(const std::shared_ptr<ValhallaRoutingContext>& context, std::size_t sizeInBytes);
+
         static std::shared_ptr<RouteMatchingResult> MatchRoute(const std::string& baseURL, const std::string& profile, const std::shared_ptr<RouteMatchingRequest>& request);
         static std::shared_ptr<RouteMatchingResult> MatchRoute(const std::vector<std::shared_ptr<sqlite3pp::database> >& databases, const std::string& profile, const std::shared_ptr<RouteMatchingRequest>& request);
+        static std::shared_ptr<RouteMatchingResult> MatchRoute(const std::shared_ptr<ValhallaRoutingContext>& context, const std::shared_ptr<RouteMatchingRequest>& request);
+
+        static void MatchRoutes(const std::vector<std::shared_ptr<ValhallaRoutingContext> >& contexts, const std::vector<std::shared_ptr<RouteMatchingRequest> >& requests, const std::shared_ptr<RoutingTask>& task, const std::shared_ptr<RouteMatchingCompletionListener>& listener);
 
         static std::shared_ptr<RoutingResult> CalculateRoute(const std::string& baseURL, const std::string& profile, const std::shared_ptr<RoutingRequest>& request);
         static std::shared_ptr<RoutingResult> CalculateRoute(const std::vector<std::shared_ptr<sqlite3pp::database> >& databases, const std::string& profile, const std::shared_ptr<RoutingRequest>& request);
+        static std::shared_ptr<RoutingResult> CalculateRoute(const std::vector<std::shared_ptr<sqlite3pp::database> >& databases, const std::string& profile, const std::shared_ptr<RoutingRequest>& request, const std::shared_ptr<RoutingTask>& task);
+        static std::shared_ptr<RoutingResult> CalculateRoute(const std::shared_ptr<ValhallaRoutingContext>& context, const std::shared_ptr<RoutingRequest>& request, const std::shared_ptr<RoutingTask>& task);
         
     private:
         ValhallaRoutingProxy();
@@ -50,7 +50,7 @@ namespace carto {
                 features.push_back(feature);
             }
         }
-        return std::make_shared<FeatureCollection>(features);
+        return std::make_shared<FeatureCollection>(std::move(features));
     }
 
 }
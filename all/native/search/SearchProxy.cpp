@@ -12,6 +12,7 @@
 #include "geometry/MultiLineGeometry.h"
 #include "geometry/MultiPolygonGeometry.h"
 #include "geometry/MultiGeometry.h"
+#include "geometry/VectorTileFeatureData.h"
 #include "search/query/QueryContext.h"
 #include "search/query/QueryExpressionParser.h"
 #include "projections/Projection.h"
@@ -26,6 +27,7 @@
 #include <boost/variant.hpp>
 #include <boost/optional.hpp>
 
+#include <cmath>
 #include <limits>
 #include <algorithm>
 #include <numeric>
@@ -84,19 +86,26 @@ namespace {
         }
     }
 
-    BoostGeometryType convertToBoostGeometry(const std::shared_ptr<carto::Geometry>& geometry) {
+    void convertToBoostGeometry(const std::shared_ptr<carto::Geometry>& geometry, BoostGeometryType& boostGeometry) {
         if (auto pointGeometry = std::dynamic_pointer_cast<carto::PointGeometry>(geometry)) {
             carto::MapPos mapPos = pointGeometry->getPos();
-            BoostPointType boostPoint(mapPos.getX(), mapPos.getY());
-            return boostPoint;
+            boostGeometry = BoostPointType(mapPos.getX(), mapPos.getY());
         } else if (auto lineGeometry = std::dynamic_pointer_cast<carto::LineGeometry>(geometry)) {
+            if (!boost::get<BoostLinestringType>(&boostGeometry)) {
+                boostGeometry = BoostLinestringType();
+            }
+            BoostLinestringType& boostLinestring = boost::get<BoostLinestringType>(boostGeometry);
+            boostLinestring.clear();
             const std::vector<carto::MapPos>& mapPoses = lineGeometry->getPoses();
-            BoostLinestringType boostLinestring;
             std::for_each(mapPoses.begin(), mapPoses.end(), [&boostLinestring](const carto::MapPos& mapPos) { boostLinestring.push_back(BoostPointType(mapPos.getX(), mapPos.getY())); });
-            return boostLinestring;
         } else if (auto polygonGeometry = std::dynamic_pointer_cast<carto::PolygonGeometry>(geometry)) {
+            if (!boost::get<BoostPolygonType>(&boostGeometry)) {
+                boostGeometry = BoostPolygonType();
+            }
+            BoostPolygonType& boostPolygon = boost::get<BoostPolygonType>(boostGeometry);
+            boostPolygon.outer().clear();
+            boostPolygon.inners().clear();
             const std::vector<std::vector<carto::MapPos> >& rings = polygonGeometry->getRings();
-            BoostPolygonType boostPolygon;
             for (std::size_t i = 0; i < rings.size(); i++) {
                 BoostPolygonType::ring_type boostRing;
                 std::for_each(rings[i].begin(), rings[i].end(), [&boostRing](const carto::MapPos& mapPos) { boostRing.push_back(BoostPointType(mapPos.getX(), mapPos.getY())); });
@@ -106,7 +115,6 @@ namespace {
                     boostPolygon.inners().push_back(std::move(boostRing));
                 }
             }
-            return boostPolygon;
         } else {
             throw carto::GenericException("Unsupported geometry type");
         }
@@ -129,7 +137,57 @@ namespace {
             return dist;
         }
 
-        return boost::geometry::distance(convertToBoostGeometry(geometry1), convertToBoostGeometry(geometry2));
+        // Reuse thread-local scratch geometries, so that dense searches do not allocate
+        // short-lived coordinate vectors for every tested candidate
+        thread_local BoostGeometryType boostGeometry1;
+        thread_local BoostGeometryType boostGeometry2;
+        convertToBoostGeometry(geometry1, boostGeometry1);
+        convertToBoostGeometry(geometry2, boostGeometry2);
+        return boost::geometry::distance(boostGeometry1, boostGeometry2);
+    }
+
+    double calculateBoundsDistance(const carto::MapBounds& bounds1, const carto::MapBounds& bounds2) {
+        double dx = std::max(std::max(bounds1.getMin().getX() - bounds2.getMax().getX(), bounds2.getMin().getX() - bounds1.getMax().getX()), 0.0);
+        double dy = std::max(std::max(bounds1.getMin().getY() - bounds2.getMax().getY(), bounds2.getMin().getY() - bounds1.getMax().getY()), 0.0);
+        return std::sqrt(dx * dx + dy * dy);
+    }
+
+    std::string GetGeometryType(const std::shared_ptr<carto::Geometry>& geometry) {
+        if (std::dynamic_pointer_cast<carto::PointGeometry>(geometry)) {
+            return "point";
+        } else if (std::dynamic_pointer_cast<carto::LineGeometry>(geometry)) {
+            return "linestring";
+        } else if (std::dynamic_pointer_cast<carto::PolygonGeometry>(geometry)) {
+            return "polygon";
+        } else if (std::dynamic_pointer_cast<carto::MultiPointGeometry>(geometry)) {
+            return "multipoint";
+        } else if (std::dynamic_pointer_cast<carto::MultiLineGeometry>(geometry)) {
+            return "multilinestring";
+        } else if (std::dynamic_pointer_cast<carto::MultiPolygonGeometry>(geometry)) {
+            return "multipolygon";
+        } else if (std::dynamic_pointer_cast<carto::MultiGeometry>(geometry)) {
+            return "multigeometry";
+        } else if (std::dynamic_pointer_cast<carto::Geometry>(geometry)) {
+            return "geometry";
+        }
+        return "unknown";
+    }
+
+    std::size_t GetGeometryVerticesCount(const std::shared_ptr<carto::Geometry>& geometry) {
+        if (std::dynamic_pointer_cast<carto::PointGeometry>(geometry)) {
+            return 1;
+        } else if (auto lineGeometry = std::dynamic_pointer_cast<carto::LineGeometry>(geometry)) {
+            return lineGeometry->getPoses().size();
+        } else if (auto polygonGeometry = std::dynamic_pointer_cast<carto::PolygonGeometry>(geometry)) {
+            return std::accumulate(polygonGeometry->getHoles().begin(), polygonGeometry->getHoles().end(), polygonGeometry->getPoses().size(), [](std::size_t size, const std::vector<carto::MapPos>& ring) { return size + ring.size(); });
+        } else if (auto multiGeometry = std::dynamic_pointer_cast<carto::MultiGeometry>(geometry)) {
+            std::size_t count = 0;
+            for (int i = 0; i < multiGeometry->getGeometryCount(); i++) {
+                count += GetGeometryVerticesCount(multiGeometry->getGeometry(i));
+            }
+            return count;
+        }
+        return 0;
     }
 
     bool matchRegexFilter(const carto::Variant& variant, const std::regex& re) {
@@ -200,48 +258,49 @@ namespace {
         }
 
     private:
-        static std::string GetGeometryType(const std::shared_ptr<carto::Geometry>& geometry) {
-            if (std::dynamic_pointer_cast<carto::PointGeometry>(geometry)) {
-                return "point";
-            } else if (std::dynamic_pointer_cast<carto::LineGeometry>(geometry)) {
-                return "linestring";
-            } else if (std::dynamic_pointer_cast<carto::PolygonGeometry>(geometry)) {
-                return "polygon";
-            } else if (std::dynamic_pointer_cast<carto::MultiPointGeometry>(geometry)) {
-                return "multipoint";
-            } else if (std::dynamic_pointer_cast<carto::MultiLineGeometry>(geometry)) {
-                return "multilinestring";
-            } else if (std::dynamic_pointer_cast<carto::MultiPolygonGeometry>(geometry)) {
-                return "multipolygon";
-            } else if (std::dynamic_pointer_cast<carto::MultiGeometry>(geometry)) {
-                return "multigeometry";
-            } else if (std::dynamic_pointer_cast<carto::Geometry>(geometry)) {
-                return "geometry";
-            }
-            return "unknown";
+        const std::shared_ptr<carto::Geometry>& _geometry;
+        const std::shared_ptr<carto::Projection>& _projection;
+        const std::string* _layerName;
+        const carto::Variant& _variant;
+    };
+
+    bool matchRegexFilter(const carto::VectorTileFeatureData& featureData, const std::regex& re) {
+        for (std::size_t i = 0; i < featureData.getPropertyCount(); i++) {
+            if (matchRegexFilter(featureData.getPropertyValue(i), re)) {
+                return true;
+            }
         }
-        
-        static std::size_t GetGeometryVerticesCount(const std::shared_ptr<carto::Geometry>& geometry) {
-            if (std::dynamic_pointer_cast<carto::PointGeometry>(geometry)) {
-                return 1;
-            } else if (auto lineGeometry = std::dynamic_pointer_cast<carto::LineGeometry>(geometry)) {
-                return lineGeometry->getPoses().size();
-            } else if (auto polygonGeometry = std::dynamic_pointer_cast<carto::PolygonGeometry>(geometry)) {
-                return std::accumulate(polygonGeometry->getHoles().begin(), polygonGeometry->getHoles().end(), polygonGeometry->getPoses().size(), [](std::size_t size, const std::vector<carto::MapPos>& ring) { return size + ring.size(); });
-            } else if (auto multiGeometry = std::dynamic_pointer_cast<carto::MultiGeometry>(geometry)) {
-                std::size_t count = 0;
-                for (int i = 0; i < multiGeometry->getGeometryCount(); i++) {
-                    count += GetGeometryVerticesCount(multiGeometry->getGeometry(i));
-                }
-                return count;
+        return false;
+    }
+
+    class FeatureDataSearchQueryContext : public carto::QueryContext {
+    public:
+        explicit FeatureDataSearchQueryContext(const std::shared_ptr<carto::Geometry>& geometry, const std::string* layerName, const std::shared_ptr<carto::VectorTileFeatureData>& featureData) : _geometry(geometry), _layerName(layerName), _featureData(featureData) { }
+        virtual ~FeatureDataSearchQueryContext() { }
+
+        virtual bool getVariable(const std::string& name, carto::Variant& value) const {
+            if (name == "layer::name") {
+                value = (_layerName ? carto::Variant(*_layerName) : carto::Variant());
+                return true;
+            }
+
+            if (name == "geometry::type") {
+                value = carto::Variant(GetGeometryType(_geometry));
+                return true;
             }
-            return 0;
+
+            if (name == "geometry::vertices") {
+                value = carto::Variant(static_cast<long long>(GetGeometryVerticesCount(_geometry)));
+                return true;
+            }
+
+            return _featureData->getProperty(name, value);
         }
 
+    private:
         const std::shared_ptr<carto::Geometry>& _geometry;
-        const std::shared_ptr<carto::Projection>& _projection;
         const std::string* _layerName;
-        const carto::Variant& _variant;
+        const std::shared_ptr<carto::VectorTileFeatureData>& _featureData;
     };
 
 }
@@ -251,10 +310,13 @@ namespace carto {
     SearchProxy::SearchProxy(const std::shared_ptr<SearchRequest>& request, const MapBounds& mapBounds, const std::shared_ptr<Projection>& proj) :
         _request(request),
         _geometry(),
+        _geometryBounds(),
         _searchBounds(),
         _searchRadius(0),
         _projection(proj),
         _expr(),
+        _layerNameHint(),
+        _valueHint(),
         _re()
     {
         if (!request) {
@@ -280,6 +342,15 @@ namespace carto {
             catch (const std::exception& ex) {
                 throw ParseException(std::string("Failed to parse expression: ") + ex.what(), request->getFilterExpression());
             }
+
+            std::set<std::string> layerNames;
+            if (_expr->getLayerNameHint(layerNames)) {
+                _layerNameHint = std::move(layerNames);
+            }
+            std::set<std::string> values;
+            if (_expr->getValueHint(values)) {
+                _valueHint = std::move(values);
+            }
         }
 
         if (request->getGeometry()) {
@@ -290,6 +361,7 @@ namespace carto {
             MapPos wgs84CenterPos = request->getProjection()->toWgs84(request->getGeometry()->getCenterPos());
             _geometry = convertToEPSG3857(request->getGeometry(), request->getProjection());
             MapBounds geometryBounds = _geometry->getBounds();
+            _geometryBounds = geometryBounds;
             _searchRadius = request->getSearchRadius() / std::cos(std::min(89.9, std::abs(wgs84CenterPos.getY())) * Const::DEG_TO_RAD);
             MapPos boundsPos0 = geometryBounds.getMin() - MapVec(_searchRadius, _searchRadius);
             MapPos boundsPos1 = geometryBounds.getMax() + MapVec(_searchRadius, _searchRadius);
@@ -305,8 +377,22 @@ namespace carto {
         return _searchBounds;
     }
 
+    const boost::optional<std::set<std::string> >& SearchProxy::getLayerNameHint() const {
+        return _layerNameHint;
+    }
+
+    const boost::optional<std::set<std::string> >& SearchProxy::getValueHint() const {
+        return _valueHint;
+    }
+
     bool SearchProxy::testBounds(const MapBounds& bounds) const {
         if (_geometry) {
+            // The distance between the bounding boxes is a lower bound for the precise
+            // distance, so most far-away candidates are rejected without being projected
+            if (calculateBoundsDistance(convertToEPSG3857(bounds, _projection), _geometryBounds) > _searchRadius) {
+                return false;
+            }
+
             std::vector<MapPos> points(4);
             points[0] = bounds.getMin();
             points[1] = MapPos(bounds.getMin().getX(), bounds.getMax().getY());
@@ -336,6 +422,43 @@ namespace carto {
         }
 
         if (_geometry) {
+            // The distance between the bounding boxes is a lower bound for the precise
+            // distance, so most far-away candidates are rejected without being projected
+            if (calculateBoundsDistance(convertToEPSG3857(geometry->getBounds(), _projection), _geometryBounds) > _searchRadius) {
+                return false;
+            }
+            if (calculateDistance(convertToEPSG3857(geometry, _projection), _geometry) > _searchRadius) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool SearchProxy::testElement(const std::shared_ptr<Geometry>& geometry, const std::string* layerName, const std::shared_ptr<VectorTileFeatureData>& featureData) const {
+        if (!featureData) {
+            return testElement(geometry, layerName, Variant());
+        }
+
+        if (_re) {
+            if (!matchRegexFilter(*featureData, *_re)) {
+                return false;
+            }
+        }
+
+        if (_expr) {
+            FeatureDataSearchQueryContext context(geometry, layerName, featureData);
+            if (!_expr->evaluate(context)) {
+                return false;
+            }
+        }
+
+        if (_geometry) {
+            // The distance between the bounding boxes is a lower bound for the precise
+            // distance, so most far-away candidates are rejected without being projected
+            if (calculateBoundsDistance(convertToEPSG3857(geometry->getBounds(), _projection), _geometryBounds) > _searchRadius) {
+                return false;
+            }
             if (calculateDistance(convertToEPSG3857(geometry, _projection), _geometry) > _searchRadius) {
                 return false;
             }
@@ -13,6 +13,8 @@
 #include "search/SearchRequest.h"
 
 #include <memory>
+#include <set>
+#include <string>
 #include <vector>
 #include <regex>
 
@@ -23,6 +25,7 @@ namespace carto {
     class Projection;
     class QueryExpression;
     class Variant;
+    class VectorTileFeatureData;
 
     class SearchProxy {
     public:
@@ -30,17 +33,26 @@ namespace carto {
 
         const MapBounds& getSearchBounds() const;
 
+        const boost::optional<std::set<std::string> >& getLayerNameHint() const;
+
+        const boost::optional<std::set<std::string> >& getValueHint() const;
+
         bool testBounds(const MapBounds& bounds) const;
 
         bool testElement(const std::shared_ptr<Geometry>& geometry, const std::string* layerName, const Variant& var) const;
 
+        bool testElement(const std::shared_ptr<Geometry>& geometry, const std::string* layerName, const std::shared_ptr<VectorTileFeatureData>& featureData) const;
+
     protected:
         std::shared_ptr<SearchRequest> _request;
         std::shared_ptr<Geometry> _geometry;
+        MapBounds _geometryBounds;
         MapBounds _searchBounds;
         double _searchRadius;
         std::shared_ptr<Projection> _projection;
         std::shared_ptr<QueryExpression> _expr;
+        boost::optional<std::set<std::string> > _layerNameHint;
+        boost::optional<std::set<std::string> > _valueHint;
         boost::optional<std::regex> _re;
     };
     
@@ -16,6 +16,7 @@ namespace carto {
         _geometry(),
         _projection(),
         _searchRadius(DEFAULT_SEARCH_RADIUS),
+        _maxResults(DEFAULT_MAX_RESULTS),
         _mutex()
     {
     }
@@ -73,6 +74,16 @@ namespace carto {
         _searchRadius = radius;
     }
 
+    int SearchRequest::getMaxResults() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _maxResults;
+    }
+
+    void SearchRequest::setMaxResults(int maxResults) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _maxResults = maxResults;
+    }
+
     std::string SearchRequest::toString() const {
         std::lock_guard<std::mutex> lock(_mutex);
 
@@ -84,6 +95,7 @@ namespace carto {
             ss << ", geometry=" << GeoJSONGeometryWriter().writeGeometry(_geometry);
             ss << ", searchRadius=" << _searchRadius;
         }
+        ss << ", maxResults=" << _maxResults;
         ss << "]";
         return ss.str();
     }
@@ -92,6 +92,18 @@ namespace carto {
          */
         void setSearchRadius(float radius);
 
+        /**
+         * Returns the maximum number of results the search returns. The default is 1000.
+         * @return The maximum number of results the search returns.
+         */
+        int getMaxResults() const;
+        /**
+         * Sets the maximum number of results the search returns. The search is stopped
+         * once the limit is reached.
+         * @param maxResults The maximum number of results.
+         */
+        void setMaxResults(int maxResults);
+
         /**
          * Creates a string representation of this request object, useful for logging.
          * @return The string representation of this request object.
@@ -100,12 +112,14 @@ namespace carto {
 
     private:
         static const int DEFAULT_SEARCH_RADIUS = 0; // in meters
+        static const int DEFAULT_MAX_RESULTS = 1000;
 
         std::string _filterExpr;
         std::string _regexFilter;
         std::shared_ptr<Geometry> _geometry;
         std::shared_ptr<Projection> _projection;
         float _searchRadius;
+        int _maxResults;
 
         mutable std::mutex _mutex;
     };
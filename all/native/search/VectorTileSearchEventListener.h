@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2016 CartoDB. All rights reserved.
+ * Copying and using this code is allowed only according
+ * to license terms, as given in https://cartodb.com/terms/
+ */
+
+#ifndef _CARTO_VECTORTILESEARCHEVENTLISTENER_H_
+#define _CARTO_VECTORTILESEARCHEVENTLISTENER_H_
+
+#ifdef _CARTO_SEARCH_SUPPORT
+
+#include <memory>
+
+namespace carto {
+    class VectorTileFeatureCollection;
+
+    /**
+     * Listener for vector tile search events.
+     */
+    class VectorTileSearchEventListener {
+    public:
+        virtual ~VectorTileSearchEventListener() { }
+
+        /**
+         * Listener method that gets called when new matching features are found.
+         * The method may be called multiple times during a single search, once for each
+         * searched tile that contains matching features. The calls are serialized but
+         * may come from different background threads.
+         * @param features The collection of newly found features.
+         * @return True if the search should be continued. False if the search should be stopped.
+         */
+        virtual bool onFeaturesFound(const std::shared_ptr<VectorTileFeatureCollection>& features) { return true; }
+    };
+
+}
+
+#endif
+
+#endif
@@ -5,15 +5,25 @@
 #include "datasources/TileDataSource.h"
 #include "geometry/Geometry.h"
 #include "geometry/VectorTileFeature.h"
+#include "geometry/VectorTileFeatureData.h"
 #include "geometry/VectorTileFeatureCollection.h"
 #include "search/SearchProxy.h"
+#include "search/VectorTileSearchEventListener.h"
 #include "vectortiles/VectorTileDecoder.h"
 #include "projections/Projection.h"
 #include "utils/TileUtils.h"
 #include "utils/Log.h"
 
+#include <algorithm>
+#include <thread>
+#include <tuple>
+
 #include <vt/TileId.h>
 
+#ifdef _CARTO_OFFLINE_SUPPORT
+#include <sqlite3pp.h>
+#endif
+
 namespace carto {
 
     VectorTileSearchService::VectorTileSearchService(const std::shared_ptr<TileDataSource>& dataSource, const std::shared_ptr<VectorTileDecoder>& tileDecoder) :
@@ -21,6 +31,11 @@ namespace carto {
         _tileDecoder(tileDecoder),
         _minZoom(),
         _maxZoom(),
+        _eventListener(),
+#ifdef _CARTO_OFFLINE_SUPPORT
+        _featureIndexFileName(),
+        _featureIndexDb(),
+#endif
         _mutex()
     {
         if (!dataSource) {
@@ -65,6 +80,115 @@ namespace carto {
         _maxZoom = maxZoom;
     }
 
+    std::shared_ptr<VectorTileSearchEventListener> VectorTileSearchService::getEventListener() const {
+        return _eventListener.get();
+    }
+
+    void VectorTileSearchService::setEventListener(const std::shared_ptr<VectorTileSearchEventListener>& eventListener) {
+        _eventListener.set(eventListener);
+    }
+
+#ifdef _CARTO_OFFLINE_SUPPORT
+    std::string VectorTileSearchService::getFeatureIndexFileName() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _featureIndexFileName;
+    }
+
+    void VectorTileSearchService::setFeatureIndexFileName(const std::string& indexFileName) {
+        std::shared_ptr<sqlite3pp::database> db;
+        if (!indexFileName.empty()) {
+            db = std::make_shared<sqlite3pp::database>();
+            if (db->connect_v2(indexFileName.c_str(), SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX) != SQLITE_OK) {
+                throw FileException("Failed to open feature index file", indexFileName);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _featureIndexFileName = indexFileName;
+        _featureIndexDb = db;
+    }
+
+    void VectorTileSearchService::buildFeatureIndex(const std::string& indexFileName) const {
+        MapBounds dataExtent = _dataSource->getDataExtent();
+        int minZoom = _dataSource->getMinZoom();
+        int maxZoom = _dataSource->getMaxZoom();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            minZoom = std::max(minZoom, _minZoom);
+            maxZoom = std::min(maxZoom, _maxZoom);
+        }
+
+        try {
+            sqlite3pp::database db(indexFileName.c_str());
+            db.execute("DROP TABLE IF EXISTS metadata");
+            db.execute("DROP TABLE IF EXISTS terms");
+            db.execute("CREATE TABLE metadata(name TEXT NOT NULL PRIMARY KEY, value TEXT)");
+            db.execute("INSERT INTO metadata(name, value) VALUES('version', '1')");
+            db.execute("CREATE TABLE terms(term TEXT NOT NULL, zoom INTEGER NOT NULL, x INTEGER NOT NULL, y INTEGER NOT NULL)");
+            db.execute("BEGIN");
+
+            MapBounds projBounds = _dataSource->getProjection()->getBounds();
+            for (int zoom = minZoom; zoom <= maxZoom; zoom++) {
+                MapTile mapTile1 = TileUtils::CalculateMapTile(dataExtent.getMin(), zoom, projBounds);
+                MapTile mapTile2 = TileUtils::CalculateMapTile(dataExtent.getMax(), zoom, projBounds);
+                for (int y = std::min(mapTile1.getY(), mapTile2.getY()); y <= std::max(mapTile1.getY(), mapTile2.getY()); y++) {
+                    for (int x = std::min(mapTile1.getX(), mapTile2.getX()); x <= std::max(mapTile1.getX(), mapTile2.getX()); x++) {
+                        MapTile mapTile(x, y, zoom, 0);
+                        std::shared_ptr<TileData> tileData = _dataSource->loadTile(mapTile.getFlipped());
+                        if (!tileData || !tileData->getData()) {
+                            continue;
+                        }
+                        MapBounds tileBounds = TileUtils::CalculateMapTileBounds(mapTile, projBounds);
+                        vt::TileId vtTile(mapTile.getZoom(), mapTile.getX(), mapTile.getY());
+                        std::shared_ptr<VectorTileFeatureCollection> featureCollection = _tileDecoder->decodeFeatures(vtTile, tileData->getData(), tileBounds);
+                        if (!featureCollection) {
+                            continue;
+                        }
+
+                        // Gather the distinct string values of all the features of the tile
+                        std::set<std::string> terms;
+                        for (int i = 0; i < featureCollection->getFeatureCount(); i++) {
+                            const std::shared_ptr<VectorTileFeature>& feature = featureCollection->getFeature(i);
+                            if (const std::shared_ptr<VectorTileFeatureData>& featureData = feature->getFeatureData()) {
+                                for (std::size_t j = 0; j < featureData->getPropertyCount(); j++) {
+                                    Variant value = featureData->getPropertyValue(j);
+                                    if (value.getType() == VariantType::VARIANT_TYPE_STRING) {
+                                        terms.insert(value.getString());
+                                    }
+                                }
+                            } else {
+                                const Variant& properties = feature->getProperties();
+                                for (const std::string& key : properties.getObjectKeys()) {
+                                    Variant value = properties.getObjectElement(key);
+                                    if (value.getType() == VariantType::VARIANT_TYPE_STRING) {
+                                        terms.insert(value.getString());
+                                    }
+                                }
+                            }
+                        }
+
+                        for (const std::string& term : terms) {
+                            sqlite3pp::command command(db, "INSERT INTO terms(term, zoom, x, y) VALUES(:term, :zoom, :x, :y)");
+                            command.bind(":term", term.c_str());
+                            command.bind(":zoom", mapTile.getZoom());
+                            command.bind(":x", mapTile.getX());
+                            command.bind(":y", mapTile.getY());
+                            command.execute();
+                            command.finish();
+                        }
+                    }
+                }
+            }
+
+            db.execute("COMMIT");
+            db.execute("CREATE INDEX terms_term ON terms(term)");
+        } catch (const std::exception& ex) {
+            Log::Errorf("VectorTileSearchService::buildFeatureIndex: Failed to build index: %s", ex.what());
+            throw GenericException("Failed to build feature index", ex.what());
+        }
+    }
+#endif
+
     std::shared_ptr<VectorTileFeatureCollection> VectorTileSearchService::findFeatures(const std::shared_ptr<SearchRequest>& request) const {
         if (!request) {
             throw NullArgumentException("Null request");
@@ -81,34 +205,126 @@ namespace carto {
         }
 
         std::vector<MapTile> mapTiles;
+        MapBounds projBounds = _dataSource->getProjection()->getBounds();
         for (int zoom = minZoom; zoom <= maxZoom; zoom++) {
-            MapTile mapTile1 = TileUtils::CalculateMapTile(searchBounds.getMin(), zoom, _dataSource->getProjection());
-            MapTile mapTile2 = TileUtils::CalculateMapTile(searchBounds.getMax(), zoom, _dataSource->getProjection());
+            MapTile mapTile1 = TileUtils::CalculateMapTile(searchBounds.getMin(), zoom, projBounds);
+            MapTile mapTile2 = TileUtils::CalculateMapTile(searchBounds.getMax(), zoom, projBounds);
             for (int y = std::min(mapTile1.getY(), mapTile2.getY()); y <= std::max(mapTile1.getY(), mapTile2.getY()); y++) {
                 for (int x = std::min(mapTile1.getX(), mapTile2.getX()); x <= std::max(mapTile1.getX(), mapTile2.getX()); x++) {
                     MapTile mapTile(x, y, zoom, 0);
-                    if (proxy.testBounds(TileUtils::CalculateMapTileBounds(mapTile, _dataSource->getProjection()))) {
+                    if (proxy.testBounds(TileUtils::CalculateMapTileBounds(mapTile, projBounds))) {
                         mapTiles.push_back(mapTile);
                     }
                 }
             }
         }
 
+#ifdef _CARTO_OFFLINE_SUPPORT
+        // If a feature index is attached and the filter expression yields value terms,
+        // restrict the tile list to the tiles that contain at least one of the terms.
+        if (const boost::optional<std::set<std::string> >& valueHint = proxy.getValueHint()) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_featureIndexDb) {
+                try {
+                    std::set<std::tuple<int, int, int> > candidateTiles;
+                    sqlite3pp::query query(*_featureIndexDb, "SELECT zoom, x, y FROM terms WHERE term=:term");
+                    for (const std::string& term : *valueHint) {
+                        query.bind(":term", term.c_str());
+                        for (auto it = query.begin(); it != query.end(); ++it) {
+                            candidateTiles.insert(std::make_tuple((*it).get<int>(0), (*it).get<int>(1), (*it).get<int>(2)));
+                        }
+                        query.reset();
+                    }
+                    query.finish();
+
+                    mapTiles.erase(std::remove_if(mapTiles.begin(), mapTiles.end(), [&candidateTiles](const MapTile& mapTile) {
+                        return candidateTiles.find(std::make_tuple(mapTile.getZoom(), mapTile.getX(), mapTile.getY())) == candidateTiles.end();
+                    }), mapTiles.end());
+                } catch (const std::exception& ex) {
+                    Log::Errorf("VectorTileSearchService::findFeatures: Failed to query feature index: %s", ex.what());
+                }
+            }
+        }
+#endif
+
+        const boost::optional<std::set<std::string> >& layerNameHint = proxy.getLayerNameHint();
+        DirectorPtr<VectorTileSearchEventListener> eventListener = _eventListener;
+        std::size_t maxResults = static_cast<std::size_t>(std::max(request->getMaxResults(), 0));
+
+        // Fan the tiles out to worker threads. Each worker grabs the next unprocessed tile,
+        // decodes and matches it and merges the matches into the shared result list.
+        std::mutex searchMutex;
+        std::size_t tileIndex = 0;
+        bool stop = (layerNameHint && layerNameHint->empty()) || maxResults == 0;
         std::vector<std::shared_ptr<VectorTileFeature> > features;
-        for (const MapTile& mapTile : mapTiles) {
-            if (std::shared_ptr<TileData> tileData = _dataSource->loadTile(mapTile.getFlipped())) {
-                MapBounds tileBounds = TileUtils::CalculateMapTileBounds(mapTile, _dataSource->getProjection());
-                if (std::shared_ptr<VectorTileFeatureCollection> featureCollection = _tileDecoder->decodeFeatures(vt::TileId(mapTile.getZoom(), mapTile.getX(), mapTile.getY()), tileData->getData(), tileBounds)) {
-                    for (int i = 0; i < featureCollection->getFeatureCount(); i++) {
-                        const std::shared_ptr<VectorTileFeature>& feature = featureCollection->getFeature(i);
-                        if (proxy.testElement(feature->getGeometry(), &feature->getLayerName(), feature->getProperties())) {
-                            features.push_back(feature);
+
+        auto searchThreadFn = [&]() {
+            while (true) {
+                MapTile mapTile(0, 0, 0, 0);
+                {
+                    std::lock_guard<std::mutex> lock(searchMutex);
+                    if (stop || tileIndex >= mapTiles.size()) {
+                        return;
+                    }
+                    mapTile = mapTiles[tileIndex++];
+                }
+
+                std::vector<std::shared_ptr<VectorTileFeature> > tileFeatures;
+                if (std::shared_ptr<TileData> tileData = _dataSource->loadTile(mapTile.getFlipped())) {
+                    MapBounds tileBounds = TileUtils::CalculateMapTileBounds(mapTile, projBounds);
+                    vt::TileId vtTile(mapTile.getZoom(), mapTile.getX(), mapTile.getY());
+                    std::shared_ptr<VectorTileFeatureCollection> featureCollection = (layerNameHint ? _tileDecoder->decodeFeatures(vtTile, tileData->getData(), tileBounds, *layerNameHint) : _tileDecoder->decodeFeatures(vtTile, tileData->getData(), tileBounds));
+                    if (featureCollection) {
+                        for (int i = 0; i < featureCollection->getFeatureCount(); i++) {
+                            const std::shared_ptr<VectorTileFeature>& feature = featureCollection->getFeature(i);
+                            bool match = false;
+                            if (const std::shared_ptr<VectorTileFeatureData>& featureData = feature->getFeatureData()) {
+                                match = proxy.testElement(feature->getGeometry(), &feature->getLayerName(), featureData);
+                            } else {
+                                match = proxy.testElement(feature->getGeometry(), &feature->getLayerName(), feature->getProperties());
+                            }
+                            if (match) {
+                                tileFeatures.push_back(feature);
+                            }
+                        }
+                    }
+                }
+
+                if (!tileFeatures.empty()) {
+                    std::lock_guard<std::mutex> lock(searchMutex);
+                    if (stop) {
+                        return;
+                    }
+                    if (features.size() + tileFeatures.size() > maxResults) {
+                        tileFeatures.resize(maxResults - features.size());
+                    }
+                    features.insert(features.end(), tileFeatures.begin(), tileFeatures.end());
+                    if (features.size() >= maxResults) {
+                        stop = true;
+                    }
+                    if (eventListener) {
+                        if (!eventListener->onFeaturesFound(std::make_shared<VectorTileFeatureCollection>(std::move(tileFeatures)))) {
+                            stop = true;
                         }
                     }
                 }
             }
+        };
+
+        std::size_t threadCount = std::min(static_cast<std::size_t>(std::max(std::thread::hardware_concurrency(), 1U)), mapTiles.size());
+        if (threadCount < 2) {
+            searchThreadFn();
+        } else {
+            std::vector<std::thread> threads;
+            threads.reserve(threadCount);
+            for (std::size_t i = 0; i < threadCount; i++) {
+                threads.emplace_back(searchThreadFn);
+            }
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
         }
-        return std::make_shared<VectorTileFeatureCollection>(features);
+        return std::make_shared<VectorTileFeatureCollection>(std::move(features));
     }
 
 }
@@ -9,17 +9,26 @@
 
 #ifdef _CARTO_SEARCH_SUPPORT
 
+#include "components/DirectorPtr.h"
 #include "search/SearchRequest.h"
 
 #include <memory>
 #include <mutex>
+#include <string>
 #include <vector>
 
+#ifdef _CARTO_OFFLINE_SUPPORT
+namespace sqlite3pp {
+    class database;
+}
+#endif
+
 namespace carto {
     class Projection;
     class TileDataSource;
     class VectorTileDecoder;
     class VectorTileFeatureCollection;
+    class VectorTileSearchEventListener;
 
     /**
      * A search service for finding features from the specified vector tile data source.
@@ -70,6 +79,42 @@ namespace carto {
          */
         void setMaxZoom(int maxZoom);
 
+        /**
+         * Returns the event listener of the search service.
+         * @return The event listener of the search service. Can be null.
+         */
+        std::shared_ptr<VectorTileSearchEventListener> getEventListener() const;
+        /**
+         * Sets the event listener of the search service. The listener is called with partial
+         * results while the search is running and can be used to stop the search early.
+         * @param eventListener The new event listener. Can be null.
+         */
+        void setEventListener(const std::shared_ptr<VectorTileSearchEventListener>& eventListener);
+
+#ifdef _CARTO_OFFLINE_SUPPORT
+        /**
+         * Returns the file name of the attached persistent feature index.
+         * @return The file name of the attached persistent feature index. Empty if no index is attached.
+         */
+        std::string getFeatureIndexFileName() const;
+        /**
+         * Attaches a persistent feature index previously built using buildFeatureIndex.
+         * When an index is attached, searches with suitable filter expressions only decode
+         * the tiles that can contain matching features. If the file name is empty, the index is detached.
+         * @param indexFileName The full path of the feature index file.
+         */
+        void setFeatureIndexFileName(const std::string& indexFileName);
+
+        /**
+         * Builds a persistent feature index for the data source of the service.
+         * The index maps feature attribute values to tile coordinates and is typically
+         * stored next to the offline tile database. Building the index decodes all
+         * the tiles within the zoom range of the service and can take a long time.
+         * @param indexFileName The full path of the feature index file to create.
+         */
+        void buildFeatureIndex(const std::string& indexFileName) const;
+#endif
+
         /**
          * Searches for the features specified by search request from the vector tiles bound to the service.
          * The zoom level range used for searching is specified using minZoom/maxZoom attributes of the search service.
@@ -84,6 +129,11 @@ namespace carto {
 
         int _minZoom;
         int _maxZoom;
+        ThreadSafeDirectorPtr<VectorTileSearchEventListener> _eventListener;
+#ifdef _CARTO_OFFLINE_SUPPORT
+        std::string _featureIndexFileName;
+        std::shared_ptr<sqlite3pp::database> _featureIndexDb;
+#endif
 
         mutable std::mutex _mutex;
     };
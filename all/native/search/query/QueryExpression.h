@@ -8,6 +8,8 @@
 #define _CARTO_QUERYEXPRESSION_H_
 
 #include <memory>
+#include <set>
+#include <string>
 
 namespace carto {
     class QueryContext;
@@ -25,6 +27,24 @@ namespace carto {
          * @return True or false, depending on the context.
          */
         virtual bool evaluate(const QueryContext& context) const = 0;
+
+        /**
+         * Extracts the set of layer names the expression can possibly match.
+         * The hint is conservative - if no set can be deduced, false is returned
+         * and the expression may match features from any layer.
+         * @param layerNames The set to fill with the possible layer names.
+         * @return True if the expression matches only the returned layer names. False if no hint could be deduced.
+         */
+        virtual bool getLayerNameHint(std::set<std::string>& layerNames) const { return false; }
+
+        /**
+         * Extracts a set of attribute values such that every matching feature has
+         * at least one property equal to one of the values. The hint is conservative -
+         * if no such set can be deduced, false is returned.
+         * @param values The set to fill with the attribute values.
+         * @return True if every match contains one of the returned values. False if no hint could be deduced.
+         */
+        virtual bool getValueHint(std::set<std::string>& values) const { return false; }
     };
 }
 
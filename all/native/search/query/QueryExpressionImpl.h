@@ -10,8 +10,11 @@
 #include "search/query/QueryContext.h"
 #include "search/query/QueryExpression.h"
 
+#include <algorithm>
+#include <iterator>
 #include <limits>
 #include <regex>
+#include <type_traits>
 
 #include <boost/variant.hpp>
 #include <boost/lexical_cast.hpp>
@@ -22,10 +25,40 @@ namespace carto {
     namespace queryexpressionimpl {
         using Value = Variant;
 
-        using Expression = QueryExpression;
-
         using Context = QueryContext;
 
+        struct Instruction {
+            enum Code {
+                CODE_PUSH_CONST,
+                CODE_PUSH_VAR,
+                CODE_NOT,
+                CODE_AND_JUMP,
+                CODE_OR_JUMP,
+                CODE_IS_NULL,
+                CODE_IS_NOT_NULL,
+                CODE_REGEXP_LIKE,
+                CODE_EQ,
+                CODE_NEQ,
+                CODE_GT,
+                CODE_LT,
+                CODE_GTE,
+                CODE_LTE
+            };
+
+            explicit Instruction(Code code) : code(code), target(-1), value(), varName(), nocase(false) { }
+
+            Code code;
+            int target;
+            Value value;
+            std::string varName;
+            bool nocase;
+        };
+
+        inline std::string CollateNoCase(const std::string& str) {
+            unistring::unistring unistr = unistring::to_unistring(str);
+            return unistring::to_utf8string(unistring::to_upper(unistr));
+        }
+
         struct IsNullPredicate {
             bool operator() (const Value& val) const { return val.getType() == VariantType::VARIANT_TYPE_NULL; }
         };
@@ -139,14 +172,38 @@ namespace carto {
             }
         };
 
+        template <typename Pred> struct PredicateCode;
+        template <> struct PredicateCode<IsNullPredicate>     { static const Instruction::Code value = Instruction::CODE_IS_NULL; };
+        template <> struct PredicateCode<IsNotNullPredicate>  { static const Instruction::Code value = Instruction::CODE_IS_NOT_NULL; };
+        template <> struct PredicateCode<RegexpLikePredicate> { static const Instruction::Code value = Instruction::CODE_REGEXP_LIKE; };
+        template <> struct PredicateCode<EqPredicate>         { static const Instruction::Code value = Instruction::CODE_EQ; };
+        template <> struct PredicateCode<NeqPredicate>        { static const Instruction::Code value = Instruction::CODE_NEQ; };
+        template <> struct PredicateCode<GtPredicate>         { static const Instruction::Code value = Instruction::CODE_GT; };
+        template <> struct PredicateCode<LtPredicate>         { static const Instruction::Code value = Instruction::CODE_LT; };
+        template <> struct PredicateCode<GtePredicate>        { static const Instruction::Code value = Instruction::CODE_GTE; };
+        template <> struct PredicateCode<LtePredicate>        { static const Instruction::Code value = Instruction::CODE_LTE; };
+
         struct Operand {
             virtual ~Operand() = default;
             virtual Value evaluate(const Context& context) const = 0;
+            virtual void compile(std::vector<Instruction>& program) const = 0;
+            virtual bool getConstValue(Value& value) const { return false; }
+            virtual bool getVariableName(std::string& name) const { return false; }
         };
 
         struct ConstOperand : public Operand {
             explicit ConstOperand(const Value& value) : _value(value) { }
+
             virtual Value evaluate(const Context& context) const { return _value; }
+
+            virtual void compile(std::vector<Instruction>& program) const {
+                Instruction insn(Instruction::CODE_PUSH_CONST);
+                insn.value = _value;
+                program.push_back(std::move(insn));
+            }
+
+            virtual bool getConstValue(Value& value) const { value = _value; return true; }
+
             static std::shared_ptr<ConstOperand> create(const Value& value) { return std::make_shared<ConstOperand>(value); }
         private:
             Value _value;
@@ -166,22 +223,43 @@ namespace carto {
                 return value;
             }
 
+            virtual void compile(std::vector<Instruction>& program) const {
+                Instruction insn(Instruction::CODE_PUSH_VAR);
+                insn.varName = _name;
+                insn.nocase = _nocase;
+                program.push_back(std::move(insn));
+            }
+
+            virtual bool getVariableName(std::string& name) const {
+                if (_nocase) {
+                    return false;
+                }
+                name = _name;
+                return true;
+            }
+
             static std::shared_ptr<VariableOperand> create(const std::string& name) { return std::make_shared<VariableOperand>(name, false); }
             static std::shared_ptr<VariableOperand> createEx(const std::string& name, const std::string& collateSeq) { return std::make_shared<VariableOperand>(name, CollateNoCase(collateSeq) == CollateNoCase("nocase")); }
 
         private:
-            static std::string CollateNoCase(const std::string& str) {
-                unistring::unistring unistr = unistring::to_unistring(str);
-                return unistring::to_utf8string(unistring::to_upper(unistr));
-            }
-
             std::string _name;
             bool _nocase;
         };
 
+        struct Expression : QueryExpression {
+            virtual void compile(std::vector<Instruction>& program) const = 0;
+        };
+
         struct NotExpression : public Expression {
             explicit NotExpression(const std::shared_ptr<Expression>& expr) : _expr(expr) { }
+
             virtual bool evaluate(const Context& context) const { return !_expr->evaluate(context); }
+
+            virtual void compile(std::vector<Instruction>& program) const {
+                _expr->compile(program);
+                program.push_back(Instruction(Instruction::CODE_NOT));
+            }
+
             static std::shared_ptr<NotExpression> create(const std::shared_ptr<Expression>& expr) { return std::make_shared<NotExpression>(expr); }
         private:
             std::shared_ptr<Expression> _expr;
@@ -189,7 +267,35 @@ namespace carto {
 
         struct OrExpression : public Expression {
             OrExpression(const std::shared_ptr<Expression>& expr1, const std::shared_ptr<Expression>& expr2) : _expr1(expr1), _expr2(expr2) { }
+
             virtual bool evaluate(const Context& context) const { return _expr1->evaluate(context) || _expr2->evaluate(context); }
+
+            virtual void compile(std::vector<Instruction>& program) const {
+                _expr1->compile(program);
+                std::size_t jumpIdx = program.size();
+                program.push_back(Instruction(Instruction::CODE_OR_JUMP));
+                _expr2->compile(program);
+                program[jumpIdx].target = static_cast<int>(program.size());
+            }
+
+            virtual bool getLayerNameHint(std::set<std::string>& layerNames) const {
+                std::set<std::string> layerNames1, layerNames2;
+                if (!_expr1->getLayerNameHint(layerNames1) || !_expr2->getLayerNameHint(layerNames2)) {
+                    return false;
+                }
+                std::set_union(layerNames1.begin(), layerNames1.end(), layerNames2.begin(), layerNames2.end(), std::inserter(layerNames, layerNames.end()));
+                return true;
+            }
+
+            virtual bool getValueHint(std::set<std::string>& values) const {
+                std::set<std::string> values1, values2;
+                if (!_expr1->getValueHint(values1) || !_expr2->getValueHint(values2)) {
+                    return false;
+                }
+                std::set_union(values1.begin(), values1.end(), values2.begin(), values2.end(), std::inserter(values, values.end()));
+                return true;
+            }
+
             static std::shared_ptr<OrExpression> create(const std::shared_ptr<Expression>& expr1, const std::shared_ptr<Expression>& expr2) { return std::make_shared<OrExpression>(expr1, expr2); }
         private:
             std::shared_ptr<Expression> _expr1, _expr2;
@@ -197,7 +303,43 @@ namespace carto {
 
         struct AndExpression : public Expression {
             AndExpression(const std::shared_ptr<Expression>& expr1, const std::shared_ptr<Expression>& expr2) : _expr1(expr1), _expr2(expr2) { }
+
             virtual bool evaluate(const Context& context) const { return _expr1->evaluate(context) && _expr2->evaluate(context); }
+
+            virtual void compile(std::vector<Instruction>& program) const {
+                _expr1->compile(program);
+                std::size_t jumpIdx = program.size();
+                program.push_back(Instruction(Instruction::CODE_AND_JUMP));
+                _expr2->compile(program);
+                program[jumpIdx].target = static_cast<int>(program.size());
+            }
+
+            virtual bool getLayerNameHint(std::set<std::string>& layerNames) const {
+                std::set<std::string> layerNames1, layerNames2;
+                bool hint1 = _expr1->getLayerNameHint(layerNames1);
+                bool hint2 = _expr2->getLayerNameHint(layerNames2);
+                if (hint1 && hint2) {
+                    std::set_intersection(layerNames1.begin(), layerNames1.end(), layerNames2.begin(), layerNames2.end(), std::inserter(layerNames, layerNames.end()));
+                    return true;
+                }
+                if (hint1) {
+                    layerNames = std::move(layerNames1);
+                }
+                if (hint2) {
+                    layerNames = std::move(layerNames2);
+                }
+                return hint1 || hint2;
+            }
+
+            virtual bool getValueHint(std::set<std::string>& values) const {
+                // Unlike layer name hints, value hints of different conjuncts can not be
+                // intersected as they may constrain different properties. Either hint is valid alone.
+                if (_expr1->getValueHint(values)) {
+                    return true;
+                }
+                return _expr2->getValueHint(values);
+            }
+
             static std::shared_ptr<AndExpression> create(const std::shared_ptr<Expression>& expr1, const std::shared_ptr<Expression>& expr2) { return std::make_shared<AndExpression>(expr1, expr2); }
         private:
             std::shared_ptr<Expression> _expr1, _expr2;
@@ -206,7 +348,14 @@ namespace carto {
         template <typename Pred>
         struct UnaryPredicateExpression : public Expression {
             UnaryPredicateExpression(const std::shared_ptr<Pred>& pred, const std::shared_ptr<Operand>& op) : _pred(pred), _op(op) { }
+
             virtual bool evaluate(const Context& context) const { return (*_pred)(_op->evaluate(context)); }
+
+            virtual void compile(std::vector<Instruction>& program) const {
+                _op->compile(program);
+                program.push_back(Instruction(PredicateCode<Pred>::value));
+            }
+
             static std::shared_ptr<UnaryPredicateExpression> create(const std::shared_ptr<Operand>& op) { return std::make_shared<UnaryPredicateExpression>(std::make_shared<Pred>(), op); }
         private:
             std::shared_ptr<Pred> _pred;
@@ -216,12 +365,168 @@ namespace carto {
         template <typename Pred>
         struct BinaryPredicateExpression : public Expression {
             BinaryPredicateExpression(const std::shared_ptr<Pred>& pred, const std::shared_ptr<Operand>& op1, const std::shared_ptr<Operand>& op2) : _pred(pred), _op1(op1), _op2(op2) { }
+
             virtual bool evaluate(const Context& context) const { return (*_pred)(_op1->evaluate(context), _op2->evaluate(context)); }
+
+            virtual void compile(std::vector<Instruction>& program) const {
+                _op1->compile(program);
+                _op2->compile(program);
+                program.push_back(Instruction(PredicateCode<Pred>::value));
+            }
+
+            virtual bool getLayerNameHint(std::set<std::string>& layerNames) const {
+                if (!std::is_same<Pred, EqPredicate>::value) {
+                    return false;
+                }
+                std::string name;
+                Value value;
+                if (!((_op1->getVariableName(name) && _op2->getConstValue(value)) || (_op2->getVariableName(name) && _op1->getConstValue(value)))) {
+                    return false;
+                }
+                if (name != "layer::name" || value.getType() != VariantType::VARIANT_TYPE_STRING) {
+                    return false;
+                }
+                layerNames.insert(value.getString());
+                return true;
+            }
+
+            virtual bool getValueHint(std::set<std::string>& values) const {
+                if (!std::is_same<Pred, EqPredicate>::value) {
+                    return false;
+                }
+                std::string name;
+                Value value;
+                if (!((_op1->getVariableName(name) && _op2->getConstValue(value)) || (_op2->getVariableName(name) && _op1->getConstValue(value)))) {
+                    return false;
+                }
+                if (name.find("::") != std::string::npos || value.getType() != VariantType::VARIANT_TYPE_STRING) {
+                    return false;
+                }
+                values.insert(value.getString());
+                return true;
+            }
+
             static std::shared_ptr<BinaryPredicateExpression> create(const std::shared_ptr<Operand>& op1, const std::shared_ptr<Operand>& op2) { return std::make_shared<BinaryPredicateExpression>(std::make_shared<Pred>(), op1, op2); }
         private:
             std::shared_ptr<Pred> _pred;
             std::shared_ptr<Operand> _op1, _op2;
         };
+
+        struct CompiledExpression : public QueryExpression {
+            CompiledExpression(std::vector<Instruction> program, bool layerNameHint, std::set<std::string> layerNames, bool valueHint, std::set<std::string> values) : _program(std::move(program)), _layerNameHint(layerNameHint), _layerNames(std::move(layerNames)), _valueHint(valueHint), _values(std::move(values)) { }
+
+            virtual bool evaluate(const Context& context) const {
+                std::vector<Value> valueStack;
+                std::vector<bool> boolStack;
+                valueStack.reserve(4);
+                boolStack.reserve(4);
+                std::size_t pc = 0;
+                while (pc < _program.size()) {
+                    const Instruction& insn = _program[pc];
+                    switch (insn.code) {
+                    case Instruction::CODE_PUSH_CONST:
+                        valueStack.push_back(insn.value);
+                        break;
+                    case Instruction::CODE_PUSH_VAR:
+                        {
+                            Value value;
+                            if (context.getVariable(insn.varName, value)) {
+                                if (insn.nocase && value.getType() == VariantType::VARIANT_TYPE_STRING) {
+                                    value = Value(CollateNoCase(value.getString()));
+                                }
+                            }
+                            valueStack.push_back(std::move(value));
+                        }
+                        break;
+                    case Instruction::CODE_NOT:
+                        boolStack.back() = !boolStack.back();
+                        break;
+                    case Instruction::CODE_AND_JUMP:
+                        if (!boolStack.back()) {
+                            pc = insn.target;
+                            continue;
+                        }
+                        boolStack.pop_back();
+                        break;
+                    case Instruction::CODE_OR_JUMP:
+                        if (boolStack.back()) {
+                            pc = insn.target;
+                            continue;
+                        }
+                        boolStack.pop_back();
+                        break;
+                    case Instruction::CODE_IS_NULL:
+                    case Instruction::CODE_IS_NOT_NULL:
+                        {
+                            Value value = std::move(valueStack.back());
+                            valueStack.pop_back();
+                            boolStack.push_back(insn.code == Instruction::CODE_IS_NULL ? IsNullPredicate()(value) : IsNotNullPredicate()(value));
+                        }
+                        break;
+                    default:
+                        {
+                            Value value2 = std::move(valueStack.back());
+                            valueStack.pop_back();
+                            Value value1 = std::move(valueStack.back());
+                            valueStack.pop_back();
+                            bool result = false;
+                            switch (insn.code) {
+                            case Instruction::CODE_REGEXP_LIKE:
+                                result = RegexpLikePredicate()(value1, value2);
+                                break;
+                            case Instruction::CODE_EQ:
+                                result = EqPredicate()(value1, value2);
+                                break;
+                            case Instruction::CODE_NEQ:
+                                result = NeqPredicate()(value1, value2);
+                                break;
+                            case Instruction::CODE_GT:
+                                result = GtPredicate()(value1, value2);
+                                break;
+                            case Instruction::CODE_LT:
+                                result = LtPredicate()(value1, value2);
+                                break;
+                            case Instruction::CODE_GTE:
+                                result = GtePredicate()(value1, value2);
+                                break;
+                            case Instruction::CODE_LTE:
+                                result = LtePredicate()(value1, value2);
+                                break;
+                            default:
+                                break;
+                            }
+                            boolStack.push_back(result);
+                        }
+                        break;
+                    }
+                    pc++;
+                }
+                return !boolStack.empty() && boolStack.back();
+            }
+
+            virtual bool getLayerNameHint(std::set<std::string>& layerNames) const {
+                if (!_layerNameHint) {
+                    return false;
+                }
+                layerNames = _layerNames;
+                return true;
+            }
+
+            virtual bool getValueHint(std::set<std::string>& values) const {
+                if (!_valueHint) {
+                    return false;
+                }
+                values = _values;
+                return true;
+            }
+
+        private:
+            std::vector<Instruction> _program;
+            bool _layerNameHint;
+            std::set<std::string> _layerNames;
+            bool _valueHint;
+            std::set<std::string> _values;
+        };
     }
 }
 
@@ -22,7 +22,7 @@ namespace carto {
         namespace encoding = boost::spirit::iso8859_1;
     
         template <typename Iterator>
-        struct Grammar : qi::grammar<Iterator, std::shared_ptr<QueryExpression>(), encoding::space_type> {
+        struct Grammar : qi::grammar<Iterator, std::shared_ptr<Expression>(), encoding::space_type> {
             Grammar() : Grammar::base_type(expression) {
                 using qi::_val;
                 using qi::_1;
@@ -106,20 +106,48 @@ namespace carto {
     }
 
     std::shared_ptr<QueryExpression> QueryExpressionParser::parse(const std::string& expr) {
+        {
+            std::lock_guard<std::mutex> lock(_CachedExpressionsMutex);
+            auto it = _CachedExpressions.find(expr);
+            if (it != _CachedExpressions.end()) {
+                return it->second;
+            }
+        }
+
         std::string::const_iterator it = expr.begin();
         std::string::const_iterator end = expr.end();
         queryexpressionimpl::encoding::space_type space;
-        std::shared_ptr<QueryExpression> queryExpr;
+        std::shared_ptr<queryexpressionimpl::Expression> queryExpr;
         bool result = boost::spirit::qi::phrase_parse(it, end, queryexpressionimpl::Grammar<std::string::const_iterator>(), space, queryExpr);
         if (!result) {
             throw ParseException("Failed to parse query expression", expr);
         } else if (it != expr.end()) {
             throw ParseException("Could not parse to the end of query expression", expr, static_cast<int>(expr.end() - it));
         }
-        return queryExpr;
+
+        // Compile the expression tree into a flat program, keeping the layer name hint of the tree
+        std::vector<queryexpressionimpl::Instruction> program;
+        queryExpr->compile(program);
+        std::set<std::string> layerNames;
+        bool layerNameHint = queryExpr->getLayerNameHint(layerNames);
+        std::set<std::string> values;
+        bool valueHint = queryExpr->getValueHint(values);
+        auto compiledExpr = std::make_shared<queryexpressionimpl::CompiledExpression>(std::move(program), layerNameHint, std::move(layerNames), valueHint, std::move(values));
+
+        {
+            std::lock_guard<std::mutex> lock(_CachedExpressionsMutex);
+            if (_CachedExpressions.size() >= MAX_CACHED_EXPRESSIONS) {
+                _CachedExpressions.erase(_CachedExpressions.begin());
+            }
+            _CachedExpressions[expr] = compiledExpr;
+        }
+        return compiledExpr;
     }
 
     QueryExpressionParser::QueryExpressionParser() {
     }
 
+    std::map<std::string, std::shared_ptr<QueryExpression> > QueryExpressionParser::_CachedExpressions;
+    std::mutex QueryExpressionParser::_CachedExpressionsMutex;
+
 }
@@ -11,6 +11,8 @@
 
 #include <string>
 #include <memory>
+#include <map>
+#include <mutex>
 
 namespace carto {
 
@@ -20,7 +22,8 @@ namespace carto {
     class QueryExpressionParser {
     public:
         /**
-         * Parse the query string and return corresponding parsed expression.
+         * Parse the query string and return corresponding compiled expression.
+         * Parsed expressions are cached, repeated calls with the same string avoid reparsing.
          * @param expr The string expression to parse.
          * @return The parsed query expression object.
          */
@@ -28,6 +31,11 @@ namespace carto {
 
     private:
         QueryExpressionParser();
+
+        static const std::size_t MAX_CACHED_EXPRESSIONS = 64;
+
+        static std::map<std::string, std::shared_ptr<QueryExpression> > _CachedExpressions;
+        static std::mutex _CachedExpressionsMutex;
     };
 
 }
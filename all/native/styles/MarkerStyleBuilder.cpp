@@ -4,6 +4,8 @@
 #include "graphics/Bitmap.h"
 #include "styles/MarkerStyle.h"
 
+#include <functional>
+
 namespace carto {
 
     MarkerStyleBuilder::MarkerStyleBuilder() :
@@ -103,23 +105,82 @@ namespace carto {
     
     std::shared_ptr<MarkerStyle> MarkerStyleBuilder::buildStyle() const {
         std::lock_guard<std::mutex> lock(_mutex);
-        return std::make_shared<MarkerStyle>(_color,
-                                             _attachAnchorPointX,
-                                             _attachAnchorPointY,
-                                             _causesOverlap,
-                                             _hideIfOverlapped,
-                                             _horizontalOffset,
-                                             _verticalOffset,
-                                             _placementPriority,
-                                             _scaleWithDPI,
-                                             _animationStyle,
-                                             _anchorPointX,
-                                             _anchorPointY,
-                                             _bitmap,
-                                             _orientationMode,
-                                             _scalingMode,
-                                             _clickSize,
-                                             _size);
+
+        // Styles are immutable, so equal parameter sets can share a single instance.
+        // Data-driven styling easily creates thousands of styles that differ only in
+        // one or two parameters, the shared instances keep the overhead per distinct
+        // parameter set instead of per element.
+        std::hash<float> floatHasher;
+        std::size_t hash = static_cast<std::size_t>(_color.getARGB());
+        hash = hash * 31 + floatHasher(_attachAnchorPointX);
+        hash = hash * 31 + floatHasher(_attachAnchorPointY);
+        hash = hash * 31 + (_causesOverlap ? 1 : 0);
+        hash = hash * 31 + (_hideIfOverlapped ? 1 : 0);
+        hash = hash * 31 + floatHasher(_horizontalOffset);
+        hash = hash * 31 + floatHasher(_verticalOffset);
+        hash = hash * 31 + static_cast<std::size_t>(_placementPriority);
+        hash = hash * 31 + (_scaleWithDPI ? 1 : 0);
+        hash = hash * 31 + std::hash<std::shared_ptr<AnimationStyle> >()(_animationStyle);
+        hash = hash * 31 + floatHasher(_anchorPointX);
+        hash = hash * 31 + floatHasher(_anchorPointY);
+        hash = hash * 31 + std::hash<std::shared_ptr<Bitmap> >()(_bitmap);
+        hash = hash * 31 + static_cast<std::size_t>(_orientationMode);
+        hash = hash * 31 + static_cast<std::size_t>(_scalingMode);
+        hash = hash * 31 + floatHasher(_clickSize);
+        hash = hash * 31 + floatHasher(_size);
+
+        std::lock_guard<std::mutex> cacheLock(_SharedStylesMutex);
+        auto it = _SharedStyles.find(hash);
+        if (it != _SharedStyles.end()) {
+            const std::shared_ptr<MarkerStyle>& style = it->second;
+            if (style->getColor() == _color
+                && style->getAttachAnchorPointX() == _attachAnchorPointX
+                && style->getAttachAnchorPointY() == _attachAnchorPointY
+                && style->isCausesOverlap() == _causesOverlap
+                && style->isHideIfOverlapped() == _hideIfOverlapped
+                && style->getHorizontalOffset() == _horizontalOffset
+                && style->getVerticalOffset() == _verticalOffset
+                && style->getPlacementPriority() == _placementPriority
+                && style->isScaleWithDPI() == _scaleWithDPI
+                && style->getAnimationStyle() == _animationStyle
+                && style->getAnchorPointX() == _anchorPointX
+                && style->getAnchorPointY() == _anchorPointY
+                && style->getBitmap() == _bitmap
+                && style->getOrientationMode() == _orientationMode
+                && style->getScalingMode() == _scalingMode
+                && style->getClickSize() == _clickSize
+                && style->getSize() == _size)
+            {
+                return style;
+            }
+        }
+
+        auto style = std::make_shared<MarkerStyle>(_color,
+                                                   _attachAnchorPointX,
+                                                   _attachAnchorPointY,
+                                                   _causesOverlap,
+                                                   _hideIfOverlapped,
+                                                   _horizontalOffset,
+                                                   _verticalOffset,
+                                                   _placementPriority,
+                                                   _scaleWithDPI,
+                                                   _animationStyle,
+                                                   _anchorPointX,
+                                                   _anchorPointY,
+                                                   _bitmap,
+                                                   _orientationMode,
+                                                   _scalingMode,
+                                                   _clickSize,
+                                                   _size);
+        if (it != _SharedStyles.end()) {
+            it->second = style; // hash collision, keep the latest instance
+        } else {
+            if (_SharedStyles.size() >= MAX_SHARED_STYLES) {
+                _SharedStyles.clear();
+            }
+            _SharedStyles[hash] = style;
+        }
+        return style;
     }
     
     std::shared_ptr<Bitmap> MarkerStyleBuilder::GetDefaultBitmap() {
@@ -132,5 +193,10 @@ namespace carto {
     
     std::shared_ptr<Bitmap> MarkerStyleBuilder::_DefaultBitmap;
     std::mutex MarkerStyleBuilder::_DefaultBitmapMutex;
-    
+
+    const std::size_t MarkerStyleBuilder::MAX_SHARED_STYLES = 256;
+
+    std::map<std::size_t, std::shared_ptr<MarkerStyle> > MarkerStyleBuilder::_SharedStyles;
+    std::mutex MarkerStyleBuilder::_SharedStylesMutex;
+
 }
@@ -9,6 +9,8 @@
 
 #include "styles/BillboardStyleBuilder.h"
 
+#include <cstddef>
+#include <map>
 #include <memory>
 
 namespace carto {
@@ -120,13 +122,14 @@ namespace carto {
     
         /**
          * Builds a new instance of the MarkerStyle object using previously set parameters.
-         * @return A new MarkerStyle object.
+         * Note that styles are immutable, so equal parameter sets may return a shared instance.
+         * @return A MarkerStyle object.
          */
         std::shared_ptr<MarkerStyle> buildStyle() const;
-    
+
     protected:
         static std::shared_ptr<Bitmap> GetDefaultBitmap();
-    
+
         static std::shared_ptr<Bitmap> _DefaultBitmap;
         static std::mutex _DefaultBitmapMutex;
         
@@ -139,9 +142,15 @@ namespace carto {
         
         BillboardScaling::BillboardScaling _scalingMode;
 
-        float _clickSize;        
+        float _clickSize;
 
         float _size;
+
+    private:
+        static const std::size_t MAX_SHARED_STYLES;
+
+        static std::map<std::size_t, std::shared_ptr<MarkerStyle> > _SharedStyles;
+        static std::mutex _SharedStylesMutex;
     };
     
 }
@@ -4,6 +4,8 @@
 #include "graphics/Bitmap.h"
 #include "styles/PointStyle.h"
 
+#include <functional>
+
 namespace carto {
 
     PointStyleBuilder::PointStyleBuilder() :
@@ -53,7 +55,37 @@ namespace carto {
     
     std::shared_ptr<PointStyle> PointStyleBuilder::buildStyle() const {
         std::lock_guard<std::mutex> lock(_mutex);
-        return std::make_shared<PointStyle>(_color, _bitmap, _clickSize, _size);
+
+        // Styles are immutable, so equal parameter sets can share a single instance.
+        std::hash<float> floatHasher;
+        std::size_t hash = static_cast<std::size_t>(_color.getARGB());
+        hash = hash * 31 + std::hash<std::shared_ptr<Bitmap> >()(_bitmap);
+        hash = hash * 31 + floatHasher(_clickSize);
+        hash = hash * 31 + floatHasher(_size);
+
+        std::lock_guard<std::mutex> cacheLock(_SharedStylesMutex);
+        auto it = _SharedStyles.find(hash);
+        if (it != _SharedStyles.end()) {
+            const std::shared_ptr<PointStyle>& style = it->second;
+            if (style->getColor() == _color
+                && style->getBitmap() == _bitmap
+                && style->getClickSize() == _clickSize
+                && style->getSize() == _size)
+            {
+                return style;
+            }
+        }
+
+        auto style = std::make_shared<PointStyle>(_color, _bitmap, _clickSize, _size);
+        if (it != _SharedStyles.end()) {
+            it->second = style; // hash collision, keep the latest instance
+        } else {
+            if (_SharedStyles.size() >= MAX_SHARED_STYLES) {
+                _SharedStyles.clear();
+            }
+            _SharedStyles[hash] = style;
+        }
+        return style;
     }
     
     std::shared_ptr<Bitmap> PointStyleBuilder::GetDefaultBitmap() {
@@ -66,5 +98,10 @@ namespace carto {
     
     std::shared_ptr<Bitmap> PointStyleBuilder::_DefaultBitmap;
     std::mutex PointStyleBuilder::_DefaultBitmapMutex;
- 
+
+    const std::size_t PointStyleBuilder::MAX_SHARED_STYLES = 256;
+
+    std::map<std::size_t, std::shared_ptr<PointStyle> > PointStyleBuilder::_SharedStyles;
+    std::mutex PointStyleBuilder::_SharedStylesMutex;
+
 }
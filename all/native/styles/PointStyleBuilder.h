@@ -9,6 +9,8 @@
 
 #include "styles/StyleBuilder.h"
 
+#include <cstddef>
+#include <map>
 #include <memory>
 
 namespace carto {
@@ -63,21 +65,28 @@ namespace carto {
     
         /**
          * Builds a new instance of the PointStyle object using previously set parameters.
-         * @return A new PointStyle object.
+         * Note that styles are immutable, so equal parameter sets may return a shared instance.
+         * @return A PointStyle object.
          */
         std::shared_ptr<PointStyle> buildStyle() const;
-    
+
     protected:
         static std::shared_ptr<Bitmap> GetDefaultBitmap();
-    
+
         static std::shared_ptr<Bitmap> _DefaultBitmap;
         static std::mutex _DefaultBitmapMutex;
-        
+
         std::shared_ptr<Bitmap> _bitmap;
-        
+
         float _clickSize;
-    
+
         float _size;
+
+    private:
+        static const std::size_t MAX_SHARED_STYLES;
+
+        static std::map<std::size_t, std::shared_ptr<PointStyle> > _SharedStyles;
+        static std::mutex _SharedStylesMutex;
     };
     
 }
@@ -4,6 +4,7 @@
 #include "components/Layers.h"
 #include "core/MapPos.h"
 #include "core/MapBounds.h"
+#include "core/MapTile.h"
 #include "core/ScreenPos.h"
 #include "core/ScreenBounds.h"
 #include "layers/Layer.h"
@@ -17,6 +18,7 @@
 #include "renderers/cameraevents/CameraZoomEvent.h"
 #include "renderers/cameraevents/CameraPanEvent.h"
 #include "ui/TouchHandler.h"
+#include "utils/NetworkUtils.h"
 #include "utils/PlatformUtils.h"
 #include "utils/Log.h"
 
@@ -24,6 +26,7 @@
 #include <unordered_map>
 #include <vector>
 #include <sstream>
+#include <iomanip>
 
 namespace carto {
 
@@ -296,7 +299,77 @@ namespace carto {
             }
         }
     }
-    
+
+    std::string BaseMapView::captureSessionSnapshot() const {
+        MapPos focusPos = getFocusPos();
+
+        std::stringstream ss;
+        ss << std::setprecision(16);
+        ss << "camera " << focusPos.getX() << " " << focusPos.getY() << " " << getZoom() << " " << getRotation() << " " << getTilt();
+
+        std::vector<std::shared_ptr<Layer> > layers = _layers->getAll();
+        for (std::size_t i = 0; i < layers.size(); i++) {
+            if (const std::shared_ptr<TileLayer>& tileLayer = std::dynamic_pointer_cast<TileLayer>(layers[i])) {
+                std::vector<MapTile> visibleTiles = tileLayer->getVisibleTiles();
+                ss << "\nlayer " << i << " " << visibleTiles.size();
+                for (const MapTile& mapTile : visibleTiles) {
+                    ss << " " << mapTile.getX() << " " << mapTile.getY() << " " << mapTile.getZoom();
+                }
+            }
+        }
+        return ss.str();
+    }
+
+    bool BaseMapView::restoreSessionSnapshot(const std::string& snapshot) {
+        std::stringstream ss(snapshot);
+
+        std::string tag;
+        double focusX = 0, focusY = 0;
+        float zoom = 0, rotation = 0, tilt = 0;
+        ss >> tag >> focusX >> focusY >> zoom >> rotation >> tilt;
+        if (!ss || tag != "camera") {
+            Log::Error("BaseMapView::restoreSessionSnapshot: Illegal snapshot format");
+            return false;
+        }
+
+        setFocusPos(MapPos(focusX, focusY), 0);
+        setZoom(zoom, 0);
+        setRotation(rotation, 0);
+        setTilt(tilt, 0);
+
+        std::vector<std::shared_ptr<Layer> > layers = _layers->getAll();
+        while (ss >> tag) {
+            std::size_t layerIndex = 0;
+            std::size_t tileCount = 0;
+            if (!(ss >> layerIndex >> tileCount) || tag != "layer") {
+                Log::Error("BaseMapView::restoreSessionSnapshot: Illegal snapshot format");
+                return false;
+            }
+
+            std::vector<MapTile> mapTiles;
+            mapTiles.reserve(tileCount);
+            for (std::size_t i = 0; i < tileCount; i++) {
+                int tileX = 0, tileY = 0, tileZoom = 0;
+                if (!(ss >> tileX >> tileY >> tileZoom)) {
+                    Log::Error("BaseMapView::restoreSessionSnapshot: Illegal snapshot format");
+                    return false;
+                }
+                mapTiles.emplace_back(tileX, tileY, tileZoom, 0);
+            }
+
+            if (layerIndex < layers.size()) {
+                if (const std::shared_ptr<TileLayer>& tileLayer = std::dynamic_pointer_cast<TileLayer>(layers[layerIndex])) {
+                    tileLayer->preloadTiles(mapTiles);
+                }
+            }
+        }
+        return true;
+    }
+
+    void BaseMapView::prewarmHTTPConnections(const std::vector<std::string>& urls) {
+        NetworkUtils::PrewarmHTTPConnections(urls, Log::IsShowDebug());
+    }
+
     const std::shared_ptr<Layers>& BaseMapView::getLayers() const {
         return _layers;
     }
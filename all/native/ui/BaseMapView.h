@@ -10,6 +10,7 @@
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 namespace carto {
     class CancelableThreadPool;
@@ -349,7 +350,34 @@ namespace carto {
          * including the visible area.
          */
         void clearAllCaches();
-    
+
+        /**
+         * Captures the current map session state as an opaque string. The snapshot contains
+         * the camera state and the ids of the currently visible tiles of all tile layers.
+         * The string can be persisted when the application is put into the background and
+         * later passed to restoreSessionSnapshot to restore the view.
+         * @return The serialized session snapshot.
+         */
+        std::string captureSessionSnapshot() const;
+        /**
+         * Restores a previously captured map session. The camera is moved to the captured state
+         * without animation and the captured tiles of all tile layers are scheduled for immediate
+         * loading, before the first frame is drawn. When the tile layers are backed by persistent
+         * tile caches (PersistentCacheTileDataSource), the restored view becomes visible
+         * right after startup without any network requests.
+         * @param snapshot The session snapshot previously returned by captureSessionSnapshot.
+         * @return True if the session was restored, false if the snapshot was not valid.
+         */
+        bool restoreSessionSnapshot(const std::string& snapshot);
+
+        /**
+         * Pre-warms HTTP connections to the specified service endpoints. The connections are established
+         * asynchronously on a background thread. Establishing DNS, TCP and TLS state before the first actual
+         * request can significantly reduce the latency of the first tile or service request on slow networks.
+         * @param urls The service URLs to connect to. Only the protocol, host and port parts of the URLs are used.
+         */
+        void prewarmHTTPConnections(const std::vector<std::string>& urls);
+
     private:
         std::shared_ptr<CancelableThreadPool> _envelopeThreadPool;
         std::shared_ptr<CancelableThreadPool> _tileThreadPool;
@@ -1,4 +1,5 @@
 #include "TouchHandler.h"
+#include "components/CancelableThreadPool.h"
 #include "components/Options.h"
 #include "graphics/ViewState.h"
 #include "layers/Layer.h"
@@ -18,6 +19,7 @@
 #include "utils/Log.h"
 
 #include <algorithm>
+#include <limits>
 
 namespace carto {
 
@@ -25,6 +27,7 @@ namespace carto {
         _gestureMode(SINGLE_POINTER_CLICK_GUESS),
         _prevScreenPos1(0, 0),
         _prevScreenPos2(0, 0),
+        _pointerSamples(),
         _swipe1(0, 0),
         _swipe2(0, 0),
         _pointersDown(0),
@@ -34,6 +37,8 @@ namespace carto {
         _mapEventListener(),
         _clickHandlerWorker(std::make_shared<ClickHandlerWorker>(options)),
         _clickHandlerThread(),
+        _clickResolverThreadPool(std::make_shared<CancelableThreadPool>()),
+        _pendingClickResolverTask(),
         _options(options),
         _mapRenderer(mapRenderer),
         _mapRendererListener(),
@@ -50,6 +55,9 @@ namespace carto {
         _clickHandlerWorker->setComponents(shared_from_this(), _clickHandlerWorker);
         _clickHandlerThread = std::thread(std::ref(*_clickHandlerWorker));
 
+        _clickResolverThreadPool->setPoolSize(1);
+        _clickResolverThreadPool->setQoS(ThreadQoS::INTERACTIVE);
+
         _mapRendererListener = std::make_shared<MapRendererListener>(shared_from_this());
         _mapRenderer->registerOnChangeListener(_mapRendererListener);
     }
@@ -60,6 +68,8 @@ namespace carto {
         
         _clickHandlerWorker->stop();
         _clickHandlerThread.detach();
+
+        _clickResolverThreadPool->deinit();
     }
     
     std::shared_ptr<MapEventListener> TouchHandler::getMapEventListener() const {
@@ -85,6 +95,8 @@ namespace carto {
         ViewState viewState = _mapRenderer->getViewState();
         switch (action) {
         case ACTION_POINTER_1_DOWN:
+            // A new gesture makes any still-queued click resolution obsolete
+            _clickResolverThreadPool->cancelAll();
             if (!_clickHandlerWorker->isRunning()) {
                 _clickHandlerWorker->init();
             }
@@ -162,6 +174,7 @@ namespace carto {
                 std::lock_guard<std::mutex> lock(_mutex);
                 _pointersDown = 0;
                 _clickHandlerWorker->cancel();
+                _clickResolverThreadPool->cancelAll();
                 _gestureMode = SINGLE_POINTER_CLICK_GUESS;
             }
             break;
@@ -221,6 +234,7 @@ namespace carto {
                     std::lock_guard<std::mutex> lock(_mutex);
                     _dualPointerReleaseTime = std::chrono::steady_clock::now();
                     _prevScreenPos1 = screenPos2;
+                    resetPointerPrediction(); // the remaining pointer is different from the sampled one
                     _gestureMode = SINGLE_POINTER_PAN;
                 }
                 break;
@@ -245,6 +259,7 @@ namespace carto {
                      std::lock_guard<std::mutex> lock(_mutex);
                      _dualPointerReleaseTime = std::chrono::steady_clock::now();
                      _prevScreenPos1 = screenPos1;
+                     resetPointerPrediction();
                      _gestureMode = SINGLE_POINTER_PAN;
                  }
                  break;
@@ -321,20 +336,67 @@ namespace carto {
         return static_cast<float>(factor);
     }
     
+    ScreenPos TouchHandler::predictPointerPos(const ScreenPos& screenPos) {
+        std::chrono::steady_clock::time_point time = std::chrono::steady_clock::now();
+        _pointerSamples.push_back(PointerSample{ time, cglib::vec2<float>(screenPos.getX(), screenPos.getY()) });
+        while (_pointerSamples.size() > 3) {
+            _pointerSamples.pop_front();
+        }
+        if (_pointerSamples.size() < 3) {
+            return screenPos;
+        }
+
+        const PointerSample& sample0 = _pointerSamples[0];
+        const PointerSample& sample1 = _pointerSamples[1];
+        const PointerSample& sample2 = _pointerSamples[2];
+        float dt0 = std::chrono::duration_cast<std::chrono::duration<float> >(sample1.time - sample0.time).count();
+        float dt1 = std::chrono::duration_cast<std::chrono::duration<float> >(sample2.time - sample1.time).count();
+        float maxSampleAge = POINTER_PREDICTION_MAX_SAMPLE_AGE.count() / 1000.0f;
+        if (dt0 <= 0 || dt1 <= 0 || dt0 > maxSampleAge || dt1 > maxSampleAge) {
+            return screenPos; // the pointer paused or events arrived in a burst, do not extrapolate
+        }
+
+        // Second-order model: velocity of the last sample interval plus velocity change (curvature)
+        cglib::vec2<float> vel0 = (sample1.pos - sample0.pos) * (1.0f / dt0);
+        cglib::vec2<float> vel1 = (sample2.pos - sample1.pos) * (1.0f / dt1);
+        cglib::vec2<float> acc = (vel1 - vel0) * (2.0f / (dt0 + dt1));
+        float dt = POINTER_PREDICTION_DURATION.count() / 1000.0f;
+        cglib::vec2<float> offset = vel1 * dt + acc * (0.5f * dt * dt);
+
+        // Clamp the predicted displacement, overshooting feels worse than lagging
+        float maxOffset = POINTER_PREDICTION_MAX_INCHES * _options->getDPI();
+        float offsetLength = cglib::length(offset);
+        if (offsetLength > maxOffset) {
+            offset = offset * (maxOffset / offsetLength);
+        }
+        return ScreenPos(screenPos.getX() + offset(0), screenPos.getY() + offset(1));
+    }
+
+    void TouchHandler::resetPointerPrediction() {
+        _pointerSamples.clear();
+    }
+
     void TouchHandler::singlePointerPan(const ScreenPos& screenPos, const ViewState& viewState) {
+        // Extrapolate the pointer to the expected presentation time. The camera tracks the
+        // predicted position and any misprediction is folded into the next event, as the
+        // pan deltas are calculated relative to the previously predicted position.
+        ScreenPos predictedPos = predictPointerPos(screenPos);
         if (_options->isUserInput()) {
             std::shared_ptr<ProjectionSurface> projectionSurface = viewState.getProjectionSurface();
             if (!projectionSurface) {
                 return;
             }
-            
+
             _mapRenderer->getAnimationHandler().stopPan();
             _mapRenderer->getAnimationHandler().stopRotation();
             _mapRenderer->getAnimationHandler().stopTilt();
             _mapRenderer->getAnimationHandler().stopZoom();
-            
-            if (isValidScreenPosition(screenPos, viewState) && isValidScreenPosition(_prevScreenPos1, viewState)) {
-                MapPos currentPos = mapScreenPosition(screenPos, viewState);
+
+            if (!isValidScreenPosition(predictedPos, viewState)) {
+                predictedPos = screenPos;
+            }
+            if (isValidScreenPosition(predictedPos, viewState) && isValidScreenPosition(_prevScreenPos1, viewState)) {
+                MapPos currentPos = mapScreenPosition(predictedPos, viewState);
                 MapPos prevPos = mapScreenPosition(_prevScreenPos1, viewState);
 
                 CameraPanEvent cameraEvent;
@@ -342,26 +404,29 @@ namespace carto {
                 _mapRenderer->calculateCameraEvent(cameraEvent, 0, true);
             }
         }
-        _prevScreenPos1 = screenPos;
+        _prevScreenPos1 = predictedPos;
     }
     
     void TouchHandler::singlePointerZoom(const ScreenPos& screenPos, const ViewState& viewState) {
+        // Extrapolate the pointer to the expected presentation time, mispredictions are
+        // folded into the next event via the predicted _prevScreenPos1
+        ScreenPos predictedPos = predictPointerPos(screenPos);
         if (_options->isUserInput()) {
             _mapRenderer->getAnimationHandler().stopPan();
             _mapRenderer->getAnimationHandler().stopRotation();
             _mapRenderer->getAnimationHandler().stopTilt();
             _mapRenderer->getAnimationHandler().stopZoom();
-            
+
             float dpi = _options->getDPI();
-            cglib::vec2<float> tempSwipe1(screenPos.getX() - _prevScreenPos1.getX(), screenPos.getY() - _prevScreenPos1.getY());
+            cglib::vec2<float> tempSwipe1(predictedPos.getX() - _prevScreenPos1.getX(), predictedPos.getY() - _prevScreenPos1.getY());
             _swipe1 += tempSwipe1 * (1.0f / dpi);
 
-            float delta = INCHES_TO_ZOOM_DELTA * (screenPos.getY() - _prevScreenPos1.getY()) / _options->getDPI();
+            float delta = INCHES_TO_ZOOM_DELTA * (predictedPos.getY() - _prevScreenPos1.getY()) / _options->getDPI();
             CameraZoomEvent cameraEvent;
             cameraEvent.setZoomDelta(delta);
             _mapRenderer->calculateCameraEvent(cameraEvent, 0, true);
         }
-        _prevScreenPos1 = screenPos;
+        _prevScreenPos1 = predictedPos;
     }
     
     void TouchHandler::dualPointerGuess(const ScreenPos& screenPos1, const ScreenPos& screenPos2, const ViewState& viewState) {
@@ -520,7 +585,7 @@ namespace carto {
         _mapRenderer->getAnimationHandler().stopTilt();
         _mapRenderer->getAnimationHandler().stopZoom();
         
-        handleClick(ClickType::CLICK_TYPE_SINGLE, screenPos);
+        resolveClick(ClickType::CLICK_TYPE_SINGLE, screenPos);
     }
     
     
@@ -536,7 +601,7 @@ namespace carto {
         _mapRenderer->getAnimationHandler().stopTilt();
         _mapRenderer->getAnimationHandler().stopZoom();
     
-        handleClick(ClickType::CLICK_TYPE_LONG, screenPos);
+        resolveClick(ClickType::CLICK_TYPE_LONG, screenPos);
     }
     
     void TouchHandler::doubleClick(const ScreenPos& screenPos) {
@@ -554,7 +619,7 @@ namespace carto {
             _prevScreenPos1 = screenPos;
             _gestureMode = SINGLE_POINTER_ZOOM;
         } else {
-            handleClick(ClickType::CLICK_TYPE_DOUBLE, screenPos);
+            resolveClick(ClickType::CLICK_TYPE_DOUBLE, screenPos);
         }
     }
     
@@ -575,7 +640,7 @@ namespace carto {
             _mapRenderer->calculateCameraEvent(cameraZoomTargetEvent, ZOOM_GESTURE_ANIMATION_DURATION.count() / 1000.0f, true);
         } else {
             ScreenPos centreScreenPos((screenPos1.getX() + screenPos2.getX()) / 2, (screenPos1.getY() + screenPos2.getY()) / 2);
-            handleClick(ClickType::CLICK_TYPE_DUAL, centreScreenPos);
+            resolveClick(ClickType::CLICK_TYPE_DUAL, centreScreenPos);
         }
     }
     
@@ -597,6 +662,20 @@ namespace carto {
         return viewState.getProjectionSurface()->calculateMapPos(pos);
     }
 
+    void TouchHandler::resolveClick(ClickType::ClickType clickType, const ScreenPos& screenPos) {
+        auto task = std::make_shared<ClickResolverTask>(shared_from_this(), clickType, screenPos);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            // A newly detected click supersedes any resolution that has not started yet.
+            // This covers double clicks arriving while the preceding single click is still queued.
+            if (_pendingClickResolverTask) {
+                _pendingClickResolverTask->cancel();
+            }
+            _pendingClickResolverTask = task;
+        }
+        _clickResolverThreadPool->execute(task, CLICK_RESOLVER_TASK_PRIORITY);
+    }
+
     void TouchHandler::handleClick(ClickType::ClickType clickType, const ScreenPos& screenPos) {
         ViewState viewState = _mapRenderer->getViewState();
         if (!isValidScreenPosition(screenPos, viewState)) {
@@ -630,15 +709,17 @@ namespace carto {
     void TouchHandler::startSinglePointer(const ScreenPos& screenPos) {
         std::lock_guard<std::mutex> lock(_mutex);
         _prevScreenPos1 = screenPos;
+        resetPointerPrediction();
         _gestureMode = SINGLE_POINTER_PAN;
     }
-    
+
     void TouchHandler::startDualPointer(const ScreenPos& screenPos1, const ScreenPos& screenPos2) {
         std::lock_guard<std::mutex> lock(_mutex);
         _swipe1 = cglib::vec2<float>(0, 0);
         _swipe2 = cglib::vec2<float>(0, 0);
         _prevScreenPos1 = screenPos1;
         _prevScreenPos2 = screenPos2;
+        resetPointerPrediction();
         _gestureMode = DUAL_POINTER_GUESS;
     }
 
@@ -656,6 +737,23 @@ namespace carto {
         }
     }
     
+    TouchHandler::ClickResolverTask::ClickResolverTask(const std::weak_ptr<TouchHandler>& touchHandler, ClickType::ClickType clickType, const ScreenPos& screenPos) :
+        _touchHandler(touchHandler),
+        _clickType(clickType),
+        _screenPos(screenPos)
+    {
+    }
+
+    void TouchHandler::ClickResolverTask::run() {
+        if (isCanceled()) {
+            return;
+        }
+
+        if (std::shared_ptr<TouchHandler> touchHandler = _touchHandler.lock()) {
+            touchHandler->handleClick(_clickType, _screenPos);
+        }
+    }
+
     TouchHandler::MapRendererListener::MapRendererListener(const std::shared_ptr<TouchHandler>& touchHandler) : _touchHandler(touchHandler) {
     }
     
@@ -714,4 +812,12 @@ namespace carto {
 
     const std::chrono::milliseconds TouchHandler::ZOOM_GESTURE_ANIMATION_DURATION = std::chrono::milliseconds(250);
 
+    const std::chrono::milliseconds TouchHandler::POINTER_PREDICTION_DURATION = std::chrono::milliseconds(25); // roughly 1.5 frames at 60fps
+
+    const std::chrono::milliseconds TouchHandler::POINTER_PREDICTION_MAX_SAMPLE_AGE = std::chrono::milliseconds(100);
+
+    const float TouchHandler::POINTER_PREDICTION_MAX_INCHES = 0.08f;
+
+    const int TouchHandler::CLICK_RESOLVER_TASK_PRIORITY = std::numeric_limits<int>::max();
+
 }
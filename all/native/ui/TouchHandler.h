@@ -7,12 +7,14 @@
 #ifndef _CARTO_TOUCHHANDLER_H_
 #define _CARTO_TOUCHHANDLER_H_
 
+#include "components/CancelableTask.h"
 #include "core/MapPos.h"
 #include "core/ScreenPos.h"
 #include "ui/MapClickInfo.h"
 #include "renderers/MapRenderer.h"
 
 #include <chrono>
+#include <deque>
 #include <memory>
 #include <thread>
 #include <vector>
@@ -20,6 +22,7 @@
 #include <cglib/vec.h>
 
 namespace carto {
+    class CancelableThreadPool;
     class ClickHandlerWorker;
     class Options;
     class MapEventListener;
@@ -80,11 +83,31 @@ namespace carto {
         private:
             std::weak_ptr<TouchHandler> _touchHandler;
         };
-        
+
+        class ClickResolverTask : public CancelableTask {
+        public:
+            ClickResolverTask(const std::weak_ptr<TouchHandler>& touchHandler, ClickType::ClickType clickType, const ScreenPos& screenPos);
+
+            virtual void run();
+
+        private:
+            std::weak_ptr<TouchHandler> _touchHandler;
+            ClickType::ClickType _clickType;
+            ScreenPos _screenPos;
+        };
+
+        struct PointerSample {
+            std::chrono::steady_clock::time_point time;
+            cglib::vec2<float> pos;
+        };
+
         void checkMapStable();
 
         float calculateRotatingScalingFactor(const ScreenPos& screenPos1, const ScreenPos& screenPos2) const;
 
+        ScreenPos predictPointerPos(const ScreenPos& screenPos);
+        void resetPointerPrediction();
+
         void singlePointerPan(const ScreenPos& screenPos, const ViewState& viewState);
         void singlePointerZoom(const ScreenPos& screenPos, const ViewState& viewState);
         void dualPointerGuess(const ScreenPos& screenPos1, const ScreenPos& screenPos2, const ViewState& viewState);
@@ -93,6 +116,7 @@ namespace carto {
 
         bool isValidScreenPosition(const ScreenPos& screenPos, const ViewState& viewState) const;
         MapPos mapScreenPosition(const ScreenPos& screenPos, const ViewState& viewState) const;
+        void resolveClick(ClickType::ClickType clickType, const ScreenPos& screenPos);
         void handleClick(ClickType::ClickType clickType, const ScreenPos& screenPos);
     
         static const float GUESS_MAX_DELTA_Y_INCHES;
@@ -130,14 +154,32 @@ namespace carto {
         // Determines how long zoom-in/out animations take
         static const std::chrono::milliseconds ZOOM_GESTURE_ANIMATION_DURATION;
 
+        // Determines the shared scheduler priority of click resolution tasks,
+        // must be above the update priorities used for tile and envelope tasks
+        static const int CLICK_RESOLVER_TASK_PRIORITY;
+
         // Map panning type, 0 = fast, accurate (finger stays exactly in the same
         // place), 1 = slow, inaccurate
         static const float PANNING_FACTOR;
-    
+
+        // Determines how far ahead of the last touch sample the pointer position is
+        // extrapolated when generating pan/zoom camera events, to compensate for the
+        // touch-to-display pipeline latency
+        static const std::chrono::milliseconds POINTER_PREDICTION_DURATION;
+
+        // Determines the maximum age of touch samples used for pointer prediction,
+        // prediction is disabled when the pointer pauses or events arrive in bursts
+        static const std::chrono::milliseconds POINTER_PREDICTION_MAX_SAMPLE_AGE;
+
+        // Determines the maximum predicted pointer displacement, in inches
+        static const float POINTER_PREDICTION_MAX_INCHES;
+
         GestureMode _gestureMode;
-        
+
         ScreenPos _prevScreenPos1;
         ScreenPos _prevScreenPos2;
+
+        std::deque<PointerSample> _pointerSamples;
     
         cglib::vec2<float> _swipe1;
         cglib::vec2<float> _swipe2;
@@ -151,7 +193,10 @@ namespace carto {
         
         std::shared_ptr<ClickHandlerWorker> _clickHandlerWorker;
         std::thread _clickHandlerThread;
-    
+
+        std::shared_ptr<CancelableThreadPool> _clickResolverThreadPool;
+        std::shared_ptr<ClickResolverTask> _pendingClickResolverTask;
+
         std::shared_ptr<Options> _options;
         std::shared_ptr<MapRenderer> _mapRenderer;
         std::shared_ptr<MapRendererListener> _mapRendererListener;
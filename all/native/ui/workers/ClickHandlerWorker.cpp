@@ -201,7 +201,7 @@ namespace carto {
     }
 
     void ClickHandlerWorker::run() {
-        ThreadUtils::SetThreadPriority(ThreadPriority::LOW);
+        ThreadUtils::SetThreadQoS(ThreadQoS::INTERACTIVE);
 
         while (true) {
             // If not running, wait until notified or exit thread if interrupted
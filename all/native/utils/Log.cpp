@@ -41,43 +41,35 @@ namespace carto {
 #endif
 
     bool Log::IsShowError() {
-        std::lock_guard<std::mutex> lock(_Mutex);
-        return _ShowError;
+        return _ShowError.load();
     }
 
     void Log::SetShowError(bool showError) {
-        std::lock_guard<std::mutex> lock(_Mutex);
-        _ShowError = showError;
+        _ShowError.store(showError);
     }
 
     bool Log::IsShowWarn() {
-        std::lock_guard<std::mutex> lock(_Mutex);
-        return _ShowWarn;
+        return _ShowWarn.load();
     }
 
     void Log::SetShowWarn(bool showWarn) {
-        std::lock_guard<std::mutex> lock(_Mutex);
-        _ShowWarn = showWarn;
+        _ShowWarn.store(showWarn);
     }
 
     bool Log::IsShowInfo() {
-        std::lock_guard<std::mutex> lock(_Mutex);
-        return _ShowInfo;
+        return _ShowInfo.load();
     }
 
     void Log::SetShowInfo(bool showInfo) {
-        std::lock_guard<std::mutex> lock(_Mutex);
-        _ShowInfo = showInfo;
+        _ShowInfo.store(showInfo);
     }
 
     bool Log::IsShowDebug() {
-        std::lock_guard<std::mutex> lock(_Mutex);
-        return _ShowDebug;
+        return _ShowDebug.load();
     }
 
     void Log::SetShowDebug(bool showDebug) {
-        std::lock_guard<std::mutex> lock(_Mutex);
-        _ShowDebug = showDebug;
+        _ShowDebug.store(showDebug);
     }
 
     std::string Log::GetTag() {
@@ -95,7 +87,13 @@ namespace carto {
     }
     
     void Log::SetLogEventListener(const std::shared_ptr<LogEventListener>& listener) {
+        // The presence flag is checked on the formatting fast path, raise it before
+        // attaching so the new listener does not miss messages formatted meanwhile
+        if (listener) {
+            _LogEventListenerSet.store(true);
+        }
         _LogEventListener.set(listener);
+        _LogEventListenerSet.store(listener ? true : false);
     }
 
     void Log::Fatal(const char* message) {
@@ -169,14 +167,15 @@ namespace carto {
     Log::Log() {
     }
 
-    bool Log::_ShowError = true;
-    bool Log::_ShowWarn = true;
-    bool Log::_ShowInfo = true;
-    bool Log::_ShowDebug = false;
+    std::atomic<bool> Log::_ShowError(true);
+    std::atomic<bool> Log::_ShowWarn(true);
+    std::atomic<bool> Log::_ShowInfo(true);
+    std::atomic<bool> Log::_ShowDebug(false);
 
     std::string Log::_Tag = "carto-mobile-sdk";
 
     DirectorPtr<LogEventListener> Log::_LogEventListener;
+    std::atomic<bool> Log::_LogEventListenerSet(false);
 
     std::mutex Log::_Mutex;
 
@@ -9,6 +9,7 @@
 
 #include "components/DirectorPtr.h"
 
+#include <atomic>
 #include <mutex>
 #include <string>
 #include <memory>
@@ -121,24 +122,36 @@ namespace carto {
 
         template <typename... Args>
         static void Errorf(const char* formatString, const Args&... args) {
+            if (!_ShowError.load(std::memory_order_relaxed) && !_LogEventListenerSet.load(std::memory_order_relaxed)) {
+                return; // skip formatting, the message would be dropped anyway
+            }
             std::string msg = tfm::format(formatString, args...);
             Error(msg.c_str());
         }
 
         template <typename... Args>
         static void Warnf(const char* formatString, const Args&... args) {
+            if (!_ShowWarn.load(std::memory_order_relaxed) && !_LogEventListenerSet.load(std::memory_order_relaxed)) {
+                return; // skip formatting, the message would be dropped anyway
+            }
             std::string msg = tfm::format(formatString, args...);
             Warn(msg.c_str());
         }
 
         template <typename... Args>
         static void Infof(const char* formatString, const Args&... args) {
+            if (!_ShowInfo.load(std::memory_order_relaxed) && !_LogEventListenerSet.load(std::memory_order_relaxed)) {
+                return; // skip formatting, the message would be dropped anyway
+            }
             std::string msg = tfm::format(formatString, args...);
             Info(msg.c_str());
         }
 
         template <typename... Args>
         static void Debugf(const char* formatString, const Args&... args) {
+            if (!_ShowDebug.load(std::memory_order_relaxed) && !_LogEventListenerSet.load(std::memory_order_relaxed)) {
+                return; // skip formatting, the message would be dropped anyway
+            }
             std::string msg = tfm::format(formatString, args...);
             Debug(msg.c_str());
         }
@@ -147,14 +160,15 @@ namespace carto {
     private:
         Log();
 
-        static bool _ShowError;
-        static bool _ShowWarn;
-        static bool _ShowInfo;
-        static bool _ShowDebug;
+        static std::atomic<bool> _ShowError;
+        static std::atomic<bool> _ShowWarn;
+        static std::atomic<bool> _ShowInfo;
+        static std::atomic<bool> _ShowDebug;
 
         static std::string _Tag;
 
         static DirectorPtr<LogEventListener> _LogEventListener;
+        static std::atomic<bool> _LogEventListenerSet;
 
         static std::mutex _Mutex;
     };
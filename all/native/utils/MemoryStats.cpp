@@ -0,0 +1,38 @@
+#include "MemoryStats.h"
+
+#include <picojson/picojson.h>
+
+namespace carto {
+
+    Variant MemoryStats::GetMemoryStats() {
+        picojson::object stats;
+        long long totalBytes = 0;
+        for (int subsystem = 0; subsystem < SUBSYSTEM_COUNT; subsystem++) {
+            long long subsystemBytes = _SubsystemBytes[subsystem].load(std::memory_order_relaxed);
+            stats[SUBSYSTEM_NAMES[subsystem]] = picojson::value(static_cast<std::int64_t>(subsystemBytes));
+            totalBytes += subsystemBytes;
+        }
+        stats["total"] = picojson::value(static_cast<std::int64_t>(totalBytes));
+        return Variant::FromPicoJSON(picojson::value(stats));
+    }
+
+    long long MemoryStats::GetSubsystemBytes(Subsystem subsystem) {
+        return _SubsystemBytes[subsystem].load(std::memory_order_relaxed);
+    }
+
+    void MemoryStats::Allocated(Subsystem subsystem, std::size_t size) {
+        _SubsystemBytes[subsystem].fetch_add(static_cast<long long>(size), std::memory_order_relaxed);
+    }
+
+    void MemoryStats::Freed(Subsystem subsystem, std::size_t size) {
+        _SubsystemBytes[subsystem].fetch_sub(static_cast<long long>(size), std::memory_order_relaxed);
+    }
+
+    MemoryStats::MemoryStats() {
+    }
+
+    const char* MemoryStats::SUBSYSTEM_NAMES[] = { "tile_cache", "draw_data", "bitmap" };
+
+    std::atomic<long long> MemoryStats::_SubsystemBytes[MemoryStats::SUBSYSTEM_COUNT] = { };
+
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2016 CartoDB. All rights reserved.
+ * Copying and using this code is allowed only according
+ * to license terms, as given in https://cartodb.com/terms/
+ */
+
+#ifndef _CARTO_MEMORYSTATS_H_
+#define _CARTO_MEMORYSTATS_H_
+
+#include "core/Variant.h"
+
+#include <atomic>
+#include <cstddef>
+
+namespace carto {
+
+    /**
+     * Memory accounting for the major SDK subsystems.
+     * Tracks the number of bytes currently allocated for tile data buffers,
+     * pooled draw data objects and bitmap pixel data, so that total memory
+     * use can be attributed to individual subsystems at runtime.
+     */
+    class MemoryStats {
+    public:
+        enum Subsystem {
+            SUBSYSTEM_TILE_CACHE = 0,
+            SUBSYSTEM_DRAW_DATA,
+            SUBSYSTEM_BITMAP,
+            SUBSYSTEM_COUNT
+        };
+
+        /**
+         * Returns the current memory statistics of all tracked subsystems.
+         * @return A variant object with the number of currently allocated bytes keyed by subsystem name ("tile_cache", "draw_data", "bitmap"), plus their sum under "total".
+         */
+        static Variant GetMemoryStats();
+
+        /**
+         * Returns the number of bytes currently allocated by the specified subsystem.
+         * @param subsystem The subsystem to query.
+         * @return The number of currently allocated bytes.
+         */
+        static long long GetSubsystemBytes(Subsystem subsystem);
+
+        static void Allocated(Subsystem subsystem, std::size_t size);
+        static void Freed(Subsystem subsystem, std::size_t size);
+
+    private:
+        MemoryStats();
+
+        static const char* SUBSYSTEM_NAMES[];
+
+        static std::atomic<long long> _SubsystemBytes[SUBSYSTEM_COUNT];
+    };
+
+}
+
+#endif
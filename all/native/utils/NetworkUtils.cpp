@@ -3,8 +3,10 @@
 #include "network/HTTPClient.h"
 #include "utils/GeneralUtils.h"
 #include "utils/PlatformUtils.h"
+#include "utils/ThreadUtils.h"
 #include "utils/Log.h"
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <iomanip>
@@ -14,6 +16,7 @@
 #include <string>
 #include <cstdint>
 #include <regex>
+#include <thread>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
@@ -50,6 +53,53 @@ namespace carto {
         return -1;
     }
 
+    void NetworkUtils::PrewarmHTTPConnections(const std::vector<std::string>& urls, bool log) {
+        // Reduce the URLs to their protocol/host/port parts and drop duplicates,
+        // establishing a connection does not depend on the request path
+        std::vector<std::string> hostURLs;
+        for (const std::string& url : urls) {
+            std::size_t index = url.find("://");
+            if (index == std::string::npos) {
+                continue;
+            }
+            index = url.find('/', index + 3);
+            std::string hostURL = (index != std::string::npos ? url.substr(0, index) : url) + "/";
+            if (std::find(hostURLs.begin(), hostURLs.end(), hostURL) == hostURLs.end()) {
+                hostURLs.push_back(hostURL);
+            }
+        }
+        if (hostURLs.empty()) {
+            return;
+        }
+
+        // Issue lightweight requests on a background thread. The responses themselves do not matter,
+        // the goal is to establish DNS, TCP and TLS session state before the first actual request.
+        // The platform HTTP stacks keep this state in process-wide caches, including TLS session
+        // tickets used to resume subsequent connections without full handshakes.
+        std::thread prewarmThread([hostURLs, log]() {
+            ThreadUtils::SetThreadQoS(ThreadQoS::UTILITY);
+            HTTPClient client(log);
+            for (const std::string& hostURL : hostURLs) {
+                std::map<std::string, std::string> requestHeaders = CreateAppRefererHeader();
+                std::map<std::string, std::string> responseHeaders;
+                auto handlerFn = [](std::uint64_t offset, std::uint64_t length, const unsigned char* buf, std::size_t size) {
+                    return true;
+                };
+                try {
+                    int code = client.streamResponse("HEAD", hostURL, requestHeaders, responseHeaders, handlerFn, 0);
+                    if (log) {
+                        Log::Debugf("NetworkUtils::PrewarmHTTPConnections: Pre-warmed connection to %s, result %d", hostURL.c_str(), code);
+                    }
+                } catch (const std::exception& ex) {
+                    if (log) {
+                        Log::Errorf("NetworkUtils::PrewarmHTTPConnections: Exception: %s", ex.what());
+                    }
+                }
+            }
+        });
+        prewarmThread.detach();
+    }
+
     int NetworkUtils::GetMaxAgeHTTPHeader(const std::map<std::string, std::string>& headers) {
         for (auto it = headers.begin(); it != headers.end(); it++) {
             if (boost::iequals(it->first, "Cache-Control")) {
@@ -27,6 +27,8 @@ namespace carto {
 
         static int StreamHTTPResponse(const std::string& method, const std::string& url, const std::map<std::string, std::string>& requestHeaders, std::map<std::string, std::string>& responseHeaders, HandlerFunc handler, std::uint64_t offset, bool log);
 
+        static void PrewarmHTTPConnections(const std::vector<std::string>& urls, bool log);
+
         static int GetMaxAgeHTTPHeader(const std::map<std::string, std::string>& headers);
 
         static std::string URLEncode(const std::string& value);
@@ -0,0 +1,45 @@
+#include "PoolAllocator.h"
+#include "utils/MemoryStats.h"
+
+namespace carto {
+
+    void* MemoryBlockPool::Allocate(std::size_t size) {
+        MemoryStats::Allocated(MemoryStats::SUBSYSTEM_DRAW_DATA, size);
+        if (size == 0 || size > MAX_BLOCK_SIZE) {
+            return ::operator new(size);
+        }
+        std::size_t sizeClass = (size - 1) / BLOCK_GRANULARITY;
+        {
+            std::lock_guard<std::mutex> lock(_Mutex);
+            std::vector<void*>& freeBlocks = _FreeBlocks[sizeClass];
+            if (!freeBlocks.empty()) {
+                void* ptr = freeBlocks.back();
+                freeBlocks.pop_back();
+                return ptr;
+            }
+        }
+        return ::operator new((sizeClass + 1) * BLOCK_GRANULARITY);
+    }
+
+    void MemoryBlockPool::Deallocate(void* ptr, std::size_t size) {
+        MemoryStats::Freed(MemoryStats::SUBSYSTEM_DRAW_DATA, size);
+        if (size == 0 || size > MAX_BLOCK_SIZE) {
+            ::operator delete(ptr);
+            return;
+        }
+        std::size_t sizeClass = (size - 1) / BLOCK_GRANULARITY;
+        {
+            std::lock_guard<std::mutex> lock(_Mutex);
+            std::vector<void*>& freeBlocks = _FreeBlocks[sizeClass];
+            if (freeBlocks.size() < MAX_FREE_BLOCKS) {
+                freeBlocks.push_back(ptr);
+                return;
+            }
+        }
+        ::operator delete(ptr);
+    }
+
+    std::vector<void*> MemoryBlockPool::_FreeBlocks[MAX_BLOCK_SIZE / BLOCK_GRANULARITY];
+    std::mutex MemoryBlockPool::_Mutex;
+
+}
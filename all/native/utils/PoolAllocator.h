@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2016 CartoDB. All rights reserved.
+ * Copying and using this code is allowed only according
+ * to license terms, as given in https://cartodb.com/terms/
+ */
+
+#ifndef _CARTO_POOLALLOCATOR_H_
+#define _CARTO_POOLALLOCATOR_H_
+
+#include <cstddef>
+#include <new>
+#include <mutex>
+#include <vector>
+
+namespace carto {
+
+    /**
+     * A process-wide pool of fixed-size memory blocks. Freed blocks are kept in
+     * per-size free lists and recycled by subsequent allocations of the same size class,
+     * so steady-state allocation patterns cause no actual allocator traffic.
+     */
+    class MemoryBlockPool {
+    public:
+        static void* Allocate(std::size_t size);
+        static void Deallocate(void* ptr, std::size_t size);
+
+    private:
+        MemoryBlockPool();
+
+        static const std::size_t BLOCK_GRANULARITY = 64; // block sizes are rounded up to a multiple of this
+        static const std::size_t MAX_BLOCK_SIZE = 2048; // larger blocks bypass the pool
+        static const std::size_t MAX_FREE_BLOCKS = 4096; // per size class
+
+        static std::vector<void*> _FreeBlocks[MAX_BLOCK_SIZE / BLOCK_GRANULARITY];
+        static std::mutex _Mutex;
+    };
+
+    /**
+     * An STL-compatible allocator backed by MemoryBlockPool. Intended to be used
+     * with std::allocate_shared for small objects that are recreated frequently,
+     * like draw datas rebuilt on every layer refresh.
+     */
+    template <typename T>
+    class PoolAllocator {
+    public:
+        typedef T value_type;
+
+        PoolAllocator() { }
+        template <typename S>
+        PoolAllocator(const PoolAllocator<S>& other) { }
+
+        T* allocate(std::size_t n) {
+            if (n == 1) {
+                return static_cast<T*>(MemoryBlockPool::Allocate(sizeof(T)));
+            }
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+
+        void deallocate(T* ptr, std::size_t n) {
+            if (n == 1) {
+                MemoryBlockPool::Deallocate(ptr, sizeof(T));
+            } else {
+                ::operator delete(ptr);
+            }
+        }
+    };
+
+    template <typename T, typename S>
+    bool operator==(const PoolAllocator<T>& alloc1, const PoolAllocator<S>& alloc2) {
+        return true;
+    }
+
+    template <typename T, typename S>
+    bool operator!=(const PoolAllocator<T>& alloc1, const PoolAllocator<S>& alloc2) {
+        return false;
+    }
+
+}
+
+#endif
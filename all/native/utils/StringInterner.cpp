@@ -0,0 +1,18 @@
+#include "StringInterner.h"
+
+namespace carto {
+
+    const std::string& StringInterner::Intern(const std::string& str) {
+        Shard& shard = _Shards[std::hash<std::string>()(str) % SHARD_COUNT];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        // References into the set remain valid across rehashing, so the returned
+        // reference is stable for the lifetime of the process
+        return *shard.strings.insert(str).first;
+    }
+
+    StringInterner::StringInterner() {
+    }
+
+    StringInterner::Shard StringInterner::_Shards[StringInterner::SHARD_COUNT];
+
+}
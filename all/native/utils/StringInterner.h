@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2016 CartoDB. All rights reserved.
+ * Copying and using this code is allowed only according
+ * to license terms, as given in https://cartodb.com/terms/
+ */
+
+#ifndef _CARTO_STRINGINTERNER_H_
+#define _CARTO_STRINGINTERNER_H_
+
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+namespace carto {
+
+    /**
+     * A process-wide string interning table. Interning maps equal strings to a single
+     * shared instance with a stable address, so recurring strings (vector tile attribute
+     * keys, for example) are stored once and can be compared by pointer.
+     * The table is sharded by string hash to keep lock contention negligible.
+     * Interned strings are never released, so the table must only be used for strings
+     * drawn from small recurring sets.
+     */
+    class StringInterner {
+    public:
+        static const std::string& Intern(const std::string& str);
+
+    private:
+        struct Shard {
+            std::mutex mutex;
+            std::unordered_set<std::string> strings;
+        };
+
+        StringInterner();
+
+        static const std::size_t SHARD_COUNT = 16;
+
+        static Shard _Shards[SHARD_COUNT];
+    };
+
+}
+
+#endif
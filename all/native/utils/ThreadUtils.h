@@ -15,9 +15,18 @@ namespace carto {
         enum ThreadPriority {MINIMUM = 20, LOW = 10, NORMAL = 0, HIGH = -10, MAXIMUM = -20};
     }
 
+    namespace ThreadQoS {
+        // Quality-of-service classes for SDK threads. BACKGROUND is for work the user is not
+        // waiting on (preloading, cache maintenance) and may be throttled or scheduled on
+        // efficiency cores, UTILITY is for normal asynchronous work and INTERACTIVE is for
+        // latency-critical work the user is actively waiting on.
+        enum ThreadQoS {BACKGROUND, UTILITY, INTERACTIVE};
+    }
+
     class ThreadUtils {
     public:
         static void SetThreadPriority(ThreadPriority::ThreadPriority priority);
+        static void SetThreadQoS(ThreadQoS::ThreadQoS qos);
 
     private:
         ThreadUtils();
@@ -47,6 +47,34 @@ namespace carto {
          */
         static MapBounds CalculateMapTileBounds(const MapTile& mapTile, const std::shared_ptr<Projection>& proj);
 
+        /**
+         * Calculates the map tile corresponding to specified point and zoom level.
+         * This overload takes precalculated projection bounds and is intended for loops over many tiles.
+         * @param mapPos Coordinates for the point.
+         * @param zoom Zoom level for the tile.
+         * @param projBounds The bounds of the projection to use for tile and point.
+         * @return The corresponding map tile.
+         */
+        static MapTile CalculateMapTile(const MapPos& mapPos, int zoom, const MapBounds& projBounds);
+
+        /**
+         * Calculates origin coordinates for the given map tile.
+         * This overload takes precalculated projection bounds and is intended for loops over many tiles.
+         * @param mapTile The map tile to use.
+         * @param projBounds The bounds of the projection to use for origin.
+         * @return The corresponding tile origin.
+         */
+        static MapPos CalculateMapTileOrigin(const MapTile& mapTile, const MapBounds& projBounds);
+
+        /**
+         * Calculates bounds for the given map tile.
+         * This overload takes precalculated projection bounds and is intended for loops over many tiles.
+         * @param mapTile The map tile to use.
+         * @param projBounds The bounds of the projection to use for bounds.
+         * @return The corresponding tile bounds.
+         */
+        static MapBounds CalculateMapTileBounds(const MapTile& mapTile, const MapBounds& projBounds);
+
     private:
         TileUtils();
     };
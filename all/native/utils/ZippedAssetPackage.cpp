@@ -11,6 +11,8 @@
 #include <miniz.c>
 #include <string.h>
 
+#include <unordered_set>
+
 namespace carto {
 
     ZippedAssetPackage::ZippedAssetPackage(const std::shared_ptr<BinaryData>& zipData) :
@@ -41,13 +43,11 @@ namespace carto {
         std::vector<std::string> names;
         names.reserve(_assetIndexMap.size());
         for (auto it = _assetIndexMap.begin(); it != _assetIndexMap.end(); it++) {
-            if (std::find(names.begin(), names.end(), it->first) == names.end()) {
-                names.push_back(it->first);
-            }
+            names.push_back(it->first);
         }
         return names;
     }
-    
+
     std::vector<std::string> ZippedAssetPackage::getAssetNames() const {
         std::lock_guard<std::mutex> lock(_mutex);
 
@@ -55,9 +55,10 @@ namespace carto {
         if (_baseAssetPackage) {
             names = _baseAssetPackage->getAssetNames();
         }
+        std::unordered_set<std::string> baseNames(names.begin(), names.end());
         names.reserve(names.size() + _assetIndexMap.size());
         for (auto it = _assetIndexMap.begin(); it != _assetIndexMap.end(); it++) {
-            if (std::find(names.begin(), names.end(), it->first) == names.end()) {
+            if (baseNames.find(it->first) == baseNames.end()) {
                 names.push_back(it->first);
             }
         }
@@ -80,13 +81,19 @@ namespace carto {
             return std::shared_ptr<BinaryData>();
         }
     
-        std::size_t elementSize = 0;
-        std::shared_ptr<unsigned char> elementData(static_cast<unsigned char*>(mz_zip_reader_extract_to_heap(zip, it->second, &elementSize, 0)), mz_free);
-        if (!elementData) {
+        mz_zip_archive_file_stat stat;
+        if (!mz_zip_reader_file_stat(zip, it->second, &stat)) {
+            Log::Error("ZippedAssetPackage::loadAsset: Could not read archive asset stats");
+            return std::shared_ptr<BinaryData>();
+        }
+
+        // Decompress directly into the final buffer, avoiding an extra copy of the asset
+        std::vector<unsigned char> elementData(static_cast<std::size_t>(stat.m_uncomp_size));
+        if (!mz_zip_reader_extract_to_mem(zip, it->second, elementData.data(), elementData.size(), 0)) {
             Log::Error("ZippedAssetPackage::loadAsset: Could not load archive asset");
             return std::shared_ptr<BinaryData>();
         }
-        return std::make_shared<BinaryData>(elementData.get(), elementSize);
+        return std::make_shared<BinaryData>(std::move(elementData));
     }
 
     void ZippedAssetPackage::initialize() {
@@ -10,6 +10,7 @@
 #include "utils/AssetPackage.h"
 
 #include <mutex>
+#include <unordered_map>
 
 namespace carto {
 
@@ -45,7 +46,7 @@ namespace carto {
         const std::shared_ptr<BinaryData> _zipData;
         const std::shared_ptr<AssetPackage> _baseAssetPackage;
         std::shared_ptr<void> _handle;
-        std::map<std::string, unsigned int> _assetIndexMap;
+        std::unordered_map<std::string, unsigned int> _assetIndexMap;
 
         mutable std::mutex _mutex;
     };
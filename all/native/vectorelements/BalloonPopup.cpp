@@ -356,12 +356,6 @@ namespace carto {
                 return std::shared_ptr<Bitmap>();
             }
         
-            BitmapCanvas canvas(canvasWidth, canvasHeight);
-        
-            // Prepare background path
-            ScreenBounds backgroundRect(ScreenPos(halfStrokeWidth, halfStrokeWidth),
-                                        ScreenPos(popupWidth - halfStrokeWidth, popupHeight - triangleStrokeOffset));
-        
             // Calculate anchor point and triangle position
             int triangleOffsetX = 0;
             if (screenPos.getX() + halfPopupWidth + screenPadding > screenWidth) {
@@ -369,70 +363,104 @@ namespace carto {
             } else if (screenPos.getX() - halfPopupWidth - screenPadding < 0) {
                 triangleOffsetX = screenPos.getX() - halfPopupWidth - screenPadding;
             }
-        
+
             int maxHalfOffsetX = static_cast<int>(halfPopupWidth - halfTriangleWidth - _style->getCornerRadius() - halfStrokeWidth);
             triangleOffsetX = std::min(maxHalfOffsetX, std::max(-maxHalfOffsetX, triangleOffsetX));
-        
-            // Prepare triangle path
-            float triangleOriginX = triangleOffsetX + halfPopupWidth - halfTriangleWidth;
-            float triangleOriginY = popupHeight - triangleStrokeOffset;
-            ScreenPos triangleP0(triangleOriginX, triangleOriginY);
-            ScreenPos triangleP1(triangleOriginX + triangleWidth, triangleOriginY);
-            ScreenPos triangleP2(triangleOriginX + halfTriangleWidth, triangleOriginY + triangleHeight);
-            std::vector<ScreenPos> trianglePoints { triangleP0, triangleP1, triangleP2 };
-        
-            // Stroke background and triangle
-            canvas.setDrawMode(BitmapCanvas::STROKE);
-            canvas.setColor(strokeColor);
-            canvas.setStrokeWidth(strokeWidth);
-            canvas.drawRoundRect(backgroundRect, _style->getCornerRadius());
-            canvas.drawPolygon(trianglePoints);
-        
-            // Fill background/2 and triangle
-            canvas.setDrawMode(BitmapCanvas::FILL);
-            canvas.setColor(backgroundColor);
-            canvas.drawRoundRect(backgroundRect, _style->getCornerRadius());
-            canvas.drawPolygon(trianglePoints);
-        
-            if (leftMarginWidth > 0 && leftColor != backgroundColor) {
-                // Fill the left area
-                ScreenBounds leftRect(ScreenPos(0, 0),
-                                      ScreenPos(leftMarginWidth + halfStrokeWidth, popupHeight));
-                canvas.pushClipRect(leftRect);
-                canvas.setColor(leftColor);
-                canvas.drawRoundRect(backgroundRect, _style->getCornerRadius());
-                canvas.drawPolygon(trianglePoints);
-                canvas.popClipRect();
-            }
-        
-            // Fill right area
-            if (rightMarginWidth > 0 && rightColor != backgroundColor) {
-                // Fill the right area
-                ScreenBounds rightRect(ScreenPos(popupWidth - halfStrokeWidth - rightMarginWidth, 0),
-                                       ScreenPos(popupWidth, popupHeight));
-                canvas.pushClipRect(rightRect);
-                canvas.setColor(rightColor);
-                canvas.drawRoundRect(backgroundRect, _style->getCornerRadius());
-                canvas.drawPolygon(trianglePoints);
-                canvas.popClipRect();
-            }
-        
-            // Draw left image
-            if (leftImage) {
-                ScreenPos leftOrigin(halfStrokeWidth + leftMargins.getLeft(),
-                                     halfStrokeWidth + std::max((float) leftMargins.getTop(), (float) (popupInnerHeight * 0.5f - leftImageHeight * 0.5f)));
-                ScreenBounds leftRect(leftOrigin, ScreenPos(leftOrigin.getX() + leftImageWidth, leftOrigin.getY() + leftImageHeight));
-                canvas.drawBitmap(leftRect, leftImage);
+
+            BitmapCanvas canvas(canvasWidth, canvasHeight);
+
+            // Rasterize the background only when the style, size or triangle position has changed.
+            // Text changes that keep the popup size then only pay for text rendering, the
+            // background, strokes and images are composed from the cached raster.
+            if (!_backgroundCache.bitmap
+                || _backgroundCache.style != _style
+                || _backgroundCache.width != canvasWidth
+                || _backgroundCache.height != canvasHeight
+                || _backgroundCache.innerHeight != popupInnerHeight
+                || _backgroundCache.triangleOffsetX != triangleOffsetX
+                || _backgroundCache.dpToPX != dpToPX)
+            {
+                BitmapCanvas backgroundCanvas(canvasWidth, canvasHeight);
+
+                // Prepare background path
+                ScreenBounds backgroundRect(ScreenPos(halfStrokeWidth, halfStrokeWidth),
+                                            ScreenPos(popupWidth - halfStrokeWidth, popupHeight - triangleStrokeOffset));
+
+                // Prepare triangle path
+                float triangleOriginX = triangleOffsetX + halfPopupWidth - halfTriangleWidth;
+                float triangleOriginY = popupHeight - triangleStrokeOffset;
+                ScreenPos triangleP0(triangleOriginX, triangleOriginY);
+                ScreenPos triangleP1(triangleOriginX + triangleWidth, triangleOriginY);
+                ScreenPos triangleP2(triangleOriginX + halfTriangleWidth, triangleOriginY + triangleHeight);
+                std::vector<ScreenPos> trianglePoints { triangleP0, triangleP1, triangleP2 };
+
+                // Stroke background and triangle
+                backgroundCanvas.setDrawMode(BitmapCanvas::STROKE);
+                backgroundCanvas.setColor(strokeColor);
+                backgroundCanvas.setStrokeWidth(strokeWidth);
+                backgroundCanvas.drawRoundRect(backgroundRect, _style->getCornerRadius());
+                backgroundCanvas.drawPolygon(trianglePoints);
+
+                // Fill background/2 and triangle
+                backgroundCanvas.setDrawMode(BitmapCanvas::FILL);
+                backgroundCanvas.setColor(backgroundColor);
+                backgroundCanvas.drawRoundRect(backgroundRect, _style->getCornerRadius());
+                backgroundCanvas.drawPolygon(trianglePoints);
+
+                if (leftMarginWidth > 0 && leftColor != backgroundColor) {
+                    // Fill the left area
+                    ScreenBounds leftRect(ScreenPos(0, 0),
+                                          ScreenPos(leftMarginWidth + halfStrokeWidth, popupHeight));
+                    backgroundCanvas.pushClipRect(leftRect);
+                    backgroundCanvas.setColor(leftColor);
+                    backgroundCanvas.drawRoundRect(backgroundRect, _style->getCornerRadius());
+                    backgroundCanvas.drawPolygon(trianglePoints);
+                    backgroundCanvas.popClipRect();
+                }
+
+                // Fill right area
+                if (rightMarginWidth > 0 && rightColor != backgroundColor) {
+                    // Fill the right area
+                    ScreenBounds rightRect(ScreenPos(popupWidth - halfStrokeWidth - rightMarginWidth, 0),
+                                           ScreenPos(popupWidth, popupHeight));
+                    backgroundCanvas.pushClipRect(rightRect);
+                    backgroundCanvas.setColor(rightColor);
+                    backgroundCanvas.drawRoundRect(backgroundRect, _style->getCornerRadius());
+                    backgroundCanvas.drawPolygon(trianglePoints);
+                    backgroundCanvas.popClipRect();
+                }
+
+                // Draw left image
+                if (leftImage) {
+                    ScreenPos leftOrigin(halfStrokeWidth + leftMargins.getLeft(),
+                                         halfStrokeWidth + std::max((float) leftMargins.getTop(), (float) (popupInnerHeight * 0.5f - leftImageHeight * 0.5f)));
+                    ScreenBounds leftRect(leftOrigin, ScreenPos(leftOrigin.getX() + leftImageWidth, leftOrigin.getY() + leftImageHeight));
+                    backgroundCanvas.drawBitmap(leftRect, leftImage);
+                }
+
+                // Draw right image
+                if (rightImage) {
+                    ScreenPos rightOrigin(popupWidth - halfStrokeWidth - rightMarginWidth + rightMargins.getLeft(),
+                                          halfStrokeWidth + std::max((float) rightMargins.getTop(), (float) (popupInnerHeight * 0.5f - rightImageHeight * 0.5f)));
+                    ScreenBounds rightRect(rightOrigin, ScreenPos(rightOrigin.getX() + rightImageWidth, rightOrigin.getY() + rightImageHeight));
+                    backgroundCanvas.drawBitmap(rightRect, rightImage);
+                }
+
+                _backgroundCache.style = _style;
+                _backgroundCache.width = canvasWidth;
+                _backgroundCache.height = canvasHeight;
+                _backgroundCache.innerHeight = popupInnerHeight;
+                _backgroundCache.triangleOffsetX = triangleOffsetX;
+                _backgroundCache.dpToPX = dpToPX;
+                _backgroundCache.bitmap = backgroundCanvas.buildBitmap();
             }
-        
-            // Draw right image
-            if (rightImage) {
-                ScreenPos rightOrigin(popupWidth - halfStrokeWidth - rightMarginWidth + rightMargins.getLeft(),
-                                      halfStrokeWidth + std::max((float) rightMargins.getTop(), (float) (popupInnerHeight * 0.5f - rightImageHeight * 0.5f)));
-                ScreenBounds rightRect(rightOrigin, ScreenPos(rightOrigin.getX() + rightImageWidth, rightOrigin.getY() + rightImageHeight));
-                canvas.drawBitmap(rightRect, rightImage);
+
+            // Compose the background
+            if (_backgroundCache.bitmap) {
+                ScreenBounds backgroundBounds(ScreenPos(0, 0), ScreenPos(canvasWidth, canvasHeight));
+                canvas.drawBitmap(backgroundBounds, _backgroundCache.bitmap);
             }
-        
+
             // Draw title
             if (!title.empty()) {
                 ScreenPos titlePos(halfStrokeWidth + leftMarginWidth + titleMargins.getLeft(),
@@ -131,6 +131,16 @@ namespace carto {
                                                    float screenWidth, float screenHeight, float dpToPX);
         
     private:
+        struct BackgroundCache {
+            std::shared_ptr<BalloonPopupStyle> style;
+            int width = 0;
+            int height = 0;
+            int innerHeight = 0;
+            int triangleOffsetX = 0;
+            float dpToPX = 0;
+            std::shared_ptr<Bitmap> bitmap;
+        };
+
         static const int SCREEN_PADDING = 10;
         static const int MAX_CANVAS_SIZE = 8192;
 
@@ -138,10 +148,12 @@ namespace carto {
         void drawButtonOnCanvas(const std::shared_ptr<BalloonPopupButton>& button, BitmapCanvas& canvas, const ScreenBounds& bounds, float dpToPX) const;
 
         std::shared_ptr<BalloonPopupStyle> _style;
-        
+
         std::string _title;
         std::string _desc;
 
+        BackgroundCache _backgroundCache;
+
         std::vector<std::shared_ptr<BalloonPopupButton> > _buttons;
         std::map<std::shared_ptr<BalloonPopupButton>, ScreenBounds> _buttonRects;
 
@@ -44,6 +44,7 @@ namespace carto {
         {
             std::lock_guard<std::recursive_mutex> lock(_mutex);
             _geometry = geometry;
+            _drawData.reset(); // the tessellation can no longer be reused
         }
         notifyElementChanged();
     }
@@ -56,6 +57,7 @@ namespace carto {
         {
             std::lock_guard<std::recursive_mutex> lock(_mutex);
             _geometry = std::make_shared<LineGeometry>(poses);
+            _drawData.reset(); // the tessellation can no longer be reused
         }
         notifyElementChanged();
     
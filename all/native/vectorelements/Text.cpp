@@ -8,6 +8,7 @@
 
 #include <cstdlib>
 #include <cmath>
+#include <sstream>
 
 namespace carto {
     
@@ -58,6 +59,16 @@ namespace carto {
                 }
             }
 
+            // Check if an identical text bitmap has already been rendered
+            std::string cacheKey = buildBitmapCacheKey(text, dpToPX);
+            {
+                std::lock_guard<std::mutex> cacheLock(_BitmapCacheMutex);
+                std::shared_ptr<Bitmap> cachedBitmap;
+                if (_BitmapCache.read(cacheKey, cachedBitmap)) {
+                    return cachedBitmap;
+                }
+            }
+
             float fontSize = _style->getFontSize() * dpToPX;
             float strokeWidth = _style->getStrokeWidth() * dpToPX;
             float borderWidth = _style->getBorderWidth() * dpToPX;
@@ -105,7 +116,12 @@ namespace carto {
             canvas.setDrawMode(BitmapCanvas::FILL);
             canvas.drawText(text, ScreenPos(borderPadding + borderWidth + leftPadding + strokeWidth * 0.5f, borderPadding + borderWidth + topPadding + strokeWidth * 0.5f), textBounds.getWidth(), _style->isBreakLines());
 
-            return canvas.buildBitmap();
+            std::shared_ptr<Bitmap> bitmap = canvas.buildBitmap();
+            if (bitmap) {
+                std::lock_guard<std::mutex> cacheLock(_BitmapCacheMutex);
+                _BitmapCache.put(cacheKey, bitmap, bitmap->getWidth() * bitmap->getHeight() * 4);
+            }
+            return bitmap;
         }
         catch (const std::exception& ex) {
             Log::Errorf("Text::drawBitmap: Failed to render bitmap: %s", ex.what());
@@ -143,4 +159,21 @@ namespace carto {
         Label::setStyle(style);
     }
 
+    std::string Text::buildBitmapCacheKey(const std::string& text, float dpToPX) const {
+        // The key must capture every style property that affects the rendered bitmap
+        std::stringstream ss;
+        ss << _style->getFontName() << '|' << dpToPX << '|' << _style->getFontSize() << '|' << _style->getFontColor().getARGB()
+           << '|' << _style->getStrokeWidth() << '|' << _style->getStrokeColor().getARGB()
+           << '|' << _style->getBorderWidth() << '|' << _style->getBorderColor().getARGB()
+           << '|' << _style->getBackgroundColor().getARGB()
+           << '|' << _style->getTextMargins().getLeft() << ',' << _style->getTextMargins().getRight() << ',' << _style->getTextMargins().getTop() << ',' << _style->getTextMargins().getBottom()
+           << '|' << _style->isBreakLines() << '|' << text;
+        return ss.str();
+    }
+
+    const std::size_t Text::BITMAP_CACHE_SIZE = 4 * 1024 * 1024;
+
+    cache::timed_lru_cache<std::string, std::shared_ptr<Bitmap> > Text::_BitmapCache(Text::BITMAP_CACHE_SIZE);
+    std::mutex Text::_BitmapCacheMutex;
+
 }
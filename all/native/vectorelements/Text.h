@@ -10,8 +10,11 @@
 #include "vectorelements/Label.h"
 
 #include <memory>
+#include <mutex>
 #include <string>
 
+#include <stdext/timed_lru_cache.h>
+
 namespace carto {
     class TextStyle;
 
@@ -68,7 +71,15 @@ namespace carto {
         void setStyle(const std::shared_ptr<TextStyle>& style);
 
     private:
+        std::string buildBitmapCacheKey(const std::string& text, float dpToPX) const;
+
         static const int MAX_CANVAS_SIZE = 8192;
+        static const std::size_t BITMAP_CACHE_SIZE;
+
+        // Rendered text bitmaps are cached and shared between all Text elements, so
+        // frequently updated labels with recurring contents reuse rasterizations
+        static cache::timed_lru_cache<std::string, std::shared_ptr<Bitmap> > _BitmapCache;
+        static std::mutex _BitmapCacheMutex;
 
         std::shared_ptr<TextStyle> _style;
 
@@ -84,6 +84,7 @@ namespace carto {
         std::shared_ptr<VectorDataSource> dataSource;
         {
             std::lock_guard<std::recursive_mutex> lock(_mutex);
+            _changeGeneration++;
             dataSource = _dataSource.lock();
         }
         if (dataSource) {
@@ -91,13 +92,19 @@ namespace carto {
         }
     }
     
+    long long VectorElement::getChangeGeneration() const {
+        std::lock_guard<std::recursive_mutex> lock(_mutex);
+        return _changeGeneration;
+    }
+
     VectorElement::VectorElement(const std::shared_ptr<Geometry>& geometry) :
         _dataSource(),
         _geometry(geometry),
         _mutex(),
         _id(-1),
         _metaData(),
-        _visible(true)
+        _visible(true),
+        _changeGeneration(0)
     {
     }
 
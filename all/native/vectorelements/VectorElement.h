@@ -100,7 +100,9 @@ namespace carto {
          * The data source may then notify the layer to update the view.
          */
         void notifyElementChanged();
-    
+
+        long long getChangeGeneration() const;
+
     protected:
         friend class VectorDataSource;
         
@@ -118,10 +120,12 @@ namespace carto {
 
     private:
         long long _id;
-    
+
         std::map<std::string, Variant> _metaData;
-    
+
         bool _visible;
+
+        long long _changeGeneration;
     };
     
 }
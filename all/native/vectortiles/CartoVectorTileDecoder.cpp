@@ -4,6 +4,7 @@
 #include "core/BinaryData.h"
 #include "core/Variant.h"
 #include "components/Exceptions.h"
+#include "components/CancelableTask.h"
 #include "geometry/Feature.h"
 #include "geometry/Geometry.h"
 #include "geometry/PointGeometry.h"
@@ -13,6 +14,7 @@
 #include "geometry/MultiLineGeometry.h"
 #include "geometry/MultiPolygonGeometry.h"
 #include "geometry/VectorTileFeature.h"
+#include "geometry/VectorTileFeatureData.h"
 #include "geometry/VectorTileFeatureCollection.h"
 #include "graphics/Bitmap.h"
 #include "styles/CartoCSSStyleSet.h"
@@ -24,6 +26,7 @@
 #include "utils/AssetPackage.h"
 #include "utils/FileUtils.h"
 #include "utils/Const.h"
+#include "utils/StringInterner.h"
 #include "utils/Log.h"
 
 #include <vt/Tile.h>
@@ -36,6 +39,7 @@
 #include <cartocss/CartoCSSMapLoader.h>
 
 #include <functional>
+#include <unordered_map>
 
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string/predicate.hpp>
@@ -51,6 +55,7 @@ namespace carto {
         _layerMaps(),
         _layerSymbolizerContexts(),
         _assetPackageSymbolizerContexts(),
+        _layerDecodeStateMap(),
         _mapSettings()
     {
         for (auto it = layerStyleSets.begin(); it != layerStyleSets.end(); it++) {
@@ -83,11 +88,15 @@ namespace carto {
             if (it == _layerStyleSets.end()) {
                 throw OutOfRangeException("Invalid layer id");
             }
+            if ((_layerInvisibleSet.count(layerId) == 0) == visible) {
+                return; // visibility unchanged, avoid invalidating the decoded tiles
+            }
             if (visible) {
                 _layerInvisibleSet.erase(layerId);
             } else {
                 _layerInvisibleSet.insert(layerId);
             }
+            updateLayerDecodeStateMap();
         }
         notifyDecoderChanged();
     }
@@ -172,12 +181,15 @@ namespace carto {
                 return std::shared_ptr<VectorTileFeature>();
             }
 
-            std::map<std::string, Variant> featureData;
+            auto keyTable = std::make_shared<std::vector<const std::string*> >();
+            auto featureData = std::make_shared<VectorTileFeatureData>(keyTable);
             if (std::shared_ptr<const mvt::FeatureData> mvtFeatureData = mvtFeature.getFeatureData()) {
                 for (const std::string& varName : mvtFeatureData->getVariableNames()) {
                     mvt::Value mvtValue;
                     if (mvtFeatureData->getVariable(varName, mvtValue)) {
-                        featureData[varName] = boost::apply_visitor(ValueConverter(), mvtValue);
+                        int keyIndex = static_cast<int>(keyTable->size());
+                        keyTable->push_back(&StringInterner::Intern(varName));
+                        boost::apply_visitor(FeatureDataValueConverter(*featureData, keyIndex), mvtValue);
                     }
                 }
             }
@@ -186,7 +198,7 @@ namespace carto {
                 return MapPos(tileBounds.getMin().getX() + pos(0) * tileBounds.getDelta().getX(), tileBounds.getMax().getY() - pos(1) * tileBounds.getDelta().getY(), 0);
             };
 
-            return std::make_shared<VectorTileFeature>(mvtFeature.getId(), MapTile(tile.x, tile.y, tile.zoom, 0), mvtLayerName, convertGeometry(convertFn, mvtGeometry), Variant(featureData));
+            return std::make_shared<VectorTileFeature>(mvtFeature.getId(), MapTile(tile.x, tile.y, tile.zoom, 0), mvtLayerName, convertGeometry(convertFn, mvtGeometry), featureData);
         } catch (const std::exception& ex) {
             Log::Errorf("CartoVectorTileDecoder::decodeFeature: Exception while decoding: %s", ex.what());
         }
@@ -194,12 +206,18 @@ namespace carto {
     }
 
     std::shared_ptr<VectorTileFeatureCollection> CartoVectorTileDecoder::decodeFeatures(const vt::TileId& tile, const std::shared_ptr<BinaryData>& tileData, const MapBounds& tileBounds) const {
+        return decodeFeatures(tile, tileData, tileBounds, std::set<std::string>());
+    }
+
+    std::shared_ptr<VectorTileFeatureCollection> CartoVectorTileDecoder::decodeFeatures(const vt::TileId& tile, const std::shared_ptr<BinaryData>& tileData, const MapBounds& tileBounds, const std::set<std::string>& layerNames) const {
         if (!tileData) {
             Log::Warn("CartoVectorTileDecoder::decodeFeatures: Null tile data");
             return std::shared_ptr<VectorTileFeatureCollection>();
         }
 
         std::vector<std::shared_ptr<VectorTileFeature> > tileFeatures;
+        auto keyTable = std::make_shared<std::vector<const std::string*> >();
+        std::unordered_map<std::string, int> keyIndexMap;
         try {
             std::shared_ptr<mvt::MBVTFeatureDecoder> decoder;
             {
@@ -215,18 +233,26 @@ namespace carto {
             }
 
             for (const std::string& mvtLayerName : decoder->getLayerNames()) {
+                if (!layerNames.empty() && layerNames.find(mvtLayerName) == layerNames.end()) {
+                    continue;
+                }
                 for (std::shared_ptr<mvt::FeatureDecoder::FeatureIterator> mvtIt = decoder->createLayerFeatureIterator(mvtLayerName); mvtIt->valid(); mvtIt->advance()) {
                     std::shared_ptr<const mvt::Geometry> mvtGeometry = mvtIt->getGeometry();
                     if (!mvtGeometry) {
                         continue;
                     }
 
-                    std::map<std::string, Variant> featureData;
+                    auto featureData = std::make_shared<VectorTileFeatureData>(keyTable);
                     if (std::shared_ptr<const mvt::FeatureData> mvtFeatureData = mvtIt->getFeatureData()) {
                         for (const std::string& varName : mvtFeatureData->getVariableNames()) {
                             mvt::Value mvtValue;
                             if (mvtFeatureData->getVariable(varName, mvtValue)) {
-                                featureData[varName] = boost::apply_visitor(ValueConverter(), mvtValue);
+                                auto keyIt = keyIndexMap.find(varName);
+                                if (keyIt == keyIndexMap.end()) {
+                                    keyIt = keyIndexMap.emplace(varName, static_cast<int>(keyTable->size())).first;
+                                    keyTable->push_back(&StringInterner::Intern(varName));
+                                }
+                                boost::apply_visitor(FeatureDataValueConverter(*featureData, keyIt->second), mvtValue);
                             }
                         }
                     }
@@ -235,7 +261,7 @@ namespace carto {
                         return MapPos(tileBounds.getMin().getX() + pos(0) * tileBounds.getDelta().getX(), tileBounds.getMax().getY() - pos(1) * tileBounds.getDelta().getY(), 0);
                     };
 
-                    auto feature = std::make_shared<VectorTileFeature>(mvtIt->getGlobalId(), MapTile(tile.x, tile.y, tile.zoom, 0), mvtLayerName, convertGeometry(convertFn, mvtGeometry), Variant(featureData));
+                    auto feature = std::make_shared<VectorTileFeature>(mvtIt->getGlobalId(), MapTile(tile.x, tile.y, tile.zoom, 0), mvtLayerName, convertGeometry(convertFn, mvtGeometry), featureData);
                     tileFeatures.push_back(feature);
                 }
             }
@@ -243,44 +269,44 @@ namespace carto {
             Log::Errorf("CartoVectorTileDecoder::decodeFeatures: Exception while decoding: %s", ex.what());
             return std::shared_ptr<VectorTileFeatureCollection>();
         }
-        return std::make_shared<VectorTileFeatureCollection>(tileFeatures);
+        return std::make_shared<VectorTileFeatureCollection>(std::move(tileFeatures));
     }
 
-    std::shared_ptr<CartoVectorTileDecoder::TileMap> CartoVectorTileDecoder::decodeTile(const vt::TileId& tile, const vt::TileId& targetTile, const std::shared_ptr<vt::TileTransformer>& tileTransformer, const std::shared_ptr<BinaryData>& tileData) const {
+    std::shared_ptr<CartoVectorTileDecoder::TileMap> CartoVectorTileDecoder::decodeTile(const vt::TileId& tile, const vt::TileId& targetTile, const std::shared_ptr<vt::TileTransformer>& tileTransformer, const std::shared_ptr<BinaryData>& tileData, const std::shared_ptr<CancelableTask>& cancelToken) const {
         if (!tileData) {
             Log::Warn("CartoVectorTileDecoder::decodeTile: Null tile data");
             return std::shared_ptr<TileMap>();
         }
 
-        std::set<std::string> layerInvisibleSet;
-        std::map<std::string, std::shared_ptr<mvt::Map> > layerMaps;
-        std::map<std::string, std::shared_ptr<mvt::SymbolizerContext> > layerSymbolizerContexts;
+        std::shared_ptr<const std::map<std::string, LayerDecodeState> > layerDecodeStateMap;
         {
             std::lock_guard<std::mutex> lock(_mutex);
-            layerInvisibleSet = _layerInvisibleSet;
-            layerMaps = _layerMaps;
-            layerSymbolizerContexts = _layerSymbolizerContexts;
+            layerDecodeStateMap = _layerDecodeStateMap;
         }
-    
+        if (!layerDecodeStateMap) {
+            return std::shared_ptr<TileMap>();
+        }
+
         try {
             mvt::MBVTFeatureDecoder decoder(*tileData->getDataPtr(), _logger);
             decoder.setTransform(calculateTileTransform(tile, targetTile));
             decoder.setGlobalIdOverride(true, MapTile(tile.x, tile.y, tile.zoom, 0).getTileId());
 
             std::vector<std::shared_ptr<vt::Tile> > tiles(_layerIds.size());
-            for (auto it = layerMaps.begin(); it != layerMaps.end(); it++) {
-                if (layerInvisibleSet.count(it->first) > 0) {
-                    continue;
+            for (auto it = layerDecodeStateMap->begin(); it != layerDecodeStateMap->end(); it++) {
+                // Cancellation checkpoint between the symbolizing stages of individual layers
+                if (cancelToken && cancelToken->isCanceled()) {
+                    return std::shared_ptr<TileMap>();
                 }
 
-                std::size_t index = std::distance(_layerIds.begin(), std::find(_layerIds.begin(), _layerIds.end(), it->first));
-                if (index >= tiles.size()) {
+                const LayerDecodeState& layerDecodeState = it->second;
+                if (!layerDecodeState.visible || layerDecodeState.layerIndex >= tiles.size()) {
                     continue;
                 }
 
-                mvt::MBVTTileReader reader(it->second, tileTransformer, *layerSymbolizerContexts[it->first], decoder);
+                mvt::MBVTTileReader reader(layerDecodeState.map, tileTransformer, *layerDecodeState.symbolizerContext, decoder);
                 reader.setLayerNameOverride(it->first);
-                tiles[index] = reader.readTile(targetTile);
+                tiles[layerDecodeState.layerIndex] = reader.readTile(targetTile);
             }
 
             float tileSize = 256.0f;
@@ -365,6 +391,20 @@ namespace carto {
         _layerStyleSets[layerId] = styleSet;
         _layerMaps[layerId] = map;
         _layerSymbolizerContexts[layerId] = symbolizerContext;
+        updateLayerDecodeStateMap();
+    }
+
+    void CartoVectorTileDecoder::updateLayerDecodeStateMap() {
+        auto layerDecodeStateMap = std::make_shared<std::map<std::string, LayerDecodeState> >();
+        for (auto it = _layerMaps.begin(); it != _layerMaps.end(); it++) {
+            LayerDecodeState layerDecodeState;
+            layerDecodeState.layerIndex = std::distance(_layerIds.begin(), std::find(_layerIds.begin(), _layerIds.end(), it->first));
+            layerDecodeState.visible = _layerInvisibleSet.count(it->first) == 0;
+            layerDecodeState.map = it->second;
+            layerDecodeState.symbolizerContext = _layerSymbolizerContexts[it->first];
+            (*layerDecodeStateMap)[it->first] = layerDecodeState;
+        }
+        _layerDecodeStateMap = layerDecodeStateMap;
     }
 
     const int CartoVectorTileDecoder::DEFAULT_TILE_SIZE = 256;
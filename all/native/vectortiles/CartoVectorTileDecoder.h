@@ -89,11 +89,27 @@ namespace carto {
         virtual std::shared_ptr<VectorTileFeature> decodeFeature(long long id, const vt::TileId& tile, const std::shared_ptr<BinaryData>& tileData, const MapBounds& tileBounds) const;
 
         virtual std::shared_ptr<VectorTileFeatureCollection> decodeFeatures(const vt::TileId& tile, const std::shared_ptr<BinaryData>& tileData, const MapBounds& tileBounds) const;
+#ifndef SWIG
+        virtual std::shared_ptr<VectorTileFeatureCollection> decodeFeatures(const vt::TileId& tile, const std::shared_ptr<BinaryData>& tileData, const MapBounds& tileBounds, const std::set<std::string>& layerNames) const;
+#endif
 
-        virtual std::shared_ptr<TileMap> decodeTile(const vt::TileId& tile, const vt::TileId& targetTile, const std::shared_ptr<vt::TileTransformer>& tileTransformer, const std::shared_ptr<BinaryData>& tileData) const;
+        virtual std::shared_ptr<TileMap> decodeTile(const vt::TileId& tile, const vt::TileId& targetTile, const std::shared_ptr<vt::TileTransformer>& tileTransformer, const std::shared_ptr<BinaryData>& tileData, const std::shared_ptr<CancelableTask>& cancelToken) const;
     
     protected:
+        // Decode-time snapshot of the per-layer style state, rebuilt when the
+        // style generation or layer visibility changes. Decoding only reads the
+        // immutable snapshot, so no per-tile style lookups or copies are needed.
+        struct LayerDecodeState {
+            LayerDecodeState() : layerIndex(0), visible(true), map(), symbolizerContext() { }
+
+            std::size_t layerIndex;
+            bool visible;
+            std::shared_ptr<mvt::Map> map;
+            std::shared_ptr<mvt::SymbolizerContext> symbolizerContext;
+        };
+
         void updateLayerStyleSet(const std::string& layerId, const std::shared_ptr<CartoCSSStyleSet>& styleSet);
+        void updateLayerDecodeStateMap();
 
         static const int DEFAULT_TILE_SIZE;
         static const int STROKEMAP_SIZE;
@@ -108,6 +124,7 @@ namespace carto {
         std::map<std::string, std::shared_ptr<mvt::Map> > _layerMaps;
         std::map<std::string, std::shared_ptr<mvt::SymbolizerContext> > _layerSymbolizerContexts;
         std::map<std::shared_ptr<AssetPackage>, std::shared_ptr<mvt::SymbolizerContext> > _assetPackageSymbolizerContexts;
+        std::shared_ptr<const std::map<std::string, LayerDecodeState> > _layerDecodeStateMap;
         std::shared_ptr<mvt::Map::Settings> _mapSettings;
 
         mutable std::pair<std::shared_ptr<BinaryData>, std::shared_ptr<mvt::MBVTFeatureDecoder> > _cachedFeatureDecoder;
@@ -4,6 +4,7 @@
 #include "core/BinaryData.h"
 #include "core/Variant.h"
 #include "components/Exceptions.h"
+#include "components/CancelableTask.h"
 #include "geometry/Feature.h"
 #include "geometry/Geometry.h"
 #include "geometry/PointGeometry.h"
@@ -13,6 +14,7 @@
 #include "geometry/MultiLineGeometry.h"
 #include "geometry/MultiPolygonGeometry.h"
 #include "geometry/VectorTileFeature.h"
+#include "geometry/VectorTileFeatureData.h"
 #include "geometry/VectorTileFeatureCollection.h"
 #include "graphics/Bitmap.h"
 #include "styles/CompiledStyleSet.h"
@@ -25,6 +27,7 @@
 #include "utils/AssetPackage.h"
 #include "utils/FileUtils.h"
 #include "utils/Const.h"
+#include "utils/StringInterner.h"
 #include "utils/Log.h"
 
 #include <vt/Tile.h>
@@ -37,6 +40,7 @@
 #include <cartocss/CartoCSSMapLoader.h>
 
 #include <functional>
+#include <unordered_map>
 
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string/predicate.hpp>
@@ -53,8 +57,7 @@ namespace carto {
         _styleSet(),
         _map(),
         _mapSettings(),
-        _symbolizerContext(),
-        _assetPackageSymbolizerContexts()
+        _symbolizerContext()
     {
         if (!compiledStyleSet) {
             throw NullArgumentException("Null compiledStyleSet");
@@ -183,16 +186,16 @@ namespace carto {
             }
             const mvt::NutiParameter& nutiParam = it->second;
 
+            mvt::Value val = nutiParam.getDefaultValue();
             if (!nutiParam.getEnumMap().empty()) {
                 auto it2 = nutiParam.getEnumMap().find(value);
                 if (it2 == nutiParam.getEnumMap().end()) {
                     Log::Errorf("MBVectorTileDecoder::setStyleParameter: Illegal enum value for parameter: %s/%s", param.c_str(), value.c_str());
                     return false;
                 }
-                _parameterValueMap[param] = it2->second;
+                val = it2->second;
             } else {
                 try {
-                    mvt::Value val = nutiParam.getDefaultValue();
                     if (boost::get<bool>(&val)) {
                         if (value == "true") {
                             val = mvt::Value(true);
@@ -208,13 +211,27 @@ namespace carto {
                     } else if (boost::get<std::string>(&val)) {
                         val = value;
                     }
-                    _parameterValueMap[param] = val;
                 } catch (const std::exception& ex) {
                     Log::Errorf("MBVectorTileDecoder::setStyleParameter: Exception while converting parameter %s/%s: %s", param.c_str(), value.c_str(), ex.what());
                     return false;
                 }
             }
 
+            // Skip the symbolizer context rebuild and the tile invalidation when the effective
+            // value does not change. UIs often re-apply their full parameter set when a single
+            // toggle changes, which would otherwise force a full viewport re-decode per parameter.
+            mvt::Value currentValue = nutiParam.getDefaultValue();
+            {
+                auto it2 = _parameterValueMap.find(param);
+                if (it2 != _parameterValueMap.end()) {
+                    currentValue = it2->second;
+                }
+            }
+            if (val == currentValue) {
+                return true;
+            }
+            _parameterValueMap[param] = val;
+
             std::map<std::string, mvt::Value> parameterValueMap = _symbolizerContext->getSettings().getNutiParameterValueMap();
             for (auto it2 = _parameterValueMap.begin(); it2 != _parameterValueMap.end(); it2++) {
                 parameterValueMap[it2->first] = it2->second;
@@ -234,6 +251,9 @@ namespace carto {
     void MBVectorTileDecoder::setFeatureIdOverride(bool idOverride) {
         {
             std::lock_guard<std::mutex> lock(_mutex);
+            if (_featureIdOverride == idOverride) {
+                return;
+            }
             _featureIdOverride = idOverride;
         }
         notifyDecoderChanged();
@@ -247,8 +267,10 @@ namespace carto {
     void MBVectorTileDecoder::setCartoCSSLayerNamesIgnored(bool ignore) {
         {
             std::lock_guard<std::mutex> lock(_mutex);
+            if (_cartoCSSLayerNamesIgnored == ignore) {
+                return;
+            }
             _cartoCSSLayerNamesIgnored = ignore;
-            _assetPackageSymbolizerContexts.clear();
             updateCurrentStyleSet(_styleSet);
         }
         notifyDecoderChanged();
@@ -262,6 +284,9 @@ namespace carto {
     void MBVectorTileDecoder::setLayerNameOverride(const std::string& name) {
         {
             std::lock_guard<std::mutex> lock(_mutex);
+            if (_layerNameOverride == name) {
+                return;
+            }
             _layerNameOverride = name;
         }
         notifyDecoderChanged();
@@ -277,7 +302,6 @@ namespace carto {
             std::lock_guard<std::mutex> lock(_mutex);
             if (fontData) {
                 _fallbackFonts.push_back(fontData);
-                _assetPackageSymbolizerContexts.clear();
                 updateCurrentStyleSet(_styleSet);
             }
         }
@@ -292,6 +316,30 @@ namespace carto {
         return Const::MAX_SUPPORTED_ZOOM_LEVEL;
     }
 
+    std::shared_ptr<mvt::MBVTFeatureDecoder> MBVectorTileDecoder::getFeatureDecoder(const std::shared_ptr<BinaryData>& tileData) const {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (auto it = _cachedFeatureDecoders.begin(); it != _cachedFeatureDecoders.end(); it++) {
+                if (it->first == tileData) {
+                    std::pair<std::shared_ptr<BinaryData>, std::shared_ptr<mvt::MBVTFeatureDecoder> > entry = *it;
+                    _cachedFeatureDecoders.erase(it);
+                    _cachedFeatureDecoders.push_back(entry);
+                    return entry.second;
+                }
+            }
+        }
+
+        // Decode outside of the lock, other decoder threads may proceed with their own tiles
+        auto decoder = std::make_shared<mvt::MBVTFeatureDecoder>(*tileData->getDataPtr(), _logger);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_cachedFeatureDecoders.size() >= MAX_CACHED_FEATURE_DECODERS) {
+            _cachedFeatureDecoders.erase(_cachedFeatureDecoders.begin());
+        }
+        _cachedFeatureDecoders.emplace_back(tileData, decoder);
+        return decoder;
+    }
+
     std::shared_ptr<VectorTileFeature> MBVectorTileDecoder::decodeFeature(long long id, const vt::TileId& tile, const std::shared_ptr<BinaryData>& tileData, const MapBounds& tileBounds) const {
         if (!tileData) {
             Log::Warn("MBVectorTileDecoder::decodeFeature: Null tile data");
@@ -299,18 +347,7 @@ namespace carto {
         }
 
         try {
-            std::shared_ptr<mvt::MBVTFeatureDecoder> decoder;
-            {
-                std::unique_lock<std::mutex> lock(_mutex);
-                if (_cachedFeatureDecoder.first != tileData) {
-                    lock.unlock();
-                    decoder = std::make_shared<mvt::MBVTFeatureDecoder>(*tileData->getDataPtr(), _logger);
-                    lock.lock();
-                    _cachedFeatureDecoder = std::make_pair(tileData, decoder);
-                } else {
-                    decoder = _cachedFeatureDecoder.second;
-                }
-            }
+            std::shared_ptr<mvt::MBVTFeatureDecoder> decoder = getFeatureDecoder(tileData);
 
             std::string mvtLayerName;
             mvt::Feature mvtFeature;
@@ -323,12 +360,15 @@ namespace carto {
                 return std::shared_ptr<VectorTileFeature>();
             }
 
-            std::map<std::string, Variant> featureData;
+            auto keyTable = std::make_shared<std::vector<const std::string*> >();
+            auto featureData = std::make_shared<VectorTileFeatureData>(keyTable);
             if (std::shared_ptr<const mvt::FeatureData> mvtFeatureData = mvtFeature.getFeatureData()) {
                 for (const std::string& varName : mvtFeatureData->getVariableNames()) {
                     mvt::Value mvtValue;
                     if (mvtFeatureData->getVariable(varName, mvtValue)) {
-                        featureData[varName] = boost::apply_visitor(ValueConverter(), mvtValue);
+                        int keyIndex = static_cast<int>(keyTable->size());
+                        keyTable->push_back(&StringInterner::Intern(varName));
+                        boost::apply_visitor(FeatureDataValueConverter(*featureData, keyIndex), mvtValue);
                     }
                 }
             }
@@ -337,7 +377,7 @@ namespace carto {
                 return MapPos(tileBounds.getMin().getX() + pos(0) * tileBounds.getDelta().getX(), tileBounds.getMax().getY() - pos(1) * tileBounds.getDelta().getY(), 0);
             };
 
-            return std::make_shared<VectorTileFeature>(mvtFeature.getId(), MapTile(tile.x, tile.y, tile.zoom, 0), mvtLayerName, convertGeometry(convertFn, mvtGeometry), Variant(featureData));
+            return std::make_shared<VectorTileFeature>(mvtFeature.getId(), MapTile(tile.x, tile.y, tile.zoom, 0), mvtLayerName, convertGeometry(convertFn, mvtGeometry), featureData);
         } catch (const std::exception& ex) {
             Log::Errorf("MBVectorTileDecoder::decodeFeature: Exception while decoding: %s", ex.what());
         }
@@ -345,39 +385,42 @@ namespace carto {
     }
 
     std::shared_ptr<VectorTileFeatureCollection> MBVectorTileDecoder::decodeFeatures(const vt::TileId& tile, const std::shared_ptr<BinaryData>& tileData, const MapBounds& tileBounds) const {
+        return decodeFeatures(tile, tileData, tileBounds, std::set<std::string>());
+    }
+
+    std::shared_ptr<VectorTileFeatureCollection> MBVectorTileDecoder::decodeFeatures(const vt::TileId& tile, const std::shared_ptr<BinaryData>& tileData, const MapBounds& tileBounds, const std::set<std::string>& layerNames) const {
         if (!tileData) {
             Log::Warn("MBVectorTileDecoder::decodeFeatures: Null tile data");
             return std::shared_ptr<VectorTileFeatureCollection>();
         }
 
         std::vector<std::shared_ptr<VectorTileFeature> > tileFeatures;
+        auto keyTable = std::make_shared<std::vector<const std::string*> >();
+        std::unordered_map<std::string, int> keyIndexMap;
         try {
-            std::shared_ptr<mvt::MBVTFeatureDecoder> decoder;
-            {
-                std::unique_lock<std::mutex> lock(_mutex);
-                if (_cachedFeatureDecoder.first != tileData) {
-                    lock.unlock();
-                    decoder = std::make_shared<mvt::MBVTFeatureDecoder>(*tileData->getDataPtr(), _logger);
-                    lock.lock();
-                    _cachedFeatureDecoder = std::make_pair(tileData, decoder);
-                } else {
-                    decoder = _cachedFeatureDecoder.second;
-                }
-            }
+            std::shared_ptr<mvt::MBVTFeatureDecoder> decoder = getFeatureDecoder(tileData);
 
             for (const std::string& mvtLayerName : decoder->getLayerNames()) {
+                if (!layerNames.empty() && layerNames.find(mvtLayerName) == layerNames.end()) {
+                    continue;
+                }
                 for (std::shared_ptr<mvt::FeatureDecoder::FeatureIterator> mvtIt = decoder->createLayerFeatureIterator(mvtLayerName); mvtIt->valid(); mvtIt->advance()) {
                     std::shared_ptr<const mvt::Geometry> mvtGeometry = mvtIt->getGeometry();
                     if (!mvtGeometry) {
                         continue;
                     }
 
-                    std::map<std::string, Variant> featureData;
+                    auto featureData = std::make_shared<VectorTileFeatureData>(keyTable);
                     if (std::shared_ptr<const mvt::FeatureData> mvtFeatureData = mvtIt->getFeatureData()) {
                         for (const std::string& varName : mvtFeatureData->getVariableNames()) {
                             mvt::Value mvtValue;
                             if (mvtFeatureData->getVariable(varName, mvtValue)) {
-                                featureData[varName] = boost::apply_visitor(ValueConverter(), mvtValue);
+                                auto keyIt = keyIndexMap.find(varName);
+                                if (keyIt == keyIndexMap.end()) {
+                                    keyIt = keyIndexMap.emplace(varName, static_cast<int>(keyTable->size())).first;
+                                    keyTable->push_back(&StringInterner::Intern(varName));
+                                }
+                                boost::apply_visitor(FeatureDataValueConverter(*featureData, keyIt->second), mvtValue);
                             }
                         }
                     }
@@ -386,7 +429,7 @@ namespace carto {
                         return MapPos(tileBounds.getMin().getX() + pos(0) * tileBounds.getDelta().getX(), tileBounds.getMax().getY() - pos(1) * tileBounds.getDelta().getY(), 0);
                     };
 
-                    auto feature = std::make_shared<VectorTileFeature>(mvtIt->getGlobalId(), MapTile(tile.x, tile.y, tile.zoom, 0), mvtLayerName, convertGeometry(convertFn, mvtGeometry), Variant(featureData));
+                    auto feature = std::make_shared<VectorTileFeature>(mvtIt->getGlobalId(), MapTile(tile.x, tile.y, tile.zoom, 0), mvtLayerName, convertGeometry(convertFn, mvtGeometry), featureData);
                     tileFeatures.push_back(feature);
                 }
             }
@@ -394,10 +437,10 @@ namespace carto {
             Log::Errorf("MBVectorTileDecoder::decodeFeatures: Exception while decoding: %s", ex.what());
             return std::shared_ptr<VectorTileFeatureCollection>();
         }
-        return std::make_shared<VectorTileFeatureCollection>(tileFeatures);
+        return std::make_shared<VectorTileFeatureCollection>(std::move(tileFeatures));
     }
 
-    std::shared_ptr<MBVectorTileDecoder::TileMap> MBVectorTileDecoder::decodeTile(const vt::TileId& tile, const vt::TileId& targetTile, const std::shared_ptr<vt::TileTransformer>& tileTransformer, const std::shared_ptr<BinaryData>& tileData) const {
+    std::shared_ptr<MBVectorTileDecoder::TileMap> MBVectorTileDecoder::decodeTile(const vt::TileId& tile, const vt::TileId& targetTile, const std::shared_ptr<vt::TileTransformer>& tileTransformer, const std::shared_ptr<BinaryData>& tileData, const std::shared_ptr<CancelableTask>& cancelToken) const {
         if (!tileData) {
             Log::Warn("MBVectorTileDecoder::decodeTile: Null tile data");
             return std::shared_ptr<TileMap>();
@@ -420,6 +463,11 @@ namespace carto {
             decoder.setTransform(calculateTileTransform(tile, targetTile));
             decoder.setGlobalIdOverride(featureIdOverride, MapTile(tile.x, tile.y, tile.zoom, 0).getTileId());
             
+            // Cancellation checkpoint between the parsing and symbolizing stages
+            if (cancelToken && cancelToken->isCanceled()) {
+                return std::shared_ptr<TileMap>();
+            }
+
             mvt::MBVTTileReader reader(map, tileTransformer, *symbolizerContext, decoder);
             reader.setLayerNameOverride(layerNameOverride);
 
@@ -443,13 +491,31 @@ namespace carto {
             styleAssetName = "";
             assetPackage = (*cartoCSSStyleSet)->getAssetPackage();
 
-            try {
-                auto assetLoader = std::make_shared<CartoCSSAssetLoader>("", (*cartoCSSStyleSet)->getAssetPackage());
-                css::CartoCSSMapLoader mapLoader(assetLoader, _logger);
-                mapLoader.setIgnoreLayerPredicates(_cartoCSSLayerNamesIgnored);
-                map = mapLoader.loadMap((*cartoCSSStyleSet)->getCartoCSS());
-            } catch (const std::exception& ex) {
-                throw ParseException(std::string("CartoCSS style parsing failed: ") + ex.what(), (*cartoCSSStyleSet)->getCartoCSS());
+            // Check the process-wide parsed map cache first, parsing the style is expensive
+            StyleMapKey mapKey((*cartoCSSStyleSet)->getCartoCSS(), assetPackage, _cartoCSSLayerNamesIgnored);
+            {
+                std::lock_guard<std::mutex> lock(_SharedStyleMapMutex);
+                auto it = _SharedStyleMaps.find(mapKey);
+                if (it != _SharedStyleMaps.end()) {
+                    map = it->second;
+                }
+            }
+
+            if (!map) {
+                try {
+                    auto assetLoader = std::make_shared<CartoCSSAssetLoader>("", (*cartoCSSStyleSet)->getAssetPackage());
+                    css::CartoCSSMapLoader mapLoader(assetLoader, _logger);
+                    mapLoader.setIgnoreLayerPredicates(_cartoCSSLayerNamesIgnored);
+                    map = mapLoader.loadMap((*cartoCSSStyleSet)->getCartoCSS());
+                } catch (const std::exception& ex) {
+                    throw ParseException(std::string("CartoCSS style parsing failed: ") + ex.what(), (*cartoCSSStyleSet)->getCartoCSS());
+                }
+
+                std::lock_guard<std::mutex> lock(_SharedStyleMapMutex);
+                if (_SharedStyleMaps.find(mapKey) == _SharedStyleMaps.end() && _SharedStyleMaps.size() >= MAX_SHARED_STYLE_MAPS) {
+                    _SharedStyleMaps.clear();
+                }
+                _SharedStyleMaps[mapKey] = map;
             }
         } else if (auto compiledStyleSet = boost::get<std::shared_ptr<CompiledStyleSet> >(&styleSet)) {
             styleAssetName = (*compiledStyleSet)->getStyleAssetName();
@@ -458,46 +524,71 @@ namespace carto {
             }
             assetPackage = (*compiledStyleSet)->getAssetPackage();
 
-            std::shared_ptr<BinaryData> styleData;
-            if (assetPackage) {
-                styleData = assetPackage->loadAsset(styleAssetName);
-            }
-            if (!styleData) {
-                throw GenericException("Failed to load style description asset");
+            // Check the process-wide parsed map cache first, parsing the style is expensive
+            StyleMapKey mapKey(styleAssetName, assetPackage, _cartoCSSLayerNamesIgnored);
+            {
+                std::lock_guard<std::mutex> lock(_SharedStyleMapMutex);
+                auto it = _SharedStyleMaps.find(mapKey);
+                if (it != _SharedStyleMaps.end()) {
+                    map = it->second;
+                }
             }
 
-            if (boost::algorithm::ends_with(styleAssetName, ".xml")) {
-                pugi::xml_document doc;
-                if (!doc.load_buffer(styleData->data(), styleData->size())) {
-                    throw ParseException("Style element XML parsing failed");
+            if (!map) {
+                std::shared_ptr<BinaryData> styleData;
+                if (assetPackage) {
+                    styleData = assetPackage->loadAsset(styleAssetName);
                 }
-                try {
-                    auto symbolizerParser = std::make_shared<mvt::SymbolizerParser>(_logger);
-                    mvt::MapParser mapParser(symbolizerParser, _logger);
-                    map = mapParser.parseMap(doc);
-                } catch (const std::exception& ex) {
-                    throw ParseException(std::string("XML style processing failed: ") + ex.what());
+                if (!styleData) {
+                    throw GenericException("Failed to load style description asset");
                 }
-            } else if (boost::algorithm::ends_with(styleAssetName, ".json")) {
-                try {
-                    auto assetLoader = std::make_shared<CartoCSSAssetLoader>(FileUtils::GetFilePath(styleAssetName), assetPackage);
-                    css::CartoCSSMapLoader mapLoader(assetLoader, _logger);
-                    mapLoader.setIgnoreLayerPredicates(_cartoCSSLayerNamesIgnored);
-                    map = mapLoader.loadMapProject(styleAssetName);
-                } catch (const std::exception& ex) {
-                    throw GenericException(std::string("CartoCSS style loading failed: ") + ex.what());
+
+                if (boost::algorithm::ends_with(styleAssetName, ".xml")) {
+                    pugi::xml_document doc;
+                    if (!doc.load_buffer(styleData->data(), styleData->size())) {
+                        throw ParseException("Style element XML parsing failed");
+                    }
+                    try {
+                        auto symbolizerParser = std::make_shared<mvt::SymbolizerParser>(_logger);
+                        mvt::MapParser mapParser(symbolizerParser, _logger);
+                        map = mapParser.parseMap(doc);
+                    } catch (const std::exception& ex) {
+                        throw ParseException(std::string("XML style processing failed: ") + ex.what());
+                    }
+                } else if (boost::algorithm::ends_with(styleAssetName, ".json")) {
+                    try {
+                        auto assetLoader = std::make_shared<CartoCSSAssetLoader>(FileUtils::GetFilePath(styleAssetName), assetPackage);
+                        css::CartoCSSMapLoader mapLoader(assetLoader, _logger);
+                        mapLoader.setIgnoreLayerPredicates(_cartoCSSLayerNamesIgnored);
+                        map = mapLoader.loadMapProject(styleAssetName);
+                    } catch (const std::exception& ex) {
+                        throw GenericException(std::string("CartoCSS style loading failed: ") + ex.what());
+                    }
+                } else {
+                    throw GenericException("Failed to detect style asset type");
                 }
-            } else {
-                throw GenericException("Failed to detect style asset type");
+
+                std::lock_guard<std::mutex> lock(_SharedStyleMapMutex);
+                if (_SharedStyleMaps.find(mapKey) == _SharedStyleMaps.end() && _SharedStyleMaps.size() >= MAX_SHARED_STYLE_MAPS) {
+                    _SharedStyleMaps.clear();
+                }
+                _SharedStyleMaps[mapKey] = map;
             }
         } else {
             throw InvalidArgumentException("Invalid style set");
         }
 
-        if (_assetPackageSymbolizerContexts.find(std::make_pair(styleAssetName, assetPackage)) == _assetPackageSymbolizerContexts.end() && _assetPackageSymbolizerContexts.size() >= MAX_ASSETPACKAGE_SYMBOLIZER_CONTEXTS) {
-            _assetPackageSymbolizerContexts.clear();
+        // Look up the symbolizer context from the process-wide cache. Decoders using the same
+        // style/font assets share the context, so glyphs are rasterized and uploaded only once.
+        SymbolizerContextKey contextKey(styleAssetName, assetPackage, _fallbackFonts);
+        std::shared_ptr<mvt::SymbolizerContext> symbolizerContext;
+        {
+            std::lock_guard<std::mutex> lock(_SharedSymbolizerContextMutex);
+            auto it = _SharedSymbolizerContexts.find(contextKey);
+            if (it != _SharedSymbolizerContexts.end()) {
+                symbolizerContext = it->second;
+            }
         }
-        std::shared_ptr<mvt::SymbolizerContext>& symbolizerContext = _assetPackageSymbolizerContexts[std::make_pair(styleAssetName, assetPackage)];
         if (!symbolizerContext) {
             auto fontManager = std::make_shared<vt::FontManager>(GLYPHMAP_SIZE, GLYPHMAP_SIZE);
             auto bitmapLoader = std::make_shared<VTBitmapLoader>(FileUtils::GetFilePath(styleAssetName), assetPackage);
@@ -526,6 +617,12 @@ namespace carto {
                     }
                 }
             }
+
+            std::lock_guard<std::mutex> lock(_SharedSymbolizerContextMutex);
+            if (_SharedSymbolizerContexts.find(contextKey) == _SharedSymbolizerContexts.end() && _SharedSymbolizerContexts.size() >= MAX_SHARED_SYMBOLIZER_CONTEXTS) {
+                _SharedSymbolizerContexts.clear();
+            }
+            _SharedSymbolizerContexts[contextKey] = symbolizerContext;
         }
 
         std::map<std::string, mvt::Value> parameterValueMap;
@@ -564,12 +661,19 @@ namespace carto {
         _map = map;
         _mapSettings = std::make_shared<mvt::Map::Settings>(_map->getSettings());
         _styleSet = styleSet;
-        _cachedFeatureDecoder.first.reset();
-        _cachedFeatureDecoder.second.reset();
+        _cachedFeatureDecoders.clear();
     }
 
     const int MBVectorTileDecoder::DEFAULT_TILE_SIZE = 256;
     const int MBVectorTileDecoder::STROKEMAP_SIZE = 512;
     const int MBVectorTileDecoder::GLYPHMAP_SIZE = 2048;
-    const std::size_t MBVectorTileDecoder::MAX_ASSETPACKAGE_SYMBOLIZER_CONTEXTS = 2;
+    const std::size_t MBVectorTileDecoder::MAX_SHARED_SYMBOLIZER_CONTEXTS = 4;
+    const std::size_t MBVectorTileDecoder::MAX_CACHED_FEATURE_DECODERS = 4;
+    const std::size_t MBVectorTileDecoder::MAX_SHARED_STYLE_MAPS = 4;
+
+    std::map<MBVectorTileDecoder::SymbolizerContextKey, std::shared_ptr<mvt::SymbolizerContext> > MBVectorTileDecoder::_SharedSymbolizerContexts;
+    std::mutex MBVectorTileDecoder::_SharedSymbolizerContextMutex;
+
+    std::map<MBVectorTileDecoder::StyleMapKey, std::shared_ptr<mvt::Map> > MBVectorTileDecoder::_SharedStyleMaps;
+    std::mutex MBVectorTileDecoder::_SharedStyleMapMutex;
 }
@@ -12,6 +12,8 @@
 #include <memory>
 #include <mutex>
 #include <map>
+#include <set>
+#include <tuple>
 #include <vector>
 #include <string>
 
@@ -144,8 +146,11 @@ namespace carto {
         virtual std::shared_ptr<VectorTileFeature> decodeFeature(long long id, const vt::TileId& tile, const std::shared_ptr<BinaryData>& tileData, const MapBounds& tileBounds) const;
 
         virtual std::shared_ptr<VectorTileFeatureCollection> decodeFeatures(const vt::TileId& tile, const std::shared_ptr<BinaryData>& tileData, const MapBounds& tileBounds) const;
+#ifndef SWIG
+        virtual std::shared_ptr<VectorTileFeatureCollection> decodeFeatures(const vt::TileId& tile, const std::shared_ptr<BinaryData>& tileData, const MapBounds& tileBounds, const std::set<std::string>& layerNames) const;
+#endif
 
-        virtual std::shared_ptr<TileMap> decodeTile(const vt::TileId& tile, const vt::TileId& targetTile, const std::shared_ptr<vt::TileTransformer>& tileTransformer, const std::shared_ptr<BinaryData>& tileData) const;
+        virtual std::shared_ptr<TileMap> decodeTile(const vt::TileId& tile, const vt::TileId& targetTile, const std::shared_ptr<vt::TileTransformer>& tileTransformer, const std::shared_ptr<BinaryData>& tileData, const std::shared_ptr<CancelableTask>& cancelToken) const;
     
     protected:
         void updateCurrentStyleSet(const boost::variant<std::shared_ptr<CompiledStyleSet>, std::shared_ptr<CartoCSSStyleSet> >& styleSet);
@@ -153,8 +158,11 @@ namespace carto {
         static const int DEFAULT_TILE_SIZE;
         static const int STROKEMAP_SIZE;
         static const int GLYPHMAP_SIZE;
-        static const std::size_t MAX_ASSETPACKAGE_SYMBOLIZER_CONTEXTS;
-        
+        static const std::size_t MAX_SHARED_SYMBOLIZER_CONTEXTS;
+        static const std::size_t MAX_CACHED_FEATURE_DECODERS;
+
+        std::shared_ptr<mvt::MBVTFeatureDecoder> getFeatureDecoder(const std::shared_ptr<BinaryData>& tileData) const;
+
         const std::shared_ptr<mvt::Logger> _logger;
         bool _featureIdOverride;
         bool _cartoCSSLayerNamesIgnored;
@@ -165,11 +173,29 @@ namespace carto {
         std::shared_ptr<mvt::Map> _map;
         std::shared_ptr<mvt::Map::Settings> _mapSettings;
         std::shared_ptr<mvt::SymbolizerContext> _symbolizerContext;
-        std::map<std::pair<std::string, std::shared_ptr<AssetPackage> >, std::shared_ptr<mvt::SymbolizerContext> > _assetPackageSymbolizerContexts;
 
-        mutable std::pair<std::shared_ptr<BinaryData>, std::shared_ptr<mvt::MBVTFeatureDecoder> > _cachedFeatureDecoder;
-    
+        mutable std::vector<std::pair<std::shared_ptr<BinaryData>, std::shared_ptr<mvt::MBVTFeatureDecoder> > > _cachedFeatureDecoders;
+
         mutable std::mutex _mutex;
+
+    private:
+        // Process-wide symbolizer context cache. Contexts are keyed by style asset, asset package and
+        // fallback fonts, so decoder instances sharing the same font assets also share rasterized
+        // glyphs and the underlying glyph atlas texture.
+        typedef std::tuple<std::string, std::shared_ptr<AssetPackage>, std::vector<std::shared_ptr<BinaryData> > > SymbolizerContextKey;
+
+        static std::map<SymbolizerContextKey, std::shared_ptr<mvt::SymbolizerContext> > _SharedSymbolizerContexts;
+        static std::mutex _SharedSymbolizerContextMutex;
+
+        // Process-wide cache of parsed style maps. Style parsing is expensive (up to several
+        // hundred milliseconds on low-end devices), so parsed maps are kept keyed by style
+        // source/asset and reused when a decoder is constructed with an identical style.
+        typedef std::tuple<std::string, std::shared_ptr<AssetPackage>, bool> StyleMapKey;
+
+        static const std::size_t MAX_SHARED_STYLE_MAPS;
+
+        static std::map<StyleMapKey, std::shared_ptr<mvt::Map> > _SharedStyleMaps;
+        static std::mutex _SharedStyleMapMutex;
     };
         
 }
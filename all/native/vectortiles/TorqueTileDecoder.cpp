@@ -1,6 +1,7 @@
 #include "TorqueTileDecoder.h"
 #include "core/BinaryData.h"
 #include "components/Exceptions.h"
+#include "components/CancelableTask.h"
 #include "styles/CartoCSSStyleSet.h"
 #include "vectortiles/utils/MapnikVTLogger.h"
 #include "vectortiles/utils/VTBitmapLoader.h"
@@ -22,6 +23,8 @@ namespace carto {
     TorqueTileDecoder::TorqueTileDecoder(const std::shared_ptr<CartoCSSStyleSet>& styleSet) :
         _logger(std::make_shared<MapnikVTLogger>("TorqueTileDecoder")),
         _resolution(256),
+        _frameWindow(0),
+        _baseFrameNr(0),
         _fallbackFonts(),
         _map(),
         _mapSettings(),
@@ -74,6 +77,46 @@ namespace carto {
         notifyDecoderChanged();
     }
     
+    int TorqueTileDecoder::getFrameWindow() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _frameWindow;
+    }
+
+    void TorqueTileDecoder::setFrameWindow(int frameWindow) {
+        if (frameWindow < 0) {
+            throw OutOfRangeException("Frame window must be non-negative");
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _frameWindow = frameWindow;
+        }
+        notifyDecoderChanged();
+    }
+
+    void TorqueTileDecoder::setBaseFrameNr(int frameNr) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_frameWindow == 0) {
+                _baseFrameNr = frameNr;
+                return;
+            }
+
+            // Re-anchor the window only once the frame has moved past half of the window,
+            // so that re-decoding takes place while nearby frames are still decoded.
+            int frameCount = std::static_pointer_cast<mvt::TorqueMap>(_map)->getTorqueSettings().frameCount;
+            int frameDist = std::abs(frameNr - _baseFrameNr);
+            if (frameCount > 0) {
+                frameDist = std::min(frameDist, frameCount - frameDist); // the animation wraps around
+            }
+            if (frameDist * 2 <= _frameWindow) {
+                return;
+            }
+            _baseFrameNr = frameNr;
+        }
+        notifyDecoderChanged();
+    }
+
     std::shared_ptr<mvt::Map::Settings> TorqueTileDecoder::getMapSettings() const  {
         std::lock_guard<std::mutex> lock(_mutex);
         return _mapSettings;
@@ -108,7 +151,7 @@ namespace carto {
         return std::shared_ptr<VectorTileFeatureCollection>();
     }
 
-    std::shared_ptr<TorqueTileDecoder::TileMap> TorqueTileDecoder::decodeTile(const vt::TileId& tile, const vt::TileId& targetTile, const std::shared_ptr<vt::TileTransformer>& tileTransformer, const std::shared_ptr<BinaryData>& tileData) const {
+    std::shared_ptr<TorqueTileDecoder::TileMap> TorqueTileDecoder::decodeTile(const vt::TileId& tile, const vt::TileId& targetTile, const std::shared_ptr<vt::TileTransformer>& tileTransformer, const std::shared_ptr<BinaryData>& tileData, const std::shared_ptr<CancelableTask>& cancelToken) const {
         if (!tileData) {
             Log::Warn("TorqueTileDecoder::decodeTile: Null tile data");
             return std::shared_ptr<TileMap>();
@@ -118,21 +161,39 @@ namespace carto {
         }
 
         int resolution;
+        int frameWindow;
+        int baseFrameNr;
         std::shared_ptr<mvt::TorqueMap> map;
         std::shared_ptr<mvt::SymbolizerContext> symbolizerContext;
         {
             std::lock_guard<std::mutex> lock(_mutex);
             resolution = _resolution;
+            frameWindow = _frameWindow;
+            baseFrameNr = _baseFrameNr;
             map = _map;
             symbolizerContext = _symbolizerContext;
         }
-    
+
         try {
             mvt::TorqueFeatureDecoder decoder(*tileData->getDataPtr(), resolution, _logger);
             decoder.setTransform(calculateTileTransform(tile, targetTile));
 
             auto tileMap = std::make_shared<TileMap>();
-            for (int frame = 0; frame < map->getTorqueSettings().frameCount; frame++) {
+            int frameCount = map->getTorqueSettings().frameCount;
+            for (int frame = 0; frame < frameCount; frame++) {
+                // Cancellation checkpoint between the decoding of individual frames
+                if (cancelToken && cancelToken->isCanceled()) {
+                    return std::shared_ptr<TileMap>();
+                }
+
+                if (frameWindow > 0) {
+                    int frameDist = std::abs(frame - baseFrameNr);
+                    frameDist = std::min(frameDist, frameCount - frameDist); // the animation wraps around
+                    if (frameDist > frameWindow) {
+                        continue;
+                    }
+                }
+
                 mvt::TorqueTileReader reader(map, frame, true, tileTransformer, *symbolizerContext, decoder);
                 if (std::shared_ptr<vt::Tile> tile = reader.readTile(targetTile)) {
                     (*tileMap)[frame] = tile;
@@ -65,6 +65,31 @@ namespace carto {
          */
         void setResolution(int resolution);
 
+        /**
+         * Returns the frame window of the decoder. Default is 0.
+         * @return The frame window, in frames. 0 means that all frames are pre-decoded.
+         */
+        int getFrameWindow() const;
+        /**
+         * Sets the frame window of the decoder. When non-zero, only frames within the given
+         * distance from the current animation frame are pre-decoded, bounding the memory cost
+         * of styles with high frame counts. Frames outside of the window are decoded
+         * when the animation approaches them. The default is 0, meaning that all frames
+         * of a tile are pre-decoded when the tile is loaded.
+         * @param frameWindow The new frame window, in frames. 0 means that all frames are pre-decoded.
+         */
+        void setFrameWindow(int frameWindow);
+
+        /**
+         * Sets the base frame that the decoded frame window is anchored to.
+         * This is called automatically by TorqueTileLayer when the frame number of the layer
+         * is changed and has no effect unless a frame window is set. Tiles are re-decoded
+         * once the new base frame moves past half of the frame window, so that the frames
+         * close to the base frame stay available while re-decoding takes place.
+         * @param frameNr The current animation frame number.
+         */
+        void setBaseFrameNr(int frameNr);
+
         virtual std::shared_ptr<mvt::Map::Settings> getMapSettings() const;
 
         virtual void addFallbackFont(const std::shared_ptr<BinaryData>& fontData);
@@ -77,7 +102,7 @@ namespace carto {
 
         virtual std::shared_ptr<VectorTileFeatureCollection> decodeFeatures(const vt::TileId& tile, const std::shared_ptr<BinaryData>& tileData, const MapBounds& tileBounds) const;
 
-        virtual std::shared_ptr<TileMap> decodeTile(const vt::TileId& tile, const vt::TileId& targetTile, const std::shared_ptr<vt::TileTransformer>& tileTransformer, const std::shared_ptr<BinaryData>& tileData) const;
+        virtual std::shared_ptr<TileMap> decodeTile(const vt::TileId& tile, const vt::TileId& targetTile, const std::shared_ptr<vt::TileTransformer>& tileTransformer, const std::shared_ptr<BinaryData>& tileData, const std::shared_ptr<CancelableTask>& cancelToken) const;
 
     protected:
         void updateCurrentStyleSet(const std::shared_ptr<CartoCSSStyleSet>& styleSet);
@@ -87,6 +112,8 @@ namespace carto {
 
         const std::shared_ptr<mvt::Logger> _logger;
         int _resolution;
+        int _frameWindow;
+        int _baseFrameNr;
         std::vector<std::shared_ptr<BinaryData> > _fallbackFonts;
         std::shared_ptr<mvt::TorqueMap> _map;
         std::shared_ptr<mvt::Map::Settings> _mapSettings;
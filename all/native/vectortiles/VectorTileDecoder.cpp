@@ -1,4 +1,6 @@
 #include "VectorTileDecoder.h"
+#include "geometry/VectorTileFeature.h"
+#include "geometry/VectorTileFeatureCollection.h"
 
 #include <vt/TileId.h>
 
@@ -10,7 +12,30 @@ namespace carto {
     {
     }
 
+    std::shared_ptr<VectorTileFeatureCollection> VectorTileDecoder::decodeFeatures(const vt::TileId& tile, const std::shared_ptr<BinaryData>& tileData, const MapBounds& tileBounds, const std::set<std::string>& layerNames) const {
+        std::shared_ptr<VectorTileFeatureCollection> featureCollection = decodeFeatures(tile, tileData, tileBounds);
+        if (!featureCollection || layerNames.empty()) {
+            return featureCollection;
+        }
+
+        std::vector<std::shared_ptr<VectorTileFeature> > features;
+        features.reserve(featureCollection->getFeatureCount());
+        for (int i = 0; i < featureCollection->getFeatureCount(); i++) {
+            const std::shared_ptr<VectorTileFeature>& feature = featureCollection->getFeature(i);
+            if (layerNames.find(feature->getLayerName()) != layerNames.end()) {
+                features.push_back(feature);
+            }
+        }
+        return std::make_shared<VectorTileFeatureCollection>(std::move(features));
+    }
+
+    unsigned int VectorTileDecoder::getChangeGeneration() const {
+        return _changeGeneration.load();
+    }
+
     void VectorTileDecoder::notifyDecoderChanged() {
+        _changeGeneration++;
+
         std::vector<std::shared_ptr<OnChangeListener> > onChangeListeners;
         {
             std::lock_guard<std::mutex> lock(_onChangeListenersMutex);
@@ -31,7 +56,8 @@ namespace carto {
         _onChangeListeners.erase(std::remove(_onChangeListeners.begin(), _onChangeListeners.end(), listener), _onChangeListeners.end());
     }
     
-    VectorTileDecoder::VectorTileDecoder() : 
+    VectorTileDecoder::VectorTileDecoder() :
+        _changeGeneration(0),
         _onChangeListeners(),
         _onChangeListenersMutex()
     {
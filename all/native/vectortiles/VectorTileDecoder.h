@@ -9,10 +9,12 @@
 
 #include "graphics/Color.h"
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <mutex>
 #include <map>
+#include <set>
 #include <vector>
 
 #include <cglib/mat.h>
@@ -27,6 +29,7 @@ namespace carto {
     }
 
     class BinaryData;
+    class CancelableTask;
     class VectorTileFeature;
     class VectorTileFeatureCollection;
     class MapBounds;
@@ -95,15 +98,40 @@ namespace carto {
          */
         virtual std::shared_ptr<VectorTileFeatureCollection> decodeFeatures(const vt::TileId& tile, const std::shared_ptr<BinaryData>& tileData, const MapBounds& tileBounds) const = 0;
 
+#ifndef SWIG
+        /**
+         * Decodes features from the specified layers of the tile.
+         * The default implementation decodes all features and filters the results,
+         * subclasses may skip the decoding of non-listed layers.
+         * @param tile The tile coordinates.
+         * @param tileData The tile data to use.
+         * @param tileBounds The bounds for the tile (used for coordinate transformation).
+         * @param layerNames The names of the layers to decode. If empty, all layers are decoded.
+         * @return The list of tile features.
+         */
+        virtual std::shared_ptr<VectorTileFeatureCollection> decodeFeatures(const vt::TileId& tile, const std::shared_ptr<BinaryData>& tileData, const MapBounds& tileBounds, const std::set<std::string>& layerNames) const;
+#endif
+
         /**
          * Loads the specified vector tile.
          * @param tile The id of the tile to load.
          * @param targetTile The target tile id that will be created from the data.
          * @param tileData The tile data to decode.
-         * @return The vector tile data, for each frame. If the tile is not available, null is returned.
+         * @param cancelToken Optional cancellation token. Decoding is aborted at the next decoder checkpoint once the token reports cancellation. Can be null.
+         * @return The vector tile data, for each frame. If the tile is not available or decoding was canceled, null is returned.
          */
-        virtual std::shared_ptr<TileMap> decodeTile(const vt::TileId& tile, const vt::TileId& targetTile, const std::shared_ptr<vt::TileTransformer>& tileTransformer, const std::shared_ptr<BinaryData>& tileData) const = 0;
-    
+        virtual std::shared_ptr<TileMap> decodeTile(const vt::TileId& tile, const vt::TileId& targetTile, const std::shared_ptr<vt::TileTransformer>& tileTransformer, const std::shared_ptr<BinaryData>& tileData, const std::shared_ptr<CancelableTask>& cancelToken) const = 0;
+
+#ifndef SWIG
+        /**
+         * Returns the change generation of the decoder. The generation is incremented
+         * every time the decoder parameters change, so it can be used as a cache key
+         * component for data decoded with this decoder.
+         * @return The change generation of the decoder.
+         */
+        unsigned int getChangeGeneration() const;
+#endif
+
         /**
          * Notifies listeners that the decoder parameters have changed. Action taken depends on the implementation of the
          * listeners, but generally all cached tiles will be reloaded. 
@@ -128,6 +156,8 @@ namespace carto {
         static cglib::mat3x3<float> calculateTileTransform(const carto::vt::TileId& tileId, const carto::vt::TileId& targetTileId);
         
     private:
+        std::atomic<unsigned int> _changeGeneration;
+
         std::vector<std::shared_ptr<OnChangeListener> > _onChangeListeners;
         mutable std::mutex _onChangeListenersMutex;
     };
@@ -20,9 +20,29 @@ namespace carto {
     std::shared_ptr<const std::vector<unsigned char> > CartoCSSAssetLoader::load(const std::string& url) const {
         std::shared_ptr<BinaryData> fileData;
         if (_urlFileLoader.isSupported(url)) {
+            // Check the process-wide asset cache first. Each style switch creates a fresh
+            // loader instance, sharing the cache keeps repeated style loads off the network.
+            {
+                std::lock_guard<std::mutex> lock(_SharedAssetsMutex);
+                auto it = _SharedAssets.find(url);
+                if (it != _SharedAssets.end()) {
+                    return it->second;
+                }
+            }
+
             if (!_urlFileLoader.load(url, fileData)) {
                 Log::Errorf("CartoCSSAssetLoader: Failed to load asset: %s", url.c_str());
             }
+
+            if (fileData) {
+                std::shared_ptr<const std::vector<unsigned char> > data = fileData->getDataPtr();
+                std::lock_guard<std::mutex> lock(_SharedAssetsMutex);
+                if (_SharedAssets.find(url) == _SharedAssets.end() && _SharedAssets.size() >= MAX_SHARED_ASSETS) {
+                    _SharedAssets.clear();
+                }
+                _SharedAssets[url] = data;
+                return data;
+            }
         } else {
             std::string fileName = FileUtils::NormalizePath(_basePath + url);
             if (_assetPackage) {
@@ -38,5 +58,10 @@ namespace carto {
         }
         return fileData->getDataPtr();
     }
-    
+
+    const std::size_t CartoCSSAssetLoader::MAX_SHARED_ASSETS = 64;
+
+    std::map<std::string, std::shared_ptr<const std::vector<unsigned char> > > CartoCSSAssetLoader::_SharedAssets;
+    std::mutex CartoCSSAssetLoader::_SharedAssetsMutex;
+
 }
@@ -9,8 +9,11 @@
 
 #include "utils/URLFileLoader.h"
 
-#include <string>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 #include <cartocss/CartoCSSMapLoader.h>
 
@@ -25,6 +28,11 @@ namespace carto {
         virtual std::shared_ptr<const std::vector<unsigned char> > load(const std::string& url) const;    
 
     private:
+        static const std::size_t MAX_SHARED_ASSETS;
+
+        static std::map<std::string, std::shared_ptr<const std::vector<unsigned char> > > _SharedAssets;
+        static std::mutex _SharedAssetsMutex;
+
         std::string _basePath;
         std::shared_ptr<AssetPackage> _assetPackage;
         URLFileLoader _urlFileLoader;
@@ -8,6 +8,7 @@
 #define _CARTO_VALUECONVERTER_H_
 
 #include "core/Variant.h"
+#include "geometry/VectorTileFeatureData.h"
 
 #include <mapnikvt/Value.h>
 
@@ -18,6 +19,17 @@ namespace carto {
         template <typename T> Variant operator() (T val) const { return Variant(val); }
     };
 
+    struct FeatureDataValueConverter : boost::static_visitor<> {
+        FeatureDataValueConverter(VectorTileFeatureData& featureData, int keyIndex) : _featureData(featureData), _keyIndex(keyIndex) { }
+
+        void operator() (boost::blank) const { _featureData.addProperty(_keyIndex); }
+        template <typename T> void operator() (const T& val) const { _featureData.addProperty(_keyIndex, val); }
+
+    private:
+        VectorTileFeatureData& _featureData;
+        int _keyIndex;
+    };
+
 }
 
 #endif
@@ -2,6 +2,7 @@
 #include "components/ThreadWorker.h"
 #include "utils/Log.h"
 
+#include <sched.h>
 #include <sys/resource.h>
 #include <string.h>
 #include <unistd.h>
@@ -18,6 +19,37 @@ namespace carto {
         }
     }
 
+    void ThreadUtils::SetThreadQoS(ThreadQoS::ThreadQoS qos) {
+        // Map the QoS class to a nice value and a scheduling policy. The energy-aware
+        // scheduler biases low-priority threads towards efficiency cores on big.LITTLE
+        // devices, explicit core affinity is not exposed to applications.
+        int niceValue = 0;
+        int schedPolicy = SCHED_OTHER;
+        switch (qos) {
+        case ThreadQoS::BACKGROUND:
+            niceValue = 19;
+            schedPolicy = SCHED_IDLE;
+            break;
+        case ThreadQoS::UTILITY:
+            niceValue = 10;
+            schedPolicy = SCHED_BATCH;
+            break;
+        case ThreadQoS::INTERACTIVE:
+            niceValue = -4;
+            break;
+        }
+
+        errno = 0;
+        if (setpriority(PRIO_PROCESS, gettid(), niceValue) != 0) {
+            Log::Errorf("ThreadUtils::SetThreadQoS: Failed to set thread priority: %d, error: %s", niceValue, strerror(errno));
+        }
+        struct sched_param schedParam;
+        schedParam.sched_priority = 0;
+        if (sched_setscheduler(gettid(), schedPolicy, &schedParam) != 0) {
+            // Some kernels do not allow policy changes for application threads, the nice value alone is an acceptable fallback
+        }
+    }
+
     ThreadUtils::ThreadUtils() {
     }
 
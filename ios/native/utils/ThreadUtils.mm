@@ -3,6 +3,7 @@
 #include "utils/Log.h"
 
 #include <sys/syscall.h>
+#include <pthread/qos.h>
 
 #import <Foundation/NSThread.h>
 
@@ -14,6 +15,22 @@ namespace carto {
         [nsThread setThreadPriority:nsPriority];
     }
     
+    void ThreadUtils::SetThreadQoS(ThreadQoS::ThreadQoS qos) {
+        qos_class_t qosClass = QOS_CLASS_DEFAULT;
+        switch (qos) {
+        case ThreadQoS::BACKGROUND:
+            qosClass = QOS_CLASS_BACKGROUND;
+            break;
+        case ThreadQoS::UTILITY:
+            qosClass = QOS_CLASS_UTILITY;
+            break;
+        case ThreadQoS::INTERACTIVE:
+            qosClass = QOS_CLASS_USER_INTERACTIVE;
+            break;
+        }
+        pthread_set_qos_class_self_np(qosClass, 0);
+    }
+
     ThreadUtils::ThreadUtils() {
     }
 
@@ -47,6 +47,7 @@
 #import "NTMultiPolygonGeometry.h"
 #import "NTGeometrySimplifier.h"
 #import "NTDouglasPeuckerGeometrySimplifier.h"
+#import "NTTopologyPreservingGeometrySimplifier.h"
 #import "NTGeoJSONGeometryReader.h"
 #import "NTGeoJSONGeometryWriter.h"
 
@@ -99,6 +100,7 @@
 #import "NTGeometryCollectionStyle.h"
 #import "NTGeometryCollectionStyleBuilder.h"
 
+#import "NTCustomRenderPass.h"
 #import "NTMapRenderer.h"
 #import "NTMapRendererListener.h"
 #import "NTRendererCaptureListener.h"
@@ -0,0 +1,355 @@
+/*
+ * Headless benchmark driver for the CARTO Mobile SDK render pipeline.
+ *
+ * Replays a recorded camera path against fixture MBTiles data through
+ * BaseMapView/MapRenderer using an offscreen EGL pbuffer context and reports
+ * frame time percentiles, per-stage tile load statistics and peak RSS.
+ * The camera path is stepped on a fixed simulated timeline, so the rendered
+ * workload is deterministic and results are comparable across runs.
+ *
+ * Camera path files are JSON arrays of keyframes:
+ *   [{ "lon": 24.65, "lat": 59.42, "zoom": 10, "rotation": 0, "tilt": 90, "duration": 2.0 }, ...]
+ * The camera is interpolated linearly between consecutive keyframes over
+ * 'duration' seconds. If no path file is given, a built-in zoom sweep is used.
+ *
+ * Typical usage:
+ *   carto_mobile_sdk_benchmark --mbtiles fixture.mbtiles --style style.zip --path camera.json --trace trace.json
+ */
+
+#include "core/BinaryData.h"
+#include "core/MapPos.h"
+#include "core/Variant.h"
+#include "components/Layers.h"
+#include "components/Options.h"
+#include "datasources/MBTilesTileDataSource.h"
+#include "layers/RasterTileLayer.h"
+#include "layers/TileLayer.h"
+#include "layers/VectorTileLayer.h"
+#include "projections/Projection.h"
+#include "renderers/MapRenderer.h"
+#include "styles/CompiledStyleSet.h"
+#include "ui/BaseMapView.h"
+#include "utils/ZippedAssetPackage.h"
+#include "vectortiles/MBVectorTileDecoder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include <EGL/egl.h>
+#include <GLES2/gl2.h>
+
+#include <picojson/picojson.h>
+
+namespace {
+
+    struct Keyframe {
+        double lon = 0;
+        double lat = 0;
+        float zoom = 0;
+        float rotation = 0;
+        float tilt = 90;
+        float duration = 0;
+    };
+
+    struct BenchmarkParams {
+        std::string mbtilesPath;
+        std::string stylePath;
+        std::string styleName;
+        std::string cameraPathFile;
+        std::string traceFile;
+        int width = 1280;
+        int height = 720;
+        float fps = 60.0f;
+        float settleSeconds = 30.0f;
+        bool rasterTiles = false;
+    };
+
+    std::shared_ptr<carto::BinaryData> ReadFileData(const std::string& fileName) {
+        std::ifstream stream(fileName.c_str(), std::ios::binary);
+        if (!stream) {
+            return std::shared_ptr<carto::BinaryData>();
+        }
+        std::vector<unsigned char> data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        return std::make_shared<carto::BinaryData>(std::move(data));
+    }
+
+    bool LoadCameraPath(const std::string& fileName, std::vector<Keyframe>& keyframes) {
+        std::ifstream stream(fileName.c_str());
+        if (!stream) {
+            std::fprintf(stderr, "Failed to open camera path file %s\n", fileName.c_str());
+            return false;
+        }
+
+        picojson::value doc;
+        std::string err = picojson::parse(doc, stream);
+        if (!err.empty() || !doc.is<picojson::array>()) {
+            std::fprintf(stderr, "Failed to parse camera path file %s: %s\n", fileName.c_str(), err.c_str());
+            return false;
+        }
+
+        for (const picojson::value& val : doc.get<picojson::array>()) {
+            Keyframe keyframe;
+            keyframe.lon = val.get("lon").get<double>();
+            keyframe.lat = val.get("lat").get<double>();
+            keyframe.zoom = static_cast<float>(val.get("zoom").get<double>());
+            if (val.contains("rotation")) {
+                keyframe.rotation = static_cast<float>(val.get("rotation").get<double>());
+            }
+            if (val.contains("tilt")) {
+                keyframe.tilt = static_cast<float>(val.get("tilt").get<double>());
+            }
+            if (val.contains("duration")) {
+                keyframe.duration = static_cast<float>(val.get("duration").get<double>());
+            }
+            keyframes.push_back(keyframe);
+        }
+        return keyframes.size() >= 2;
+    }
+
+    std::vector<Keyframe> DefaultCameraPath() {
+        // Zoom sweep over the center of the data, followed by a rotating tilted pan
+        std::vector<Keyframe> keyframes(5);
+        keyframes[0] = Keyframe();
+        keyframes[0].zoom = 2;
+        keyframes[1] = keyframes[0];
+        keyframes[1].zoom = 10;
+        keyframes[1].duration = 5;
+        keyframes[2] = keyframes[1];
+        keyframes[2].zoom = 14;
+        keyframes[2].duration = 5;
+        keyframes[3] = keyframes[2];
+        keyframes[3].lon = 0.05;
+        keyframes[3].rotation = 90;
+        keyframes[3].tilt = 45;
+        keyframes[3].duration = 5;
+        keyframes[4] = keyframes[3];
+        keyframes[4].lon = 0.1;
+        keyframes[4].rotation = 180;
+        keyframes[4].duration = 5;
+        return keyframes;
+    }
+
+    bool CreateOffscreenContext(int width, int height) {
+        EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        if (display == EGL_NO_DISPLAY || !eglInitialize(display, NULL, NULL)) {
+            std::fprintf(stderr, "Failed to initialize EGL display\n");
+            return false;
+        }
+
+        const EGLint configAttribs[] = {
+            EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+            EGL_RED_SIZE, 8,
+            EGL_GREEN_SIZE, 8,
+            EGL_BLUE_SIZE, 8,
+            EGL_ALPHA_SIZE, 8,
+            EGL_DEPTH_SIZE, 16,
+            EGL_NONE
+        };
+        EGLConfig config = NULL;
+        EGLint configCount = 0;
+        if (!eglChooseConfig(display, configAttribs, &config, 1, &configCount) || configCount < 1) {
+            std::fprintf(stderr, "Failed to find suitable EGL config\n");
+            return false;
+        }
+
+        const EGLint surfaceAttribs[] = {
+            EGL_WIDTH, width,
+            EGL_HEIGHT, height,
+            EGL_NONE
+        };
+        EGLSurface surface = eglCreatePbufferSurface(display, config, surfaceAttribs);
+        if (surface == EGL_NO_SURFACE) {
+            std::fprintf(stderr, "Failed to create EGL pbuffer surface\n");
+            return false;
+        }
+
+        const EGLint contextAttribs[] = {
+            EGL_CONTEXT_CLIENT_VERSION, 2,
+            EGL_NONE
+        };
+        EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs);
+        if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, surface, surface, context)) {
+            std::fprintf(stderr, "Failed to create EGL context\n");
+            return false;
+        }
+        return true;
+    }
+
+    float CalculatePercentile(std::vector<float> samples, int percentile) {
+        if (samples.empty()) {
+            return 0;
+        }
+        std::sort(samples.begin(), samples.end());
+        return samples[samples.size() * percentile / 100];
+    }
+
+    long long GetPeakRSSBytes() {
+        struct rusage usage;
+        std::memset(&usage, 0, sizeof(usage));
+        getrusage(RUSAGE_SELF, &usage);
+        return static_cast<long long>(usage.ru_maxrss) * 1024; // ru_maxrss is in kilobytes on Linux
+    }
+
+    bool ParseArgs(int argc, char* argv[], BenchmarkParams& params) {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--raster") {
+                params.rasterTiles = true;
+            } else if (i + 1 < argc) {
+                std::string value = argv[++i];
+                if (arg == "--mbtiles") {
+                    params.mbtilesPath = value;
+                } else if (arg == "--style") {
+                    params.stylePath = value;
+                } else if (arg == "--style-name") {
+                    params.styleName = value;
+                } else if (arg == "--path") {
+                    params.cameraPathFile = value;
+                } else if (arg == "--trace") {
+                    params.traceFile = value;
+                } else if (arg == "--width") {
+                    params.width = std::atoi(value.c_str());
+                } else if (arg == "--height") {
+                    params.height = std::atoi(value.c_str());
+                } else if (arg == "--fps") {
+                    params.fps = static_cast<float>(std::atof(value.c_str()));
+                } else if (arg == "--settle") {
+                    params.settleSeconds = static_cast<float>(std::atof(value.c_str()));
+                } else {
+                    std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+                    return false;
+                }
+            } else {
+                std::fprintf(stderr, "Missing value for option %s\n", arg.c_str());
+                return false;
+            }
+        }
+
+        if (params.mbtilesPath.empty()) {
+            std::fprintf(stderr, "Usage: %s --mbtiles <file> [--style <zip>] [--style-name <name>] [--path <json>] [--trace <json>] [--width <n>] [--height <n>] [--fps <n>] [--settle <seconds>] [--raster]\n", argv[0]);
+            return false;
+        }
+        if (!params.rasterTiles && params.stylePath.empty()) {
+            std::fprintf(stderr, "Vector tile benchmarks require a compiled style set, use --style or --raster\n");
+            return false;
+        }
+        return true;
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    BenchmarkParams params;
+    if (!ParseArgs(argc, argv, params)) {
+        return 1;
+    }
+
+    std::vector<Keyframe> keyframes;
+    if (!params.cameraPathFile.empty()) {
+        if (!LoadCameraPath(params.cameraPathFile, keyframes)) {
+            return 1;
+        }
+    } else {
+        keyframes = DefaultCameraPath();
+    }
+
+    if (!CreateOffscreenContext(params.width, params.height)) {
+        return 1;
+    }
+
+    // Build the layer stack
+    std::shared_ptr<carto::TileLayer> tileLayer;
+    try {
+        auto dataSource = std::make_shared<carto::MBTilesTileDataSource>(params.mbtilesPath);
+        if (params.rasterTiles) {
+            tileLayer = std::make_shared<carto::RasterTileLayer>(dataSource);
+        } else {
+            std::shared_ptr<carto::BinaryData> styleData = ReadFileData(params.stylePath);
+            if (!styleData) {
+                std::fprintf(stderr, "Failed to read style file %s\n", params.stylePath.c_str());
+                return 1;
+            }
+            auto assetPackage = std::make_shared<carto::ZippedAssetPackage>(styleData);
+            auto styleSet = params.styleName.empty()
+                ? std::make_shared<carto::CompiledStyleSet>(assetPackage)
+                : std::make_shared<carto::CompiledStyleSet>(assetPackage, params.styleName);
+            auto tileDecoder = std::make_shared<carto::MBVectorTileDecoder>(styleSet);
+            tileLayer = std::make_shared<carto::VectorTileLayer>(dataSource, tileDecoder);
+        }
+    }
+    catch (const std::exception& ex) {
+        std::fprintf(stderr, "Failed to create tile layer: %s\n", ex.what());
+        return 1;
+    }
+    tileLayer->setPreloading(true);
+
+    carto::BaseMapView mapView;
+    mapView.getLayers()->add(tileLayer);
+    mapView.onSurfaceCreated();
+    mapView.onSurfaceChanged(params.width, params.height);
+    if (!params.traceFile.empty()) {
+        mapView.getMapRenderer()->setFrameProfilingEnabled(true);
+    }
+
+    std::shared_ptr<carto::Projection> projection = mapView.getOptions()->getBaseProjection();
+
+    // Replay the camera path on a fixed simulated timeline
+    std::vector<float> frameTimes;
+    for (std::size_t i = 1; i < keyframes.size(); i++) {
+        const Keyframe& keyframe0 = keyframes[i - 1];
+        const Keyframe& keyframe1 = keyframes[i];
+        int frameCount = std::max(1, static_cast<int>(keyframe1.duration * params.fps));
+        for (int frame = 0; frame < frameCount; frame++) {
+            float t = static_cast<float>(frame + 1) / frameCount;
+            carto::MapPos wgs84Pos(keyframe0.lon + (keyframe1.lon - keyframe0.lon) * t,
+                                   keyframe0.lat + (keyframe1.lat - keyframe0.lat) * t);
+            mapView.setFocusPos(projection->fromWgs84(wgs84Pos), 0);
+            mapView.setZoom(keyframe0.zoom + (keyframe1.zoom - keyframe0.zoom) * t, 0);
+            mapView.setRotation(keyframe0.rotation + (keyframe1.rotation - keyframe0.rotation) * t, 0);
+            mapView.setTilt(keyframe0.tilt + (keyframe1.tilt - keyframe0.tilt) * t, 0);
+
+            std::chrono::steady_clock::time_point frameStartTime = std::chrono::steady_clock::now();
+            mapView.onDrawFrame();
+            glFinish();
+            frameTimes.push_back(std::chrono::duration_cast<std::chrono::duration<float, std::milli> >(std::chrono::steady_clock::now() - frameStartTime).count());
+        }
+    }
+
+    // Keep drawing until all pending tile fetches/decodes have finished, so that
+    // the reported tile statistics cover the full workload
+    std::chrono::steady_clock::time_point settleStartTime = std::chrono::steady_clock::now();
+    while (tileLayer->isUpdateInProgress()) {
+        if (std::chrono::duration_cast<std::chrono::duration<float> >(std::chrono::steady_clock::now() - settleStartTime).count() > params.settleSeconds) {
+            std::fprintf(stderr, "Warning: tile loading did not settle within %g seconds\n", params.settleSeconds);
+            break;
+        }
+        mapView.onDrawFrame();
+        glFinish();
+    }
+
+    if (!params.traceFile.empty()) {
+        std::ofstream stream(params.traceFile.c_str());
+        stream << mapView.getMapRenderer()->getFrameProfilingTrace();
+    }
+
+    std::printf("frames: %d\n", static_cast<int>(frameTimes.size()));
+    std::printf("frame time (ms): p50=%.2f p90=%.2f p99=%.2f max=%.2f\n",
+                CalculatePercentile(frameTimes, 50),
+                CalculatePercentile(frameTimes, 90),
+                CalculatePercentile(frameTimes, 99),
+                frameTimes.empty() ? 0.0f : *std::max_element(frameTimes.begin(), frameTimes.end()));
+    std::printf("tile load statistics (s): %s\n", tileLayer->getTileLoadStatistics().toString().c_str());
+    std::printf("peak RSS (MB): %.1f\n", GetPeakRSSBytes() / (1024.0 * 1024.0));
+
+    mapView.onSurfaceDestroyed();
+    return 0;
+}
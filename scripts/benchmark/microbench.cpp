@@ -0,0 +1,268 @@
+/*
+ * Microbenchmark driver for the CARTO Mobile SDK decode and geometry hot paths.
+ *
+ * Each benchmark is a single operation that the harness runs repeatedly,
+ * auto-calibrating the iteration count until the run takes long enough to
+ * measure reliably, and reports the average time per operation. Tracked over
+ * time these numbers show whether optimizations to the hot paths actually land.
+ *
+ * The tile decode benchmark is only run when a compiled style set and corpus
+ * tiles are given on the command line. Corpus tile coordinates are parsed from
+ * file names of the form z_x_y.mvt, defaulting to 0_0_0.
+ *
+ * Typical usage:
+ *   carto_mobile_sdk_microbench --style style.zip --tile 14_8800_5373.mvt --tile 2_2_1.mvt
+ */
+
+#include "core/BinaryData.h"
+#include "core/MapPos.h"
+#include "core/MapTile.h"
+#include "core/Variant.h"
+#include "geometry/DouglasPeuckerGeometrySimplifier.h"
+#include "geometry/LineGeometry.h"
+#include "packagemanager/PackageTileMask.h"
+#include "projections/EPSG3857.h"
+#include "projections/PlanarProjectionSurface.h"
+#include "renderers/drawdatas/LineDrawData.h"
+#include "search/query/QueryContext.h"
+#include "search/query/QueryExpression.h"
+#include "search/query/QueryExpressionParser.h"
+#include "styles/CompiledStyleSet.h"
+#include "styles/LineStyle.h"
+#include "styles/LineStyleBuilder.h"
+#include "utils/Const.h"
+#include "utils/ZippedAssetPackage.h"
+#include "vectortiles/MBVectorTileDecoder.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <vt/TileTransformer.h>
+
+namespace {
+
+    volatile std::size_t _BenchmarkSink = 0;
+
+    template <typename Func>
+    void RunBenchmark(const char* name, Func func) {
+        long long iterations = 1;
+        while (true) {
+            std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+            for (long long i = 0; i < iterations; i++) {
+                _BenchmarkSink += func();
+            }
+            double elapsed = std::chrono::duration_cast<std::chrono::duration<double> >(std::chrono::steady_clock::now() - startTime).count();
+            if (elapsed >= 0.25) {
+                std::printf("%-40s %14.1f ns/op %12lld iterations\n", name, elapsed * 1.0e9 / iterations, iterations);
+                return;
+            }
+            iterations *= 4;
+        }
+    }
+
+    std::shared_ptr<carto::BinaryData> ReadFileData(const std::string& fileName) {
+        std::ifstream stream(fileName.c_str(), std::ios::binary);
+        if (!stream) {
+            return std::shared_ptr<carto::BinaryData>();
+        }
+        std::vector<unsigned char> data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        return std::make_shared<carto::BinaryData>(std::move(data));
+    }
+
+    carto::MapTile ParseTileCoordinates(const std::string& fileName) {
+        // Parse z_x_y from the file name, e.g. corpus/14_8800_5373.mvt
+        std::size_t dirPos = fileName.find_last_of('/');
+        std::string baseName = (dirPos == std::string::npos ? fileName : fileName.substr(dirPos + 1));
+        int zoom = 0, x = 0, y = 0;
+        if (std::sscanf(baseName.c_str(), "%d_%d_%d", &zoom, &x, &y) != 3) {
+            zoom = x = y = 0;
+        }
+        return carto::MapTile(x, y, zoom, 0);
+    }
+
+    std::vector<carto::MapPos> GenerateLinePoses(int count) {
+        // Noisy diagonal line in EPSG3857 coordinates, roughly city-block scale
+        std::vector<carto::MapPos> poses;
+        poses.reserve(count);
+        for (int i = 0; i < count; i++) {
+            double t = static_cast<double>(i) / count;
+            poses.emplace_back(t * 10000.0 + std::sin(i * 12.9898) * 25.0,
+                               t * 10000.0 + std::cos(i * 78.2330) * 25.0);
+        }
+        return poses;
+    }
+
+    class MapQueryContext : public carto::QueryContext {
+    public:
+        explicit MapQueryContext(std::map<std::string, carto::Variant> variables) : _variables(std::move(variables)) { }
+
+        virtual bool getVariable(const std::string& name, carto::Variant& value) const {
+            auto it = _variables.find(name);
+            if (it == _variables.end()) {
+                return false;
+            }
+            value = it->second;
+            return true;
+        }
+
+    private:
+        std::map<std::string, carto::Variant> _variables;
+    };
+
+    void BenchmarkEPSG3857Transforms() {
+        carto::EPSG3857 projection;
+        std::vector<carto::MapPos> wgs84Poses;
+        for (int i = 0; i < 256; i++) {
+            wgs84Poses.emplace_back(-180.0 + i * 1.4, -85.0 + i * 0.66);
+        }
+
+        RunBenchmark("EPSG3857::fromWgs84", [&]() -> std::size_t {
+            double sum = 0;
+            for (const carto::MapPos& pos : wgs84Poses) {
+                sum += projection.fromWgs84(pos).getX();
+            }
+            return static_cast<std::size_t>(sum);
+        });
+
+        std::vector<carto::MapPos> internalPoses = projection.fromWgs84(wgs84Poses);
+        RunBenchmark("EPSG3857::toWgs84", [&]() -> std::size_t {
+            double sum = 0;
+            for (const carto::MapPos& pos : internalPoses) {
+                sum += projection.toWgs84(pos).getX();
+            }
+            return static_cast<std::size_t>(sum);
+        });
+    }
+
+    void BenchmarkGeometrySimplifier() {
+        auto projection = std::make_shared<carto::EPSG3857>();
+        auto projectionSurface = std::make_shared<carto::PlanarProjectionSurface>();
+        auto geometry = std::make_shared<carto::LineGeometry>(GenerateLinePoses(1000));
+        carto::DouglasPeuckerGeometrySimplifier simplifier(1.0f);
+
+        RunBenchmark("DouglasPeuckerGeometrySimplifier", [&]() -> std::size_t {
+            std::shared_ptr<carto::Geometry> simplified = simplifier.simplify(geometry, projection, projectionSurface, 1.0f);
+            return simplified ? 1 : 0;
+        });
+    }
+
+    void BenchmarkLineTessellation() {
+        carto::EPSG3857 projection;
+        carto::PlanarProjectionSurface projectionSurface;
+        carto::LineGeometry geometry(GenerateLinePoses(1000));
+        carto::LineStyleBuilder styleBuilder;
+        styleBuilder.setWidth(4.0f);
+        std::shared_ptr<carto::LineStyle> style = styleBuilder.buildStyle();
+
+        RunBenchmark("LineDrawData tessellation", [&]() -> std::size_t {
+            carto::LineDrawData drawData(geometry, *style, projection, projectionSurface);
+            return drawData.getCoords().size();
+        });
+    }
+
+    void BenchmarkPackageTileMask() {
+        // Diagonal coverage pattern, similar in shape to country package masks
+        std::vector<carto::MapTile> tiles;
+        for (int zoom = 0; zoom <= 10; zoom++) {
+            for (int i = 0; i < (1 << zoom); i++) {
+                tiles.emplace_back(i, i, zoom, 0);
+            }
+        }
+        carto::PackageTileMask tileMask(tiles, 10);
+
+        RunBenchmark("PackageTileMask::getTileStatus", [&]() -> std::size_t {
+            std::size_t sum = 0;
+            for (int i = 0; i < 256; i++) {
+                sum += tileMask.getTileStatus(carto::MapTile(i * 3 % 1024, i * 7 % 1024, 10, 0));
+            }
+            return sum;
+        });
+    }
+
+    void BenchmarkQueryExpressions() {
+        std::map<std::string, carto::Variant> variables;
+        variables["class"] = carto::Variant(std::string("highway"));
+        variables["name"] = carto::Variant(std::string("Main Street"));
+        variables["population"] = carto::Variant(static_cast<long long>(12500));
+        MapQueryContext context(variables);
+        std::string expr = "class = 'highway' AND (population > 10000 OR name = 'Main Street')";
+
+        RunBenchmark("QueryExpressionParser::parse", [&]() -> std::size_t {
+            return carto::QueryExpressionParser::parse(expr) ? 1 : 0;
+        });
+
+        std::shared_ptr<carto::QueryExpression> parsedExpr = carto::QueryExpressionParser::parse(expr);
+        RunBenchmark("QueryExpression::evaluate", [&]() -> std::size_t {
+            return parsedExpr->evaluate(context) ? 1 : 0;
+        });
+    }
+
+    void BenchmarkTileDecode(const std::string& stylePath, const std::vector<std::string>& tileFiles) {
+        std::shared_ptr<carto::BinaryData> styleData = ReadFileData(stylePath);
+        if (!styleData) {
+            std::fprintf(stderr, "Failed to read style file %s\n", stylePath.c_str());
+            return;
+        }
+
+        std::shared_ptr<carto::MBVectorTileDecoder> tileDecoder;
+        try {
+            auto assetPackage = std::make_shared<carto::ZippedAssetPackage>(styleData);
+            auto styleSet = std::make_shared<carto::CompiledStyleSet>(assetPackage);
+            tileDecoder = std::make_shared<carto::MBVectorTileDecoder>(styleSet);
+        }
+        catch (const std::exception& ex) {
+            std::fprintf(stderr, "Failed to create tile decoder: %s\n", ex.what());
+            return;
+        }
+        auto tileTransformer = std::make_shared<carto::vt::DefaultTileTransformer>(static_cast<float>(carto::Const::WORLD_SIZE));
+
+        for (const std::string& tileFile : tileFiles) {
+            std::shared_ptr<carto::BinaryData> tileData = ReadFileData(tileFile);
+            if (!tileData) {
+                std::fprintf(stderr, "Failed to read tile file %s\n", tileFile.c_str());
+                continue;
+            }
+            carto::MapTile tile = ParseTileCoordinates(tileFile);
+            carto::vt::TileId vtTile(tile.getZoom(), tile.getX(), tile.getY());
+
+            std::string name = "MBVectorTileDecoder::decodeTile " + tileFile;
+            RunBenchmark(name.c_str(), [&]() -> std::size_t {
+                std::shared_ptr<carto::VectorTileDecoder::TileMap> tileMap = tileDecoder->decodeTile(vtTile, vtTile, tileTransformer, tileData, std::shared_ptr<carto::CancelableTask>());
+                return tileMap ? tileMap->size() : 0;
+            });
+        }
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    std::string stylePath;
+    std::vector<std::string> tileFiles;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--style" && i + 1 < argc) {
+            stylePath = argv[++i];
+        } else if (arg == "--tile" && i + 1 < argc) {
+            tileFiles.push_back(argv[++i]);
+        } else {
+            std::fprintf(stderr, "Usage: %s [--style <zip>] [--tile <z_x_y.mvt>]...\n", argv[0]);
+            return 1;
+        }
+    }
+
+    BenchmarkEPSG3857Transforms();
+    BenchmarkGeometrySimplifier();
+    BenchmarkLineTessellation();
+    BenchmarkPackageTileMask();
+    BenchmarkQueryExpressions();
+    if (!stylePath.empty() && !tileFiles.empty()) {
+        BenchmarkTileDecode(stylePath, tileFiles);
+    }
+    return 0;
+}
@@ -11,6 +11,22 @@ namespace carto {
         ::SetThreadPriority(::GetCurrentThread(), static_cast<int>(priority) * THREAD_PRIORITY_HIGHEST / static_cast<int>(ThreadPriority::MAXIMUM));
     }
 
+    void ThreadUtils::SetThreadQoS(ThreadQoS::ThreadQoS qos) {
+        int threadPriority = THREAD_PRIORITY_NORMAL;
+        switch (qos) {
+        case ThreadQoS::BACKGROUND:
+            threadPriority = THREAD_PRIORITY_LOWEST;
+            break;
+        case ThreadQoS::UTILITY:
+            threadPriority = THREAD_PRIORITY_BELOW_NORMAL;
+            break;
+        case ThreadQoS::INTERACTIVE:
+            threadPriority = THREAD_PRIORITY_ABOVE_NORMAL;
+            break;
+        }
+        ::SetThreadPriority(::GetCurrentThread(), threadPriority);
+    }
+
     ThreadUtils::ThreadUtils() {
     }
 